@@ -28,6 +28,18 @@
 #define SPEED_ALGORITHM_HPP
 
 #include "algorithm/algorithm.hpp"
+#include "algorithm/algorithm_exception.hpp"
+#include "algorithm/argsort.hpp"
+#include "algorithm/external_sort.hpp"
+#include "algorithm/parallel.hpp"
+#include "algorithm/parallel_sort.hpp"
+#include "algorithm/radix_sort.hpp"
+#include "algorithm/search.hpp"
+#include "algorithm/selection.hpp"
+#include "algorithm/static_sort.hpp"
+#include "algorithm/timsort.hpp"
+#include "algorithm/top_k.hpp"
+#include "algorithm/work_stealing_executor.hpp"
 
 
 namespace speed {
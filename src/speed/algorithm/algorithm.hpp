@@ -27,8 +27,14 @@
 #ifndef SPEED_ALGORITHM_ALGORITHM_HPP
 #define SPEED_ALGORITHM_ALGORITHM_HPP
 
+#include <algorithm>
 #include <cstdlib>
+#include <functional>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+
+#include "static_sort.hpp"
 
 
 namespace speed {
@@ -39,46 +45,643 @@ namespace algorithm {
 namespace __hidden_algorithm {
 
 
+/** Size under which the ranges are sorted by insertion. */
+constexpr std::size_t INSERTION_SORT_THRESHOLD = 24;
+
+/** Size under which the ranges of arithmetic types are sorted with a sorting network. */
+constexpr std::size_t STATIC_SORT_THRESHOLD = 16;
+
+/** Size over which the pivot is chosen as the pseudo-median of nine elements. */
+constexpr std::size_t NINTHER_THRESHOLD = 128;
+
+/** Number of moves after which a partial insertion sort gives up. */
+constexpr std::size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+/** Number of elements scanned at once by the branchless partitioning. */
+constexpr std::size_t PARTITION_BLOCK_SIZE = 64;
+
+
+/**
+ * @brief       Get the floor of the base 2 logarithm of a number.
+ * @param       n : The number, greater than 0.
+ * @return      The floor of the base 2 logarithm of the number.
+ */
+constexpr std::size_t __log2(std::size_t n) noexcept
+{
+    std::size_t lg = 0;
+    
+    while (n >>= 1)
+    {
+        ++lg;
+    }
+    
+    return lg;
+}
+
+
+/**
+ * @brief       Sort a range by insertion.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ */
+template<typename TpArray, typename TpCompare>
+void __insertion_sort(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+{
+    std::size_t i;
+    std::size_t j;
+    
+    for (i = lo + 1; i < hi; ++i)
+    {
+        if (comp(array[i], array[i - 1]))
+        {
+            std::decay_t<decltype(array[0])> tmp = std::move(array[i]);
+            
+            j = i;
+            do
+            {
+                array[j] = std::move(array[j - 1]);
+                --j;
+            } while (j > lo && comp(tmp, array[j - 1]));
+            
+            array[j] = std::move(tmp);
+        }
+    }
+}
+
+
+/**
+ * @brief       Sort a range by insertion, assuming that the element before the range is not
+ *              greater than any element of the range, so that no bounds check is needed.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range, greater than 0.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ */
 template<typename TpArray, typename TpCompare>
-std::size_t __get_partition(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+void __unguarded_insertion_sort(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp
+)
 {
-    std::size_t partition_index = lo;
     std::size_t i;
-    std::remove_reference_t<decltype(array[0])> pivot = array[hi];
-    std::remove_reference_t<decltype(array[0])> aux;
+    std::size_t j;
     
-    for (i = lo; i < hi; i++)
+    for (i = lo + 1; i < hi; ++i)
     {
-        if (comp(array[i], pivot))
+        if (comp(array[i], array[i - 1]))
         {
-            aux = array[partition_index];
-            array[partition_index] = array[i];
-            array[i] = aux;
-            partition_index++;
+            std::decay_t<decltype(array[0])> tmp = std::move(array[i]);
+            
+            j = i;
+            do
+            {
+                array[j] = std::move(array[j - 1]);
+                --j;
+            } while (comp(tmp, array[j - 1]));
+            
+            array[j] = std::move(tmp);
         }
     }
+}
+
+
+/**
+ * @brief       Try to sort a range by insertion, giving up after PARTIAL_INSERTION_SORT_LIMIT
+ *              moves. It is used to finish quickly the ranges that are almost sorted.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      If the range has been sorted true is returned, otherwise false is returned.
+ */
+template<typename TpArray, typename TpCompare>
+bool __partial_insertion_sort(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+{
+    std::size_t limit = 0;
+    std::size_t i;
+    std::size_t j;
     
-    aux = array[hi];
-    array[hi] = array[partition_index];
-    array[partition_index] = aux;
+    for (i = lo + 1; i < hi; ++i)
+    {
+        if (comp(array[i], array[i - 1]))
+        {
+            std::decay_t<decltype(array[0])> tmp = std::move(array[i]);
+            
+            j = i;
+            do
+            {
+                array[j] = std::move(array[j - 1]);
+                --j;
+            } while (j > lo && comp(tmp, array[j - 1]));
+            
+            array[j] = std::move(tmp);
+            limit += i - j;
+            
+            if (limit > PARTIAL_INSERTION_SORT_LIMIT)
+            {
+                return i + 1 == hi;
+            }
+        }
+    }
     
-    return partition_index;
+    return true;
 }
 
 
+/**
+ * @brief       Sort a range with a heapsort. It is used when the partitions are too unbalanced,
+ *              so that the sort is O(n * log(n)) in the worst case.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ */
 template<typename TpArray, typename TpCompare>
-void __quicksort(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+void __heapsort(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
 {
-    std::size_t partition_index;
+    const std::size_t sz = hi - lo;
+    std::size_t end;
+    std::size_t i;
     
-    if (lo < hi)
+    auto sift_down = [&](std::size_t root, std::size_t heap_sz)
     {
-        partition_index = __get_partition(array, lo, hi, comp);
-        if (partition_index > 0)
+        std::decay_t<decltype(array[0])> tmp = std::move(array[lo + root]);
+        std::size_t child;
+        
+        while ((child = 2 * root + 1) < heap_sz)
         {
-            __quicksort(array, lo, partition_index - 1, comp);
+            if (child + 1 < heap_sz && comp(array[lo + child], array[lo + child + 1]))
+            {
+                ++child;
+            }
+            
+            if (!comp(tmp, array[lo + child]))
+            {
+                break;
+            }
+            
+            array[lo + root] = std::move(array[lo + child]);
+            root = child;
+        }
+        
+        array[lo + root] = std::move(tmp);
+    };
+    
+    for (i = sz / 2; i-- > 0;)
+    {
+        sift_down(i, sz);
+    }
+    
+    for (end = sz; end-- > 1;)
+    {
+        std::swap(array[lo], array[lo + end]);
+        sift_down(0, end);
+    }
+}
+
+
+/**
+ * @brief       Sort three elements of an array.
+ * @param       array : The array.
+ * @param       i : The index of the first element.
+ * @param       j : The index of the second element.
+ * @param       k : The index of the third element.
+ * @param       comp : The comparison function.
+ */
+template<typename TpArray, typename TpCompare>
+void __sort3(TpArray& array, std::size_t i, std::size_t j, std::size_t k, const TpCompare& comp)
+{
+    if (comp(array[j], array[i]))
+    {
+        std::swap(array[i], array[j]);
+    }
+    
+    if (comp(array[k], array[j]))
+    {
+        std::swap(array[j], array[k]);
+        
+        if (comp(array[j], array[i]))
+        {
+            std::swap(array[i], array[j]);
+        }
+    }
+}
+
+
+/**
+ * @brief       Partition a range around its first element. The elements equal to the pivot are
+ *              placed on the right. There must be an element not lower than the pivot after it.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range, that is the pivot.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      The position of the pivot, and whether the range was already partitioned.
+ */
+template<typename TpArray, typename TpCompare>
+std::pair<std::size_t, bool> __partition_right(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp
+)
+{
+    std::decay_t<decltype(array[0])> pivot = std::move(array[lo]);
+    std::size_t first = lo;
+    std::size_t last = hi;
+    bool already_partitioned;
+    
+    while (comp(array[++first], pivot))
+    {
+    }
+    
+    if (first - 1 == lo)
+    {
+        while (first < last && !comp(array[--last], pivot))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(array[--last], pivot))
+        {
+        }
+    }
+    
+    already_partitioned = first >= last;
+    
+    while (first < last)
+    {
+        std::swap(array[first], array[last]);
+        while (comp(array[++first], pivot))
+        {
+        }
+        while (!comp(array[--last], pivot))
+        {
+        }
+    }
+    
+    array[lo] = std::move(array[first - 1]);
+    array[first - 1] = std::move(pivot);
+    
+    return {first - 1, already_partitioned};
+}
+
+
+/**
+ * @brief       Partition a range around its first element like __partition_right, but without
+ *              branches depending on the comparisons. The comparison results are first stored as
+ *              offsets in small blocks, and the misplaced elements are then swapped in bulk, as
+ *              in BlockQuicksort.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range, that is the pivot.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      The position of the pivot, and whether the range was already partitioned.
+ */
+template<typename TpArray, typename TpCompare>
+std::pair<std::size_t, bool> __partition_right_branchless(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp
+)
+{
+    std::decay_t<decltype(array[0])> pivot = std::move(array[lo]);
+    std::size_t first = lo;
+    std::size_t last = hi;
+    bool already_partitioned;
+    
+    while (comp(array[++first], pivot))
+    {
+    }
+    
+    if (first - 1 == lo)
+    {
+        while (first < last && !comp(array[--last], pivot))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(array[--last], pivot))
+        {
+        }
+    }
+    
+    already_partitioned = first >= last;
+    
+    if (!already_partitioned)
+    {
+        alignas(64) unsigned char ofsts_l[PARTITION_BLOCK_SIZE];
+        alignas(64) unsigned char ofsts_r[PARTITION_BLOCK_SIZE];
+        std::size_t ofsts_l_bse;
+        std::size_t ofsts_r_bse;
+        std::size_t nbr_l = 0;
+        std::size_t nbr_r = 0;
+        std::size_t strt_l = 0;
+        std::size_t strt_r = 0;
+        std::size_t nbr_unknwn;
+        std::size_t l_split;
+        std::size_t r_split;
+        std::size_t nbr;
+        std::size_t i;
+        
+        std::swap(array[first], array[last]);
+        ++first;
+        ofsts_l_bse = first;
+        ofsts_r_bse = last;
+        
+        while (first < last)
+        {
+            nbr_unknwn = last - first;
+            l_split = nbr_l == 0 ? (nbr_r == 0 ? nbr_unknwn / 2 : nbr_unknwn) : 0;
+            r_split = nbr_r == 0 ? nbr_unknwn - l_split : 0;
+            
+            for (i = 0; i < l_split && i < PARTITION_BLOCK_SIZE; ++first)
+            {
+                ofsts_l[nbr_l] = static_cast<unsigned char>(i++);
+                nbr_l += !comp(array[first], pivot);
+            }
+            
+            for (i = 0; i < r_split && i < PARTITION_BLOCK_SIZE;)
+            {
+                ofsts_r[nbr_r] = static_cast<unsigned char>(++i);
+                nbr_r += comp(array[--last], pivot);
+            }
+            
+            nbr = std::min(nbr_l, nbr_r);
+            
+            if (nbr_l == nbr_r)
+            {
+                for (i = 0; i < nbr; ++i)
+                {
+                    std::swap(array[ofsts_l_bse + ofsts_l[strt_l + i]],
+                              array[ofsts_r_bse - ofsts_r[strt_r + i]]);
+                }
+            }
+            else if (nbr > 0)
+            {
+                std::size_t l = ofsts_l_bse + ofsts_l[strt_l];
+                std::size_t r = ofsts_r_bse - ofsts_r[strt_r];
+                std::decay_t<decltype(array[0])> tmp = std::move(array[l]);
+                
+                array[l] = std::move(array[r]);
+                for (i = 1; i < nbr; ++i)
+                {
+                    l = ofsts_l_bse + ofsts_l[strt_l + i];
+                    array[r] = std::move(array[l]);
+                    r = ofsts_r_bse - ofsts_r[strt_r + i];
+                    array[l] = std::move(array[r]);
+                }
+                array[r] = std::move(tmp);
+            }
+            
+            nbr_l -= nbr;
+            nbr_r -= nbr;
+            strt_l += nbr;
+            strt_r += nbr;
+            
+            if (nbr_l == 0)
+            {
+                strt_l = 0;
+                ofsts_l_bse = first;
+            }
+            
+            if (nbr_r == 0)
+            {
+                strt_r = 0;
+                ofsts_r_bse = last;
+            }
+        }
+        
+        if (nbr_l > 0)
+        {
+            while (nbr_l-- > 0)
+            {
+                std::swap(array[ofsts_l_bse + ofsts_l[strt_l + nbr_l]], array[--last]);
+            }
+            first = last;
+        }
+        
+        if (nbr_r > 0)
+        {
+            while (nbr_r-- > 0)
+            {
+                std::swap(array[ofsts_r_bse - ofsts_r[strt_r + nbr_r]], array[first]);
+                ++first;
+            }
+        }
+    }
+    
+    array[lo] = std::move(array[first - 1]);
+    array[first - 1] = std::move(pivot);
+    
+    return {first - 1, already_partitioned};
+}
+
+
+/**
+ * @brief       Partition a range around its first element, placing the elements equal to the
+ *              pivot on the left. It is used when the pivot is equal to the element preceding the
+ *              range, so that all the elements equal to the pivot are put in place at once and
+ *              the ranges with many duplicates are sorted in linear time.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range, that is the pivot.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      The position of the pivot.
+ */
+template<typename TpArray, typename TpCompare>
+std::size_t __partition_left(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+{
+    std::decay_t<decltype(array[0])> pivot = std::move(array[lo]);
+    std::size_t first = lo;
+    std::size_t last = hi;
+    
+    while (comp(pivot, array[--last]))
+    {
+    }
+    
+    if (last + 1 == hi)
+    {
+        while (first < last && !comp(pivot, array[++first]))
+        {
+        }
+    }
+    else
+    {
+        while (!comp(pivot, array[++first]))
+        {
+        }
+    }
+    
+    while (first < last)
+    {
+        std::swap(array[first], array[last]);
+        while (comp(pivot, array[--last]))
+        {
+        }
+        while (!comp(pivot, array[++first]))
+        {
+        }
+    }
+    
+    array[lo] = std::move(array[last]);
+    array[last] = std::move(pivot);
+    
+    return last;
+}
+
+
+/**
+ * @brief       Sort a range with a pattern-defeating quicksort. Only the smallest partition is
+ *              sorted recursively, so the stack depth is O(log(n)). The small ranges are sorted
+ *              with sorting networks when the partitioning is branchless and they are very small,
+ *              and by insertion otherwise.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @param       bad_allowed : Number of unbalanced partitions allowed before falling back to a
+ *              heapsort.
+ * @param       leftmost : Whether the range is the leftmost one, that is whether there is no
+ *              element before it that is not greater than all its elements.
+ */
+template<bool BRANCHLESS, typename TpArray, typename TpCompare>
+void __quicksort(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp,
+        std::size_t bad_allowed,
+        bool leftmost
+)
+{
+    std::size_t sz;
+    std::size_t hlf;
+    std::size_t pivot_pos;
+    std::size_t l_sz;
+    std::size_t r_sz;
+    bool already_partitioned;
+    
+    while (true)
+    {
+        sz = hi - lo;
+        
+        if constexpr (BRANCHLESS)
+        {
+            if (sz < STATIC_SORT_THRESHOLD)
+            {
+                __static_sort_dispatch<STATIC_SORT_THRESHOLD>(array, lo, sz, comp);
+                return;
+            }
+        }
+        
+        if (sz < INSERTION_SORT_THRESHOLD)
+        {
+            if (leftmost)
+            {
+                __insertion_sort(array, lo, hi, comp);
+            }
+            else
+            {
+                __unguarded_insertion_sort(array, lo, hi, comp);
+            }
+            
+            return;
+        }
+        
+        hlf = sz / 2;
+        if (sz > NINTHER_THRESHOLD)
+        {
+            __sort3(array, lo, lo + hlf, hi - 1, comp);
+            __sort3(array, lo + 1, lo + hlf - 1, hi - 2, comp);
+            __sort3(array, lo + 2, lo + hlf + 1, hi - 3, comp);
+            __sort3(array, lo + hlf - 1, lo + hlf, lo + hlf + 1, comp);
+            std::swap(array[lo], array[lo + hlf]);
+        }
+        else
+        {
+            __sort3(array, lo + hlf, lo, hi - 1, comp);
+        }
+        
+        if (!leftmost && !comp(array[lo - 1], array[lo]))
+        {
+            lo = __partition_left(array, lo, hi, comp) + 1;
+            continue;
+        }
+        
+        if constexpr (BRANCHLESS)
+        {
+            std::tie(pivot_pos, already_partitioned) =
+                    __partition_right_branchless(array, lo, hi, comp);
+        }
+        else
+        {
+            std::tie(pivot_pos, already_partitioned) = __partition_right(array, lo, hi, comp);
+        }
+        
+        l_sz = pivot_pos - lo;
+        r_sz = hi - (pivot_pos + 1);
+        
+        if (l_sz < sz / 8 || r_sz < sz / 8)
+        {
+            if (--bad_allowed == 0)
+            {
+                __heapsort(array, lo, hi, comp);
+                return;
+            }
+            
+            if (l_sz >= INSERTION_SORT_THRESHOLD)
+            {
+                std::swap(array[lo], array[lo + l_sz / 4]);
+                std::swap(array[pivot_pos - 1], array[pivot_pos - l_sz / 4]);
+                
+                if (l_sz > NINTHER_THRESHOLD)
+                {
+                    std::swap(array[lo + 1], array[lo + l_sz / 4 + 1]);
+                    std::swap(array[lo + 2], array[lo + l_sz / 4 + 2]);
+                    std::swap(array[pivot_pos - 2], array[pivot_pos - l_sz / 4 - 1]);
+                    std::swap(array[pivot_pos - 3], array[pivot_pos - l_sz / 4 - 2]);
+                }
+            }
+            
+            if (r_sz >= INSERTION_SORT_THRESHOLD)
+            {
+                std::swap(array[pivot_pos + 1], array[pivot_pos + 1 + r_sz / 4]);
+                std::swap(array[hi - 1], array[hi - r_sz / 4]);
+                
+                if (r_sz > NINTHER_THRESHOLD)
+                {
+                    std::swap(array[pivot_pos + 2], array[pivot_pos + 2 + r_sz / 4]);
+                    std::swap(array[pivot_pos + 3], array[pivot_pos + 3 + r_sz / 4]);
+                    std::swap(array[hi - 2], array[hi - 1 - r_sz / 4]);
+                    std::swap(array[hi - 3], array[hi - 2 - r_sz / 4]);
+                }
+            }
+        }
+        else if (already_partitioned &&
+                 __partial_insertion_sort(array, lo, pivot_pos, comp) &&
+                 __partial_insertion_sort(array, pivot_pos + 1, hi, comp))
+        {
+            return;
+        }
+        
+        if (l_sz < r_sz)
+        {
+            __quicksort<BRANCHLESS>(array, lo, pivot_pos, comp, bad_allowed, leftmost);
+            lo = pivot_pos + 1;
+            leftmost = false;
+        }
+        else
+        {
+            __quicksort<BRANCHLESS>(array, pivot_pos + 1, hi, comp, bad_allowed, false);
+            hi = pivot_pos;
         }
-        __quicksort(array, partition_index + 1, hi, comp);
     }
 }
 
@@ -108,7 +711,14 @@ struct simple_compare
 
 
 /**
- * @brief       Quicksort the array elements.
+ * @brief       Sort the array elements with a pattern-defeating quicksort. The pivot is the
+ *              median of three elements, or the pseudo-median of nine elements on large ranges,
+ *              and the small ranges are sorted by insertion. Runs of elements equal to a previous
+ *              pivot are gathered in a single pass, the sorted and reversed inputs are detected,
+ *              and a heapsort takes over when the partitions keep being unbalanced, so the sort
+ *              is O(n * log(n)) in the worst case. Arithmetic types compared with the default
+ *              comparison are partitioned without branches depending on the comparisons, and
+ *              their small partitions are sorted with static_sort. The sort is not stable.
  * @param       array : The array to sort.
  * @param       sz : The array size.
  * @param       comp : Binary function that accepts two elements in the range as arguments, and
@@ -118,20 +728,30 @@ struct simple_compare
 template<typename TpArray, typename TpCompare>
 void quicksort(TpArray& array, std::size_t sz, const TpCompare& comp)
 {
-    __hidden_algorithm::__quicksort(array, 0, sz - 1, comp);
+    using value_type = std::decay_t<decltype(array[0])>;
+    
+    constexpr bool branchless = std::is_arithmetic<value_type>::value &&
+            (std::is_same<TpCompare, simple_compare<value_type>>::value ||
+             std::is_same<TpCompare, std::less<value_type>>::value ||
+             std::is_same<TpCompare, std::less<>>::value);
+    
+    if (sz > 1)
+    {
+        __hidden_algorithm::__quicksort<branchless>(array, 0, sz, comp,
+                                                    __hidden_algorithm::__log2(sz), true);
+    }
 }
 
 
 /**
- * @brief       Quicksort the array elements.
+ * @brief       Sort the array elements with a pattern-defeating quicksort.
  * @param       array : The array to sort.
  * @param       sz : The array size.
  */
 template<typename TpArray>
 void quicksort(TpArray& array, std::size_t sz)
 {
-    simple_compare<std::remove_reference_t<decltype(array[0])>> comp;
-    __hidden_algorithm::__quicksort(array, 0, sz - 1, comp);
+    quicksort(array, sz, simple_compare<std::decay_t<decltype(array[0])>>());
 }
 
 
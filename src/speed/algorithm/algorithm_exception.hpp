@@ -0,0 +1,92 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/algorithm_exception.hpp
+ * @brief       algorithm_exception main header.
+ * @author      Killian
+ * @date        2018/09/27 - 09:05
+ */
+
+#ifndef SPEED_ALGORITHM_ALGORITHM_EXCEPTION_HPP
+#define SPEED_ALGORITHM_ALGORITHM_EXCEPTION_HPP
+
+#include "../exception.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/**
+ * @brief       Base class used to throw exceptions when an algorithm operation fails.
+ */
+class algorithm_exception : public speed::exception::exception_base
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "algorithm exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when an argument is not valid.
+ */
+class invalid_argument_exception : public algorithm_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "invalid argument exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when a file can not be opened, read or written.
+ */
+class io_exception : public algorithm_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "io exception";
+    }
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,265 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/argsort.hpp
+ * @brief       argsort functions header.
+ * @author      Killian
+ * @date        2018/09/28 - 15:37
+ */
+
+#ifndef SPEED_ALGORITHM_ARGSORT_HPP
+#define SPEED_ALGORITHM_ARGSORT_HPP
+
+#include <cstdlib>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "radix_sort.hpp"
+#include "timsort.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/**
+ * @brief       Get the indexes of the array elements in the order in which the elements would be
+ *              if the array was sorted. The indexes are sorted with a timsort comparing the
+ *              elements they refer to, so the order is stable and the elements are not moved.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The indexes of the array elements, in the sorted order.
+ */
+template<typename TpArray, typename TpCompare>
+std::vector<std::size_t> argsort(const TpArray& array, std::size_t sz, const TpCompare& comp)
+{
+    std::vector<std::size_t> idxs(sz);
+    
+    for (std::size_t i = 0; i < sz; ++i)
+    {
+        idxs[i] = i;
+    }
+    
+    timsort(idxs, sz, [&array, &comp](std::size_t lhs, std::size_t rhs)
+    {
+        return comp(array[lhs], array[rhs]);
+    });
+    
+    return idxs;
+}
+
+
+/**
+ * @brief       Get the indexes of the array elements in the order in which the elements would be
+ *              if the array was sorted.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @return      The indexes of the array elements, in the sorted order.
+ */
+template<typename TpArray>
+std::vector<std::size_t> argsort(const TpArray& array, std::size_t sz)
+{
+    return argsort(array, sz, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+
+/**
+ * @brief       Get the indexes of the array elements in the order in which the elements would be
+ *              if the array was sorted by a key. The keys are extracted once in a compact array of
+ *              key-index pairs that is sorted with a timsort, so the comparisons do not reach the
+ *              elements and the order is stable.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       ky_extr : Function that accepts an element of the range as argument, and returns
+ *              its key.
+ * @param       comp : Binary function that accepts two keys as arguments, and returns a value
+ *              convertible to bool. The value returned indicates whether the key passed as first
+ *              argument is considered to go before the second.
+ * @return      The indexes of the array elements, in the sorted order.
+ */
+template<typename TpArray, typename TpKeyExtractor, typename TpCompare>
+std::vector<std::size_t> argsort_by_key(
+        const TpArray& array,
+        std::size_t sz,
+        const TpKeyExtractor& ky_extr,
+        const TpCompare& comp
+)
+{
+    using key_type = std::decay_t<decltype(ky_extr(array[0]))>;
+    
+    std::vector<std::pair<key_type, std::size_t>> prs;
+    std::vector<std::size_t> idxs(sz);
+    std::size_t i;
+    
+    prs.reserve(sz);
+    for (i = 0; i < sz; ++i)
+    {
+        prs.emplace_back(ky_extr(array[i]), i);
+    }
+    
+    timsort(prs, sz, [&comp](const auto& lhs, const auto& rhs)
+    {
+        return comp(lhs.first, rhs.first);
+    });
+    
+    for (i = 0; i < sz; ++i)
+    {
+        idxs[i] = prs[i].second;
+    }
+    
+    return idxs;
+}
+
+
+/**
+ * @brief       Get the indexes of the array elements in the order in which the elements would be
+ *              if the array was sorted by a key. The key-index pairs are sorted with radix_sort
+ *              if the keys are arithmetic or convertible to std::string_view, otherwise with a
+ *              timsort. The order is stable.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       ky_extr : Function that accepts an element of the range as argument, and returns
+ *              its key.
+ * @return      The indexes of the array elements, in the sorted order.
+ */
+template<typename TpArray, typename TpKeyExtractor>
+std::vector<std::size_t> argsort_by_key(
+        const TpArray& array,
+        std::size_t sz,
+        const TpKeyExtractor& ky_extr
+)
+{
+    using key_type = std::decay_t<decltype(ky_extr(array[0]))>;
+    
+    if constexpr (std::is_arithmetic<key_type>::value ||
+                  std::is_convertible<key_type, std::string_view>::value)
+    {
+        std::vector<std::pair<key_type, std::size_t>> prs;
+        std::vector<std::size_t> idxs(sz);
+        std::size_t i;
+        
+        prs.reserve(sz);
+        for (i = 0; i < sz; ++i)
+        {
+            prs.emplace_back(ky_extr(array[i]), i);
+        }
+        
+        radix_sort(prs, sz, [](const auto& pr) -> const key_type&
+        {
+            return pr.first;
+        });
+        
+        for (i = 0; i < sz; ++i)
+        {
+            idxs[i] = prs[i].second;
+        }
+        
+        return idxs;
+    }
+    else
+    {
+        return argsort_by_key(array, sz, ky_extr, simple_compare<key_type>());
+    }
+}
+
+
+/**
+ * @brief       Rearrange the array elements in the order given by indexes, by following the
+ *              cycles of the permutation, so every element is moved once and no copy of the array
+ *              is needed.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       idxs : The indexes of the elements in their new order, that is the index of the
+ *              element placed at position i is idxs[i]. It has to be a permutation of the array
+ *              indexes. It is used to mark the elements moved, and holds the identity permutation
+ *              when the function returns.
+ */
+template<typename TpArray, typename TpIndexArray>
+void apply_permutation(TpArray& array, std::size_t sz, TpIndexArray& idxs)
+{
+    std::size_t j;
+    std::size_t k;
+    
+    for (std::size_t i = 0; i < sz; ++i)
+    {
+        if (idxs[i] == i)
+        {
+            continue;
+        }
+        
+        std::decay_t<decltype(array[0])> tmp = std::move(array[i]);
+        
+        j = i;
+        while ((k = idxs[j]) != i)
+        {
+            array[j] = std::move(array[k]);
+            idxs[j] = j;
+            j = k;
+        }
+        
+        array[j] = std::move(tmp);
+        idxs[j] = j;
+    }
+}
+
+
+/**
+ * @brief       Sort the array elements with a stable indirect sort. The indexes of the elements
+ *              are sorted with argsort, and the elements are then moved once each to their place
+ *              with apply_permutation. It is faster than a direct sort when the elements are
+ *              expensive to move.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ */
+template<typename TpArray, typename TpCompare>
+void indirect_sort(TpArray& array, std::size_t sz, const TpCompare& comp)
+{
+    std::vector<std::size_t> idxs = argsort(array, sz, comp);
+    
+    apply_permutation(array, sz, idxs);
+}
+
+
+/**
+ * @brief       Sort the array elements with a stable indirect sort.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ */
+template<typename TpArray>
+void indirect_sort(TpArray& array, std::size_t sz)
+{
+    indirect_sort(array, sz, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+
+}
+}
+
+
+#endif
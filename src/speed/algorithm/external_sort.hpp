@@ -0,0 +1,1022 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/external_sort.hpp
+ * @brief       external_sort functions header.
+ * @author      Killian
+ * @date        2018/09/27 - 09:20
+ */
+
+#ifndef SPEED_ALGORITHM_EXTERNAL_SORT_HPP
+#define SPEED_ALGORITHM_EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "algorithm_exception.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** Default maximum number of bytes of records held in memory by an external sort. */
+constexpr std::size_t EXTERNAL_SORT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+/** Default maximum number of runs merged at once by an external sort. */
+constexpr std::size_t EXTERNAL_SORT_MERGE_WAYS = 64;
+
+/** Default size in bytes of the buffers used to read and write the files of an external sort. */
+constexpr std::size_t EXTERNAL_SORT_BUFFER_SIZE = 1024 * 1024;
+
+
+/**
+ * @brief       Options of an external sort.
+ */
+struct external_sort_options
+{
+    /** The maximum number of bytes of records held in memory to sort a run. The buffers of a
+     *  merge are shrunk to fit in it too, and the memory of the runs is freed before the merges,
+     *  so the budget bounds the whole sort. */
+    std::size_t mem_budget = EXTERNAL_SORT_MEMORY_BUDGET;
+    
+    /** The maximum number of runs merged at once. If there are more runs, several merge passes
+     *  are done. */
+    std::size_t nbr_ways = EXTERNAL_SORT_MERGE_WAYS;
+    
+    /** The size in bytes of the buffers used to read and write the files. */
+    std::size_t buf_sz = EXTERNAL_SORT_BUFFER_SIZE;
+    
+    /** The directory where the runs are spilled. If it is a null pointer, the temporary
+     *  directory of the system is used. */
+    const char* tmp_dir = nullptr;
+};
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/**
+ * @brief       Temporary file that holds a run. It is removed when the object is destroyed.
+ */
+class __tmp_file
+{
+public:
+    /**
+     * @brief       Constructor with parameters. It creates an empty file with a unique name.
+     * @param       dir : The directory where the file is created.
+     * @throw       speed::algorithm::io_exception : If the file can not be created.
+     */
+    explicit __tmp_file(const std::string& dir)
+            : pth_()
+            , fle_(nullptr)
+    {
+        static std::mt19937_64 gen{std::random_device()()};
+        static std::mutex gen_mtx;
+        char nme[32];
+        
+        for (int i = 0; i < 16 && fle_ == nullptr; ++i)
+        {
+            {
+                std::lock_guard<std::mutex> lck(gen_mtx);
+                std::snprintf(nme, sizeof(nme), "/speed_xsort_%016llx",
+                              static_cast<unsigned long long>(gen()));
+            }
+            
+            pth_ = dir + nme;
+            fle_ = std::fopen(pth_.c_str(), "w+bx");
+        }
+        
+        if (fle_ == nullptr)
+        {
+            throw io_exception();
+        }
+        
+        std::setvbuf(fle_, nullptr, _IONBF, 0);
+    }
+    
+    __tmp_file(const __tmp_file&) = delete;
+    
+    __tmp_file& operator =(const __tmp_file&) = delete;
+    
+    /**
+     * @brief       Destructor. It closes and removes the file.
+     */
+    ~__tmp_file()
+    {
+        std::fclose(fle_);
+        std::remove(pth_.c_str());
+    }
+    
+    /**
+     * @brief       Get the file stream.
+     * @return      The file stream.
+     */
+    [[nodiscard]] std::FILE* get_stream() const noexcept
+    {
+        return fle_;
+    }
+
+private:
+    /** The file path. */
+    std::string pth_;
+    
+    /** The file stream. */
+    std::FILE* fle_;
+};
+
+
+/**
+ * @brief       Writer that gathers records in a large buffer and writes it sequentially.
+ */
+class __record_writer
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       fle : The file stream to write.
+     * @param       buf_sz : The size of the buffer in bytes.
+     */
+    __record_writer(std::FILE* fle, std::size_t buf_sz)
+            : buf_(std::make_unique<unsigned char[]>(buf_sz))
+            , fle_(fle)
+            , buf_sz_(buf_sz)
+            , pos_(0)
+    {
+    }
+    
+    /**
+     * @brief       Write bytes.
+     * @param       src : The bytes to write.
+     * @param       sz : The number of bytes to write.
+     * @throw       speed::algorithm::io_exception : If the file can not be written.
+     */
+    void write(const unsigned char* src, std::size_t sz)
+    {
+        std::size_t cpy_sz;
+        
+        while (sz > 0)
+        {
+            if (pos_ == buf_sz_)
+            {
+                flush();
+            }
+            
+            cpy_sz = std::min(sz, buf_sz_ - pos_);
+            std::memcpy(buf_.get() + pos_, src, cpy_sz);
+            pos_ += cpy_sz;
+            src += cpy_sz;
+            sz -= cpy_sz;
+        }
+    }
+    
+    /**
+     * @brief       Write the bytes held in the buffer.
+     * @throw       speed::algorithm::io_exception : If the file can not be written.
+     */
+    void flush()
+    {
+        if (pos_ > 0 && std::fwrite(buf_.get(), 1, pos_, fle_) != pos_)
+        {
+            throw io_exception();
+        }
+        
+        pos_ = 0;
+    }
+
+private:
+    /** The buffer. */
+    std::unique_ptr<unsigned char[]> buf_;
+    
+    /** The file stream. */
+    std::FILE* fle_;
+    
+    /** The size of the buffer in bytes. */
+    std::size_t buf_sz_;
+    
+    /** The number of bytes held in the buffer. */
+    std::size_t pos_;
+};
+
+
+class __read_ahead;
+
+
+/**
+ * @brief       Reader of the records of a run. It has two buffers: the records are read from the
+ *              front one while the back one is filled by a read-ahead thread.
+ */
+class __run_reader
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       fle : The file stream to read, positioned at the beginning of the run.
+     * @param       buf_sz : The size of each buffer in bytes, a multiple of the record size.
+     * @param       rec_sz : The size of a record in bytes.
+     */
+    __run_reader(std::FILE* fle, std::size_t buf_sz, std::size_t rec_sz)
+            : bufs_{std::make_unique<unsigned char[]>(buf_sz),
+                    std::make_unique<unsigned char[]>(buf_sz)}
+            , fle_(fle)
+            , cur_(nullptr)
+            , end_(nullptr)
+            , buf_sz_(buf_sz)
+            , rec_sz_(rec_sz)
+            , bck_sz_(0)
+            , frnt_(1)
+            , pndng_(false)
+            , err_(false)
+    {
+    }
+    
+    /**
+     * @brief       Get the current record.
+     * @return      The current record, or a null pointer if all the records have been read.
+     */
+    [[nodiscard]] const unsigned char* get() const noexcept
+    {
+        return cur_;
+    }
+    
+    /**
+     * @brief       Move to the next record.
+     * @param       rd_ahd : The read-ahead thread that fills the buffers.
+     */
+    inline void next(__read_ahead& rd_ahd);
+    
+    /**
+     * @brief       Swap the buffers once the back one is filled, and request to fill the new back
+     *              one if the end of the run has not been reached.
+     * @param       rd_ahd : The read-ahead thread that fills the buffers.
+     * @throw       speed::algorithm::io_exception : If the file can not be read.
+     */
+    inline void swap_buffers(__read_ahead& rd_ahd);
+    
+    /**
+     * @brief       Fill the back buffer. It is called by the read-ahead thread.
+     */
+    void fill_back() noexcept
+    {
+        bck_sz_ = std::fread(bufs_[frnt_ ^ 1].get(), 1, buf_sz_, fle_);
+        if (bck_sz_ < buf_sz_ && std::ferror(fle_))
+        {
+            err_ = true;
+        }
+    }
+
+private:
+    /** The buffers. */
+    std::unique_ptr<unsigned char[]> bufs_[2];
+    
+    /** The file stream. */
+    std::FILE* fle_;
+    
+    /** The current record. */
+    const unsigned char* cur_;
+    
+    /** The end of the records held in the front buffer. */
+    const unsigned char* end_;
+    
+    /** The size of each buffer in bytes. */
+    std::size_t buf_sz_;
+    
+    /** The size of a record in bytes. */
+    std::size_t rec_sz_;
+    
+    /** The number of bytes held in the back buffer. */
+    std::size_t bck_sz_;
+    
+    /** The index of the front buffer. */
+    std::size_t frnt_;
+    
+    /** Whether the back buffer is being filled. */
+    bool pndng_;
+    
+    /** Whether the file could not be read. */
+    bool err_;
+    
+    friend class __read_ahead;
+};
+
+
+/**
+ * @brief       Thread that fills the back buffers of the run readers, so the reads overlap the
+ *              merge.
+ */
+class __read_ahead
+{
+public:
+    /**
+     * @brief       Default constructor. It starts the thread.
+     */
+    __read_ahead()
+            : qu_()
+            , mtx_()
+            , rqst_cv_()
+            , dne_cv_()
+            , thrd_()
+            , stop_(false)
+    {
+        thrd_ = std::thread(&__read_ahead::work, this);
+    }
+    
+    __read_ahead(const __read_ahead&) = delete;
+    
+    __read_ahead& operator =(const __read_ahead&) = delete;
+    
+    /**
+     * @brief       Destructor. It waits for the fill in progress and stops the thread.
+     */
+    ~__read_ahead()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            stop_ = true;
+        }
+        
+        rqst_cv_.notify_one();
+        thrd_.join();
+    }
+    
+    /**
+     * @brief       Request to fill the back buffer of a reader.
+     * @param       rdr : The reader.
+     */
+    void request(__run_reader& rdr)
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            
+            rdr.pndng_ = true;
+            qu_.push_back(&rdr);
+        }
+        
+        rqst_cv_.notify_one();
+    }
+    
+    /**
+     * @brief       Wait for the back buffer of a reader to be filled.
+     * @param       rdr : The reader.
+     */
+    void wait(__run_reader& rdr)
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        dne_cv_.wait(lck, [&] { return !rdr.pndng_; });
+    }
+
+private:
+    /**
+     * @brief       Fill the back buffers requested until the object is destroyed.
+     */
+    void work()
+    {
+        __run_reader* rdr;
+        
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lck(mtx_);
+                
+                rqst_cv_.wait(lck, [this] { return stop_ || !qu_.empty(); });
+                if (stop_)
+                {
+                    return;
+                }
+                
+                rdr = qu_.front();
+                qu_.pop_front();
+            }
+            
+            rdr->fill_back();
+            
+            {
+                std::lock_guard<std::mutex> lck(mtx_);
+                rdr->pndng_ = false;
+            }
+            
+            dne_cv_.notify_all();
+        }
+    }
+    
+    /** The readers whose back buffer has to be filled. */
+    std::deque<__run_reader*> qu_;
+    
+    /** Mutex that protects the queue and the pending flags of the readers. */
+    std::mutex mtx_;
+    
+    /** Condition variable notified when a fill is requested or the object is destroyed. */
+    std::condition_variable rqst_cv_;
+    
+    /** Condition variable notified when a back buffer has been filled. */
+    std::condition_variable dne_cv_;
+    
+    /** The thread. */
+    std::thread thrd_;
+    
+    /** Whether the thread has to stop. */
+    bool stop_;
+};
+
+
+void __run_reader::next(__read_ahead& rd_ahd)
+{
+    cur_ += rec_sz_;
+    if (cur_ == end_)
+    {
+        swap_buffers(rd_ahd);
+    }
+}
+
+
+void __run_reader::swap_buffers(__read_ahead& rd_ahd)
+{
+    rd_ahd.wait(*this);
+    if (err_)
+    {
+        throw io_exception();
+    }
+    
+    frnt_ ^= 1;
+    if (bck_sz_ == 0)
+    {
+        cur_ = nullptr;
+        return;
+    }
+    
+    cur_ = bufs_[frnt_].get();
+    end_ = cur_ + bck_sz_;
+    
+    if (bck_sz_ == buf_sz_)
+    {
+        rd_ahd.request(*this);
+    }
+    else
+    {
+        bck_sz_ = 0;
+    }
+}
+
+
+/**
+ * @brief       Chunk of values sorted in memory to make a run.
+ */
+template<typename TpValue, typename TpCompare>
+class __value_chunk
+{
+public:
+    /**
+     * @brief       Constructor with parameters. The memory is allocated by allocate.
+     * @param       mem_budget : The maximum number of bytes of values held.
+     * @param       comp : The comparison function.
+     */
+    __value_chunk(std::size_t mem_budget, const TpCompare& comp)
+            : vals_()
+            , cap_(std::max(mem_budget / sizeof(TpValue), std::size_t(1)))
+            , comp_(comp)
+    {
+    }
+    
+    /**
+     * @brief       Allocate the memory of the chunk.
+     * @param       nbr_recs : The number of records to sort. The chunk holds this number of
+     *              records if it fits in the memory budget.
+     */
+    void allocate(std::size_t nbr_recs)
+    {
+        cap_ = std::max(std::min(cap_, nbr_recs), std::size_t(1));
+        vals_.reset(new TpValue[cap_]);
+    }
+    
+    /**
+     * @brief       Free the memory of the chunk, once all the runs are made.
+     */
+    void release() noexcept
+    {
+        vals_.reset();
+    }
+    
+    /**
+     * @brief       Get the buffer where the records are read.
+     * @return      The buffer where the records are read.
+     */
+    [[nodiscard]] unsigned char* get_buffer() noexcept
+    {
+        return reinterpret_cast<unsigned char*>(vals_.get());
+    }
+    
+    /**
+     * @brief       Get the maximum number of records held.
+     * @return      The maximum number of records held.
+     */
+    [[nodiscard]] std::size_t get_capacity() const noexcept
+    {
+        return cap_;
+    }
+    
+    /**
+     * @brief       Sort the records read and write them.
+     * @param       nbr_recs : The number of records read.
+     * @param       wrtr : The writer.
+     */
+    void sort(std::size_t nbr_recs, __record_writer& wrtr)
+    {
+        quicksort(vals_, nbr_recs, comp_);
+        wrtr.write(get_buffer(), nbr_recs * sizeof(TpValue));
+    }
+
+private:
+    /** The values. */
+    std::unique_ptr<TpValue[]> vals_;
+    
+    /** The maximum number of records held. */
+    std::size_t cap_;
+    
+    /** The comparison function. */
+    const TpCompare& comp_;
+};
+
+
+/**
+ * @brief       Chunk of fixed-size records sorted in memory to make a run. The pointers to the
+ *              records are sorted, and the records are written in their order.
+ */
+template<typename TpCompare>
+class __record_chunk
+{
+public:
+    /**
+     * @brief       Constructor with parameters. The memory is allocated by allocate.
+     * @param       mem_budget : The maximum number of bytes of records and pointers held.
+     * @param       rec_sz : The size of a record in bytes.
+     * @param       comp : The comparison function.
+     */
+    __record_chunk(std::size_t mem_budget, std::size_t rec_sz, const TpCompare& comp)
+            : ptrs_()
+            , buf_()
+            , cap_(std::max(mem_budget / (rec_sz + sizeof(const unsigned char*)),
+                            std::size_t(1)))
+            , rec_sz_(rec_sz)
+            , comp_(comp)
+    {
+    }
+    
+    /**
+     * @brief       Allocate the memory of the chunk.
+     * @param       nbr_recs : The number of records to sort. The chunk holds this number of
+     *              records if it fits in the memory budget.
+     */
+    void allocate(std::size_t nbr_recs)
+    {
+        cap_ = std::max(std::min(cap_, nbr_recs), std::size_t(1));
+        ptrs_.reset(new const unsigned char*[cap_]);
+        buf_.reset(new unsigned char[cap_ * rec_sz_]);
+    }
+    
+    /**
+     * @brief       Free the memory of the chunk, once all the runs are made.
+     */
+    void release() noexcept
+    {
+        ptrs_.reset();
+        buf_.reset();
+    }
+    
+    /**
+     * @brief       Get the buffer where the records are read.
+     * @return      The buffer where the records are read.
+     */
+    [[nodiscard]] unsigned char* get_buffer() noexcept
+    {
+        return buf_.get();
+    }
+    
+    /**
+     * @brief       Get the maximum number of records held.
+     * @return      The maximum number of records held.
+     */
+    [[nodiscard]] std::size_t get_capacity() const noexcept
+    {
+        return cap_;
+    }
+    
+    /**
+     * @brief       Sort the records read and write them.
+     * @param       nbr_recs : The number of records read.
+     * @param       wrtr : The writer.
+     */
+    void sort(std::size_t nbr_recs, __record_writer& wrtr)
+    {
+        for (std::size_t i = 0; i < nbr_recs; ++i)
+        {
+            ptrs_[i] = buf_.get() + i * rec_sz_;
+        }
+        
+        quicksort(ptrs_, nbr_recs, comp_);
+        for (std::size_t i = 0; i < nbr_recs; ++i)
+        {
+            wrtr.write(ptrs_[i], rec_sz_);
+        }
+    }
+
+private:
+    /** The pointers to the records. */
+    std::unique_ptr<const unsigned char*[]> ptrs_;
+    
+    /** The records. */
+    std::unique_ptr<unsigned char[]> buf_;
+    
+    /** The maximum number of records held. */
+    std::size_t cap_;
+    
+    /** The size of a record in bytes. */
+    std::size_t rec_sz_;
+    
+    /** The comparison function. */
+    const TpCompare& comp_;
+};
+
+
+/**
+ * @brief       Merge runs with a loser tree. The tree keeps the run of the lowest current record
+ *              at its root and, at every inner node, the run that lost the match played there, so
+ *              once a record is written only the matches on the path of its run are replayed,
+ *              that is log2(k) comparisons for k runs.
+ * @param       runs : The runs to merge, in files positioned at their beginning.
+ * @param       nbr_runs : The number of runs to merge.
+ * @param       dest : The file stream where the merged records are written.
+ * @param       rec_sz : The size of a record in bytes.
+ * @param       buf_sz : The size in bytes of the buffers, a multiple of the record size.
+ * @param       comp : The comparison function, that receives pointers to the records.
+ */
+template<typename TpCompare>
+void __merge_runs(
+        std::unique_ptr<__tmp_file>* runs,
+        std::size_t nbr_runs,
+        std::FILE* dest,
+        std::size_t rec_sz,
+        std::size_t buf_sz,
+        const TpCompare& comp
+)
+{
+    std::vector<std::unique_ptr<__run_reader>> rdrs;
+    std::vector<std::size_t> lsrs(nbr_runs);
+    std::vector<std::size_t> wnrs(2 * nbr_runs);
+    std::size_t wnr;
+    std::size_t i;
+    
+    auto wins = [&](std::size_t lhs, std::size_t rhs)
+    {
+        const unsigned char* lhs_rec = rdrs[lhs]->get();
+        const unsigned char* rhs_rec = rdrs[rhs]->get();
+        
+        return lhs_rec != nullptr && (rhs_rec == nullptr || comp(lhs_rec, rhs_rec));
+    };
+    
+    rdrs.reserve(nbr_runs);
+    for (i = 0; i < nbr_runs; ++i)
+    {
+        std::rewind(runs[i]->get_stream());
+        rdrs.push_back(std::make_unique<__run_reader>(runs[i]->get_stream(), buf_sz, rec_sz));
+    }
+    
+    __read_ahead rd_ahd;
+    __record_writer wrtr(dest, buf_sz);
+    
+    for (i = 0; i < nbr_runs; ++i)
+    {
+        rd_ahd.request(*rdrs[i]);
+    }
+    
+    for (i = 0; i < nbr_runs; ++i)
+    {
+        rdrs[i]->swap_buffers(rd_ahd);
+        wnrs[nbr_runs + i] = i;
+    }
+    
+    for (i = nbr_runs; i-- > 1;)
+    {
+        if (wins(wnrs[2 * i], wnrs[2 * i + 1]))
+        {
+            wnrs[i] = wnrs[2 * i];
+            lsrs[i] = wnrs[2 * i + 1];
+        }
+        else
+        {
+            wnrs[i] = wnrs[2 * i + 1];
+            lsrs[i] = wnrs[2 * i];
+        }
+    }
+    
+    wnr = nbr_runs > 1 ? wnrs[1] : 0;
+    while (rdrs[wnr]->get() != nullptr)
+    {
+        wrtr.write(rdrs[wnr]->get(), rec_sz);
+        rdrs[wnr]->next(rd_ahd);
+        
+        for (i = (nbr_runs + wnr) / 2; i > 0; i /= 2)
+        {
+            if (wins(lsrs[i], wnr))
+            {
+                std::swap(lsrs[i], wnr);
+            }
+        }
+    }
+    
+    wrtr.flush();
+}
+
+
+/**
+ * @brief       Sort a file of fixed-size records. The file is read in chunks that fit in the
+ *              memory budget, every chunk is sorted in memory and spilled as a run in a temporary
+ *              file, and the runs are merged with a loser tree, in several passes if there are more
+ *              runs than merge ways. If the whole file fits in one chunk, it is sorted in memory
+ *              and no temporary file is created. The chunk is not larger than the file.
+ * @param       src_path : The path of the file to sort.
+ * @param       dest_path : The path of the file where the sorted records are written. It can be
+ *              the path of the file to sort.
+ * @param       rec_sz : The size of a record in bytes.
+ * @param       chnk : The chunk that sorts the records in memory.
+ * @param       comp : The comparison function, that receives pointers to the records.
+ * @param       opts : The options.
+ */
+template<typename TpChunk, typename TpCompare>
+void __external_sort(
+        const char* src_path,
+        const char* dest_path,
+        std::size_t rec_sz,
+        TpChunk& chnk,
+        const TpCompare& comp,
+        const external_sort_options& opts
+)
+{
+    using file_ptr = std::unique_ptr<std::FILE, int (*)(std::FILE*)>;
+    
+    std::error_code err_code;
+    const std::string tmp_dir = opts.tmp_dir != nullptr
+            ? std::string(opts.tmp_dir)
+            : std::filesystem::temp_directory_path(err_code).string();
+    const std::size_t nbr_ways = std::max(opts.nbr_ways, std::size_t(2));
+    std::size_t buf_sz = std::min(opts.buf_sz, opts.mem_budget / (2 * nbr_ways + 1));
+    std::vector<std::unique_ptr<__tmp_file>> runs;
+    std::vector<std::unique_ptr<__tmp_file>> nxt_runs;
+    long src_sz;
+    std::size_t nbr_recs;
+    std::size_t chnk_sz;
+    std::size_t i;
+    
+    buf_sz = std::max(buf_sz / rec_sz, std::size_t(1)) * rec_sz;
+    
+    file_ptr src(std::fopen(src_path, "rb"), &std::fclose);
+    if (src == nullptr || std::fseek(src.get(), 0, SEEK_END) != 0 ||
+        (src_sz = std::ftell(src.get())) < 0 || std::fseek(src.get(), 0, SEEK_SET) != 0)
+    {
+        throw io_exception();
+    }
+    
+    if (static_cast<std::size_t>(src_sz) % rec_sz != 0)
+    {
+        throw invalid_argument_exception();
+    }
+    
+    nbr_recs = static_cast<std::size_t>(src_sz) / rec_sz;
+    chnk.allocate(nbr_recs);
+    
+    if (nbr_recs <= chnk.get_capacity())
+    {
+        if (std::fread(chnk.get_buffer(), rec_sz, nbr_recs, src.get()) != nbr_recs)
+        {
+            throw io_exception();
+        }
+        
+        src.reset();
+        
+        file_ptr dest(std::fopen(dest_path, "wb"), &std::fclose);
+        if (dest == nullptr)
+        {
+            throw io_exception();
+        }
+        
+        __record_writer wrtr(dest.get(), buf_sz);
+        
+        chnk.sort(nbr_recs, wrtr);
+        wrtr.flush();
+        
+        if (std::fclose(dest.release()) != 0)
+        {
+            throw io_exception();
+        }
+        
+        return;
+    }
+    
+    if (tmp_dir.empty())
+    {
+        throw io_exception();
+    }
+    
+    for (i = 0; i < nbr_recs; i += chnk_sz)
+    {
+        chnk_sz = std::min(chnk.get_capacity(), nbr_recs - i);
+        if (std::fread(chnk.get_buffer(), rec_sz, chnk_sz, src.get()) != chnk_sz)
+        {
+            throw io_exception();
+        }
+        
+        runs.push_back(std::make_unique<__tmp_file>(tmp_dir));
+        
+        __record_writer wrtr(runs.back()->get_stream(), buf_sz);
+        
+        chnk.sort(chnk_sz, wrtr);
+        wrtr.flush();
+    }
+    
+    src.reset();
+    chnk.release();
+    
+    while (runs.size() > nbr_ways)
+    {
+        for (i = 0; i < runs.size(); i += nbr_ways)
+        {
+            nxt_runs.push_back(std::make_unique<__tmp_file>(tmp_dir));
+            __merge_runs(runs.data() + i, std::min(nbr_ways, runs.size() - i),
+                         nxt_runs.back()->get_stream(), rec_sz, buf_sz, comp);
+            
+            for (std::size_t j = i; j < std::min(i + nbr_ways, runs.size()); ++j)
+            {
+                runs[j].reset();
+            }
+        }
+        
+        runs.swap(nxt_runs);
+        nxt_runs.clear();
+    }
+    
+    file_ptr dest(std::fopen(dest_path, "wb"), &std::fclose);
+    if (dest == nullptr)
+    {
+        throw io_exception();
+    }
+    
+    __merge_runs(runs.data(), runs.size(), dest.get(), rec_sz, buf_sz, comp);
+    
+    if (std::fclose(dest.release()) != 0)
+    {
+        throw io_exception();
+    }
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Sort a binary file of values that does not need to fit in memory. The file is read
+ *              in chunks that fit in the memory budget, every chunk is sorted in memory with
+ *              quicksort and spilled as a run in a temporary file, and the runs are merged with a
+ *              loser tree through large sequential reads and writes, with the next buffer of every
+ *              run read ahead by a background thread while the current one is merged.
+ * @param       src_path : The path of the file to sort, that holds values in their binary
+ *              representation.
+ * @param       dest_path : The path of the file where the sorted values are written. It can be
+ *              the path of the file to sort.
+ * @param       comp : Binary function that accepts two values as arguments, and returns a value
+ *              convertible to bool. The value returned indicates whether the value passed as
+ *              first argument is considered to go before the second.
+ * @param       opts : The options.
+ * @throw       speed::algorithm::io_exception : If a file can not be opened, read or written.
+ * @throw       speed::algorithm::invalid_argument_exception : If the size of the file to sort is
+ *              not a multiple of the size of a value.
+ */
+template<typename TpValue, typename TpCompare>
+void external_sort(
+        const char* src_path,
+        const char* dest_path,
+        const TpCompare& comp,
+        const external_sort_options& opts = external_sort_options()
+)
+{
+    static_assert(std::is_trivially_copyable<TpValue>::value,
+                  "The values have to be trivially copyable.");
+    
+    auto rec_comp = [&comp](const unsigned char* lhs, const unsigned char* rhs)
+    {
+        TpValue lhs_val;
+        TpValue rhs_val;
+        
+        std::memcpy(&lhs_val, lhs, sizeof(TpValue));
+        std::memcpy(&rhs_val, rhs, sizeof(TpValue));
+        
+        return comp(lhs_val, rhs_val);
+    };
+    
+    __hidden_algorithm::__value_chunk<TpValue, TpCompare> chnk(opts.mem_budget, comp);
+    
+    __hidden_algorithm::__external_sort(src_path, dest_path, sizeof(TpValue), chnk, rec_comp,
+                                        opts);
+}
+
+
+/**
+ * @brief       Sort a binary file of values that does not need to fit in memory.
+ * @param       src_path : The path of the file to sort.
+ * @param       dest_path : The path of the file where the sorted values are written.
+ * @param       opts : The options.
+ * @throw       speed::algorithm::io_exception : If a file can not be opened, read or written.
+ * @throw       speed::algorithm::invalid_argument_exception : If the size of the file to sort is
+ *              not a multiple of the size of a value.
+ */
+template<typename TpValue>
+void external_sort(
+        const char* src_path,
+        const char* dest_path,
+        const external_sort_options& opts = external_sort_options()
+)
+{
+    external_sort<TpValue>(src_path, dest_path, simple_compare<TpValue>(), opts);
+}
+
+
+/**
+ * @brief       Sort a binary file of fixed-size records that does not need to fit in memory. It
+ *              works like external_sort, but the records are opaque: the pointers to the records
+ *              of a chunk are sorted, and the records are compared through pointers.
+ * @param       src_path : The path of the file to sort.
+ * @param       dest_path : The path of the file where the sorted records are written. It can be
+ *              the path of the file to sort.
+ * @param       rec_sz : The size of a record in bytes.
+ * @param       comp : Binary function that accepts two pointers to records as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              record pointed by the first argument is considered to go before the second.
+ * @param       opts : The options.
+ * @throw       speed::algorithm::io_exception : If a file can not be opened, read or written.
+ * @throw       speed::algorithm::invalid_argument_exception : If the record size is 0 or the
+ *              size of the file to sort is not a multiple of it.
+ */
+template<typename TpCompare>
+void external_sort_records(
+        const char* src_path,
+        const char* dest_path,
+        std::size_t rec_sz,
+        const TpCompare& comp,
+        const external_sort_options& opts = external_sort_options()
+)
+{
+    if (rec_sz == 0)
+    {
+        throw invalid_argument_exception();
+    }
+    
+    auto rec_comp = [&comp](const unsigned char* lhs, const unsigned char* rhs)
+    {
+        return comp(lhs, rhs);
+    };
+    
+    __hidden_algorithm::__record_chunk<decltype(rec_comp)> chnk(opts.mem_budget, rec_sz,
+                                                                  rec_comp);
+    
+    __hidden_algorithm::__external_sort(src_path, dest_path, rec_sz, chnk, rec_comp, opts);
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,624 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/parallel.hpp
+ * @brief       parallel functions header.
+ * @author      Killian
+ * @date        2018/09/26 - 16:21
+ */
+
+#ifndef SPEED_ALGORITHM_PARALLEL_HPP
+#define SPEED_ALGORITHM_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstdlib>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "work_stealing_executor.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Minimum number of elements processed by a task of the parallel algorithms. */
+constexpr std::size_t PARALLEL_MIN_GRAIN_SIZE = 4096;
+
+/** Number of tasks per thread of the parallel algorithms, so that the load can be balanced. */
+constexpr std::size_t PARALLEL_TASKS_PER_THREAD = 8;
+
+
+/**
+ * @brief       Get the number of tasks to split a range in. Every task processes at least
+ *              PARALLEL_MIN_GRAIN_SIZE elements, so that the scheduling cost stays small, and
+ *              there are at most PARALLEL_TASKS_PER_THREAD tasks per thread.
+ * @param       sz : The range size.
+ * @param       concurrency : The number of threads of the executor.
+ * @return      The number of tasks, at least 1.
+ */
+constexpr std::size_t __get_number_of_tasks(std::size_t sz, std::size_t concurrency) noexcept
+{
+    return std::max(std::min(sz / PARALLEL_MIN_GRAIN_SIZE, concurrency * PARALLEL_TASKS_PER_THREAD),
+                    std::size_t(1));
+}
+
+
+/**
+ * @brief       Get the index of the first element of a task.
+ * @param       sz : The range size.
+ * @param       nbr_tasks : The number of tasks.
+ * @param       task_idx : The index of the task.
+ * @return      The index of the first element of the task.
+ */
+constexpr std::size_t __get_task_begin(
+        std::size_t sz,
+        std::size_t nbr_tasks,
+        std::size_t task_idx
+) noexcept
+{
+    return sz / nbr_tasks * task_idx + std::min(task_idx, sz % nbr_tasks);
+}
+
+
+/**
+ * @brief       Split a range in tasks and run them on an executor.
+ * @param       sz : The range size.
+ * @param       exec : The executor.
+ * @param       fnc : The function to call for every task, that receives the index of the task,
+ *              the index of its first element, and the index of its past-the-end element.
+ */
+template<typename TpExecutor, typename TpFunction>
+void __run_tasks(std::size_t sz, TpExecutor& exec, const TpFunction& fnc)
+{
+    const std::size_t nbr_tasks = __get_number_of_tasks(sz, exec.get_concurrency());
+    
+    if (nbr_tasks == 1)
+    {
+        fnc(0, 0, sz);
+        return;
+    }
+    
+    exec.bulk_run(nbr_tasks, [&](std::size_t task_idx)
+    {
+        fnc(task_idx, __get_task_begin(sz, nbr_tasks, task_idx),
+            __get_task_begin(sz, nbr_tasks, task_idx + 1));
+    });
+}
+
+
+/**
+ * @brief       Reduce the transformed elements of a range. Four independent accumulators are
+ *              used, so that the successive operations do not depend on each other.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range, greater than lo.
+ * @param       reduce_op : The reduction operation.
+ * @param       transform_op : The transformation operation.
+ * @return      The reduction of the transformed elements.
+ */
+template<typename TpArray, typename TpReduceOperation, typename TpTransformOperation>
+auto __transform_reduce(
+        const TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpReduceOperation& reduce_op,
+        const TpTransformOperation& transform_op
+)
+{
+    using result_type = std::decay_t<decltype(transform_op(array[lo]))>;
+    
+    if (hi - lo < 8)
+    {
+        result_type acc = transform_op(array[lo]);
+        
+        for (++lo; lo < hi; ++lo)
+        {
+            acc = reduce_op(std::move(acc), transform_op(array[lo]));
+        }
+        
+        return acc;
+    }
+    
+    result_type acc0 = transform_op(array[lo]);
+    result_type acc1 = transform_op(array[lo + 1]);
+    result_type acc2 = transform_op(array[lo + 2]);
+    result_type acc3 = transform_op(array[lo + 3]);
+    
+    for (lo += 4; lo + 4 <= hi; lo += 4)
+    {
+        acc0 = reduce_op(std::move(acc0), transform_op(array[lo]));
+        acc1 = reduce_op(std::move(acc1), transform_op(array[lo + 1]));
+        acc2 = reduce_op(std::move(acc2), transform_op(array[lo + 2]));
+        acc3 = reduce_op(std::move(acc3), transform_op(array[lo + 3]));
+    }
+    
+    for (; lo < hi; ++lo)
+    {
+        acc0 = reduce_op(std::move(acc0), transform_op(array[lo]));
+    }
+    
+    return reduce_op(reduce_op(std::move(acc0), std::move(acc1)),
+                     reduce_op(std::move(acc2), std::move(acc3)));
+}
+
+
+/**
+ * @brief       Compute the prefix reductions of a range, starting from an initial value.
+ * @param       src : The source array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       dest : The destination array.
+ * @param       acc : The initial value.
+ * @param       op : The reduction operation.
+ * @param       inclsv : Whether the element at an index is included in the reduction stored at
+ *              this index.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpValue,
+         typename TpOperation>
+void __scan(
+        const TpSourceArray& src,
+        std::size_t lo,
+        std::size_t hi,
+        TpDestinationArray& dest,
+        TpValue acc,
+        const TpOperation& op,
+        bool inclsv
+)
+{
+    if (inclsv)
+    {
+        for (; lo < hi; ++lo)
+        {
+            acc = op(std::move(acc), src[lo]);
+            dest[lo] = acc;
+        }
+    }
+    else
+    {
+        for (; lo < hi; ++lo)
+        {
+            TpValue nxt = op(acc, src[lo]);
+            
+            dest[lo] = std::move(acc);
+            acc = std::move(nxt);
+        }
+    }
+}
+
+
+/**
+ * @brief       Compute the prefix reductions of an array in parallel. The reduction of every task
+ *              is computed first, the prefix reductions of the tasks are then computed
+ *              sequentially, and every task finally computes the prefix reductions of its
+ *              elements starting from the reduction of the tasks before it.
+ * @param       src : The source array.
+ * @param       sz : The array size.
+ * @param       dest : The destination array.
+ * @param       init : The initial value, if any.
+ * @param       op : The reduction operation.
+ * @param       exec : The executor.
+ * @param       inclsv : Whether the element at an index is included in the reduction stored at
+ *              this index.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpValue,
+         typename TpOperation, typename TpExecutor>
+void __parallel_scan(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        std::optional<TpValue> init,
+        const TpOperation& op,
+        TpExecutor& exec,
+        bool inclsv
+)
+{
+    const std::size_t nbr_tasks = __get_number_of_tasks(sz, exec.get_concurrency());
+    std::vector<std::optional<TpValue>> ofsts(nbr_tasks);
+    
+    if (sz == 0)
+    {
+        return;
+    }
+    
+    if (nbr_tasks == 1)
+    {
+        if (init)
+        {
+            __scan(src, 0, sz, dest, std::move(*init), op, inclsv);
+        }
+        else
+        {
+            dest[0] = src[0];
+            __scan(src, 1, sz, dest, TpValue(src[0]), op, true);
+        }
+        
+        return;
+    }
+    
+    auto identity = [](const auto& x) -> TpValue { return x; };
+    
+    exec.bulk_run(nbr_tasks - 1, [&](std::size_t task_idx)
+    {
+        ofsts[task_idx + 1] = __transform_reduce(
+                src, __get_task_begin(sz, nbr_tasks, task_idx),
+                __get_task_begin(sz, nbr_tasks, task_idx + 1), op, identity);
+    });
+    
+    ofsts[0] = std::move(init);
+    for (std::size_t i = 1; i < nbr_tasks; ++i)
+    {
+        if (ofsts[i - 1])
+        {
+            ofsts[i] = op(*ofsts[i - 1], std::move(*ofsts[i]));
+        }
+    }
+    
+    exec.bulk_run(nbr_tasks, [&](std::size_t task_idx)
+    {
+        std::size_t lo = __get_task_begin(sz, nbr_tasks, task_idx);
+        std::size_t hi = __get_task_begin(sz, nbr_tasks, task_idx + 1);
+        
+        if (ofsts[task_idx])
+        {
+            __scan(src, lo, hi, dest, std::move(*ofsts[task_idx]), op, inclsv);
+        }
+        else
+        {
+            dest[lo] = src[lo];
+            __scan(src, lo + 1, hi, dest, TpValue(src[lo]), op, true);
+        }
+    });
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Call a function on every element of an array, in parallel. The array is split in
+ *              tasks of consecutive elements, whose size is chosen from the array size and the
+ *              number of threads, and the tasks are run by an executor. An executor is an object
+ *              with a get_concurrency() function, that returns its number of threads, and a
+ *              bulk_run(nbr_tasks, fnc) function, that calls fnc(task_idx) for every task and
+ *              waits for them, like work_stealing_executor and sequential_executor.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       fnc : Function that accepts an element of the array as argument. It is called
+ *              concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpArray, typename TpFunction, typename TpExecutor>
+void parallel_for_each(TpArray& array, std::size_t sz, const TpFunction& fnc, TpExecutor& exec)
+{
+    __hidden_algorithm::__run_tasks(sz, exec, [&](std::size_t, std::size_t lo, std::size_t hi)
+    {
+        for (; lo < hi; ++lo)
+        {
+            fnc(array[lo]);
+        }
+    });
+}
+
+
+/**
+ * @brief       Call a function on every element of an array, in parallel, with the default
+ *              executor.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       fnc : Function that accepts an element of the array as argument. It is called
+ *              concurrently from several threads.
+ */
+template<typename TpArray, typename TpFunction>
+void parallel_for_each(TpArray& array, std::size_t sz, const TpFunction& fnc)
+{
+    parallel_for_each(array, sz, fnc, get_default_executor());
+}
+
+
+/**
+ * @brief       Store the transformed elements of an array in another array, in parallel.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       op : Function that accepts an element of the source array as argument, and returns
+ *              the value to store. It is called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpOperation,
+         typename TpExecutor>
+void parallel_transform(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        const TpOperation& op,
+        TpExecutor& exec
+)
+{
+    __hidden_algorithm::__run_tasks(sz, exec, [&](std::size_t, std::size_t lo, std::size_t hi)
+    {
+        for (; lo < hi; ++lo)
+        {
+            dest[lo] = op(src[lo]);
+        }
+    });
+}
+
+
+/**
+ * @brief       Store the transformed elements of an array in another array, in parallel, with
+ *              the default executor.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       op : Function that accepts an element of the source array as argument, and returns
+ *              the value to store. It is called concurrently from several threads.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpOperation>
+void parallel_transform(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        const TpOperation& op
+)
+{
+    parallel_transform(src, sz, dest, op, get_default_executor());
+}
+
+
+/**
+ * @brief       Reduce the transformed elements of an array, in parallel. Every task reduces its
+ *              elements with four independent accumulators, and the results of the tasks are then
+ *              reduced in order, so the reduction operation has to be associative and
+ *              commutative.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       init : The initial value of the reduction.
+ * @param       reduce_op : Binary function that accepts two values as arguments, and returns
+ *              their reduction. It is called concurrently from several threads.
+ * @param       transform_op : Function that accepts an element of the array as argument, and
+ *              returns the value to reduce. It is called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ * @return      The reduction of the initial value and the transformed elements.
+ */
+template<typename TpArray, typename TpValue, typename TpReduceOperation,
+         typename TpTransformOperation, typename TpExecutor>
+TpValue parallel_transform_reduce(
+        const TpArray& array,
+        std::size_t sz,
+        TpValue init,
+        const TpReduceOperation& reduce_op,
+        const TpTransformOperation& transform_op,
+        TpExecutor& exec
+)
+{
+    std::vector<std::optional<TpValue>> accs(
+            __hidden_algorithm::__get_number_of_tasks(sz, exec.get_concurrency()));
+    
+    if (sz == 0)
+    {
+        return init;
+    }
+    
+    auto transform = [&](const auto& x) -> TpValue { return transform_op(x); };
+    
+    __hidden_algorithm::__run_tasks(sz, exec, [&](std::size_t task_idx, std::size_t lo,
+                                                  std::size_t hi)
+    {
+        accs[task_idx] = __hidden_algorithm::__transform_reduce(array, lo, hi, reduce_op,
+                                                                transform);
+    });
+    
+    for (auto& x : accs)
+    {
+        init = reduce_op(std::move(init), std::move(*x));
+    }
+    
+    return init;
+}
+
+
+/**
+ * @brief       Reduce the transformed elements of an array, in parallel, with the default
+ *              executor.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       init : The initial value of the reduction.
+ * @param       reduce_op : Binary function that accepts two values as arguments, and returns
+ *              their reduction. It is called concurrently from several threads.
+ * @param       transform_op : Function that accepts an element of the array as argument, and
+ *              returns the value to reduce. It is called concurrently from several threads.
+ * @return      The reduction of the initial value and the transformed elements.
+ */
+template<typename TpArray, typename TpValue, typename TpReduceOperation,
+         typename TpTransformOperation>
+TpValue parallel_transform_reduce(
+        const TpArray& array,
+        std::size_t sz,
+        TpValue init,
+        const TpReduceOperation& reduce_op,
+        const TpTransformOperation& transform_op
+)
+{
+    return parallel_transform_reduce(array, sz, std::move(init), reduce_op, transform_op,
+                                     get_default_executor());
+}
+
+
+/**
+ * @brief       Reduce the elements of an array, in parallel. The reduction operation has to be
+ *              associative and commutative.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       init : The initial value of the reduction.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ * @return      The reduction of the initial value and the elements.
+ */
+template<typename TpArray, typename TpValue, typename TpOperation, typename TpExecutor>
+TpValue parallel_reduce(
+        const TpArray& array,
+        std::size_t sz,
+        TpValue init,
+        const TpOperation& op,
+        TpExecutor& exec
+)
+{
+    return parallel_transform_reduce(array, sz, std::move(init), op,
+                                     [](const auto& x) -> const auto& { return x; }, exec);
+}
+
+
+/**
+ * @brief       Reduce the elements of an array, in parallel, with the default executor.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       init : The initial value of the reduction.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ * @return      The reduction of the initial value and the elements.
+ */
+template<typename TpArray, typename TpValue, typename TpOperation>
+TpValue parallel_reduce(const TpArray& array, std::size_t sz, TpValue init, const TpOperation& op)
+{
+    return parallel_reduce(array, sz, std::move(init), op, get_default_executor());
+}
+
+
+/**
+ * @brief       Store the inclusive prefix reductions of an array in another array, in parallel,
+ *              that is the reduction of the elements up to every index, this one included. The
+ *              array is read twice, once to reduce every task and once to store its prefix
+ *              reductions, so the reduction operation has to be associative.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpOperation,
+         typename TpExecutor>
+void parallel_inclusive_scan(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        const TpOperation& op,
+        TpExecutor& exec
+)
+{
+    __hidden_algorithm::__parallel_scan<TpSourceArray, TpDestinationArray,
+                                        std::decay_t<decltype(src[0])>>(
+            src, sz, dest, std::nullopt, op, exec, true);
+}
+
+
+/**
+ * @brief       Store the inclusive prefix reductions of an array in another array, in parallel,
+ *              with the default executor.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpOperation>
+void parallel_inclusive_scan(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        const TpOperation& op
+)
+{
+    parallel_inclusive_scan(src, sz, dest, op, get_default_executor());
+}
+
+
+/**
+ * @brief       Store the exclusive prefix reductions of an array in another array, in parallel,
+ *              that is the reduction of an initial value and the elements before every index. The
+ *              reduction operation has to be associative.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       init : The initial value, stored at the index 0.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpValue,
+         typename TpOperation, typename TpExecutor>
+void parallel_exclusive_scan(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        TpValue init,
+        const TpOperation& op,
+        TpExecutor& exec
+)
+{
+    __hidden_algorithm::__parallel_scan<TpSourceArray, TpDestinationArray, TpValue>(
+            src, sz, dest, std::move(init), op, exec, false);
+}
+
+
+/**
+ * @brief       Store the exclusive prefix reductions of an array in another array, in parallel,
+ *              with the default executor.
+ * @param       src : The source array.
+ * @param       sz : The source array size.
+ * @param       dest : The destination array, that has at least sz elements. It can be the source
+ *              array.
+ * @param       init : The initial value, stored at the index 0.
+ * @param       op : Binary function that accepts two values as arguments, and returns their
+ *              reduction. It is called concurrently from several threads.
+ */
+template<typename TpSourceArray, typename TpDestinationArray, typename TpValue,
+         typename TpOperation>
+void parallel_exclusive_scan(
+        const TpSourceArray& src,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        TpValue init,
+        const TpOperation& op
+)
+{
+    parallel_exclusive_scan(src, sz, dest, std::move(init), op, get_default_executor());
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,259 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/parallel_sort.hpp
+ * @brief       parallel_sort functions header.
+ * @author      Killian
+ * @date        2018/09/21 - 10:12
+ */
+
+#ifndef SPEED_ALGORITHM_PARALLEL_SORT_HPP
+#define SPEED_ALGORITHM_PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "work_stealing_executor.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Size under which parallel_sort uses the sequential sort. */
+constexpr std::size_t PARALLEL_SORT_THRESHOLD = 1 << 16;
+
+/** Minimum number of elements handled by every chunk of parallel_sort. */
+constexpr std::size_t PARALLEL_SORT_MIN_PER_CHUNK = 1 << 14;
+
+/** Number of buckets per chunk, so that the threads that finish early can take more work. */
+constexpr std::size_t PARALLEL_SORT_BUCKETS_PER_CHUNK = 8;
+
+/** Number of samples taken per bucket to choose the splitters. */
+constexpr std::size_t PARALLEL_SORT_OVERSAMPLING = 16;
+
+
+/**
+ * @brief       Sort an array with a parallel sample sort. The splitters are chosen from a random
+ *              sample, the elements of every chunk of the array are distributed in buckets by one
+ *              task, and every bucket is sorted and moved back by one task, the largest first.
+ *              Every splitter has its own bucket for the elements equal to it, which needs no
+ *              sort, so the inputs with few distinct values are handled efficiently.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       comp : The comparison function.
+ * @param       nbr_chnks : The number of chunks, greater than 1.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpArray, typename TpCompare, typename TpExecutor>
+void __parallel_sample_sort(
+        TpArray& array,
+        std::size_t sz,
+        const TpCompare& comp,
+        std::size_t nbr_chnks,
+        TpExecutor& exec
+)
+{
+    using value_type = std::decay_t<decltype(array[0])>;
+    
+    const std::size_t nbr_spltrs = nbr_chnks * PARALLEL_SORT_BUCKETS_PER_CHUNK - 1;
+    const std::size_t nbr_bkts = 2 * nbr_spltrs + 1;
+    std::vector<value_type> smpls;
+    std::vector<value_type> spltrs;
+    std::vector<value_type> buf(sz);
+    std::vector<std::uint32_t> bkt_ids(sz);
+    std::vector<std::size_t> cnts(nbr_chnks * nbr_bkts, 0);
+    std::vector<std::size_t> bkt_strts(nbr_bkts + 1, 0);
+    std::vector<std::size_t> bkt_ordr(nbr_bkts);
+    std::mt19937_64 gen(sz);
+    std::size_t ofst;
+    
+    smpls.reserve((nbr_spltrs + 1) * PARALLEL_SORT_OVERSAMPLING);
+    for (std::size_t i = 0; i < (nbr_spltrs + 1) * PARALLEL_SORT_OVERSAMPLING; ++i)
+    {
+        smpls.push_back(array[static_cast<std::size_t>(gen() % sz)]);
+    }
+    
+    quicksort(smpls, smpls.size(), comp);
+    
+    spltrs.reserve(nbr_spltrs);
+    for (std::size_t i = 1; i <= nbr_spltrs; ++i)
+    {
+        spltrs.push_back(smpls[i * PARALLEL_SORT_OVERSAMPLING]);
+    }
+    
+    auto get_chunk_begin = [&](std::size_t chnk_idx)
+    {
+        return sz / nbr_chnks * chnk_idx + std::min(chnk_idx, sz % nbr_chnks);
+    };
+    
+    exec.bulk_run(nbr_chnks, [&](std::size_t chnk_idx)
+    {
+        std::size_t* chnk_cnts = cnts.data() + chnk_idx * nbr_bkts;
+        std::size_t spltr_idx;
+        
+        for (std::size_t i = get_chunk_begin(chnk_idx); i < get_chunk_begin(chnk_idx + 1); ++i)
+        {
+            spltr_idx = static_cast<std::size_t>(
+                    std::lower_bound(spltrs.begin(), spltrs.end(), array[i], comp) -
+                    spltrs.begin());
+            
+            if (spltr_idx < nbr_spltrs && !comp(array[i], spltrs[spltr_idx]))
+            {
+                bkt_ids[i] = static_cast<std::uint32_t>(2 * spltr_idx + 1);
+            }
+            else
+            {
+                bkt_ids[i] = static_cast<std::uint32_t>(2 * spltr_idx);
+            }
+            
+            ++chnk_cnts[bkt_ids[i]];
+        }
+    });
+    
+    ofst = 0;
+    for (std::size_t i = 0; i < nbr_bkts; ++i)
+    {
+        bkt_strts[i] = ofst;
+        for (std::size_t j = 0; j < nbr_chnks; ++j)
+        {
+            std::swap(ofst, cnts[j * nbr_bkts + i]);
+            ofst += cnts[j * nbr_bkts + i];
+        }
+    }
+    bkt_strts[nbr_bkts] = sz;
+    
+    exec.bulk_run(nbr_chnks, [&](std::size_t chnk_idx)
+    {
+        std::size_t* chnk_ofsts = cnts.data() + chnk_idx * nbr_bkts;
+        
+        for (std::size_t i = get_chunk_begin(chnk_idx); i < get_chunk_begin(chnk_idx + 1); ++i)
+        {
+            buf[chnk_ofsts[bkt_ids[i]]++] = std::move(array[i]);
+        }
+    });
+    
+    for (std::size_t i = 0; i < nbr_bkts; ++i)
+    {
+        bkt_ordr[i] = i;
+    }
+    
+    std::sort(bkt_ordr.begin(), bkt_ordr.end(), [&](std::size_t lhs, std::size_t rhs)
+    {
+        return bkt_strts[lhs + 1] - bkt_strts[lhs] > bkt_strts[rhs + 1] - bkt_strts[rhs];
+    });
+    
+    exec.bulk_run(nbr_bkts, [&](std::size_t bkt_idx)
+    {
+        const std::size_t bkt = bkt_ordr[bkt_idx];
+        value_type* bkt_data = buf.data() + bkt_strts[bkt];
+        
+        if (bkt % 2 == 0)
+        {
+            quicksort(bkt_data, bkt_strts[bkt + 1] - bkt_strts[bkt], comp);
+        }
+        
+        for (std::size_t j = bkt_strts[bkt]; j < bkt_strts[bkt + 1]; ++j)
+        {
+            array[j] = std::move(buf[j]);
+        }
+    });
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Sort the array elements using several threads. The sort is a parallel sample
+ *              sort, which buffers the elements once, so it needs additional memory for one copy
+ *              of the array and the element type has to be default constructible. Its phases are
+ *              split in tasks that are run by an executor, like work_stealing_executor, so the
+ *              threads that finish early take work from the others. The small arrays are sorted
+ *              with quicksort on the calling thread. The sort is not stable. If an exception is
+ *              thrown, the content of the array is unspecified.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second. It is
+ *              called concurrently from several threads.
+ * @param       exec : The executor that runs the tasks.
+ */
+template<typename TpArray, typename TpCompare, typename TpExecutor>
+void parallel_sort(TpArray& array, std::size_t sz, const TpCompare& comp, TpExecutor& exec)
+{
+    const std::size_t nbr_chnks = std::min(exec.get_concurrency(),
+                                           sz / __hidden_algorithm::PARALLEL_SORT_MIN_PER_CHUNK);
+    
+    if (sz < __hidden_algorithm::PARALLEL_SORT_THRESHOLD || nbr_chnks <= 1)
+    {
+        quicksort(array, sz, comp);
+    }
+    else
+    {
+        __hidden_algorithm::__parallel_sample_sort(array, sz, comp, nbr_chnks, exec);
+    }
+}
+
+
+/**
+ * @brief       Sort the array elements using several threads, with the default executor.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second. It is
+ *              called concurrently from several threads.
+ */
+template<typename TpArray, typename TpCompare>
+void parallel_sort(TpArray& array, std::size_t sz, const TpCompare& comp)
+{
+    parallel_sort(array, sz, comp, get_default_executor());
+}
+
+
+/**
+ * @brief       Sort the array elements using several threads, with the default executor.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ */
+template<typename TpArray>
+void parallel_sort(TpArray& array, std::size_t sz)
+{
+    parallel_sort(array, sz, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+}
+}
+
+
+#endif
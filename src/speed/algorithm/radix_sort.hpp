@@ -0,0 +1,366 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/radix_sort.hpp
+ * @brief       radix_sort functions header.
+ * @author      Killian
+ * @date        2018/09/22 - 09:31
+ */
+
+#ifndef SPEED_ALGORITHM_RADIX_SORT_HPP
+#define SPEED_ALGORITHM_RADIX_SORT_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Size under which the string buckets are sorted by insertion. */
+constexpr std::size_t MSD_INSERTION_SORT_THRESHOLD = 32;
+
+
+/**
+ * @brief       Key extractor that returns the element itself.
+ */
+struct __identity_key
+{
+    template<typename T>
+    constexpr const T& operator()(const T& val) const noexcept
+    {
+        return val;
+    }
+};
+
+
+/**
+ * @brief       Unsigned integer type with the same size as a type.
+ */
+template<std::size_t SZ>
+struct __radix_unsigned;
+
+template<>
+struct __radix_unsigned<1>
+{
+    using type = std::uint8_t;
+};
+
+template<>
+struct __radix_unsigned<2>
+{
+    using type = std::uint16_t;
+};
+
+template<>
+struct __radix_unsigned<4>
+{
+    using type = std::uint32_t;
+};
+
+template<>
+struct __radix_unsigned<8>
+{
+    using type = std::uint64_t;
+};
+
+
+/**
+ * @brief       Convert an arithmetic key into an unsigned integer with the same order. The sign
+ *              bit of the signed integers is flipped, and the floating point numbers have their
+ *              sign bit flipped if they are positive, or all their bits flipped if they are
+ *              negative.
+ * @param       ky : The key.
+ * @return      The unsigned integer.
+ */
+template<typename TpKey>
+inline auto __get_radix_key(TpKey ky) noexcept
+{
+    using radix_type = typename __radix_unsigned<sizeof(TpKey)>::type;
+    
+    constexpr radix_type sign_bit = radix_type(1) << (sizeof(TpKey) * 8 - 1);
+    radix_type rdx;
+    
+    if constexpr (std::is_floating_point<TpKey>::value)
+    {
+        std::memcpy(&rdx, &ky, sizeof(TpKey));
+        
+        return static_cast<radix_type>((rdx & sign_bit) != 0 ? ~rdx : rdx | sign_bit);
+    }
+    else if constexpr (std::is_signed<TpKey>::value)
+    {
+        return static_cast<radix_type>(static_cast<radix_type>(ky) ^ sign_bit);
+    }
+    else
+    {
+        return static_cast<radix_type>(ky);
+    }
+}
+
+
+/**
+ * @brief       Sort an array with a least significant digit radix sort on arithmetic keys. The
+ *              histograms of all the bytes are computed in a single pass, and the passes on the
+ *              bytes that are equal for all the keys are skipped.
+ * @param       array : The array to sort.
+ * @param       sz : The array size, greater than 1.
+ * @param       ky_extr : The key extractor.
+ */
+template<typename TpArray, typename TpKeyExtractor>
+void __lsd_radix_sort(TpArray& array, std::size_t sz, const TpKeyExtractor& ky_extr)
+{
+    using value_type = std::decay_t<decltype(array[0])>;
+    using key_type = std::decay_t<decltype(ky_extr(array[0]))>;
+    
+    constexpr std::size_t nbr_dgts = sizeof(key_type);
+    std::size_t cnts[nbr_dgts][256] = {};
+    std::vector<value_type> buf;
+    bool in_buf = false;
+    std::size_t ofst;
+    std::size_t d;
+    std::size_t i;
+    
+    for (i = 0; i < sz; ++i)
+    {
+        auto rdx = __get_radix_key(ky_extr(array[i]));
+        
+        for (d = 0; d < nbr_dgts; ++d)
+        {
+            ++cnts[d][(rdx >> (d * 8)) & 0xff];
+        }
+    }
+    
+    auto scatter = [&](auto& src, auto& dst, std::size_t dgt)
+    {
+        for (std::size_t j = 0; j < sz; ++j)
+        {
+            dst[cnts[dgt][(__get_radix_key(ky_extr(src[j])) >> (dgt * 8)) & 0xff]++] =
+                    std::move(src[j]);
+        }
+    };
+    
+    for (d = 0; d < nbr_dgts; ++d)
+    {
+        if (cnts[d][(__get_radix_key(ky_extr(in_buf ? buf[0] : array[0])) >> (d * 8)) & 0xff] ==
+            sz)
+        {
+            continue;
+        }
+        
+        ofst = 0;
+        for (auto& x : cnts[d])
+        {
+            std::swap(ofst, x);
+            ofst += x;
+        }
+        
+        if (buf.empty())
+        {
+            buf.resize(sz);
+        }
+        
+        if (in_buf)
+        {
+            scatter(buf, array, d);
+        }
+        else
+        {
+            scatter(array, buf, d);
+        }
+        
+        in_buf = !in_buf;
+    }
+    
+    if (in_buf)
+    {
+        for (i = 0; i < sz; ++i)
+        {
+            array[i] = std::move(buf[i]);
+        }
+    }
+}
+
+
+/**
+ * @brief       Sort an array with a most significant digit radix sort on string keys. The
+ *              buckets are processed from an explicit stack, and the small buckets are sorted by
+ *              insertion.
+ * @param       array : The array to sort.
+ * @param       sz : The array size, greater than 1.
+ * @param       ky_extr : The key extractor.
+ */
+template<typename TpArray, typename TpKeyExtractor>
+void __msd_radix_sort(TpArray& array, std::size_t sz, const TpKeyExtractor& ky_extr)
+{
+    using value_type = std::decay_t<decltype(array[0])>;
+    
+    std::vector<value_type> buf(sz);
+    std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> stck;
+    std::size_t cnts[257];
+    std::size_t lo;
+    std::size_t hi;
+    std::size_t dpth;
+    std::size_t ofst;
+    std::size_t i;
+    std::size_t j;
+    
+    auto get_bucket = [&](const value_type& val, std::size_t pos) -> std::size_t
+    {
+        const auto& ky = ky_extr(val);
+        std::string_view ky_vw(ky);
+        
+        return pos < ky_vw.size() ? static_cast<unsigned char>(ky_vw[pos]) + std::size_t(1) : 0;
+    };
+    
+    stck.emplace_back(0, sz, 0);
+    while (!stck.empty())
+    {
+        std::tie(lo, hi, dpth) = stck.back();
+        stck.pop_back();
+        
+        if (hi - lo < MSD_INSERTION_SORT_THRESHOLD)
+        {
+            for (i = lo + 1; i < hi; ++i)
+            {
+                if (std::string_view(ky_extr(array[i])).substr(dpth) <
+                    std::string_view(ky_extr(array[i - 1])).substr(dpth))
+                {
+                    value_type tmp = std::move(array[i]);
+                    
+                    j = i;
+                    do
+                    {
+                        array[j] = std::move(array[j - 1]);
+                        --j;
+                    } while (j > lo && std::string_view(ky_extr(tmp)).substr(dpth) <
+                                       std::string_view(ky_extr(array[j - 1])).substr(dpth));
+                    
+                    array[j] = std::move(tmp);
+                }
+            }
+            
+            continue;
+        }
+        
+        std::memset(cnts, 0, sizeof(cnts));
+        for (i = lo; i < hi; ++i)
+        {
+            ++cnts[get_bucket(array[i], dpth)];
+        }
+        
+        ofst = lo;
+        for (auto& x : cnts)
+        {
+            std::swap(ofst, x);
+            ofst += x;
+        }
+        
+        for (i = lo; i < hi; ++i)
+        {
+            buf[cnts[get_bucket(array[i], dpth)]++] = std::move(array[i]);
+        }
+        
+        for (i = lo; i < hi; ++i)
+        {
+            array[i] = std::move(buf[i]);
+        }
+        
+        for (i = 1, ofst = cnts[0]; i < 257; ofst = cnts[i++])
+        {
+            if (cnts[i] - ofst > 1)
+            {
+                stck.emplace_back(ofst, cnts[i], dpth + 1);
+            }
+        }
+    }
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Sort the array elements by a key with a stable radix sort. The arithmetic keys,
+ *              integers or floating point numbers, are sorted with a least significant digit
+ *              radix sort on bytes. The negative zero is placed before the positive zero, and the
+ *              NaNs are placed at the ends according to their sign bit. The keys convertible to
+ *              std::string_view are sorted with a most significant digit radix sort on
+ *              characters, compared as unsigned chars. The sort needs additional memory for one
+ *              copy of the array, and the element type has to be default constructible.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       ky_extr : Function that accepts an element of the range as argument, and returns
+ *              its key.
+ */
+template<typename TpArray, typename TpKeyExtractor>
+void radix_sort(TpArray& array, std::size_t sz, const TpKeyExtractor& ky_extr)
+{
+    using key_type = std::decay_t<decltype(ky_extr(array[0]))>;
+    
+    static_assert(std::is_arithmetic<key_type>::value ||
+                  std::is_convertible<key_type, std::string_view>::value,
+                  "The key has to be arithmetic or convertible to std::string_view");
+    
+    if (sz < 2)
+    {
+        return;
+    }
+    
+    if constexpr (std::is_arithmetic<key_type>::value)
+    {
+        __hidden_algorithm::__lsd_radix_sort(array, sz, ky_extr);
+    }
+    else
+    {
+        __hidden_algorithm::__msd_radix_sort(array, sz, ky_extr);
+    }
+}
+
+
+/**
+ * @brief       Sort the array elements with a stable radix sort. The elements have to be
+ *              arithmetic or convertible to std::string_view.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ */
+template<typename TpArray>
+void radix_sort(TpArray& array, std::size_t sz)
+{
+    radix_sort(array, sz, __hidden_algorithm::__identity_key());
+}
+
+
+}
+}
+
+
+#endif
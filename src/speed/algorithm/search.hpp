@@ -0,0 +1,641 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/search.hpp
+ * @brief       search functions header.
+ * @author      Killian
+ * @date        2018/09/24 - 09:47
+ */
+
+#ifndef SPEED_ALGORITHM_SEARCH_HPP
+#define SPEED_ALGORITHM_SEARCH_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Number of elements of a node of the k-ary tree layout. */
+constexpr std::size_t KARY_SEARCH_PIVOTS = 16;
+
+
+/**
+ * @brief       Ask the processor to load the cache line of an element in advance.
+ * @param       ptr : The address of the element.
+ */
+inline void __prefetch(const void* ptr) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(ptr);
+#else
+    static_cast<void>(ptr);
+#endif
+}
+
+
+/**
+ * @brief       Get the number of consecutive bits set from the lowest bit of a number.
+ * @param       nbr : The number.
+ * @return      The number of consecutive bits set from the lowest bit.
+ */
+inline std::size_t __get_trailing_ones(std::size_t nbr) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return ~nbr == 0 ? sizeof(nbr) * 8 : static_cast<std::size_t>(__builtin_ctzll(~nbr));
+#else
+    std::size_t cnt = 0;
+    
+    for (; (nbr & 1) != 0; nbr >>= 1)
+    {
+        ++cnt;
+    }
+    
+    return cnt;
+#endif
+}
+
+
+/**
+ * @brief       Get whether a comparison function is the default less than comparison.
+ */
+template<typename TpValue, typename TpCompare>
+constexpr bool __is_default_compare = std::is_same<TpCompare, std::less<TpValue>>::value ||
+                                      std::is_same<TpCompare, std::less<>>::value;
+
+
+/**
+ * @brief       Get the index of the first element for which a predicate is false, on a range
+ *              partitioned by the predicate. The range is halved without branches depending on
+ *              the predicate, and the two possible next middle elements are prefetched.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       pred : The predicate.
+ * @return      The index of the first element for which the predicate is false, or sz.
+ */
+template<typename TpArray, typename TpPredicate>
+std::size_t __branchless_partition_point(
+        const TpArray& array,
+        std::size_t sz,
+        const TpPredicate& pred
+)
+{
+    std::size_t bse = 0;
+    std::size_t hlf;
+    
+    if (sz == 0)
+    {
+        return 0;
+    }
+    
+    while (sz > 1)
+    {
+        hlf = sz / 2;
+        sz -= hlf;
+        
+        __prefetch(std::addressof(array[bse + sz / 2]));
+        __prefetch(std::addressof(array[bse + hlf + sz / 2]));
+        
+        bse = pred(array[bse + hlf]) ? bse + hlf : bse;
+    }
+    
+    return bse + static_cast<std::size_t>(pred(array[bse]));
+}
+
+
+/**
+ * @brief       Copy the elements of a sorted array in the Eytzinger layout, through an in-order
+ *              traversal of the implicit tree.
+ * @param       src : The sorted array.
+ * @param       src_idx : The index of the next element of the sorted array to copy.
+ * @param       dest : The destination array.
+ * @param       nod : The node to fill, numbered from 1.
+ * @param       sz : The arrays size.
+ * @return      The index of the next element of the sorted array to copy.
+ */
+template<typename TpSourceArray, typename TpDestinationArray>
+std::size_t __make_eytzinger_layout(
+        const TpSourceArray& src,
+        std::size_t src_idx,
+        TpDestinationArray& dest,
+        std::size_t nod,
+        std::size_t sz
+)
+{
+    if (nod <= sz)
+    {
+        src_idx = __make_eytzinger_layout(src, src_idx, dest, 2 * nod, sz);
+        dest[nod - 1] = src[src_idx++];
+        src_idx = __make_eytzinger_layout(src, src_idx, dest, 2 * nod + 1, sz);
+    }
+    
+    return src_idx;
+}
+
+
+/**
+ * @brief       Get the index of the first element for which a predicate is false, on an array
+ *              in the Eytzinger layout. The tree is descended without branches depending on the
+ *              predicate, and the nodes four levels below are prefetched.
+ * @param       array : The array in the Eytzinger layout.
+ * @param       sz : The array size.
+ * @param       pred : The predicate.
+ * @return      The index of the first element for which the predicate is false, or sz.
+ */
+template<typename TpArray, typename TpPredicate>
+std::size_t __eytzinger_partition_point(
+        const TpArray& array,
+        std::size_t sz,
+        const TpPredicate& pred
+)
+{
+    std::size_t nod = 1;
+    
+    while (nod <= sz)
+    {
+        __prefetch(std::addressof(array[std::min(16 * nod, sz) - 1]));
+        
+        nod = 2 * nod + static_cast<std::size_t>(pred(array[nod - 1]));
+    }
+    
+    nod >>= __get_trailing_ones(nod) + 1;
+    
+    return nod == 0 ? sz : nod - 1;
+}
+
+
+/**
+ * @brief       Copy the elements of a sorted array in the k-ary tree layout, through an in-order
+ *              traversal of the implicit tree.
+ * @param       src : The sorted array.
+ * @param       src_idx : The index of the next element of the sorted array to copy.
+ * @param       sz : The sorted array size.
+ * @param       dest : The destination array.
+ * @param       nod : The node to fill, numbered from 0.
+ * @param       nbr_nods : The number of nodes.
+ * @return      The index of the next element of the sorted array to copy.
+ */
+template<typename TpSourceArray, typename TpDestinationArray>
+std::size_t __make_kary_layout(
+        const TpSourceArray& src,
+        std::size_t src_idx,
+        std::size_t sz,
+        TpDestinationArray& dest,
+        std::size_t nod,
+        std::size_t nbr_nods
+)
+{
+    if (nod < nbr_nods)
+    {
+        for (std::size_t i = 0; i < KARY_SEARCH_PIVOTS; ++i)
+        {
+            src_idx = __make_kary_layout(src, src_idx, sz, dest,
+                                         nod * (KARY_SEARCH_PIVOTS + 1) + i + 1, nbr_nods);
+            dest[nod * KARY_SEARCH_PIVOTS + i] = src[std::min(src_idx, sz - 1)];
+            ++src_idx;
+        }
+        
+        src_idx = __make_kary_layout(src, src_idx, sz, dest,
+                                     nod * (KARY_SEARCH_PIVOTS + 1) + KARY_SEARCH_PIVOTS + 1,
+                                     nbr_nods);
+    }
+    
+    return src_idx;
+}
+
+
+/**
+ * @brief       Get the mask of the elements of a node of the k-ary tree layout that go before a
+ *              value.
+ * @param       pvts : The elements of the node.
+ * @param       val : The value.
+ * @param       comp : The comparison function.
+ * @return      The mask that has the bit i set if the element i goes before the value.
+ */
+template<typename TpValue, typename TpCompare>
+inline std::uint32_t __get_kary_mask(const TpValue* pvts, const TpValue& val, const TpCompare& comp)
+{
+#if defined(__SSE2__)
+    if constexpr (__is_default_compare<TpValue, TpCompare> &&
+                  (std::is_same<TpValue, std::int32_t>::value ||
+                   std::is_same<TpValue, float>::value))
+    {
+        std::uint32_t msk = 0;
+
+#if defined(__AVX2__)
+        for (std::size_t i = 0; i < KARY_SEARCH_PIVOTS; i += 8)
+        {
+            __m256 lt;
+            
+            if constexpr (std::is_same<TpValue, float>::value)
+            {
+                lt = _mm256_cmp_ps(_mm256_loadu_ps(pvts + i), _mm256_set1_ps(val), _CMP_LT_OQ);
+            }
+            else
+            {
+                lt = _mm256_castsi256_ps(_mm256_cmpgt_epi32(
+                        _mm256_set1_epi32(val),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pvts + i))));
+            }
+            
+            msk |= static_cast<std::uint32_t>(_mm256_movemask_ps(lt)) << i;
+        }
+#else
+        for (std::size_t i = 0; i < KARY_SEARCH_PIVOTS; i += 4)
+        {
+            __m128 lt;
+            
+            if constexpr (std::is_same<TpValue, float>::value)
+            {
+                lt = _mm_cmplt_ps(_mm_loadu_ps(pvts + i), _mm_set1_ps(val));
+            }
+            else
+            {
+                lt = _mm_castsi128_ps(_mm_cmpgt_epi32(
+                        _mm_set1_epi32(val),
+                        _mm_loadu_si128(reinterpret_cast<const __m128i*>(pvts + i))));
+            }
+            
+            msk |= static_cast<std::uint32_t>(_mm_movemask_ps(lt)) << i;
+        }
+#endif
+
+        return msk;
+    }
+    else if constexpr (__is_default_compare<TpValue, TpCompare> &&
+                       std::is_same<TpValue, double>::value)
+    {
+        std::uint32_t msk = 0;
+        
+        for (std::size_t i = 0; i < KARY_SEARCH_PIVOTS; i += 2)
+        {
+            msk |= static_cast<std::uint32_t>(
+                    _mm_movemask_pd(_mm_cmplt_pd(_mm_loadu_pd(pvts + i), _mm_set1_pd(val)))) << i;
+        }
+        
+        return msk;
+    }
+    else
+#endif
+    {
+        std::uint32_t msk = 0;
+        
+        for (std::size_t i = 0; i < KARY_SEARCH_PIVOTS; ++i)
+        {
+            msk |= static_cast<std::uint32_t>(comp(pvts[i], val) ? 1 : 0) << i;
+        }
+        
+        return msk;
+    }
+}
+
+
+/**
+ * @brief       Get the number of bits set in a mask.
+ * @param       msk : The mask.
+ * @return      The number of bits set in the mask.
+ */
+inline std::size_t __get_kary_count(std::uint32_t msk) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcount(msk));
+#else
+    std::size_t cnt = 0;
+    
+    for (; msk != 0; msk &= msk - 1)
+    {
+        ++cnt;
+    }
+    
+    return cnt;
+#endif
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Get the index of the first element of a sorted array that does not go before a
+ *              value. The search range is halved without branches depending on the comparisons,
+ *              which become conditional moves, and the two possible next middle elements are
+ *              prefetched, so the latency of the memory accesses is overlapped on large arrays.
+ * @param       array : The sorted array.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The index of the first element that does not go before the value, or sz if there
+ *              is no such element.
+ */
+template<typename TpArray, typename TpValue, typename TpCompare>
+std::size_t branchless_lower_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const TpValue& val,
+        const TpCompare& comp
+)
+{
+    return __hidden_algorithm::__branchless_partition_point(
+            array, sz, [&](const auto& x) { return comp(x, val); });
+}
+
+
+/**
+ * @brief       Get the index of the first element of a sorted array that does not go before a
+ *              value, without branches depending on the comparisons.
+ * @param       array : The sorted array.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @return      The index of the first element that is not less than the value, or sz if there is
+ *              no such element.
+ */
+template<typename TpArray, typename TpValue>
+std::size_t branchless_lower_bound(const TpArray& array, std::size_t sz, const TpValue& val)
+{
+    return branchless_lower_bound(array, sz, val, std::less<>());
+}
+
+
+/**
+ * @brief       Get the index of the first element of a sorted array that goes after a value. The
+ *              search range is halved without branches depending on the comparisons, and the two
+ *              possible next middle elements are prefetched.
+ * @param       array : The sorted array.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The index of the first element that goes after the value, or sz if there is no
+ *              such element.
+ */
+template<typename TpArray, typename TpValue, typename TpCompare>
+std::size_t branchless_upper_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const TpValue& val,
+        const TpCompare& comp
+)
+{
+    return __hidden_algorithm::__branchless_partition_point(
+            array, sz, [&](const auto& x) { return !comp(val, x); });
+}
+
+
+/**
+ * @brief       Get the index of the first element of a sorted array that goes after a value,
+ *              without branches depending on the comparisons.
+ * @param       array : The sorted array.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @return      The index of the first element that is greater than the value, or sz if there is
+ *              no such element.
+ */
+template<typename TpArray, typename TpValue>
+std::size_t branchless_upper_bound(const TpArray& array, std::size_t sz, const TpValue& val)
+{
+    return branchless_upper_bound(array, sz, val, std::less<>());
+}
+
+
+/**
+ * @brief       Copy the elements of a sorted array in the Eytzinger layout, that is the breadth
+ *              first order of a complete binary search tree. The element at index i has its
+ *              children at indexes 2 * i + 1 and 2 * i + 2, so the first levels of the tree share
+ *              a few cache lines, and the descendants of a node several levels below are
+ *              contiguous and can be prefetched.
+ * @param       src : The sorted array.
+ * @param       sz : The array size.
+ * @param       dest : The destination array, that has at least sz elements and is not the source
+ *              array.
+ */
+template<typename TpSourceArray, typename TpDestinationArray>
+void make_eytzinger_layout(const TpSourceArray& src, std::size_t sz, TpDestinationArray& dest)
+{
+    __hidden_algorithm::__make_eytzinger_layout(src, 0, dest, 1, sz);
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the Eytzinger layout that does
+ *              not go before a value. The tree is descended without branches depending on the
+ *              comparisons, and the nodes four levels below the current one are prefetched.
+ * @param       array : The array in the Eytzinger layout, built with make_eytzinger_layout.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The index in the Eytzinger layout of the first element that does not go before the
+ *              value, or sz if there is no such element.
+ */
+template<typename TpArray, typename TpValue, typename TpCompare>
+std::size_t eytzinger_lower_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const TpValue& val,
+        const TpCompare& comp
+)
+{
+    return __hidden_algorithm::__eytzinger_partition_point(
+            array, sz, [&](const auto& x) { return comp(x, val); });
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the Eytzinger layout that does
+ *              not go before a value.
+ * @param       array : The array in the Eytzinger layout, built with make_eytzinger_layout.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @return      The index in the Eytzinger layout of the first element that is not less than the
+ *              value, or sz if there is no such element.
+ */
+template<typename TpArray, typename TpValue>
+std::size_t eytzinger_lower_bound(const TpArray& array, std::size_t sz, const TpValue& val)
+{
+    return eytzinger_lower_bound(array, sz, val, std::less<>());
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the Eytzinger layout that goes
+ *              after a value. The tree is descended without branches depending on the
+ *              comparisons, and the nodes four levels below the current one are prefetched.
+ * @param       array : The array in the Eytzinger layout, built with make_eytzinger_layout.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The index in the Eytzinger layout of the first element that goes after the value,
+ *              or sz if there is no such element.
+ */
+template<typename TpArray, typename TpValue, typename TpCompare>
+std::size_t eytzinger_upper_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const TpValue& val,
+        const TpCompare& comp
+)
+{
+    return __hidden_algorithm::__eytzinger_partition_point(
+            array, sz, [&](const auto& x) { return !comp(val, x); });
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the Eytzinger layout that goes
+ *              after a value.
+ * @param       array : The array in the Eytzinger layout, built with make_eytzinger_layout.
+ * @param       sz : The array size.
+ * @param       val : The value to search.
+ * @return      The index in the Eytzinger layout of the first element that is greater than the
+ *              value, or sz if there is no such element.
+ */
+template<typename TpArray, typename TpValue>
+std::size_t eytzinger_upper_bound(const TpArray& array, std::size_t sz, const TpValue& val)
+{
+    return eytzinger_upper_bound(array, sz, val, std::less<>());
+}
+
+
+/**
+ * @brief       Get the size of the k-ary tree layout of a sorted array.
+ * @param       sz : The sorted array size.
+ * @return      The size of the k-ary tree layout, the array size rounded up to a multiple of 16.
+ */
+constexpr std::size_t get_kary_layout_size(std::size_t sz) noexcept
+{
+    return (sz + __hidden_algorithm::KARY_SEARCH_PIVOTS - 1) /
+           __hidden_algorithm::KARY_SEARCH_PIVOTS * __hidden_algorithm::KARY_SEARCH_PIVOTS;
+}
+
+
+/**
+ * @brief       Copy the elements of a sorted array in a k-ary tree layout. Every node of the tree
+ *              holds 16 consecutive elements and has 17 children, and the nodes are stored in
+ *              breadth first order, so a search reads a single cache line per level for 32 bits
+ *              types and compares all the elements of a node at once. The last node is padded
+ *              with copies of the greatest element.
+ * @param       src : The sorted array.
+ * @param       sz : The array size.
+ * @param       dest : The destination array, that has at least get_kary_layout_size(sz) elements
+ *              and is not the source array.
+ */
+template<typename TpSourceArray, typename TpDestinationArray>
+void make_kary_layout(const TpSourceArray& src, std::size_t sz, TpDestinationArray& dest)
+{
+    __hidden_algorithm::__make_kary_layout(src, 0, sz, dest, 0,
+                                           get_kary_layout_size(sz) /
+                                           __hidden_algorithm::KARY_SEARCH_PIVOTS);
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the k-ary tree layout that does
+ *              not go before a value. The elements of every node visited are compared to the value
+ *              at once, with SIMD instructions for the 32 bits integers, the floats and the doubles
+ *              compared with std::less, and the number of elements that go before the value gives
+ *              the child to visit, so the search takes about log17(n) steps without branches
+ *              depending on the comparisons. It is meant for arrays that are searched many times,
+ *              since the layout has to be built first.
+ * @param       array : The array in the k-ary tree layout, built with make_kary_layout, that
+ *              stores its elements contiguously.
+ * @param       sz : The array size, returned by get_kary_layout_size.
+ * @param       val : The value to search.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ * @return      The index in the k-ary tree layout of the first element that does not go before
+ *              the value, or sz if there is no such element.
+ */
+template<typename TpArray, typename TpCompare>
+std::size_t kary_lower_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const std::decay_t<decltype(array[0])>& val,
+        const TpCompare& comp
+)
+{
+    using __hidden_algorithm::KARY_SEARCH_PIVOTS;
+    
+    const std::size_t nbr_nods = sz / KARY_SEARCH_PIVOTS;
+    std::size_t nod = 0;
+    std::size_t res = sz;
+    std::size_t cnt;
+    
+    while (nod < nbr_nods)
+    {
+        cnt = __hidden_algorithm::__get_kary_count(__hidden_algorithm::__get_kary_mask(
+                std::addressof(array[nod * KARY_SEARCH_PIVOTS]), val, comp));
+        
+        res = cnt < KARY_SEARCH_PIVOTS ? nod * KARY_SEARCH_PIVOTS + cnt : res;
+        nod = nod * (KARY_SEARCH_PIVOTS + 1) + cnt + 1;
+    }
+    
+    return res;
+}
+
+
+/**
+ * @brief       Get the index of the first element of an array in the k-ary tree layout that does
+ *              not go before a value.
+ * @param       array : The array in the k-ary tree layout, built with make_kary_layout, that
+ *              stores its elements contiguously.
+ * @param       sz : The array size, returned by get_kary_layout_size.
+ * @param       val : The value to search.
+ * @return      The index in the k-ary tree layout of the first element that is not less than the
+ *              value, or sz if there is no such element.
+ */
+template<typename TpArray>
+std::size_t kary_lower_bound(
+        const TpArray& array,
+        std::size_t sz,
+        const std::decay_t<decltype(array[0])>& val
+)
+{
+    return kary_lower_bound(array, sz, val, std::less<std::decay_t<decltype(array[0])>>());
+}
+
+}
+}
+
+
+#endif
@@ -0,0 +1,311 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/selection.hpp
+ * @brief       selection functions header.
+ * @author      Killian
+ * @date        2018/09/25 - 09:12
+ */
+
+#ifndef SPEED_ALGORITHM_SELECTION_HPP
+#define SPEED_ALGORITHM_SELECTION_HPP
+
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "algorithm.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Ratio of the array size to the number of elements sorted over which a heap selects them. */
+constexpr std::size_t PARTIAL_SORT_HEAP_RATIO = 64;
+
+
+/**
+ * @brief       Place at a given index the element of a range that would be there if the range
+ *              was sorted, with the lower elements before it and the greater ones after it. The
+ *              range is partitioned like in __quicksort, but only the partition that holds the
+ *              index is processed, and a heapsort takes over when the partitions keep being
+ *              unbalanced.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       nth : The index of the element to place, in the range.
+ * @param       comp : The comparison function.
+ */
+template<bool BRANCHLESS, typename TpArray, typename TpCompare>
+void __introselect(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        std::size_t nth,
+        const TpCompare& comp
+)
+{
+    std::size_t bad_allowed = __log2(hi - lo);
+    std::size_t sz;
+    std::size_t hlf;
+    std::size_t pivot_pos;
+    bool leftmost = true;
+    
+    while (true)
+    {
+        sz = hi - lo;
+        
+        if (sz < INSERTION_SORT_THRESHOLD)
+        {
+            if (leftmost)
+            {
+                __insertion_sort(array, lo, hi, comp);
+            }
+            else
+            {
+                __unguarded_insertion_sort(array, lo, hi, comp);
+            }
+            
+            return;
+        }
+        
+        hlf = sz / 2;
+        if (sz > NINTHER_THRESHOLD)
+        {
+            __sort3(array, lo, lo + hlf, hi - 1, comp);
+            __sort3(array, lo + 1, lo + hlf - 1, hi - 2, comp);
+            __sort3(array, lo + 2, lo + hlf + 1, hi - 3, comp);
+            __sort3(array, lo + hlf - 1, lo + hlf, lo + hlf + 1, comp);
+            std::swap(array[lo], array[lo + hlf]);
+        }
+        else
+        {
+            __sort3(array, lo + hlf, lo, hi - 1, comp);
+        }
+        
+        if (!leftmost && !comp(array[lo - 1], array[lo]))
+        {
+            lo = __partition_left(array, lo, hi, comp) + 1;
+            if (nth < lo)
+            {
+                return;
+            }
+            
+            continue;
+        }
+        
+        if constexpr (BRANCHLESS)
+        {
+            pivot_pos = __partition_right_branchless(array, lo, hi, comp).first;
+        }
+        else
+        {
+            pivot_pos = __partition_right(array, lo, hi, comp).first;
+        }
+        
+        if (pivot_pos == nth)
+        {
+            return;
+        }
+        
+        if ((pivot_pos - lo < sz / 8 || hi - (pivot_pos + 1) < sz / 8) && --bad_allowed == 0)
+        {
+            __heapsort(array, lo, hi, comp);
+            return;
+        }
+        
+        if (nth < pivot_pos)
+        {
+            hi = pivot_pos;
+        }
+        else
+        {
+            lo = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+}
+
+
+/**
+ * @brief       Place the lowest elements of an array at its beginning, in an unspecified order,
+ *              with a heap of the elements already selected whose root is the greatest of them.
+ *              It is faster than an introselect when few elements are selected.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       nbr_sltd : The number of elements to select, greater than 0 and lower than the
+ *              array size.
+ * @param       comp : The comparison function.
+ */
+template<typename TpArray, typename TpCompare>
+void __heap_select(TpArray& array, std::size_t sz, std::size_t nbr_sltd, const TpCompare& comp)
+{
+    std::size_t i;
+    
+    auto sift_down = [&](std::size_t root)
+    {
+        std::decay_t<decltype(array[0])> tmp = std::move(array[root]);
+        std::size_t child;
+        
+        while ((child = 2 * root + 1) < nbr_sltd)
+        {
+            if (child + 1 < nbr_sltd && comp(array[child], array[child + 1]))
+            {
+                ++child;
+            }
+            
+            if (!comp(tmp, array[child]))
+            {
+                break;
+            }
+            
+            array[root] = std::move(array[child]);
+            root = child;
+        }
+        
+        array[root] = std::move(tmp);
+    };
+    
+    for (i = nbr_sltd / 2; i-- > 0;)
+    {
+        sift_down(i);
+    }
+    
+    for (i = nbr_sltd; i < sz; ++i)
+    {
+        if (comp(array[i], array[0]))
+        {
+            std::swap(array[i], array[0]);
+            sift_down(0);
+        }
+    }
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Rearrange the array elements so that the element at a given index is the one that
+ *              would be there if the array was sorted, the elements before it do not go after it,
+ *              and the elements after it do not go before it. It is an introselect, whose pivots
+ *              and partitioning are the ones of quicksort, so it is O(n) on average and
+ *              O(n * log(n)) in the worst case.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       nth : The index of the element to place. If it is not lower than the array size,
+ *              the array is not modified.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ */
+template<typename TpArray, typename TpCompare>
+void nth_element(TpArray& array, std::size_t sz, std::size_t nth, const TpCompare& comp)
+{
+    using value_type = std::decay_t<decltype(array[0])>;
+    
+    constexpr bool branchless = std::is_arithmetic<value_type>::value &&
+            (std::is_same<TpCompare, simple_compare<value_type>>::value ||
+             std::is_same<TpCompare, std::less<value_type>>::value ||
+             std::is_same<TpCompare, std::less<>>::value);
+    
+    if (nth < sz && sz > 1)
+    {
+        __hidden_algorithm::__introselect<branchless>(array, 0, sz, nth, comp);
+    }
+}
+
+
+/**
+ * @brief       Rearrange the array elements so that the element at a given index is the one that
+ *              would be there if the array was sorted.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       nth : The index of the element to place.
+ */
+template<typename TpArray>
+void nth_element(TpArray& array, std::size_t sz, std::size_t nth)
+{
+    nth_element(array, sz, nth, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+
+/**
+ * @brief       Rearrange the array elements so that its first elements are the lowest ones, in
+ *              order. The remaining elements are left in an unspecified order. The lowest
+ *              elements are selected with nth_element, or with a bounded heap when they are few
+ *              compared to the array size, and then sorted with quicksort.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       nbr_sorted : The number of elements to sort. If it is greater than the array size,
+ *              the whole array is sorted.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ */
+template<typename TpArray, typename TpCompare>
+void partial_sort(TpArray& array, std::size_t sz, std::size_t nbr_sorted, const TpCompare& comp)
+{
+    if (nbr_sorted >= sz)
+    {
+        quicksort(array, sz, comp);
+    }
+    else if (nbr_sorted > 0)
+    {
+        if (sz / nbr_sorted > __hidden_algorithm::PARTIAL_SORT_HEAP_RATIO)
+        {
+            __hidden_algorithm::__heap_select(array, sz, nbr_sorted, comp);
+            quicksort(array, nbr_sorted, comp);
+        }
+        else
+        {
+            nth_element(array, sz, nbr_sorted - 1, comp);
+            quicksort(array, nbr_sorted - 1, comp);
+        }
+    }
+}
+
+
+/**
+ * @brief       Rearrange the array elements so that its first elements are the lowest ones, in
+ *              order.
+ * @param       array : The array.
+ * @param       sz : The array size.
+ * @param       nbr_sorted : The number of elements to sort.
+ */
+template<typename TpArray>
+void partial_sort(TpArray& array, std::size_t sz, std::size_t nbr_sorted)
+{
+    partial_sort(array, sz, nbr_sorted, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+
+}
+}
+
+
+#endif
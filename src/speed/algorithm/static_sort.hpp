@@ -0,0 +1,278 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/static_sort.hpp
+ * @brief       static_sort functions header.
+ * @author      Killian
+ * @date        2018/09/23 - 10:26
+ */
+
+#ifndef SPEED_ALGORITHM_STATIC_SORT_HPP
+#define SPEED_ALGORITHM_STATIC_SORT_HPP
+
+#include <array>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/**
+ * @brief       Comparator of a sorting network, that orders the elements at two indexes.
+ */
+struct __comparator
+{
+    /** Index of the element that receives the lowest value. */
+    std::size_t lo;
+    
+    /** Index of the element that receives the greatest value. */
+    std::size_t hi;
+};
+
+
+/**
+ * @brief       Build the Batcher merge exchange network of N elements, or only count its
+ *              comparators. The network uses about N * log2(N)^2 / 4 comparators, which is optimal
+ *              up to 8 elements and close to the best known networks up to 32 elements.
+ * @param       netwrk : The array filled with the comparators, or nullptr to count them only.
+ * @return      The number of comparators.
+ */
+template<std::size_t N>
+constexpr std::size_t __build_sorting_network(__comparator* netwrk) noexcept
+{
+    std::size_t cnt = 0;
+    std::size_t t = 0;
+    std::size_t p = 0;
+    std::size_t q = 0;
+    std::size_t r = 0;
+    std::size_t d = 0;
+    
+    while ((std::size_t(1) << t) < N)
+    {
+        ++t;
+    }
+    
+    for (p = t == 0 ? 0 : std::size_t(1) << (t - 1); p > 0; p >>= 1)
+    {
+        q = std::size_t(1) << (t - 1);
+        r = 0;
+        d = p;
+        
+        while (true)
+        {
+            for (std::size_t i = 0; i + d < N; ++i)
+            {
+                if ((i & p) == r)
+                {
+                    if (netwrk != nullptr)
+                    {
+                        netwrk[cnt] = {i, i + d};
+                    }
+                    ++cnt;
+                }
+            }
+            
+            if (q == p)
+            {
+                break;
+            }
+            
+            d = q - p;
+            q >>= 1;
+            r = p;
+        }
+    }
+    
+    return cnt;
+}
+
+
+/**
+ * @brief       Get the sorting network of N elements.
+ * @return      The comparators of the network.
+ */
+template<std::size_t N>
+constexpr auto __get_sorting_network() noexcept
+{
+    std::array<__comparator, __build_sorting_network<N>(nullptr)> netwrk = {};
+    
+    __build_sorting_network<N>(netwrk.data());
+    
+    return netwrk;
+}
+
+
+/** The sorting network of N elements. */
+template<std::size_t N>
+constexpr auto SORTING_NETWORK = __get_sorting_network<N>();
+
+
+/**
+ * @brief       Order two elements. The arithmetic types are ordered with conditional moves
+ *              instead of branches.
+ * @param       x : The element that receives the lowest value.
+ * @param       y : The element that receives the greatest value.
+ * @param       comp : The comparison function.
+ */
+template<typename TpValue, typename TpCompare>
+inline void __compare_exchange(TpValue& x, TpValue& y, const TpCompare& comp)
+{
+    if constexpr (std::is_arithmetic<TpValue>::value)
+    {
+        const TpValue a = x;
+        const TpValue b = y;
+        const bool swp = comp(b, a);
+        
+        x = swp ? b : a;
+        y = swp ? a : b;
+    }
+    else
+    {
+        if (comp(y, x))
+        {
+            std::swap(x, y);
+        }
+    }
+}
+
+
+/**
+ * @brief       Sort N consecutive elements of an array with a sorting network.
+ * @param       array : The array.
+ * @param       lo : The index of the first element.
+ * @param       comp : The comparison function.
+ */
+template<std::size_t N, typename TpArray, typename TpCompare, std::size_t... IDXS>
+inline void __static_sort(
+        TpArray& array,
+        std::size_t lo,
+        const TpCompare& comp,
+        std::index_sequence<IDXS...>
+)
+{
+    static_cast<void>(lo);
+    (__compare_exchange(array[lo + SORTING_NETWORK<N>[IDXS].lo],
+                        array[lo + SORTING_NETWORK<N>[IDXS].hi], comp), ...);
+}
+
+
+/**
+ * @brief       Sort N consecutive elements of an array with a sorting network.
+ * @param       array : The array.
+ * @param       lo : The index of the first element.
+ * @param       comp : The comparison function.
+ */
+template<std::size_t N, typename TpArray, typename TpCompare>
+void __static_sort(TpArray& array, std::size_t lo, const TpCompare& comp)
+{
+    __static_sort<N>(array, lo, comp, std::make_index_sequence<SORTING_NETWORK<N>.size()>());
+}
+
+
+/**
+ * @brief       Sort a range of less than MAX_N elements with the sorting network of its size.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       sz : The number of elements of the range, lower than MAX_N.
+ * @param       comp : The comparison function.
+ */
+template<std::size_t MAX_N, typename TpArray, typename TpCompare, std::size_t... IDXS>
+void __static_sort_dispatch(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t sz,
+        const TpCompare& comp,
+        std::index_sequence<IDXS...>
+)
+{
+    using sort_function = void (*)(TpArray&, std::size_t, const TpCompare&);
+    
+    static constexpr sort_function fncs[] = {&__static_sort<IDXS, TpArray, TpCompare>...};
+    
+    fncs[sz](array, lo, comp);
+}
+
+
+/**
+ * @brief       Sort a range of less than MAX_N elements with the sorting network of its size.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       sz : The number of elements of the range, lower than MAX_N.
+ * @param       comp : The comparison function.
+ */
+template<std::size_t MAX_N, typename TpArray, typename TpCompare>
+inline void __static_sort_dispatch(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t sz,
+        const TpCompare& comp
+)
+{
+    __static_sort_dispatch<MAX_N>(array, lo, sz, comp, std::make_index_sequence<MAX_N>());
+}
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Sort the first N elements of an array with a sorting network generated at compile
+ *              time. The sequence of comparisons does not depend on the data, and the arithmetic
+ *              types are ordered with conditional moves, so the sort has no unpredictable
+ *              branches and the independent comparators can be vectorized by the compiler. It is
+ *              meant for small arrays, up to about 32 elements. The sort is not stable.
+ * @param       array : The array to sort, that has at least N elements.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ */
+template<std::size_t N, typename TpArray, typename TpCompare>
+inline void static_sort(TpArray& array, const TpCompare& comp)
+{
+    __hidden_algorithm::__static_sort<N>(array, 0, comp);
+}
+
+
+/**
+ * @brief       Sort the first N elements of an array with a sorting network generated at compile
+ *              time.
+ * @param       array : The array to sort, that has at least N elements.
+ */
+template<std::size_t N, typename TpArray>
+inline void static_sort(TpArray& array)
+{
+    __hidden_algorithm::__static_sort<N>(array, 0, std::less<>());
+}
+
+
+}
+}
+
+
+#endif
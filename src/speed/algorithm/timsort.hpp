@@ -0,0 +1,729 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/timsort.hpp
+ * @brief       timsort functions header.
+ * @author      Killian
+ * @date        2018/09/28 - 10:14
+ */
+
+#ifndef SPEED_ALGORITHM_TIMSORT_HPP
+#define SPEED_ALGORITHM_TIMSORT_HPP
+
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/** @cond */
+namespace __hidden_algorithm {
+
+
+/** Number of elements under which a range is sorted by binary insertion instead of merged. */
+constexpr std::size_t TIMSORT_MIN_MERGE = 64;
+
+/** Initial number of consecutive wins of a run after which a merge switches to galloping. */
+constexpr std::size_t TIMSORT_MIN_GALLOP = 7;
+
+/** Maximum number of pending runs, enough for any array given the run stack invariants. */
+constexpr std::size_t TIMSORT_MAX_RUNS = 96;
+
+
+/**
+ * @brief       Get the minimum length of a run, so that the number of runs is a power of two or
+ *              slightly less, which keeps the merges balanced.
+ * @param       sz : The array size.
+ * @return      The minimum length of a run.
+ */
+constexpr std::size_t __get_min_run_length(std::size_t sz) noexcept
+{
+    std::size_t r = 0;
+    
+    while (sz >= TIMSORT_MIN_MERGE)
+    {
+        r |= sz & 1;
+        sz >>= 1;
+    }
+    
+    return sz + r;
+}
+
+
+/**
+ * @brief       Get the end of the run that starts at the beginning of a range, and make it
+ *              ascending. A descending run is strictly descending, so reversing it keeps the sort
+ *              stable.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range, greater than lo.
+ * @param       comp : The comparison function.
+ * @return      The index of the past-the-end element of the run.
+ */
+template<typename TpArray, typename TpCompare>
+std::size_t __make_run(TpArray& array, std::size_t lo, std::size_t hi, const TpCompare& comp)
+{
+    std::size_t run_hi = lo + 1;
+    std::size_t i;
+    std::size_t j;
+    
+    if (run_hi == hi)
+    {
+        return hi;
+    }
+    
+    if (comp(array[run_hi++], array[lo]))
+    {
+        while (run_hi < hi && comp(array[run_hi], array[run_hi - 1]))
+        {
+            ++run_hi;
+        }
+        
+        for (i = lo, j = run_hi - 1; i < j; ++i, --j)
+        {
+            std::swap(array[i], array[j]);
+        }
+    }
+    else
+    {
+        while (run_hi < hi && !comp(array[run_hi], array[run_hi - 1]))
+        {
+            ++run_hi;
+        }
+    }
+    
+    return run_hi;
+}
+
+
+/**
+ * @brief       Sort a range whose beginning is already sorted, inserting the other elements after
+ *              the equal ones with a binary search.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       srtd_hi : The index of the past-the-end element of the sorted beginning, greater
+ *              than lo.
+ * @param       comp : The comparison function.
+ */
+template<typename TpArray, typename TpCompare>
+void __binary_insertion_sort(
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        std::size_t srtd_hi,
+        const TpCompare& comp
+)
+{
+    std::size_t bgn;
+    std::size_t end;
+    std::size_t mid;
+    std::size_t i;
+    
+    for (; srtd_hi < hi; ++srtd_hi)
+    {
+        std::decay_t<decltype(array[0])> pivot = std::move(array[srtd_hi]);
+        
+        bgn = lo;
+        end = srtd_hi;
+        while (bgn < end)
+        {
+            mid = bgn + (end - bgn) / 2;
+            if (comp(pivot, array[mid]))
+            {
+                end = mid;
+            }
+            else
+            {
+                bgn = mid + 1;
+            }
+        }
+        
+        for (i = srtd_hi; i > bgn; --i)
+        {
+            array[i] = std::move(array[i - 1]);
+        }
+        
+        array[bgn] = std::move(pivot);
+    }
+}
+
+
+/**
+ * @brief       Find where a value goes in a sorted range, searching from its beginning with steps
+ *              of exponentially growing size and then with a binary search, so the cost is
+ *              logarithmic in the distance to the beginning.
+ * @param       val : The value.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      If UPPER is true the index of the first element that goes after the value is
+ *              returned, otherwise the index of the first element that does not go before the
+ *              value is returned.
+ */
+template<bool UPPER, typename TpValue, typename TpArray, typename TpCompare>
+std::size_t __gallop_forward(
+        const TpValue& val,
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp
+)
+{
+    std::size_t prv = lo;
+    std::size_t ofst = 1;
+    std::size_t mid;
+    
+    auto is_before = [&](std::size_t idx)
+    {
+        return UPPER ? !comp(val, array[idx]) : comp(array[idx], val);
+    };
+    
+    if (lo == hi || !is_before(lo))
+    {
+        return lo;
+    }
+    
+    while (ofst < hi - lo && is_before(lo + ofst))
+    {
+        prv = lo + ofst;
+        ofst = ofst * 2 + 1;
+    }
+    
+    ++prv;
+    hi = ofst < hi - lo ? lo + ofst : hi;
+    while (prv < hi)
+    {
+        mid = prv + (hi - prv) / 2;
+        if (is_before(mid))
+        {
+            prv = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    
+    return prv;
+}
+
+
+/**
+ * @brief       Find where a value goes in a sorted range, searching from its end with steps of
+ *              exponentially growing size and then with a binary search, so the cost is
+ *              logarithmic in the distance to the end.
+ * @param       val : The value.
+ * @param       array : The array.
+ * @param       lo : The index of the first element of the range.
+ * @param       hi : The index of the past-the-end element of the range.
+ * @param       comp : The comparison function.
+ * @return      If UPPER is true the index of the first element that goes after the value is
+ *              returned, otherwise the index of the first element that does not go before the
+ *              value is returned.
+ */
+template<bool UPPER, typename TpValue, typename TpArray, typename TpCompare>
+std::size_t __gallop_backward(
+        const TpValue& val,
+        TpArray& array,
+        std::size_t lo,
+        std::size_t hi,
+        const TpCompare& comp
+)
+{
+    std::size_t nxt = hi;
+    std::size_t ofst = 1;
+    std::size_t mid;
+    
+    auto is_before = [&](std::size_t idx)
+    {
+        return UPPER ? !comp(val, array[idx]) : comp(array[idx], val);
+    };
+    
+    if (lo == hi || is_before(hi - 1))
+    {
+        return hi;
+    }
+    
+    --nxt;
+    while (ofst < nxt - lo + 1 && !is_before(nxt - ofst))
+    {
+        nxt -= ofst;
+        ofst = ofst * 2 + 1;
+    }
+    
+    lo = ofst < nxt - lo + 1 ? nxt - ofst + 1 : lo;
+    while (lo < nxt)
+    {
+        mid = lo + (nxt - lo) / 2;
+        if (is_before(mid))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            nxt = mid;
+        }
+    }
+    
+    return lo;
+}
+
+
+/**
+ * @brief       Class that holds the state of a timsort: the stack of the pending runs, the
+ *              buffer of the merges and the current galloping threshold.
+ */
+template<typename TpArray, typename TpCompare>
+class __timsort
+{
+public:
+    /** The value type. */
+    using value_type = std::decay_t<decltype(std::declval<TpArray&>()[0])>;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       array : The array to sort.
+     * @param       comp : The comparison function.
+     */
+    __timsort(TpArray& array, const TpCompare& comp)
+            : buf_()
+            , array_(array)
+            , comp_(comp)
+            , run_bgns_()
+            , run_lens_()
+            , nbr_runs_(0)
+            , min_gallop_(TIMSORT_MIN_GALLOP)
+    {
+    }
+    
+    /**
+     * @brief       Sort the array.
+     * @param       sz : The array size.
+     */
+    void sort(std::size_t sz)
+    {
+        const std::size_t min_run_len = __get_min_run_length(sz);
+        std::size_t lo = 0;
+        std::size_t run_hi;
+        std::size_t forced_hi;
+        
+        while (lo < sz)
+        {
+            run_hi = __make_run(array_, lo, sz, comp_);
+            if (run_hi - lo < min_run_len)
+            {
+                forced_hi = std::min(lo + min_run_len, sz);
+                if constexpr (std::is_arithmetic<value_type>::value)
+                {
+                    __insertion_sort(array_, lo, forced_hi, comp_);
+                }
+                else
+                {
+                    __binary_insertion_sort(array_, lo, forced_hi, run_hi, comp_);
+                }
+                
+                run_hi = forced_hi;
+            }
+            
+            run_bgns_[nbr_runs_] = lo;
+            run_lens_[nbr_runs_] = run_hi - lo;
+            ++nbr_runs_;
+            merge_collapse();
+            
+            lo = run_hi;
+        }
+        
+        while (nbr_runs_ > 1)
+        {
+            std::size_t n = nbr_runs_ - 2;
+            
+            if (n > 0 && run_lens_[n - 1] < run_lens_[n + 1])
+            {
+                --n;
+            }
+            
+            merge_at(n);
+        }
+    }
+
+private:
+    /**
+     * @brief       Merge the pending runs until the lengths of the runs on the stack decrease
+     *              faster than the Fibonacci numbers, so the stack stays small and the merges
+     *              balanced.
+     */
+    void merge_collapse()
+    {
+        std::size_t n;
+        
+        while (nbr_runs_ > 1)
+        {
+            n = nbr_runs_ - 2;
+            if ((n > 0 && run_lens_[n - 1] <= run_lens_[n] + run_lens_[n + 1]) ||
+                (n > 1 && run_lens_[n - 2] <= run_lens_[n - 1] + run_lens_[n]))
+            {
+                if (run_lens_[n - 1] < run_lens_[n + 1])
+                {
+                    --n;
+                }
+            }
+            else if (run_lens_[n] > run_lens_[n + 1])
+            {
+                break;
+            }
+            
+            merge_at(n);
+        }
+    }
+    
+    /**
+     * @brief       Merge two consecutive runs of the stack. The elements of the first run that
+     *              do not go after the beginning of the second run and the elements of the second
+     *              run that do not go before the end of the first run are already in place, so
+     *              only the remaining elements are merged, through a buffer holding the shortest
+     *              remaining run.
+     * @param       n : The index on the stack of the first run.
+     */
+    void merge_at(std::size_t n)
+    {
+        std::size_t lo = run_bgns_[n];
+        std::size_t mid = lo + run_lens_[n];
+        std::size_t hi = mid + run_lens_[n + 1];
+        
+        run_lens_[n] += run_lens_[n + 1];
+        if (n + 2 < nbr_runs_)
+        {
+            run_bgns_[n + 1] = run_bgns_[n + 2];
+            run_lens_[n + 1] = run_lens_[n + 2];
+        }
+        
+        --nbr_runs_;
+        
+        lo = __gallop_forward<true>(array_[mid], array_, lo, mid, comp_);
+        if (lo == mid)
+        {
+            return;
+        }
+        
+        hi = __gallop_backward<false>(array_[mid - 1], array_, mid, hi, comp_);
+        if (mid - lo <= hi - mid)
+        {
+            merge_low(lo, mid, hi);
+        }
+        else
+        {
+            merge_high(lo, mid, hi);
+        }
+    }
+    
+    /**
+     * @brief       Merge two consecutive sorted ranges from their beginning, the first one being
+     *              moved to the buffer. After a run has won TIMSORT_MIN_GALLOP times in a row, the
+     *              number of consecutive elements it wins is found by galloping, until galloping
+     *              stops paying off.
+     * @param       lo : The index of the first element of the first range.
+     * @param       mid : The index of the first element of the second range.
+     * @param       hi : The index of the past-the-end element of the second range.
+     */
+    void merge_low(std::size_t lo, std::size_t mid, std::size_t hi)
+    {
+        const std::size_t len = mid - lo;
+        std::size_t i = 0;
+        std::size_t j = mid;
+        std::size_t k = lo;
+        std::size_t min_gallop = min_gallop_;
+        std::size_t cnt1;
+        std::size_t cnt2;
+        std::size_t end;
+        
+        fill_buffer(lo, mid);
+        
+        while (true)
+        {
+            cnt1 = 0;
+            cnt2 = 0;
+            do
+            {
+                if (comp_(array_[j], buf_[i]))
+                {
+                    array_[k++] = std::move(array_[j++]);
+                    ++cnt2;
+                    cnt1 = 0;
+                    if (j == hi)
+                    {
+                        goto done;
+                    }
+                }
+                else
+                {
+                    array_[k++] = std::move(buf_[i++]);
+                    ++cnt1;
+                    cnt2 = 0;
+                    if (i == len)
+                    {
+                        goto done;
+                    }
+                }
+            } while ((cnt1 | cnt2) < min_gallop);
+            
+            do
+            {
+                end = __gallop_forward<true>(array_[j], buf_, i, len, comp_);
+                for (cnt1 = end - i; i < end;)
+                {
+                    array_[k++] = std::move(buf_[i++]);
+                }
+                
+                if (i == len)
+                {
+                    goto done;
+                }
+                
+                array_[k++] = std::move(array_[j++]);
+                if (j == hi)
+                {
+                    goto done;
+                }
+                
+                end = __gallop_forward<false>(buf_[i], array_, j, hi, comp_);
+                for (cnt2 = end - j; j < end;)
+                {
+                    array_[k++] = std::move(array_[j++]);
+                }
+                
+                if (j == hi)
+                {
+                    goto done;
+                }
+                
+                array_[k++] = std::move(buf_[i++]);
+                if (i == len)
+                {
+                    goto done;
+                }
+                
+                if (min_gallop > 1)
+                {
+                    --min_gallop;
+                }
+            } while (cnt1 >= TIMSORT_MIN_GALLOP || cnt2 >= TIMSORT_MIN_GALLOP);
+            
+            min_gallop += 2;
+        }
+
+done:
+        min_gallop_ = min_gallop;
+        while (i < len)
+        {
+            array_[k++] = std::move(buf_[i++]);
+        }
+    }
+    
+    /**
+     * @brief       Merge two consecutive sorted ranges from their end, the second one being moved
+     *              to the buffer. It gallops like merge_low.
+     * @param       lo : The index of the first element of the first range.
+     * @param       mid : The index of the first element of the second range.
+     * @param       hi : The index of the past-the-end element of the second range.
+     */
+    void merge_high(std::size_t lo, std::size_t mid, std::size_t hi)
+    {
+        std::size_t i = hi - mid;
+        std::size_t j = mid;
+        std::size_t k = hi;
+        std::size_t min_gallop = min_gallop_;
+        std::size_t cnt1;
+        std::size_t cnt2;
+        std::size_t bgn;
+        
+        fill_buffer(mid, hi);
+        
+        while (true)
+        {
+            cnt1 = 0;
+            cnt2 = 0;
+            do
+            {
+                if (comp_(buf_[i - 1], array_[j - 1]))
+                {
+                    array_[--k] = std::move(array_[--j]);
+                    ++cnt1;
+                    cnt2 = 0;
+                    if (j == lo)
+                    {
+                        goto done;
+                    }
+                }
+                else
+                {
+                    array_[--k] = std::move(buf_[--i]);
+                    ++cnt2;
+                    cnt1 = 0;
+                    if (i == 0)
+                    {
+                        goto done;
+                    }
+                }
+            } while ((cnt1 | cnt2) < min_gallop);
+            
+            do
+            {
+                bgn = __gallop_backward<true>(buf_[i - 1], array_, lo, j, comp_);
+                for (cnt1 = j - bgn; j > bgn;)
+                {
+                    array_[--k] = std::move(array_[--j]);
+                }
+                
+                if (j == lo)
+                {
+                    goto done;
+                }
+                
+                array_[--k] = std::move(buf_[--i]);
+                if (i == 0)
+                {
+                    goto done;
+                }
+                
+                bgn = __gallop_backward<false>(array_[j - 1], buf_, 0, i, comp_);
+                for (cnt2 = i - bgn; i > bgn;)
+                {
+                    array_[--k] = std::move(buf_[--i]);
+                }
+                
+                if (i == 0)
+                {
+                    goto done;
+                }
+                
+                array_[--k] = std::move(array_[--j]);
+                if (j == lo)
+                {
+                    goto done;
+                }
+                
+                if (min_gallop > 1)
+                {
+                    --min_gallop;
+                }
+            } while (cnt1 >= TIMSORT_MIN_GALLOP || cnt2 >= TIMSORT_MIN_GALLOP);
+            
+            min_gallop += 2;
+        }
+
+done:
+        min_gallop_ = min_gallop;
+        while (i > 0)
+        {
+            array_[--k] = std::move(buf_[--i]);
+        }
+    }
+    
+    /**
+     * @brief       Move a range of the array to the buffer.
+     * @param       lo : The index of the first element of the range.
+     * @param       hi : The index of the past-the-end element of the range.
+     */
+    void fill_buffer(std::size_t lo, std::size_t hi)
+    {
+        buf_.clear();
+        buf_.reserve(hi - lo);
+        for (; lo < hi; ++lo)
+        {
+            buf_.push_back(std::move(array_[lo]));
+        }
+    }
+    
+    /** The buffer of the merges. */
+    std::vector<value_type> buf_;
+    
+    /** The array to sort. */
+    TpArray& array_;
+    
+    /** The comparison function. */
+    const TpCompare& comp_;
+    
+    /** The indexes of the first elements of the pending runs. */
+    std::size_t run_bgns_[TIMSORT_MAX_RUNS];
+    
+    /** The lengths of the pending runs. */
+    std::size_t run_lens_[TIMSORT_MAX_RUNS];
+    
+    /** The number of pending runs. */
+    std::size_t nbr_runs_;
+    
+    /** The number of consecutive wins of a run after which a merge switches to galloping. */
+    std::size_t min_gallop_;
+};
+
+
+} /* __hidden_algorithm */
+/** @endcond */
+
+
+/**
+ * @brief       Sort the array elements with a timsort, that is stable and adaptive. The array is
+ *              split in the runs it already holds, the short runs being extended by insertion,
+ *              with a binary search unless the elements are arithmetic, and the runs are merged so
+ *              that the merges stay balanced. The merges gallop over the long sequences of
+ *              elements coming from the same run. The sort is O(n * log(n)) in the worst case and
+ *              O(n) on arrays made of few runs, and it uses a buffer of at most half the array
+ *              size.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ * @param       comp : Binary function that accepts two elements in the range as arguments, and
+ *              returns a value convertible to bool. The value returned indicates whether the
+ *              element passed as first argument is considered to go before the second.
+ */
+template<typename TpArray, typename TpCompare>
+void timsort(TpArray& array, std::size_t sz, const TpCompare& comp)
+{
+    if (sz > 1)
+    {
+        __hidden_algorithm::__timsort<TpArray, TpCompare>(array, comp).sort(sz);
+    }
+}
+
+
+/**
+ * @brief       Sort the array elements with a timsort, that is stable and adaptive.
+ * @param       array : The array to sort.
+ * @param       sz : The array size.
+ */
+template<typename TpArray>
+void timsort(TpArray& array, std::size_t sz)
+{
+    timsort(array, sz, simple_compare<std::decay_t<decltype(array[0])>>());
+}
+
+
+}
+}
+
+
+#endif
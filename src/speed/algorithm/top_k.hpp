@@ -0,0 +1,384 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/top_k.hpp
+ * @brief       top_k class header.
+ * @author      Killian
+ * @date        2018/09/25 - 15:40
+ */
+
+#ifndef SPEED_ALGORITHM_TOP_K_HPP
+#define SPEED_ALGORITHM_TOP_K_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "algorithm.hpp"
+
+
+namespace speed {
+namespace algorithm {
+
+
+/**
+ * @brief       Class that accumulates a stream of values and keeps the k greatest ones. The values
+ *              kept are stored in a bounded heap whose root is the lowest of them, so a value is
+ *              inserted only if it goes after the root. When values are pushed in chunks, the 32
+ *              bits integers, the floats and the doubles compared with std::less are first
+ *              compared to the root several at a time with SIMD instructions, so the values that
+ *              are not kept, which are most of them on long streams, cost a fraction of a
+ *              comparison. An accumulator can be filled by every thread and the accumulators
+ *              merged at the end.
+ */
+template<typename TpValue, typename TpCompare = std::less<TpValue>>
+class top_k
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The compare type. */
+    using compare_type = TpCompare;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       k : The maximum number of values to keep.
+     * @param       comp : Binary function that accepts two values as arguments, and returns a
+     *              value convertible to bool. The value returned indicates whether the value
+     *              passed as first argument is considered to go before the second.
+     */
+    explicit top_k(std::size_t k, const compare_type& comp = compare_type())
+            : heap_()
+            , k_(k)
+            , comp_(comp)
+    {
+        heap_.reserve(k);
+    }
+    
+    /**
+     * @brief       Push a value.
+     * @param       val : The value to push.
+     */
+    void push(const value_type& val)
+    {
+        if (heap_.size() < k_)
+        {
+            push_heap(val);
+        }
+        else if (k_ > 0 && comp_(heap_[0], val))
+        {
+            replace_root(val);
+        }
+    }
+    
+    /**
+     * @brief       Push a chunk of values.
+     * @param       vals : The values to push.
+     * @param       sz : The number of values to push.
+     */
+    void push(const value_type* vals, std::size_t sz)
+    {
+        std::size_t i = 0;
+        
+        for (; i < sz && heap_.size() < k_; ++i)
+        {
+            push_heap(vals[i]);
+        }
+        
+        if (k_ == 0)
+        {
+            return;
+        }
+
+#if defined(__SSE2__)
+        if constexpr (SIMD_FILTER)
+        {
+            i = push_simd(vals, i, sz);
+        }
+#endif
+
+        for (; i < sz; ++i)
+        {
+            if (comp_(heap_[0], vals[i]))
+            {
+                replace_root(vals[i]);
+            }
+        }
+    }
+    
+    /**
+     * @brief       Push a chunk of values.
+     * @param       vals : The values to push.
+     */
+    void push(const std::vector<value_type>& vals)
+    {
+        push(vals.data(), vals.size());
+    }
+    
+    /**
+     * @brief       Push the values kept by another accumulator.
+     * @param       rhs : The other accumulator.
+     */
+    void merge(const top_k& rhs)
+    {
+        push(rhs.heap_.data(), rhs.heap_.size());
+    }
+    
+    /**
+     * @brief       Remove all the values kept.
+     */
+    void clear() noexcept
+    {
+        heap_.clear();
+    }
+    
+    /**
+     * @brief       Get the values kept, the greatest first.
+     * @return      The values kept, the greatest first.
+     */
+    [[nodiscard]] std::vector<value_type> get_values() const
+    {
+        std::vector<value_type> vals(heap_);
+        
+        quicksort(vals, vals.size(), [this](const value_type& lhs, const value_type& rhs)
+        {
+            return comp_(rhs, lhs);
+        });
+        
+        return vals;
+    }
+    
+    /**
+     * @brief       Get the lowest value kept, that a value has to go after to be kept when the
+     *              accumulator is full.
+     * @return      The lowest value kept. The accumulator must not be empty.
+     */
+    [[nodiscard]] const value_type& get_threshold() const noexcept
+    {
+        return heap_[0];
+    }
+    
+    /**
+     * @brief       Get the maximum number of values to keep.
+     * @return      The maximum number of values to keep.
+     */
+    [[nodiscard]] std::size_t get_k() const noexcept
+    {
+        return k_;
+    }
+    
+    /**
+     * @brief       Get the number of values kept.
+     * @return      The number of values kept.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return heap_.size();
+    }
+    
+    /**
+     * @brief       Check whether the accumulator keeps no value.
+     * @return      If the accumulator is empty true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return heap_.empty();
+    }
+
+private:
+    /** Whether the chunks are filtered with SIMD instructions. */
+    static constexpr bool SIMD_FILTER =
+            (std::is_same<compare_type, std::less<value_type>>::value ||
+             std::is_same<compare_type, std::less<>>::value) &&
+            (std::is_same<value_type, std::int32_t>::value ||
+             std::is_same<value_type, float>::value ||
+             std::is_same<value_type, double>::value);
+    
+    /**
+     * @brief       Insert a value in the heap, that is not full.
+     * @param       val : The value to insert.
+     */
+    void push_heap(const value_type& val)
+    {
+        std::size_t idx = heap_.size();
+        std::size_t parnt;
+        
+        heap_.push_back(val);
+        while (idx > 0)
+        {
+            parnt = (idx - 1) / 2;
+            if (!comp_(heap_[idx], heap_[parnt]))
+            {
+                break;
+            }
+            
+            std::swap(heap_[idx], heap_[parnt]);
+            idx = parnt;
+        }
+    }
+    
+    /**
+     * @brief       Replace the root of the heap by a value, and restore the heap order.
+     * @param       val : The new value.
+     */
+    void replace_root(const value_type& val)
+    {
+        const std::size_t sz = heap_.size();
+        std::size_t idx = 0;
+        std::size_t chld;
+        
+        while ((chld = 2 * idx + 1) < sz)
+        {
+            if (chld + 1 < sz && comp_(heap_[chld + 1], heap_[chld]))
+            {
+                ++chld;
+            }
+            
+            if (!comp_(heap_[chld], val))
+            {
+                break;
+            }
+            
+            heap_[idx] = std::move(heap_[chld]);
+            idx = chld;
+        }
+        
+        heap_[idx] = val;
+    }
+
+#if defined(__SSE2__)
+    /**
+     * @brief       Push the values of a chunk, skipping with SIMD instructions the blocks of
+     *              values that are all not greater than the root of the heap, which is full.
+     * @param       vals : The values to push.
+     * @param       i : The index of the first value to push.
+     * @param       sz : The number of values of the chunk.
+     * @return      The index of the first value not pushed.
+     */
+    std::size_t push_simd(const value_type* vals, std::size_t i, std::size_t sz)
+    {
+#if defined(__AVX2__)
+        constexpr std::size_t blk_sz = 32 / sizeof(value_type);
+#else
+        constexpr std::size_t blk_sz = 16 / sizeof(value_type);
+#endif
+        std::uint32_t msk;
+        
+        for (; i + blk_sz <= sz; i += blk_sz)
+        {
+            msk = get_greater_mask(vals + i, heap_[0]);
+            while (msk != 0)
+            {
+                const value_type& val = vals[i + get_lowest_bit(msk)];
+                
+                if (comp_(heap_[0], val))
+                {
+                    replace_root(val);
+                }
+                
+                msk &= msk - 1;
+            }
+        }
+        
+        return i;
+    }
+    
+    /**
+     * @brief       Get the mask of the values of a block that are greater than a threshold.
+     * @param       vals : The values of the block.
+     * @param       thrshld : The threshold.
+     * @return      The mask that has the bit i set if the value i is greater than the threshold.
+     */
+    static std::uint32_t get_greater_mask(const value_type* vals, value_type thrshld) noexcept
+    {
+#if defined(__AVX2__)
+        if constexpr (std::is_same<value_type, float>::value)
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(
+                    _mm256_loadu_ps(vals), _mm256_set1_ps(thrshld), _CMP_GT_OQ)));
+        }
+        else if constexpr (std::is_same<value_type, double>::value)
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_cmp_pd(
+                    _mm256_loadu_pd(vals), _mm256_set1_pd(thrshld), _CMP_GT_OQ)));
+        }
+        else
+        {
+            return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(
+                    _mm256_cmpgt_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(vals)),
+                                       _mm256_set1_epi32(thrshld)))));
+        }
+#else
+        if constexpr (std::is_same<value_type, float>::value)
+        {
+            return static_cast<std::uint32_t>(
+                    _mm_movemask_ps(_mm_cmpgt_ps(_mm_loadu_ps(vals), _mm_set1_ps(thrshld))));
+        }
+        else if constexpr (std::is_same<value_type, double>::value)
+        {
+            return static_cast<std::uint32_t>(
+                    _mm_movemask_pd(_mm_cmpgt_pd(_mm_loadu_pd(vals), _mm_set1_pd(thrshld))));
+        }
+        else
+        {
+            return static_cast<std::uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(
+                    _mm_cmpgt_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(vals)),
+                                    _mm_set1_epi32(thrshld)))));
+        }
+#endif
+    }
+    
+    /**
+     * @brief       Get the position of the lowest bit set in a mask.
+     * @param       msk : The mask, that must not be 0.
+     * @return      The position of the lowest bit set in the mask.
+     */
+    static std::size_t get_lowest_bit(std::uint32_t msk) noexcept
+    {
+        return static_cast<std::size_t>(__builtin_ctz(msk));
+    }
+#endif
+
+    /** The values kept, in a heap whose root is the lowest value. */
+    std::vector<value_type> heap_;
+    
+    /** The maximum number of values to keep. */
+    std::size_t k_;
+    
+    /** The comparison function. */
+    compare_type comp_;
+};
+
+
+}
+}
+
+
+#endif
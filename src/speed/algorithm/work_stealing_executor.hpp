@@ -0,0 +1,420 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/algorithm/work_stealing_executor.hpp
+ * @brief       work_stealing_executor class header.
+ * @author      Killian
+ * @date        2018/09/26 - 10:03
+ */
+
+#ifndef SPEED_ALGORITHM_WORK_STEALING_EXECUTOR_HPP
+#define SPEED_ALGORITHM_WORK_STEALING_EXECUTOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace speed {
+namespace algorithm {
+
+
+/**
+ * @brief       Executor that runs the tasks on the calling thread, in order. It can be passed to
+ *              the parallel algorithms to run them sequentially.
+ */
+class sequential_executor
+{
+public:
+    /**
+     * @brief       Get the number of threads that run the tasks.
+     * @return      The number of threads that run the tasks, that is 1.
+     */
+    [[nodiscard]] std::size_t get_concurrency() const noexcept
+    {
+        return 1;
+    }
+    
+    /**
+     * @brief       Run tasks and wait for them.
+     * @param       nbr_tasks : The number of tasks.
+     * @param       fnc : The function to call for every task, that receives the task index.
+     */
+    template<typename TpFunction>
+    void bulk_run(std::size_t nbr_tasks, const TpFunction& fnc) const
+    {
+        for (std::size_t i = 0; i < nbr_tasks; ++i)
+        {
+            fnc(i);
+        }
+    }
+};
+
+
+/**
+ * @brief       Executor that runs tasks on a pool of threads with work stealing. The tasks of a
+ *              bulk run are split in one range of indexes per thread. Every thread runs the tasks
+ *              of its range from the front, and when its range is empty it steals the back half
+ *              of the range of another thread, so the load is balanced even when the tasks have
+ *              different costs. The thread that calls bulk_run takes part in the work. The bulk
+ *              runs are serialized, and a bulk run started from a task runs on the calling
+ *              thread.
+ */
+class work_stealing_executor
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_thrds : The number of threads that run the tasks, the thread that calls
+     *              bulk_run included. If it is 0 the number of hardware threads is used.
+     */
+    explicit work_stealing_executor(std::size_t nbr_thrds = 0)
+            : rngs_()
+            , thrds_()
+            , mtx_()
+            , run_mtx_()
+            , wrk_cv_()
+            , dne_cv_()
+            , excptn_()
+            , call_(nullptr)
+            , ctx_(nullptr)
+            , rmng_(0)
+            , actv_(0)
+            , gen_(0)
+            , nbr_thrds_(nbr_thrds != 0 ? nbr_thrds
+                                        : std::max(std::thread::hardware_concurrency(), 1U))
+            , stop_(false)
+    {
+        rngs_ = std::make_unique<task_range[]>(nbr_thrds_);
+        
+        thrds_.reserve(nbr_thrds_ - 1);
+        for (std::size_t i = 1; i < nbr_thrds_; ++i)
+        {
+            thrds_.emplace_back(&work_stealing_executor::work, this, i);
+        }
+    }
+    
+    work_stealing_executor(const work_stealing_executor&) = delete;
+    
+    work_stealing_executor& operator =(const work_stealing_executor&) = delete;
+    
+    /**
+     * @brief       Destructor. It waits for the threads to stop.
+     */
+    ~work_stealing_executor()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            stop_ = true;
+        }
+        
+        wrk_cv_.notify_all();
+        for (auto& x : thrds_)
+        {
+            x.join();
+        }
+    }
+    
+    /**
+     * @brief       Get the number of threads that run the tasks.
+     * @return      The number of threads that run the tasks, the thread that calls bulk_run
+     *              included.
+     */
+    [[nodiscard]] std::size_t get_concurrency() const noexcept
+    {
+        return nbr_thrds_;
+    }
+    
+    /**
+     * @brief       Run tasks and wait for them. The first exception thrown by a task is rethrown
+     *              once all the tasks are done.
+     * @param       nbr_tasks : The number of tasks.
+     * @param       fnc : The function to call for every task, that receives the task index. It is
+     *              called concurrently from several threads.
+     */
+    template<typename TpFunction>
+    void bulk_run(std::size_t nbr_tasks, const TpFunction& fnc)
+    {
+        if (nbr_tasks <= 1 || nbr_thrds_ == 1 || in_task_)
+        {
+            for (std::size_t i = 0; i < nbr_tasks; ++i)
+            {
+                fnc(i);
+            }
+            
+            return;
+        }
+        
+        std::lock_guard<std::mutex> run_lck(run_mtx_);
+        std::exception_ptr excptn;
+        
+        for (std::size_t i = 0; i < nbr_thrds_; ++i)
+        {
+            std::lock_guard<std::mutex> rng_lck(rngs_[i].mtx);
+            
+            rngs_[i].bgn = nbr_tasks * i / nbr_thrds_;
+            rngs_[i].end = nbr_tasks * (i + 1) / nbr_thrds_;
+        }
+        
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            
+            call_ = [](const void* ctx, std::size_t task_idx)
+            {
+                (*static_cast<const TpFunction*>(ctx))(task_idx);
+            };
+            ctx_ = &fnc;
+            rmng_ = nbr_tasks;
+            actv_ = nbr_thrds_;
+            ++gen_;
+        }
+        
+        wrk_cv_.notify_all();
+        run(0);
+        
+        {
+            std::unique_lock<std::mutex> lck(mtx_);
+            
+            dne_cv_.wait(lck, [this] { return actv_ == 0; });
+            std::swap(excptn, excptn_);
+        }
+        
+        if (excptn)
+        {
+            std::rethrow_exception(excptn);
+        }
+    }
+
+private:
+    /**
+     * @brief       Range of task indexes owned by a thread.
+     */
+    struct alignas(64) task_range
+    {
+        /** Mutex that protects the range. */
+        std::mutex mtx;
+        
+        /** The index of the first task of the range. */
+        std::size_t bgn = 0;
+        
+        /** The index of the past-the-end task of the range. */
+        std::size_t end = 0;
+    };
+    
+    /**
+     * @brief       Wait for the bulk runs and take part in them, until the executor is destroyed.
+     * @param       thrd_idx : The index of the thread.
+     */
+    void work(std::size_t thrd_idx)
+    {
+        std::size_t lst_gen = 0;
+        
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lck(mtx_);
+                
+                wrk_cv_.wait(lck, [&] { return stop_ || gen_ != lst_gen; });
+                if (stop_)
+                {
+                    return;
+                }
+                
+                lst_gen = gen_;
+            }
+            
+            run(thrd_idx);
+        }
+    }
+    
+    /**
+     * @brief       Run the tasks of the current bulk run until there is none left to take.
+     * @param       thrd_idx : The index of the thread.
+     */
+    void run(std::size_t thrd_idx)
+    {
+        std::size_t task_idx;
+        
+        in_task_ = true;
+        while (take_task(thrd_idx, task_idx) || steal_task(thrd_idx, task_idx))
+        {
+            try
+            {
+                call_(ctx_, task_idx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lck(mtx_);
+                
+                if (!excptn_)
+                {
+                    excptn_ = std::current_exception();
+                }
+            }
+            
+            rmng_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        in_task_ = false;
+        
+        std::lock_guard<std::mutex> lck(mtx_);
+        
+        if (--actv_ == 0)
+        {
+            dne_cv_.notify_all();
+        }
+    }
+    
+    /**
+     * @brief       Take the first task of the range of a thread.
+     * @param       thrd_idx : The index of the thread.
+     * @param       task_idx : The index of the task taken.
+     * @return      If a task has been taken true is returned, otherwise false is returned.
+     */
+    bool take_task(std::size_t thrd_idx, std::size_t& task_idx)
+    {
+        std::lock_guard<std::mutex> lck(rngs_[thrd_idx].mtx);
+        
+        if (rngs_[thrd_idx].bgn == rngs_[thrd_idx].end)
+        {
+            return false;
+        }
+        
+        task_idx = rngs_[thrd_idx].bgn++;
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Steal the back half of the range of another thread, and take its first task.
+     * @param       thrd_idx : The index of the thread that steals.
+     * @param       task_idx : The index of the task taken.
+     * @return      If a task has been taken true is returned, otherwise false is returned.
+     */
+    bool steal_task(std::size_t thrd_idx, std::size_t& task_idx)
+    {
+        std::size_t vctm;
+        std::size_t mid;
+        std::size_t end;
+        
+        if (rmng_.load(std::memory_order_acquire) == 0)
+        {
+            return false;
+        }
+        
+        for (std::size_t i = 1; i < nbr_thrds_; ++i)
+        {
+            vctm = (thrd_idx + i) % nbr_thrds_;
+            
+            {
+                std::lock_guard<std::mutex> lck(rngs_[vctm].mtx);
+                
+                if (rngs_[vctm].bgn == rngs_[vctm].end)
+                {
+                    continue;
+                }
+                
+                end = rngs_[vctm].end;
+                mid = end - (end - rngs_[vctm].bgn + 1) / 2;
+                rngs_[vctm].end = mid;
+            }
+            
+            std::lock_guard<std::mutex> lck(rngs_[thrd_idx].mtx);
+            
+            rngs_[thrd_idx].bgn = mid + 1;
+            rngs_[thrd_idx].end = end;
+            task_idx = mid;
+            
+            return true;
+        }
+        
+        return false;
+    }
+    
+    /** Whether the current thread is running a task. */
+    static inline thread_local bool in_task_ = false;
+    
+    /** The ranges of task indexes of the threads. */
+    std::unique_ptr<task_range[]> rngs_;
+    
+    /** The threads, the thread that calls bulk_run excluded. */
+    std::vector<std::thread> thrds_;
+    
+    /** Mutex that protects the state of the bulk run. */
+    std::mutex mtx_;
+    
+    /** Mutex that serializes the bulk runs. */
+    std::mutex run_mtx_;
+    
+    /** Condition variable notified when a bulk run starts or the executor is destroyed. */
+    std::condition_variable wrk_cv_;
+    
+    /** Condition variable notified when all the threads have left the bulk run. */
+    std::condition_variable dne_cv_;
+    
+    /** The first exception thrown by a task of the bulk run. */
+    std::exception_ptr excptn_;
+    
+    /** Function that calls the task function of the bulk run. */
+    void (*call_)(const void*, std::size_t);
+    
+    /** The task function of the bulk run. */
+    const void* ctx_;
+    
+    /** The number of tasks of the bulk run not done yet. */
+    std::atomic<std::size_t> rmng_;
+    
+    /** The number of threads that have not left the bulk run yet. */
+    std::size_t actv_;
+    
+    /** The number of bulk runs started. */
+    std::size_t gen_;
+    
+    /** The number of threads, the thread that calls bulk_run included. */
+    std::size_t nbr_thrds_;
+    
+    /** Whether the threads have to stop. */
+    bool stop_;
+};
+
+
+/**
+ * @brief       Get the executor used by the parallel algorithms when none is given. It is created
+ *              on the first call with as many threads as hardware threads.
+ * @return      The default executor.
+ */
+inline work_stealing_executor& get_default_executor()
+{
+    static work_stealing_executor exec;
+    
+    return exec;
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,51 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency.hpp
+ * @brief       concurrency main header.
+ * @author      Killian
+ * @date        2018/09/30 - 09:14
+ */
+
+#ifndef SPEED_CONCURRENCY_HPP
+#define SPEED_CONCURRENCY_HPP
+
+#include "concurrency/chase_lev_deque.hpp"
+#include "concurrency/concurrency_exception.hpp"
+#include "concurrency/future.hpp"
+#include "concurrency/pipeline.hpp"
+#include "concurrency/stage_modes.hpp"
+#include "concurrency/task.hpp"
+#include "concurrency/thread_pool.hpp"
+
+
+namespace speed {
+
+
+/**
+ * @brief       Contains resources to run tasks concurrently.
+ */
+namespace concurrency {}
+
+
+}
+
+
+#endif
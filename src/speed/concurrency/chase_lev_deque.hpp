@@ -0,0 +1,291 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/chase_lev_deque.hpp
+ * @brief       chase_lev_deque class header.
+ * @author      Killian
+ * @date        2018/09/30 - 09:14
+ */
+
+#ifndef SPEED_CONCURRENCY_CHASE_LEV_DEQUE_HPP
+#define SPEED_CONCURRENCY_CHASE_LEV_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+
+namespace speed {
+namespace concurrency {
+
+
+/**
+ * @brief       Class that represents the work-stealing deque of Chase and Lev. A single thread, the
+ *              owner, pushes and pops values at the bottom, without any atomic read-modify-write
+ *              unless a single value is left, while any number of other threads steal values at
+ *              the top with a CAS. The values are stored in a circular array that grows when it is
+ *              full. The previous arrays are kept until the deque is destroyed, since a thief can
+ *              still be reading them.
+ */
+template<typename TpValue>
+class chase_lev_deque
+{
+    static_assert(std::is_trivially_copyable<TpValue>::value,
+                  "The values of a chase_lev_deque have to be trivially copyable");
+
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       cap : The initial capacity, rounded up to a power of two.
+     */
+    explicit chase_lev_deque(std::size_t cap = 256)
+            : top_(0)
+            , bot_(0)
+            , arr_(nullptr)
+            , arrs_()
+    {
+        std::size_t pow2_cap = 2;
+        
+        while (pow2_cap < cap)
+        {
+            pow2_cap *= 2;
+        }
+        
+        arrs_.push_back(std::make_unique<circular_array>(pow2_cap));
+        arr_.store(arrs_.back().get(), std::memory_order_relaxed);
+    }
+    
+    /** @cond */
+    chase_lev_deque(const chase_lev_deque&) = delete;
+    
+    chase_lev_deque& operator =(const chase_lev_deque&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Push a value at the bottom. It must only be called by the owner.
+     * @param       val : The value to push.
+     */
+    void push(const value_type& val)
+    {
+        const std::int64_t bot = bot_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        circular_array* arr = arr_.load(std::memory_order_relaxed);
+        
+        if (bot - top > static_cast<std::int64_t>(arr->get_mask()))
+        {
+            arr = grow(arr, top, bot);
+        }
+        
+        arr->store(bot, val);
+        bot_.store(bot + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief       Pop the value at the bottom, that is the last one pushed. It must only be called
+     *              by the owner.
+     * @param       val : The value popped.
+     * @return      If a value has been popped true is returned, otherwise false is returned.
+     */
+    bool pop(value_type& val)
+    {
+        const std::int64_t bot = bot_.load(std::memory_order_relaxed) - 1;
+        circular_array* arr = arr_.load(std::memory_order_relaxed);
+        std::int64_t top;
+        
+        bot_.store(bot, std::memory_order_seq_cst);
+        top = top_.load(std::memory_order_seq_cst);
+        
+        if (top > bot)
+        {
+            bot_.store(bot + 1, std::memory_order_relaxed);
+            return false;
+        }
+        
+        val = arr->load(bot);
+        if (top < bot)
+        {
+            return true;
+        }
+        
+        const bool sccs = top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                                       std::memory_order_relaxed);
+        
+        bot_.store(bot + 1, std::memory_order_relaxed);
+        
+        return sccs;
+    }
+    
+    /**
+     * @brief       Steal the value at the top, that is the first one pushed. It can be called by
+     *              any thread.
+     * @param       val : The value stolen.
+     * @return      If a value has been stolen true is returned, otherwise false is returned, either
+     *              because the deque is empty or because another thread took the value first.
+     */
+    bool steal(value_type& val)
+    {
+        std::int64_t top = top_.load(std::memory_order_seq_cst);
+        const std::int64_t bot = bot_.load(std::memory_order_seq_cst);
+        
+        if (top >= bot)
+        {
+            return false;
+        }
+        
+        val = arr_.load(std::memory_order_acquire)->load(top);
+        
+        return top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Get the number of values in the deque. It is only a hint when other threads use
+     *              the deque.
+     * @return      The number of values in the deque.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        const std::int64_t bot = bot_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_relaxed);
+        
+        return bot > top ? static_cast<std::size_t>(bot - top) : 0;
+    }
+    
+    /**
+     * @brief       Check whether the deque is empty. It is only a hint when other threads use the
+     *              deque.
+     * @return      If the deque is empty true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+    
+    /**
+     * @brief       Get the number of values the deque can hold before growing.
+     * @return      The number of values the deque can hold before growing.
+     */
+    [[nodiscard]] std::size_t get_capacity() const noexcept
+    {
+        return arr_.load(std::memory_order_relaxed)->get_mask() + 1;
+    }
+
+private:
+    /**
+     * @brief       Circular array of values, indexed with the unbounded top and bottom indexes.
+     */
+    class circular_array
+    {
+    public:
+        /**
+         * @brief       Constructor with parameters.
+         * @param       cap : The capacity, that has to be a power of two.
+         */
+        explicit circular_array(std::size_t cap)
+                : vals_(std::make_unique<std::atomic<value_type>[]>(cap))
+                , msk_(cap - 1)
+        {
+        }
+        
+        /**
+         * @brief       Load a value.
+         * @param       idx : The unbounded index of the value.
+         * @return      The value.
+         */
+        [[nodiscard]] value_type load(std::int64_t idx) const noexcept
+        {
+            return vals_[static_cast<std::size_t>(idx) & msk_].load(std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief       Store a value.
+         * @param       idx : The unbounded index of the value.
+         * @param       val : The value.
+         */
+        void store(std::int64_t idx, const value_type& val) noexcept
+        {
+            vals_[static_cast<std::size_t>(idx) & msk_].store(val, std::memory_order_relaxed);
+        }
+        
+        /**
+         * @brief       Get the mask that maps the unbounded indexes to the array.
+         * @return      The mask that maps the unbounded indexes to the array.
+         */
+        [[nodiscard]] std::size_t get_mask() const noexcept
+        {
+            return msk_;
+        }
+    
+    private:
+        /** The values. */
+        std::unique_ptr<std::atomic<value_type>[]> vals_;
+        
+        /** The mask that maps the unbounded indexes to the array, that is the capacity - 1. */
+        std::size_t msk_;
+    };
+    
+    /**
+     * @brief       Replace the array by one twice larger that holds the same values.
+     * @param       arr : The current array.
+     * @param       top : The top index.
+     * @param       bot : The bottom index.
+     * @return      The new array.
+     */
+    circular_array* grow(circular_array* arr, std::int64_t top, std::int64_t bot)
+    {
+        auto new_arr = std::make_unique<circular_array>((arr->get_mask() + 1) * 2);
+        
+        for (std::int64_t i = top; i < bot; ++i)
+        {
+            new_arr->store(i, arr->load(i));
+        }
+        
+        arrs_.push_back(std::move(new_arr));
+        arr = arrs_.back().get();
+        arr_.store(arr, std::memory_order_release);
+        
+        return arr;
+    }
+    
+    /** The index of the top value, where the thieves steal. */
+    alignas(64) std::atomic<std::int64_t> top_;
+    
+    /** The index past the bottom value, where the owner pushes and pops. */
+    alignas(64) std::atomic<std::int64_t> bot_;
+    
+    /** The current array. */
+    std::atomic<circular_array*> arr_;
+    
+    /** All the arrays allocated, the current one last. */
+    std::vector<std::unique_ptr<circular_array>> arrs_;
+};
+
+
+}
+}
+
+
+#endif
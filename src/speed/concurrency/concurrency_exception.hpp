@@ -0,0 +1,127 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/concurrency_exception.hpp
+ * @brief       concurrency_exception main header.
+ * @author      Killian
+ * @date        2018/10/02 - 09:20
+ */
+
+#ifndef SPEED_CONCURRENCY_CONCURRENCY_EXCEPTION_HPP
+#define SPEED_CONCURRENCY_CONCURRENCY_EXCEPTION_HPP
+
+#include "../exception.hpp"
+
+
+namespace speed {
+namespace concurrency {
+
+
+/**
+ * @brief       Base class used to throw exceptions when a concurrency operation fails.
+ */
+class concurrency_exception : public speed::exception::exception_base
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "concurrency exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when a promise is destroyed before being satisfied.
+ */
+class broken_promise_exception : public concurrency_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "broken promise exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when the future of a promise is retrieved twice.
+ */
+class future_already_retrieved_exception : public concurrency_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "future already retrieved exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when a continuation is attached to a future that
+ *              already has one.
+ */
+class continuation_already_attached_exception : public concurrency_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "continuation already attached exception";
+    }
+};
+
+
+/**
+ * @brief       Class used to throw exceptions when a promise is satisfied twice.
+ */
+class promise_already_satisfied_exception : public concurrency_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "promise already satisfied exception";
+    }
+};
+
+
+}
+}
+
+
+#endif
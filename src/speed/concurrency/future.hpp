@@ -0,0 +1,1305 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/future.hpp
+ * @brief       future class header.
+ * @author      Killian
+ * @date        2018/10/02 - 10:05
+ */
+
+#ifndef SPEED_CONCURRENCY_FUTURE_HPP
+#define SPEED_CONCURRENCY_FUTURE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../system/sync/sync.hpp"
+#include "concurrency_exception.hpp"
+
+
+namespace speed {
+namespace concurrency {
+
+
+template<typename TpValue>
+class future;
+
+
+template<typename TpValue>
+class promise;
+
+
+/**
+ * @brief       Executor that runs the tasks on the calling thread, as soon as they are submitted.
+ *              The continuations attached with it run on the thread that makes their future
+ *              ready.
+ */
+class inline_executor
+{
+public:
+    /**
+     * @brief       Run a task.
+     * @param       fnc : The task function.
+     */
+    template<typename TpFunction>
+    void submit(TpFunction&& fnc) const
+    {
+        std::forward<TpFunction>(fnc)();
+    }
+};
+
+
+/**
+ * @brief       Result of when_any.
+ */
+template<typename TpValue>
+struct when_any_result
+{
+    /** The index of the first future that was ready, or npos if there was no future. */
+    std::size_t idx;
+    
+    /** The futures. A continuation can be attached to the ones that are not ready. */
+    std::vector<future<TpValue>> futs;
+    
+    /** The value of the index when there was no future. */
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+};
+
+
+/** @cond */
+namespace __hidden_concurrency {
+
+
+/** The bit of the state of a shared state set when its value or its exception is set. */
+constexpr std::uint32_t STATE_READY_BIT = 1;
+
+/** The bit of the state of a shared state set when a thread sleeps waiting for it. */
+constexpr std::uint32_t STATE_WAITING_BIT = 2;
+
+
+/**
+ * @brief       Value stored by the shared states of the futures of void.
+ */
+struct __unit
+{
+};
+
+
+/** The type of value stored by the shared states of the futures of a type. */
+template<typename TpValue>
+using __value_t = std::conditional_t<std::is_void<TpValue>::value, __unit, TpValue>;
+
+
+/**
+ * @brief       Callback run when a shared state becomes ready. It is embedded in the object that
+ *              it notifies, so attaching it to a shared state does not allocate.
+ */
+struct __continuation
+{
+    /** The function called when the shared state becomes ready. */
+    void (*on_ready)(__continuation*) noexcept;
+};
+
+
+/** Continuation stored in the shared states that are ready, that is never called. */
+inline __continuation __ready_marker = {nullptr};
+
+
+/**
+ * @brief       Result of an attempt to attach a continuation to a shared state.
+ */
+enum class __attach_status : std::uint8_t
+{
+    /** The continuation has been attached. */
+    ATTACHED,
+    
+    /** The shared state is ready, so the continuation has not been attached. */
+    READY,
+    
+    /** Another continuation is attached, so the continuation has not been attached. */
+    TAKEN
+};
+
+
+/**
+ * @brief       Part of a shared state that does not depend on the value type. It is reference
+ *              counted, and holds the exception, the continuation and the state word, on which
+ *              the threads that wait for it sleep.
+ */
+class __shared_state_base
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_refs : The initial number of references.
+     */
+    explicit __shared_state_base(std::uint32_t nbr_refs) noexcept
+            : excptn_()
+            , cont_(nullptr)
+            , refs_(nbr_refs)
+            , stte_(0)
+    {
+    }
+    
+    /** @cond */
+    __shared_state_base(const __shared_state_base&) = delete;
+    
+    __shared_state_base& operator =(const __shared_state_base&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor.
+     */
+    virtual ~__shared_state_base() = default;
+    
+    /**
+     * @brief       Add a reference.
+     */
+    void add_reference() noexcept
+    {
+        refs_.fetch_add(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Remove a reference, and destroy the shared state if it was the last one.
+     */
+    void release() noexcept
+    {
+        if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+    }
+    
+    /**
+     * @brief       Check whether the value or the exception is set.
+     * @return      If the value or the exception is set true is returned, otherwise false is
+     *              returned.
+     */
+    [[nodiscard]] bool is_ready() const noexcept
+    {
+        return (stte_.load(std::memory_order_acquire) & STATE_READY_BIT) != 0;
+    }
+    
+    /**
+     * @brief       Wait until the value or the exception is set.
+     */
+    void wait() noexcept
+    {
+        std::uint32_t stte = stte_.load(std::memory_order_acquire);
+        
+        while ((stte & STATE_READY_BIT) == 0)
+        {
+            if ((stte & STATE_WAITING_BIT) != 0 ||
+                stte_.compare_exchange_weak(stte, stte | STATE_WAITING_BIT,
+                                            std::memory_order_acquire))
+            {
+                if (!speed::system::futex_wait(&stte_, stte | STATE_WAITING_BIT))
+                {
+                    std::this_thread::yield();
+                }
+                
+                stte = stte_.load(std::memory_order_acquire);
+            }
+        }
+    }
+    
+    /**
+     * @brief       Attach the continuation, if the shared state is not ready yet and has no
+     *              continuation.
+     * @param       cont : The continuation. Only one continuation can be attached at a time.
+     * @return      Whether the continuation has been attached, or why it has not.
+     */
+    __attach_status try_attach(__continuation* cont) noexcept
+    {
+        __continuation* expctd = nullptr;
+        
+        if (cont_.compare_exchange_strong(expctd, cont, std::memory_order_acq_rel,
+                                          std::memory_order_acquire))
+        {
+            return __attach_status::ATTACHED;
+        }
+        
+        return expctd == &__ready_marker ? __attach_status::READY : __attach_status::TAKEN;
+    }
+    
+    /**
+     * @brief       Detach the continuation, if the shared state is not ready yet, so that another
+     *              one can be attached.
+     * @param       cont : The continuation.
+     * @return      If the continuation has been detached true is returned, otherwise it is not
+     *              attached or it is being called and false is returned.
+     */
+    bool try_detach(__continuation* cont) noexcept
+    {
+        return cont_.compare_exchange_strong(cont, nullptr, std::memory_order_acq_rel,
+                                             std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief       Set the exception, which makes the shared state ready.
+     * @param       excptn : The exception.
+     */
+    void set_exception(std::exception_ptr excptn) noexcept
+    {
+        excptn_ = std::move(excptn);
+        make_ready();
+    }
+
+protected:
+    /**
+     * @brief       Make the shared state ready, wake the threads that wait for it, and call its
+     *              continuation.
+     */
+    void make_ready() noexcept
+    {
+        __continuation* cont;
+        
+        if ((stte_.exchange(STATE_READY_BIT, std::memory_order_acq_rel) & STATE_WAITING_BIT) != 0)
+        {
+            speed::system::futex_wake_all(&stte_);
+        }
+        
+        cont = cont_.exchange(&__ready_marker, std::memory_order_acq_rel);
+        if (cont != nullptr)
+        {
+            cont->on_ready(cont);
+        }
+    }
+    
+    /** The exception. */
+    std::exception_ptr excptn_;
+
+private:
+    /** The continuation, or __ready_marker once the shared state is ready. */
+    std::atomic<__continuation*> cont_;
+    
+    /** The number of references. */
+    std::atomic<std::uint32_t> refs_;
+    
+    /** The state word, that holds STATE_READY_BIT and STATE_WAITING_BIT. */
+    std::atomic<std::uint32_t> stte_;
+};
+
+
+/**
+ * @brief       Shared state of a promise and its future.
+ */
+template<typename TpValue>
+class __shared_state : public __shared_state_base
+{
+public:
+    using __shared_state_base::__shared_state_base;
+    
+    /**
+     * @brief       Set the value, which makes the shared state ready.
+     * @param       args : The arguments to construct the value with.
+     */
+    template<typename... TpArgs>
+    void set_value(TpArgs&&... args)
+    {
+        val_.emplace(std::forward<TpArgs>(args)...);
+        make_ready();
+    }
+    
+    /**
+     * @brief       Take the value, or throw the exception. The shared state has to be ready.
+     * @return      The value.
+     */
+    __value_t<TpValue> take_value()
+    {
+        if (excptn_)
+        {
+            std::rethrow_exception(excptn_);
+        }
+        
+        return std::move(*val_);
+    }
+
+private:
+    /** The value. */
+    std::optional<__value_t<TpValue>> val_;
+};
+
+
+/**
+ * @brief       Give access to the internals of the futures.
+ */
+struct __future_access
+{
+    /**
+     * @brief       Get the shared state of a future.
+     * @param       fut : The future.
+     * @return      The shared state of the future, or nullptr if it holds its value itself.
+     */
+    template<typename TpValue>
+    static __shared_state<TpValue>* get_state(const future<TpValue>& fut) noexcept
+    {
+        return fut.stte_;
+    }
+    
+    /**
+     * @brief       Create a future from a shared state.
+     * @param       stte : The shared state, whose reference is taken by the future.
+     * @return      The future.
+     */
+    template<typename TpValue>
+    static future<TpValue> make_future(__shared_state<TpValue>* stte) noexcept
+    {
+        return future<TpValue>(stte);
+    }
+    
+    /**
+     * @brief       Create a future that holds its value itself.
+     * @param       args : The arguments to construct the value with.
+     * @return      The future.
+     */
+    template<typename TpValue, typename... TpArgs>
+    static future<TpValue> make_ready_future(TpArgs&&... args)
+    {
+        return future<TpValue>(std::in_place, std::forward<TpArgs>(args)...);
+    }
+};
+
+
+/**
+ * @brief       Get the executor used by the continuations attached without executor.
+ * @return      The executor used by the continuations attached without executor.
+ */
+inline inline_executor& __get_inline_executor() noexcept
+{
+    static inline_executor exec;
+    
+    return exec;
+}
+
+
+/**
+ * @brief       Shared state of the future returned by then. It is the continuation of the source
+ *              future too, so attaching a continuation costs a single allocation.
+ */
+template<typename TpValue, typename TpResult, typename TpFunction, typename TpExecutor>
+class __then_state : public __shared_state<TpResult>, public __continuation
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       src : The source future.
+     * @param       fnc : The function to call with the source future once it is ready.
+     * @param       exec : The executor on which the function is called.
+     */
+    template<typename TpFunction_>
+    __then_state(future<TpValue>&& src, TpFunction_&& fnc, TpExecutor& exec)
+            : __shared_state<TpResult>(2)
+            , __continuation{&__then_state::notify}
+            , src_(std::move(src))
+            , fnc_(std::forward<TpFunction_>(fnc))
+            , exec_(exec)
+    {
+    }
+    
+    /**
+     * @brief       Attach the state to the source future, or schedule the function if the source
+     *              future is ready. If the source future already has a continuation, the state
+     *              gets a continuation_already_attached_exception.
+     */
+    void start() noexcept
+    {
+        __shared_state<TpValue>* src_stte = __future_access::get_state(src_);
+        
+        if (src_stte == nullptr)
+        {
+            schedule();
+            return;
+        }
+        
+        switch (src_stte->try_attach(this))
+        {
+            case __attach_status::ATTACHED:
+                break;
+            case __attach_status::READY:
+                schedule();
+                break;
+            case __attach_status::TAKEN:
+                this->set_exception(std::make_exception_ptr(
+                        continuation_already_attached_exception()));
+                this->release();
+                break;
+        }
+    }
+
+private:
+    /**
+     * @brief       Called when the source future becomes ready.
+     * @param       cont : The continuation, that is the state.
+     */
+    static void notify(__continuation* cont) noexcept
+    {
+        static_cast<__then_state*>(cont)->schedule();
+    }
+    
+    /**
+     * @brief       Submit the function to the executor.
+     */
+    void schedule() noexcept
+    {
+        try
+        {
+            exec_.submit([this]() { execute(); });
+        }
+        catch (...)
+        {
+            this->set_exception(std::current_exception());
+            this->release();
+        }
+    }
+    
+    /**
+     * @brief       Call the function and set its result.
+     */
+    void execute() noexcept
+    {
+        try
+        {
+            if constexpr (std::is_void<TpResult>::value)
+            {
+                fnc_(std::move(src_));
+                this->set_value();
+            }
+            else
+            {
+                this->set_value(fnc_(std::move(src_)));
+            }
+        }
+        catch (...)
+        {
+            this->set_exception(std::current_exception());
+        }
+        
+        this->release();
+    }
+    
+    /** The source future. */
+    future<TpValue> src_;
+    
+    /** The function to call with the source future once it is ready. */
+    TpFunction fnc_;
+    
+    /** The executor on which the function is called. */
+    TpExecutor& exec_;
+};
+
+
+/**
+ * @brief       Call a function for every future of a vector.
+ * @param       futs : The futures.
+ * @param       fnc : The function to call.
+ */
+template<typename TpValue, typename TpFunction>
+void __for_each_future(std::vector<future<TpValue>>& futs, const TpFunction& fnc)
+{
+    for (auto& x : futs)
+    {
+        fnc(x);
+    }
+}
+
+
+/**
+ * @brief       Call a function for every future of a tuple.
+ * @param       futs : The futures.
+ * @param       fnc : The function to call.
+ */
+template<typename... TpValues, typename TpFunction>
+void __for_each_future(std::tuple<future<TpValues>...>& futs, const TpFunction& fnc)
+{
+    std::apply([&fnc](auto&... x) { (fnc(x), ...); }, futs);
+}
+
+
+/**
+ * @brief       Shared state of the future returned by when_all. It is the continuation of all the
+ *              source futures, and counts them down.
+ */
+template<typename TpFutures>
+class __when_all_state : public __shared_state<TpFutures>, public __continuation
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       futs : The source futures.
+     */
+    explicit __when_all_state(TpFutures&& futs)
+            : __shared_state<TpFutures>(2)
+            , __continuation{&__when_all_state::notify}
+            , futs_(std::move(futs))
+            , rmng_(1)
+            , tkn_(false)
+    {
+    }
+    
+    /**
+     * @brief       Attach the state to the source futures that are not ready. If a source future
+     *              already has a continuation, the state gets a
+     *              continuation_already_attached_exception once the others are ready.
+     */
+    void start() noexcept
+    {
+        __for_each_future(futs_, [this](auto& fut)
+        {
+            auto* src_stte = __future_access::get_state(fut);
+            
+            if (src_stte != nullptr)
+            {
+                rmng_.fetch_add(1, std::memory_order_relaxed);
+                switch (src_stte->try_attach(this))
+                {
+                    case __attach_status::ATTACHED:
+                        break;
+                    case __attach_status::READY:
+                        arrive();
+                        break;
+                    case __attach_status::TAKEN:
+                        tkn_ = true;
+                        arrive();
+                        break;
+                }
+            }
+        });
+        
+        arrive();
+    }
+
+private:
+    /**
+     * @brief       Called when a source future becomes ready.
+     * @param       cont : The continuation, that is the state.
+     */
+    static void notify(__continuation* cont) noexcept
+    {
+        static_cast<__when_all_state*>(cont)->arrive();
+    }
+    
+    /**
+     * @brief       Count down a source future, and set the value once all are ready.
+     */
+    void arrive() noexcept
+    {
+        if (rmng_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            if (tkn_)
+            {
+                this->set_exception(std::make_exception_ptr(
+                        continuation_already_attached_exception()));
+            }
+            else
+            {
+                this->set_value(std::move(futs_));
+            }
+            
+            this->release();
+        }
+    }
+    
+    /** The source futures. */
+    TpFutures futs_;
+    
+    /** The number of source futures not ready, plus one until they are all attached. */
+    std::atomic<std::size_t> rmng_;
+    
+    /** Whether a source future already had a continuation. It is set before the last count
+     *  down of start, so the thread that sets the result sees it. */
+    bool tkn_;
+};
+
+
+/**
+ * @brief       Shared state of the future returned by when_any. It is the continuation of all the
+ *              source futures, and becomes ready once one of them is ready and all are attached.
+ *              It then detaches from the source futures that are not ready, so that other
+ *              continuations can be attached to them.
+ */
+template<typename TpValue>
+class __when_any_state : public __shared_state<when_any_result<TpValue>>, public __continuation
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       futs : The source futures.
+     */
+    explicit __when_any_state(std::vector<future<TpValue>>&& futs)
+            : __shared_state<when_any_result<TpValue>>(2)
+            , __continuation{&__when_any_state::notify}
+            , futs_(std::move(futs))
+            , tkns_(2)
+            , frd_(false)
+            , tkn_(false)
+    {
+    }
+    
+    /**
+     * @brief       Attach the state to the source futures that are not ready. If a source future
+     *              already has a continuation, the state gets a
+     *              continuation_already_attached_exception.
+     */
+    void start() noexcept
+    {
+        __shared_state<TpValue>* src_stte;
+        
+        if (futs_.empty())
+        {
+            arrive();
+        }
+        
+        for (auto& x : futs_)
+        {
+            src_stte = __future_access::get_state(x);
+            if (src_stte == nullptr)
+            {
+                arrive();
+                continue;
+            }
+            
+            this->add_reference();
+            switch (src_stte->try_attach(this))
+            {
+                case __attach_status::ATTACHED:
+                    break;
+                case __attach_status::READY:
+                    arrive();
+                    this->release();
+                    break;
+                case __attach_status::TAKEN:
+                    tkn_ = true;
+                    arrive();
+                    this->release();
+                    break;
+            }
+        }
+        
+        count_down();
+    }
+
+private:
+    /**
+     * @brief       Called when a source future becomes ready.
+     * @param       cont : The continuation, that is the state.
+     */
+    static void notify(__continuation* cont) noexcept
+    {
+        auto* stte = static_cast<__when_any_state*>(cont);
+        
+        stte->arrive();
+        stte->release();
+    }
+    
+    /**
+     * @brief       Record that a source future is ready.
+     */
+    void arrive() noexcept
+    {
+        if (!frd_.exchange(true, std::memory_order_acq_rel))
+        {
+            count_down();
+        }
+    }
+    
+    /**
+     * @brief       Count down a token, and set the value once a source future is ready and all
+     *              are attached.
+     */
+    void count_down() noexcept
+    {
+        std::size_t idx = when_any_result<TpValue>::npos;
+        
+        if (tkns_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+        
+        for (auto& x : futs_)
+        {
+            __shared_state<TpValue>* src_stte = __future_access::get_state(x);
+            
+            if (src_stte != nullptr && src_stte->try_detach(this))
+            {
+                this->release();
+            }
+        }
+        
+        if (tkn_)
+        {
+            this->set_exception(std::make_exception_ptr(continuation_already_attached_exception()));
+            this->release();
+            return;
+        }
+        
+        for (std::size_t i = 0; i < futs_.size(); ++i)
+        {
+            if (futs_[i].is_ready())
+            {
+                idx = i;
+                break;
+            }
+        }
+        
+        this->set_value(when_any_result<TpValue>{idx, std::move(futs_)});
+        this->release();
+    }
+    
+    /** The source futures. */
+    std::vector<future<TpValue>> futs_;
+    
+    /** The number of tokens left, one for the first ready future and one for the attachment. */
+    std::atomic<std::uint32_t> tkns_;
+    
+    /** Whether a source future is ready. */
+    std::atomic<bool> frd_;
+    
+    /** Whether a source future already had a continuation. It is set before the last count
+     *  down of start, so the thread that sets the result sees it. */
+    bool tkn_;
+};
+
+
+} /* __hidden_concurrency */
+/** @endcond */
+
+
+/**
+ * @brief       Class that represents the result of an asynchronous operation. The result is held
+ *              in a shared state allocated once by the promise or the continuation that produces
+ *              it, or in the future itself when it is ready from the start, so no allocation is
+ *              needed. A continuation can be attached with then, which runs it on a given
+ *              executor once the result is ready, without blocking any thread.
+ */
+template<typename TpValue>
+class future
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /**
+     * @brief       Default constructor. The future is not valid.
+     */
+    future() noexcept
+            : stte_(nullptr)
+            , val_()
+    {
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    future(future&& rhs) noexcept(std::is_nothrow_move_constructible<stored_type>::value)
+            : stte_(std::exchange(rhs.stte_, nullptr))
+            , val_()
+    {
+        if (rhs.val_.has_value())
+        {
+            val_.emplace(std::move(*rhs.val_));
+            rhs.val_.reset();
+        }
+    }
+    
+    /** @cond */
+    future(const future&) = delete;
+    
+    future& operator =(const future&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor.
+     */
+    ~future()
+    {
+        if (stte_ != nullptr)
+        {
+            stte_->release();
+        }
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    future& operator =(future&& rhs) noexcept(std::is_nothrow_move_assignable<stored_type>::value)
+    {
+        if (this != &rhs)
+        {
+            if (stte_ != nullptr)
+            {
+                stte_->release();
+            }
+            
+            stte_ = std::exchange(rhs.stte_, nullptr);
+            val_ = std::move(rhs.val_);
+            rhs.val_.reset();
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Check whether the future refers to a result.
+     * @return      If the future refers to a result true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool valid() const noexcept
+    {
+        return stte_ != nullptr || val_.has_value();
+    }
+    
+    /**
+     * @brief       Check whether the result is available. The future has to be valid.
+     * @return      If the result is available true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool is_ready() const noexcept
+    {
+        return val_.has_value() || stte_->is_ready();
+    }
+    
+    /**
+     * @brief       Wait until the result is available. The future has to be valid.
+     */
+    void wait() const noexcept
+    {
+        if (stte_ != nullptr)
+        {
+            stte_->wait();
+        }
+    }
+    
+    /**
+     * @brief       Wait until the result is available and get it. The future is no longer valid
+     *              afterwards. The future has to be valid.
+     * @return      The value.
+     * @throw       The exception set by the producer, if any.
+     */
+    value_type get()
+    {
+        if constexpr (std::is_void<value_type>::value)
+        {
+            take();
+        }
+        else
+        {
+            return take();
+        }
+    }
+    
+    /**
+     * @brief       Attach a continuation, that is called on an executor with the ready future
+     *              once the result is available. The future is no longer valid afterwards. It
+     *              costs a single allocation, that holds both the continuation and the result.
+     * @param       exec : The executor, that needs a submit method that receives a function
+     *              without arguments. It has to outlive the call of the continuation.
+     * @param       fnc : The function to call, that receives the ready future.
+     * @return      The future of the value returned by the function.
+     */
+    template<typename TpExecutor, typename TpFunction>
+    auto then(TpExecutor& exec, TpFunction&& fnc)
+    {
+        using result_type = std::invoke_result_t<std::decay_t<TpFunction>&, future>;
+        using state_type = __hidden_concurrency::__then_state<
+                value_type, result_type, std::decay_t<TpFunction>, TpExecutor>;
+        
+        auto* stte = new state_type(std::move(*this), std::forward<TpFunction>(fnc), exec);
+        future<result_type> res = __hidden_concurrency::__future_access::make_future<result_type>(
+                stte);
+        
+        stte->start();
+        
+        return res;
+    }
+    
+    /**
+     * @brief       Attach a continuation, that is called with the ready future once the result is
+     *              available, on the thread that sets the result. If the result is already
+     *              available the function is called right away and no allocation is done. The
+     *              future is no longer valid afterwards.
+     * @param       fnc : The function to call, that receives the ready future.
+     * @return      The future of the value returned by the function.
+     */
+    template<typename TpFunction>
+    auto then(TpFunction&& fnc)
+    {
+        using result_type = std::invoke_result_t<std::decay_t<TpFunction>&, future>;
+        using access_type = __hidden_concurrency::__future_access;
+        
+        if (stte_ == nullptr)
+        {
+            try
+            {
+                if constexpr (std::is_void<result_type>::value)
+                {
+                    fnc(std::move(*this));
+                    return access_type::make_ready_future<result_type>();
+                }
+                else
+                {
+                    return access_type::make_ready_future<result_type>(fnc(std::move(*this)));
+                }
+            }
+            catch (...)
+            {
+                auto* stte = new __hidden_concurrency::__shared_state<result_type>(1);
+                
+                stte->set_exception(std::current_exception());
+                
+                return access_type::make_future<result_type>(stte);
+            }
+        }
+        
+        return then(__hidden_concurrency::__get_inline_executor(), std::forward<TpFunction>(fnc));
+    }
+
+private:
+    /** The type of value stored. */
+    using stored_type = __hidden_concurrency::__value_t<value_type>;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       stte : The shared state, whose reference is taken by the future.
+     */
+    explicit future(__hidden_concurrency::__shared_state<value_type>* stte) noexcept
+            : stte_(stte)
+            , val_()
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       args : The arguments to construct the value with.
+     */
+    template<typename... TpArgs>
+    explicit future(std::in_place_t, TpArgs&&... args)
+            : stte_(nullptr)
+            , val_(std::in_place, std::forward<TpArgs>(args)...)
+    {
+    }
+    
+    /**
+     * @brief       Wait until the result is available and take it.
+     * @return      The value.
+     */
+    stored_type take()
+    {
+        __hidden_concurrency::__shared_state<value_type>* stte = std::exchange(stte_, nullptr);
+        
+        if (stte == nullptr)
+        {
+            stored_type val = std::move(*val_);
+            
+            val_.reset();
+            
+            return val;
+        }
+        
+        stte->wait();
+        
+        try
+        {
+            stored_type val = stte->take_value();
+            
+            stte->release();
+            
+            return val;
+        }
+        catch (...)
+        {
+            stte->release();
+            throw;
+        }
+    }
+    
+    /** The shared state, or nullptr if the future holds its value itself. */
+    __hidden_concurrency::__shared_state<value_type>* stte_;
+    
+    /** The value, when the future is ready from the start. */
+    std::optional<stored_type> val_;
+    
+    friend struct __hidden_concurrency::__future_access;
+};
+
+
+/**
+ * @brief       Class that sets the result of an asynchronous operation, that is retrieved through
+ *              its future. If it is destroyed without being satisfied, the future gets a
+ *              broken_promise_exception.
+ */
+template<typename TpValue>
+class promise
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /**
+     * @brief       Default constructor.
+     */
+    promise()
+            : stte_(new __hidden_concurrency::__shared_state<value_type>(1))
+            , ftr_rtrvd_(false)
+            , stsfd_(false)
+    {
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    promise(promise&& rhs) noexcept
+            : stte_(std::exchange(rhs.stte_, nullptr))
+            , ftr_rtrvd_(rhs.ftr_rtrvd_)
+            , stsfd_(rhs.stsfd_)
+    {
+    }
+    
+    /** @cond */
+    promise(const promise&) = delete;
+    
+    promise& operator =(const promise&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor.
+     */
+    ~promise()
+    {
+        abandon();
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    promise& operator =(promise&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            abandon();
+            stte_ = std::exchange(rhs.stte_, nullptr);
+            ftr_rtrvd_ = rhs.ftr_rtrvd_;
+            stsfd_ = rhs.stsfd_;
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Get the future of the promise.
+     * @return      The future of the promise.
+     * @throw       speed::concurrency::future_already_retrieved_exception : If the future has
+     *              already been retrieved.
+     */
+    future<value_type> get_future()
+    {
+        if (ftr_rtrvd_)
+        {
+            throw future_already_retrieved_exception();
+        }
+        
+        ftr_rtrvd_ = true;
+        stte_->add_reference();
+        
+        return __hidden_concurrency::__future_access::make_future<value_type>(stte_);
+    }
+    
+    /**
+     * @brief       Set the value, which makes the future ready and runs its continuation.
+     * @param       args : The arguments to construct the value with, none for a promise of void.
+     * @throw       speed::concurrency::promise_already_satisfied_exception : If the value or the
+     *              exception has already been set.
+     */
+    template<typename... TpArgs>
+    void set_value(TpArgs&&... args)
+    {
+        if (stsfd_)
+        {
+            throw promise_already_satisfied_exception();
+        }
+        
+        stte_->set_value(std::forward<TpArgs>(args)...);
+        stsfd_ = true;
+    }
+    
+    /**
+     * @brief       Set the exception, which makes the future ready and runs its continuation.
+     * @param       excptn : The exception.
+     * @throw       speed::concurrency::promise_already_satisfied_exception : If the value or the
+     *              exception has already been set.
+     */
+    void set_exception(std::exception_ptr excptn)
+    {
+        if (stsfd_)
+        {
+            throw promise_already_satisfied_exception();
+        }
+        
+        stsfd_ = true;
+        stte_->set_exception(std::move(excptn));
+    }
+
+private:
+    /**
+     * @brief       Break the promise if it is not satisfied, and release its shared state.
+     */
+    void abandon() noexcept
+    {
+        if (stte_ != nullptr)
+        {
+            if (!stsfd_)
+            {
+                stte_->set_exception(std::make_exception_ptr(broken_promise_exception()));
+            }
+            
+            stte_->release();
+        }
+    }
+    
+    /** The shared state. */
+    __hidden_concurrency::__shared_state<value_type>* stte_;
+    
+    /** Whether the future has been retrieved. */
+    bool ftr_rtrvd_;
+    
+    /** Whether the value or the exception has been set. */
+    bool stsfd_;
+};
+
+
+/**
+ * @brief       Create a future that holds a value. No allocation is done.
+ * @param       val : The value.
+ * @return      The future.
+ */
+template<typename TpValue>
+future<std::decay_t<TpValue>> make_ready_future(TpValue&& val)
+{
+    return __hidden_concurrency::__future_access::make_ready_future<std::decay_t<TpValue>>(
+            std::forward<TpValue>(val));
+}
+
+
+/**
+ * @brief       Create a ready future of void. No allocation is done.
+ * @return      The future.
+ */
+inline future<void> make_ready_future()
+{
+    return __hidden_concurrency::__future_access::make_ready_future<void>();
+}
+
+
+/**
+ * @brief       Create a future that holds an exception.
+ * @param       excptn : The exception.
+ * @return      The future.
+ */
+template<typename TpValue>
+future<TpValue> make_exceptional_future(std::exception_ptr excptn)
+{
+    auto* stte = new __hidden_concurrency::__shared_state<TpValue>(1);
+    
+    stte->set_exception(std::move(excptn));
+    
+    return __hidden_concurrency::__future_access::make_future<TpValue>(stte);
+}
+
+
+/**
+ * @brief       Get a future that becomes ready once all the futures of a vector are ready.
+ * @param       futs : The futures, that have to be valid.
+ * @return      The future of the futures, which are all ready.
+ */
+template<typename TpValue>
+future<std::vector<future<TpValue>>> when_all(std::vector<future<TpValue>> futs)
+{
+    using futures_type = std::vector<future<TpValue>>;
+    
+    auto* stte = new __hidden_concurrency::__when_all_state<futures_type>(std::move(futs));
+    future<futures_type> res = __hidden_concurrency::__future_access::make_future<futures_type>(
+            stte);
+    
+    stte->start();
+    
+    return res;
+}
+
+
+/**
+ * @brief       Get a future that becomes ready once all the given futures are ready.
+ * @param       futs : The futures, that have to be valid.
+ * @return      The future of the tuple of the futures, which are all ready.
+ */
+template<typename... TpValues>
+future<std::tuple<future<TpValues>...>> when_all(future<TpValues>&&... futs)
+{
+    using futures_type = std::tuple<future<TpValues>...>;
+    
+    auto* stte = new __hidden_concurrency::__when_all_state<futures_type>(
+            futures_type(std::move(futs)...));
+    future<futures_type> res = __hidden_concurrency::__future_access::make_future<futures_type>(
+            stte);
+    
+    stte->start();
+    
+    return res;
+}
+
+
+/**
+ * @brief       Get a future that becomes ready once one of the futures of a vector is ready.
+ * @param       futs : The futures, that have to be valid.
+ * @return      The future of the index of the first future that was ready and of the futures.
+ */
+template<typename TpValue>
+future<when_any_result<TpValue>> when_any(std::vector<future<TpValue>> futs)
+{
+    using result_type = when_any_result<TpValue>;
+    
+    auto* stte = new __hidden_concurrency::__when_any_state<TpValue>(std::move(futs));
+    future<result_type> res = __hidden_concurrency::__future_access::make_future<result_type>(
+            stte);
+    
+    stte->start();
+    
+    return res;
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,1117 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/pipeline.hpp
+ * @brief       pipeline class header.
+ * @author      Killian
+ * @date        2018/10/06 - 10:12
+ */
+
+#ifndef SPEED_CONCURRENCY_PIPELINE_HPP
+#define SPEED_CONCURRENCY_PIPELINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stage_modes.hpp"
+#include "thread_pool.hpp"
+
+
+namespace speed {
+namespace concurrency {
+
+
+template<typename TpInput, typename TpOutput>
+class stage_chain;
+
+
+/**
+ * @brief       Class given to the first stage of a pipeline, through which it tells that there is
+ *              no item left to produce.
+ */
+class flow_control
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    flow_control() noexcept
+            : stop_(false)
+    {
+    }
+    
+    /**
+     * @brief       Tell that there is no item left. The value returned by the stage function that
+     *              calls it is ignored, and the first stage is not called anymore.
+     */
+    void stop() noexcept
+    {
+        stop_ = true;
+    }
+    
+    /**
+     * @brief       Check whether stop has been called.
+     * @return      If stop has been called true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool is_stopped() const noexcept
+    {
+        return stop_;
+    }
+
+private:
+    /** Whether stop has been called. */
+    bool stop_;
+};
+
+
+/**
+ * @brief       Statistics of a stage of a pipeline, over its last run.
+ */
+struct pipeline_stage_statistics
+{
+    /** The mode of the stage. */
+    stage_modes mde;
+    
+    /** The number of items processed by the stage. */
+    std::uint64_t nbr_itms;
+    
+    /** The time spent in the stage function, summed over the threads, if the stages are timed. */
+    std::chrono::nanoseconds bsy_tme;
+    
+    /** The number of items processed per second. */
+    double thrpt;
+    
+    /** The average number of tokens waiting to enter the stage. */
+    double avg_q_sz;
+    
+    /** The maximum number of tokens waiting to enter the stage. */
+    std::size_t max_q_sz;
+};
+
+
+/** @cond */
+namespace __hidden_concurrency {
+
+
+/** The number of tokens per worker thread in flight in a pipeline when no limit is given. */
+constexpr std::size_t PIPELINE_TOKENS_PER_THREAD = 4;
+
+
+/**
+ * @brief       Stage of a pipeline whose item types are erased.
+ */
+class __stage_base
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       mde : The mode of the stage.
+     * @param       out_sz : The size of the output type.
+     * @param       out_algn : The alignment of the output type.
+     */
+    __stage_base(stage_modes mde, std::size_t out_sz, std::size_t out_algn) noexcept
+            : mde_(mde)
+            , out_sz_(out_sz)
+            , out_algn_(out_algn)
+    {
+    }
+    
+    /**
+     * @brief       Destructor.
+     */
+    virtual ~__stage_base() = default;
+    
+    /**
+     * @brief       Process an item. The input is destroyed, even if an exception is thrown.
+     * @param       in : The input, that is null for the first stage.
+     * @param       out : The storage in which the output is constructed, if it is not void.
+     * @param       fc : The flow control, used by the first stage only.
+     * @return      If an item has been processed true is returned, otherwise the first stage has
+     *              stopped and false is returned.
+     */
+    virtual bool process(void* in, void* out, flow_control& fc) = 0;
+    
+    /**
+     * @brief       Destroy an output of the stage.
+     * @param       out : The output.
+     */
+    virtual void destroy_output(void* out) noexcept = 0;
+    
+    /**
+     * @brief       Get the mode of the stage.
+     * @return      The mode of the stage.
+     */
+    [[nodiscard]] stage_modes get_mode() const noexcept
+    {
+        return mde_;
+    }
+    
+    /**
+     * @brief       Get the size of the output type.
+     * @return      The size of the output type, or 0 if it is void.
+     */
+    [[nodiscard]] std::size_t get_output_size() const noexcept
+    {
+        return out_sz_;
+    }
+    
+    /**
+     * @brief       Get the alignment of the output type.
+     * @return      The alignment of the output type, or 1 if it is void.
+     */
+    [[nodiscard]] std::size_t get_output_alignment() const noexcept
+    {
+        return out_algn_;
+    }
+
+private:
+    /** The mode of the stage. */
+    stage_modes mde_;
+    
+    /** The size of the output type. */
+    std::size_t out_sz_;
+    
+    /** The alignment of the output type. */
+    std::size_t out_algn_;
+};
+
+
+/**
+ * @brief       Stage of a pipeline that calls a function.
+ */
+template<typename TpInput, typename TpOutput, typename TpFunction>
+class __stage : public __stage_base
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       mde : The mode of the stage.
+     * @param       fnc : The stage function.
+     */
+    template<typename TpFunction_>
+    __stage(stage_modes mde, TpFunction_&& fnc)
+            : __stage_base(mde, get_size(), get_alignment())
+            , fnc_(std::forward<TpFunction_>(fnc))
+    {
+    }
+    
+    /**
+     * @brief       Process an item. The input is destroyed, even if an exception is thrown.
+     * @param       in : The input, that is null for the first stage.
+     * @param       out : The storage in which the output is constructed, if it is not void.
+     * @param       fc : The flow control, used by the first stage only.
+     * @return      If an item has been processed true is returned, otherwise the first stage has
+     *              stopped and false is returned.
+     */
+    bool process(void* in, void* out, flow_control& fc) override
+    {
+        if constexpr (std::is_void<TpInput>::value)
+        {
+            (void)in;
+            if constexpr (std::is_void<TpOutput>::value)
+            {
+                (void)out;
+                fnc_(fc);
+            }
+            else
+            {
+                new (out) TpOutput(fnc_(fc));
+                if (fc.is_stopped())
+                {
+                    destroy_output(out);
+                }
+            }
+            
+            return !fc.is_stopped();
+        }
+        else
+        {
+            auto* in_ptr = std::launder(static_cast<TpInput*>(in));
+            
+            (void)fc;
+            try
+            {
+                if constexpr (std::is_void<TpOutput>::value)
+                {
+                    (void)out;
+                    fnc_(std::move(*in_ptr));
+                }
+                else
+                {
+                    new (out) TpOutput(fnc_(std::move(*in_ptr)));
+                }
+            }
+            catch (...)
+            {
+                in_ptr->~TpInput();
+                throw;
+            }
+            
+            in_ptr->~TpInput();
+            
+            return true;
+        }
+    }
+    
+    /**
+     * @brief       Destroy an output of the stage.
+     * @param       out : The output.
+     */
+    void destroy_output(void* out) noexcept override
+    {
+        if constexpr (!std::is_void<TpOutput>::value)
+        {
+            std::launder(static_cast<TpOutput*>(out))->~TpOutput();
+        }
+        else
+        {
+            (void)out;
+        }
+    }
+
+private:
+    /**
+     * @brief       Get the size of the output type.
+     * @return      The size of the output type, or 0 if it is void.
+     */
+    static constexpr std::size_t get_size() noexcept
+    {
+        if constexpr (std::is_void<TpOutput>::value)
+        {
+            return 0;
+        }
+        else
+        {
+            return sizeof(TpOutput);
+        }
+    }
+    
+    /**
+     * @brief       Get the alignment of the output type.
+     * @return      The alignment of the output type, or 1 if it is void.
+     */
+    static constexpr std::size_t get_alignment() noexcept
+    {
+        if constexpr (std::is_void<TpOutput>::value)
+        {
+            return 1;
+        }
+        else
+        {
+            return alignof(TpOutput);
+        }
+    }
+    
+    /** The stage function. */
+    TpFunction fnc_;
+};
+
+
+/**
+ * @brief       Token that carries an item through a pipeline. The item is stored in one of two
+ *              buffers of the token, a stage reading it from one and constructing its output in
+ *              the other, so moving an item from stage to stage does not allocate.
+ */
+struct __pipeline_token
+{
+    /** The buffers that hold the item. */
+    unsigned char* bufs[2];
+    
+    /** The sequence number of the item, given by the first stage. */
+    std::uint64_t seq;
+    
+    /** The next token in the queue of a stage. */
+    __pipeline_token* nxt;
+    
+    /** The index of the buffer that holds the item. */
+    unsigned char cur;
+    
+    /** Whether the token holds an item. The tokens without item still go through the stages. */
+    bool vld;
+};
+
+
+/**
+ * @brief       State of a serial stage of a pipeline.
+ */
+struct alignas(64) __pipeline_stage_state
+{
+    /** Mutex that protects the state. */
+    std::mutex mtx;
+    
+    /** The tokens waiting to enter an in order stage, in a heap whose root has the lowest
+     *  sequence number. */
+    std::vector<__pipeline_token*> hp;
+    
+    /** The first token waiting to enter an out of order stage. */
+    __pipeline_token* hd = nullptr;
+    
+    /** The last token waiting to enter an out of order stage. */
+    __pipeline_token* tl = nullptr;
+    
+    /** The sequence number of the next item to enter an in order stage. */
+    std::uint64_t nxt_seq = 0;
+    
+    /** The number of tokens waiting to enter the stage. */
+    std::size_t q_sz = 0;
+    
+    /** The maximum number of tokens waiting to enter the stage. */
+    std::size_t max_q_sz = 0;
+    
+    /** The sum over time of the number of tokens waiting, in tokens times nanoseconds. */
+    std::uint64_t q_area = 0;
+    
+    /** The last time the number of tokens waiting changed. */
+    std::chrono::steady_clock::time_point lst_chng;
+    
+    /** Whether a token is in the stage. */
+    bool bsy = false;
+};
+
+
+/**
+ * @brief       Counters of a stage of a pipeline kept by a worker thread.
+ */
+struct alignas(64) __pipeline_stage_counters
+{
+    /** The number of items processed. */
+    std::uint64_t nbr_itms = 0;
+    
+    /** The time spent in the stage function, in nanoseconds. */
+    std::uint64_t bsy_tme = 0;
+};
+
+
+} /* __hidden_concurrency */
+/** @endcond */
+
+
+/**
+ * @brief       Class that represents a chain of pipeline stages, that takes items of an input type
+ *              and produces items of an output type. The chains are made with make_stage and
+ *              joined with the operator |. A chain whose input and output types are void makes a
+ *              pipeline.
+ */
+template<typename TpInput, typename TpOutput>
+class stage_chain
+{
+public:
+    /** The input type. */
+    using input_type = TpInput;
+    
+    /** The output type. */
+    using output_type = TpOutput;
+    
+    /**
+     * @brief       Get the number of stages.
+     * @return      The number of stages.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return stges_.size();
+    }
+
+private:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       stges : The stages.
+     */
+    explicit stage_chain(std::vector<std::unique_ptr<__hidden_concurrency::__stage_base>> stges)
+            : stges_(std::move(stges))
+    {
+    }
+    
+    /** The stages. */
+    std::vector<std::unique_ptr<__hidden_concurrency::__stage_base>> stges_;
+    
+    template<typename TpInput_, typename TpOutput_>
+    friend class stage_chain;
+    
+    template<typename TpInput_, typename TpOutput_, typename TpFunction>
+    friend stage_chain<TpInput_, TpOutput_> make_stage(stage_modes mde, TpFunction&& fnc);
+    
+    template<typename TpInput_, typename TpMiddle, typename TpOutput_>
+    friend stage_chain<TpInput_, TpOutput_> operator |(
+            stage_chain<TpInput_, TpMiddle>&& lhs,
+            stage_chain<TpMiddle, TpOutput_>&& rhs
+    );
+    
+    friend class pipeline;
+};
+
+
+/**
+ * @brief       Make a pipeline stage.
+ * @param       mde : The mode of the stage. A parallel stage function is called concurrently from
+ *              several threads.
+ * @param       fnc : The stage function. It takes a flow_control& if the input type is void, and
+ *              an input otherwise, and it returns an output.
+ * @return      A chain made of the stage.
+ */
+template<typename TpInput, typename TpOutput, typename TpFunction>
+stage_chain<TpInput, TpOutput> make_stage(stage_modes mde, TpFunction&& fnc)
+{
+    std::vector<std::unique_ptr<__hidden_concurrency::__stage_base>> stges;
+    
+    stges.push_back(std::make_unique<__hidden_concurrency::__stage<
+            TpInput, TpOutput, std::decay_t<TpFunction>>>(mde, std::forward<TpFunction>(fnc)));
+    
+    return stage_chain<TpInput, TpOutput>(std::move(stges));
+}
+
+
+/**
+ * @brief       Join two chains of pipeline stages.
+ * @param       lhs : The first chain, whose output goes to the second chain.
+ * @param       rhs : The second chain.
+ * @return      The chain made of the stages of the first chain followed by the ones of the second.
+ */
+template<typename TpInput, typename TpMiddle, typename TpOutput>
+stage_chain<TpInput, TpOutput> operator |(
+        stage_chain<TpInput, TpMiddle>&& lhs,
+        stage_chain<TpMiddle, TpOutput>&& rhs
+)
+{
+    static_assert(!std::is_void<TpMiddle>::value, "Only the first stage can have no input.");
+    
+    for (auto& x : rhs.stges_)
+    {
+        lhs.stges_.push_back(std::move(x));
+    }
+    
+    return stage_chain<TpInput, TpOutput>(std::move(lhs.stges_));
+}
+
+
+/**
+ * @brief       Class that represents a pipeline of stages run on a thread pool. The first stage
+ *              produces the items, and every stage transforms the output of the previous one. A
+ *              serial stage processes one item at a time, either in the order in which the first
+ *              stage produced them or in any order, while a parallel stage processes any number of
+ *              items at the same time. The items travel in a fixed number of tokens, so the
+ *              number of items in flight, and the memory they use, is bounded: the first stage is
+ *              only called when a token is free. A worker carries a token through the stages as
+ *              far as it can, so an item is processed by the next stage while it is still in the
+ *              cache of the core that produced it. When a token cannot enter a serial stage it
+ *              waits in the stage queue without holding a thread, and the token that leaves the
+ *              stage hands the stage over to it as a task spawned on the deque of its worker.
+ *              The items processed by every stage, and optionally the time spent in it, are
+ *              counted per worker, and the queue of every serial stage tracks its occupancy over
+ *              time.
+ */
+class pipeline
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       pool : The pool on which the stages are run.
+     * @param       stges : The stages.
+     * @param       max_tkns : The maximum number of items in flight. If it is 0, four items per
+     *              worker thread are in flight.
+     * @param       tme_stges : Whether the time spent in every stage function is measured. It
+     *              costs two clock reads per item and per stage.
+     */
+    pipeline(
+            thread_pool& pool,
+            stage_chain<void, void> stges,
+            std::size_t max_tkns = 0,
+            bool tme_stges = false
+    )
+            : pool_(pool)
+            , stges_(std::move(stges.stges_))
+            , sttes_()
+            , cntrs_()
+            , tkns_()
+            , bufs_()
+            , excptn_mtx_()
+            , excptn_()
+            , elpsd_tme_(0)
+            , grp_(nullptr)
+            , nxt_seq_(0)
+            , nbr_slts_(pool.get_concurrency() + 1)
+            , tme_stges_(tme_stges)
+            , stop_(false)
+            , cncl_(false)
+    {
+        const std::size_t nbr_tkns = max_tkns != 0 ? max_tkns :
+                __hidden_concurrency::PIPELINE_TOKENS_PER_THREAD * pool.get_concurrency();
+        std::size_t buf_sz = 0;
+        std::size_t buf_algn = 64;
+        std::size_t tkn_sz;
+        unsigned char* bse;
+        
+        for (auto& x : stges_)
+        {
+            buf_sz = std::max(buf_sz, x->get_output_size());
+            buf_algn = std::max(buf_algn, x->get_output_alignment());
+        }
+        
+        buf_sz = (buf_sz + buf_algn - 1) / buf_algn * buf_algn;
+        tkn_sz = std::max<std::size_t>(2 * buf_sz, buf_algn);
+        
+        bufs_.resize(nbr_tkns * tkn_sz + buf_algn);
+        bse = bufs_.data() + (buf_algn - reinterpret_cast<std::uintptr_t>(bufs_.data()) % buf_algn);
+        
+        tkns_.resize(nbr_tkns);
+        for (std::size_t i = 0; i < nbr_tkns; ++i)
+        {
+            tkns_[i].bufs[0] = bse + i * tkn_sz;
+            tkns_[i].bufs[1] = bse + i * tkn_sz + buf_sz;
+        }
+        
+        sttes_ = std::make_unique<__hidden_concurrency::__pipeline_stage_state[]>(stges_.size());
+        for (std::size_t i = 0; i < stges_.size(); ++i)
+        {
+            if (i > 0 && stges_[i]->get_mode() == stage_modes::SERIAL_IN_ORDER)
+            {
+                sttes_[i].hp.reserve(nbr_tkns);
+            }
+        }
+        
+        cntrs_ = std::make_unique<__hidden_concurrency::__pipeline_stage_counters[]>(
+                stges_.size() * nbr_slts_);
+    }
+    
+    /** @cond */
+    pipeline(const pipeline&) = delete;
+    
+    pipeline& operator =(const pipeline&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Run the pipeline until the first stage stops and all the items have gone
+     *              through the stages. If a stage throws an exception, the first stage is not
+     *              called anymore and the items in flight are dropped. A worker of the pool runs
+     *              the stages meanwhile, any other thread sleeps. The pipeline can be run again
+     *              afterwards, but not from several threads at the same time.
+     * @throw       The first exception thrown by a stage.
+     */
+    void run()
+    {
+        const auto strt = std::chrono::steady_clock::now();
+        task_group grp(pool_);
+        std::exception_ptr excptn;
+        
+        reset(strt);
+        grp_ = &grp;
+        
+        for (auto& x : tkns_)
+        {
+            grp.spawn([this, tkn = &x] { process(tkn, 0, false); });
+        }
+        
+        grp.wait();
+        grp_ = nullptr;
+        elpsd_tme_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - strt);
+        
+        {
+            std::lock_guard<std::mutex> lck(excptn_mtx_);
+            std::swap(excptn, excptn_);
+        }
+        
+        if (excptn)
+        {
+            std::rethrow_exception(excptn);
+        }
+    }
+    
+    /**
+     * @brief       Get the statistics of the stages over the last run.
+     * @return      The statistics of the stages, in the order of the stages.
+     */
+    [[nodiscard]] std::vector<pipeline_stage_statistics> get_statistics() const
+    {
+        std::vector<pipeline_stage_statistics> stats(stges_.size());
+        const double elpsd = static_cast<double>(elpsd_tme_.count());
+        std::uint64_t bsy_tme;
+        
+        for (std::size_t i = 0; i < stges_.size(); ++i)
+        {
+            stats[i].mde = stges_[i]->get_mode();
+            stats[i].nbr_itms = 0;
+            bsy_tme = 0;
+            for (std::size_t j = 0; j < nbr_slts_; ++j)
+            {
+                stats[i].nbr_itms += cntrs_[j * stges_.size() + i].nbr_itms;
+                bsy_tme += cntrs_[j * stges_.size() + i].bsy_tme;
+            }
+            
+            stats[i].bsy_tme = std::chrono::nanoseconds(bsy_tme);
+            stats[i].thrpt = elpsd > 0 ? static_cast<double>(stats[i].nbr_itms) * 1e9 / elpsd
+                                       : 0;
+            stats[i].avg_q_sz = elpsd > 0 ? static_cast<double>(sttes_[i].q_area) / elpsd : 0;
+            stats[i].max_q_sz = sttes_[i].max_q_sz;
+        }
+        
+        return stats;
+    }
+    
+    /**
+     * @brief       Get the duration of the last run.
+     * @return      The duration of the last run.
+     */
+    [[nodiscard]] std::chrono::nanoseconds get_elapsed_time() const noexcept
+    {
+        return elpsd_tme_;
+    }
+    
+    /**
+     * @brief       Get the maximum number of items in flight.
+     * @return      The maximum number of items in flight.
+     */
+    [[nodiscard]] std::size_t get_max_tokens() const noexcept
+    {
+        return tkns_.size();
+    }
+    
+    /**
+     * @brief       Get the number of stages.
+     * @return      The number of stages.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return stges_.size();
+    }
+
+private:
+    using token = __hidden_concurrency::__pipeline_token;
+    
+    using stage_state = __hidden_concurrency::__pipeline_stage_state;
+    
+    using stage_counters = __hidden_concurrency::__pipeline_stage_counters;
+    
+    /**
+     * @brief       Reset the state of the stages before a run.
+     * @param       strt : The time at which the run starts.
+     */
+    void reset(std::chrono::steady_clock::time_point strt) noexcept
+    {
+        for (std::size_t i = 0; i < stges_.size(); ++i)
+        {
+            sttes_[i].nxt_seq = 0;
+            sttes_[i].max_q_sz = 0;
+            sttes_[i].q_area = 0;
+            sttes_[i].lst_chng = strt;
+        }
+        
+        for (std::size_t i = 0; i < stges_.size() * nbr_slts_; ++i)
+        {
+            cntrs_[i].nbr_itms = 0;
+            cntrs_[i].bsy_tme = 0;
+        }
+        
+        nxt_seq_.store(0, std::memory_order_relaxed);
+        stop_.store(false, std::memory_order_relaxed);
+        cncl_.store(false, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Carry a token through the stages, and through the pipeline again once it is out,
+     *              until it has to wait to enter a serial stage or the first stage has stopped.
+     * @param       tkn : The token.
+     * @param       stge_idx : The index of the stage the token enters.
+     * @param       ownd : Whether the token has already been let in the stage, if it is serial.
+     */
+    void process(token* tkn, std::size_t stge_idx, bool ownd)
+    {
+        stage_counters* cntrs = &cntrs_[std::min(pool_.get_worker_index(), nbr_slts_ - 1) *
+                                        stges_.size()];
+        stage_modes mde;
+        
+        while (true)
+        {
+            mde = stges_[stge_idx]->get_mode();
+            
+            if (stge_idx == 0)
+            {
+                if (mde != stage_modes::PARALLEL && !ownd && !enter(tkn, 0))
+                {
+                    return;
+                }
+                
+                ownd = produce(tkn, cntrs[0]);
+                if (mde != stage_modes::PARALLEL)
+                {
+                    leave(0);
+                }
+                
+                if (!ownd)
+                {
+                    return;
+                }
+            }
+            else if (mde == stage_modes::PARALLEL ||
+                     (mde == stage_modes::SERIAL_OUT_OF_ORDER && !tkn->vld))
+            {
+                execute(tkn, stge_idx, cntrs[stge_idx]);
+            }
+            else
+            {
+                if (!ownd && !enter(tkn, stge_idx))
+                {
+                    return;
+                }
+                
+                execute(tkn, stge_idx, cntrs[stge_idx]);
+                leave(stge_idx);
+            }
+            
+            ownd = false;
+            if (++stge_idx == stges_.size())
+            {
+                if (stop_.load(std::memory_order_acquire))
+                {
+                    return;
+                }
+                
+                stge_idx = 0;
+            }
+        }
+    }
+    
+    /**
+     * @brief       Call the first stage to fill a token with a new item.
+     * @param       tkn : The token.
+     * @param       cntrs : The counters of the first stage of the calling thread.
+     * @return      If the token has been given a sequence number, so it has to go through the
+     *              other stages, true is returned, otherwise false is returned.
+     */
+    bool produce(token* tkn, stage_counters& cntrs)
+    {
+        flow_control fc;
+        std::chrono::steady_clock::time_point strt;
+        
+        if (stop_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        
+        tkn->seq = nxt_seq_.fetch_add(1, std::memory_order_relaxed);
+        tkn->cur = 0;
+        
+        if (tme_stges_)
+        {
+            strt = std::chrono::steady_clock::now();
+        }
+        
+        try
+        {
+            tkn->vld = stges_[0]->process(nullptr, tkn->bufs[0], fc);
+        }
+        catch (...)
+        {
+            tkn->vld = false;
+            cancel(std::current_exception());
+        }
+        
+        if (tkn->vld)
+        {
+            count(cntrs, strt);
+        }
+        else
+        {
+            stop_.store(true, std::memory_order_release);
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Call a stage that is not the first one on the item of a token. If the
+     *              pipeline is cancelled, the item is destroyed instead.
+     * @param       tkn : The token.
+     * @param       stge_idx : The index of the stage.
+     * @param       cntrs : The counters of the stage of the calling thread.
+     */
+    void execute(token* tkn, std::size_t stge_idx, stage_counters& cntrs)
+    {
+        flow_control fc;
+        std::chrono::steady_clock::time_point strt;
+        
+        if (!tkn->vld)
+        {
+            return;
+        }
+        
+        if (cncl_.load(std::memory_order_relaxed))
+        {
+            stges_[stge_idx - 1]->destroy_output(tkn->bufs[tkn->cur]);
+            tkn->vld = false;
+            
+            return;
+        }
+        
+        if (tme_stges_)
+        {
+            strt = std::chrono::steady_clock::now();
+        }
+        
+        try
+        {
+            stges_[stge_idx]->process(tkn->bufs[tkn->cur], tkn->bufs[tkn->cur ^ 1], fc);
+            tkn->cur ^= 1;
+            count(cntrs, strt);
+        }
+        catch (...)
+        {
+            tkn->vld = false;
+            cancel(std::current_exception());
+        }
+    }
+    
+    /**
+     * @brief       Let a token in a serial stage, or make it wait in the stage queue. The first
+     *              stage does not let tokens in once it has stopped.
+     * @param       tkn : The token.
+     * @param       stge_idx : The index of the stage.
+     * @return      If the token has been let in true is returned, otherwise false is returned.
+     */
+    bool enter(token* tkn, std::size_t stge_idx)
+    {
+        stage_state& stte = sttes_[stge_idx];
+        const bool in_ordr = stge_idx > 0 &&
+                stges_[stge_idx]->get_mode() == stage_modes::SERIAL_IN_ORDER;
+        std::lock_guard<std::mutex> lck(stte.mtx);
+        
+        if (stge_idx == 0 && stop_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        
+        if (!stte.bsy && (!in_ordr || tkn->seq == stte.nxt_seq))
+        {
+            stte.bsy = true;
+            
+            return true;
+        }
+        
+        update_occupancy(stte);
+        if (in_ordr)
+        {
+            stte.hp.push_back(tkn);
+            std::push_heap(stte.hp.begin(), stte.hp.end(), compare_sequences);
+        }
+        else
+        {
+            tkn->nxt = nullptr;
+            if (stte.tl == nullptr)
+            {
+                stte.hd = tkn;
+            }
+            else
+            {
+                stte.tl->nxt = tkn;
+            }
+            
+            stte.tl = tkn;
+        }
+        
+        stte.max_q_sz = std::max(++stte.q_sz, stte.max_q_sz);
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Make the token in a serial stage leave it, and hand the stage over to the next
+     *              waiting token that can enter it, as a task. The tokens waiting to enter the
+     *              first stage are dropped once it has stopped.
+     * @param       stge_idx : The index of the stage.
+     */
+    void leave(std::size_t stge_idx)
+    {
+        stage_state& stte = sttes_[stge_idx];
+        const bool in_ordr = stge_idx > 0 &&
+                stges_[stge_idx]->get_mode() == stage_modes::SERIAL_IN_ORDER;
+        token* nxt = nullptr;
+        
+        {
+            std::lock_guard<std::mutex> lck(stte.mtx);
+            
+            if (in_ordr)
+            {
+                ++stte.nxt_seq;
+                if (!stte.hp.empty() && stte.hp.front()->seq == stte.nxt_seq)
+                {
+                    update_occupancy(stte);
+                    std::pop_heap(stte.hp.begin(), stte.hp.end(), compare_sequences);
+                    nxt = stte.hp.back();
+                    stte.hp.pop_back();
+                    --stte.q_sz;
+                }
+            }
+            else if (stte.hd != nullptr)
+            {
+                update_occupancy(stte);
+                if (stge_idx == 0 && stop_.load(std::memory_order_acquire))
+                {
+                    stte.hd = nullptr;
+                    stte.tl = nullptr;
+                    stte.q_sz = 0;
+                }
+                else
+                {
+                    nxt = stte.hd;
+                    stte.hd = nxt->nxt;
+                    if (stte.hd == nullptr)
+                    {
+                        stte.tl = nullptr;
+                    }
+                    
+                    --stte.q_sz;
+                }
+            }
+            
+            stte.bsy = nxt != nullptr;
+        }
+        
+        if (nxt != nullptr)
+        {
+            grp_->spawn([this, nxt, stge_idx] { process(nxt, stge_idx, true); });
+        }
+    }
+    
+    /**
+     * @brief       Cancel the run because a stage has thrown an exception.
+     * @param       excptn : The exception.
+     */
+    void cancel(std::exception_ptr excptn) noexcept
+    {
+        {
+            std::lock_guard<std::mutex> lck(excptn_mtx_);
+            
+            if (!excptn_)
+            {
+                excptn_ = std::move(excptn);
+            }
+        }
+        
+        cncl_.store(true, std::memory_order_relaxed);
+        stop_.store(true, std::memory_order_release);
+    }
+    
+    /**
+     * @brief       Count an item processed by a stage.
+     * @param       cntrs : The counters of the stage of the calling thread.
+     * @param       strt : The time at which the stage function was called, if the stages are
+     *              timed.
+     */
+    void count(stage_counters& cntrs, std::chrono::steady_clock::time_point strt) const noexcept
+    {
+        ++cntrs.nbr_itms;
+        if (tme_stges_)
+        {
+            cntrs.bsy_tme += static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now() - strt).count());
+        }
+    }
+    
+    /**
+     * @brief       Add to the occupancy of a stage queue the time since its last change. It is
+     *              called with the stage mutex held, before the queue changes.
+     * @param       stte : The state of the stage.
+     */
+    static void update_occupancy(stage_state& stte) noexcept
+    {
+        const auto nw = std::chrono::steady_clock::now();
+        
+        stte.q_area += stte.q_sz * static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(nw - stte.lst_chng).count());
+        stte.lst_chng = nw;
+    }
+    
+    /**
+     * @brief       Compare the sequence numbers of two tokens, so that the heap of the waiting
+     *              tokens has the lowest one at its root.
+     * @param       lhs : The first token.
+     * @param       rhs : The second token.
+     * @return      If the first token has a greater sequence number true is returned, otherwise
+     *              false is returned.
+     */
+    static bool compare_sequences(const token* lhs, const token* rhs) noexcept
+    {
+        return lhs->seq > rhs->seq;
+    }
+    
+    /** The pool on which the stages are run. */
+    thread_pool& pool_;
+    
+    /** The stages. */
+    std::vector<std::unique_ptr<__hidden_concurrency::__stage_base>> stges_;
+    
+    /** The states of the stages. */
+    std::unique_ptr<stage_state[]> sttes_;
+    
+    /** The counters of the stages, for every worker thread and another thread. */
+    std::unique_ptr<stage_counters[]> cntrs_;
+    
+    /** The tokens. */
+    std::vector<token> tkns_;
+    
+    /** The memory that holds the buffers of the tokens. */
+    std::vector<unsigned char> bufs_;
+    
+    /** Mutex that protects the exception. */
+    std::mutex excptn_mtx_;
+    
+    /** The first exception thrown by a stage during the run. */
+    std::exception_ptr excptn_;
+    
+    /** The duration of the last run. */
+    std::chrono::nanoseconds elpsd_tme_;
+    
+    /** The group of the tasks of the current run. */
+    task_group* grp_;
+    
+    /** The sequence number of the next item produced by the first stage. */
+    std::atomic<std::uint64_t> nxt_seq_;
+    
+    /** The number of slots of counters per stage, one per worker thread and another one. */
+    std::size_t nbr_slts_;
+    
+    /** Whether the time spent in every stage function is measured. */
+    bool tme_stges_;
+    
+    /** Whether the first stage has stopped. */
+    std::atomic<bool> stop_;
+    
+    /** Whether the run is cancelled because a stage has thrown an exception. */
+    std::atomic<bool> cncl_;
+};
+
+
+}
+}
+
+
+#endif
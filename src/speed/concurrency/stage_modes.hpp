@@ -0,0 +1,57 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/stage_modes.hpp
+ * @brief       stage_modes header.
+ * @author      Killian
+ * @date        2018/10/06 - 09:35
+ */
+
+#ifndef SPEED_CONCURRENCY_STAGE_MODES_HPP
+#define SPEED_CONCURRENCY_STAGE_MODES_HPP
+
+#include <cstdint>
+
+
+namespace speed {
+namespace concurrency {
+
+
+/**
+ * @brief       Represents the ways the items go through a stage of a pipeline.
+ */
+enum class stage_modes : std::uint8_t
+{
+    /** The stage processes one item at a time, in the order in which the items were produced. */
+    SERIAL_IN_ORDER,
+    
+    /** The stage processes one item at a time, in any order. */
+    SERIAL_OUT_OF_ORDER,
+    
+    /** The stage processes several items at the same time. */
+    PARALLEL
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,739 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/task.hpp
+ * @brief       task class header.
+ * @author      Killian
+ * @date        2018/10/02 - 15:30
+ */
+
+#ifndef SPEED_CONCURRENCY_TASK_HPP
+#define SPEED_CONCURRENCY_TASK_HPP
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "future.hpp"
+
+
+namespace speed {
+namespace concurrency {
+
+
+template<typename TpValue>
+class task;
+
+
+/** @cond */
+namespace __hidden_concurrency {
+
+
+/**
+ * @brief       Type-erased reference to an executor, on which coroutines are resumed. An empty
+ *              reference resumes them on the calling thread.
+ */
+class __executor_reference
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    constexpr __executor_reference() noexcept
+            : exec_(nullptr)
+            , schdl_(nullptr)
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       exec : The executor, that needs a submit method that receives a function
+     *              without arguments.
+     */
+    template<typename TpExecutor>
+    explicit __executor_reference(TpExecutor& exec) noexcept
+            : exec_(&exec)
+            , schdl_([](void* exec, std::coroutine_handle<> hndl)
+                     {
+                         static_cast<TpExecutor*>(exec)->submit([hndl]() { hndl.resume(); });
+                     })
+    {
+    }
+    
+    /**
+     * @brief       Resume a coroutine on the executor.
+     * @param       hndl : The coroutine.
+     */
+    void schedule(std::coroutine_handle<> hndl) const
+    {
+        if (exec_ == nullptr)
+        {
+            hndl.resume();
+        }
+        else
+        {
+            schdl_(exec_, hndl);
+        }
+    }
+
+private:
+    /** The executor. */
+    void* exec_;
+    
+    /** Function that submits the resumption of a coroutine to the executor. */
+    void (*schdl_)(void*, std::coroutine_handle<>);
+};
+
+
+/**
+ * @brief       Part of the promise of a task that does not depend on the value type.
+ */
+class __task_promise_base
+{
+public:
+    /**
+     * @brief       Awaiter of the end of a task, that resumes the coroutine awaiting it.
+     */
+    struct final_awaiter
+    {
+        /**
+         * @brief       Check whether the task does not have to suspend.
+         * @return      False.
+         */
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+        
+        /**
+         * @brief       Get the coroutine to resume once the task is suspended.
+         * @param       hndl : The task.
+         * @return      The coroutine awaiting the task, or a no-op coroutine if there is none.
+         */
+        template<typename TpPromise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<TpPromise> hndl) noexcept
+        {
+            std::coroutine_handle<> cont = hndl.promise().get_continuation();
+            
+            return cont ? cont : std::noop_coroutine();
+        }
+        
+        /**
+         * @brief       Resume the task, which does not happen.
+         */
+        void await_resume() const noexcept
+        {
+        }
+    };
+    
+    /**
+     * @brief       Get the awaiter of the start of the task, which is lazy.
+     * @return      The awaiter of the start of the task.
+     */
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+    
+    /**
+     * @brief       Get the awaiter of the end of the task.
+     * @return      The awaiter of the end of the task.
+     */
+    [[nodiscard]] final_awaiter final_suspend() const noexcept
+    {
+        return {};
+    }
+    
+    /**
+     * @brief       Store the exception that escapes the task.
+     */
+    void unhandled_exception() noexcept
+    {
+        excptn_ = std::current_exception();
+    }
+    
+    /**
+     * @brief       Get the coroutine to resume once the task is done.
+     * @return      The coroutine to resume once the task is done.
+     */
+    [[nodiscard]] std::coroutine_handle<> get_continuation() const noexcept
+    {
+        return cont_;
+    }
+    
+    /**
+     * @brief       Set the coroutine to resume once the task is done.
+     * @param       cont : The coroutine to resume once the task is done.
+     */
+    void set_continuation(std::coroutine_handle<> cont) noexcept
+    {
+        cont_ = cont;
+    }
+    
+    /**
+     * @brief       Get the executor on which the task is resumed.
+     * @return      The executor on which the task is resumed.
+     */
+    [[nodiscard]] const __executor_reference& get_executor() const noexcept
+    {
+        return exec_;
+    }
+    
+    /**
+     * @brief       Set the executor on which the task is resumed.
+     * @param       exec : The executor on which the task is resumed.
+     */
+    void set_executor(const __executor_reference& exec) noexcept
+    {
+        exec_ = exec;
+    }
+
+protected:
+    /** The coroutine to resume once the task is done. */
+    std::coroutine_handle<> cont_;
+    
+    /** The executor on which the task is resumed. */
+    __executor_reference exec_;
+    
+    /** The exception that escaped the task. */
+    std::exception_ptr excptn_;
+};
+
+
+/**
+ * @brief       Promise of a task that returns a value.
+ */
+template<typename TpValue>
+class __task_promise : public __task_promise_base
+{
+public:
+    /**
+     * @brief       Get the task of the promise.
+     * @return      The task of the promise.
+     */
+    task<TpValue> get_return_object() noexcept
+    {
+        return task<TpValue>(std::coroutine_handle<__task_promise>::from_promise(*this));
+    }
+    
+    /**
+     * @brief       Store the value returned by the task.
+     * @param       val : The value returned by the task.
+     */
+    template<typename TpValue_>
+    void return_value(TpValue_&& val)
+    {
+        val_.emplace(std::forward<TpValue_>(val));
+    }
+    
+    /**
+     * @brief       Take the value returned by the task, or throw the exception that escaped it.
+     * @return      The value returned by the task.
+     */
+    TpValue take_result()
+    {
+        if (excptn_)
+        {
+            std::rethrow_exception(excptn_);
+        }
+        
+        return std::move(*val_);
+    }
+
+private:
+    /** The value returned by the task. */
+    std::optional<TpValue> val_;
+};
+
+
+/**
+ * @brief       Promise of a task that returns nothing.
+ */
+template<>
+class __task_promise<void> : public __task_promise_base
+{
+public:
+    /**
+     * @brief       Get the task of the promise.
+     * @return      The task of the promise.
+     */
+    task<void> get_return_object() noexcept;
+    
+    /**
+     * @brief       Record the end of the task.
+     */
+    void return_void() const noexcept
+    {
+    }
+    
+    /**
+     * @brief       Throw the exception that escaped the task, if any.
+     */
+    void take_result()
+    {
+        if (excptn_)
+        {
+            std::rethrow_exception(excptn_);
+        }
+    }
+};
+
+
+/**
+ * @brief       Awaiter of a task, that starts the task and resumes the awaiting coroutine once
+ *              the task is done.
+ */
+template<typename TpValue>
+class __task_awaiter
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       hndl : The task.
+     */
+    explicit __task_awaiter(std::coroutine_handle<__task_promise<TpValue>> hndl) noexcept
+            : hndl_(hndl)
+    {
+    }
+    
+    /**
+     * @brief       Check whether the awaiting coroutine does not have to suspend.
+     * @return      False.
+     */
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    
+    /**
+     * @brief       Start the task, which runs on the executor of the awaiting coroutine.
+     * @param       cllr : The awaiting coroutine.
+     * @return      The task.
+     */
+    template<typename TpPromise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<TpPromise> cllr) noexcept
+    {
+        hndl_.promise().set_continuation(cllr);
+        if constexpr (std::is_base_of<__task_promise_base, TpPromise>::value)
+        {
+            hndl_.promise().set_executor(cllr.promise().get_executor());
+        }
+        
+        return hndl_;
+    }
+    
+    /**
+     * @brief       Get the result of the task.
+     * @return      The value returned by the task.
+     */
+    TpValue await_resume()
+    {
+        return hndl_.promise().take_result();
+    }
+
+private:
+    /** The task. */
+    std::coroutine_handle<__task_promise<TpValue>> hndl_;
+};
+
+
+/**
+ * @brief       Coroutine that starts a task on an executor and sets its result in a promise. It
+ *              destroys itself once done.
+ */
+struct __detached_task
+{
+    /**
+     * @brief       Promise of the coroutine.
+     */
+    struct promise_type : public __task_promise_base
+    {
+        /**
+         * @brief       Get the coroutine of the promise.
+         * @return      The coroutine of the promise.
+         */
+        __detached_task get_return_object() noexcept
+        {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        
+        /**
+         * @brief       Get the awaiter of the end of the coroutine, that destroys it.
+         * @return      The awaiter of the end of the coroutine.
+         */
+        [[nodiscard]] std::suspend_never final_suspend() const noexcept
+        {
+            return {};
+        }
+        
+        /**
+         * @brief       Record the end of the coroutine.
+         */
+        void return_void() const noexcept
+        {
+        }
+    };
+    
+    /** The coroutine. */
+    std::coroutine_handle<promise_type> hndl;
+};
+
+
+/**
+ * @brief       Run a task and set its result in a promise.
+ * @param       tsk : The task.
+ * @param       prms : The promise.
+ * @return      The coroutine, that is suspended before running the task.
+ */
+template<typename TpValue>
+__detached_task __run_detached(task<TpValue> tsk, promise<TpValue> prms)
+{
+    try
+    {
+        if constexpr (std::is_void<TpValue>::value)
+        {
+            co_await std::move(tsk);
+            prms.set_value();
+        }
+        else
+        {
+            prms.set_value(co_await std::move(tsk));
+        }
+    }
+    catch (...)
+    {
+        prms.set_exception(std::current_exception());
+    }
+}
+
+
+/**
+ * @brief       Awaiter of a future, that resumes the coroutine on its executor once the future is
+ *              ready. The awaiter is the continuation of the future, so no allocation is done.
+ */
+template<typename TpValue>
+class __future_awaiter : public __continuation
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       fut : The future.
+     */
+    explicit __future_awaiter(future<TpValue>&& fut) noexcept
+            : __continuation{&__future_awaiter::notify}
+            , fut_(std::move(fut))
+            , hndl_()
+            , exec_()
+    {
+    }
+    
+    /**
+     * @brief       Check whether the future is ready, so the coroutine does not have to suspend.
+     * @return      If the future is ready true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return fut_.is_ready();
+    }
+    
+    /**
+     * @brief       Attach the awaiter to the future.
+     * @param       hndl : The coroutine.
+     * @return      If the coroutine has to stay suspended true is returned, otherwise the future
+     *              became ready and false is returned.
+     * @throw       speed::concurrency::continuation_already_attached_exception : If the future
+     *              already has a continuation an exception is thrown.
+     */
+    template<typename TpPromise>
+    bool await_suspend(std::coroutine_handle<TpPromise> hndl)
+    {
+        hndl_ = hndl;
+        if constexpr (std::is_base_of<__task_promise_base, TpPromise>::value)
+        {
+            exec_ = hndl.promise().get_executor();
+        }
+        
+        switch (__future_access::get_state(fut_)->try_attach(this))
+        {
+            case __attach_status::ATTACHED:
+                return true;
+            case __attach_status::READY:
+                return false;
+            case __attach_status::TAKEN:
+                break;
+        }
+        
+        throw continuation_already_attached_exception();
+    }
+    
+    /**
+     * @brief       Get the result of the future.
+     * @return      The value.
+     */
+    TpValue await_resume()
+    {
+        return fut_.get();
+    }
+
+private:
+    /**
+     * @brief       Called when the future becomes ready.
+     * @param       cont : The continuation, that is the awaiter.
+     */
+    static void notify(__continuation* cont) noexcept
+    {
+        auto* awtr = static_cast<__future_awaiter*>(cont);
+        const __executor_reference exec = awtr->exec_;
+        
+        exec.schedule(awtr->hndl_);
+    }
+    
+    /** The future. */
+    future<TpValue> fut_;
+    
+    /** The coroutine. */
+    std::coroutine_handle<> hndl_;
+    
+    /** The executor on which the coroutine is resumed. */
+    __executor_reference exec_;
+};
+
+
+/**
+ * @brief       Awaiter that moves a coroutine to an executor.
+ */
+class __resume_on_awaiter
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       exec : The executor.
+     */
+    explicit __resume_on_awaiter(const __executor_reference& exec) noexcept
+            : exec_(exec)
+    {
+    }
+    
+    /**
+     * @brief       Check whether the coroutine does not have to suspend.
+     * @return      False.
+     */
+    [[nodiscard]] bool await_ready() const noexcept
+    {
+        return false;
+    }
+    
+    /**
+     * @brief       Submit the resumption of the coroutine to the executor.
+     * @param       hndl : The coroutine.
+     */
+    template<typename TpPromise>
+    void await_suspend(std::coroutine_handle<TpPromise> hndl) const
+    {
+        if constexpr (std::is_base_of<__task_promise_base, TpPromise>::value)
+        {
+            hndl.promise().set_executor(exec_);
+        }
+        
+        exec_.schedule(hndl);
+    }
+    
+    /**
+     * @brief       Resume the coroutine on the executor.
+     */
+    void await_resume() const noexcept
+    {
+    }
+
+private:
+    /** The executor. */
+    __executor_reference exec_;
+};
+
+
+} /* __hidden_concurrency */
+/** @endcond */
+
+
+/**
+ * @brief       Class that represents a lazy coroutine that returns a value. It starts when it is
+ *              awaited, or when it is started on an executor, and it runs on the executor of the
+ *              coroutine that awaits it. Awaiting a future from a task suspends it without
+ *              blocking a thread, and resumes it on its executor once the future is ready.
+ */
+template<typename TpValue = void>
+class task
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The promise type. */
+    using promise_type = __hidden_concurrency::__task_promise<value_type>;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       hndl : The coroutine.
+     */
+    explicit task(std::coroutine_handle<promise_type> hndl) noexcept
+            : hndl_(hndl)
+    {
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    task(task&& rhs) noexcept
+            : hndl_(std::exchange(rhs.hndl_, nullptr))
+    {
+    }
+    
+    /** @cond */
+    task(const task&) = delete;
+    
+    task& operator =(const task&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor.
+     */
+    ~task()
+    {
+        if (hndl_)
+        {
+            hndl_.destroy();
+        }
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    task& operator =(task&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            if (hndl_)
+            {
+                hndl_.destroy();
+            }
+            
+            hndl_ = std::exchange(rhs.hndl_, nullptr);
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Await the task. The task runs on the executor of the awaiting coroutine, and
+     *              resumes it once done.
+     * @return      The awaiter of the task.
+     */
+    auto operator co_await() && noexcept
+    {
+        return __hidden_concurrency::__task_awaiter<value_type>(hndl_);
+    }
+    
+    /**
+     * @brief       Start the task on an executor. The task is no longer valid afterwards.
+     * @param       exec : The executor, that needs a submit method that receives a function
+     *              without arguments. It has to outlive the task.
+     * @return      The future of the value returned by the task.
+     */
+    template<typename TpExecutor>
+    future<value_type> start(TpExecutor& exec) &&
+    {
+        promise<value_type> prms;
+        future<value_type> fut = prms.get_future();
+        auto hndl = __hidden_concurrency::__run_detached(std::move(*this), std::move(prms)).hndl;
+        
+        hndl.promise().set_executor(__hidden_concurrency::__executor_reference(exec));
+        try
+        {
+            hndl.promise().get_executor().schedule(hndl);
+        }
+        catch (...)
+        {
+            hndl.destroy();
+            throw;
+        }
+        
+        return fut;
+    }
+
+private:
+    /** The coroutine. */
+    std::coroutine_handle<promise_type> hndl_;
+};
+
+
+/** @cond */
+namespace __hidden_concurrency {
+
+
+inline task<void> __task_promise<void>::get_return_object() noexcept
+{
+    return task<void>(std::coroutine_handle<__task_promise>::from_promise(*this));
+}
+
+
+} /* __hidden_concurrency */
+/** @endcond */
+
+
+/**
+ * @brief       Await a future from a task, which is resumed on its executor once the future is
+ *              ready.
+ * @param       fut : The future, that has to be valid.
+ * @return      The awaiter of the future.
+ */
+template<typename TpValue>
+auto operator co_await(future<TpValue>&& fut) noexcept
+{
+    return __hidden_concurrency::__future_awaiter<TpValue>(std::move(fut));
+}
+
+
+/**
+ * @brief       Move the awaiting task to an executor, on which it goes on running.
+ * @param       exec : The executor, that needs a submit method that receives a function without
+ *              arguments. It has to outlive the task.
+ * @return      The awaiter.
+ */
+template<typename TpExecutor>
+auto resume_on(TpExecutor& exec) noexcept
+{
+    return __hidden_concurrency::__resume_on_awaiter(
+            __hidden_concurrency::__executor_reference(exec));
+}
+
+
+}
+}
+
+#endif
+
+#endif
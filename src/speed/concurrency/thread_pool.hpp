@@ -0,0 +1,811 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/concurrency/thread_pool.hpp
+ * @brief       thread_pool class header.
+ * @author      Killian
+ * @date        2018/09/30 - 11:52
+ */
+
+#ifndef SPEED_CONCURRENCY_THREAD_POOL_HPP
+#define SPEED_CONCURRENCY_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../system/sync/event_count.hpp"
+#include "../system/sync/sync.hpp"
+#include "chase_lev_deque.hpp"
+
+
+namespace speed {
+namespace concurrency {
+
+
+class task_group;
+
+
+/** @cond */
+namespace __hidden_concurrency {
+
+
+/** The size of the buffer in which a task function is stored without allocation. */
+constexpr std::size_t TASK_INLINE_SIZE = 48;
+
+/** The maximum number of free task nodes kept by a thread for reuse. */
+constexpr std::size_t TASK_NODE_CACHE_SIZE = 1024;
+
+/** The number of rounds a worker looks for a task before parking. */
+constexpr std::size_t SEARCH_ROUNDS = 64;
+
+/** The bit of the number of pending tasks of a group set when a thread sleeps waiting for it. */
+constexpr std::uint32_t GROUP_WAITING_BIT = 0x80000000;
+
+
+/**
+ * @brief       Node that holds a task. The task function is stored in the node itself when it is
+ *              small enough, and the nodes are recycled through a per thread cache, so running a
+ *              task does not allocate in the steady state.
+ */
+struct __task_node
+{
+    /** The buffer that holds the task function, or a pointer to it when it is too large. */
+    alignas(std::max_align_t) unsigned char buf[TASK_INLINE_SIZE];
+    
+    /** Function that calls the task function and destroys it. */
+    void (*run_and_destroy)(__task_node*);
+    
+    /** The group of the task, if any. */
+    task_group* grp;
+    
+    /** The next node in the cache of free nodes. */
+    __task_node* nxt;
+};
+
+
+/**
+ * @brief       Cache of free task nodes owned by a thread.
+ */
+struct __task_node_cache
+{
+    /**
+     * @brief       Destructor.
+     */
+    ~__task_node_cache()
+    {
+        __task_node* nxt;
+        
+        while (hd != nullptr)
+        {
+            nxt = hd->nxt;
+            delete hd;
+            hd = nxt;
+        }
+    }
+    
+    /** The first free node. */
+    __task_node* hd = nullptr;
+    
+    /** The number of free nodes. */
+    std::size_t sz = 0;
+};
+
+
+/**
+ * @brief       Get the cache of free task nodes of the calling thread.
+ * @return      The cache of free task nodes of the calling thread.
+ */
+inline __task_node_cache& __get_task_node_cache() noexcept
+{
+    static thread_local __task_node_cache cche;
+    
+    return cche;
+}
+
+
+/**
+ * @brief       Create a task node that holds a task function.
+ * @param       fnc : The task function.
+ * @param       grp : The group of the task, if any.
+ * @return      The task node.
+ */
+template<typename TpFunction>
+__task_node* __make_task_node(TpFunction&& fnc, task_group* grp)
+{
+    using function_type = std::decay_t<TpFunction>;
+    
+    __task_node_cache& cche = __get_task_node_cache();
+    __task_node* nod;
+    
+    if (cche.hd != nullptr)
+    {
+        nod = cche.hd;
+        cche.hd = nod->nxt;
+        --cche.sz;
+    }
+    else
+    {
+        nod = new __task_node;
+    }
+    
+    try
+    {
+        if constexpr (sizeof(function_type) <= TASK_INLINE_SIZE &&
+                      alignof(function_type) <= alignof(std::max_align_t))
+        {
+            new (nod->buf) function_type(std::forward<TpFunction>(fnc));
+            nod->run_and_destroy = [](__task_node* nd)
+            {
+                auto* fnc_ptr = std::launder(reinterpret_cast<function_type*>(nd->buf));
+                
+                try
+                {
+                    (*fnc_ptr)();
+                }
+                catch (...)
+                {
+                    fnc_ptr->~function_type();
+                    throw;
+                }
+                
+                fnc_ptr->~function_type();
+            };
+        }
+        else
+        {
+            *reinterpret_cast<function_type**>(nod->buf) =
+                    new function_type(std::forward<TpFunction>(fnc));
+            nod->run_and_destroy = [](__task_node* nd)
+            {
+                std::unique_ptr<function_type> fnc_ptr(
+                        *reinterpret_cast<function_type**>(nd->buf));
+                
+                (*fnc_ptr)();
+            };
+        }
+    }
+    catch (...)
+    {
+        nod->nxt = cche.hd;
+        cche.hd = nod;
+        ++cche.sz;
+        throw;
+    }
+    
+    nod->grp = grp;
+    
+    return nod;
+}
+
+
+/**
+ * @brief       Give a task node back to the cache of free nodes of the calling thread.
+ * @param       nod : The task node, whose function has been destroyed.
+ */
+inline void __release_task_node(__task_node* nod) noexcept
+{
+    __task_node_cache& cche = __get_task_node_cache();
+    
+    if (cche.sz < TASK_NODE_CACHE_SIZE)
+    {
+        nod->nxt = cche.hd;
+        cche.hd = nod;
+        ++cche.sz;
+    }
+    else
+    {
+        delete nod;
+    }
+}
+
+
+} /* __hidden_concurrency */
+/** @endcond */
+
+
+/**
+ * @brief       Class that represents a pool of threads that run tasks with work stealing. Every
+ *              worker owns a Chase-Lev deque: the tasks spawned by a worker are pushed on its own
+ *              deque and popped in LIFO order, which keeps the recently touched data in cache,
+ *              while idle workers steal the oldest tasks, which are usually the largest ones, from
+ *              the top of the deques of random victims. The tasks submitted by other threads go
+ *              through a shared injection queue. Idle workers park on an event_count and are
+ *              woken only when there are sleeping workers, so spawning a task costs no system call
+ *              when the pool is busy. Tasks are stored in recycled nodes with an inline buffer, so
+ *              spawning a small task does not allocate.
+ */
+class thread_pool
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_thrds : The number of worker threads. If it is 0 the number of hardware
+     *              threads is used.
+     * @param       pin_thrds : Whether every worker is pinned to a CPU, the worker i running on the
+     *              CPU i modulo the number of CPUs. It is ignored on the systems that do not
+     *              support it.
+     */
+    explicit thread_pool(std::size_t nbr_thrds = 0, bool pin_thrds = false)
+            : wrkrs_()
+            , thrds_()
+            , inj_mtx_()
+            , inj_q_()
+            , inj_sz_(0)
+            , evnt_cnt_()
+            , nbr_thrds_(nbr_thrds != 0 ? nbr_thrds
+                                        : std::max(std::thread::hardware_concurrency(), 1U))
+            , stop_(false)
+    {
+        wrkrs_ = std::make_unique<worker[]>(nbr_thrds_);
+        
+        thrds_.reserve(nbr_thrds_);
+        try
+        {
+            for (std::size_t i = 0; i < nbr_thrds_; ++i)
+            {
+                thrds_.emplace_back(&thread_pool::work, this, i);
+                if (pin_thrds)
+                {
+                    pin_thread(thrds_.back(), i);
+                }
+            }
+        }
+        catch (...)
+        {
+            stop();
+            throw;
+        }
+    }
+    
+    /** @cond */
+    thread_pool(const thread_pool&) = delete;
+    
+    thread_pool& operator =(const thread_pool&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. The tasks already submitted are run, then the workers stop.
+     */
+    ~thread_pool()
+    {
+        stop();
+    }
+    
+    /**
+     * @brief       Submit a task that is not waited for. If the task throws an exception,
+     *              std::terminate is called.
+     * @param       fnc : The task function, that takes no argument.
+     */
+    template<typename TpFunction>
+    void submit(TpFunction&& fnc)
+    {
+        push(__hidden_concurrency::__make_task_node(std::forward<TpFunction>(fnc), nullptr));
+    }
+    
+    /**
+     * @brief       Get the number of worker threads.
+     * @return      The number of worker threads.
+     */
+    [[nodiscard]] std::size_t get_concurrency() const noexcept
+    {
+        return nbr_thrds_;
+    }
+    
+    /**
+     * @brief       Get the index of the calling thread among the workers of the pool.
+     * @return      The index of the calling thread among the workers of the pool, or
+     *              get_concurrency() if the calling thread is not one of them.
+     */
+    [[nodiscard]] std::size_t get_worker_index() const noexcept
+    {
+        return cur_pool_ == this ? cur_wrkr_idx_ : nbr_thrds_;
+    }
+
+private:
+    /**
+     * @brief       State of a worker.
+     */
+    struct alignas(64) worker
+    {
+        /** The deque of tasks owned by the worker. */
+        chase_lev_deque<__hidden_concurrency::__task_node*> dq;
+        
+        /** The state of the random generator used to choose the victims. */
+        std::uint64_t rnd_stte = 0;
+    };
+    
+    /**
+     * @brief       Push a task. It goes on the deque of the calling thread if it is a worker of the
+     *              pool, and on the injection queue otherwise.
+     * @param       nod : The task node.
+     */
+    void push(__hidden_concurrency::__task_node* nod)
+    {
+        if (cur_pool_ == this)
+        {
+            wrkrs_[cur_wrkr_idx_].dq.push(nod);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lck(inj_mtx_);
+            
+            inj_q_.push_back(nod);
+            inj_sz_.fetch_add(1, std::memory_order_release);
+        }
+        
+        evnt_cnt_.notify_one();
+    }
+    
+    /**
+     * @brief       Take a task to run: first from the deque of the calling worker, then from the
+     *              injection queue, and then from the deques of the other workers starting from a
+     *              random one. It must only be called by a worker of the pool.
+     * @param       nod : The task node taken.
+     * @return      If a task has been taken true is returned, otherwise false is returned.
+     */
+    bool take(__hidden_concurrency::__task_node*& nod)
+    {
+        worker& wrkr = wrkrs_[cur_wrkr_idx_];
+        std::size_t strt;
+        
+        if (wrkr.dq.pop(nod))
+        {
+            return true;
+        }
+        
+        if (inj_sz_.load(std::memory_order_acquire) != 0)
+        {
+            std::lock_guard<std::mutex> lck(inj_mtx_);
+            
+            if (!inj_q_.empty())
+            {
+                nod = inj_q_.front();
+                inj_q_.pop_front();
+                inj_sz_.fetch_sub(1, std::memory_order_relaxed);
+                
+                return true;
+            }
+        }
+        
+        strt = static_cast<std::size_t>(next_random(wrkr.rnd_stte) % nbr_thrds_);
+        for (std::size_t i = 0; i < nbr_thrds_; ++i)
+        {
+            if (wrkrs_[(strt + i) % nbr_thrds_].dq.steal(nod))
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Check whether there is a task that could be taken. It is only a hint.
+     * @return      If there is a task that could be taken true is returned, otherwise false is
+     *              returned.
+     */
+    bool has_task() const noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (inj_sz_.load(std::memory_order_seq_cst) != 0)
+        {
+            return true;
+        }
+        
+        for (std::size_t i = 0; i < nbr_thrds_; ++i)
+        {
+            if (!wrkrs_[i].dq.empty())
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Run a task and release its node.
+     * @param       nod : The task node.
+     */
+    void run(__hidden_concurrency::__task_node* nod);
+    
+    /**
+     * @brief       Run a task that is not in a group. If it throws an exception, std::terminate is
+     *              called.
+     * @param       nod : The task node.
+     */
+    static void run_detached(__hidden_concurrency::__task_node* nod) noexcept
+    {
+        nod->run_and_destroy(nod);
+    }
+    
+    /**
+     * @brief       Run the tasks until the pool stops.
+     * @param       wrkr_idx : The index of the worker.
+     */
+    void work(std::size_t wrkr_idx)
+    {
+        __hidden_concurrency::__task_node* nod;
+        std::uint32_t ky;
+        
+        cur_pool_ = this;
+        cur_wrkr_idx_ = wrkr_idx;
+        wrkrs_[wrkr_idx].rnd_stte = (wrkr_idx + 1) * 0x9e3779b97f4a7c15ULL;
+        
+        while (true)
+        {
+            if (find(nod))
+            {
+                run(nod);
+                continue;
+            }
+            
+            ky = evnt_cnt_.prepare_wait();
+            if (has_task())
+            {
+                evnt_cnt_.cancel_wait();
+                continue;
+            }
+            
+            if (stop_.load(std::memory_order_seq_cst))
+            {
+                evnt_cnt_.cancel_wait();
+                break;
+            }
+            
+            evnt_cnt_.wait(ky);
+        }
+        
+        cur_pool_ = nullptr;
+    }
+    
+    /**
+     * @brief       Look for a task for a few rounds before giving up.
+     * @param       nod : The task node found.
+     * @return      If a task has been found true is returned, otherwise false is returned.
+     */
+    bool find(__hidden_concurrency::__task_node*& nod)
+    {
+        for (std::size_t i = 0; i < __hidden_concurrency::SEARCH_ROUNDS; ++i)
+        {
+            if (take(nod))
+            {
+                return true;
+            }
+            
+            std::this_thread::yield();
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Stop the workers once all the tasks are run, and wait for them.
+     */
+    void stop() noexcept
+    {
+        stop_.store(true, std::memory_order_seq_cst);
+        evnt_cnt_.notify_all();
+        
+        for (auto& x : thrds_)
+        {
+            x.join();
+        }
+        
+        thrds_.clear();
+    }
+    
+    /**
+     * @brief       Pin a thread to a CPU.
+     * @param       thrd : The thread.
+     * @param       idx : The index of the thread, from which the CPU is chosen.
+     */
+    static void pin_thread(std::thread& thrd, std::size_t idx) noexcept
+    {
+#ifdef __linux__
+        const std::size_t nbr_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+        cpu_set_t cpu_st;
+        
+        CPU_ZERO(&cpu_st);
+        CPU_SET(idx % nbr_cpus, &cpu_st);
+        ::pthread_setaffinity_np(thrd.native_handle(), sizeof(cpu_set_t), &cpu_st);
+#else
+        (void)thrd;
+        (void)idx;
+#endif
+    }
+    
+    /**
+     * @brief       Get the next number of a xorshift random generator.
+     * @param       stte : The state of the generator.
+     * @return      The next number of the generator.
+     */
+    static std::uint64_t next_random(std::uint64_t& stte) noexcept
+    {
+        stte ^= stte << 13;
+        stte ^= stte >> 7;
+        stte ^= stte << 17;
+        
+        return stte;
+    }
+    
+    /** The pool whose worker is the current thread, if any. */
+    static inline thread_local thread_pool* cur_pool_ = nullptr;
+    
+    /** The index of the worker that is the current thread. */
+    static inline thread_local std::size_t cur_wrkr_idx_ = 0;
+    
+    /** The state of the workers. */
+    std::unique_ptr<worker[]> wrkrs_;
+    
+    /** The worker threads. */
+    std::vector<std::thread> thrds_;
+    
+    /** Mutex that protects the injection queue. */
+    std::mutex inj_mtx_;
+    
+    /** The queue of the tasks submitted by threads that are not workers. */
+    std::deque<__hidden_concurrency::__task_node*> inj_q_;
+    
+    /** The number of tasks in the injection queue. */
+    std::atomic<std::size_t> inj_sz_;
+    
+    /** The event count on which the idle workers park. */
+    speed::system::event_count evnt_cnt_;
+    
+    /** The number of worker threads. */
+    std::size_t nbr_thrds_;
+    
+    /** Whether the workers have to stop once there is no task left. */
+    std::atomic<bool> stop_;
+    
+    friend class task_group;
+};
+
+
+/**
+ * @brief       Class that represents a group of tasks run on a thread pool, for fork-join
+ *              parallelism. The tasks are spawned in the group and the group is waited for. A
+ *              worker that waits runs the tasks of the pool meanwhile, its own ones first, so a
+ *              task can spawn and wait for a nested group without blocking a worker. The other
+ *              threads do not run tasks while they wait: they would take the oldest tasks, that
+ *              are the largest ones, and nest them on their stack without bound.
+ */
+class task_group
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       pool : The pool on which the tasks are run.
+     */
+    explicit task_group(thread_pool& pool) noexcept
+            : pool_(pool)
+            , excptn_mtx_()
+            , excptn_()
+            , pndng_(0)
+    {
+    }
+    
+    /** @cond */
+    task_group(const task_group&) = delete;
+    
+    task_group& operator =(const task_group&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. It waits for the tasks of the group, whose exceptions are ignored.
+     */
+    ~task_group()
+    {
+        join();
+    }
+    
+    /**
+     * @brief       Spawn a task in the group.
+     * @param       fnc : The task function, that takes no argument.
+     */
+    template<typename TpFunction>
+    void spawn(TpFunction&& fnc)
+    {
+        __hidden_concurrency::__task_node* nod =
+                __hidden_concurrency::__make_task_node(std::forward<TpFunction>(fnc), this);
+        
+        pndng_.fetch_add(1, std::memory_order_relaxed);
+        pool_.push(nod);
+    }
+    
+    /**
+     * @brief       Wait for all the tasks of the group. A worker of the pool runs tasks meanwhile,
+     *              any other thread sleeps. The group can be reused afterwards.
+     * @throw       The first exception thrown by a task of the group.
+     */
+    void wait()
+    {
+        std::exception_ptr excptn;
+        
+        join();
+        
+        {
+            std::lock_guard<std::mutex> lck(excptn_mtx_);
+            std::swap(excptn, excptn_);
+        }
+        
+        if (excptn)
+        {
+            std::rethrow_exception(excptn);
+        }
+    }
+    
+    /**
+     * @brief       Get the pool on which the tasks are run.
+     * @return      The pool on which the tasks are run.
+     */
+    [[nodiscard]] thread_pool& get_pool() const noexcept
+    {
+        return pool_;
+    }
+
+private:
+    /**
+     * @brief       Wait for all the tasks of the group. A worker of the pool runs tasks meanwhile,
+     *              any other thread sleeps.
+     */
+    void join()
+    {
+        constexpr std::uint32_t wtng_bit = __hidden_concurrency::GROUP_WAITING_BIT;
+        
+        const bool is_wrkr = thread_pool::cur_pool_ == &pool_;
+        __hidden_concurrency::__task_node* nod;
+        std::uint32_t pndng;
+        std::size_t nbr_fails = 0;
+        
+        while (((pndng = pndng_.load(std::memory_order_acquire)) & ~wtng_bit) != 0)
+        {
+            if (is_wrkr && pool_.take(nod))
+            {
+                pool_.run(nod);
+                nbr_fails = 0;
+                continue;
+            }
+            
+            if (++nbr_fails < __hidden_concurrency::SEARCH_ROUNDS)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            
+            pndng = pndng_.fetch_or(wtng_bit, std::memory_order_acq_rel);
+            if ((pndng & ~wtng_bit) == 0)
+            {
+                break;
+            }
+            
+            sleep(pndng | wtng_bit);
+            nbr_fails = 0;
+        }
+        
+        pndng_.store(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Sleep until the number of pending tasks changes from a given value, or yield
+     *              when futexes are not available.
+     * @param       pndng : The number of pending tasks seen, with the waiting bit.
+     */
+    void sleep(std::uint32_t pndng) noexcept
+    {
+        if (!speed::system::futex_wait(&pndng_, pndng))
+        {
+            std::this_thread::yield();
+        }
+    }
+    
+    /**
+     * @brief       Record that a task of the group is done.
+     * @param       excptn : The exception thrown by the task, if any.
+     */
+    void complete(std::exception_ptr excptn) noexcept
+    {
+        if (excptn)
+        {
+            std::lock_guard<std::mutex> lck(excptn_mtx_);
+            
+            if (!excptn_)
+            {
+                excptn_ = std::move(excptn);
+            }
+        }
+        
+        // The group can be destroyed as soon as the last task is counted down, so the waiting bit
+        // is read in the same operation and only the address of the counter is used afterwards.
+        if (pndng_.fetch_sub(1, std::memory_order_acq_rel) ==
+            (__hidden_concurrency::GROUP_WAITING_BIT | 1))
+        {
+            speed::system::futex_wake_all(&pndng_);
+        }
+    }
+    
+    /** The pool on which the tasks are run. */
+    thread_pool& pool_;
+    
+    /** Mutex that protects the exception. */
+    std::mutex excptn_mtx_;
+    
+    /** The first exception thrown by a task of the group. */
+    std::exception_ptr excptn_;
+    
+    /** The number of tasks not done yet, with GROUP_WAITING_BIT set when a thread sleeps. */
+    std::atomic<std::uint32_t> pndng_;
+    
+    friend class thread_pool;
+};
+
+
+inline void thread_pool::run(__hidden_concurrency::__task_node* nod)
+{
+    task_group* grp = nod->grp;
+    std::exception_ptr excptn;
+    
+    if (grp == nullptr)
+    {
+        run_detached(nod);
+    }
+    else
+    {
+        try
+        {
+            nod->run_and_destroy(nod);
+        }
+        catch (...)
+        {
+            excptn = std::current_exception();
+        }
+    }
+    
+    __hidden_concurrency::__release_task_node(nod);
+    if (grp != nullptr)
+    {
+        grp->complete(std::move(excptn));
+    }
+}
+
+
+}
+}
+
+
+#endif
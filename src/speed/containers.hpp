@@ -27,15 +27,29 @@
 #ifndef SPEED_CONTAINERS_HPP
 #define SPEED_CONTAINERS_HPP
 
+#include "containers/b_plus_tree.hpp"
+#include "containers/bit_packing.hpp"
+#include "containers/block_delta_sequence.hpp"
+#include "containers/blocked_bloom_filter.hpp"
+#include "containers/btree_map.hpp"
+#include "containers/btree_set.hpp"
 #include "containers/circular_doubly_linked_list.hpp"
+#include "containers/concurrent_skip_list_map.hpp"
+#include "containers/concurrent_unordered_map.hpp"
 #include "containers/containers_exception.hpp"
+#include "containers/cuckoo_filter.hpp"
+#include "containers/d_ary_heap.hpp"
 #include "containers/doubly_linked_node.hpp"
+#include "containers/elias_fano_sequence.hpp"
+#include "containers/epoch_based_reclamation.hpp"
 #include "containers/flags.hpp"
 #include "containers/i_const_iterator.hpp"
 #include "containers/i_const_mutable_iterator.hpp"
 #include "containers/i_iterator.hpp"
 #include "containers/i_mutable_iterator.hpp"
+#include "containers/packed_array.hpp"
 #include "containers/static_cache.hpp"
+#include "containers/static_string.hpp"
 
 
 namespace speed {
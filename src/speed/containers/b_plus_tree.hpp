@@ -0,0 +1,1713 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/b_plus_tree.hpp
+ * @brief      b_plus_tree class header.
+ * @author     Killian
+ * @date       2018/09/08 - 16:20
+ */
+
+#ifndef SPEED_CONTAINERS_B_PLUS_TREE_HPP
+#define SPEED_CONTAINERS_B_PLUS_TREE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "containers_exception.hpp"
+#include "i_const_mutable_iterator.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/** @cond */
+namespace __hidden_containers {
+
+
+template<typename TpMapped, std::size_t CAP>
+struct __b_plus_tree_leaf_values
+{
+    TpMapped vals_[CAP];
+};
+
+
+template<std::size_t CAP>
+struct __b_plus_tree_leaf_values<void, CAP>
+{
+};
+
+
+constexpr std::size_t __get_b_plus_tree_capacity(std::size_t node_sz, std::size_t entry_sz)
+{
+    return node_sz / entry_sz < 4 ? 4 : node_sz / entry_sz;
+}
+
+
+} /* __hidden_containers */
+/** @endcond */
+
+
+/**
+ * @brief       Class that represents a B+tree. All the elements are stored in the leaves, which
+ *              are linked together so range scans never go back up the tree. The nodes store their
+ *              keys contiguously and their capacity is computed from NODE_SIZE, so a search in a
+ *              node touches a few consecutive cache lines instead of chasing one pointer per level
+ *              of a binary tree. When TpMapped is void the tree behaves as a set. This class is the
+ *              base of btree_map and btree_set.
+ */
+template<
+        typename TpKey,
+        typename TpMapped,
+        typename TpCompare = std::less<TpKey>,
+        std::size_t NODE_SIZE = 256,
+        typename TpAllocator = std::allocator<int>
+>
+class b_plus_tree
+{
+public:
+    /** The key type. */
+    using key_type = TpKey;
+    
+    /** The mapped type. */
+    using mapped_type = TpMapped;
+    
+    /** The value accessed through the iterators. */
+    using value_type = std::conditional_t<std::is_void<TpMapped>::value, TpKey, TpMapped>;
+    
+    /** The compare type. */
+    using compare_type = TpCompare;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /** Whether the tree is a set. */
+    static constexpr bool IS_SET = std::is_void<TpMapped>::value;
+    
+    /** The maximum number of elements in a leaf. */
+    static constexpr std::size_t LEAF_CAPACITY = __hidden_containers::__get_b_plus_tree_capacity(
+            NODE_SIZE, sizeof(key_type) + (IS_SET ? 0 : sizeof(value_type)));
+    
+    /** The maximum number of keys in an inner node. */
+    static constexpr std::size_t INNER_CAPACITY = __hidden_containers::__get_b_plus_tree_capacity(
+            NODE_SIZE, sizeof(key_type) + sizeof(void*));
+    
+    /** The cache line size used to align the nodes. */
+    static constexpr std::size_t CACHE_LINE_SIZE = 64;
+    
+    /**
+     * @brief       Struct that represents the header shared by all the nodes.
+     */
+    struct node_base
+    {
+        /** Whether the node is a leaf. */
+        bool is_leaf_;
+        
+        /** The number of keys in the node. */
+        std::size_t n_;
+    };
+    
+    /**
+     * @brief       Struct that represents a leaf node.
+     */
+    struct alignas(CACHE_LINE_SIZE) leaf_node
+            : public node_base
+            , public __hidden_containers::__b_plus_tree_leaf_values<TpMapped, LEAF_CAPACITY>
+    {
+        /** The previous leaf. */
+        leaf_node* prev_;
+        
+        /** The next leaf. */
+        leaf_node* nxt_;
+        
+        /** The leaf keys. */
+        key_type keys_[LEAF_CAPACITY];
+    };
+    
+    /**
+     * @brief       Struct that represents an inner node.
+     */
+    struct alignas(CACHE_LINE_SIZE) inner_node : public node_base
+    {
+        /** The separator keys. The child i holds the keys in [keys_[i - 1], keys_[i]). */
+        key_type keys_[INNER_CAPACITY];
+        
+        /** The children. */
+        node_base* chlds_[INNER_CAPACITY + 1];
+    };
+    
+    /**
+     * @brief       Class that represents const iterators.
+     */
+    class const_iterator : public i_const_iterator<value_type, const_iterator>
+    {
+    public:
+        /** The class itself. */
+        using self_type = const_iterator;
+        
+        /** The base class. */
+        using base_type = i_const_iterator<value_type, const_iterator>;
+        
+        /** The node iteration type. */
+        using node_type = leaf_node;
+        
+        /**
+         * @brief       Default constructor.
+         */
+        const_iterator() noexcept
+                : tre_(nullptr)
+                , leaf_(nullptr)
+                , idx_(0)
+        {
+        }
+        
+        /**
+         * @brief       Constructor with parameters.
+         * @param       tre : The tree in which iterate.
+         * @param       leaf : The current leaf.
+         * @param       idx : The current index in the leaf.
+         */
+        const_iterator(const b_plus_tree* tre, leaf_node* leaf, std::size_t idx) noexcept
+                : tre_(tre)
+                , leaf_(leaf)
+                , idx_(idx)
+        {
+        }
+        
+        /**
+         * @brief       Move to the forward node.
+         * @return      A reference to an iterator pointing the current node.
+         */
+        self_type& operator ++() override
+        {
+            if (leaf_ != nullptr && ++idx_ >= leaf_->n_)
+            {
+                leaf_ = leaf_->nxt_;
+                idx_ = 0;
+            }
+            
+            return *this;
+        }
+        
+        /**
+         * @brief       Move to the backward node.
+         * @return      A reference to an iterator pointing the current node.
+         */
+        self_type& operator --() override
+        {
+            if (leaf_ == nullptr)
+            {
+                leaf_ = tre_->lst_leaf_;
+                idx_ = leaf_ != nullptr ? leaf_->n_ - 1 : 0;
+            }
+            else if (idx_ > 0)
+            {
+                --idx_;
+            }
+            else
+            {
+                leaf_ = leaf_->prev_;
+                idx_ = leaf_ != nullptr ? leaf_->n_ - 1 : 0;
+            }
+            
+            return *this;
+        }
+        
+        /**
+         * @brief       Allows knowing whether the two iterators are the same.
+         * @param       rhs : The value to compare.
+         * @return      If function was successful true is returned, otherwise false is returned.
+         */
+        bool operator ==(const self_type& rhs) const noexcept override
+        {
+            return leaf_ == rhs.leaf_ && idx_ == rhs.idx_;
+        }
+        
+        /**
+         * @brief       Allows knowing whether the iterator is past-the-end or not.
+         * @return      If function was successful true is returned, otherwise false is returned.
+         */
+        bool end() const noexcept override
+        {
+            return leaf_ == nullptr;
+        }
+        
+        /**
+         * @brief       Get the reference of the current node value.
+         * @return      The reference of the current node value.
+         */
+        const value_type& operator *() const override
+        {
+            return b_plus_tree::get_value(leaf_, idx_);
+        }
+        
+        /**
+         * @brief       Get the address of the current node value.
+         * @return      The address of the current node value.
+         */
+        const value_type* operator ->() const override
+        {
+            return &b_plus_tree::get_value(leaf_, idx_);
+        }
+        
+        /**
+         * @brief       Get the key of the current node.
+         * @return      The key of the current node.
+         */
+        const key_type& key() const noexcept
+        {
+            return leaf_->keys_[idx_];
+        }
+        
+        template<
+                typename TpKey__,
+                typename TpMapped__,
+                typename TpCompare__,
+                std::size_t NODE_SIZE__,
+                typename TpAllocator__
+        >
+        friend class b_plus_tree;
+    
+    protected:
+        /** The tree in which iterate. */
+        const b_plus_tree* tre_;
+        
+        /** The current leaf. */
+        leaf_node* leaf_;
+        
+        /** The current index in the leaf. */
+        std::size_t idx_;
+    };
+    
+    /**
+     * @brief       Class that represents iterators.
+     */
+    class iterator : public i_const_mutable_iterator<value_type, const_iterator, iterator>
+    {
+    public:
+        /** The class itself. */
+        using self_type = iterator;
+        
+        /** The const iterator base. */
+        using const_self_type = const_iterator;
+        
+        /** The base class. */
+        using base_type = i_const_mutable_iterator<value_type, const_iterator, iterator>;
+        
+        /** The node iteration type. */
+        using node_type = leaf_node;
+        
+        /**
+         * @brief       Default constructor.
+         */
+        iterator() = default;
+        
+        /**
+         * @brief       Constructor with parameters.
+         * @param       tre : The tree in which iterate.
+         * @param       leaf : The current leaf.
+         * @param       idx : The current index in the leaf.
+         */
+        iterator(const b_plus_tree* tre, leaf_node* leaf, std::size_t idx) noexcept
+                : base_type(tre, leaf, idx)
+        {
+        }
+        
+        /**
+         * @brief       Move to the forward node.
+         * @return      A reference to an iterator pointing the current node.
+         */
+        self_type& operator ++() override
+        {
+            const_self_type::operator ++();
+            
+            return *this;
+        }
+        
+        /**
+         * @brief       Move to the backward node.
+         * @return      A reference to an iterator pointing the current node.
+         */
+        self_type& operator --() override
+        {
+            const_self_type::operator --();
+            
+            return *this;
+        }
+        
+        /**
+         * @brief       Allows knowing whether the two iterators are the same.
+         * @param       rhs : The value to compare.
+         * @return      If function was successful true is returned, otherwise false is returned.
+         */
+        bool operator ==(const self_type& rhs) const noexcept override
+        {
+            return const_self_type::operator ==(rhs);
+        }
+        
+        /**
+         * @brief       Allows knowing whether the iterator is past-the-end or not.
+         * @return      If function was successful true is returned, otherwise false is returned.
+         */
+        bool end() const noexcept override
+        {
+            return const_self_type::end();
+        }
+        
+        /**
+         * @brief       Get the reference of the current node value.
+         * @return      The reference of the current node value.
+         */
+        value_type& operator *() override
+        {
+            return b_plus_tree::get_value(const_self_type::leaf_, const_self_type::idx_);
+        }
+        
+        /**
+         * @brief       Get the address of the current node value.
+         * @return      The address of the current node value.
+         */
+        value_type* operator ->() override
+        {
+            return &b_plus_tree::get_value(const_self_type::leaf_, const_self_type::idx_);
+        }
+        
+        template<
+                typename TpKey__,
+                typename TpMapped__,
+                typename TpCompare__,
+                std::size_t NODE_SIZE__,
+                typename TpAllocator__
+        >
+        friend class b_plus_tree;
+    };
+    
+    /**
+     * @brief       Default constructor.
+     * @param       comp : The comparator.
+     */
+    explicit b_plus_tree(const compare_type& comp = compare_type())
+            : root_(nullptr)
+            , fir_leaf_(nullptr)
+            , lst_leaf_(nullptr)
+            , sz_(0)
+            , comp_(comp)
+            , leaf_alloctr_()
+            , inner_alloctr_()
+    {
+    }
+    
+    /**
+     * @brief       Copy constructor. The nodes are cloned one by one, so the copy has the same
+     *              shape as the original.
+     * @param       rhs : The object to copy.
+     */
+    b_plus_tree(const b_plus_tree& rhs)
+            : root_(nullptr)
+            , fir_leaf_(nullptr)
+            , lst_leaf_(nullptr)
+            , sz_(0)
+            , comp_(rhs.comp_)
+            , leaf_alloctr_(rhs.leaf_alloctr_)
+            , inner_alloctr_(rhs.inner_alloctr_)
+    {
+        if (rhs.root_ != nullptr)
+        {
+            root_ = copy_node(rhs.root_);
+            sz_ = rhs.sz_;
+        }
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    b_plus_tree(b_plus_tree&& rhs) noexcept
+            : root_(rhs.root_)
+            , fir_leaf_(rhs.fir_leaf_)
+            , lst_leaf_(rhs.lst_leaf_)
+            , sz_(rhs.sz_)
+            , comp_(std::move(rhs.comp_))
+            , leaf_alloctr_(std::move(rhs.leaf_alloctr_))
+            , inner_alloctr_(std::move(rhs.inner_alloctr_))
+    {
+        rhs.root_ = nullptr;
+        rhs.fir_leaf_ = nullptr;
+        rhs.lst_leaf_ = nullptr;
+        rhs.sz_ = 0;
+    }
+    
+    /**
+     * @brief       Destructor.
+     */
+    ~b_plus_tree()
+    {
+        clear();
+    }
+    
+    /**
+     * @brief       Copy assignment operator.
+     * @param       rhs : The object to copy.
+     * @return      The object who call the method.
+     */
+    b_plus_tree& operator =(const b_plus_tree& rhs)
+    {
+        if (this != &rhs)
+        {
+            *this = b_plus_tree(rhs);
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    b_plus_tree& operator =(b_plus_tree&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            clear();
+            root_ = rhs.root_;
+            fir_leaf_ = rhs.fir_leaf_;
+            lst_leaf_ = rhs.lst_leaf_;
+            sz_ = rhs.sz_;
+            comp_ = std::move(rhs.comp_);
+            leaf_alloctr_ = std::move(rhs.leaf_alloctr_);
+            inner_alloctr_ = std::move(rhs.inner_alloctr_);
+            rhs.root_ = nullptr;
+            rhs.fir_leaf_ = nullptr;
+            rhs.lst_leaf_ = nullptr;
+            rhs.sz_ = 0;
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Get the first element iterator of the container.
+     * @return      The first element iterator of the container.
+     */
+    inline iterator begin() noexcept
+    {
+        return iterator(this, fir_leaf_, 0);
+    }
+    
+    /**
+     * @brief       Get the first element const iterator of the container.
+     * @return      The first element const iterator of the container.
+     */
+    inline const_iterator cbegin() const noexcept
+    {
+        return const_iterator(this, fir_leaf_, 0);
+    }
+    
+    /**
+     * @brief       Get an iterator to the past-the-end element in the container.
+     * @return      An iterator to the past-the-end element in the container.
+     */
+    inline iterator end() noexcept
+    {
+        return iterator(this, nullptr, 0);
+    }
+    
+    /**
+     * @brief       Get a const iterator to the past-the-end element in the container.
+     * @return      A const iterator to the past-the-end element in the container.
+     */
+    inline const_iterator cend() const noexcept
+    {
+        return const_iterator(this, nullptr, 0);
+    }
+    
+    /**
+     * @brief       Find the element with the specified key.
+     * @param       ky : The key.
+     * @return      If function was successful an iterator to the element is returned, otherwise an
+     *              end iterator is returned.
+     */
+    iterator find(const key_type& ky) noexcept
+    {
+        iterator it = lower_bound(ky);
+        
+        if (!it.end() && comp_(ky, it.key()))
+        {
+            return end();
+        }
+        
+        return it;
+    }
+    
+    /**
+     * @brief       Find the element with the specified key.
+     * @param       ky : The key.
+     * @return      If function was successful a const iterator to the element is returned,
+     *              otherwise an end const iterator is returned.
+     */
+    const_iterator find(const key_type& ky) const noexcept
+    {
+        return const_cast<b_plus_tree&>(*this).find(ky);
+    }
+    
+    /**
+     * @brief       Check whether the container holds the specified key.
+     * @param       ky : The key.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool contains(const key_type& ky) const noexcept
+    {
+        return !find(ky).end();
+    }
+    
+    /**
+     * @brief       Get an iterator to the first element whose key does not go before the specified
+     *              key.
+     * @param       ky : The key.
+     * @return      An iterator to the first element whose key does not go before the key.
+     */
+    iterator lower_bound(const key_type& ky) noexcept
+    {
+        leaf_node* leaf = find_leaf(ky);
+        std::size_t idx;
+        
+        if (leaf == nullptr)
+        {
+            return end();
+        }
+        
+        idx = get_leaf_lower_bound(leaf, ky);
+        
+        return make_iterator(leaf, idx);
+    }
+    
+    /**
+     * @brief       Get an iterator to the first element whose key goes after the specified key.
+     * @param       ky : The key.
+     * @return      An iterator to the first element whose key goes after the key.
+     */
+    iterator upper_bound(const key_type& ky) noexcept
+    {
+        iterator it = lower_bound(ky);
+        
+        if (!it.end() && !comp_(ky, it.key()))
+        {
+            ++it;
+        }
+        
+        return it;
+    }
+    
+    /**
+     * @brief       Call a function for every element whose key is in [lo, hi). The leaves are
+     *              scanned sequentially.
+     * @param       lo : The first key of the range.
+     * @param       hi : The past-the-end key of the range.
+     * @param       fnc : The function to call with the key and the value of each element.
+     * @return      The number of elements visited.
+     */
+    template<typename TpFunction>
+    std::size_t for_each_in_range(const key_type& lo, const key_type& hi, TpFunction&& fnc)
+    {
+        leaf_node* leaf = find_leaf(lo);
+        std::size_t idx;
+        std::size_t cnt = 0;
+        
+        if (leaf == nullptr)
+        {
+            return 0;
+        }
+        
+        for (idx = get_leaf_lower_bound(leaf, lo); leaf != nullptr; leaf = leaf->nxt_, idx = 0)
+        {
+            for (; idx < leaf->n_; ++idx)
+            {
+                if (!comp_(leaf->keys_[idx], hi))
+                {
+                    return cnt;
+                }
+                
+                fnc(leaf->keys_[idx], get_value(leaf, idx));
+                ++cnt;
+            }
+        }
+        
+        return cnt;
+    }
+    
+    /**
+     * @brief       Erase the element with the specified key.
+     * @param       ky : The key.
+     * @return      If an element has been erased true is returned, otherwise false is returned.
+     */
+    bool erase(const key_type& ky)
+    {
+        inner_node* old_root;
+        
+        if (root_ == nullptr || !erase_from_node(root_, ky))
+        {
+            return false;
+        }
+        
+        --sz_;
+        
+        if (root_->is_leaf_)
+        {
+            if (root_->n_ == 0)
+            {
+                destroy_leaf(static_cast<leaf_node*>(root_));
+                root_ = nullptr;
+                fir_leaf_ = nullptr;
+                lst_leaf_ = nullptr;
+            }
+        }
+        else if (root_->n_ == 0)
+        {
+            old_root = static_cast<inner_node*>(root_);
+            root_ = old_root->chlds_[0];
+            destroy_inner(old_root);
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Erase all the elements.
+     */
+    void clear() noexcept
+    {
+        if (root_ != nullptr)
+        {
+            destroy_node(root_);
+        }
+        
+        root_ = nullptr;
+        fir_leaf_ = nullptr;
+        lst_leaf_ = nullptr;
+        sz_ = 0;
+    }
+    
+    /**
+     * @brief       Check whether the container is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return sz_ == 0;
+    }
+    
+    /**
+     * @brief       Get the container size.
+     * @return      The container size.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return sz_;
+    }
+    
+    /**
+     * @brief       Get the number of levels of the tree.
+     * @return      The number of levels of the tree.
+     */
+    [[nodiscard]] std::size_t get_depth() const noexcept
+    {
+        const node_base* cur = root_;
+        std::size_t dpth = 0;
+        
+        for (; cur != nullptr; ++dpth)
+        {
+            cur = cur->is_leaf_ ? nullptr : static_cast<const inner_node*>(cur)->chlds_[0];
+        }
+        
+        return dpth;
+    }
+
+protected:
+    /**
+     * @brief       Find the position of a key and insert it if it is not in the tree. The value of
+     *              a new element is value-initialized.
+     * @param       ky : The key.
+     * @param       insertd : Set to true if the key has been inserted, otherwise set to false.
+     * @return      An iterator to the element with the key.
+     */
+    template<typename TpKey_>
+    iterator find_or_insert(TpKey_&& ky, bool* insertd)
+    {
+        node_base* splt_nod = nullptr;
+        key_type splt_ky;
+        leaf_node* leaf;
+        std::size_t idx;
+        inner_node* new_root;
+        
+        if (root_ == nullptr)
+        {
+            leaf = create_leaf();
+            root_ = leaf;
+            fir_leaf_ = leaf;
+            lst_leaf_ = leaf;
+        }
+        
+        *insertd = insert_in_node(root_, std::forward<TpKey_>(ky), &leaf, &idx, &splt_ky,
+                                  &splt_nod);
+        
+        if (splt_nod != nullptr)
+        {
+            new_root = create_inner();
+            new_root->keys_[0] = std::move(splt_ky);
+            new_root->chlds_[0] = root_;
+            new_root->chlds_[1] = splt_nod;
+            new_root->n_ = 1;
+            root_ = new_root;
+        }
+        
+        if (*insertd)
+        {
+            ++sz_;
+        }
+        
+        return iterator(this, leaf, idx);
+    }
+    
+    /**
+     * @brief       Replace the contents of the tree with a sorted sequence. The leaves are filled
+     *              directly and the inner levels are built bottom-up, without any search or split.
+     * @param       sz : The number of elements.
+     * @param       get_ky : Function that gets the key of the i-th element.
+     * @param       set_val : Function that stores the value of the i-th element in a leaf slot.
+     * @throw       speed::containers::insertion_exception : If the keys are not strictly sorted
+     *              an exception is thrown.
+     */
+    template<typename TpGetKey, typename TpSetValue>
+    void build_from_sorted(std::size_t sz, TpGetKey&& get_ky, TpSetValue&& set_val)
+    {
+        std::size_t nbr_nods;
+        std::size_t nbr_chlds;
+        std::size_t i;
+        std::size_t j;
+        std::size_t k;
+        std::size_t cnt;
+        leaf_node* leaf;
+        leaf_node* prev_leaf = nullptr;
+        inner_node* inner;
+        
+        clear();
+        
+        if (sz == 0)
+        {
+            return;
+        }
+        
+        for (i = 1; i < sz; ++i)
+        {
+            if (!comp_(get_ky(i - 1), get_ky(i)))
+            {
+                throw insertion_exception();
+            }
+        }
+        
+        nbr_nods = (sz + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+        std::unique_ptr<node_base*[]> lvl(new node_base*[nbr_nods]);
+        std::unique_ptr<key_type[]> lvl_kys(new key_type[nbr_nods]);
+        std::vector<inner_node*> inners;
+        
+        for (i = 0, j = nbr_nods; j > 1; i += j)
+        {
+            j = (j + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+        }
+        
+        inners.reserve(i);
+        
+        try
+        {
+            for (i = 0, k = 0; i < nbr_nods; ++i)
+            {
+                cnt = sz / nbr_nods + (i < sz % nbr_nods ? 1 : 0);
+                leaf = create_leaf();
+                
+                for (j = 0; j < cnt; ++j, ++k)
+                {
+                    leaf->keys_[j] = get_ky(k);
+                    set_val(leaf, j, k);
+                }
+                
+                leaf->n_ = cnt;
+                leaf->prev_ = prev_leaf;
+                
+                if (prev_leaf != nullptr)
+                {
+                    prev_leaf->nxt_ = leaf;
+                }
+                else
+                {
+                    fir_leaf_ = leaf;
+                }
+                
+                prev_leaf = leaf;
+                lst_leaf_ = leaf;
+                lvl[i] = leaf;
+                lvl_kys[i] = leaf->keys_[0];
+                root_ = leaf;
+            }
+            
+            while (nbr_nods > 1)
+            {
+                nbr_chlds = nbr_nods;
+                nbr_nods = (nbr_chlds + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+                
+                for (i = 0, k = 0; i < nbr_nods; ++i)
+                {
+                    cnt = nbr_chlds / nbr_nods + (i < nbr_chlds % nbr_nods ? 1 : 0);
+                    inner = create_inner();
+                    inners.push_back(inner);
+                    inner->chlds_[0] = lvl[k];
+                    
+                    for (j = 1; j < cnt; ++j)
+                    {
+                        inner->keys_[j - 1] = std::move(lvl_kys[k + j]);
+                        inner->chlds_[j] = lvl[k + j];
+                    }
+                    
+                    inner->n_ = cnt - 1;
+                    lvl_kys[i] = std::move(lvl_kys[k]);
+                    lvl[i] = inner;
+                    k += cnt;
+                }
+                
+                root_ = lvl[0];
+            }
+        }
+        catch (...)
+        {
+            for (auto& x : inners)
+            {
+                destroy_inner(x);
+            }
+            
+            for (leaf = fir_leaf_; leaf != nullptr; leaf = prev_leaf)
+            {
+                prev_leaf = leaf->nxt_;
+                destroy_leaf(leaf);
+            }
+            
+            root_ = nullptr;
+            fir_leaf_ = nullptr;
+            lst_leaf_ = nullptr;
+            
+            throw;
+        }
+        
+        sz_ = sz;
+    }
+    
+    /**
+     * @brief       Get the value stored in a leaf slot.
+     * @param       leaf : The leaf.
+     * @param       idx : The slot index.
+     * @return      The value stored in the slot.
+     */
+    static value_type& get_value(leaf_node* leaf, std::size_t idx) noexcept
+    {
+        if constexpr (IS_SET)
+        {
+            return leaf->keys_[idx];
+        }
+        else
+        {
+            return leaf->vals_[idx];
+        }
+    }
+    
+    /**
+     * @brief       Build an iterator normalizing a past-the-end slot of a leaf.
+     * @param       leaf : The leaf.
+     * @param       idx : The slot index.
+     * @return      The iterator.
+     */
+    iterator make_iterator(leaf_node* leaf, std::size_t idx) noexcept
+    {
+        if (idx >= leaf->n_)
+        {
+            return iterator(this, leaf->nxt_, 0);
+        }
+        
+        return iterator(this, leaf, idx);
+    }
+    
+    /**
+     * @brief       Get the leaf in which a key is or would be.
+     * @param       ky : The key.
+     * @return      The leaf, or nullptr if the tree is empty.
+     */
+    leaf_node* find_leaf(const key_type& ky) const noexcept
+    {
+        node_base* cur = root_;
+        inner_node* inner;
+        
+        if (cur == nullptr)
+        {
+            return nullptr;
+        }
+        
+        while (!cur->is_leaf_)
+        {
+            inner = static_cast<inner_node*>(cur);
+            cur = inner->chlds_[get_inner_upper_bound(inner, ky)];
+        }
+        
+        return static_cast<leaf_node*>(cur);
+    }
+    
+    /**
+     * @brief       Get the index of the first key of a leaf that does not go before a key.
+     * @param       leaf : The leaf.
+     * @param       ky : The key.
+     * @return      The index.
+     */
+    std::size_t get_leaf_lower_bound(const leaf_node* leaf, const key_type& ky) const noexcept
+    {
+        std::size_t lo = 0;
+        std::size_t hi = leaf->n_;
+        std::size_t mid;
+        
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            
+            if (comp_(leaf->keys_[mid], ky))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        
+        return lo;
+    }
+    
+    /**
+     * @brief       Get the child of an inner node in which a key is or would be.
+     * @param       inner : The inner node.
+     * @param       ky : The key.
+     * @return      The child index.
+     */
+    std::size_t get_inner_upper_bound(const inner_node* inner, const key_type& ky) const noexcept
+    {
+        std::size_t lo = 0;
+        std::size_t hi = inner->n_;
+        std::size_t mid;
+        
+        while (lo < hi)
+        {
+            mid = (lo + hi) / 2;
+            
+            if (comp_(ky, inner->keys_[mid]))
+            {
+                hi = mid;
+            }
+            else
+            {
+                lo = mid + 1;
+            }
+        }
+        
+        return lo;
+    }
+    
+    /**
+     * @brief       Insert a key in a subtree.
+     * @param       nod : The subtree root.
+     * @param       ky : The key.
+     * @param       res_leaf : The leaf in which the key is.
+     * @param       res_idx : The leaf index in which the key is.
+     * @param       splt_ky : If the node splits, the first key of the new node.
+     * @param       splt_nod : If the node splits, the new node. Otherwise it is left untouched.
+     * @return      If the key has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_>
+    bool insert_in_node(
+            node_base* nod,
+            TpKey_&& ky,
+            leaf_node** res_leaf,
+            std::size_t* res_idx,
+            key_type* splt_ky,
+            node_base** splt_nod
+    )
+    {
+        if (nod->is_leaf_)
+        {
+            return insert_in_leaf(static_cast<leaf_node*>(nod), std::forward<TpKey_>(ky),
+                                  res_leaf, res_idx, splt_ky, splt_nod);
+        }
+        
+        inner_node* inner = static_cast<inner_node*>(nod);
+        const std::size_t pos = get_inner_upper_bound(inner, ky);
+        node_base* chld_splt_nod = nullptr;
+        key_type chld_splt_ky;
+        bool insertd;
+        
+        insertd = insert_in_node(inner->chlds_[pos], std::forward<TpKey_>(ky), res_leaf, res_idx,
+                                 &chld_splt_ky, &chld_splt_nod);
+        
+        if (chld_splt_nod != nullptr)
+        {
+            insert_in_inner(inner, pos, std::move(chld_splt_ky), chld_splt_nod, splt_ky,
+                            splt_nod);
+        }
+        
+        return insertd;
+    }
+    
+    /**
+     * @brief       Insert a key in a leaf, splitting it if it is full.
+     * @param       leaf : The leaf.
+     * @param       ky : The key.
+     * @param       res_leaf : The leaf in which the key is.
+     * @param       res_idx : The leaf index in which the key is.
+     * @param       splt_ky : If the leaf splits, the first key of the new leaf.
+     * @param       splt_nod : If the leaf splits, the new leaf.
+     * @return      If the key has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_>
+    bool insert_in_leaf(
+            leaf_node* leaf,
+            TpKey_&& ky,
+            leaf_node** res_leaf,
+            std::size_t* res_idx,
+            key_type* splt_ky,
+            node_base** splt_nod
+    )
+    {
+        std::size_t pos = get_leaf_lower_bound(leaf, ky);
+        leaf_node* new_leaf;
+        std::size_t half;
+        
+        if (pos < leaf->n_ && !comp_(ky, leaf->keys_[pos]))
+        {
+            *res_leaf = leaf;
+            *res_idx = pos;
+            return false;
+        }
+        
+        if (leaf->n_ == LEAF_CAPACITY)
+        {
+            new_leaf = create_leaf();
+            half = LEAF_CAPACITY / 2;
+            
+            move_leaf_slots(leaf, half, new_leaf, 0, LEAF_CAPACITY - half);
+            new_leaf->n_ = LEAF_CAPACITY - half;
+            leaf->n_ = half;
+            
+            new_leaf->nxt_ = leaf->nxt_;
+            new_leaf->prev_ = leaf;
+            
+            if (leaf->nxt_ != nullptr)
+            {
+                leaf->nxt_->prev_ = new_leaf;
+            }
+            else
+            {
+                lst_leaf_ = new_leaf;
+            }
+            
+            leaf->nxt_ = new_leaf;
+            
+            if (pos > half)
+            {
+                leaf = new_leaf;
+                pos -= half;
+            }
+            
+            *splt_nod = new_leaf;
+        }
+        
+        shift_leaf_slots_right(leaf, pos);
+        leaf->keys_[pos] = std::forward<TpKey_>(ky);
+        
+        if constexpr (!IS_SET)
+        {
+            leaf->vals_[pos] = value_type();
+        }
+        
+        ++leaf->n_;
+        
+        if (*splt_nod != nullptr)
+        {
+            *splt_ky = static_cast<leaf_node*>(*splt_nod)->keys_[0];
+        }
+        
+        *res_leaf = leaf;
+        *res_idx = pos;
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Insert a separator and a child in an inner node, splitting it if it is full.
+     * @param       inner : The inner node.
+     * @param       pos : The index of the child that has been split.
+     * @param       ky : The separator key.
+     * @param       chld : The new child.
+     * @param       splt_ky : If the node splits, the key that goes up.
+     * @param       splt_nod : If the node splits, the new node.
+     */
+    void insert_in_inner(
+            inner_node* inner,
+            std::size_t pos,
+            key_type&& ky,
+            node_base* chld,
+            key_type* splt_ky,
+            node_base** splt_nod
+    )
+    {
+        key_type tmp_kys[INNER_CAPACITY + 1];
+        node_base* tmp_chlds[INNER_CAPACITY + 2];
+        inner_node* new_inner;
+        std::size_t half;
+        std::size_t i;
+        
+        if (inner->n_ < INNER_CAPACITY)
+        {
+            for (i = inner->n_; i > pos; --i)
+            {
+                inner->keys_[i] = std::move(inner->keys_[i - 1]);
+                inner->chlds_[i + 1] = inner->chlds_[i];
+            }
+            
+            inner->keys_[pos] = std::move(ky);
+            inner->chlds_[pos + 1] = chld;
+            ++inner->n_;
+            
+            return;
+        }
+        
+        for (i = 0; i < pos; ++i)
+        {
+            tmp_kys[i] = std::move(inner->keys_[i]);
+        }
+        
+        tmp_kys[pos] = std::move(ky);
+        
+        for (i = pos; i < INNER_CAPACITY; ++i)
+        {
+            tmp_kys[i + 1] = std::move(inner->keys_[i]);
+        }
+        
+        for (i = 0; i <= pos; ++i)
+        {
+            tmp_chlds[i] = inner->chlds_[i];
+        }
+        
+        tmp_chlds[pos + 1] = chld;
+        
+        for (i = pos + 1; i <= INNER_CAPACITY; ++i)
+        {
+            tmp_chlds[i + 1] = inner->chlds_[i];
+        }
+        
+        new_inner = create_inner();
+        half = (INNER_CAPACITY + 1) / 2;
+        
+        for (i = 0; i < half; ++i)
+        {
+            inner->keys_[i] = std::move(tmp_kys[i]);
+            inner->chlds_[i] = tmp_chlds[i];
+        }
+        
+        inner->chlds_[half] = tmp_chlds[half];
+        inner->n_ = half;
+        *splt_ky = std::move(tmp_kys[half]);
+        
+        for (i = half + 1; i <= INNER_CAPACITY; ++i)
+        {
+            new_inner->keys_[i - half - 1] = std::move(tmp_kys[i]);
+            new_inner->chlds_[i - half - 1] = tmp_chlds[i];
+        }
+        
+        new_inner->chlds_[INNER_CAPACITY - half] = tmp_chlds[INNER_CAPACITY + 1];
+        new_inner->n_ = INNER_CAPACITY - half;
+        *splt_nod = new_inner;
+    }
+    
+    /**
+     * @brief       Erase a key from a subtree, rebalancing the children that underflow.
+     * @param       nod : The subtree root.
+     * @param       ky : The key.
+     * @return      If the key has been erased true is returned, otherwise false is returned.
+     */
+    bool erase_from_node(node_base* nod, const key_type& ky)
+    {
+        if (nod->is_leaf_)
+        {
+            leaf_node* leaf = static_cast<leaf_node*>(nod);
+            std::size_t pos = get_leaf_lower_bound(leaf, ky);
+            
+            if (pos >= leaf->n_ || comp_(ky, leaf->keys_[pos]))
+            {
+                return false;
+            }
+            
+            move_leaf_slots(leaf, pos + 1, leaf, pos, leaf->n_ - pos - 1);
+            --leaf->n_;
+            
+            return true;
+        }
+        
+        inner_node* inner = static_cast<inner_node*>(nod);
+        const std::size_t pos = get_inner_upper_bound(inner, ky);
+        
+        if (!erase_from_node(inner->chlds_[pos], ky))
+        {
+            return false;
+        }
+        
+        if (inner->chlds_[pos]->is_leaf_)
+        {
+            if (inner->chlds_[pos]->n_ < LEAF_CAPACITY / 2)
+            {
+                rebalance_leaf(inner, pos);
+            }
+        }
+        else if (inner->chlds_[pos]->n_ < INNER_CAPACITY / 2)
+        {
+            rebalance_inner(inner, pos);
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Fix an underflowed leaf borrowing from or merging with a sibling.
+     * @param       parnt : The parent of the leaf.
+     * @param       pos : The leaf index in the parent.
+     */
+    void rebalance_leaf(inner_node* parnt, std::size_t pos)
+    {
+        leaf_node* leaf = static_cast<leaf_node*>(parnt->chlds_[pos]);
+        leaf_node* lft = pos > 0 ? static_cast<leaf_node*>(parnt->chlds_[pos - 1]) : nullptr;
+        leaf_node* rgt = pos < parnt->n_ ? static_cast<leaf_node*>(parnt->chlds_[pos + 1])
+                                         : nullptr;
+        
+        if (lft != nullptr && lft->n_ > LEAF_CAPACITY / 2)
+        {
+            shift_leaf_slots_right(leaf, 0);
+            move_leaf_slots(lft, lft->n_ - 1, leaf, 0, 1);
+            --lft->n_;
+            ++leaf->n_;
+            parnt->keys_[pos - 1] = leaf->keys_[0];
+        }
+        else if (rgt != nullptr && rgt->n_ > LEAF_CAPACITY / 2)
+        {
+            move_leaf_slots(rgt, 0, leaf, leaf->n_, 1);
+            move_leaf_slots(rgt, 1, rgt, 0, rgt->n_ - 1);
+            --rgt->n_;
+            ++leaf->n_;
+            parnt->keys_[pos] = rgt->keys_[0];
+        }
+        else if (lft != nullptr)
+        {
+            merge_leaves(parnt, pos - 1);
+        }
+        else if (rgt != nullptr)
+        {
+            merge_leaves(parnt, pos);
+        }
+    }
+    
+    /**
+     * @brief       Merge the child pos + 1 of an inner node into the child pos. Both are leaves.
+     * @param       parnt : The parent of the leaves.
+     * @param       pos : The left leaf index in the parent.
+     */
+    void merge_leaves(inner_node* parnt, std::size_t pos)
+    {
+        leaf_node* lft = static_cast<leaf_node*>(parnt->chlds_[pos]);
+        leaf_node* rgt = static_cast<leaf_node*>(parnt->chlds_[pos + 1]);
+        
+        move_leaf_slots(rgt, 0, lft, lft->n_, rgt->n_);
+        lft->n_ += rgt->n_;
+        lft->nxt_ = rgt->nxt_;
+        
+        if (rgt->nxt_ != nullptr)
+        {
+            rgt->nxt_->prev_ = lft;
+        }
+        else
+        {
+            lst_leaf_ = lft;
+        }
+        
+        erase_inner_slot(parnt, pos);
+        destroy_leaf(rgt);
+    }
+    
+    /**
+     * @brief       Fix an underflowed inner node borrowing from or merging with a sibling.
+     * @param       parnt : The parent of the inner node.
+     * @param       pos : The inner node index in the parent.
+     */
+    void rebalance_inner(inner_node* parnt, std::size_t pos)
+    {
+        inner_node* inner = static_cast<inner_node*>(parnt->chlds_[pos]);
+        inner_node* lft = pos > 0 ? static_cast<inner_node*>(parnt->chlds_[pos - 1]) : nullptr;
+        inner_node* rgt = pos < parnt->n_ ? static_cast<inner_node*>(parnt->chlds_[pos + 1])
+                                          : nullptr;
+        std::size_t i;
+        
+        if (lft != nullptr && lft->n_ > INNER_CAPACITY / 2)
+        {
+            inner->chlds_[inner->n_ + 1] = inner->chlds_[inner->n_];
+            
+            for (i = inner->n_; i > 0; --i)
+            {
+                inner->keys_[i] = std::move(inner->keys_[i - 1]);
+                inner->chlds_[i] = inner->chlds_[i - 1];
+            }
+            
+            inner->keys_[0] = std::move(parnt->keys_[pos - 1]);
+            inner->chlds_[0] = lft->chlds_[lft->n_];
+            parnt->keys_[pos - 1] = std::move(lft->keys_[lft->n_ - 1]);
+            --lft->n_;
+            ++inner->n_;
+        }
+        else if (rgt != nullptr && rgt->n_ > INNER_CAPACITY / 2)
+        {
+            inner->keys_[inner->n_] = std::move(parnt->keys_[pos]);
+            inner->chlds_[inner->n_ + 1] = rgt->chlds_[0];
+            parnt->keys_[pos] = std::move(rgt->keys_[0]);
+            
+            for (i = 1; i < rgt->n_; ++i)
+            {
+                rgt->keys_[i - 1] = std::move(rgt->keys_[i]);
+                rgt->chlds_[i - 1] = rgt->chlds_[i];
+            }
+            
+            rgt->chlds_[rgt->n_ - 1] = rgt->chlds_[rgt->n_];
+            --rgt->n_;
+            ++inner->n_;
+        }
+        else if (lft != nullptr)
+        {
+            merge_inners(parnt, pos - 1);
+        }
+        else if (rgt != nullptr)
+        {
+            merge_inners(parnt, pos);
+        }
+    }
+    
+    /**
+     * @brief       Merge the child pos + 1 of an inner node into the child pos. Both are inner
+     *              nodes.
+     * @param       parnt : The parent of the inner nodes.
+     * @param       pos : The left inner node index in the parent.
+     */
+    void merge_inners(inner_node* parnt, std::size_t pos)
+    {
+        inner_node* lft = static_cast<inner_node*>(parnt->chlds_[pos]);
+        inner_node* rgt = static_cast<inner_node*>(parnt->chlds_[pos + 1]);
+        std::size_t i;
+        
+        lft->keys_[lft->n_] = std::move(parnt->keys_[pos]);
+        
+        for (i = 0; i < rgt->n_; ++i)
+        {
+            lft->keys_[lft->n_ + 1 + i] = std::move(rgt->keys_[i]);
+            lft->chlds_[lft->n_ + 1 + i] = rgt->chlds_[i];
+        }
+        
+        lft->chlds_[lft->n_ + 1 + rgt->n_] = rgt->chlds_[rgt->n_];
+        lft->n_ += rgt->n_ + 1;
+        
+        erase_inner_slot(parnt, pos);
+        destroy_inner(rgt);
+    }
+    
+    /**
+     * @brief       Erase the separator pos and the child pos + 1 of an inner node.
+     * @param       inner : The inner node.
+     * @param       pos : The separator index.
+     */
+    void erase_inner_slot(inner_node* inner, std::size_t pos) noexcept
+    {
+        for (std::size_t i = pos + 1; i < inner->n_; ++i)
+        {
+            inner->keys_[i - 1] = std::move(inner->keys_[i]);
+            inner->chlds_[i] = inner->chlds_[i + 1];
+        }
+        
+        --inner->n_;
+    }
+    
+    /**
+     * @brief       Move a group of slots between two leaves, or inside the same leaf towards the
+     *              beginning.
+     * @param       src : The source leaf.
+     * @param       src_idx : The first source slot.
+     * @param       dest : The destination leaf.
+     * @param       dest_idx : The first destination slot.
+     * @param       cnt : The number of slots to move.
+     */
+    static void move_leaf_slots(
+            leaf_node* src,
+            std::size_t src_idx,
+            leaf_node* dest,
+            std::size_t dest_idx,
+            std::size_t cnt
+    ) noexcept
+    {
+        for (std::size_t i = 0; i < cnt; ++i)
+        {
+            dest->keys_[dest_idx + i] = std::move(src->keys_[src_idx + i]);
+            
+            if constexpr (!IS_SET)
+            {
+                dest->vals_[dest_idx + i] = std::move(src->vals_[src_idx + i]);
+            }
+        }
+    }
+    
+    /**
+     * @brief       Open a free slot in a leaf moving the following slots one position.
+     * @param       leaf : The leaf.
+     * @param       pos : The slot to free.
+     */
+    static void shift_leaf_slots_right(leaf_node* leaf, std::size_t pos) noexcept
+    {
+        for (std::size_t i = leaf->n_; i > pos; --i)
+        {
+            leaf->keys_[i] = std::move(leaf->keys_[i - 1]);
+            
+            if constexpr (!IS_SET)
+            {
+                leaf->vals_[i] = std::move(leaf->vals_[i - 1]);
+            }
+        }
+    }
+    
+    /**
+     * @brief       Allocate an empty leaf.
+     * @return      The new leaf.
+     */
+    leaf_node* create_leaf()
+    {
+        leaf_node* leaf = leaf_alloctr_.allocate(1);
+        
+        try
+        {
+            ::new (static_cast<void*>(leaf)) leaf_node();
+        }
+        catch (...)
+        {
+            leaf_alloctr_.deallocate(leaf, 1);
+            throw;
+        }
+        
+        leaf->is_leaf_ = true;
+        leaf->n_ = 0;
+        leaf->prev_ = nullptr;
+        leaf->nxt_ = nullptr;
+        
+        return leaf;
+    }
+    
+    /**
+     * @brief       Allocate an empty inner node.
+     * @return      The new inner node.
+     */
+    inner_node* create_inner()
+    {
+        inner_node* inner = inner_alloctr_.allocate(1);
+        
+        try
+        {
+            ::new (static_cast<void*>(inner)) inner_node();
+        }
+        catch (...)
+        {
+            inner_alloctr_.deallocate(inner, 1);
+            throw;
+        }
+        
+        inner->is_leaf_ = false;
+        inner->n_ = 0;
+        
+        return inner;
+    }
+    
+    /**
+     * @brief       Destroy and deallocate a leaf.
+     * @param       leaf : The leaf.
+     */
+    void destroy_leaf(leaf_node* leaf) noexcept
+    {
+        leaf->~leaf_node();
+        leaf_alloctr_.deallocate(leaf, 1);
+    }
+    
+    /**
+     * @brief       Destroy and deallocate an inner node.
+     * @param       inner : The inner node.
+     */
+    void destroy_inner(inner_node* inner) noexcept
+    {
+        inner->~inner_node();
+        inner_alloctr_.deallocate(inner, 1);
+    }
+    
+    /**
+     * @brief       Destroy a subtree.
+     * @param       nod : The subtree root.
+     */
+    void destroy_node(node_base* nod) noexcept
+    {
+        if (nod->is_leaf_)
+        {
+            destroy_leaf(static_cast<leaf_node*>(nod));
+            return;
+        }
+        
+        inner_node* inner = static_cast<inner_node*>(nod);
+        
+        for (std::size_t i = 0; i <= inner->n_; ++i)
+        {
+            destroy_node(inner->chlds_[i]);
+        }
+        
+        destroy_inner(inner);
+    }
+    
+    /**
+     * @brief       Clone a subtree of another tree. The cloned leaves are appended to the chain of
+     *              leaves of the tree.
+     * @param       nod : The subtree root in the other tree.
+     * @return      The root of the clone.
+     */
+    node_base* copy_node(const node_base* nod)
+    {
+        if (nod->is_leaf_)
+        {
+            const auto* src = static_cast<const leaf_node*>(nod);
+            leaf_node* leaf = create_leaf();
+            
+            try
+            {
+                for (std::size_t i = 0; i < src->n_; ++i)
+                {
+                    leaf->keys_[i] = src->keys_[i];
+                    
+                    if constexpr (!IS_SET)
+                    {
+                        leaf->vals_[i] = src->vals_[i];
+                    }
+                }
+            }
+            catch (...)
+            {
+                destroy_leaf(leaf);
+                throw;
+            }
+            
+            leaf->n_ = src->n_;
+            leaf->prev_ = lst_leaf_;
+            
+            if (lst_leaf_ != nullptr)
+            {
+                lst_leaf_->nxt_ = leaf;
+            }
+            else
+            {
+                fir_leaf_ = leaf;
+            }
+            
+            lst_leaf_ = leaf;
+            
+            return leaf;
+        }
+        
+        const auto* src = static_cast<const inner_node*>(nod);
+        inner_node* inner = create_inner();
+        std::size_t nbr_chlds = 0;
+        
+        try
+        {
+            for (std::size_t i = 0; i < src->n_; ++i)
+            {
+                inner->keys_[i] = src->keys_[i];
+            }
+        
+            for (; nbr_chlds <= src->n_; ++nbr_chlds)
+            {
+                inner->chlds_[nbr_chlds] = copy_node(src->chlds_[nbr_chlds]);
+            }
+        }
+        catch (...)
+        {
+            for (std::size_t i = 0; i < nbr_chlds; ++i)
+            {
+                destroy_node(inner->chlds_[i]);
+            }
+            
+            destroy_inner(inner);
+            throw;
+        }
+        
+        inner->n_ = src->n_;
+        
+        return inner;
+    }
+        
+private:
+    /** The root node. */
+    node_base* root_;
+    
+    /** The first leaf. */
+    leaf_node* fir_leaf_;
+    
+    /** The last leaf. */
+    leaf_node* lst_leaf_;
+    
+    /** The number of elements. */
+    std::size_t sz_;
+    
+    /** The comparator. */
+    compare_type comp_;
+    
+    /** The leaves allocator. */
+    allocator_type<leaf_node> leaf_alloctr_;
+    
+    /** The inner nodes allocator. */
+    allocator_type<inner_node> inner_alloctr_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,379 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/bit_packing.hpp
+ * @brief      bit_packing functions header.
+ * @author     Killian
+ * @date       2018/09/20 - 09:48
+ */
+
+#ifndef SPEED_CONTAINERS_BIT_PACKING_HPP
+#define SPEED_CONTAINERS_BIT_PACKING_HPP
+
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__AVX2__) || defined(__BMI2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace speed {
+namespace containers {
+
+
+/** @cond */
+namespace __hidden_containers {
+
+
+/**
+ * @brief       Get the number of bits needed to hold a value.
+ * @param       val : The value.
+ * @return      The number of bits needed to hold the value, at least 1.
+ */
+constexpr std::size_t get_bit_width(std::uint64_t val) noexcept
+{
+    std::size_t bits = 1;
+    
+    while (bits < 64 && (val >> bits) != 0)
+    {
+        ++bits;
+    }
+    
+    return bits;
+}
+
+
+/**
+ * @brief       Get the mask of the low bits of a word.
+ * @param       bits : The number of bits, from 0 to 64.
+ * @return      The mask of the low bits.
+ */
+constexpr std::uint64_t get_bit_mask(std::size_t bits) noexcept
+{
+    return bits >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bits) - 1;
+}
+
+
+/**
+ * @brief       Get the number of bits set in a word.
+ * @param       wrd : The word.
+ * @return      The number of bits set in the word.
+ */
+inline std::size_t get_popcount(std::uint64_t wrd) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_popcountll(wrd));
+#else
+    std::size_t cnt = 0;
+    
+    for (; wrd != 0; wrd &= wrd - 1)
+    {
+        ++cnt;
+    }
+    
+    return cnt;
+#endif
+}
+
+
+/**
+ * @brief       Get the position of the lowest bit set in a word.
+ * @param       wrd : The word, that must not be 0.
+ * @return      The position of the lowest bit set in the word.
+ */
+inline std::size_t get_trailing_zeros(std::uint64_t wrd) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<std::size_t>(__builtin_ctzll(wrd));
+#else
+    std::size_t pos = 0;
+    
+    for (; (wrd & 1) == 0; wrd >>= 1)
+    {
+        ++pos;
+    }
+    
+    return pos;
+#endif
+}
+
+
+/**
+ * @brief       Get the position of the k-th bit set in a word.
+ * @param       wrd : The word, that must have more than k bits set.
+ * @param       k : The rank of the bit, starting at 0.
+ * @return      The position of the k-th bit set in the word.
+ */
+inline std::size_t select_in_word(std::uint64_t wrd, std::size_t k) noexcept
+{
+#ifdef __BMI2__
+    return get_trailing_zeros(_pdep_u64(std::uint64_t(1) << k, wrd));
+#else
+    for (; k > 0; --k)
+    {
+        wrd &= wrd - 1;
+    }
+    
+    return get_trailing_zeros(wrd);
+#endif
+}
+
+
+/**
+ * @brief       Get a value packed in an array of words. The array must be followed by a padding
+ *              word.
+ * @param       wrds : The words.
+ * @param       bits : The number of bits per value.
+ * @param       idx : The index of the value.
+ * @return      The value.
+ */
+inline std::uint64_t get_packed_value(
+        const std::uint64_t* wrds,
+        std::size_t bits,
+        std::size_t idx
+) noexcept
+{
+    const std::size_t bit_pos = idx * bits;
+    const std::size_t wrd_idx = bit_pos >> 6;
+    const std::size_t shft = bit_pos & 63;
+    
+    return ((wrds[wrd_idx] >> shft) | ((wrds[wrd_idx + 1] << 1) << (63 - shft))) &
+           get_bit_mask(bits);
+}
+
+
+/**
+ * @brief       Set a value packed in an array of words. Only the low bits of the value that fit
+ *              are kept.
+ * @param       wrds : The words.
+ * @param       bits : The number of bits per value.
+ * @param       idx : The index of the value.
+ * @param       val : The new value.
+ */
+inline void set_packed_value(
+        std::uint64_t* wrds,
+        std::size_t bits,
+        std::size_t idx,
+        std::uint64_t val
+) noexcept
+{
+    const std::size_t bit_pos = idx * bits;
+    const std::size_t wrd_idx = bit_pos >> 6;
+    const std::size_t shft = bit_pos & 63;
+    const std::uint64_t msk = get_bit_mask(bits);
+    
+    val &= msk;
+    wrds[wrd_idx] = (wrds[wrd_idx] & ~(msk << shft)) | (val << shft);
+    
+    if (shft + bits > 64)
+    {
+        wrds[wrd_idx + 1] = (wrds[wrd_idx + 1] & ~(msk >> (64 - shft))) | (val >> (64 - shft));
+    }
+}
+
+
+/**
+ * @brief       Copy consecutive packed values into a regular array, reading every word once. The
+ *              array of words must be followed by a padding word.
+ * @param       wrds : The words.
+ * @param       bits : The number of bits per value.
+ * @param       first : The index of the first value to copy.
+ * @param       cnt : The number of values to copy.
+ * @param       out : The destination array.
+ */
+template<typename TpIntegral>
+void unpack_values_scalar(
+        const std::uint64_t* wrds,
+        std::size_t bits,
+        std::size_t first,
+        std::size_t cnt,
+        TpIntegral* out
+) noexcept
+{
+    const std::uint64_t msk = get_bit_mask(bits);
+    std::size_t wrd_idx = (first * bits) >> 6;
+    std::size_t shft = (first * bits) & 63;
+    std::uint64_t cur;
+    std::uint64_t nxt;
+    
+    if (cnt == 0)
+    {
+        return;
+    }
+    
+    cur = wrds[wrd_idx];
+    nxt = wrds[wrd_idx + 1];
+    for (std::size_t i = 0; i < cnt; ++i)
+    {
+        if (shft >= 64)
+        {
+            shft -= 64;
+            cur = nxt;
+            nxt = wrds[++wrd_idx + 1];
+        }
+        
+        out[i] = static_cast<TpIntegral>(((cur >> shft) | ((nxt << 1) << (63 - shft))) & msk);
+        shft += bits;
+    }
+}
+
+
+#ifdef __AVX2__
+/**
+ * @brief       Copy consecutive packed values of at most 25 bits into an array of 32 bits
+ *              integers, 8 at a time. Eight values span exactly bits bytes, so the byte offset and
+ *              the shift of every lane are the same for all the groups.
+ * @param       wrds : The words.
+ * @param       bits : The number of bits per value.
+ * @param       first : The index of the first value to copy.
+ * @param       cnt : The number of values to copy.
+ * @param       out : The destination array.
+ * @return      The number of values copied, a multiple of 8.
+ */
+inline std::size_t unpack_values_avx2(
+        const std::uint64_t* wrds,
+        std::size_t bits,
+        std::size_t first,
+        std::size_t cnt,
+        std::uint32_t* out
+) noexcept
+{
+    const std::uint8_t* bytes = reinterpret_cast<const std::uint8_t*>(wrds) + ((first * bits) >> 3);
+    const std::size_t bit_ofst = (first * bits) & 7;
+    alignas(32) std::int32_t ofsts[8];
+    alignas(32) std::int32_t shfts[8];
+    std::size_t i;
+    
+    for (i = 0; i < 8; ++i)
+    {
+        ofsts[i] = static_cast<std::int32_t>((bit_ofst + i * bits) >> 3);
+        shfts[i] = static_cast<std::int32_t>((bit_ofst + i * bits) & 7);
+    }
+    
+    const __m256i ofsts_vec = _mm256_load_si256(reinterpret_cast<const __m256i*>(ofsts));
+    const __m256i shfts_vec = _mm256_load_si256(reinterpret_cast<const __m256i*>(shfts));
+    const __m256i msk = _mm256_set1_epi32(static_cast<int>(get_bit_mask(bits)));
+    __m256i vals;
+    
+    for (i = 0; i + 8 <= cnt; i += 8, bytes += bits)
+    {
+        vals = _mm256_i32gather_epi32(reinterpret_cast<const int*>(bytes), ofsts_vec, 1);
+        vals = _mm256_and_si256(_mm256_srlv_epi32(vals, shfts_vec), msk);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), vals);
+    }
+    
+    return i;
+}
+#endif
+
+
+/**
+ * @brief       Copy consecutive packed values into a regular array. The values are unpacked 8 at a
+ *              time with AVX2 when the destination holds 32 bits integers and a value has at most
+ *              25 bits. The array of words must be followed by a padding word.
+ * @param       wrds : The words.
+ * @param       bits : The number of bits per value.
+ * @param       first : The index of the first value to copy.
+ * @param       cnt : The number of values to copy.
+ * @param       out : The destination array.
+ */
+template<typename TpIntegral>
+void unpack_values(
+        const std::uint64_t* wrds,
+        std::size_t bits,
+        std::size_t first,
+        std::size_t cnt,
+        TpIntegral* out
+) noexcept
+{
+    std::size_t i = 0;
+
+#ifdef __AVX2__
+    if constexpr (sizeof(TpIntegral) == 4)
+    {
+        if (bits <= 25)
+        {
+            i = unpack_values_avx2(wrds, bits, first, cnt, reinterpret_cast<std::uint32_t*>(out));
+        }
+    }
+#endif
+
+    if (i < cnt)
+    {
+        unpack_values_scalar(wrds, bits, first + i, cnt - i, out + i);
+    }
+}
+
+
+/**
+ * @brief       Replace the deltas of an array by their prefix sums. The sums are computed 4 at a
+ *              time with SSE2 when the array holds 32 bits integers.
+ * @param       vals : The deltas, replaced by the prefix sums.
+ * @param       cnt : The number of deltas.
+ * @param       bse : The value added to all the sums.
+ */
+template<typename TpIntegral>
+void add_prefix_sums(TpIntegral* vals, std::size_t cnt, TpIntegral bse) noexcept
+{
+    std::size_t i = 0;
+
+#ifdef __SSE2__
+    if constexpr (sizeof(TpIntegral) == 4)
+    {
+        __m128i prv = _mm_set1_epi32(static_cast<int>(bse));
+        __m128i x;
+        
+        for (; i + 4 <= cnt; i += 4)
+        {
+            x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(vals + i));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+            x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+            x = _mm_add_epi32(x, prv);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(vals + i), x);
+            prv = _mm_shuffle_epi32(x, 0xff);
+        }
+        
+        if (i > 0)
+        {
+            bse = vals[i - 1];
+        }
+    }
+#endif
+
+    for (; i < cnt; ++i)
+    {
+        bse = static_cast<TpIntegral>(bse + vals[i]);
+        vals[i] = bse;
+    }
+}
+
+
+}
+/** @endcond */
+
+
+}
+}
+
+
+#endif
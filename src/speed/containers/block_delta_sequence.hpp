@@ -0,0 +1,686 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/block_delta_sequence.hpp
+ * @brief      block_delta_sequence class header.
+ * @author     Killian
+ * @date       2018/09/20 - 15:36
+ */
+
+#ifndef SPEED_CONTAINERS_BLOCK_DELTA_SEQUENCE_HPP
+#define SPEED_CONTAINERS_BLOCK_DELTA_SEQUENCE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "bit_packing.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents a read-only view over a sorted sequence of unsigned integers
+ *              split in blocks of BLOCK_SIZE elements, where every block stores the differences
+ *              between consecutive elements packed with the number of bits of its greatest
+ *              difference. The view does not own the words, so it can be placed directly over a
+ *              buffer filled by block_delta_sequence::serialize, for instance a memory mapped file.
+ */
+template<typename TpValue = std::uint64_t>
+class block_delta_view
+{
+    static_assert(std::is_unsigned<TpValue>::value, "The value type has to be unsigned");
+
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** Identifies the buffers filled by serialize. */
+    static constexpr std::uint64_t MAGIC = 0x51455341544c4544ULL;
+    
+    /** Number of words of the serialization header. */
+    static constexpr std::size_t HEADER_WORDS = 5;
+    
+    /** Number of elements in a block. */
+    static constexpr std::size_t BLOCK_SIZE = 128;
+    
+    /**
+     * @brief       Default constructor. The view is empty.
+     */
+    block_delta_view() noexcept
+            : lsts_(nullptr)
+            , infos_(nullptr)
+            , dat_(nullptr)
+            , n_(0)
+            , nbr_blks_(0)
+            , buf_sz_(0)
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters. Only the header of the buffer is checked, so the
+     *              construction does not touch the encoded elements.
+     * @param       buf : The buffer filled by block_delta_sequence::serialize. It must be aligned
+     *              on 8 bytes and outlive the view.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    block_delta_view(const void* buf, std::size_t buf_sz)
+            : block_delta_view()
+    {
+        const std::uint64_t* wrds = static_cast<const std::uint64_t*>(buf);
+        const std::size_t nbr_wrds = buf_sz / sizeof(std::uint64_t);
+        
+        if (buf == nullptr || reinterpret_cast<std::uintptr_t>(buf) % sizeof(std::uint64_t) != 0 ||
+            buf_sz % sizeof(std::uint64_t) != 0 || nbr_wrds < HEADER_WORDS ||
+            wrds[0] != MAGIC || wrds[1] != sizeof(value_type) ||
+            wrds[2] > buf_sz * 8 || wrds[3] != (wrds[2] + BLOCK_SIZE - 1) / BLOCK_SIZE ||
+            wrds[4] == 0 || nbr_wrds != HEADER_WORDS + 2 * wrds[3] + wrds[4])
+        {
+            throw deserialization_exception();
+        }
+        
+        lsts_ = wrds + HEADER_WORDS;
+        infos_ = lsts_ + wrds[3];
+        dat_ = infos_ + wrds[3];
+        n_ = static_cast<std::size_t>(wrds[2]);
+        nbr_blks_ = static_cast<std::size_t>(wrds[3]);
+        buf_sz_ = buf_sz;
+    }
+    
+    /**
+     * @brief       Get an element without bounds checking. The block of the element is decoded.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     */
+    [[nodiscard]] value_type get(std::size_t idx) const noexcept
+    {
+        value_type blk[BLOCK_SIZE];
+        
+        decode_block(idx / BLOCK_SIZE, blk);
+        
+        return blk[idx % BLOCK_SIZE];
+    }
+    
+    /**
+     * @brief       Get an element.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     * @throw       speed::containers::out_of_range_exception : If the index is not lower than the
+     *              size an exception is thrown.
+     */
+    [[nodiscard]] value_type at(std::size_t idx) const
+    {
+        if (idx >= n_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return get(idx);
+    }
+    
+    /**
+     * @brief       Get the index of the first element that is greater than or equal to a value.
+     *              The block is found by a binary search on the last elements of the blocks, so
+     *              only one block is decoded.
+     * @param       x : The value to look for.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    [[nodiscard]] std::size_t next_geq(value_type x) const noexcept
+    {
+        value_type val;
+        
+        return next_geq(x, val);
+    }
+    
+    /**
+     * @brief       Get the index and the value of the first element that is greater than or equal
+     *              to a value.
+     * @param       x : The value to look for.
+     * @param       val : Set with the element found, if any.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    std::size_t next_geq(value_type x, value_type& val) const noexcept
+    {
+        value_type blk[BLOCK_SIZE];
+        const std::uint64_t* lsts_it = std::lower_bound(lsts_, lsts_ + nbr_blks_,
+                                                        static_cast<std::uint64_t>(x));
+        
+        if (lsts_it == lsts_ + nbr_blks_)
+        {
+            return n_;
+        }
+        
+        const std::size_t blk_idx = static_cast<std::size_t>(lsts_it - lsts_);
+        const std::size_t cnt = decode_block(blk_idx, blk);
+        const std::size_t i = static_cast<std::size_t>(std::lower_bound(blk, blk + cnt, x) - blk);
+        
+        val = blk[i];
+        
+        return blk_idx * BLOCK_SIZE + i;
+    }
+    
+    /**
+     * @brief       Copy consecutive elements into a regular array.
+     * @param       first : The index of the first element to copy.
+     * @param       cnt : The number of elements to copy.
+     * @param       out : The destination array.
+     * @throw       speed::containers::out_of_range_exception : If the range exceeds the size an
+     *              exception is thrown.
+     */
+    void decode(std::size_t first, std::size_t cnt, value_type* out) const
+    {
+        value_type blk[BLOCK_SIZE];
+        std::size_t blk_idx = first / BLOCK_SIZE;
+        std::size_t ofst = first % BLOCK_SIZE;
+        std::size_t blk_cnt;
+        
+        if (first > n_ || cnt > n_ - first)
+        {
+            throw out_of_range_exception();
+        }
+        
+        for (; cnt > 0; ++blk_idx, ofst = 0)
+        {
+            if (ofst == 0 && cnt >= BLOCK_SIZE)
+            {
+                blk_cnt = decode_block(blk_idx, out);
+            }
+            else
+            {
+                blk_cnt = std::min(decode_block(blk_idx, blk) - ofst, cnt);
+                std::copy(blk + ofst, blk + ofst + blk_cnt, out);
+            }
+            
+            out += blk_cnt;
+            cnt -= blk_cnt;
+        }
+    }
+    
+    /**
+     * @brief       Decode a block. The differences are unpacked 8 at a time with AVX2 and summed 4
+     *              at a time with SSE2 when the elements are 32 bits integers.
+     * @param       blk_idx : The index of the block, lower than get_block_count().
+     * @param       out : The destination array, that must hold BLOCK_SIZE elements.
+     * @return      The number of elements of the block.
+     */
+    std::size_t decode_block(std::size_t blk_idx, value_type* out) const noexcept
+    {
+        const std::size_t cnt = std::min(BLOCK_SIZE, n_ - blk_idx * BLOCK_SIZE);
+        const std::uint64_t inf = infos_[blk_idx];
+        
+        __hidden_containers::unpack_values(dat_ + (inf >> 8), static_cast<std::size_t>(inf & 0xff),
+                                           0, cnt, out);
+        __hidden_containers::add_prefix_sums(
+                out, cnt,
+                blk_idx == 0 ? value_type(0) : static_cast<value_type>(lsts_[blk_idx - 1]));
+        
+        return cnt;
+    }
+    
+    /**
+     * @brief       Get the last element.
+     * @return      The last element, or 0 if the sequence is empty.
+     */
+    [[nodiscard]] inline value_type back() const noexcept
+    {
+        return nbr_blks_ == 0 ? value_type(0) : static_cast<value_type>(lsts_[nbr_blks_ - 1]);
+    }
+    
+    /**
+     * @brief       Get the number of blocks.
+     * @return      The number of blocks.
+     */
+    [[nodiscard]] inline std::size_t get_block_count() const noexcept
+    {
+        return nbr_blks_;
+    }
+    
+    /**
+     * @brief       Get the size in bytes of the buffer holding the sequence.
+     * @return      The size in bytes of the buffer holding the sequence.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return buf_sz_;
+    }
+    
+    /**
+     * @brief       Check whether the sequence is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return n_ == 0;
+    }
+    
+    /**
+     * @brief       Get the number of elements.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return n_;
+    }
+
+private:
+    /** The last element of every block. */
+    const std::uint64_t* lsts_;
+    
+    /** The word offset of every block in the data, shifted by 8, and its number of bits. */
+    const std::uint64_t* infos_;
+    
+    /** The packed differences of the blocks, followed by a padding word. */
+    const std::uint64_t* dat_;
+    
+    /** The number of elements. */
+    std::size_t n_;
+    
+    /** The number of blocks. */
+    std::size_t nbr_blks_;
+    
+    /** The size of the buffer in bytes. */
+    std::size_t buf_sz_;
+};
+
+
+/**
+ * @brief       Class that represents a sorted sequence of unsigned integers compressed in blocks
+ *              of packed differences. The words are laid out exactly as in the serialized buffer,
+ *              so the buffer can be written to a file and later served with a block_delta_view
+ *              over a memory mapping, without decoding. The buffer uses the host endianness.
+ */
+template<typename TpValue = std::uint64_t, typename TpAllocator = std::allocator<int>>
+class block_delta_sequence
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The view type. */
+    using view_type = block_delta_view<TpValue>;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /**
+     * @brief       Default constructor. The sequence is empty.
+     */
+    block_delta_sequence()
+            : block_delta_sequence(static_cast<const value_type*>(nullptr),
+                                   static_cast<const value_type*>(nullptr))
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       first : Iterator to the first element of the range.
+     * @param       last : Iterator to the past-the-end element of the range.
+     * @throw       speed::containers::insertion_exception : If the range is not sorted an
+     *              exception is thrown.
+     */
+    template<typename TpForwardIterator>
+    block_delta_sequence(TpForwardIterator first, TpForwardIterator last)
+            : wrds_()
+            , vw_()
+    {
+        constexpr std::size_t BLOCK_SIZE = view_type::BLOCK_SIZE;
+        std::uint64_t dltas[BLOCK_SIZE];
+        std::vector<std::uint64_t, allocator_type<std::uint64_t>> dat;
+        std::uint64_t n = 0;
+        std::uint64_t prv = 0;
+        std::uint64_t max_dlta;
+        std::size_t blk_cnt;
+        std::size_t bits;
+        
+        for (auto it = first; it != last; ++it, ++n)
+        {
+            if (static_cast<std::uint64_t>(*it) < prv)
+            {
+                throw insertion_exception();
+            }
+            
+            prv = static_cast<std::uint64_t>(*it);
+        }
+        
+        const std::size_t nbr_blks = static_cast<std::size_t>((n + BLOCK_SIZE - 1) / BLOCK_SIZE);
+        
+        wrds_.assign(view_type::HEADER_WORDS + 2 * nbr_blks, 0);
+        wrds_[0] = view_type::MAGIC;
+        wrds_[1] = sizeof(value_type);
+        wrds_[2] = n;
+        wrds_[3] = nbr_blks;
+        
+        prv = 0;
+        for (std::size_t i = 0; i < nbr_blks; ++i)
+        {
+            max_dlta = 0;
+            for (blk_cnt = 0; blk_cnt < BLOCK_SIZE && first != last; ++blk_cnt, ++first)
+            {
+                dltas[blk_cnt] = static_cast<std::uint64_t>(*first) - prv;
+                prv = static_cast<std::uint64_t>(*first);
+                max_dlta |= dltas[blk_cnt];
+            }
+            
+            bits = __hidden_containers::get_bit_width(max_dlta);
+            wrds_[view_type::HEADER_WORDS + i] = prv;
+            wrds_[view_type::HEADER_WORDS + nbr_blks + i] = (dat.size() << 8) | bits;
+            
+            const std::size_t ofst = dat.size();
+            
+            dat.resize(ofst + (blk_cnt * bits + 63) / 64, 0);
+            for (std::size_t j = 0; j < blk_cnt; ++j)
+            {
+                __hidden_containers::set_packed_value(dat.data() + ofst, bits, j, dltas[j]);
+            }
+        }
+        
+        dat.push_back(0);
+        wrds_[4] = dat.size();
+        wrds_.insert(wrds_.end(), dat.begin(), dat.end());
+        
+        reset_view();
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       il : The sorted elements.
+     * @throw       speed::containers::insertion_exception : If the elements are not sorted an
+     *              exception is thrown.
+     */
+    block_delta_sequence(std::initializer_list<value_type> il)
+            : block_delta_sequence(il.begin(), il.end())
+    {
+    }
+    
+    /**
+     * @brief       Copy constructor.
+     * @param       rhs : The object to copy.
+     */
+    block_delta_sequence(const block_delta_sequence& rhs)
+            : wrds_(rhs.wrds_)
+            , vw_()
+    {
+        reset_view();
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    block_delta_sequence(block_delta_sequence&& rhs) noexcept
+            : wrds_(std::move(rhs.wrds_))
+            , vw_(rhs.vw_)
+    {
+        rhs.vw_ = view_type();
+    }
+    
+    /**
+     * @brief       Copy assignment operator.
+     * @param       rhs : The object to copy.
+     * @return      The object who call the method.
+     */
+    block_delta_sequence& operator =(const block_delta_sequence& rhs)
+    {
+        if (this != &rhs)
+        {
+            wrds_ = rhs.wrds_;
+            reset_view();
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    block_delta_sequence& operator =(block_delta_sequence&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            wrds_ = std::move(rhs.wrds_);
+            vw_ = rhs.vw_;
+            rhs.vw_ = view_type();
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Get an element without bounds checking.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     */
+    [[nodiscard]] inline value_type get(std::size_t idx) const noexcept
+    {
+        return vw_.get(idx);
+    }
+    
+    /**
+     * @brief       Get an element.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     * @throw       speed::containers::out_of_range_exception : If the index is not lower than the
+     *              size an exception is thrown.
+     */
+    [[nodiscard]] inline value_type at(std::size_t idx) const
+    {
+        return vw_.at(idx);
+    }
+    
+    /**
+     * @brief       Get the index of the first element that is greater than or equal to a value.
+     * @param       x : The value to look for.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    [[nodiscard]] inline std::size_t next_geq(value_type x) const noexcept
+    {
+        return vw_.next_geq(x);
+    }
+    
+    /**
+     * @brief       Get the index and the value of the first element that is greater than or equal
+     *              to a value.
+     * @param       x : The value to look for.
+     * @param       val : Set with the element found, if any.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    inline std::size_t next_geq(value_type x, value_type& val) const noexcept
+    {
+        return vw_.next_geq(x, val);
+    }
+    
+    /**
+     * @brief       Copy consecutive elements into a regular array.
+     * @param       first : The index of the first element to copy.
+     * @param       cnt : The number of elements to copy.
+     * @param       out : The destination array.
+     * @throw       speed::containers::out_of_range_exception : If the range exceeds the size an
+     *              exception is thrown.
+     */
+    inline void decode(std::size_t first, std::size_t cnt, value_type* out) const
+    {
+        vw_.decode(first, cnt, out);
+    }
+    
+    /**
+     * @brief       Decode a block.
+     * @param       blk_idx : The index of the block, lower than get_block_count().
+     * @param       out : The destination array, that must hold BLOCK_SIZE elements.
+     * @return      The number of elements of the block.
+     */
+    inline std::size_t decode_block(std::size_t blk_idx, value_type* out) const noexcept
+    {
+        return vw_.decode_block(blk_idx, out);
+    }
+    
+    /**
+     * @brief       Serialize the sequence in a byte buffer. The buffer holds the words of the
+     *              sequence in the host endianness.
+     * @return      The buffer holding the sequence.
+     */
+    [[nodiscard]] std::vector<std::uint8_t> serialize() const
+    {
+        std::vector<std::uint8_t> buf(get_size_in_bytes());
+        
+        std::memcpy(buf.data(), wrds_.data(), buf.size());
+        
+        return buf;
+    }
+    
+    /**
+     * @brief       Build a sequence from a buffer filled by serialize. The buffer is copied, use a
+     *              block_delta_view to access it in place.
+     * @param       buf : The buffer.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @return      The deserialized sequence.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    static block_delta_sequence deserialize(const std::uint8_t* buf, std::size_t buf_sz)
+    {
+        block_delta_sequence bds;
+        
+        if (buf_sz % sizeof(std::uint64_t) != 0)
+        {
+            throw deserialization_exception();
+        }
+        
+        bds.wrds_.resize(buf_sz / sizeof(std::uint64_t));
+        std::memcpy(bds.wrds_.data(), buf, buf_sz);
+        bds.vw_ = view_type(bds.wrds_.data(), buf_sz);
+        
+        return bds;
+    }
+    
+    /**
+     * @brief       Build a sequence from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @return      The deserialized sequence.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    static block_delta_sequence deserialize(const std::vector<std::uint8_t>& buf)
+    {
+        return deserialize(buf.data(), buf.size());
+    }
+    
+    /**
+     * @brief       Get a view over the sequence.
+     * @return      A view over the sequence, valid while the sequence is not modified.
+     */
+    [[nodiscard]] inline const view_type& get_view() const noexcept
+    {
+        return vw_;
+    }
+    
+    /**
+     * @brief       Get the words of the sequence, laid out as in the serialized buffer.
+     * @return      The words of the sequence.
+     */
+    [[nodiscard]] inline const std::uint64_t* data() const noexcept
+    {
+        return wrds_.data();
+    }
+    
+    /**
+     * @brief       Get the last element.
+     * @return      The last element, or 0 if the sequence is empty.
+     */
+    [[nodiscard]] inline value_type back() const noexcept
+    {
+        return vw_.back();
+    }
+    
+    /**
+     * @brief       Get the number of blocks.
+     * @return      The number of blocks.
+     */
+    [[nodiscard]] inline std::size_t get_block_count() const noexcept
+    {
+        return vw_.get_block_count();
+    }
+    
+    /**
+     * @brief       Get the size of the sequence in bytes.
+     * @return      The size of the sequence in bytes.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return wrds_.size() * sizeof(std::uint64_t);
+    }
+    
+    /**
+     * @brief       Check whether the sequence is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return vw_.empty();
+    }
+    
+    /**
+     * @brief       Get the number of elements.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return vw_.size();
+    }
+
+private:
+    /**
+     * @brief       Build the view over the words.
+     */
+    void reset_view()
+    {
+        vw_ = view_type(wrds_.data(), get_size_in_bytes());
+    }
+    
+    /** The words of the sequence, laid out as in the serialized buffer. */
+    std::vector<std::uint64_t, allocator_type<std::uint64_t>> wrds_;
+    
+    /** The view over the words. */
+    view_type vw_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,490 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/blocked_bloom_filter.hpp
+ * @brief      blocked_bloom_filter class header.
+ * @author     Killian
+ * @date       2018/09/16 - 10:27
+ */
+
+#ifndef SPEED_CONTAINERS_BLOCKED_BLOOM_FILTER_HPP
+#define SPEED_CONTAINERS_BLOCKED_BLOOM_FILTER_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "../hash.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents a split block Bloom filter. Every key sets one bit in each of
+ *              the 8 words of a single 32 bytes block, so a lookup touches one cache line only and
+ *              is done with a few vector instructions when AVX2 is available. The filter can
+ *              report false positives, but never false negatives.
+ */
+template<
+        typename TpKey,
+        typename TpHash = speed::hash::hasher<TpKey>,
+        typename TpAllocator = std::allocator<int>
+>
+class blocked_bloom_filter
+{
+public:
+    /** The key type. */
+    using key_type = TpKey;
+    
+    /** The hash type. */
+    using hash_type = TpHash;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /** Number of words in a block, that is the number of bits set by every key. */
+    static constexpr std::size_t WORDS_PER_BLOCK = 8;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       expctd_sz : The number of keys the filter is expected to hold.
+     * @param       fpr : The false positive rate targeted when the filter holds the expected number
+     *              of keys.
+     */
+    explicit blocked_bloom_filter(std::size_t expctd_sz, double fpr = 0.01)
+            : blks_(get_number_of_blocks_for(expctd_sz, fpr))
+            , sz_(0)
+            , hshr_()
+    {
+    }
+    
+    /**
+     * @brief       Insert a key in the filter.
+     * @param       ky : The key to insert.
+     */
+    void insert(const key_type& ky) noexcept
+    {
+        insert_hash(get_hash(ky));
+    }
+    
+    /**
+     * @brief       Insert an already mixed 64 bits hash in the filter.
+     * @param       hsh : The hash to insert.
+     */
+    void insert_hash(std::uint64_t hsh) noexcept
+    {
+        block& blk = blks_[get_block_index(hsh)];
+
+#ifdef __AVX2__
+        __m256i wrds = _mm256_load_si256(reinterpret_cast<const __m256i*>(blk.wrds_));
+        
+        wrds = _mm256_or_si256(wrds, make_mask(static_cast<std::uint32_t>(hsh)));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(blk.wrds_), wrds);
+#else
+        for (std::size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+        {
+            blk.wrds_[i] |= get_word_mask(static_cast<std::uint32_t>(hsh), i);
+        }
+#endif
+
+        ++sz_;
+    }
+    
+    /**
+     * @brief       Check whether a key may be in the filter.
+     * @param       ky : The key to look for.
+     * @return      If the key may be in the filter true is returned, if it is certainly not in it
+     *              false is returned.
+     */
+    [[nodiscard]] bool contains(const key_type& ky) const noexcept
+    {
+        return contains_hash(get_hash(ky));
+    }
+    
+    /**
+     * @brief       Check whether an already mixed 64 bits hash may be in the filter.
+     * @param       hsh : The hash to look for.
+     * @return      If the hash may be in the filter true is returned, if it is certainly not in it
+     *              false is returned.
+     */
+    [[nodiscard]] bool contains_hash(std::uint64_t hsh) const noexcept
+    {
+        const block& blk = blks_[get_block_index(hsh)];
+
+#ifdef __AVX2__
+        const __m256i wrds = _mm256_load_si256(reinterpret_cast<const __m256i*>(blk.wrds_));
+        
+        return _mm256_testc_si256(wrds, make_mask(static_cast<std::uint32_t>(hsh))) != 0;
+#else
+        for (std::size_t i = 0; i < WORDS_PER_BLOCK; ++i)
+        {
+            if ((blk.wrds_[i] & get_word_mask(static_cast<std::uint32_t>(hsh), i)) == 0)
+            {
+                return false;
+            }
+        }
+        
+        return true;
+#endif
+    }
+    
+    /**
+     * @brief       Erase all the keys in the filter.
+     */
+    void clear() noexcept
+    {
+        for (auto& x : blks_)
+        {
+            x = block();
+        }
+        
+        sz_ = 0;
+    }
+    
+    /**
+     * @brief       Get the false positive rate expected with the current number of insertions.
+     * @return      The expected false positive rate.
+     */
+    [[nodiscard]] double get_expected_false_positive_rate() const noexcept
+    {
+        return get_false_positive_rate(static_cast<double>(sz_) /
+                                       static_cast<double>(blks_.size()));
+    }
+    
+    /**
+     * @brief       Get the number of insertions done in the filter.
+     * @return      The number of insertions done in the filter.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return sz_;
+    }
+    
+    /**
+     * @brief       Get the memory used by the filter bits in bytes.
+     * @return      The memory used by the filter bits in bytes.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return blks_.size() * sizeof(block);
+    }
+    
+    /**
+     * @brief       Serialize the filter in a byte buffer. The format does not depend on the host
+     *              endianness.
+     * @return      The buffer holding the filter.
+     */
+    [[nodiscard]] std::vector<std::uint8_t> serialize() const
+    {
+        std::vector<std::uint8_t> buf;
+        
+        buf.reserve(HEADER_SIZE + get_size_in_bytes());
+        put_uint(buf, MAGIC, 4);
+        put_uint(buf, blks_.size(), 8);
+        put_uint(buf, sz_, 8);
+        
+        for (auto& x : blks_)
+        {
+            for (auto& y : x.wrds_)
+            {
+                put_uint(buf, y, 4);
+            }
+        }
+        
+        return buf;
+    }
+    
+    /**
+     * @brief       Build a filter from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @return      The deserialized filter.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid filter an exception is thrown.
+     */
+    static blocked_bloom_filter deserialize(const std::uint8_t* buf, std::size_t buf_sz)
+    {
+        std::uint64_t nbr_blks;
+        std::size_t pos = 0;
+        
+        if (buf_sz < HEADER_SIZE || get_uint(buf, pos, 4) != MAGIC)
+        {
+            throw deserialization_exception();
+        }
+        
+        nbr_blks = get_uint(buf, pos, 8);
+        
+        if (nbr_blks == 0 || (buf_sz - HEADER_SIZE) / sizeof(block) != nbr_blks ||
+            (buf_sz - HEADER_SIZE) % sizeof(block) != 0)
+        {
+            throw deserialization_exception();
+        }
+        
+        blocked_bloom_filter bf(static_cast<std::size_t>(nbr_blks), blocks_tag());
+        
+        bf.sz_ = static_cast<std::size_t>(get_uint(buf, pos, 8));
+        
+        for (auto& x : bf.blks_)
+        {
+            for (auto& y : x.wrds_)
+            {
+                y = static_cast<std::uint32_t>(get_uint(buf, pos, 4));
+            }
+        }
+        
+        return bf;
+    }
+    
+    /**
+     * @brief       Deserialize a filter from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @return      The deserialized filter.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid filter an exception is thrown.
+     */
+    static blocked_bloom_filter deserialize(const std::vector<std::uint8_t>& buf)
+    {
+        return deserialize(buf.data(), buf.size());
+    }
+
+private:
+    /**
+     * @brief       Struct that represents a block of the filter.
+     */
+    struct alignas(32) block
+    {
+        /** The block words. */
+        std::uint32_t wrds_[WORDS_PER_BLOCK] = {};
+    };
+    
+    /**
+     * @brief       Tag used to build a filter with a given number of blocks.
+     */
+    struct blocks_tag
+    {
+    };
+    
+    /** Odd constants used to derive one bit position per word from a single hash. */
+    static constexpr std::uint32_t SALTS[WORDS_PER_BLOCK] = {
+            0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+            0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+    
+    /** Identifies the buffers filled by serialize. */
+    static constexpr std::uint64_t MAGIC = 0x46424253U;
+    
+    /** Size of the serialization header. */
+    static constexpr std::size_t HEADER_SIZE = 20;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_blks : The number of blocks.
+     */
+    blocked_bloom_filter(std::size_t nbr_blks, blocks_tag)
+            : blks_(nbr_blks)
+            , sz_(0)
+            , hshr_()
+    {
+    }
+    
+    /**
+     * @brief       Get the hash of a key, mixed so that all its bits are usable.
+     * @param       ky : The key.
+     * @return      The mixed hash of the key.
+     */
+    std::uint64_t get_hash(const key_type& ky) const
+    {
+        if constexpr (std::is_same<hash_type, speed::hash::hasher<key_type>>::value)
+        {
+            return static_cast<std::uint64_t>(hshr_(ky));
+        }
+        else
+        {
+            return speed::hash::mix64(static_cast<std::uint64_t>(hshr_(ky)));
+        }
+    }
+    
+    /**
+     * @brief       Get the block of a hash. The high bits of the hash are mapped on the number of
+     *              blocks with a multiplication, which avoids both a division and a power of 2
+     *              number of blocks.
+     * @param       hsh : The hash.
+     * @return      The index of the block.
+     */
+    std::size_t get_block_index(std::uint64_t hsh) const noexcept
+    {
+        return static_cast<std::size_t>(((hsh >> 32) * static_cast<std::uint64_t>(blks_.size()))
+                                        >> 32);
+    }
+
+#ifdef __AVX2__
+    /**
+     * @brief       Get the bits that a hash sets in a block.
+     * @param       hsh : The low bits of the hash.
+     * @return      The bits that the hash sets in a block.
+     */
+    static __m256i make_mask(std::uint32_t hsh) noexcept
+    {
+        const __m256i salts = _mm256_setr_epi32(
+                static_cast<int>(SALTS[0]), static_cast<int>(SALTS[1]),
+                static_cast<int>(SALTS[2]), static_cast<int>(SALTS[3]),
+                static_cast<int>(SALTS[4]), static_cast<int>(SALTS[5]),
+                static_cast<int>(SALTS[6]), static_cast<int>(SALTS[7]));
+        __m256i bits = _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(hsh)), salts);
+        
+        bits = _mm256_srli_epi32(bits, 27);
+        
+        return _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+    }
+#else
+    /**
+     * @brief       Get the bit that a hash sets in a word of a block.
+     * @param       hsh : The low bits of the hash.
+     * @param       i : The index of the word.
+     * @return      The bit that the hash sets in the word.
+     */
+    static std::uint32_t get_word_mask(std::uint32_t hsh, std::size_t i) noexcept
+    {
+        return 1U << ((hsh * SALTS[i]) >> 27);
+    }
+#endif
+
+    /**
+     * @brief       Get the false positive rate of a filter with a given average number of keys per
+     *              block. The number of keys in a block follows a Poisson distribution.
+     * @param       lambda : The average number of keys per block.
+     * @return      The false positive rate.
+     */
+    static double get_false_positive_rate(double lambda) noexcept
+    {
+        const std::size_t max_ld = static_cast<std::size_t>(lambda + 12 * std::sqrt(lambda)) + 16;
+        double prob = std::exp(-lambda);
+        double fpr = 0;
+        
+        for (std::size_t i = 0; i <= max_ld; ++i)
+        {
+            fpr += prob * std::pow(1 - std::pow(31.0 / 32.0, static_cast<double>(i)),
+                                   static_cast<double>(WORDS_PER_BLOCK));
+            prob *= lambda / static_cast<double>(i + 1);
+        }
+        
+        return fpr;
+    }
+    
+    /**
+     * @brief       Get the number of blocks needed to hold a number of keys with a given false
+     *              positive rate.
+     * @param       expctd_sz : The number of keys.
+     * @param       fpr : The false positive rate.
+     * @return      The number of blocks.
+     */
+    static std::size_t get_number_of_blocks_for(std::size_t expctd_sz, double fpr) noexcept
+    {
+        double lo = 0.01;
+        double hi = 64;
+        double mid;
+        
+        if (!(fpr > 0 && fpr < 1))
+        {
+            fpr = 0.01;
+        }
+        
+        for (int i = 0; i < 64; ++i)
+        {
+            mid = (lo + hi) / 2;
+            
+            if (get_false_positive_rate(mid) <= fpr)
+            {
+                lo = mid;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        
+        return static_cast<std::size_t>(std::ceil(static_cast<double>(expctd_sz) / lo)) + 1;
+    }
+    
+    /**
+     * @brief       Append an unsigned integer to a buffer in little endian.
+     * @param       buf : The buffer.
+     * @param       val : The value to append.
+     * @param       nbr_bytes : The number of bytes to write.
+     */
+    static void put_uint(std::vector<std::uint8_t>& buf, std::uint64_t val, std::size_t nbr_bytes)
+    {
+        for (std::size_t i = 0; i < nbr_bytes; ++i)
+        {
+            buf.push_back(static_cast<std::uint8_t>(val >> (i * 8)));
+        }
+    }
+    
+    /**
+     * @brief       Read an unsigned integer written in little endian in a buffer.
+     * @param       buf : The buffer.
+     * @param       pos : The position of the integer, that is moved past it.
+     * @param       nbr_bytes : The number of bytes to read.
+     * @return      The read value.
+     */
+    static std::uint64_t get_uint(
+            const std::uint8_t* buf,
+            std::size_t& pos,
+            std::size_t nbr_bytes
+    ) noexcept
+    {
+        std::uint64_t val = 0;
+        
+        for (std::size_t i = 0; i < nbr_bytes; ++i)
+        {
+            val |= static_cast<std::uint64_t>(buf[pos++]) << (i * 8);
+        }
+        
+        return val;
+    }
+    
+    /** The filter blocks. */
+    std::vector<block, allocator_type<block>> blks_;
+    
+    /** The number of insertions. */
+    std::size_t sz_;
+    
+    /** The hasher. */
+    hash_type hshr_;
+};
+
+
+}
+}
+
+
+#endif
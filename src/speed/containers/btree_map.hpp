@@ -0,0 +1,218 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/btree_map.hpp
+ * @brief      btree_map class header.
+ * @author     Killian
+ * @date       2018/09/08 - 19:02
+ */
+
+#ifndef SPEED_CONTAINERS_BTREE_MAP_HPP
+#define SPEED_CONTAINERS_BTREE_MAP_HPP
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "b_plus_tree.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an ordered map implemented as a B+tree. The iterators are
+ *              ordered by key, they give access to the mapped values and the key of the current
+ *              element is available through the key() iterator method.
+ */
+template<
+        typename TpKey,
+        typename TpValue,
+        typename TpCompare = std::less<TpKey>,
+        std::size_t NODE_SIZE = 256,
+        typename TpAllocator = std::allocator<int>
+>
+class btree_map : public b_plus_tree<TpKey, TpValue, TpCompare, NODE_SIZE, TpAllocator>
+{
+public:
+    /** The base class. */
+    using base_type = b_plus_tree<TpKey, TpValue, TpCompare, NODE_SIZE, TpAllocator>;
+    
+    /** The key type. */
+    using key_type = typename base_type::key_type;
+    
+    /** The value type. */
+    using value_type = typename base_type::value_type;
+    
+    /** The compare type. */
+    using compare_type = typename base_type::compare_type;
+    
+    /** The iterator type. */
+    using iterator = typename base_type::iterator;
+    
+    /** The const iterator type. */
+    using const_iterator = typename base_type::const_iterator;
+    
+    using base_type::base_type;
+    
+    /**
+     * @brief       Constructor with parameters. The elements are bulk loaded.
+     * @param       first : Iterator to the first key value pair of a range sorted by key.
+     * @param       last : Iterator to the past-the-end key value pair of the range.
+     * @param       comp : The comparator.
+     * @throw       speed::containers::insertion_exception : If the range is not strictly sorted by
+     *              key an exception is thrown.
+     */
+    template<typename TpRandomAccessIterator>
+    btree_map(
+            TpRandomAccessIterator first,
+            TpRandomAccessIterator last,
+            const compare_type& comp = compare_type()
+    )
+            : base_type(comp)
+    {
+        bulk_load(first, last);
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      An iterator to the inserted element.
+     * @throw       speed::containers::insertion_exception : If the key is found in the container
+     *              an exception is thrown.
+     */
+    template<typename TpKey_, typename TpValue_>
+    iterator insert(TpKey_&& ky, TpValue_&& val)
+    {
+        bool insertd;
+        iterator it = base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+        
+        if (!insertd)
+        {
+            throw insertion_exception();
+        }
+        
+        *it = std::forward<TpValue_>(val);
+        
+        return it;
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container if the key is not already in it.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      If the element has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_, typename TpValue_>
+    bool try_insert(TpKey_&& ky, TpValue_&& val)
+    {
+        bool insertd;
+        iterator it = base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+        
+        if (insertd)
+        {
+            *it = std::forward<TpValue_>(val);
+        }
+        
+        return insertd;
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container, or assign the value if the key is
+     *              already in it.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      An iterator to the element.
+     */
+    template<typename TpKey_, typename TpValue_>
+    iterator insert_or_assign(TpKey_&& ky, TpValue_&& val)
+    {
+        bool insertd;
+        iterator it = base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+        
+        *it = std::forward<TpValue_>(val);
+        
+        return it;
+    }
+    
+    /**
+     * @brief       Get the value associated with a key, inserting a value-initialized one if the
+     *              key is not in the container.
+     * @param       ky : The key.
+     * @return      The value associated with the key.
+     */
+    template<typename TpKey_>
+    value_type& operator [](TpKey_&& ky)
+    {
+        bool insertd;
+        
+        return *base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+    }
+    
+    /**
+     * @brief       Get the value associated with a key.
+     * @param       ky : The key.
+     * @return      The value associated with the key.
+     * @throw       speed::containers::out_of_range_exception : If the key is not in the container
+     *              an exception is thrown.
+     */
+    value_type& at(const key_type& ky)
+    {
+        iterator it = base_type::find(ky);
+        
+        if (it.end())
+        {
+            throw out_of_range_exception();
+        }
+        
+        return *it;
+    }
+    
+    /**
+     * @brief       Replace the contents of the container with a range of key value pairs sorted by
+     *              key. The nodes are built full, without searching nor splitting.
+     * @param       first : Iterator to the first key value pair of the range.
+     * @param       last : Iterator to the past-the-end key value pair of the range.
+     * @throw       speed::containers::insertion_exception : If the range is not strictly sorted by
+     *              key an exception is thrown.
+     */
+    template<typename TpRandomAccessIterator>
+    void bulk_load(TpRandomAccessIterator first, TpRandomAccessIterator last)
+    {
+        base_type::build_from_sorted(
+                static_cast<std::size_t>(last - first),
+                [&](std::size_t i) -> const key_type& { return first[i].first; },
+                [&](typename base_type::leaf_node* leaf, std::size_t j, std::size_t i)
+                {
+                    leaf->vals_[j] = first[i].second;
+                });
+    }
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,202 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/btree_set.hpp
+ * @brief      btree_set class header.
+ * @author     Killian
+ * @date       2018/09/08 - 19:31
+ */
+
+#ifndef SPEED_CONTAINERS_BTREE_SET_HPP
+#define SPEED_CONTAINERS_BTREE_SET_HPP
+
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "b_plus_tree.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an ordered set implemented as a B+tree.
+ */
+template<
+        typename TpKey,
+        typename TpCompare = std::less<TpKey>,
+        std::size_t NODE_SIZE = 256,
+        typename TpAllocator = std::allocator<int>
+>
+class btree_set : public b_plus_tree<TpKey, void, TpCompare, NODE_SIZE, TpAllocator>
+{
+public:
+    /** The base class. */
+    using base_type = b_plus_tree<TpKey, void, TpCompare, NODE_SIZE, TpAllocator>;
+    
+    /** The key type. */
+    using key_type = typename base_type::key_type;
+    
+    /** The value type. */
+    using value_type = typename base_type::value_type;
+    
+    /** The compare type. */
+    using compare_type = typename base_type::compare_type;
+    
+    /** The const iterator type. The keys can not be modified in place. */
+    using const_iterator = typename base_type::const_iterator;
+    
+    /** The iterator type. */
+    using iterator = const_iterator;
+    
+    using base_type::base_type;
+    
+    /**
+     * @brief       Constructor with parameters. The elements are bulk loaded.
+     * @param       first : Iterator to the first key of a sorted range.
+     * @param       last : Iterator to the past-the-end key of the range.
+     * @param       comp : The comparator.
+     * @throw       speed::containers::insertion_exception : If the range is not strictly sorted an
+     *              exception is thrown.
+     */
+    template<typename TpRandomAccessIterator>
+    btree_set(
+            TpRandomAccessIterator first,
+            TpRandomAccessIterator last,
+            const compare_type& comp = compare_type()
+    )
+            : base_type(comp)
+    {
+        bulk_load(first, last);
+    }
+    
+    /**
+     * @brief       Get the first element iterator of the container.
+     * @return      The first element iterator of the container.
+     */
+    inline iterator begin() const noexcept
+    {
+        return base_type::cbegin();
+    }
+    
+    /**
+     * @brief       Get an iterator to the past-the-end element in the container.
+     * @return      An iterator to the past-the-end element in the container.
+     */
+    inline iterator end() const noexcept
+    {
+        return base_type::cend();
+    }
+    
+    /**
+     * @brief       Find the specified key.
+     * @param       ky : The key.
+     * @return      If function was successful an iterator to the key is returned, otherwise an end
+     *              iterator is returned.
+     */
+    iterator find(const key_type& ky) const noexcept
+    {
+        return base_type::find(ky);
+    }
+    
+    /**
+     * @brief       Get an iterator to the first key that does not go before the specified key.
+     * @param       ky : The key.
+     * @return      An iterator to the first key that does not go before the key.
+     */
+    iterator lower_bound(const key_type& ky) const noexcept
+    {
+        return const_cast<btree_set&>(*this).base_type::lower_bound(ky);
+    }
+    
+    /**
+     * @brief       Get an iterator to the first key that goes after the specified key.
+     * @param       ky : The key.
+     * @return      An iterator to the first key that goes after the key.
+     */
+    iterator upper_bound(const key_type& ky) const noexcept
+    {
+        return const_cast<btree_set&>(*this).base_type::upper_bound(ky);
+    }
+    
+    /**
+     * @brief       Insert a key in the container.
+     * @param       ky : The key.
+     * @return      An iterator to the inserted key.
+     * @throw       speed::containers::insertion_exception : If the key is found in the container
+     *              an exception is thrown.
+     */
+    template<typename TpKey_>
+    iterator insert(TpKey_&& ky)
+    {
+        bool insertd;
+        iterator it = base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+        
+        if (!insertd)
+        {
+            throw insertion_exception();
+        }
+        
+        return it;
+    }
+    
+    /**
+     * @brief       Insert a key in the container if it is not already in it.
+     * @param       ky : The key.
+     * @return      If the key has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_>
+    bool try_insert(TpKey_&& ky)
+    {
+        bool insertd;
+        
+        base_type::find_or_insert(std::forward<TpKey_>(ky), &insertd);
+        
+        return insertd;
+    }
+    
+    /**
+     * @brief       Replace the contents of the container with a sorted range of keys. The nodes are
+     *              built full, without searching nor splitting.
+     * @param       first : Iterator to the first key of the range.
+     * @param       last : Iterator to the past-the-end key of the range.
+     * @throw       speed::containers::insertion_exception : If the range is not strictly sorted an
+     *              exception is thrown.
+     */
+    template<typename TpRandomAccessIterator>
+    void bulk_load(TpRandomAccessIterator first, TpRandomAccessIterator last)
+    {
+        base_type::build_from_sorted(
+                static_cast<std::size_t>(last - first),
+                [&](std::size_t i) -> const key_type& { return first[i]; },
+                [](typename base_type::leaf_node*, std::size_t, std::size_t) {});
+    }
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,662 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/concurrent_skip_list_map.hpp
+ * @brief      concurrent_skip_list_map class header.
+ * @author     Killian
+ * @date       2018/09/17 - 11:36
+ */
+
+#ifndef SPEED_CONTAINERS_CONCURRENT_SKIP_LIST_MAP_HPP
+#define SPEED_CONTAINERS_CONCURRENT_SKIP_LIST_MAP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <utility>
+
+#include "containers_exception.hpp"
+#include "epoch_based_reclamation.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an ordered map that can be used concurrently by any number of
+ *              threads without locking. Insertions link a node level by level with CAS, erasures
+ *              first mark the links of a node (logical deletion) and the marked nodes are then
+ *              unlinked by any thread that walks over them. Unlinked nodes are reclaimed through
+ *              epoch_based_reclamation. The values are immutable once inserted.
+ */
+template<
+        typename TpKey,
+        typename TpValue,
+        typename TpCompare = std::less<TpKey>,
+        std::size_t MAX_LEVEL = 24
+>
+class concurrent_skip_list_map
+{
+    static_assert(MAX_LEVEL >= 1 && MAX_LEVEL <= 64, "The maximum level has to be in [1, 64]");
+
+public:
+    /** The key type. */
+    using key_type = TpKey;
+    
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The compare type. */
+    using compare_type = TpCompare;
+    
+    /**
+     * @brief       Default constructor.
+     * @param       comp : The comparator.
+     */
+    explicit concurrent_skip_list_map(const compare_type& comp = compare_type())
+            : hd_()
+            , sz_(0)
+            , comp_(comp)
+    {
+        for (auto& x : hd_)
+        {
+            x.store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    /** @cond */
+    concurrent_skip_list_map(const concurrent_skip_list_map& rhs) = delete;
+    
+    concurrent_skip_list_map& operator =(const concurrent_skip_list_map& rhs) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. No other thread can use the container while it is destroyed.
+     */
+    ~concurrent_skip_list_map()
+    {
+        node* nod = get_node(hd_[0].load(std::memory_order_relaxed));
+        node* nxt;
+        
+        while (nod != nullptr)
+        {
+            nxt = get_node(nod->get_next(0).load(std::memory_order_relaxed));
+            destroy_node(nod);
+            nod = nxt;
+        }
+    }
+    
+    /**
+     * @brief       Find the value associated with a key.
+     * @param       ky : The key.
+     * @param       val : If it is not nullptr and the key is found, it receives a copy of the
+     *              value.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    bool find(const key_type& ky, value_type* val = nullptr) const
+    {
+        epoch_based_reclamation::guard grd;
+        const node* nod = find_greater_or_equal(ky);
+        
+        if (nod == nullptr || comp_(ky, nod->ky_))
+        {
+            return false;
+        }
+        
+        if (val != nullptr)
+        {
+            *val = nod->val_;
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Check whether a key is in the container.
+     * @param       ky : The key.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool contains(const key_type& ky) const
+    {
+        return find(ky);
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @throw       speed::containers::insertion_exception : If the key is found in the container
+     *              an exception is thrown.
+     */
+    template<typename TpKey_, typename TpValue_>
+    void insert(TpKey_&& ky, TpValue_&& val)
+    {
+        if (!try_insert(std::forward<TpKey_>(ky), std::forward<TpValue_>(val)))
+        {
+            throw insertion_exception();
+        }
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container if the key is not already in it.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      If the element has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_, typename TpValue_>
+    bool try_insert(TpKey_&& ky, TpValue_&& val)
+    {
+        epoch_based_reclamation::guard grd;
+        std::atomic<std::uintptr_t>* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        node* nod = create_node(std::forward<TpKey_>(ky), std::forward<TpValue_>(val),
+                                get_random_level());
+        std::uintptr_t expctd;
+        std::size_t i;
+        
+        for (;;)
+        {
+            if (find_position(nod->ky_, preds, succs))
+            {
+                destroy_node(nod);
+                return false;
+            }
+            
+            for (i = 0; i < nod->lvl_; ++i)
+            {
+                nod->get_next(i).store(get_link(succs[i]), std::memory_order_relaxed);
+            }
+            
+            expctd = get_link(succs[0]);
+            
+            if (preds[0]->compare_exchange_strong(expctd, get_link(nod), std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        
+        sz_.fetch_add(1, std::memory_order_relaxed);
+        link_upper_levels(nod, preds, succs);
+        release_node(nod);
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Erase the element with the specified key.
+     * @param       ky : The key.
+     * @return      If an element has been erased true is returned, otherwise false is returned.
+     */
+    bool erase(const key_type& ky)
+    {
+        epoch_based_reclamation::guard grd;
+        std::atomic<std::uintptr_t>* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        node* nod;
+        std::size_t i;
+        
+        if (!find_position(ky, preds, succs))
+        {
+            return false;
+        }
+        
+        nod = succs[0];
+        
+        for (i = nod->lvl_ - 1; i > 0; --i)
+        {
+            nod->get_next(i).fetch_or(MARK, std::memory_order_seq_cst);
+        }
+        
+        if ((nod->get_next(0).fetch_or(MARK, std::memory_order_seq_cst) & MARK) != 0)
+        {
+            return false;
+        }
+        
+        sz_.fetch_sub(1, std::memory_order_relaxed);
+        find_position(ky, preds, succs);
+        release_node(nod);
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Call a function with every key value pair whose key is in [lo, hi), in
+     *              ascending key order, without locking. The elements inserted or erased during
+     *              the call may or may not be visited. The memory of the erased nodes is not
+     *              reclaimed while the call is in progress, so the function should not block.
+     * @param       lo : The first key of the range.
+     * @param       hi : The past-the-end key of the range.
+     * @param       fnc : The function to call with a const reference to the key and to the value.
+     */
+    template<typename TpFunction>
+    void cvisit_range(const key_type& lo, const key_type& hi, TpFunction&& fnc) const
+    {
+        epoch_based_reclamation::guard grd;
+        
+        cvisit_from(find_greater_or_equal(lo), &hi, std::forward<TpFunction>(fnc));
+    }
+    
+    /**
+     * @brief       Call a function with every key value pair, in ascending key order, without
+     *              locking. The elements inserted or erased during the call may or may not be
+     *              visited.
+     * @param       fnc : The function to call with a const reference to the key and to the value.
+     */
+    template<typename TpFunction>
+    void cvisit_all(TpFunction&& fnc) const
+    {
+        epoch_based_reclamation::guard grd;
+        
+        cvisit_from(get_node(hd_[0].load(std::memory_order_acquire)), nullptr,
+                    std::forward<TpFunction>(fnc));
+    }
+    
+    /**
+     * @brief       Get the number of elements. The value is exact only if no other thread is
+     *              modifying the container.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return sz_.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Check whether the container is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+private:
+    /** Bit set in the links of a node that has been erased. */
+    static constexpr std::uintptr_t MARK = 1;
+    
+    /**
+     * @brief       Struct that represents a node. The node is followed in memory by its array of
+     *              links, one per level.
+     */
+    struct node
+    {
+        /**
+         * @brief       Constructor with parameters.
+         * @param       ky : The key.
+         * @param       val : The value.
+         * @param       lvl : The number of levels.
+         */
+        template<typename TpKey_, typename TpValue_>
+        node(TpKey_&& ky, TpValue_&& val, std::size_t lvl)
+                : ky_(std::forward<TpKey_>(ky))
+                , val_(std::forward<TpValue_>(val))
+                , lvl_(lvl)
+                , refs_(2)
+        {
+        }
+        
+        /**
+         * @brief       Get the links of the node.
+         * @return      The links of the node.
+         */
+        std::atomic<std::uintptr_t>* get_links() noexcept
+        {
+            return reinterpret_cast<std::atomic<std::uintptr_t>*>(
+                    reinterpret_cast<char*>(this) + LINKS_OFFSET);
+        }
+        
+        /**
+         * @brief       Get the link of the node at a level.
+         * @param       lvl : The level.
+         * @return      The link of the node at the level.
+         */
+        std::atomic<std::uintptr_t>& get_next(std::size_t lvl) noexcept
+        {
+            return get_links()[lvl];
+        }
+        
+        /** The key. */
+        const key_type ky_;
+        
+        /** The value. */
+        const value_type val_;
+        
+        /** The number of levels. */
+        const std::size_t lvl_;
+        
+        /** Number of threads that still have to release the node: the inserter and the eraser. */
+        std::atomic<int> refs_;
+    };
+    
+    /** Offset of the links from the beginning of a node. */
+    static constexpr std::size_t LINKS_OFFSET =
+            (sizeof(node) + alignof(std::atomic<std::uintptr_t>) - 1) &
+            ~(alignof(std::atomic<std::uintptr_t>) - 1);
+    
+    /**
+     * @brief       Get the node referenced by a link, ignoring the mark.
+     * @param       lnk : The link.
+     * @return      The node referenced by the link.
+     */
+    static node* get_node(std::uintptr_t lnk) noexcept
+    {
+        return reinterpret_cast<node*>(lnk & ~MARK);
+    }
+    
+    /**
+     * @brief       Get the unmarked link to a node.
+     * @param       nod : The node.
+     * @return      The link to the node.
+     */
+    static std::uintptr_t get_link(const node* nod) noexcept
+    {
+        return reinterpret_cast<std::uintptr_t>(nod);
+    }
+    
+    /**
+     * @brief       Allocate and build a node.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @param       lvl : The number of levels.
+     * @return      The built node.
+     */
+    template<typename TpKey_, typename TpValue_>
+    static node* create_node(TpKey_&& ky, TpValue_&& val, std::size_t lvl)
+    {
+        void* mem = ::operator new(LINKS_OFFSET + lvl * sizeof(std::atomic<std::uintptr_t>));
+        node* nod;
+        
+        try
+        {
+            nod = new (mem) node(std::forward<TpKey_>(ky), std::forward<TpValue_>(val), lvl);
+        }
+        catch (...)
+        {
+            ::operator delete(mem);
+            throw;
+        }
+        
+        for (std::size_t i = 0; i < lvl; ++i)
+        {
+            new (nod->get_links() + i) std::atomic<std::uintptr_t>(0);
+        }
+        
+        return nod;
+    }
+    
+    /**
+     * @brief       Destroy and deallocate a node.
+     * @param       obj : The node.
+     */
+    static void destroy_node(void* obj) noexcept
+    {
+        node* nod = static_cast<node*>(obj);
+        
+        nod->~node();
+        ::operator delete(obj);
+    }
+    
+    /**
+     * @brief       Get a random number of levels, with a geometric distribution of parameter 1/2.
+     * @return      The number of levels.
+     */
+    static std::size_t get_random_level() noexcept
+    {
+        thread_local std::uint64_t rnd = reinterpret_cast<std::uintptr_t>(&rnd) ^
+                                         0x9e3779b97f4a7c15ULL;
+        std::uint64_t bits;
+        std::size_t lvl = 1;
+        
+        rnd ^= rnd << 13;
+        rnd ^= rnd >> 7;
+        rnd ^= rnd << 17;
+        
+        for (bits = rnd; lvl < MAX_LEVEL && (bits & 1) != 0; bits >>= 1)
+        {
+            ++lvl;
+        }
+        
+        return lvl;
+    }
+    
+    /**
+     * @brief       Find the position of a key at every level, and unlink the marked nodes found on
+     *              the way.
+     * @param       ky : The key.
+     * @param       preds : Receives, for every level, the link that precedes the position.
+     * @param       succs : Receives, for every level, the first node not less than the key.
+     * @return      If a node with the key was found true is returned, otherwise false is returned.
+     */
+    bool find_position(
+            const key_type& ky,
+            std::atomic<std::uintptr_t>** preds,
+            node** succs
+    )
+    {
+        std::atomic<std::uintptr_t>* pred;
+        node* cur;
+        std::uintptr_t succ;
+        std::uintptr_t expctd;
+        std::size_t i;
+        bool retry;
+        
+        do
+        {
+            retry = false;
+            pred = hd_;
+            
+            for (i = MAX_LEVEL; i-- > 0 && !retry;)
+            {
+                cur = get_node(pred[i].load(std::memory_order_seq_cst));
+                
+                while (cur != nullptr)
+                {
+                    succ = cur->get_next(i).load(std::memory_order_seq_cst);
+                    
+                    if ((succ & MARK) != 0)
+                    {
+                        expctd = get_link(cur);
+                        
+                        if (!pred[i].compare_exchange_strong(expctd, succ & ~MARK,
+                                                             std::memory_order_seq_cst,
+                                                             std::memory_order_relaxed))
+                        {
+                            retry = true;
+                            break;
+                        }
+                        
+                        cur = get_node(succ);
+                    }
+                    else if (comp_(cur->ky_, ky))
+                    {
+                        pred = cur->get_links();
+                        cur = get_node(succ);
+                    }
+                    else
+                    {
+                        break;
+                    }
+                }
+                
+                preds[i] = &pred[i];
+                succs[i] = cur;
+            }
+        } while (retry);
+        
+        return succs[0] != nullptr && !comp_(ky, succs[0]->ky_);
+    }
+    
+    /**
+     * @brief       Find the first node not less than a key without modifying the container. A
+     *              marked node is only used to move forward at its own level, never to go down,
+     *              because its lower links may reference nodes that are already reclaimed.
+     * @param       ky : The key.
+     * @return      The first node not less than the key, or nullptr.
+     */
+    const node* find_greater_or_equal(const key_type& ky) const
+    {
+        const std::atomic<std::uintptr_t>* pred = hd_;
+        node* cur = nullptr;
+        std::uintptr_t succ;
+        std::size_t i;
+        
+        for (i = MAX_LEVEL; i-- > 0;)
+        {
+            cur = get_node(pred[i].load(std::memory_order_acquire));
+            
+            while (cur != nullptr)
+            {
+                succ = cur->get_next(i).load(std::memory_order_acquire);
+                
+                if ((succ & MARK) != 0)
+                {
+                    cur = get_node(succ);
+                }
+                else if (comp_(cur->ky_, ky))
+                {
+                    pred = cur->get_links();
+                    cur = get_node(succ);
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+        
+        return cur;
+    }
+    
+    /**
+     * @brief       Call a function with the unmarked nodes of the bottom level, from a node up to a
+     *              key.
+     * @param       nod : The first node.
+     * @param       hi : The past-the-end key, or nullptr to visit up to the end.
+     * @param       fnc : The function to call with a const reference to the key and to the value.
+     */
+    template<typename TpFunction>
+    void cvisit_from(const node* nod, const key_type* hi, TpFunction&& fnc) const
+    {
+        std::uintptr_t succ;
+        
+        while (nod != nullptr && (hi == nullptr || comp_(nod->ky_, *hi)))
+        {
+            succ = const_cast<node*>(nod)->get_next(0).load(std::memory_order_acquire);
+            
+            if ((succ & MARK) == 0)
+            {
+                fnc(nod->ky_, nod->val_);
+            }
+            
+            nod = get_node(succ);
+        }
+    }
+    
+    /**
+     * @brief       Link the upper levels of a node already linked at the bottom level. The linking
+     *              stops as soon as the node is erased.
+     * @param       nod : The node.
+     * @param       preds : The links that precede the node at every level.
+     * @param       succs : The nodes that follow the node at every level.
+     */
+    void link_upper_levels(
+            node* nod,
+            std::atomic<std::uintptr_t>** preds,
+            node** succs
+    )
+    {
+        std::uintptr_t nxt;
+        std::uintptr_t expctd;
+        
+        for (std::size_t i = 1; i < nod->lvl_; ++i)
+        {
+            for (;;)
+            {
+                nxt = nod->get_next(i).load(std::memory_order_seq_cst);
+                
+                if ((nxt & MARK) != 0)
+                {
+                    return;
+                }
+                
+                if (nxt != get_link(succs[i]) &&
+                    !nod->get_next(i).compare_exchange_strong(nxt, get_link(succs[i]),
+                                                              std::memory_order_seq_cst,
+                                                              std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                
+                expctd = get_link(succs[i]);
+                
+                if (preds[i]->compare_exchange_strong(expctd, get_link(nod),
+                                                      std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+                {
+                    break;
+                }
+                
+                find_position(nod->ky_, preds, succs);
+                
+                if (succs[0] != nod)
+                {
+                    return;
+                }
+            }
+        }
+    }
+    
+    /**
+     * @brief       Release a node on behalf of its inserter or of its eraser. The last one unlinks
+     *              the node from the levels it may still be linked to and retires it.
+     * @param       nod : The node.
+     */
+    void release_node(node* nod)
+    {
+        std::atomic<std::uintptr_t>* preds[MAX_LEVEL];
+        node* succs[MAX_LEVEL];
+        
+        if (nod->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            find_position(nod->ky_, preds, succs);
+            epoch_based_reclamation::retire(nod, &destroy_node);
+        }
+    }
+    
+    /** The links of the head, one per level. */
+    std::atomic<std::uintptr_t> hd_[MAX_LEVEL];
+    
+    /** The number of elements. */
+    std::atomic<std::size_t> sz_;
+    
+    /** The comparator. */
+    compare_type comp_;
+};
+
+
+}
+}
+
+
+#endif
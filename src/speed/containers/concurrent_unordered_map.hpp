@@ -0,0 +1,673 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/concurrent_unordered_map.hpp
+ * @brief      concurrent_unordered_map class header.
+ * @author     Killian
+ * @date       2018/09/15 - 16:48
+ */
+
+#ifndef SPEED_CONTAINERS_CONCURRENT_UNORDERED_MAP_HPP
+#define SPEED_CONTAINERS_CONCURRENT_UNORDERED_MAP_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "../hash.hpp"
+#include "containers_exception.hpp"
+#include "epoch_based_reclamation.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an unbounded hash map that can be used concurrently by any
+ *              number of threads. The keys are distributed over NBR_STRIPES independent stripes,
+ *              each one with its own lock and its own bucket table. Writers only lock the stripe of
+ *              the key and a stripe grows on its own, so the map never stops the world. Readers do
+ *              not lock at all: the nodes are immutable once published, updates replace them, and
+ *              the replaced nodes are reclaimed through epoch_based_reclamation. The values are
+ *              never exposed by reference outside of a visit function, so no caller can hold a
+ *              reference to a value that is being replaced.
+ */
+template<
+        typename TpKey,
+        typename TpValue,
+        typename TpHash = speed::hash::hasher<TpKey>,
+        typename TpPred = std::equal_to<TpKey>,
+        std::size_t NBR_STRIPES = 64
+>
+class concurrent_unordered_map
+{
+    static_assert((NBR_STRIPES & (NBR_STRIPES - 1)) == 0, "The number of stripes has to be a power "
+                  "of 2");
+
+public:
+    /** The key type. */
+    using key_type = TpKey;
+    
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The hash type. */
+    using hash_type = TpHash;
+    
+    /** The predicate type. */
+    using pred_type = TpPred;
+    
+    /** The initial number of buckets of each stripe. */
+    static constexpr std::size_t INITIAL_STRIPE_CAPACITY = 8;
+    
+    /**
+     * @brief       Default constructor.
+     */
+    concurrent_unordered_map()
+            : strps_()
+            , hshr_()
+            , eq_()
+    {
+        for (auto& x : strps_)
+        {
+            x.tbl_.store(create_table(INITIAL_STRIPE_CAPACITY), std::memory_order_relaxed);
+        }
+    }
+    
+    /** @cond */
+    concurrent_unordered_map(const concurrent_unordered_map& rhs) = delete;
+    
+    concurrent_unordered_map& operator =(const concurrent_unordered_map& rhs) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. No other thread can use the container while it is destroyed.
+     */
+    ~concurrent_unordered_map()
+    {
+        for (auto& x : strps_)
+        {
+            destroy_table(x.tbl_.load(std::memory_order_relaxed));
+        }
+    }
+    
+    /**
+     * @brief       Find the value associated with a key without locking.
+     * @param       ky : The key.
+     * @param       val : If it is not nullptr and the key is found, it receives a copy of the
+     *              value.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    bool find(const key_type& ky, value_type* val = nullptr) const
+    {
+        epoch_based_reclamation::guard grd;
+        const std::size_t hsh = get_hash(ky);
+        const node* nod = find_node(get_stripe(hsh), hsh, ky);
+        
+        if (nod == nullptr)
+        {
+            return false;
+        }
+        
+        if (val != nullptr)
+        {
+            *val = nod->val_;
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Check whether a key is in the container without locking.
+     * @param       ky : The key.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool contains(const key_type& ky) const
+    {
+        return find(ky);
+    }
+    
+    /**
+     * @brief       Call a function with the value associated with a key without locking. The
+     *              function must not modify the value nor keep a reference to it.
+     * @param       ky : The key.
+     * @param       fnc : The function to call with a const reference to the value.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    template<typename TpFunction>
+    bool cvisit(const key_type& ky, TpFunction&& fnc) const
+    {
+        epoch_based_reclamation::guard grd;
+        const std::size_t hsh = get_hash(ky);
+        const node* nod = find_node(get_stripe(hsh), hsh, ky);
+        
+        if (nod == nullptr)
+        {
+            return false;
+        }
+        
+        fnc(static_cast<const value_type&>(nod->val_));
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Modify the value associated with a key. The function receives a copy of the
+     *              value while the stripe of the key is locked, and the modified copy replaces the
+     *              value atomically for the readers.
+     * @param       ky : The key.
+     * @param       fnc : The function to call with a reference to the value.
+     * @return      If the key was found true is returned, otherwise false is returned.
+     */
+    template<typename TpFunction>
+    bool visit(const key_type& ky, TpFunction&& fnc)
+    {
+        const std::size_t hsh = get_hash(ky);
+        stripe& strp = get_stripe(hsh);
+        std::lock_guard<std::mutex> lck(strp.mtx_);
+        std::atomic<node*>* prev_lnk = find_link(strp, hsh, ky);
+        node* old_nod = prev_lnk->load(std::memory_order_relaxed);
+        
+        if (old_nod == nullptr)
+        {
+            return false;
+        }
+        
+        replace_node(prev_lnk, old_nod, std::forward<TpFunction>(fnc));
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @throw       speed::containers::insertion_exception : If the key is found in the container
+     *              an exception is thrown.
+     */
+    template<typename TpKey_, typename TpValue_>
+    void insert(TpKey_&& ky, TpValue_&& val)
+    {
+        if (!try_insert(std::forward<TpKey_>(ky), std::forward<TpValue_>(val)))
+        {
+            throw insertion_exception();
+        }
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container if the key is not already in it.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      If the element has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_, typename TpValue_>
+    bool try_insert(TpKey_&& ky, TpValue_&& val)
+    {
+        return insert_or_visit(std::forward<TpKey_>(ky), std::forward<TpValue_>(val), nullptr);
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container, or replace the value if the key is
+     *              already in it.
+     * @param       ky : The key.
+     * @param       val : The value.
+     * @return      If the element has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_, typename TpValue_>
+    bool insert_or_assign(TpKey_&& ky, TpValue_&& val)
+    {
+        return insert_or_visit(
+                std::forward<TpKey_>(ky),
+                std::forward<TpValue_>(val),
+                [&](value_type& cur_val) { cur_val = std::forward<TpValue_>(val); });
+    }
+    
+    /**
+     * @brief       Insert a key value pair in the container, or modify the value associated with
+     *              the key if it is already in it. Both operations are done atomically while the
+     *              stripe of the key is locked.
+     * @param       ky : The key.
+     * @param       val : The value to insert.
+     * @param       fnc : The function to call with a reference to a copy of the value if the key is
+     *              already in the container. It can be nullptr.
+     * @return      If the element has been inserted true is returned, otherwise false is returned.
+     */
+    template<typename TpKey_, typename TpValue_, typename TpFunction>
+    bool insert_or_visit(TpKey_&& ky, TpValue_&& val, TpFunction&& fnc)
+    {
+        const std::size_t hsh = get_hash(ky);
+        stripe& strp = get_stripe(hsh);
+        std::lock_guard<std::mutex> lck(strp.mtx_);
+        std::atomic<node*>* prev_lnk = find_link(strp, hsh, ky);
+        node* old_nod = prev_lnk->load(std::memory_order_relaxed);
+        node* new_nod;
+        
+        if (old_nod != nullptr)
+        {
+            if constexpr (!std::is_same<std::decay_t<TpFunction>, std::nullptr_t>::value)
+            {
+                replace_node(prev_lnk, old_nod, std::forward<TpFunction>(fnc));
+            }
+            
+            return false;
+        }
+        
+        new_nod = new node(std::forward<TpKey_>(ky), std::forward<TpValue_>(val), hsh);
+        prev_lnk->store(new_nod, std::memory_order_release);
+        strp.sz_.store(strp.sz_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        
+        if (strp.sz_.load(std::memory_order_relaxed) >
+            strp.tbl_.load(std::memory_order_relaxed)->cap_)
+        {
+            grow_stripe(strp);
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Erase the element with the specified key.
+     * @param       ky : The key.
+     * @return      If an element has been erased true is returned, otherwise false is returned.
+     */
+    bool erase(const key_type& ky)
+    {
+        const std::size_t hsh = get_hash(ky);
+        stripe& strp = get_stripe(hsh);
+        std::lock_guard<std::mutex> lck(strp.mtx_);
+        std::atomic<node*>* prev_lnk = find_link(strp, hsh, ky);
+        node* old_nod = prev_lnk->load(std::memory_order_relaxed);
+        
+        if (old_nod == nullptr)
+        {
+            return false;
+        }
+        
+        prev_lnk->store(old_nod->nxt_.load(std::memory_order_relaxed), std::memory_order_release);
+        strp.sz_.store(strp.sz_.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        epoch_based_reclamation::retire(old_nod);
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Call a function with every key value pair without locking. The elements inserted
+     *              or erased during the call may or may not be visited.
+     * @param       fnc : The function to call with a const reference to the key and to the value.
+     */
+    template<typename TpFunction>
+    void cvisit_all(TpFunction&& fnc) const
+    {
+        epoch_based_reclamation::guard grd;
+        const table* tbl;
+        const node* nod;
+        std::size_t i;
+        
+        for (auto& x : strps_)
+        {
+            tbl = x.tbl_.load(std::memory_order_acquire);
+            
+            for (i = 0; i < tbl->cap_; ++i)
+            {
+                for (nod = tbl->bkts_[i].load(std::memory_order_acquire); nod != nullptr;
+                     nod = nod->nxt_.load(std::memory_order_acquire))
+                {
+                    fnc(static_cast<const key_type&>(nod->ky_),
+                        static_cast<const value_type&>(nod->val_));
+                }
+            }
+        }
+    }
+    
+    /**
+     * @brief       Erase all the elements. The stripes are cleared one after another.
+     */
+    void clear()
+    {
+        table* old_tbl;
+        
+        for (auto& x : strps_)
+        {
+            std::lock_guard<std::mutex> lck(x.mtx_);
+            
+            old_tbl = x.tbl_.load(std::memory_order_relaxed);
+            x.tbl_.store(create_table(INITIAL_STRIPE_CAPACITY), std::memory_order_release);
+            x.sz_.store(0, std::memory_order_relaxed);
+            epoch_based_reclamation::retire(old_tbl, &destroy_table_object);
+        }
+    }
+    
+    /**
+     * @brief       Get the number of elements. The value is exact only if no other thread is
+     *              modifying the container.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        std::size_t sz = 0;
+        
+        for (auto& x : strps_)
+        {
+            sz += x.sz_.load(std::memory_order_relaxed);
+        }
+        
+        return sz;
+    }
+    
+    /**
+     * @brief       Check whether the container is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return size() == 0;
+    }
+
+private:
+    /**
+     * @brief       Struct that represents an immutable node.
+     */
+    struct node
+    {
+        /**
+         * @brief       Constructor with parameters.
+         * @param       ky : The key.
+         * @param       val : The value.
+         * @param       hsh : The key hash.
+         */
+        template<typename TpKey_, typename TpValue_>
+        node(TpKey_&& ky, TpValue_&& val, std::size_t hsh)
+                : ky_(std::forward<TpKey_>(ky))
+                , val_(std::forward<TpValue_>(val))
+                , hsh_(hsh)
+                , nxt_(nullptr)
+        {
+        }
+        
+        /** The key. */
+        const key_type ky_;
+        
+        /** The value. */
+        value_type val_;
+        
+        /** The key hash. */
+        const std::size_t hsh_;
+        
+        /** The next node in the bucket. */
+        std::atomic<node*> nxt_;
+    };
+    
+    /**
+     * @brief       Struct that represents the bucket table of a stripe.
+     */
+    struct table
+    {
+        /** The number of buckets, always a power of 2. */
+        std::size_t cap_;
+        
+        /** The buckets. */
+        std::atomic<node*>* bkts_;
+    };
+    
+    /**
+     * @brief       Struct that represents a stripe.
+     */
+    struct alignas(64) stripe
+    {
+        /** The lock taken by the writers. */
+        std::mutex mtx_;
+        
+        /** The current bucket table. */
+        std::atomic<table*> tbl_;
+        
+        /** The number of elements. */
+        std::atomic<std::size_t> sz_{0};
+    };
+    
+    /**
+     * @brief       Get the mixed hash of a key.
+     * @param       ky : The key.
+     * @return      The mixed hash of the key.
+     */
+    std::size_t get_hash(const key_type& ky) const
+    {
+        if constexpr (std::is_same<hash_type, speed::hash::hasher<key_type>>::value)
+        {
+            return hshr_(ky);
+        }
+        else
+        {
+            return static_cast<std::size_t>(
+                    speed::hash::mix64(static_cast<std::uint64_t>(hshr_(ky))));
+        }
+    }
+    
+    /**
+     * @brief       Get the stripe of a hash. The stripe uses the high bits and the bucket the low
+     *              bits, so both choices are independent.
+     * @param       hsh : The hash.
+     * @return      The stripe of the hash.
+     */
+    stripe& get_stripe(std::size_t hsh) const noexcept
+    {
+        return const_cast<stripe&>(strps_[(hsh >> (sizeof(std::size_t) * 8 - 16)) &
+                                          (NBR_STRIPES - 1)]);
+    }
+    
+    /**
+     * @brief       Find the node of a key without locking. The caller has to be in an epoch
+     *              critical section.
+     * @param       strp : The stripe of the key.
+     * @param       hsh : The key hash.
+     * @param       ky : The key.
+     * @return      The node, or nullptr if it is not found.
+     */
+    const node* find_node(const stripe& strp, std::size_t hsh, const key_type& ky) const
+    {
+        const table* tbl = strp.tbl_.load(std::memory_order_acquire);
+        const node* nod = tbl->bkts_[hsh & (tbl->cap_ - 1)].load(std::memory_order_acquire);
+        
+        for (; nod != nullptr; nod = nod->nxt_.load(std::memory_order_acquire))
+        {
+            if (nod->hsh_ == hsh && eq_(nod->ky_, ky))
+            {
+                return nod;
+            }
+        }
+        
+        return nullptr;
+    }
+    
+    /**
+     * @brief       Find the link that points to the node of a key. The stripe has to be locked.
+     * @param       strp : The stripe of the key.
+     * @param       hsh : The key hash.
+     * @param       ky : The key.
+     * @return      The link that points to the node of the key, or the null link that ends the
+     *              bucket if the key is not found.
+     */
+    std::atomic<node*>* find_link(stripe& strp, std::size_t hsh, const key_type& ky)
+    {
+        table* tbl = strp.tbl_.load(std::memory_order_relaxed);
+        std::atomic<node*>* lnk = &tbl->bkts_[hsh & (tbl->cap_ - 1)];
+        node* nod;
+        
+        while ((nod = lnk->load(std::memory_order_relaxed)) != nullptr)
+        {
+            if (nod->hsh_ == hsh && eq_(nod->ky_, ky))
+            {
+                break;
+            }
+            
+            lnk = &nod->nxt_;
+        }
+        
+        return lnk;
+    }
+    
+    /**
+     * @brief       Replace a node by a modified copy. The stripe has to be locked.
+     * @param       prev_lnk : The link that points to the node.
+     * @param       old_nod : The node to replace.
+     * @param       fnc : The function that modifies the copied value.
+     */
+    template<typename TpFunction>
+    void replace_node(std::atomic<node*>* prev_lnk, node* old_nod, TpFunction&& fnc)
+    {
+        node* new_nod = new node(old_nod->ky_, old_nod->val_, old_nod->hsh_);
+        
+        try
+        {
+            fnc(new_nod->val_);
+        }
+        catch (...)
+        {
+            delete new_nod;
+            throw;
+        }
+        
+        new_nod->nxt_.store(old_nod->nxt_.load(std::memory_order_relaxed),
+                            std::memory_order_relaxed);
+        prev_lnk->store(new_nod, std::memory_order_release);
+        epoch_based_reclamation::retire(old_nod);
+    }
+    
+    /**
+     * @brief       Double the number of buckets of a stripe. The nodes are copied in a new table
+     *              that is published atomically, so the readers keep using the old table until
+     *              they finish. The stripe has to be locked.
+     * @param       strp : The stripe.
+     */
+    void grow_stripe(stripe& strp)
+    {
+        table* old_tbl = strp.tbl_.load(std::memory_order_relaxed);
+        table* new_tbl = create_table(old_tbl->cap_ * 2);
+        std::atomic<node*>* bkt;
+        node* nod;
+        node* new_nod;
+        std::size_t i;
+        
+        try
+        {
+            for (i = 0; i < old_tbl->cap_; ++i)
+            {
+                for (nod = old_tbl->bkts_[i].load(std::memory_order_relaxed); nod != nullptr;
+                     nod = nod->nxt_.load(std::memory_order_relaxed))
+                {
+                    new_nod = new node(nod->ky_, nod->val_, nod->hsh_);
+                    bkt = &new_tbl->bkts_[nod->hsh_ & (new_tbl->cap_ - 1)];
+                    new_nod->nxt_.store(bkt->load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+                    bkt->store(new_nod, std::memory_order_relaxed);
+                }
+            }
+        }
+        catch (...)
+        {
+            destroy_table(new_tbl);
+            return;
+        }
+        
+        strp.tbl_.store(new_tbl, std::memory_order_release);
+        epoch_based_reclamation::retire(old_tbl, &destroy_table_object);
+    }
+    
+    /**
+     * @brief       Allocate an empty table.
+     * @param       cap : The number of buckets.
+     * @return      The new table.
+     */
+    static table* create_table(std::size_t cap)
+    {
+        table* tbl = new table();
+        
+        try
+        {
+            tbl->bkts_ = new std::atomic<node*>[cap];
+        }
+        catch (...)
+        {
+            delete tbl;
+            throw;
+        }
+        
+        tbl->cap_ = cap;
+        
+        for (std::size_t i = 0; i < cap; ++i)
+        {
+            tbl->bkts_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        
+        return tbl;
+    }
+    
+    /**
+     * @brief       Delete a table and all the nodes linked in it.
+     * @param       tbl : The table.
+     */
+    static void destroy_table(table* tbl) noexcept
+    {
+        node* nod;
+        node* nxt;
+        
+        for (std::size_t i = 0; i < tbl->cap_; ++i)
+        {
+            for (nod = tbl->bkts_[i].load(std::memory_order_relaxed); nod != nullptr; nod = nxt)
+            {
+                nxt = nod->nxt_.load(std::memory_order_relaxed);
+                delete nod;
+            }
+        }
+        
+        delete[] tbl->bkts_;
+        delete tbl;
+    }
+    
+    /**
+     * @brief       Deleter used to retire a table.
+     * @param       tbl : The table.
+     */
+    static void destroy_table_object(void* tbl) noexcept
+    {
+        destroy_table(static_cast<table*>(tbl));
+    }
+    
+    /** The stripes. */
+    stripe strps_[NBR_STRIPES];
+    
+    /** The hasher. */
+    hash_type hshr_;
+    
+    /** The key comparator. */
+    pred_type eq_;
+};
+
+
+}
+}
+
+
+#endif
@@ -139,6 +139,24 @@ public:
 };
 
 
+/**
+ * @brief       Class used to throw exceptions when a buffer does not hold a valid serialized
+ *              container.
+ */
+class deserialization_exception : public containers_exception
+{
+public:
+    /**
+     * @brief       Get the message of the exception.
+     * @return      The exception message.
+     */
+    char const* what() const noexcept override
+    {
+        return "deserialization exception";
+    }
+};
+
+
 }
 }
 
@@ -0,0 +1,657 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/cuckoo_filter.hpp
+ * @brief      cuckoo_filter class header.
+ * @author     Killian
+ * @date       2018/09/16 - 15:52
+ */
+
+#ifndef SPEED_CONTAINERS_CUCKOO_FILTER_HPP
+#define SPEED_CONTAINERS_CUCKOO_FILTER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "../hash.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents a cuckoo filter. It stores a small fingerprint of every key in
+ *              one of two candidate buckets, so unlike a Bloom filter it supports erasing keys. The
+ *              fingerprint length is derived from the targeted false positive rate. The filter can
+ *              report false positives, but never false negatives for keys that have been inserted
+ *              and not erased.
+ */
+template<
+        typename TpKey,
+        typename TpHash = speed::hash::hasher<TpKey>,
+        typename TpAllocator = std::allocator<int>
+>
+class cuckoo_filter
+{
+public:
+    /** The key type. */
+    using key_type = TpKey;
+    
+    /** The hash type. */
+    using hash_type = TpHash;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /** Number of fingerprints per bucket. */
+    static constexpr std::size_t BUCKET_SIZE = 4;
+    
+    /** Maximum number of relocations tried by an insertion. */
+    static constexpr std::size_t MAX_KICKS = 500;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       cap : The number of keys the filter has to be able to hold.
+     * @param       fpr : The targeted false positive rate.
+     */
+    explicit cuckoo_filter(std::size_t cap, double fpr = 0.01)
+            : tbl_()
+            , nbr_bkts_(get_number_of_buckets_for(cap))
+            , fp_bits_(get_fingerprint_bits_for(fpr))
+            , fp_bytes_((fp_bits_ + 7) / 8)
+            , sz_(0)
+            , vctm_fp_(0)
+            , vctm_idx_(0)
+            , rnd_(0x9e3779b97f4a7c15ULL)
+            , hshr_()
+    {
+        tbl_.resize(nbr_bkts_ * BUCKET_SIZE * fp_bytes_);
+    }
+    
+    /**
+     * @brief       Insert a key in the filter.
+     * @param       ky : The key to insert.
+     * @throw       speed::containers::exhausted_resources_exception : If the filter is full an
+     *              exception is thrown.
+     */
+    void insert(const key_type& ky)
+    {
+        if (!try_insert(ky))
+        {
+            throw exhausted_resources_exception();
+        }
+    }
+    
+    /**
+     * @brief       Try to insert a key in the filter.
+     * @param       ky : The key to insert.
+     * @return      If the key has been inserted true is returned, if the filter is full false is
+     *              returned.
+     */
+    bool try_insert(const key_type& ky) noexcept
+    {
+        const std::uint64_t hsh = get_hash(ky);
+        std::uint32_t fp = get_fingerprint(hsh);
+        std::size_t idx = get_index(hsh);
+        std::uint32_t prev_fp;
+        std::size_t slt;
+        
+        if (vctm_fp_ != 0)
+        {
+            return false;
+        }
+        
+        ++sz_;
+        
+        if (insert_in_bucket(idx, fp) || insert_in_bucket(get_alt_index(idx, fp), fp))
+        {
+            return true;
+        }
+        
+        if (get_random() & 1)
+        {
+            idx = get_alt_index(idx, fp);
+        }
+        
+        for (std::size_t i = 0; i < MAX_KICKS; ++i)
+        {
+            slt = static_cast<std::size_t>(get_random() % BUCKET_SIZE);
+            prev_fp = get_slot(idx, slt);
+            set_slot(idx, slt, fp);
+            fp = prev_fp;
+            idx = get_alt_index(idx, fp);
+            
+            if (insert_in_bucket(idx, fp))
+            {
+                return true;
+            }
+        }
+        
+        vctm_fp_ = fp;
+        vctm_idx_ = idx;
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Check whether a key may be in the filter.
+     * @param       ky : The key to look for.
+     * @return      If the key may be in the filter true is returned, if it is certainly not in it
+     *              false is returned.
+     */
+    [[nodiscard]] bool contains(const key_type& ky) const noexcept
+    {
+        const std::uint64_t hsh = get_hash(ky);
+        const std::uint32_t fp = get_fingerprint(hsh);
+        const std::size_t idx1 = get_index(hsh);
+        const std::size_t idx2 = get_alt_index(idx1, fp);
+        
+        return (vctm_fp_ == fp && (vctm_idx_ == idx1 || vctm_idx_ == idx2)) ||
+               find_in_bucket(idx1, fp) != BUCKET_SIZE ||
+               find_in_bucket(idx2, fp) != BUCKET_SIZE;
+    }
+    
+    /**
+     * @brief       Erase a key from the filter. Only keys that have been inserted must be erased,
+     *              otherwise a key sharing the same fingerprint could be erased instead.
+     * @param       ky : The key to erase.
+     * @return      If a fingerprint of the key has been erased true is returned, otherwise false is
+     *              returned.
+     */
+    bool erase(const key_type& ky) noexcept
+    {
+        const std::uint64_t hsh = get_hash(ky);
+        const std::uint32_t fp = get_fingerprint(hsh);
+        const std::size_t idx1 = get_index(hsh);
+        const std::size_t idx2 = get_alt_index(idx1, fp);
+        std::size_t slt;
+        
+        if (vctm_fp_ == fp && (vctm_idx_ == idx1 || vctm_idx_ == idx2))
+        {
+            vctm_fp_ = 0;
+            --sz_;
+            return true;
+        }
+        
+        if ((slt = find_in_bucket(idx1, fp)) != BUCKET_SIZE)
+        {
+            set_slot(idx1, slt, 0);
+        }
+        else if ((slt = find_in_bucket(idx2, fp)) != BUCKET_SIZE)
+        {
+            set_slot(idx2, slt, 0);
+        }
+        else
+        {
+            return false;
+        }
+        
+        --sz_;
+        
+        if (vctm_fp_ != 0 && (insert_in_bucket(vctm_idx_, vctm_fp_) ||
+                              insert_in_bucket(get_alt_index(vctm_idx_, vctm_fp_), vctm_fp_)))
+        {
+            vctm_fp_ = 0;
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Erase all the keys in the filter.
+     */
+    void clear() noexcept
+    {
+        for (auto& x : tbl_)
+        {
+            x = 0;
+        }
+        
+        sz_ = 0;
+        vctm_fp_ = 0;
+    }
+    
+    /**
+     * @brief       Get the number of keys in the filter.
+     * @return      The number of keys in the filter.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return sz_;
+    }
+    
+    /**
+     * @brief       Check whether the filter is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return sz_ == 0;
+    }
+    
+    /**
+     * @brief       Get the ratio of used fingerprint slots.
+     * @return      The ratio of used fingerprint slots.
+     */
+    [[nodiscard]] double get_load_factor() const noexcept
+    {
+        return static_cast<double>(sz_) / static_cast<double>(nbr_bkts_ * BUCKET_SIZE);
+    }
+    
+    /**
+     * @brief       Get the number of bits of the fingerprints.
+     * @return      The number of bits of the fingerprints.
+     */
+    [[nodiscard]] inline std::size_t get_fingerprint_bits() const noexcept
+    {
+        return fp_bits_;
+    }
+    
+    /**
+     * @brief       Get the memory used by the fingerprints in bytes.
+     * @return      The memory used by the fingerprints in bytes.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return tbl_.size();
+    }
+    
+    /**
+     * @brief       Serialize the filter in a byte buffer. The format does not depend on the host
+     *              endianness.
+     * @return      The buffer holding the filter.
+     */
+    [[nodiscard]] std::vector<std::uint8_t> serialize() const
+    {
+        std::vector<std::uint8_t> buf;
+        
+        buf.reserve(HEADER_SIZE + tbl_.size());
+        put_uint(buf, MAGIC, 4);
+        put_uint(buf, fp_bits_, 1);
+        put_uint(buf, nbr_bkts_, 8);
+        put_uint(buf, sz_, 8);
+        put_uint(buf, vctm_fp_, 4);
+        put_uint(buf, vctm_idx_, 8);
+        buf.insert(buf.end(), tbl_.begin(), tbl_.end());
+        
+        return buf;
+    }
+    
+    /**
+     * @brief       Build a filter from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @return      The deserialized filter.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid filter an exception is thrown.
+     */
+    static cuckoo_filter deserialize(const std::uint8_t* buf, std::size_t buf_sz)
+    {
+        std::size_t pos = 0;
+        std::size_t fp_bits;
+        std::uint64_t nbr_bkts;
+        
+        if (buf_sz < HEADER_SIZE || get_uint(buf, pos, 4) != MAGIC)
+        {
+            throw deserialization_exception();
+        }
+        
+        fp_bits = static_cast<std::size_t>(get_uint(buf, pos, 1));
+        nbr_bkts = get_uint(buf, pos, 8);
+        
+        if (fp_bits < MIN_FINGERPRINT_BITS || fp_bits > MAX_FINGERPRINT_BITS || nbr_bkts == 0 ||
+            (nbr_bkts & (nbr_bkts - 1)) != 0 ||
+            (buf_sz - HEADER_SIZE) / (BUCKET_SIZE * ((fp_bits + 7) / 8)) != nbr_bkts ||
+            (buf_sz - HEADER_SIZE) % (BUCKET_SIZE * ((fp_bits + 7) / 8)) != 0)
+        {
+            throw deserialization_exception();
+        }
+        
+        cuckoo_filter cf(static_cast<std::size_t>(nbr_bkts), fp_bits, buckets_tag());
+        
+        cf.sz_ = static_cast<std::size_t>(get_uint(buf, pos, 8));
+        cf.vctm_fp_ = static_cast<std::uint32_t>(get_uint(buf, pos, 4));
+        cf.vctm_idx_ = static_cast<std::size_t>(get_uint(buf, pos, 8));
+        
+        if (cf.vctm_idx_ >= cf.nbr_bkts_)
+        {
+            throw deserialization_exception();
+        }
+        
+        std::copy(buf + pos, buf + buf_sz, cf.tbl_.begin());
+        
+        return cf;
+    }
+    
+    /**
+     * @brief       Build a filter from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @return      The deserialized filter.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid filter an exception is thrown.
+     */
+    static cuckoo_filter deserialize(const std::vector<std::uint8_t>& buf)
+    {
+        return deserialize(buf.data(), buf.size());
+    }
+
+private:
+    /**
+     * @brief       Tag used to build a filter with a given number of buckets.
+     */
+    struct buckets_tag
+    {
+    };
+    
+    /** Minimum number of bits of the fingerprints. */
+    static constexpr std::size_t MIN_FINGERPRINT_BITS = 4;
+    
+    /** Maximum number of bits of the fingerprints. */
+    static constexpr std::size_t MAX_FINGERPRINT_BITS = 32;
+    
+    /** Identifies the buffers filled by serialize. */
+    static constexpr std::uint64_t MAGIC = 0x464b4355U;
+    
+    /** Size of the serialization header. */
+    static constexpr std::size_t HEADER_SIZE = 33;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_bkts : The number of buckets.
+     * @param       fp_bits : The number of bits of the fingerprints.
+     */
+    cuckoo_filter(std::size_t nbr_bkts, std::size_t fp_bits, buckets_tag)
+            : tbl_(nbr_bkts * BUCKET_SIZE * ((fp_bits + 7) / 8))
+            , nbr_bkts_(nbr_bkts)
+            , fp_bits_(fp_bits)
+            , fp_bytes_((fp_bits + 7) / 8)
+            , sz_(0)
+            , vctm_fp_(0)
+            , vctm_idx_(0)
+            , rnd_(0x9e3779b97f4a7c15ULL)
+            , hshr_()
+    {
+    }
+    
+    /**
+     * @brief       Get the hash of a key, mixed so that all its bits are usable.
+     * @param       ky : The key.
+     * @return      The mixed hash of the key.
+     */
+    std::uint64_t get_hash(const key_type& ky) const
+    {
+        if constexpr (std::is_same<hash_type, speed::hash::hasher<key_type>>::value)
+        {
+            return static_cast<std::uint64_t>(hshr_(ky));
+        }
+        else
+        {
+            return speed::hash::mix64(static_cast<std::uint64_t>(hshr_(ky)));
+        }
+    }
+    
+    /**
+     * @brief       Get the fingerprint of a hash. The value 0 marks the empty slots, so it is never
+     *              used as a fingerprint.
+     * @param       hsh : The hash.
+     * @return      The fingerprint of the hash.
+     */
+    std::uint32_t get_fingerprint(std::uint64_t hsh) const noexcept
+    {
+        const std::uint32_t fp = static_cast<std::uint32_t>(
+                (hsh >> 32) & ((std::uint64_t(1) << fp_bits_) - 1));
+        
+        return fp == 0 ? 1 : fp;
+    }
+    
+    /**
+     * @brief       Get the first candidate bucket of a hash.
+     * @param       hsh : The hash.
+     * @return      The first candidate bucket.
+     */
+    std::size_t get_index(std::uint64_t hsh) const noexcept
+    {
+        return static_cast<std::size_t>(hsh) & (nbr_bkts_ - 1);
+    }
+    
+    /**
+     * @brief       Get the other candidate bucket of a fingerprint. Applying the function twice
+     *              gives back the original bucket, so a fingerprint can be moved without the key.
+     * @param       idx : A candidate bucket of the fingerprint.
+     * @param       fp : The fingerprint.
+     * @return      The other candidate bucket.
+     */
+    std::size_t get_alt_index(std::size_t idx, std::uint32_t fp) const noexcept
+    {
+        return (idx ^ static_cast<std::size_t>(speed::hash::mix64(fp))) & (nbr_bkts_ - 1);
+    }
+    
+    /**
+     * @brief       Get the fingerprint stored in a slot.
+     * @param       idx : The bucket.
+     * @param       slt : The slot in the bucket.
+     * @return      The fingerprint stored in the slot.
+     */
+    std::uint32_t get_slot(std::size_t idx, std::size_t slt) const noexcept
+    {
+        const std::uint8_t* ptr = &tbl_[(idx * BUCKET_SIZE + slt) * fp_bytes_];
+        std::uint32_t fp = 0;
+        
+        for (std::size_t i = 0; i < fp_bytes_; ++i)
+        {
+            fp |= static_cast<std::uint32_t>(ptr[i]) << (i * 8);
+        }
+        
+        return fp;
+    }
+    
+    /**
+     * @brief       Set the fingerprint stored in a slot.
+     * @param       idx : The bucket.
+     * @param       slt : The slot in the bucket.
+     * @param       fp : The fingerprint.
+     */
+    void set_slot(std::size_t idx, std::size_t slt, std::uint32_t fp) noexcept
+    {
+        std::uint8_t* ptr = &tbl_[(idx * BUCKET_SIZE + slt) * fp_bytes_];
+        
+        for (std::size_t i = 0; i < fp_bytes_; ++i)
+        {
+            ptr[i] = static_cast<std::uint8_t>(fp >> (i * 8));
+        }
+    }
+    
+    /**
+     * @brief       Find a fingerprint in a bucket.
+     * @param       idx : The bucket.
+     * @param       fp : The fingerprint.
+     * @return      The slot of the fingerprint, or BUCKET_SIZE if it is not in the bucket.
+     */
+    std::size_t find_in_bucket(std::size_t idx, std::uint32_t fp) const noexcept
+    {
+        for (std::size_t i = 0; i < BUCKET_SIZE; ++i)
+        {
+            if (get_slot(idx, i) == fp)
+            {
+                return i;
+            }
+        }
+        
+        return BUCKET_SIZE;
+    }
+    
+    /**
+     * @brief       Store a fingerprint in a free slot of a bucket.
+     * @param       idx : The bucket.
+     * @param       fp : The fingerprint.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool insert_in_bucket(std::size_t idx, std::uint32_t fp) noexcept
+    {
+        const std::size_t slt = find_in_bucket(idx, 0);
+        
+        if (slt == BUCKET_SIZE)
+        {
+            return false;
+        }
+        
+        set_slot(idx, slt, fp);
+        
+        return true;
+    }
+    
+    /**
+     * @brief       Get a pseudo random number used to choose the fingerprints to relocate.
+     * @return      A pseudo random number.
+     */
+    std::uint64_t get_random() noexcept
+    {
+        rnd_ ^= rnd_ << 13;
+        rnd_ ^= rnd_ >> 7;
+        rnd_ ^= rnd_ << 17;
+        
+        return rnd_;
+    }
+    
+    /**
+     * @brief       Get the number of buckets needed to hold a number of keys. The number of buckets
+     *              is a power of 2 and the load factor stays below 95%.
+     * @param       cap : The number of keys.
+     * @return      The number of buckets.
+     */
+    static std::size_t get_number_of_buckets_for(std::size_t cap) noexcept
+    {
+        const std::size_t min_bkts = static_cast<std::size_t>(
+                std::ceil(static_cast<double>(cap) / (BUCKET_SIZE * 0.95)));
+        std::size_t nbr_bkts = 1;
+        
+        while (nbr_bkts < min_bkts)
+        {
+            nbr_bkts <<= 1;
+        }
+        
+        return nbr_bkts;
+    }
+    
+    /**
+     * @brief       Get the number of bits of the fingerprints needed to reach a false positive
+     *              rate. A lookup compares the fingerprint with 2 * BUCKET_SIZE slots.
+     * @param       fpr : The false positive rate.
+     * @return      The number of bits of the fingerprints.
+     */
+    static std::size_t get_fingerprint_bits_for(double fpr) noexcept
+    {
+        std::size_t fp_bits;
+        
+        if (!(fpr > 0 && fpr < 1))
+        {
+            fpr = 0.01;
+        }
+        
+        fp_bits = static_cast<std::size_t>(std::ceil(std::log2(2 * BUCKET_SIZE / fpr)));
+        
+        if (fp_bits < MIN_FINGERPRINT_BITS)
+        {
+            return MIN_FINGERPRINT_BITS;
+        }
+        
+        return fp_bits > MAX_FINGERPRINT_BITS ? MAX_FINGERPRINT_BITS : fp_bits;
+    }
+    
+    /**
+     * @brief       Append an unsigned integer to a buffer in little endian.
+     * @param       buf : The buffer.
+     * @param       val : The value to append.
+     * @param       nbr_bytes : The number of bytes to write.
+     */
+    static void put_uint(std::vector<std::uint8_t>& buf, std::uint64_t val, std::size_t nbr_bytes)
+    {
+        for (std::size_t i = 0; i < nbr_bytes; ++i)
+        {
+            buf.push_back(static_cast<std::uint8_t>(val >> (i * 8)));
+        }
+    }
+    
+    /**
+     * @brief       Read an unsigned integer written in little endian in a buffer.
+     * @param       buf : The buffer.
+     * @param       pos : The position of the integer, that is moved past it.
+     * @param       nbr_bytes : The number of bytes to read.
+     * @return      The read value.
+     */
+    static std::uint64_t get_uint(
+            const std::uint8_t* buf,
+            std::size_t& pos,
+            std::size_t nbr_bytes
+    ) noexcept
+    {
+        std::uint64_t val = 0;
+        
+        for (std::size_t i = 0; i < nbr_bytes; ++i)
+        {
+            val |= static_cast<std::uint64_t>(buf[pos++]) << (i * 8);
+        }
+        
+        return val;
+    }
+    
+    /** The fingerprint slots. */
+    std::vector<std::uint8_t, allocator_type<std::uint8_t>> tbl_;
+    
+    /** The number of buckets. */
+    std::size_t nbr_bkts_;
+    
+    /** The number of bits of the fingerprints. */
+    std::size_t fp_bits_;
+    
+    /** The number of bytes used to store a fingerprint. */
+    std::size_t fp_bytes_;
+    
+    /** The number of keys. */
+    std::size_t sz_;
+    
+    /** The fingerprint that could not be relocated, or 0. */
+    std::uint32_t vctm_fp_;
+    
+    /** A candidate bucket of the victim fingerprint. */
+    std::size_t vctm_idx_;
+    
+    /** The state of the pseudo random number generator. */
+    std::uint64_t rnd_;
+    
+    /** The hasher. */
+    hash_type hshr_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,479 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/d_ary_heap.hpp
+ * @brief      d_ary_heap class header.
+ * @author     Killian
+ * @date       2018/09/02 - 18:12
+ */
+
+#ifndef SPEED_CONTAINERS_D_ARY_HEAP_HPP
+#define SPEED_CONTAINERS_D_ARY_HEAP_HPP
+
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an indexed d-ary heap. The element in the top of the heap is
+ *              the one that goes before all the others according to the comparator, so with the
+ *              default comparator the heap is a min-heap. Every pushed element gets a handle that
+ *              remains valid until the element leaves the heap, and that allows updating or
+ *              erasing the element in O(log n).
+ */
+template<
+        typename TpValue,
+        std::size_t D = 4,
+        typename TpCompare = std::less<TpValue>,
+        typename TpAllocator = std::allocator<int>
+>
+class d_ary_heap
+{
+    static_assert(D >= 2, "The heap arity has to be at least 2");
+
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The compare type. */
+    using compare_type = TpCompare;
+    
+    /** The handle type used to identify the elements. */
+    using handle_type = std::size_t;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /** Value used as position for the handles that are not in the heap. */
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+    
+    /**
+     * @brief       Default constructor.
+     * @param       comp : The comparator.
+     */
+    explicit d_ary_heap(const compare_type& comp = compare_type())
+            : nods_()
+            , pos_()
+            , free_hndls_()
+            , comp_(comp)
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters. The elements are heapified in O(n), and the
+     *              element at the i-th position of the range gets the handle i.
+     * @param       first : Iterator to the first element of the range.
+     * @param       last : Iterator to the past-the-end element of the range.
+     * @param       comp : The comparator.
+     */
+    template<typename TpInputIterator>
+    d_ary_heap(
+            TpInputIterator first,
+            TpInputIterator last,
+            const compare_type& comp = compare_type()
+    )
+            : d_ary_heap(comp)
+    {
+        assign(first, last);
+    }
+    
+    /**
+     * @brief       Replace the contents of the heap with the elements of the range. The elements
+     *              are heapified in O(n), and the element at the i-th position of the range gets
+     *              the handle i.
+     * @param       first : Iterator to the first element of the range.
+     * @param       last : Iterator to the past-the-end element of the range.
+     */
+    template<typename TpInputIterator>
+    void assign(TpInputIterator first, TpInputIterator last)
+    {
+        clear();
+        
+        for (; first != last; ++first)
+        {
+            pos_.push_back(nods_.size());
+            nods_.push_back({*first, nods_.size()});
+        }
+        
+        heapify();
+    }
+    
+    /**
+     * @brief       Insert an element in the heap.
+     * @param       val : The element to insert.
+     * @return      The handle of the inserted element.
+     */
+    template<typename TpValue_>
+    handle_type push(TpValue_&& val)
+    {
+        handle_type hndl;
+        
+        if (free_hndls_.empty())
+        {
+            hndl = pos_.size();
+            pos_.push_back(nods_.size());
+        }
+        else
+        {
+            hndl = free_hndls_.back();
+            free_hndls_.pop_back();
+            pos_[hndl] = nods_.size();
+        }
+        
+        nods_.push_back({std::forward<TpValue_>(val), hndl});
+        sift_up(nods_.size() - 1);
+        
+        return hndl;
+    }
+    
+    /**
+     * @brief       Get the top element.
+     * @return      The top element.
+     * @throw       speed::containers::empty_container_exception : If the heap is empty an
+     *              exception is thrown.
+     */
+    const value_type& top() const
+    {
+        if (nods_.empty())
+        {
+            throw empty_container_exception();
+        }
+        
+        return nods_.front().val_;
+    }
+    
+    /**
+     * @brief       Get the handle of the top element.
+     * @return      The handle of the top element.
+     * @throw       speed::containers::empty_container_exception : If the heap is empty an
+     *              exception is thrown.
+     */
+    handle_type top_handle() const
+    {
+        if (nods_.empty())
+        {
+            throw empty_container_exception();
+        }
+        
+        return nods_.front().hndl_;
+    }
+    
+    /**
+     * @brief       Erase the top element.
+     * @throw       speed::containers::empty_container_exception : If the heap is empty an
+     *              exception is thrown.
+     */
+    void pop()
+    {
+        if (nods_.empty())
+        {
+            throw empty_container_exception();
+        }
+        
+        erase_at(0);
+    }
+    
+    /**
+     * @brief       Check whether the specified handle identifies an element of the heap.
+     * @param       hndl : The handle.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool contains(handle_type hndl) const noexcept
+    {
+        return hndl < pos_.size() && pos_[hndl] != npos;
+    }
+    
+    /**
+     * @brief       Get the element identified by a handle.
+     * @param       hndl : The handle.
+     * @return      The element identified by the handle.
+     * @throw       speed::containers::out_of_range_exception : If the handle is not in the heap an
+     *              exception is thrown.
+     */
+    const value_type& get(handle_type hndl) const
+    {
+        return nods_[get_position(hndl)].val_;
+    }
+    
+    /**
+     * @brief       Change the value of an element and restore the heap order.
+     * @param       hndl : The handle of the element to update.
+     * @param       val : The new value.
+     * @throw       speed::containers::out_of_range_exception : If the handle is not in the heap an
+     *              exception is thrown.
+     */
+    template<typename TpValue_>
+    void update(handle_type hndl, TpValue_&& val)
+    {
+        const std::size_t i = get_position(hndl);
+        const bool up = comp_(val, nods_[i].val_);
+        
+        nods_[i].val_ = std::forward<TpValue_>(val);
+        
+        if (up)
+        {
+            sift_up(i);
+        }
+        else
+        {
+            sift_down(i);
+        }
+    }
+    
+    /**
+     * @brief       Move an element towards the top of the heap. The new value must not go after the
+     *              current one according to the comparator, which makes the operation cheaper than
+     *              update.
+     * @param       hndl : The handle of the element to update.
+     * @param       val : The new value.
+     * @throw       speed::containers::out_of_range_exception : If the handle is not in the heap an
+     *              exception is thrown.
+     */
+    template<typename TpValue_>
+    void decrease_key(handle_type hndl, TpValue_&& val)
+    {
+        const std::size_t i = get_position(hndl);
+        
+        nods_[i].val_ = std::forward<TpValue_>(val);
+        sift_up(i);
+    }
+    
+    /**
+     * @brief       Erase an element from the heap.
+     * @param       hndl : The handle of the element to erase.
+     * @throw       speed::containers::out_of_range_exception : If the handle is not in the heap an
+     *              exception is thrown.
+     */
+    void erase(handle_type hndl)
+    {
+        erase_at(get_position(hndl));
+    }
+    
+    /**
+     * @brief       Erase all the elements in the heap. All the handles are invalidated.
+     */
+    void clear() noexcept
+    {
+        nods_.clear();
+        pos_.clear();
+        free_hndls_.clear();
+    }
+    
+    /**
+     * @brief       Increase the capacity of the heap.
+     * @param       cap : The new capacity of the heap.
+     */
+    void reserve(std::size_t cap)
+    {
+        nods_.reserve(cap);
+        pos_.reserve(cap);
+    }
+    
+    /**
+     * @brief       Check whether the heap is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return nods_.empty();
+    }
+    
+    /**
+     * @brief       Get the number of elements in the heap.
+     * @return      The number of elements in the heap.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return nods_.size();
+    }
+
+private:
+    /**
+     * @brief       Struct that represents a heap node.
+     */
+    struct node
+    {
+        /** The node value. */
+        value_type val_;
+        
+        /** The handle of the node. */
+        handle_type hndl_;
+    };
+    
+    /**
+     * @brief       Get the heap position of a handle.
+     * @param       hndl : The handle.
+     * @return      The heap position of the handle.
+     * @throw       speed::containers::out_of_range_exception : If the handle is not in the heap an
+     *              exception is thrown.
+     */
+    std::size_t get_position(handle_type hndl) const
+    {
+        if (!contains(hndl))
+        {
+            throw out_of_range_exception();
+        }
+        
+        return pos_[hndl];
+    }
+    
+    /**
+     * @brief       Erase the node at the specified position.
+     * @param       i : The position of the node to erase.
+     */
+    void erase_at(std::size_t i)
+    {
+        const std::size_t lst = nods_.size() - 1;
+        
+        pos_[nods_[i].hndl_] = npos;
+        free_hndls_.push_back(nods_[i].hndl_);
+        
+        if (i != lst)
+        {
+            nods_[i] = std::move(nods_[lst]);
+            pos_[nods_[i].hndl_] = i;
+            nods_.pop_back();
+            
+            if (i > 0 && comp_(nods_[i].val_, nods_[(i - 1) / D].val_))
+            {
+                sift_up(i);
+            }
+            else
+            {
+                sift_down(i);
+            }
+        }
+        else
+        {
+            nods_.pop_back();
+        }
+    }
+    
+    /**
+     * @brief       Move a node towards the top until its parent goes before it.
+     * @param       i : The position of the node.
+     */
+    void sift_up(std::size_t i)
+    {
+        node nod = std::move(nods_[i]);
+        std::size_t parnt;
+        
+        while (i > 0)
+        {
+            parnt = (i - 1) / D;
+            
+            if (!comp_(nod.val_, nods_[parnt].val_))
+            {
+                break;
+            }
+            
+            nods_[i] = std::move(nods_[parnt]);
+            pos_[nods_[i].hndl_] = i;
+            i = parnt;
+        }
+        
+        pos_[nod.hndl_] = i;
+        nods_[i] = std::move(nod);
+    }
+    
+    /**
+     * @brief       Move a node towards the bottom until it goes before all its children.
+     * @param       i : The position of the node.
+     */
+    void sift_down(std::size_t i)
+    {
+        const std::size_t sz = nods_.size();
+        node nod = std::move(nods_[i]);
+        std::size_t first_chld;
+        std::size_t last_chld;
+        std::size_t best;
+        std::size_t j;
+        
+        while ((first_chld = i * D + 1) < sz)
+        {
+            last_chld = first_chld + D < sz ? first_chld + D : sz;
+            best = first_chld;
+            
+            for (j = first_chld + 1; j < last_chld; ++j)
+            {
+                if (comp_(nods_[j].val_, nods_[best].val_))
+                {
+                    best = j;
+                }
+            }
+            
+            if (!comp_(nods_[best].val_, nod.val_))
+            {
+                break;
+            }
+            
+            nods_[i] = std::move(nods_[best]);
+            pos_[nods_[i].hndl_] = i;
+            i = best;
+        }
+        
+        pos_[nod.hndl_] = i;
+        nods_[i] = std::move(nod);
+    }
+    
+    /**
+     * @brief       Restore the heap order of all the nodes in O(n).
+     */
+    void heapify()
+    {
+        if (nods_.size() > 1)
+        {
+            for (std::size_t i = (nods_.size() - 2) / D + 1; i-- > 0;)
+            {
+                sift_down(i);
+            }
+        }
+    }
+    
+    /** The heap nodes. */
+    std::vector<node, allocator_type<node>> nods_;
+    
+    /** The heap position of each handle. */
+    std::vector<std::size_t, allocator_type<std::size_t>> pos_;
+    
+    /** The handles that can be reused. */
+    std::vector<handle_type, allocator_type<handle_type>> free_hndls_;
+    
+    /** The comparator. */
+    compare_type comp_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,769 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/elias_fano_sequence.hpp
+ * @brief      elias_fano_sequence class header.
+ * @author     Killian
+ * @date       2018/09/20 - 11:20
+ */
+
+#ifndef SPEED_CONTAINERS_ELIAS_FANO_SEQUENCE_HPP
+#define SPEED_CONTAINERS_ELIAS_FANO_SEQUENCE_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "bit_packing.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents a read-only view over a sorted sequence of unsigned integers
+ *              encoded with Elias-Fano coding. The view does not own the words, so it can be
+ *              placed directly over a buffer filled by elias_fano_sequence::serialize, for
+ *              instance a memory mapped file. Every element is split in l low bits, stored packed,
+ *              and high bits, stored in unary in a bit vector, which takes less than 2 + l bits per
+ *              element.
+ */
+template<typename TpValue = std::uint64_t>
+class elias_fano_view
+{
+    static_assert(std::is_unsigned<TpValue>::value, "The value type has to be unsigned");
+
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** Identifies the buffers filled by serialize. */
+    static constexpr std::uint64_t MAGIC = 0x5145534f4e414645ULL;
+    
+    /** Number of words of the serialization header. */
+    static constexpr std::size_t HEADER_WORDS = 8;
+    
+    /** Number of ones, or zeros, between two samples used to speed up the select queries. */
+    static constexpr std::size_t SAMPLE_RATE = 256;
+    
+    /**
+     * @brief       Default constructor. The view is empty.
+     */
+    elias_fano_view() noexcept
+            : lowr_(nullptr)
+            , uppr_(nullptr)
+            , smpls1_(nullptr)
+            , smpls0_(nullptr)
+            , n_(0)
+            , lst_(0)
+            , l_(0)
+            , buf_sz_(0)
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters. Only the header of the buffer is checked, so the
+     *              construction does not touch the encoded elements.
+     * @param       buf : The buffer filled by elias_fano_sequence::serialize. It must be aligned
+     *              on 8 bytes and outlive the view.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    elias_fano_view(const void* buf, std::size_t buf_sz)
+            : elias_fano_view()
+    {
+        const std::uint64_t* wrds = static_cast<const std::uint64_t*>(buf);
+        std::uint64_t n;
+        std::uint64_t lst;
+        std::uint64_t l;
+        std::uint64_t nbr_zeros;
+        std::uint64_t nbr_lowr_wrds;
+        std::uint64_t nbr_uppr_wrds;
+        std::uint64_t nbr_smpls1;
+        std::uint64_t nbr_smpls0;
+        
+        if (buf == nullptr || reinterpret_cast<std::uintptr_t>(buf) % sizeof(std::uint64_t) != 0 ||
+            buf_sz % sizeof(std::uint64_t) != 0 || buf_sz < HEADER_WORDS * sizeof(std::uint64_t) ||
+            wrds[0] != MAGIC || wrds[1] != sizeof(value_type))
+        {
+            throw deserialization_exception();
+        }
+        
+        n = wrds[2];
+        lst = wrds[3];
+        l = wrds[4];
+        
+        if (n > buf_sz * 8 || lst > std::numeric_limits<value_type>::max() ||
+            l != get_low_bits(n, lst) || wrds[5] != n + (lst >> l) + 1)
+        {
+            throw deserialization_exception();
+        }
+        
+        nbr_zeros = (lst >> l) + 1;
+        nbr_lowr_wrds = (n * l + 63) / 64 + 1;
+        nbr_uppr_wrds = (wrds[5] + 63) / 64 + 1;
+        nbr_smpls1 = (n + SAMPLE_RATE - 1) / SAMPLE_RATE;
+        nbr_smpls0 = (nbr_zeros + SAMPLE_RATE - 1) / SAMPLE_RATE;
+        
+        if (wrds[6] != nbr_smpls1 || wrds[7] != nbr_smpls0 ||
+            buf_sz / sizeof(std::uint64_t) !=
+                    HEADER_WORDS + nbr_lowr_wrds + nbr_uppr_wrds + nbr_smpls1 + nbr_smpls0)
+        {
+            throw deserialization_exception();
+        }
+        
+        lowr_ = wrds + HEADER_WORDS;
+        uppr_ = lowr_ + nbr_lowr_wrds;
+        smpls1_ = uppr_ + nbr_uppr_wrds;
+        smpls0_ = smpls1_ + nbr_smpls1;
+        n_ = static_cast<std::size_t>(n);
+        lst_ = static_cast<value_type>(lst);
+        l_ = static_cast<std::size_t>(l);
+        buf_sz_ = buf_sz;
+    }
+    
+    /**
+     * @brief       Get an element without bounds checking.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     */
+    [[nodiscard]] value_type get(std::size_t idx) const noexcept
+    {
+        return static_cast<value_type>(((select1(idx) - idx) << l_) |
+                                       __hidden_containers::get_packed_value(lowr_, l_, idx));
+    }
+    
+    /**
+     * @brief       Get an element.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     * @throw       speed::containers::out_of_range_exception : If the index is not lower than the
+     *              size an exception is thrown.
+     */
+    [[nodiscard]] value_type at(std::size_t idx) const
+    {
+        if (idx >= n_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return get(idx);
+    }
+    
+    /**
+     * @brief       Get the index of the first element that is greater than or equal to a value.
+     *              The high bits of the value select a bucket in constant time, so only the
+     *              elements sharing the same high bits are scanned.
+     * @param       x : The value to look for.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    [[nodiscard]] std::size_t next_geq(value_type x) const noexcept
+    {
+        value_type val;
+        
+        return next_geq(x, val);
+    }
+    
+    /**
+     * @brief       Get the index and the value of the first element that is greater than or equal
+     *              to a value.
+     * @param       x : The value to look for.
+     * @param       val : Set with the element found, if any.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    std::size_t next_geq(value_type x, value_type& val) const noexcept
+    {
+        if (n_ == 0 || x > lst_)
+        {
+            return n_;
+        }
+        
+        const std::size_t hgh = static_cast<std::size_t>(x >> l_);
+        std::size_t pos = hgh == 0 ? 0 : select0(hgh - 1) + 1;
+        std::size_t idx = pos - hgh;
+        std::size_t wrd_idx = pos >> 6;
+        std::uint64_t wrd = uppr_[wrd_idx] & (~std::uint64_t(0) << (pos & 63));
+        
+        for (;; ++idx, wrd &= wrd - 1)
+        {
+            while (wrd == 0)
+            {
+                wrd = uppr_[++wrd_idx];
+            }
+            
+            pos = (wrd_idx << 6) + __hidden_containers::get_trailing_zeros(wrd);
+            val = static_cast<value_type>(((pos - idx) << l_) |
+                                          __hidden_containers::get_packed_value(lowr_, l_, idx));
+            
+            if (val >= x)
+            {
+                return idx;
+            }
+        }
+    }
+    
+    /**
+     * @brief       Copy consecutive elements into a regular array. The low bits are unpacked 8 at
+     *              a time with AVX2 when the elements are 32 bits integers.
+     * @param       first : The index of the first element to copy.
+     * @param       cnt : The number of elements to copy.
+     * @param       out : The destination array.
+     * @throw       speed::containers::out_of_range_exception : If the range exceeds the size an
+     *              exception is thrown.
+     */
+    void decode(std::size_t first, std::size_t cnt, value_type* out) const
+    {
+        if (first > n_ || cnt > n_ - first)
+        {
+            throw out_of_range_exception();
+        }
+        
+        if (cnt == 0)
+        {
+            return;
+        }
+        
+        __hidden_containers::unpack_values(lowr_, l_, first, cnt, out);
+        
+        const std::size_t pos = select1(first);
+        std::size_t wrd_idx = pos >> 6;
+        std::uint64_t wrd = uppr_[wrd_idx] & (~std::uint64_t(0) << (pos & 63));
+        
+        for (std::size_t i = 0; i < cnt; ++i, wrd &= wrd - 1)
+        {
+            while (wrd == 0)
+            {
+                wrd = uppr_[++wrd_idx];
+            }
+            
+            out[i] |= static_cast<value_type>(
+                    ((wrd_idx << 6) + __hidden_containers::get_trailing_zeros(wrd) - first - i)
+                            << l_);
+        }
+    }
+    
+    /**
+     * @brief       Get the last element.
+     * @return      The last element, or 0 if the sequence is empty.
+     */
+    [[nodiscard]] inline value_type back() const noexcept
+    {
+        return lst_;
+    }
+    
+    /**
+     * @brief       Get the number of low bits stored per element.
+     * @return      The number of low bits stored per element.
+     */
+    [[nodiscard]] inline std::size_t get_low_bits() const noexcept
+    {
+        return l_;
+    }
+    
+    /**
+     * @brief       Get the size in bytes of the buffer holding the sequence.
+     * @return      The size in bytes of the buffer holding the sequence.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return buf_sz_;
+    }
+    
+    /**
+     * @brief       Check whether the sequence is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return n_ == 0;
+    }
+    
+    /**
+     * @brief       Get the number of elements.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return n_;
+    }
+    
+    /**
+     * @brief       Get the number of low bits that minimizes the size of a sequence.
+     * @param       n : The number of elements.
+     * @param       lst : The last element.
+     * @return      The number of low bits that minimizes the size of the sequence.
+     */
+    [[nodiscard]] static constexpr std::uint64_t get_low_bits(
+            std::uint64_t n,
+            std::uint64_t lst
+    ) noexcept
+    {
+        return n == 0 || lst / n == 0 ? 0 : __hidden_containers::get_bit_width(lst / n) - 1;
+    }
+
+private:
+    /**
+     * @brief       Get the position of a bit set in the upper bits.
+     * @param       rnk : The rank of the bit set, starting at 0.
+     * @return      The position of the bit set.
+     */
+    std::size_t select1(std::size_t rnk) const noexcept
+    {
+        const std::size_t pos = static_cast<std::size_t>(smpls1_[rnk / SAMPLE_RATE]);
+        std::size_t wrd_idx = pos >> 6;
+        std::uint64_t wrd = uppr_[wrd_idx] & (~std::uint64_t(0) << (pos & 63));
+        std::size_t cnt;
+        
+        rnk %= SAMPLE_RATE;
+        while ((cnt = __hidden_containers::get_popcount(wrd)) <= rnk)
+        {
+            rnk -= cnt;
+            wrd = uppr_[++wrd_idx];
+        }
+        
+        return (wrd_idx << 6) + __hidden_containers::select_in_word(wrd, rnk);
+    }
+    
+    /**
+     * @brief       Get the position of a bit cleared in the upper bits.
+     * @param       rnk : The rank of the bit cleared, starting at 0.
+     * @return      The position of the bit cleared.
+     */
+    std::size_t select0(std::size_t rnk) const noexcept
+    {
+        const std::size_t pos = static_cast<std::size_t>(smpls0_[rnk / SAMPLE_RATE]);
+        std::size_t wrd_idx = pos >> 6;
+        std::uint64_t wrd = ~uppr_[wrd_idx] & (~std::uint64_t(0) << (pos & 63));
+        std::size_t cnt;
+        
+        rnk %= SAMPLE_RATE;
+        while ((cnt = __hidden_containers::get_popcount(wrd)) <= rnk)
+        {
+            rnk -= cnt;
+            wrd = ~uppr_[++wrd_idx];
+        }
+        
+        return (wrd_idx << 6) + __hidden_containers::select_in_word(wrd, rnk);
+    }
+    
+    /** The low bits of the elements, followed by a padding word. */
+    const std::uint64_t* lowr_;
+    
+    /** The high bits of the elements in unary, followed by a padding word. */
+    const std::uint64_t* uppr_;
+    
+    /** The positions of one bit set out of SAMPLE_RATE in the upper bits. */
+    const std::uint64_t* smpls1_;
+    
+    /** The positions of one bit cleared out of SAMPLE_RATE in the upper bits. */
+    const std::uint64_t* smpls0_;
+    
+    /** The number of elements. */
+    std::size_t n_;
+    
+    /** The last element. */
+    value_type lst_;
+    
+    /** The number of low bits per element. */
+    std::size_t l_;
+    
+    /** The size of the buffer in bytes. */
+    std::size_t buf_sz_;
+};
+
+
+/**
+ * @brief       Class that represents a sorted sequence of unsigned integers compressed with
+ *              Elias-Fano coding. The words are laid out exactly as in the serialized buffer, so
+ *              the buffer can be written to a file and later served with an elias_fano_view over a
+ *              memory mapping, without decoding. The buffer uses the host endianness.
+ */
+template<typename TpValue = std::uint64_t, typename TpAllocator = std::allocator<int>>
+class elias_fano_sequence
+{
+public:
+    /** The value type. */
+    using value_type = TpValue;
+    
+    /** The view type. */
+    using view_type = elias_fano_view<TpValue>;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /**
+     * @brief       Default constructor. The sequence is empty.
+     */
+    elias_fano_sequence()
+            : elias_fano_sequence(static_cast<const value_type*>(nullptr),
+                                  static_cast<const value_type*>(nullptr))
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       first : Iterator to the first element of the range.
+     * @param       last : Iterator to the past-the-end element of the range.
+     * @throw       speed::containers::insertion_exception : If the range is not sorted an
+     *              exception is thrown.
+     */
+    template<typename TpForwardIterator>
+    elias_fano_sequence(TpForwardIterator first, TpForwardIterator last)
+            : wrds_()
+            , vw_()
+    {
+        constexpr std::size_t SAMPLE_RATE = view_type::SAMPLE_RATE;
+        std::uint64_t n = 0;
+        std::uint64_t lst = 0;
+        std::uint64_t val;
+        std::uint64_t pos;
+        std::uint64_t zero_cnt;
+        std::uint64_t wrd;
+        std::uint64_t cnt;
+        
+        for (auto it = first; it != last; ++it, ++n)
+        {
+            if (static_cast<std::uint64_t>(*it) < lst)
+            {
+                throw insertion_exception();
+            }
+            
+            lst = static_cast<std::uint64_t>(*it);
+        }
+        
+        const std::uint64_t l = view_type::get_low_bits(n, lst);
+        const std::uint64_t nbr_uppr_bits = n + (lst >> l) + 1;
+        const std::uint64_t nbr_zeros = (lst >> l) + 1;
+        const std::size_t nbr_lowr_wrds = static_cast<std::size_t>((n * l + 63) / 64 + 1);
+        const std::size_t nbr_uppr_wrds = static_cast<std::size_t>((nbr_uppr_bits + 63) / 64 + 1);
+        const std::size_t nbr_smpls1 = static_cast<std::size_t>(
+                (n + SAMPLE_RATE - 1) / SAMPLE_RATE);
+        
+        wrds_.assign(view_type::HEADER_WORDS + nbr_lowr_wrds + nbr_uppr_wrds + nbr_smpls1 +
+                     (nbr_zeros + SAMPLE_RATE - 1) / SAMPLE_RATE, 0);
+        wrds_[0] = view_type::MAGIC;
+        wrds_[1] = sizeof(value_type);
+        wrds_[2] = n;
+        wrds_[3] = lst;
+        wrds_[4] = l;
+        wrds_[5] = nbr_uppr_bits;
+        wrds_[6] = nbr_smpls1;
+        wrds_[7] = (nbr_zeros + SAMPLE_RATE - 1) / SAMPLE_RATE;
+        
+        std::uint64_t* lowr = wrds_.data() + view_type::HEADER_WORDS;
+        std::uint64_t* uppr = lowr + nbr_lowr_wrds;
+        std::uint64_t* smpls1 = uppr + nbr_uppr_wrds;
+        std::uint64_t* smpls0 = smpls1 + nbr_smpls1;
+        
+        for (std::size_t i = 0; first != last; ++first, ++i)
+        {
+            val = static_cast<std::uint64_t>(*first);
+            pos = (val >> l) + i;
+            __hidden_containers::set_packed_value(lowr, l, i, val);
+            uppr[pos >> 6] |= std::uint64_t(1) << (pos & 63);
+            
+            if (i % SAMPLE_RATE == 0)
+            {
+                smpls1[i / SAMPLE_RATE] = pos;
+            }
+        }
+        
+        zero_cnt = 0;
+        for (std::size_t i = 0; zero_cnt < nbr_zeros; ++i)
+        {
+            wrd = ~uppr[i];
+            cnt = __hidden_containers::get_popcount(wrd);
+            
+            for (pos = (zero_cnt + SAMPLE_RATE - 1) / SAMPLE_RATE * SAMPLE_RATE;
+                 pos < zero_cnt + cnt && pos < nbr_zeros; pos += SAMPLE_RATE)
+            {
+                smpls0[pos / SAMPLE_RATE] = (i << 6) + __hidden_containers::select_in_word(
+                        wrd, static_cast<std::size_t>(pos - zero_cnt));
+            }
+            
+            zero_cnt += cnt;
+        }
+        
+        reset_view();
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       il : The sorted elements.
+     * @throw       speed::containers::insertion_exception : If the elements are not sorted an
+     *              exception is thrown.
+     */
+    elias_fano_sequence(std::initializer_list<value_type> il)
+            : elias_fano_sequence(il.begin(), il.end())
+    {
+    }
+    
+    /**
+     * @brief       Copy constructor.
+     * @param       rhs : The object to copy.
+     */
+    elias_fano_sequence(const elias_fano_sequence& rhs)
+            : wrds_(rhs.wrds_)
+            , vw_()
+    {
+        reset_view();
+    }
+    
+    /**
+     * @brief       Move constructor.
+     * @param       rhs : The object to move.
+     */
+    elias_fano_sequence(elias_fano_sequence&& rhs) noexcept
+            : wrds_(std::move(rhs.wrds_))
+            , vw_(rhs.vw_)
+    {
+        rhs.vw_ = view_type();
+    }
+    
+    /**
+     * @brief       Copy assignment operator.
+     * @param       rhs : The object to copy.
+     * @return      The object who call the method.
+     */
+    elias_fano_sequence& operator =(const elias_fano_sequence& rhs)
+    {
+        if (this != &rhs)
+        {
+            wrds_ = rhs.wrds_;
+            reset_view();
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Move assignment operator.
+     * @param       rhs : The object to move.
+     * @return      The object who call the method.
+     */
+    elias_fano_sequence& operator =(elias_fano_sequence&& rhs) noexcept
+    {
+        if (this != &rhs)
+        {
+            wrds_ = std::move(rhs.wrds_);
+            vw_ = rhs.vw_;
+            rhs.vw_ = view_type();
+        }
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Get an element without bounds checking.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     */
+    [[nodiscard]] inline value_type get(std::size_t idx) const noexcept
+    {
+        return vw_.get(idx);
+    }
+    
+    /**
+     * @brief       Get an element.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     * @throw       speed::containers::out_of_range_exception : If the index is not lower than the
+     *              size an exception is thrown.
+     */
+    [[nodiscard]] inline value_type at(std::size_t idx) const
+    {
+        return vw_.at(idx);
+    }
+    
+    /**
+     * @brief       Get the index of the first element that is greater than or equal to a value.
+     * @param       x : The value to look for.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    [[nodiscard]] inline std::size_t next_geq(value_type x) const noexcept
+    {
+        return vw_.next_geq(x);
+    }
+    
+    /**
+     * @brief       Get the index and the value of the first element that is greater than or equal
+     *              to a value.
+     * @param       x : The value to look for.
+     * @param       val : Set with the element found, if any.
+     * @return      The index of the first element that is not lower than the value, or size() if
+     *              there is no such element.
+     */
+    inline std::size_t next_geq(value_type x, value_type& val) const noexcept
+    {
+        return vw_.next_geq(x, val);
+    }
+    
+    /**
+     * @brief       Copy consecutive elements into a regular array.
+     * @param       first : The index of the first element to copy.
+     * @param       cnt : The number of elements to copy.
+     * @param       out : The destination array.
+     * @throw       speed::containers::out_of_range_exception : If the range exceeds the size an
+     *              exception is thrown.
+     */
+    inline void decode(std::size_t first, std::size_t cnt, value_type* out) const
+    {
+        vw_.decode(first, cnt, out);
+    }
+    
+    /**
+     * @brief       Serialize the sequence in a byte buffer. The buffer holds the words of the
+     *              sequence in the host endianness.
+     * @return      The buffer holding the sequence.
+     */
+    [[nodiscard]] std::vector<std::uint8_t> serialize() const
+    {
+        std::vector<std::uint8_t> buf(get_size_in_bytes());
+        
+        std::memcpy(buf.data(), wrds_.data(), buf.size());
+        
+        return buf;
+    }
+    
+    /**
+     * @brief       Build a sequence from a buffer filled by serialize. The buffer is copied, use an
+     *              elias_fano_view to access it in place.
+     * @param       buf : The buffer.
+     * @param       buf_sz : The size of the buffer in bytes.
+     * @return      The deserialized sequence.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    static elias_fano_sequence deserialize(const std::uint8_t* buf, std::size_t buf_sz)
+    {
+        elias_fano_sequence efs;
+        
+        if (buf_sz % sizeof(std::uint64_t) != 0)
+        {
+            throw deserialization_exception();
+        }
+        
+        efs.wrds_.resize(buf_sz / sizeof(std::uint64_t));
+        std::memcpy(efs.wrds_.data(), buf, buf_sz);
+        efs.vw_ = view_type(efs.wrds_.data(), buf_sz);
+        
+        return efs;
+    }
+    
+    /**
+     * @brief       Build a sequence from a buffer filled by serialize.
+     * @param       buf : The buffer.
+     * @return      The deserialized sequence.
+     * @throw       speed::containers::deserialization_exception : If the buffer does not hold a
+     *              valid sequence an exception is thrown.
+     */
+    static elias_fano_sequence deserialize(const std::vector<std::uint8_t>& buf)
+    {
+        return deserialize(buf.data(), buf.size());
+    }
+    
+    /**
+     * @brief       Get a view over the sequence.
+     * @return      A view over the sequence, valid while the sequence is not modified.
+     */
+    [[nodiscard]] inline const view_type& get_view() const noexcept
+    {
+        return vw_;
+    }
+    
+    /**
+     * @brief       Get the words of the sequence, laid out as in the serialized buffer.
+     * @return      The words of the sequence.
+     */
+    [[nodiscard]] inline const std::uint64_t* data() const noexcept
+    {
+        return wrds_.data();
+    }
+    
+    /**
+     * @brief       Get the last element.
+     * @return      The last element, or 0 if the sequence is empty.
+     */
+    [[nodiscard]] inline value_type back() const noexcept
+    {
+        return vw_.back();
+    }
+    
+    /**
+     * @brief       Get the size of the sequence in bytes.
+     * @return      The size of the sequence in bytes.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return wrds_.size() * sizeof(std::uint64_t);
+    }
+    
+    /**
+     * @brief       Check whether the sequence is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return vw_.empty();
+    }
+    
+    /**
+     * @brief       Get the number of elements.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return vw_.size();
+    }
+
+private:
+    /**
+     * @brief       Build the view over the words.
+     */
+    void reset_view()
+    {
+        vw_ = view_type(wrds_.data(), get_size_in_bytes());
+    }
+    
+    /** The words of the sequence, laid out as in the serialized buffer. */
+    std::vector<std::uint64_t, allocator_type<std::uint64_t>> wrds_;
+    
+    /** The view over the words. */
+    view_type vw_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,332 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/epoch_based_reclamation.hpp
+ * @brief      epoch_based_reclamation class header.
+ * @author     Killian
+ * @date       2018/09/15 - 14:03
+ */
+
+#ifndef SPEED_CONTAINERS_EPOCH_BASED_RECLAMATION_HPP
+#define SPEED_CONTAINERS_EPOCH_BASED_RECLAMATION_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that implements a process-wide epoch based memory reclamation domain, used by
+ *              the lock-free containers. A thread reads shared nodes only inside a critical section
+ *              (see guard), and a node unlinked from a container is retired instead of deleted.
+ *              A retired node is deleted once the global epoch has advanced twice since it was
+ *              retired, which guarantees that no thread is still in a critical section that could
+ *              have seen it.
+ */
+class epoch_based_reclamation
+{
+public:
+    /** Type of the functions used to delete retired objects. */
+    using deleter_type = void (*)(void*);
+    
+    /** Number of retired objects per thread that triggers a collection. */
+    static constexpr std::size_t COLLECT_THRESHOLD = 64;
+    
+    /**
+     * @brief       Class that represents a critical section. The shared nodes read while the object
+     *              is alive are not deleted. Critical sections can be nested.
+     */
+    class guard
+    {
+    public:
+        /**
+         * @brief       Default constructor. Enter the critical section.
+         */
+        guard() noexcept
+        {
+            epoch_based_reclamation::enter();
+        }
+        
+        /** @cond */
+        guard(const guard& rhs) = delete;
+        
+        guard& operator =(const guard& rhs) = delete;
+        /** @endcond */
+        
+        /**
+         * @brief       Destructor. Leave the critical section.
+         */
+        ~guard()
+        {
+            epoch_based_reclamation::leave();
+        }
+    };
+    
+    /**
+     * @brief       Enter a critical section. On x86 the local epoch is published with a locked
+     *              exchange, which is a full barrier on its own. The compilers implement the
+     *              equivalent fence as a locked operation on the stack, which stalls on the stack
+     *              slots that the caller has just written.
+     */
+    static void enter() noexcept
+    {
+        thread_record* rec = get_thread_record();
+        
+        if (rec->nest_++ == 0)
+        {
+#if defined(__x86_64__) || defined(__i386__)
+            rec->local_epoch_.exchange(global_epoch_.load(std::memory_order_relaxed),
+                                       std::memory_order_seq_cst);
+#else
+            rec->local_epoch_.store(global_epoch_.load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+        }
+    }
+    
+    /**
+     * @brief       Leave a critical section.
+     */
+    static void leave() noexcept
+    {
+        thread_record* rec = get_thread_record();
+        
+        if (--rec->nest_ == 0)
+        {
+            rec->local_epoch_.store(INACTIVE, std::memory_order_release);
+        }
+    }
+    
+    /**
+     * @brief       Retire an object that is no longer reachable from any shared structure. The
+     *              object is deleted when no critical section can reference it anymore.
+     * @param       obj : The object to retire.
+     * @param       del : The function used to delete the object.
+     */
+    static void retire(void* obj, deleter_type del)
+    {
+        thread_record* rec = get_thread_record();
+        
+        rec->retired_.push_back({obj, del, global_epoch_.load(std::memory_order_seq_cst)});
+        
+        if (rec->retired_.size() >= COLLECT_THRESHOLD)
+        {
+            try_advance();
+            collect_thread_record(rec);
+        }
+    }
+    
+    /**
+     * @brief       Retire an object allocated with new.
+     * @param       obj : The object to retire.
+     */
+    template<typename T>
+    static void retire(T* obj)
+    {
+        retire(static_cast<void*>(obj), [](void* p) { delete static_cast<T*>(p); });
+    }
+    
+    /**
+     * @brief       Try to advance the global epoch and delete the objects retired by the calling
+     *              thread that are safe to delete.
+     * @return      The number of objects of the calling thread still waiting to be deleted.
+     */
+    static std::size_t collect()
+    {
+        thread_record* rec = get_thread_record();
+        
+        try_advance();
+        try_advance();
+        collect_thread_record(rec);
+        
+        return rec->retired_.size();
+    }
+
+private:
+    /** Local epoch value of the threads that are not in a critical section. */
+    static constexpr std::uint64_t INACTIVE = std::numeric_limits<std::uint64_t>::max();
+    
+    /**
+     * @brief       Struct that represents a retired object.
+     */
+    struct retired_object
+    {
+        /** The object. */
+        void* obj_;
+        
+        /** The object deleter. */
+        deleter_type del_;
+        
+        /** The global epoch when the object was retired. */
+        std::uint64_t epch_;
+    };
+    
+    /**
+     * @brief       Struct that represents the state of a thread in the domain. The records are
+     *              never freed, they are reused by new threads.
+     */
+    struct alignas(64) thread_record
+    {
+        /** The epoch observed when entering the critical section, or INACTIVE. */
+        std::atomic<std::uint64_t> local_epoch_{INACTIVE};
+        
+        /** Whether the record is owned by a thread. */
+        std::atomic<bool> in_use_{true};
+        
+        /** The next record. */
+        thread_record* nxt_ = nullptr;
+        
+        /** The critical section nesting level. */
+        std::size_t nest_ = 0;
+        
+        /** The objects retired by the thread. */
+        std::vector<retired_object> retired_;
+    };
+    
+    /**
+     * @brief       Struct that releases the record of a thread when it exits.
+     */
+    struct thread_record_owner
+    {
+        /** The owned record. */
+        thread_record* rec_ = nullptr;
+        
+        /**
+         * @brief       Destructor.
+         */
+        ~thread_record_owner()
+        {
+            if (rec_ != nullptr)
+            {
+                try_advance();
+                collect_thread_record(rec_);
+                rec_->in_use_.store(false, std::memory_order_release);
+            }
+        }
+    };
+    
+    /**
+     * @brief       Get the record of the calling thread, acquiring one if needed.
+     * @return      The record of the calling thread.
+     */
+    static thread_record* get_thread_record()
+    {
+        thread_local thread_record_owner ownr;
+        thread_record* rec;
+        bool expctd;
+        
+        if (ownr.rec_ != nullptr)
+        {
+            return ownr.rec_;
+        }
+        
+        for (rec = recs_.load(std::memory_order_acquire); rec != nullptr; rec = rec->nxt_)
+        {
+            expctd = false;
+            
+            if (!rec->in_use_.load(std::memory_order_relaxed) &&
+                rec->in_use_.compare_exchange_strong(expctd, true, std::memory_order_acquire))
+            {
+                ownr.rec_ = rec;
+                return rec;
+            }
+        }
+        
+        rec = new thread_record();
+        rec->nxt_ = recs_.load(std::memory_order_relaxed);
+        
+        while (!recs_.compare_exchange_weak(rec->nxt_, rec, std::memory_order_release,
+                                            std::memory_order_relaxed))
+        {
+        }
+        
+        ownr.rec_ = rec;
+        
+        return rec;
+    }
+    
+    /**
+     * @brief       Advance the global epoch if every thread in a critical section has observed it.
+     * @return      If the epoch has been advanced true is returned, otherwise false is returned.
+     */
+    static bool try_advance() noexcept
+    {
+        std::uint64_t epch = global_epoch_.load(std::memory_order_seq_cst);
+        std::uint64_t local_epch;
+        
+        for (thread_record* rec = recs_.load(std::memory_order_acquire); rec != nullptr;
+             rec = rec->nxt_)
+        {
+            local_epch = rec->local_epoch_.load(std::memory_order_seq_cst);
+            
+            if (local_epch != INACTIVE && local_epch != epch)
+            {
+                return false;
+            }
+        }
+        
+        return global_epoch_.compare_exchange_strong(epch, epch + 1, std::memory_order_seq_cst);
+    }
+    
+    /**
+     * @brief       Delete the objects of a record that are safe to delete.
+     * @param       rec : The record.
+     */
+    static void collect_thread_record(thread_record* rec) noexcept
+    {
+        const std::uint64_t epch = global_epoch_.load(std::memory_order_seq_cst);
+        std::size_t i;
+        std::size_t j;
+        
+        for (i = 0, j = 0; i < rec->retired_.size(); ++i)
+        {
+            if (rec->retired_[i].epch_ + 2 <= epch)
+            {
+                rec->retired_[i].del_(rec->retired_[i].obj_);
+            }
+            else
+            {
+                rec->retired_[j++] = rec->retired_[i];
+            }
+        }
+        
+        rec->retired_.resize(j);
+    }
+    
+    /** The global epoch. */
+    inline static std::atomic<std::uint64_t> global_epoch_{0};
+    
+    /** The list of thread records. */
+    inline static std::atomic<thread_record*> recs_{nullptr};
+};
+
+
+}
+}
+
+
+#endif
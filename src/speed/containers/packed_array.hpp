@@ -0,0 +1,340 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/packed_array.hpp
+ * @brief      packed_array class header.
+ * @author     Killian
+ * @date       2018/09/19 - 10:05
+ */
+
+#ifndef SPEED_CONTAINERS_PACKED_ARRAY_HPP
+#define SPEED_CONTAINERS_PACKED_ARRAY_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "bit_packing.hpp"
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents an array of unsigned integers packed with a fixed number of
+ *              bits per element, from 1 to 64. When BITS is 0 the number of bits is chosen at
+ *              runtime, for instance from the maximum of the data. The elements are stored
+ *              contiguously in 64 bits words, so an element can overlap two words.
+ */
+template<std::size_t BITS = 0, typename TpAllocator = std::allocator<int>>
+class packed_array
+{
+    static_assert(BITS <= 64, "The number of bits per element has to be in [1, 64], or 0");
+
+public:
+    /** The value type. */
+    using value_type = std::uint64_t;
+    
+    /** The allocator type. */
+    template<typename T>
+    using allocator_type = typename TpAllocator::template rebind<T>::other;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       sz : The number of elements, initialized to 0.
+     * @param       bits : The number of bits per element. It must be BITS if BITS is not 0.
+     * @throw       speed::containers::out_of_range_exception : If the number of bits is not valid
+     *              an exception is thrown.
+     */
+    explicit packed_array(std::size_t sz = 0, std::size_t bits = BITS == 0 ? 64 : BITS)
+            : wrds_()
+            , sz_(0)
+            , bits_(bits)
+    {
+        if (bits == 0 || bits > 64 || (BITS != 0 && bits != BITS))
+        {
+            throw out_of_range_exception();
+        }
+        
+        resize(sz);
+    }
+    
+    /**
+     * @brief       Constructor with parameters. If BITS is 0, the number of bits per element is
+     *              the number of bits of the greatest element of the range.
+     * @param       first : Iterator to the first element of the range.
+     * @param       last : Iterator to the past-the-end element of the range.
+     * @throw       speed::containers::out_of_range_exception : If an element does not fit in BITS
+     *              bits an exception is thrown.
+     */
+    template<
+            typename TpForwardIterator,
+            typename = std::enable_if_t<!std::is_integral<TpForwardIterator>::value>
+    >
+    packed_array(TpForwardIterator first, TpForwardIterator last)
+            : wrds_()
+            , sz_(0)
+            , bits_(BITS)
+    {
+        value_type max_val = 0;
+        std::size_t sz = 0;
+        
+        for (auto it = first; it != last; ++it, ++sz)
+        {
+            max_val |= static_cast<value_type>(*it);
+        }
+        
+        if (BITS == 0)
+        {
+            bits_ = get_bit_width(max_val);
+        }
+        else if (get_bit_width(max_val) > BITS)
+        {
+            throw out_of_range_exception();
+        }
+        
+        resize(sz);
+        
+        for (std::size_t i = 0; first != last; ++first, ++i)
+        {
+            set(i, static_cast<value_type>(*first));
+        }
+    }
+    
+    /**
+     * @brief       Get an element without bounds checking.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     */
+    [[nodiscard]] inline value_type get(std::size_t idx) const noexcept
+    {
+        return __hidden_containers::get_packed_value(wrds_.data(), get_bits(), idx);
+    }
+    
+    /**
+     * @brief       Get an element.
+     * @param       idx : The index of the element.
+     * @return      The element.
+     * @throw       speed::containers::out_of_range_exception : If the index is not lower than the
+     *              size an exception is thrown.
+     */
+    [[nodiscard]] value_type at(std::size_t idx) const
+    {
+        if (idx >= sz_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return get(idx);
+    }
+    
+    /**
+     * @brief       Set an element without bounds checking. Only the low bits of the value that fit
+     *              in an element are kept.
+     * @param       idx : The index of the element.
+     * @param       val : The new value.
+     */
+    inline void set(std::size_t idx, value_type val) noexcept
+    {
+        __hidden_containers::set_packed_value(wrds_.data(), get_bits(), idx, val);
+    }
+    
+    /**
+     * @brief       Insert an element at the end of the array.
+     * @param       val : The value to insert. Only the low bits that fit in an element are kept.
+     */
+    void push_back(value_type val)
+    {
+        resize(sz_ + 1);
+        set(sz_ - 1, val);
+    }
+    
+    /**
+     * @brief       Change the number of elements. The new elements are set to 0.
+     * @param       sz : The new number of elements.
+     */
+    void resize(std::size_t sz)
+    {
+        const std::size_t old_sz = sz_;
+        
+        wrds_.resize((sz * get_bits() + 63) / 64 + 1, 0);
+        sz_ = sz;
+        
+        if (sz < old_sz)
+        {
+            clear_unused_bits();
+        }
+    }
+    
+    /**
+     * @brief       Copy consecutive elements into a regular array. The elements are unpacked 8 at
+     *              a time with AVX2 when the destination holds 32 bits integers and an element
+     *              has at most 25 bits.
+     * @param       first : The index of the first element to copy.
+     * @param       cnt : The number of elements to copy.
+     * @param       out : The destination array.
+     * @throw       speed::containers::out_of_range_exception : If the range exceeds the size an
+     *              exception is thrown.
+     */
+    template<typename TpIntegral>
+    void decode(std::size_t first, std::size_t cnt, TpIntegral* out) const
+    {
+        if (first > sz_ || cnt > sz_ - first)
+        {
+            throw out_of_range_exception();
+        }
+        
+        __hidden_containers::unpack_values(wrds_.data(), get_bits(), first, cnt, out);
+    }
+    
+    /**
+     * @brief       Erase all the elements.
+     */
+    void clear() noexcept
+    {
+        wrds_.assign(1, 0);
+        sz_ = 0;
+    }
+    
+    /**
+     * @brief       Get the number of bits per element.
+     * @return      The number of bits per element.
+     */
+    [[nodiscard]] inline std::size_t get_bits() const noexcept
+    {
+        if constexpr (BITS != 0)
+        {
+            return BITS;
+        }
+        else
+        {
+            return bits_;
+        }
+    }
+    
+    /**
+     * @brief       Get the greatest value that an element can hold.
+     * @return      The greatest value that an element can hold.
+     */
+    [[nodiscard]] inline value_type get_max_value() const noexcept
+    {
+        return get_mask();
+    }
+    
+    /**
+     * @brief       Get the memory used by the elements in bytes.
+     * @return      The memory used by the elements in bytes.
+     */
+    [[nodiscard]] inline std::size_t get_size_in_bytes() const noexcept
+    {
+        return wrds_.size() * sizeof(value_type);
+    }
+    
+    /**
+     * @brief       Get the words holding the packed elements.
+     * @return      The words holding the packed elements.
+     */
+    [[nodiscard]] inline const value_type* data() const noexcept
+    {
+        return wrds_.data();
+    }
+    
+    /**
+     * @brief       Check whether the array is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return sz_ == 0;
+    }
+    
+    /**
+     * @brief       Get the number of elements.
+     * @return      The number of elements.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return sz_;
+    }
+    
+    /**
+     * @brief       Get the number of bits needed to hold a value.
+     * @param       val : The value.
+     * @return      The number of bits needed to hold the value, at least 1.
+     */
+    [[nodiscard]] static constexpr std::size_t get_bit_width(value_type val) noexcept
+    {
+        return __hidden_containers::get_bit_width(val);
+    }
+
+private:
+    /**
+     * @brief       Get the mask of the bits of an element.
+     * @return      The mask of the bits of an element.
+     */
+    inline value_type get_mask() const noexcept
+    {
+        return __hidden_containers::get_bit_mask(get_bits());
+    }
+    
+    /**
+     * @brief       Set to 0 the bits that follow the last element. The bits are kept at 0, so
+     *              that the elements added by a resize are equal to 0.
+     */
+    void clear_unused_bits() noexcept
+    {
+        const std::size_t bit_pos = sz_ * get_bits();
+        const std::size_t wrd_idx = bit_pos >> 6;
+        
+        if ((bit_pos & 63) != 0)
+        {
+            wrds_[wrd_idx] &= (value_type(1) << (bit_pos & 63)) - 1;
+        }
+        else
+        {
+            wrds_[wrd_idx] = 0;
+        }
+        
+        for (std::size_t i = wrd_idx + 1; i < wrds_.size(); ++i)
+        {
+            wrds_[i] = 0;
+        }
+    }
+    
+    /** The words holding the elements, followed by a padding word. */
+    std::vector<value_type, allocator_type<value_type>> wrds_;
+    
+    /** The number of elements. */
+    std::size_t sz_;
+    
+    /** The number of bits per element. */
+    std::size_t bits_;
+};
+
+
+}
+}
+
+
+#endif
@@ -30,6 +30,7 @@
 #include <cstdlib>
 #include <functional>
 
+#include "../hash.hpp"
 #include "containers_exception.hpp"
 #include "flags.hpp"
 #include "i_const_mutable_iterator.hpp"
@@ -69,7 +70,7 @@ template<
         typename TpKey,
         typename TpValue,
         std::size_t SIZE,
-        typename TpHash = std::hash<TpKey>,
+        typename TpHash = speed::hash::hasher<TpKey>,
         typename TpPred = std::equal_to<TpKey>
 >
 class static_cache
@@ -0,0 +1,667 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file       speed/containers/static_string.hpp
+ * @brief      static_string class header.
+ * @author     Killian
+ * @date       2018/09/18 - 09:14
+ */
+
+#ifndef SPEED_CONTAINERS_STATIC_STRING_HPP
+#define SPEED_CONTAINERS_STATIC_STRING_HPP
+
+#include <cstdlib>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "containers_exception.hpp"
+
+
+namespace speed {
+namespace containers {
+
+
+/**
+ * @brief       Class that represents a string with a compile-time capacity. The characters are
+ *              stored inline and always null-terminated, so the string never allocates, is
+ *              trivially copyable, and can be passed to the functions that expect a C string.
+ */
+template<typename TpChar, std::size_t N>
+class static_string
+{
+public:
+    /** The character type. */
+    using value_type = TpChar;
+    
+    /** The traits type. */
+    using traits_type = std::char_traits<TpChar>;
+    
+    /** The size type. */
+    using size_type = std::size_t;
+    
+    /** The iterator type. */
+    using iterator = TpChar*;
+    
+    /** The const iterator type. */
+    using const_iterator = const TpChar*;
+    
+    /** The string view type. */
+    using string_view_type = std::basic_string_view<TpChar>;
+    
+    /** Value returned by the search functions when nothing is found. */
+    static constexpr size_type npos = string_view_type::npos;
+    
+    /**
+     * @brief       Default constructor.
+     */
+    constexpr static_string() noexcept
+            : str_()
+            , len_(0)
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       str : The characters to copy.
+     * @param       len : The number of characters to copy.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    constexpr static_string(const TpChar* str, size_type len)
+            : str_()
+            , len_(0)
+    {
+        assign(str, len);
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       str : The null-terminated string to copy.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    constexpr static_string(const TpChar* str)
+            : static_string(str, traits_type::length(str))
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       str_vw : The characters to copy.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    explicit constexpr static_string(string_view_type str_vw)
+            : static_string(str_vw.data(), str_vw.size())
+    {
+    }
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       str : The string to copy.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    template<typename TpCharTraits, typename TpAllocator>
+    explicit static_string(const std::basic_string<TpChar, TpCharTraits, TpAllocator>& str)
+            : static_string(str.data(), str.size())
+    {
+    }
+    
+    /**
+     * @brief       Replace the contents of the string.
+     * @param       str : The characters to copy.
+     * @param       len : The number of characters to copy.
+     * @return      The object that invoked the function.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    constexpr static_string& assign(const TpChar* str, size_type len)
+    {
+        if (len > N)
+        {
+            throw out_of_range_exception();
+        }
+        
+        for (size_type i = 0; i < len; ++i)
+        {
+            str_[i] = str[i];
+        }
+        
+        len_ = len;
+        str_[len_] = TpChar();
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Append characters at the end of the string.
+     * @param       str : The characters to append.
+     * @param       len : The number of characters to append.
+     * @return      The object that invoked the function.
+     * @throw       speed::containers::out_of_range_exception : If the resulting length is greater
+     *              than the capacity an exception is thrown.
+     */
+    constexpr static_string& append(const TpChar* str, size_type len)
+    {
+        if (len > N - len_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        for (size_type i = 0; i < len; ++i)
+        {
+            str_[len_ + i] = str[i];
+        }
+        
+        len_ += len;
+        str_[len_] = TpChar();
+        
+        return *this;
+    }
+    
+    /**
+     * @brief       Append characters at the end of the string.
+     * @param       str_vw : The characters to append.
+     * @return      The object that invoked the function.
+     * @throw       speed::containers::out_of_range_exception : If the resulting length is greater
+     *              than the capacity an exception is thrown.
+     */
+    constexpr static_string& append(string_view_type str_vw)
+    {
+        return append(str_vw.data(), str_vw.size());
+    }
+    
+    /**
+     * @brief       Append a character at the end of the string.
+     * @param       ch : The character to append.
+     * @throw       speed::containers::out_of_range_exception : If the string is full an exception
+     *              is thrown.
+     */
+    constexpr void push_back(TpChar ch)
+    {
+        if (len_ == N)
+        {
+            throw out_of_range_exception();
+        }
+        
+        str_[len_++] = ch;
+        str_[len_] = TpChar();
+    }
+    
+    /**
+     * @brief       Erase the last character of the string.
+     * @throw       speed::containers::empty_container_exception : If the string is empty an
+     *              exception is thrown.
+     */
+    constexpr void pop_back()
+    {
+        if (len_ == 0)
+        {
+            throw empty_container_exception();
+        }
+        
+        str_[--len_] = TpChar();
+    }
+    
+    /**
+     * @brief       Change the length of the string. The new characters are set to a value.
+     * @param       len : The new length.
+     * @param       ch : The value of the new characters.
+     * @throw       speed::containers::out_of_range_exception : If the length is greater than the
+     *              capacity an exception is thrown.
+     */
+    constexpr void resize(size_type len, TpChar ch = TpChar())
+    {
+        if (len > N)
+        {
+            throw out_of_range_exception();
+        }
+        
+        for (size_type i = len_; i < len; ++i)
+        {
+            str_[i] = ch;
+        }
+        
+        len_ = len;
+        str_[len_] = TpChar();
+    }
+    
+    /**
+     * @brief       Erase all the characters.
+     */
+    constexpr void clear() noexcept
+    {
+        len_ = 0;
+        str_[0] = TpChar();
+    }
+    
+    /**
+     * @brief       Get a part of the string.
+     * @param       pos : The position of the first character.
+     * @param       cnt : The maximum number of characters.
+     * @return      The part of the string.
+     * @throw       speed::containers::out_of_range_exception : If the position is greater than the
+     *              length an exception is thrown.
+     */
+    [[nodiscard]] constexpr static_string substr(size_type pos = 0, size_type cnt = npos) const
+    {
+        if (pos > len_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return static_string(str_ + pos, cnt < len_ - pos ? cnt : len_ - pos);
+    }
+    
+    /**
+     * @brief       Find the first occurrence of characters.
+     * @param       str_vw : The characters to look for.
+     * @param       pos : The position where the search starts.
+     * @return      The position of the first occurrence, or npos.
+     */
+    [[nodiscard]] constexpr size_type find(string_view_type str_vw, size_type pos = 0)
+            const noexcept
+    {
+        return string_view_type(str_, len_).find(str_vw, pos);
+    }
+    
+    /**
+     * @brief       Find the first occurrence of a character.
+     * @param       ch : The character to look for.
+     * @param       pos : The position where the search starts.
+     * @return      The position of the first occurrence, or npos.
+     */
+    [[nodiscard]] constexpr size_type find(TpChar ch, size_type pos = 0) const noexcept
+    {
+        return string_view_type(str_, len_).find(ch, pos);
+    }
+    
+    /**
+     * @brief       Compare the string with other characters.
+     * @param       str_vw : The characters to compare with.
+     * @return      A negative value if the string goes before the characters, 0 if both are equal
+     *              and a positive value otherwise.
+     */
+    [[nodiscard]] constexpr int compare(string_view_type str_vw) const noexcept
+    {
+        return string_view_type(str_, len_).compare(str_vw);
+    }
+    
+    /**
+     * @brief       Get the character at the specified position.
+     * @param       pos : The position of the character.
+     * @return      The character at the specified position.
+     * @throw       speed::containers::out_of_range_exception : If the position is not lower than
+     *              the length an exception is thrown.
+     */
+    [[nodiscard]] constexpr TpChar& at(size_type pos)
+    {
+        if (pos >= len_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return str_[pos];
+    }
+    
+    /**
+     * @brief       Get the character at the specified position.
+     * @param       pos : The position of the character.
+     * @return      The character at the specified position.
+     * @throw       speed::containers::out_of_range_exception : If the position is not lower than
+     *              the length an exception is thrown.
+     */
+    [[nodiscard]] constexpr const TpChar& at(size_type pos) const
+    {
+        if (pos >= len_)
+        {
+            throw out_of_range_exception();
+        }
+        
+        return str_[pos];
+    }
+    
+    /**
+     * @brief       Get the first character.
+     * @return      The first character.
+     */
+    [[nodiscard]] constexpr TpChar& front() noexcept
+    {
+        return str_[0];
+    }
+    
+    /**
+     * @brief       Get the first character.
+     * @return      The first character.
+     */
+    [[nodiscard]] constexpr const TpChar& front() const noexcept
+    {
+        return str_[0];
+    }
+    
+    /**
+     * @brief       Get the last character.
+     * @return      The last character.
+     */
+    [[nodiscard]] constexpr TpChar& back() noexcept
+    {
+        return str_[len_ - 1];
+    }
+    
+    /**
+     * @brief       Get the last character.
+     * @return      The last character.
+     */
+    [[nodiscard]] constexpr const TpChar& back() const noexcept
+    {
+        return str_[len_ - 1];
+    }
+    
+    /**
+     * @brief       Get the characters of the string.
+     * @return      The characters of the string.
+     */
+    [[nodiscard]] constexpr TpChar* data() noexcept
+    {
+        return str_;
+    }
+    
+    /**
+     * @brief       Get the characters of the string.
+     * @return      The characters of the string.
+     */
+    [[nodiscard]] constexpr const TpChar* data() const noexcept
+    {
+        return str_;
+    }
+    
+    /**
+     * @brief       Get the null-terminated characters of the string.
+     * @return      The null-terminated characters of the string.
+     */
+    [[nodiscard]] constexpr const TpChar* c_str() const noexcept
+    {
+        return str_;
+    }
+    
+    /**
+     * @brief       Get an iterator to the first character.
+     * @return      An iterator to the first character.
+     */
+    [[nodiscard]] constexpr iterator begin() noexcept
+    {
+        return str_;
+    }
+    
+    /**
+     * @brief       Get an iterator to the first character.
+     * @return      An iterator to the first character.
+     */
+    [[nodiscard]] constexpr const_iterator begin() const noexcept
+    {
+        return str_;
+    }
+    
+    /**
+     * @brief       Get an iterator to the past-the-end character.
+     * @return      An iterator to the past-the-end character.
+     */
+    [[nodiscard]] constexpr iterator end() noexcept
+    {
+        return str_ + len_;
+    }
+    
+    /**
+     * @brief       Get an iterator to the past-the-end character.
+     * @return      An iterator to the past-the-end character.
+     */
+    [[nodiscard]] constexpr const_iterator end() const noexcept
+    {
+        return str_ + len_;
+    }
+    
+    /**
+     * @brief       Check whether the string is empty.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return len_ == 0;
+    }
+    
+    /**
+     * @brief       Get the number of characters.
+     * @return      The number of characters.
+     */
+    [[nodiscard]] constexpr size_type size() const noexcept
+    {
+        return len_;
+    }
+    
+    /**
+     * @brief       Get the number of characters.
+     * @return      The number of characters.
+     */
+    [[nodiscard]] constexpr size_type length() const noexcept
+    {
+        return len_;
+    }
+    
+    /**
+     * @brief       Get the maximum number of characters.
+     * @return      The maximum number of characters.
+     */
+    [[nodiscard]] static constexpr size_type capacity() noexcept
+    {
+        return N;
+    }
+    
+    /**
+     * @brief       Get the maximum number of characters.
+     * @return      The maximum number of characters.
+     */
+    [[nodiscard]] static constexpr size_type max_size() noexcept
+    {
+        return N;
+    }
+    
+    /**
+     * @brief       Get a string view of the characters.
+     * @return      A string view of the characters.
+     */
+    constexpr operator string_view_type() const noexcept
+    {
+        return string_view_type(str_, len_);
+    }
+    
+    /**
+     * @brief       Get a std::basic_string copy of the characters.
+     * @return      A std::basic_string copy of the characters.
+     */
+    [[nodiscard]] std::basic_string<TpChar> str() const
+    {
+        return std::basic_string<TpChar>(str_, len_);
+    }
+    
+    /**
+     * @brief       Access operator.
+     * @param       pos : The position of the character.
+     * @return      The character at the specified position.
+     */
+    constexpr TpChar& operator [](size_type pos) noexcept
+    {
+        return str_[pos];
+    }
+    
+    /**
+     * @brief       Access operator.
+     * @param       pos : The position of the character.
+     * @return      The character at the specified position.
+     */
+    constexpr const TpChar& operator [](size_type pos) const noexcept
+    {
+        return str_[pos];
+    }
+    
+    /**
+     * @brief       Addition assignment operator.
+     * @param       str_vw : The characters to append.
+     * @return      The object that invoked the function.
+     * @throw       speed::containers::out_of_range_exception : If the resulting length is greater
+     *              than the capacity an exception is thrown.
+     */
+    constexpr static_string& operator +=(string_view_type str_vw)
+    {
+        return append(str_vw);
+    }
+    
+    /**
+     * @brief       Addition assignment operator.
+     * @param       ch : The character to append.
+     * @return      The object that invoked the function.
+     * @throw       speed::containers::out_of_range_exception : If the string is full an exception
+     *              is thrown.
+     */
+    constexpr static_string& operator +=(TpChar ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+    
+    /**
+     * @brief       Equal operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator ==(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return lhs.len_ == rhs.size() && traits_type::compare(lhs.str_, rhs.data(), lhs.len_) == 0;
+    }
+    
+    /**
+     * @brief       Different operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator !=(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+    
+    /**
+     * @brief       Less than operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator <(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return lhs.compare(rhs) < 0;
+    }
+    
+    /**
+     * @brief       Less or equal operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator <=(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+    
+    /**
+     * @brief       Greater than operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator >(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return lhs.compare(rhs) > 0;
+    }
+    
+    /**
+     * @brief       Greater or equal operator.
+     * @param       lhs : The left hand side string.
+     * @param       rhs : The right hand side characters.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    friend constexpr bool operator >=(const static_string& lhs, string_view_type rhs) noexcept
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+    
+    /**
+     * @brief       Output stream operator.
+     * @param       os : The output stream.
+     * @param       str : The string to write.
+     * @return      The output stream.
+     */
+    template<typename TpCharTraits>
+    friend std::basic_ostream<TpChar, TpCharTraits>& operator <<(
+            std::basic_ostream<TpChar, TpCharTraits>& os,
+            const static_string& str
+    )
+    {
+        return os << string_view_type(str.str_, str.len_);
+    }
+
+private:
+    /** The null-terminated characters. */
+    TpChar str_[N + 1];
+    
+    /** The number of characters. */
+    size_type len_;
+};
+
+
+}
+}
+
+
+/** @cond */
+namespace std {
+
+
+/**
+ * @brief       Hash of a static_string. It is the hash of the equivalent string view, so it is
+ *              consistent with std::basic_string and std::basic_string_view.
+ */
+template<typename TpChar, std::size_t N>
+struct hash<speed::containers::static_string<TpChar, N>>
+{
+    std::size_t operator ()(const speed::containers::static_string<TpChar, N>& str) const noexcept
+    {
+        return hash<basic_string_view<TpChar>>()(basic_string_view<TpChar>(str));
+    }
+};
+
+
+}
+/** @endcond */
+
+
+#endif
@@ -0,0 +1,46 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/hash.hpp
+ * @brief       hash main header.
+ * @author      Killian
+ * @date        2018/09/29 - 10:31
+ */
+
+#ifndef SPEED_HASH_HPP
+#define SPEED_HASH_HPP
+
+#include "hash/hash.hpp"
+#include "hash/hasher.hpp"
+
+
+namespace speed {
+
+
+/**
+ * @brief       Contains hash functions and hash function objects.
+ */
+namespace hash {}
+
+
+}
+
+
+#endif
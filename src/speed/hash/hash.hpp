@@ -0,0 +1,543 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/hash/hash.hpp
+ * @brief       hash functions header.
+ * @author      Killian
+ * @date        2018/09/29 - 10:31
+ */
+
+#ifndef SPEED_HASH_HASH_HPP
+#define SPEED_HASH_HASH_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace speed {
+namespace hash {
+
+
+/** @cond */
+namespace __hidden_hash {
+
+
+/** Secret used to hash the short inputs. */
+constexpr std::uint64_t SHORT_SECRET[4] = {
+        0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL
+};
+
+/** Secret used to hash the long inputs. The stripe i of a block uses the words i to i + 7, the
+ *  last stripe uses the words 23 to 30, the scrambles the words 24 to 31 and the final merge the
+ *  words 9 to 16. */
+constexpr std::uint64_t LONG_SECRET[32] = {
+        0x2cb0f69f4abea221ULL, 0x9417034723148989ULL, 0xdd555950609dfe03ULL, 0xdbafb150deb12800ULL,
+        0x7e789b2e6c442cb6ULL, 0xf41e5636c7e4f8c4ULL, 0x0959d150f8fba7e4ULL, 0xa97316f13cdb9eeaULL,
+        0x74cd8258f9520068ULL, 0x55c74a62e116868bULL, 0xd2f4c799a2023cbdULL, 0xdf98cb79a37b51b9ULL,
+        0x396f5885524f3905ULL, 0xaf1d56386ca3b276ULL, 0xa9ffbe6b5104e85aULL, 0x6bd0c51b9fd533b3ULL,
+        0x980ce91c50ab4b56ULL, 0x28ac395780fe62c5ULL, 0x768912e3a6bcedc7ULL, 0x50b3e8c9332c7c88ULL,
+        0xce3bbfe520bd47daULL, 0xcba6c8e8e0bb7c4fULL, 0xbf194db8434a346dULL, 0x7d8f2a7b60416d7fULL,
+        0x0849d1f6e0e10a5eULL, 0x7654b590d064e22fULL, 0x16d1da9507df3af2ULL, 0xf63aef1089ea30e4ULL,
+        0x9ade6673cc6c522bULL, 0x4c75bc274e37087cULL, 0xd35e12b49f51f27bULL, 0x22ddf2ffcee481eaULL
+};
+
+/** Initial values of the accumulators of the long inputs. */
+constexpr std::uint64_t LONG_INIT[8] = {
+        0x00000000c2b2ae3dULL, 0x9e3779b185ebca87ULL, 0xc2b2ae3d27d4eb4fULL, 0x165667b19e3779f9ULL,
+        0x85ebca77c2b2ae63ULL, 0x0000000085ebca77ULL, 0x27d4eb2f165667c5ULL, 0x000000009e3779b1ULL
+};
+
+/** Number of bytes over which an input is hashed with the long inputs algorithm. */
+constexpr std::size_t LONG_INPUT_THRESHOLD = 1024;
+
+/** Number of bytes of a stripe, that is accumulated at once. */
+constexpr std::size_t STRIPE_SIZE = 64;
+
+/** Number of stripes of a block, after which the accumulators are scrambled. */
+constexpr std::size_t STRIPES_PER_BLOCK = 16;
+
+/** Odd 32 bits constant by which the accumulators are multiplied when they are scrambled. */
+constexpr std::uint64_t SCRAMBLE_PRIME = 0x9e3779b1ULL;
+
+
+/**
+ * @brief       Multiply two 64 bits integers into a 128 bits integer.
+ * @param       lo : The first integer, that receives the low 64 bits of the product.
+ * @param       hi : The second integer, that receives the high 64 bits of the product.
+ */
+inline void __multiply(std::uint64_t& lo, std::uint64_t& hi) noexcept
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 prod = static_cast<unsigned __int128>(lo) * hi;
+    
+    lo = static_cast<std::uint64_t>(prod);
+    hi = static_cast<std::uint64_t>(prod >> 64);
+#else
+    const std::uint64_t a_lo = lo & 0xffffffffULL;
+    const std::uint64_t a_hi = lo >> 32;
+    const std::uint64_t b_lo = hi & 0xffffffffULL;
+    const std::uint64_t b_hi = hi >> 32;
+    const std::uint64_t lo_lo = a_lo * b_lo;
+    const std::uint64_t hi_lo = a_hi * b_lo;
+    const std::uint64_t lo_hi = a_lo * b_hi;
+    const std::uint64_t hi_hi = a_hi * b_hi;
+    const std::uint64_t crss = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+    
+    lo = (crss << 32) | (lo_lo & 0xffffffffULL);
+    hi = (hi_lo >> 32) + (crss >> 32) + hi_hi;
+#endif
+}
+
+
+/**
+ * @brief       Mix two 64 bits integers by folding their 128 bits product.
+ * @param       a : The first integer.
+ * @param       b : The second integer.
+ * @return      The exclusive or of the low and high halves of the product.
+ */
+inline std::uint64_t __fold_multiply(std::uint64_t a, std::uint64_t b) noexcept
+{
+    __multiply(a, b);
+    
+    return a ^ b;
+}
+
+
+/**
+ * @brief       Read a little endian 64 bits integer, whatever the byte order of the host, so the
+ *              hashes are the same on all the platforms.
+ * @param       src : The bytes to read.
+ * @return      The integer.
+ */
+inline std::uint64_t __read64(const unsigned char* src) noexcept
+{
+    std::uint64_t val;
+    
+    std::memcpy(&val, src, sizeof(val));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    val = __builtin_bswap64(val);
+#endif
+    
+    return val;
+}
+
+
+/**
+ * @brief       Read a little endian 32 bits integer.
+ * @param       src : The bytes to read.
+ * @return      The integer, zero extended.
+ */
+inline std::uint64_t __read32(const unsigned char* src) noexcept
+{
+    std::uint32_t val;
+    
+    std::memcpy(&val, src, sizeof(val));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    val = __builtin_bswap32(val);
+#endif
+    
+    return val;
+}
+
+
+/**
+ * @brief       Hash an input of at most LONG_INPUT_THRESHOLD bytes. The input is read as pairs of
+ *              64 bits words that are mixed into the state by 128 bits multiplications, with
+ *              three independent states on the inputs longer than 48 bytes, and the inputs
+ *              shorter than 16 bytes are read with overlapping loads.
+ * @param       src : The input.
+ * @param       sz : The input size.
+ * @param       sd : The seed.
+ * @return      The hash.
+ */
+inline std::uint64_t __hash_short(
+        const unsigned char* src,
+        std::size_t sz,
+        std::uint64_t sd
+) noexcept
+{
+    std::uint64_t a;
+    std::uint64_t b;
+    std::size_t i = sz;
+    
+    sd ^= __fold_multiply(sd ^ SHORT_SECRET[0], SHORT_SECRET[1]);
+    
+    if (sz <= 16)
+    {
+        if (sz >= 4)
+        {
+            a = (__read32(src) << 32) | __read32(src + ((sz >> 3) << 2));
+            b = (__read32(src + sz - 4) << 32) | __read32(src + sz - 4 - ((sz >> 3) << 2));
+        }
+        else if (sz > 0)
+        {
+            a = (static_cast<std::uint64_t>(src[0]) << 16) |
+                (static_cast<std::uint64_t>(src[sz >> 1]) << 8) | src[sz - 1];
+            b = 0;
+        }
+        else
+        {
+            a = 0;
+            b = 0;
+        }
+    }
+    else
+    {
+        if (i > 48)
+        {
+            std::uint64_t sd1 = sd;
+            std::uint64_t sd2 = sd;
+            
+            do
+            {
+                sd = __fold_multiply(__read64(src) ^ SHORT_SECRET[1], __read64(src + 8) ^ sd);
+                sd1 = __fold_multiply(__read64(src + 16) ^ SHORT_SECRET[2],
+                                      __read64(src + 24) ^ sd1);
+                sd2 = __fold_multiply(__read64(src + 32) ^ SHORT_SECRET[3],
+                                      __read64(src + 40) ^ sd2);
+                src += 48;
+                i -= 48;
+            } while (i > 48);
+            
+            sd ^= sd1 ^ sd2;
+        }
+        
+        while (i > 16)
+        {
+            sd = __fold_multiply(__read64(src) ^ SHORT_SECRET[1], __read64(src + 8) ^ sd);
+            src += 16;
+            i -= 16;
+        }
+        
+        a = __read64(src + i - 16);
+        b = __read64(src + i - 8);
+    }
+    
+    a ^= SHORT_SECRET[1];
+    b ^= sd;
+    __multiply(a, b);
+    
+    return __fold_multiply(a ^ SHORT_SECRET[0] ^ sz, b ^ SHORT_SECRET[1]);
+}
+
+
+/**
+ * @brief       Eight 64 bits accumulators, held in SIMD registers when they are available.
+ */
+struct __accumulators
+{
+#if defined(__AVX2__)
+    /** The accumulators, four per register. */
+    __m256i lns[2];
+#elif defined(__SSE2__)
+    /** The accumulators, two per register. */
+    __m128i lns[4];
+#else
+    /** The accumulators. */
+    std::uint64_t lns[8];
+#endif
+};
+
+
+#if defined(__AVX2__)
+/**
+ * @brief       Accumulate four words of a stripe.
+ * @param       acc : The accumulators of the words.
+ * @param       src : The words.
+ * @param       scrt : The words of the secret.
+ * @return      The updated accumulators.
+ */
+inline __m256i __accumulate_lane(
+        __m256i acc,
+        const unsigned char* src,
+        const std::uint64_t* scrt
+) noexcept
+{
+    const __m256i dat = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+    const __m256i dat_ky = _mm256_xor_si256(
+            dat, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scrt)));
+    const __m256i prod = _mm256_mul_epu32(dat_ky, _mm256_srli_epi64(dat_ky, 32));
+    
+    return _mm256_add_epi64(acc, _mm256_add_epi64(
+            prod, _mm256_shuffle_epi32(dat, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+
+/**
+ * @brief       Scramble four accumulators.
+ * @param       acc : The accumulators.
+ * @param       scrt : The words of the secret.
+ * @return      The scrambled accumulators.
+ */
+inline __m256i __scramble_lane(__m256i acc, const std::uint64_t* scrt) noexcept
+{
+    const __m256i prm = _mm256_set1_epi32(static_cast<int>(SCRAMBLE_PRIME));
+    
+    acc = _mm256_xor_si256(acc, _mm256_srli_epi64(acc, 47));
+    acc = _mm256_xor_si256(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(scrt)));
+    
+    return _mm256_add_epi64(_mm256_mul_epu32(acc, prm),
+                            _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(acc, 32), prm),
+                                              32));
+}
+#elif defined(__SSE2__)
+/**
+ * @brief       Accumulate two words of a stripe.
+ * @param       acc : The accumulators of the words.
+ * @param       src : The words.
+ * @param       scrt : The words of the secret.
+ * @return      The updated accumulators.
+ */
+inline __m128i __accumulate_lane(
+        __m128i acc,
+        const unsigned char* src,
+        const std::uint64_t* scrt
+) noexcept
+{
+    const __m128i dat = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+    const __m128i dat_ky = _mm_xor_si128(
+            dat, _mm_loadu_si128(reinterpret_cast<const __m128i*>(scrt)));
+    const __m128i prod = _mm_mul_epu32(dat_ky, _mm_srli_epi64(dat_ky, 32));
+    
+    return _mm_add_epi64(acc, _mm_add_epi64(prod,
+                                            _mm_shuffle_epi32(dat, _MM_SHUFFLE(1, 0, 3, 2))));
+}
+
+
+/**
+ * @brief       Scramble two accumulators.
+ * @param       acc : The accumulators.
+ * @param       scrt : The words of the secret.
+ * @return      The scrambled accumulators.
+ */
+inline __m128i __scramble_lane(__m128i acc, const std::uint64_t* scrt) noexcept
+{
+    const __m128i prm = _mm_set1_epi32(static_cast<int>(SCRAMBLE_PRIME));
+    
+    acc = _mm_xor_si128(acc, _mm_srli_epi64(acc, 47));
+    acc = _mm_xor_si128(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(scrt)));
+    
+    return _mm_add_epi64(_mm_mul_epu32(acc, prm),
+                         _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(acc, 32), prm), 32));
+}
+#endif
+
+
+/**
+ * @brief       Accumulate a stripe in the accumulators. Every 64 bits word of the stripe is mixed
+ *              with a word of the secret, and the product of the two halves of the result is
+ *              added to the accumulator of the word, while the word itself is added to the
+ *              neighbour accumulator.
+ * @param       accs : The accumulators.
+ * @param       src : The stripe.
+ * @param       scrt : The words of the secret.
+ */
+inline void __accumulate_stripe(
+        __accumulators& accs,
+        const unsigned char* src,
+        const std::uint64_t* scrt
+) noexcept
+{
+#if defined(__AVX2__)
+    accs.lns[0] = __accumulate_lane(accs.lns[0], src, scrt);
+    accs.lns[1] = __accumulate_lane(accs.lns[1], src + 32, scrt + 4);
+#elif defined(__SSE2__)
+    accs.lns[0] = __accumulate_lane(accs.lns[0], src, scrt);
+    accs.lns[1] = __accumulate_lane(accs.lns[1], src + 16, scrt + 2);
+    accs.lns[2] = __accumulate_lane(accs.lns[2], src + 32, scrt + 4);
+    accs.lns[3] = __accumulate_lane(accs.lns[3], src + 48, scrt + 6);
+#else
+    std::uint64_t dat;
+    std::uint64_t dat_ky;
+    
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        dat = __read64(src + i * 8);
+        dat_ky = dat ^ scrt[i];
+        accs.lns[i ^ 1] += dat;
+        accs.lns[i] += (dat_ky & 0xffffffffULL) * (dat_ky >> 32);
+    }
+#endif
+}
+
+
+/**
+ * @brief       Scramble the accumulators at the end of a block, so the blocks can not cancel each
+ *              other.
+ * @param       accs : The accumulators.
+ * @param       scrt : The words of the secret.
+ */
+inline void __scramble(__accumulators& accs, const std::uint64_t* scrt) noexcept
+{
+#if defined(__AVX2__)
+    accs.lns[0] = __scramble_lane(accs.lns[0], scrt);
+    accs.lns[1] = __scramble_lane(accs.lns[1], scrt + 4);
+#elif defined(__SSE2__)
+    accs.lns[0] = __scramble_lane(accs.lns[0], scrt);
+    accs.lns[1] = __scramble_lane(accs.lns[1], scrt + 2);
+    accs.lns[2] = __scramble_lane(accs.lns[2], scrt + 4);
+    accs.lns[3] = __scramble_lane(accs.lns[3], scrt + 6);
+#else
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        accs.lns[i] ^= accs.lns[i] >> 47;
+        accs.lns[i] ^= scrt[i];
+        accs.lns[i] *= SCRAMBLE_PRIME;
+    }
+#endif
+}
+
+
+/**
+ * @brief       Hash an input of more than LONG_INPUT_THRESHOLD bytes. The input is split in
+ *              stripes of 64 bytes that are accumulated in eight independent 64 bits
+ *              accumulators, each stripe of a block with a different window of the secret, and
+ *              the accumulators are scrambled after every block and merged at the end.
+ * @param       src : The input.
+ * @param       sz : The input size.
+ * @param       sd : The seed.
+ * @return      The hash.
+ */
+inline std::uint64_t __hash_long(
+        const unsigned char* src,
+        std::size_t sz,
+        std::uint64_t sd
+) noexcept
+{
+    constexpr std::size_t blk_sz = STRIPE_SIZE * STRIPES_PER_BLOCK;
+    __accumulators accs;
+    std::uint64_t accs_vals[8];
+    std::uint64_t scrt[32];
+    const std::size_t nbr_blks = (sz - 1) / blk_sz;
+    const std::size_t nbr_strps = ((sz - 1) % blk_sz) / STRIPE_SIZE;
+    std::uint64_t hsh = sz * 0x9e3779b185ebca87ULL;
+    std::size_t i;
+    std::size_t j;
+    
+    for (i = 0; i < 32; i += 2)
+    {
+        scrt[i] = LONG_SECRET[i] + sd;
+        scrt[i + 1] = LONG_SECRET[i + 1] - sd;
+    }
+    
+    std::memcpy(&accs, LONG_INIT, sizeof(accs));
+    
+    for (i = 0; i < nbr_blks; ++i)
+    {
+        for (j = 0; j < STRIPES_PER_BLOCK; ++j)
+        {
+            __accumulate_stripe(accs, src + i * blk_sz + j * STRIPE_SIZE, scrt + j);
+        }
+        
+        __scramble(accs, scrt + 24);
+    }
+    
+    for (j = 0; j < nbr_strps; ++j)
+    {
+        __accumulate_stripe(accs, src + nbr_blks * blk_sz + j * STRIPE_SIZE, scrt + j);
+    }
+    
+    __accumulate_stripe(accs, src + sz - STRIPE_SIZE, scrt + 23);
+    
+    std::memcpy(accs_vals, &accs, sizeof(accs));
+    for (i = 0; i < 8; i += 2)
+    {
+        hsh += __fold_multiply(accs_vals[i] ^ scrt[9 + i], accs_vals[i + 1] ^ scrt[10 + i]);
+    }
+    
+    hsh ^= hsh >> 37;
+    hsh *= 0x165667919e3779f9ULL;
+    hsh ^= hsh >> 32;
+    
+    return hsh;
+}
+
+
+} /* __hidden_hash */
+/** @endcond */
+
+
+/**
+ * @brief       Mix the bits of a 64 bits integer, so that every bit of the result depends on every
+ *              bit of the integer. It is a bijection, so distinct integers never collide.
+ * @param       val : The integer to mix.
+ * @return      The mixed integer.
+ */
+constexpr std::uint64_t mix64(std::uint64_t val) noexcept
+{
+    val ^= val >> 33;
+    val *= 0xff51afd7ed558ccdULL;
+    val ^= val >> 33;
+    val *= 0xc4ceb9fe1a85ec53ULL;
+    val ^= val >> 33;
+    
+    return val;
+}
+
+
+/**
+ * @brief       Hash a sequence of bytes. The inputs of up to 1024 bytes are mixed through 128 bits
+ *              multiplications of pairs of words, and the longer inputs are accumulated 64 bytes
+ *              at a time in eight lanes with SIMD instructions when they are available. The
+ *              result does not depend on the instructions used.
+ * @param       src : The bytes to hash.
+ * @param       sz : The number of bytes to hash.
+ * @param       sd : The seed.
+ * @return      The hash of the bytes.
+ */
+inline std::uint64_t hash_bytes(const void* src, std::size_t sz, std::uint64_t sd = 0) noexcept
+{
+    if (sz <= __hidden_hash::LONG_INPUT_THRESHOLD)
+    {
+        return __hidden_hash::__hash_short(static_cast<const unsigned char*>(src), sz, sd);
+    }
+    
+    return __hidden_hash::__hash_long(static_cast<const unsigned char*>(src), sz, sd);
+}
+
+
+/**
+ * @brief       Combine a hash with the hash of the previous components of a composite key. The
+ *              result depends on the order of the components.
+ * @param       sd : The hash of the previous components.
+ * @param       hsh : The hash to combine.
+ * @return      The combined hash.
+ */
+inline std::uint64_t hash_combine(std::uint64_t sd, std::uint64_t hsh) noexcept
+{
+    return __hidden_hash::__fold_multiply(sd ^ __hidden_hash::SHORT_SECRET[0],
+                                          hsh ^ __hidden_hash::SHORT_SECRET[1]);
+}
+
+
+}
+}
+
+
+#endif
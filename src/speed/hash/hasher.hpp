@@ -0,0 +1,137 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/hash/hasher.hpp
+ * @brief       hasher class header.
+ * @author      Killian
+ * @date        2018/09/29 - 15:08
+ */
+
+#ifndef SPEED_HASH_HASHER_HPP
+#define SPEED_HASH_HASHER_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "hash.hpp"
+
+
+namespace speed {
+namespace hash {
+
+
+/** @cond */
+namespace __hidden_hash {
+
+
+/**
+ * @brief       Trait that checks whether a type is tuple-like, that is whether std::tuple_size is
+ *              defined for it.
+ */
+template<typename TpKey, typename = void>
+struct __is_tuple_like : std::false_type
+{
+};
+
+template<typename TpKey>
+struct __is_tuple_like<TpKey, std::void_t<decltype(std::tuple_size<TpKey>::value)>>
+        : std::true_type
+{
+};
+
+
+} /* __hidden_hash */
+/** @endcond */
+
+
+/**
+ * @brief       Function object that hashes keys with well-mixed hashes, so that they can be
+ *              reduced with a modulo or a mask. The integers, the enumerations and the pointers
+ *              are mixed with mix64, the floating point numbers are mixed from their
+ *              representation, the positive and negative zeros hashing the same, the keys
+ *              convertible to std::string_view are hashed with hash_bytes, and the tuple-like
+ *              keys combine the hashes of their elements with hash_combine. The hash of the
+ *              other keys is std::hash mixed with mix64.
+ */
+template<typename TpKey>
+struct hasher
+{
+    /**
+     * @brief       Hash a key.
+     * @param       ky : The key to hash.
+     * @return      The hash of the key.
+     */
+    [[nodiscard]] std::size_t operator()(const TpKey& ky) const
+    {
+        if constexpr (std::is_integral<TpKey>::value || std::is_enum<TpKey>::value)
+        {
+            return static_cast<std::size_t>(mix64(static_cast<std::uint64_t>(ky)));
+        }
+        else if constexpr (std::is_pointer<TpKey>::value)
+        {
+            return static_cast<std::size_t>(mix64(reinterpret_cast<std::uintptr_t>(ky)));
+        }
+        else if constexpr (std::is_same<TpKey, float>::value || std::is_same<TpKey, double>::value)
+        {
+            std::conditional_t<sizeof(TpKey) == 4, std::uint32_t, std::uint64_t> bits = 0;
+            
+            if (ky != 0)
+            {
+                std::memcpy(&bits, &ky, sizeof(TpKey));
+            }
+            
+            return static_cast<std::size_t>(mix64(bits));
+        }
+        else if constexpr (std::is_convertible<const TpKey&, std::string_view>::value)
+        {
+            const std::string_view str = ky;
+            
+            return static_cast<std::size_t>(hash_bytes(str.data(), str.size()));
+        }
+        else if constexpr (__hidden_hash::__is_tuple_like<TpKey>::value)
+        {
+            return std::apply([](const auto&... elems)
+            {
+                std::uint64_t hsh = 0;
+                
+                ((hsh = hash_combine(hsh, hasher<std::decay_t<decltype(elems)>>()(elems))), ...);
+                
+                return static_cast<std::size_t>(hsh);
+            }, ky);
+        }
+        else
+        {
+            return static_cast<std::size_t>(mix64(std::hash<TpKey>()(ky)));
+        }
+    }
+};
+
+
+}
+}
+
+
+#endif
@@ -29,8 +29,10 @@
 
 #include "algorithm.hpp"
 #include "argparse.hpp"
+#include "concurrency.hpp"
 #include "containers.hpp"
 #include "exception.hpp"
+#include "hash.hpp"
 #include "iostream.hpp"
 #include "lowlevel.hpp"
 #include "math.hpp"
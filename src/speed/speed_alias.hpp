@@ -33,8 +33,10 @@ namespace speed {
 
 namespace algorithm {}
 namespace argparse {}
+namespace concurrency {}
 namespace containers {}
 namespace exception {}
+namespace hash {}
 namespace iostream {}
 namespace lowlevel {}
 namespace math {}
@@ -58,6 +60,12 @@ namespace algo = algorithm;
 namespace ap = argparse;
 
 
+/**
+ * @brief       Contains resources to run tasks concurrently.
+ */
+namespace conc = concurrency;
+
+
 /**
  * @brief       Contians definitions of containers.
  */
@@ -71,6 +79,12 @@ namespace contain = containers;
 namespace except = exception;
 
 
+/**
+ * @brief       Contains hash functions and hash function objects.
+ */
+namespace hsh = hash;
+
+
 /**
  * @brief       Contains resources for input and output streams.
  */
@@ -29,8 +29,22 @@
 
 #include "system/data_types.hpp"
 #include "system/error_code.hpp"
+#include "system/event/event.hpp"
+#include "system/event/event_flags.hpp"
+#include "system/event/event_loop.hpp"
+#include "system/event/event_loop_group.hpp"
 #include "system/filesystem.hpp"
+#include "system/io/async_io_backends.hpp"
+#include "system/io/async_io_engine.hpp"
 #include "system/process.hpp"
+#include "system/sync/adaptive_mutex.hpp"
+#include "system/sync/barrier.hpp"
+#include "system/sync/counting_semaphore.hpp"
+#include "system/sync/event_count.hpp"
+#include "system/sync/latch.hpp"
+#include "system/sync/reader_writer_lock.hpp"
+#include "system/sync/sync.hpp"
+#include "system/sync/ticket_lock.hpp"
 #include "system/system_exception.hpp"
 #include "system/system_macros.hpp"
 #include "system/terminal.hpp"
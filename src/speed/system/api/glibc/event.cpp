@@ -0,0 +1,464 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/api/glibc/event.cpp
+ * @brief       event functions definitions.
+ * @author      Killian
+ * @date        2018/10/04 - 09:37
+ */
+
+#include "../../system_macros.hpp"
+#ifdef SPEED_GLIBC
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#endif
+
+#include "event.hpp"
+
+
+namespace speed {
+namespace system {
+namespace glibc {
+
+
+/** @cond */
+namespace __hidden_glibc {
+
+
+#ifdef __linux__
+/** The maximum number of events taken by a call to wait_events. */
+constexpr std::size_t MAX_EVENTS_BATCH = 256;
+
+
+/**
+ * @brief       Get the epoll events of event flags. The watch is edge-triggered.
+ * @param       evnts : The event flags.
+ * @return      The epoll events.
+ */
+std::uint32_t __to_epoll_events(event_flags evnts) noexcept
+{
+    std::uint32_t epll_evnts = EPOLLET | EPOLLERR | EPOLLHUP;
+    
+    if ((evnts & event_flags::READABLE) != event_flags::NIL)
+    {
+        epll_evnts |= EPOLLIN | EPOLLRDHUP;
+    }
+    
+    if ((evnts & event_flags::WRITABLE) != event_flags::NIL)
+    {
+        epll_evnts |= EPOLLOUT;
+    }
+    
+    return epll_evnts;
+}
+
+
+/**
+ * @brief       Get the event flags of epoll events.
+ * @param       epll_evnts : The epoll events.
+ * @return      The event flags.
+ */
+event_flags __to_event_flags(std::uint32_t epll_evnts) noexcept
+{
+    event_flags evnts = event_flags::NIL;
+    
+    if ((epll_evnts & EPOLLIN) != 0)
+    {
+        evnts = evnts | event_flags::READABLE;
+    }
+    
+    if ((epll_evnts & EPOLLOUT) != 0)
+    {
+        evnts = evnts | event_flags::WRITABLE;
+    }
+    
+    if ((epll_evnts & EPOLLERR) != 0)
+    {
+        evnts = evnts | event_flags::ERROR;
+    }
+    
+    if ((epll_evnts & (EPOLLHUP | EPOLLRDHUP)) != 0)
+    {
+        evnts = evnts | event_flags::HANGUP;
+    }
+    
+    return evnts;
+}
+
+
+/**
+ * @brief       Add, change or remove the watch of a file descriptor.
+ * @param       pllr_fd : The file descriptor of the poller.
+ * @param       op : The epoll operation.
+ * @param       fd : The file descriptor.
+ * @param       evnts : The events to watch.
+ * @param       dat : The data reported with the events of the file descriptor.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+bool __control_event_watch(
+        int pllr_fd,
+        int op,
+        int fd,
+        event_flags evnts,
+        std::uint64_t dat,
+        std::error_code* err_code
+) noexcept
+{
+    struct ::epoll_event epll_evnt = {};
+    
+    epll_evnt.events = __to_epoll_events(evnts);
+    epll_evnt.data.u64 = dat;
+    if (::epoll_ctl(pllr_fd, op, fd, &epll_evnt) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+}
+#endif
+
+
+} /* __hidden_glibc */
+/** @endcond */
+
+
+bool create_event_poller(int* fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    const int pllr_fd = ::epoll_create1(EPOLL_CLOEXEC);
+    
+    if (pllr_fd == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    *fd = pllr_fd;
+    
+    return true;
+#else
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool add_event_watch(
+        int pllr_fd,
+        int fd,
+        event_flags evnts,
+        std::uint64_t dat,
+        std::error_code* err_code
+) noexcept
+{
+#ifdef __linux__
+    return __hidden_glibc::__control_event_watch(pllr_fd, EPOLL_CTL_ADD, fd, evnts, dat, err_code);
+#else
+    (void)pllr_fd;
+    (void)fd;
+    (void)evnts;
+    (void)dat;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool modify_event_watch(
+        int pllr_fd,
+        int fd,
+        event_flags evnts,
+        std::uint64_t dat,
+        std::error_code* err_code
+) noexcept
+{
+#ifdef __linux__
+    return __hidden_glibc::__control_event_watch(pllr_fd, EPOLL_CTL_MOD, fd, evnts, dat, err_code);
+#else
+    (void)pllr_fd;
+    (void)fd;
+    (void)evnts;
+    (void)dat;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool remove_event_watch(int pllr_fd, int fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    return __hidden_glibc::__control_event_watch(pllr_fd, EPOLL_CTL_DEL, fd, event_flags::NIL, 0,
+                                                 err_code);
+#else
+    (void)pllr_fd;
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool wait_events(
+        int pllr_fd,
+        event_record* evnts,
+        std::size_t max_nbr_evnts,
+        int tmout,
+        std::size_t* nbr_evnts,
+        std::error_code* err_code
+) noexcept
+{
+#ifdef __linux__
+    struct ::epoll_event epll_evnts[__hidden_glibc::MAX_EVENTS_BATCH];
+    const int nbr_rdy = ::epoll_wait(
+            pllr_fd, epll_evnts,
+            static_cast<int>(std::min(max_nbr_evnts, __hidden_glibc::MAX_EVENTS_BATCH)), tmout);
+    
+    *nbr_evnts = 0;
+    if (nbr_rdy == -1)
+    {
+        if (errno == EINTR)
+        {
+            return true;
+        }
+        
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    for (int i = 0; i < nbr_rdy; ++i)
+    {
+        evnts[i].dat = epll_evnts[i].data.u64;
+        evnts[i].evnts = __hidden_glibc::__to_event_flags(epll_evnts[i].events);
+    }
+    
+    *nbr_evnts = static_cast<std::size_t>(nbr_rdy);
+    
+    return true;
+#else
+    (void)pllr_fd;
+    (void)evnts;
+    (void)max_nbr_evnts;
+    (void)tmout;
+    *nbr_evnts = 0;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool create_event_notifier(int* fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    const int ntfr_fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    
+    if (ntfr_fd == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    *fd = ntfr_fd;
+    
+    return true;
+#else
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool notify_event_notifier(int fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    const std::uint64_t val = 1;
+    
+    while (::write(fd, &val, sizeof(val)) == -1)
+    {
+        if (errno == EAGAIN)
+        {
+            return true;
+        }
+        
+        if (errno != EINTR)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+    
+    return true;
+#else
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool clear_event_notifier(int fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    std::uint64_t val;
+    
+    while (::read(fd, &val, sizeof(val)) == -1)
+    {
+        if (errno == EAGAIN)
+        {
+            return true;
+        }
+        
+        if (errno != EINTR)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+    
+    return true;
+#else
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool set_signal_descriptor(
+        int* fd,
+        const int* sigs,
+        std::size_t nbr_sigs,
+        std::error_code* err_code
+) noexcept
+{
+#ifdef __linux__
+    ::sigset_t sig_st;
+    int res;
+    
+    ::sigemptyset(&sig_st);
+    for (std::size_t i = 0; i < nbr_sigs; ++i)
+    {
+        if (::sigaddset(&sig_st, sigs[i]) == -1)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+    
+    res = ::pthread_sigmask(SIG_BLOCK, &sig_st, nullptr);
+    if (res != 0)
+    {
+        assign_system_error_code(res, err_code);
+        return false;
+    }
+    
+    res = ::signalfd(*fd, &sig_st, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (res == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    *fd = res;
+    
+    return true;
+#else
+    (void)fd;
+    (void)sigs;
+    (void)nbr_sigs;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool read_signal_descriptor(int fd, int* sig, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    struct ::signalfd_siginfo sig_inf;
+    
+    *sig = 0;
+    while (::read(fd, &sig_inf, sizeof(sig_inf)) == -1)
+    {
+        if (errno == EAGAIN)
+        {
+            return true;
+        }
+        
+        if (errno != EINTR)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+    
+    *sig = static_cast<int>(sig_inf.ssi_signo);
+    
+    return true;
+#else
+    (void)fd;
+    *sig = 0;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool close_event_descriptor(int fd, std::error_code* err_code) noexcept
+{
+    if (::close(fd) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+}
+
+
+}
+}
+}
+
+
+#endif
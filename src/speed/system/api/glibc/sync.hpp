@@ -0,0 +1,205 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/api/glibc/sync.hpp
+ * @brief       sync functions header.
+ * @author      Killian
+ * @date        2018/10/01 - 09:20
+ */
+
+#ifndef SPEED_SYSTEM_API_GLIBC_SYNC_HPP
+#define SPEED_SYSTEM_API_GLIBC_SYNC_HPP
+
+#include "../../system_macros.hpp"
+#ifdef SPEED_GLIBC
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "../../error_code.hpp"
+
+
+namespace speed {
+namespace system {
+namespace glibc {
+
+
+/**
+ * @brief       Put the calling thread to sleep if a 32 bits word holds an expected value, until a
+ *              futex_wake on the same word. The check and the sleep are atomic.
+ * @param       addr : The address of the word.
+ * @param       expctd_val : The value the word has to hold for the thread to sleep.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If the thread has slept, or has not because the word did not hold the expected
+ *              value or because a signal interrupted the sleep, true is returned, otherwise false
+ *              is returned.
+ */
+inline bool futex_wait(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t expctd_val,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+#ifdef __linux__
+    if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT_PRIVATE,
+                  expctd_val, nullptr, nullptr, 0) == -1 &&
+        errno != EAGAIN && errno != EINTR)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    (void)addr;
+    (void)expctd_val;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+/**
+ * @brief       Wake threads that sleep in futex_wait on a 32 bits word.
+ * @param       addr : The address of the word.
+ * @param       nbr_thrds : The maximum number of threads to wake.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool futex_wake(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t nbr_thrds,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+#ifdef __linux__
+    if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE_PRIVATE,
+                  nbr_thrds > INT_MAX ? INT_MAX : static_cast<int>(nbr_thrds), nullptr, nullptr,
+                  0) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    (void)addr;
+    (void)nbr_thrds;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+/**
+ * @brief       Put the calling thread to sleep if a 32 bits word holds an expected value, until a
+ *              futex_wake_bitset on the same word with a bitset that shares a bit with the one of
+ *              the thread. The check and the sleep are atomic.
+ * @param       addr : The address of the word.
+ * @param       expctd_val : The value the word has to hold for the thread to sleep.
+ * @param       btst : The bitset of the thread, that must not be 0.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If the thread has slept, or has not because the word did not hold the expected
+ *              value or because a signal interrupted the sleep, true is returned, otherwise false
+ *              is returned.
+ */
+inline bool futex_wait_bitset(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t expctd_val,
+        std::uint32_t btst,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+#ifdef __linux__
+    if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAIT_BITSET_PRIVATE,
+                  expctd_val, nullptr, nullptr, btst) == -1 &&
+        errno != EAGAIN && errno != EINTR)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    (void)addr;
+    (void)expctd_val;
+    (void)btst;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+/**
+ * @brief       Wake threads that sleep in futex_wait_bitset on a 32 bits word with a bitset that
+ *              shares a bit with a given one.
+ * @param       addr : The address of the word.
+ * @param       nbr_thrds : The maximum number of threads to wake.
+ * @param       btst : The bitset, that must not be 0.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool futex_wake_bitset(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t nbr_thrds,
+        std::uint32_t btst,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+#ifdef __linux__
+    if (::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(addr), FUTEX_WAKE_BITSET_PRIVATE,
+                  nbr_thrds > INT_MAX ? INT_MAX : static_cast<int>(nbr_thrds), nullptr, nullptr,
+                  btst) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    (void)addr;
+    (void)nbr_thrds;
+    (void)btst;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+}
+}
+}
+
+
+#endif
+
+#endif
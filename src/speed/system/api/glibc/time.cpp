@@ -27,9 +27,15 @@
 #include "../system_macros.hpp"
 #ifdef SPEED_GLIBC
 
+#include <cerrno>
 #include <ctime>
+#include <poll.h>
 #include <sys/times.h>
 
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
 #include "time.hpp"
 
 
@@ -38,18 +44,33 @@ namespace system {
 namespace glibc {
 
 
-bool get_monotonic_time(time_specification* time_spec, std::error_code* err_code) noexcept
-{
-    struct ::timespec tp;
-    int clk;
+/** @cond */
+namespace __hidden_glibc {
 
+
+/**
+ * @brief       Get the clock used as monotonic time.
+ * @return      The clock used as monotonic time.
+ */
+inline ::clockid_t __get_monotonic_clock() noexcept
+{
 #if defined(__linux__) && LINUX_VERSION_CODE >= KERNEL_VERSION(2, 6, 39)
-    clk = CLOCK_BOOTTIME;
+    return CLOCK_BOOTTIME;
 #else
-    clock = CLOCK_MONOTONIC;
+    return CLOCK_MONOTONIC;
 #endif
+}
+
+
+} /* __hidden_glibc */
+/** @endcond */
+
+
+bool get_monotonic_time(time_specification* time_spec, std::error_code* err_code) noexcept
+{
+    struct ::timespec tp;
     
-    if (::clock_gettime(clk, &tp) == -1)
+    if (::clock_gettime(__hidden_glibc::__get_monotonic_clock(), &tp) == -1)
     {
         assign_system_error_code(errno, err_code);
         return false;
@@ -114,6 +135,112 @@ bool get_child_cpu_time(time_specification* time_spec, std::error_code* err_code
 }
 
 
+bool create_timer(int* fd, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    const int tmr_fd = ::timerfd_create(__hidden_glibc::__get_monotonic_clock(),
+                                        TFD_NONBLOCK | TFD_CLOEXEC);
+    
+    if (tmr_fd == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    *fd = tmr_fd;
+    
+    return true;
+#else
+    (void)fd;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool set_timer(int fd, const time_specification* deadln, std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    struct ::itimerspec spec = {};
+    
+    if (deadln != nullptr)
+    {
+        spec.it_value.tv_sec = static_cast<::time_t>(deadln->sec);
+        spec.it_value.tv_nsec = static_cast<long>(deadln->nsec);
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0)
+        {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    
+    if (::timerfd_settime(fd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    (void)fd;
+    (void)deadln;
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+bool read_timer(int fd, std::uint64_t* nbr_expirations, std::error_code* err_code) noexcept
+{
+    std::uint64_t nbr_exp;
+    
+    if (::read(fd, &nbr_exp, sizeof(nbr_exp)) != static_cast<::ssize_t>(sizeof(nbr_exp)))
+    {
+        if (errno != EAGAIN)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+        
+        nbr_exp = 0;
+    }
+    
+    *nbr_expirations = nbr_exp;
+    
+    return true;
+}
+
+
+bool wait_timer(int fd, std::error_code* err_code) noexcept
+{
+    struct ::pollfd pfd = {fd, POLLIN, 0};
+    
+    while (::poll(&pfd, 1, -1) == -1)
+    {
+        if (errno != EINTR)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+bool close_timer(int fd, std::error_code* err_code) noexcept
+{
+    if (::close(fd) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+}
+
+
 }
 }
 }
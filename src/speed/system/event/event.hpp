@@ -0,0 +1,230 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event.hpp
+ * @brief       event functions header.
+ * @author      Killian
+ * @date        2018/10/04 - 09:37
+ */
+
+#ifndef SPEED_SYSTEM_EVENT_EVENT_HPP
+#define SPEED_SYSTEM_EVENT_EVENT_HPP
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "../api/glibc/event.hpp"
+#include "../error_code.hpp"
+#include "../system_macros.hpp"
+#include "../types.hpp"
+#include "event_flags.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Create an event poller, that is a file descriptor that watches the events of other
+ *              file descriptors.
+ * @param       fd : The value in which store the file descriptor of the poller.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool create_event_poller(int* fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(create_event_poller, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Start watching the events of a file descriptor. The watch is edge-triggered, so an
+ *              event is reported once each time it occurs and the file descriptor has to be read
+ *              or written until it would block.
+ * @param       pllr_fd : The file descriptor of the poller.
+ * @param       fd : The file descriptor to watch.
+ * @param       evnts : The events to watch.
+ * @param       dat : The data reported with the events of the file descriptor.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool add_event_watch(
+        int pllr_fd,
+        int fd,
+        event_flags evnts,
+        std::uint64_t dat,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(add_event_watch, false, pllr_fd, fd, evnts, dat, err_code);
+}
+
+
+/**
+ * @brief       Change the events watched on a file descriptor and the data reported with them.
+ * @param       pllr_fd : The file descriptor of the poller.
+ * @param       fd : The watched file descriptor.
+ * @param       evnts : The events to watch.
+ * @param       dat : The data reported with the events of the file descriptor.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool modify_event_watch(
+        int pllr_fd,
+        int fd,
+        event_flags evnts,
+        std::uint64_t dat,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(modify_event_watch, false, pllr_fd, fd, evnts, dat, err_code);
+}
+
+
+/**
+ * @brief       Stop watching the events of a file descriptor.
+ * @param       pllr_fd : The file descriptor of the poller.
+ * @param       fd : The watched file descriptor.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool remove_event_watch(int pllr_fd, int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(remove_event_watch, false, pllr_fd, fd, err_code);
+}
+
+
+/**
+ * @brief       Wait for events on the watched file descriptors.
+ * @param       pllr_fd : The file descriptor of the poller.
+ * @param       evnts : The array in which store the events.
+ * @param       max_nbr_evnts : The maximum number of events to store.
+ * @param       tmout : The maximum time to wait in milliseconds, -1 to wait without limit and 0
+ *              to return immediately.
+ * @param       nbr_evnts : The value in which store the number of events stored. It is 0 if the
+ *              time limit has been reached or a signal interrupted the wait.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool wait_events(
+        int pllr_fd,
+        event_record* evnts,
+        std::size_t max_nbr_evnts,
+        int tmout,
+        std::size_t* nbr_evnts,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(wait_events, false, pllr_fd, evnts, max_nbr_evnts, tmout, nbr_evnts,
+                            err_code);
+}
+
+
+/**
+ * @brief       Create an event notifier, that is a file descriptor readable once another thread
+ *              notifies it.
+ * @param       fd : The value in which store the file descriptor of the notifier.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool create_event_notifier(int* fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(create_event_notifier, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Notify an event notifier, making it readable.
+ * @param       fd : The file descriptor of the notifier.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool notify_event_notifier(int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(notify_event_notifier, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Consume the notifications of an event notifier, making it not readable.
+ * @param       fd : The file descriptor of the notifier.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool clear_event_notifier(int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(clear_event_notifier, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Create a signal descriptor, that is a file descriptor readable once a signal is
+ *              pending, or change the signals of an existing one. The signals are blocked in the
+ *              calling thread so that they are not delivered to their handlers, and they have to
+ *              be blocked in the other threads too, which is the case of the threads created
+ *              afterwards.
+ * @param       fd : The value that holds the file descriptor of the signal descriptor to change,
+ *              or -1 to create one, in which store the file descriptor of the signal descriptor.
+ * @param       sigs : The signals to report.
+ * @param       nbr_sigs : The number of signals to report.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool set_signal_descriptor(
+        int* fd,
+        const int* sigs,
+        std::size_t nbr_sigs,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(set_signal_descriptor, false, fd, sigs, nbr_sigs, err_code);
+}
+
+
+/**
+ * @brief       Take a pending signal from a signal descriptor.
+ * @param       fd : The file descriptor of the signal descriptor.
+ * @param       sig : The value in which store the signal taken, or 0 if no signal is pending.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool read_signal_descriptor(int fd, int* sig, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(read_signal_descriptor, false, fd, sig, err_code);
+}
+
+
+/**
+ * @brief       Close an event poller, an event notifier or a signal descriptor.
+ * @param       fd : The file descriptor to close.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool close_event_descriptor(int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(close_event_descriptor, false, fd, err_code);
+}
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,85 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event_flags.hpp
+ * @brief       event_flags header.
+ * @author      Killian
+ * @date        2018/10/04 - 09:37
+ */
+
+#ifndef SPEED_SYSTEM_EVENT_EVENT_FLAGS_HPP
+#define SPEED_SYSTEM_EVENT_EVENT_FLAGS_HPP
+
+#include <cstdint>
+
+#include "../../lowlevel.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Represents the events of a file descriptor.
+ */
+enum class event_flags : std::uint32_t
+{
+    /** No event. */
+    NIL = 0,
+    
+    /** The file descriptor is readable. */
+    READABLE = 0x1,
+    
+    /** The file descriptor is writable. */
+    WRITABLE = 0x2,
+    
+    /** An error occurred on the file descriptor. It is always watched. */
+    ERROR = 0x4,
+    
+    /** The peer closed its end of the file descriptor. It is always watched. */
+    HANGUP = 0x8,
+    
+    /** All the events. */
+    FULL = 0xF
+};
+
+
+/** Represents the events of a file descriptor. */
+using ef_t = event_flags;
+
+
+}
+}
+
+
+/** @cond */
+namespace speed {
+namespace lowlevel {
+template<>
+struct enum_bitwise_operators<speed::system::event_flags>
+{
+    static constexpr bool enable = true;
+};
+}
+}
+/** @endcond */
+
+
+#endif
@@ -0,0 +1,427 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event_loop.cpp
+ * @brief       event_loop class definition.
+ * @author      Killian
+ * @date        2018/10/04 - 11:12
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <iterator>
+#include <utility>
+
+#include "../system_exception.hpp"
+#include "event_loop.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+event_loop::event_loop(std::size_t max_nbr_evnts)
+        : wtchs_()
+        , evnts_(max_nbr_evnts != 0 ? max_nbr_evnts : 1)
+        , dfrd_()
+        , btch_()
+        , pstd_()
+        , sig_cbs_()
+        , sigs_()
+        , pstd_mtx_()
+        , nxt_evnt_(0)
+        , nbr_evnts_(0)
+        , nbr_wtchs_(0)
+        , pllr_fd_(-1)
+        , ntfr_fd_(-1)
+        , sig_fd_(-1)
+        , stop_(false)
+{
+    if (!create_event_poller(&pllr_fd_))
+    {
+        throw system_exception();
+    }
+    
+    if (!create_event_notifier(&ntfr_fd_) ||
+        !add_event_watch(pllr_fd_, ntfr_fd_, event_flags::READABLE, NOTIFIER_DATA))
+    {
+        if (ntfr_fd_ != -1)
+        {
+            close_event_descriptor(ntfr_fd_);
+        }
+        
+        close_event_descriptor(pllr_fd_);
+        throw system_exception();
+    }
+}
+
+
+event_loop::~event_loop() noexcept
+{
+    if (sig_fd_ != -1)
+    {
+        close_event_descriptor(sig_fd_);
+    }
+    
+    close_event_descriptor(ntfr_fd_);
+    close_event_descriptor(pllr_fd_);
+}
+
+
+bool event_loop::add_watch(
+        int fd,
+        event_flags evnts,
+        watch_callback_type cb,
+        std::error_code* err_code
+)
+{
+    if (fd < 0)
+    {
+        assign_system_error_code(EBADF, err_code);
+        return false;
+    }
+    
+    if (static_cast<std::size_t>(fd) >= wtchs_.size())
+    {
+        wtchs_.resize(static_cast<std::size_t>(fd) + 1);
+    }
+    
+    watch_entry& wtch = wtchs_[fd];
+    
+    if (wtch.actv)
+    {
+        assign_system_error_code(EEXIST, err_code);
+        return false;
+    }
+    
+    if (!add_event_watch(pllr_fd_, fd, evnts, get_watch_data(fd, wtch.gen), err_code))
+    {
+        return false;
+    }
+    
+    wtch.cb = std::move(cb);
+    wtch.actv = true;
+    ++nbr_wtchs_;
+    
+    return true;
+}
+
+
+bool event_loop::modify_watch(int fd, event_flags evnts, std::error_code* err_code) noexcept
+{
+    if (fd < 0 || static_cast<std::size_t>(fd) >= wtchs_.size() || !wtchs_[fd].actv)
+    {
+        assign_system_error_code(ENOENT, err_code);
+        return false;
+    }
+    
+    return modify_event_watch(pllr_fd_, fd, evnts, get_watch_data(fd, wtchs_[fd].gen), err_code);
+}
+
+
+bool event_loop::remove_watch(int fd, std::error_code* err_code) noexcept
+{
+    if (fd < 0 || static_cast<std::size_t>(fd) >= wtchs_.size() || !wtchs_[fd].actv)
+    {
+        assign_system_error_code(ENOENT, err_code);
+        return false;
+    }
+    
+    watch_entry& wtch = wtchs_[fd];
+    
+    wtch.cb = nullptr;
+    wtch.actv = false;
+    ++wtch.gen;
+    --nbr_wtchs_;
+    
+    return remove_event_watch(pllr_fd_, fd, err_code);
+}
+
+
+bool event_loop::add_signal_handler(int sig, signal_callback_type cb, std::error_code* err_code)
+{
+    if (sig <= 0)
+    {
+        assign_system_error_code(EINVAL, err_code);
+        return false;
+    }
+    
+    if (static_cast<std::size_t>(sig) >= sig_cbs_.size())
+    {
+        sig_cbs_.resize(static_cast<std::size_t>(sig) + 1);
+    }
+    
+    if (std::find(sigs_.begin(), sigs_.end(), sig) == sigs_.end())
+    {
+        sigs_.push_back(sig);
+        if (!update_signal_descriptor(err_code))
+        {
+            sigs_.pop_back();
+            return false;
+        }
+    }
+    
+    sig_cbs_[sig] = std::move(cb);
+    
+    return true;
+}
+
+
+bool event_loop::remove_signal_handler(int sig, std::error_code* err_code)
+{
+    auto it = std::find(sigs_.begin(), sigs_.end(), sig);
+    
+    if (it == sigs_.end())
+    {
+        assign_system_error_code(ENOENT, err_code);
+        return false;
+    }
+    
+    sigs_.erase(it);
+    sig_cbs_[sig] = nullptr;
+    
+    return update_signal_descriptor(err_code);
+}
+
+
+void event_loop::defer(task_type tsk)
+{
+    dfrd_.push_back(std::move(tsk));
+}
+
+
+void event_loop::post(task_type tsk)
+{
+    bool was_empty;
+    
+    if (cur_lp_ == this)
+    {
+        dfrd_.push_back(std::move(tsk));
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lck(pstd_mtx_);
+        
+        was_empty = pstd_.empty();
+        pstd_.push_back(std::move(tsk));
+    }
+    
+    if (was_empty)
+    {
+        notify_event_notifier(ntfr_fd_);
+    }
+}
+
+
+std::size_t event_loop::run_once(int tmout)
+{
+    struct current_loop_guard
+    {
+        explicit current_loop_guard(event_loop* lp) noexcept
+                : prv(cur_lp_)
+        {
+            cur_lp_ = lp;
+        }
+        
+        ~current_loop_guard() noexcept
+        {
+            cur_lp_ = prv;
+        }
+        
+        event_loop* prv;
+    } gurd(this);
+    
+    std::size_t nbr_clls = 0;
+    
+    if (nxt_evnt_ == nbr_evnts_)
+    {
+        nxt_evnt_ = 0;
+        nbr_evnts_ = 0;
+        wait_events(pllr_fd_, evnts_.data(), evnts_.size(), dfrd_.empty() ? tmout : 0,
+                    &nbr_evnts_);
+    }
+    
+    while (nxt_evnt_ < nbr_evnts_)
+    {
+        const event_record& evnt = evnts_[nxt_evnt_++];
+        
+        if (evnt.dat == NOTIFIER_DATA)
+        {
+            clear_event_notifier(ntfr_fd_);
+            take_posted_tasks();
+        }
+        else if (evnt.dat == SIGNAL_DATA)
+        {
+            nbr_clls += dispatch_signals();
+        }
+        else if (dispatch_watch(evnt))
+        {
+            ++nbr_clls;
+        }
+    }
+    
+    return nbr_clls + run_deferred_tasks();
+}
+
+
+void event_loop::run()
+{
+    while (!stop_.exchange(false, std::memory_order_acq_rel))
+    {
+        run_once();
+    }
+}
+
+
+void event_loop::stop() noexcept
+{
+    stop_.store(true, std::memory_order_release);
+    if (cur_lp_ != this)
+    {
+        notify_event_notifier(ntfr_fd_);
+    }
+}
+
+
+bool event_loop::dispatch_watch(const event_record& evnt)
+{
+    const auto fd = static_cast<std::size_t>(evnt.dat & 0xFFFFFFFF);
+    const auto gen = static_cast<std::uint32_t>(evnt.dat >> 32);
+    watch_callback_type cb;
+    
+    if (fd >= wtchs_.size() || !wtchs_[fd].actv || wtchs_[fd].gen != gen)
+    {
+        return false;
+    }
+    
+    cb = std::move(wtchs_[fd].cb);
+    
+    try
+    {
+        cb(evnt.evnts);
+    }
+    catch (...)
+    {
+        if (wtchs_[fd].actv && wtchs_[fd].gen == gen)
+        {
+            wtchs_[fd].cb = std::move(cb);
+        }
+        
+        throw;
+    }
+    
+    if (wtchs_[fd].actv && wtchs_[fd].gen == gen)
+    {
+        wtchs_[fd].cb = std::move(cb);
+    }
+    
+    return true;
+}
+
+
+std::size_t event_loop::dispatch_signals()
+{
+    std::size_t nbr_clls = 0;
+    int sig;
+    
+    while (read_signal_descriptor(sig_fd_, &sig) && sig != 0)
+    {
+        if (static_cast<std::size_t>(sig) < sig_cbs_.size() && sig_cbs_[sig])
+        {
+            signal_callback_type cb = sig_cbs_[sig];
+            
+            cb(sig);
+            ++nbr_clls;
+        }
+    }
+    
+    return nbr_clls;
+}
+
+
+void event_loop::take_posted_tasks()
+{
+    std::lock_guard<std::mutex> lck(pstd_mtx_);
+    
+    if (dfrd_.empty())
+    {
+        dfrd_.swap(pstd_);
+    }
+    else
+    {
+        dfrd_.insert(dfrd_.end(), std::make_move_iterator(pstd_.begin()),
+                     std::make_move_iterator(pstd_.end()));
+        pstd_.clear();
+    }
+}
+
+
+std::size_t event_loop::run_deferred_tasks()
+{
+    std::size_t i = 0;
+    
+    btch_.swap(dfrd_);
+    
+    try
+    {
+        for (; i < btch_.size(); ++i)
+        {
+            btch_[i]();
+        }
+    }
+    catch (...)
+    {
+        dfrd_.insert(dfrd_.begin(), std::make_move_iterator(btch_.begin() + i + 1),
+                     std::make_move_iterator(btch_.end()));
+        btch_.clear();
+        
+        throw;
+    }
+    
+    btch_.clear();
+    
+    return i;
+}
+
+
+bool event_loop::update_signal_descriptor(std::error_code* err_code)
+{
+    const bool crtd = sig_fd_ == -1;
+    
+    if (!set_signal_descriptor(&sig_fd_, sigs_.data(), sigs_.size(), err_code))
+    {
+        return false;
+    }
+    
+    if (crtd && !add_event_watch(pllr_fd_, sig_fd_, event_flags::READABLE, SIGNAL_DATA, err_code))
+    {
+        close_event_descriptor(sig_fd_);
+        sig_fd_ = -1;
+        
+        return false;
+    }
+    
+    return true;
+}
+
+
+}
+}
@@ -0,0 +1,316 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event_loop.hpp
+ * @brief       event_loop class header.
+ * @author      Killian
+ * @date        2018/10/04 - 11:12
+ */
+
+#ifndef SPEED_SYSTEM_EVENT_EVENT_LOOP_HPP
+#define SPEED_SYSTEM_EVENT_EVENT_LOOP_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <system_error>
+#include <vector>
+
+#include "../types.hpp"
+#include "event.hpp"
+#include "event_flags.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents an event loop, that waits for the events of many file
+ *              descriptors with a single thread and calls a callback for each of them. The file
+ *              descriptors are watched in edge-triggered mode, so an event is reported once each
+ *              time it occurs and the callbacks have to read or write until the file descriptor
+ *              would block. Tasks can be deferred from the loop thread and posted from any thread:
+ *              they are run in batches at the end of the loop iterations, and the other threads
+ *              wake the loop with an event notifier only when the queue was empty. Signals can be
+ *              handled by the loop through a signal descriptor. Except post and stop, the member
+ *              functions have to be called from the loop thread, or before the loop runs.
+ */
+class event_loop
+{
+public:
+    /** The type of the callbacks of the watched file descriptors, that receive the events. */
+    using watch_callback_type = std::function<void(event_flags)>;
+    
+    /** The type of the callbacks of the signals, that receive the signal. */
+    using signal_callback_type = std::function<void(int)>;
+    
+    /** The type of the deferred and posted tasks. */
+    using task_type = std::function<void()>;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       max_nbr_evnts : The maximum number of events taken by a loop iteration.
+     * @throw       speed::system::system_exception : If the poller or the notifier can not be
+     *              created.
+     */
+    explicit event_loop(std::size_t max_nbr_evnts = 256);
+    
+    /** @cond */
+    event_loop(const event_loop&) = delete;
+    
+    event_loop& operator =(const event_loop&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. The tasks not run yet are destroyed.
+     */
+    ~event_loop() noexcept;
+    
+    /**
+     * @brief       Start watching a file descriptor.
+     * @param       fd : The file descriptor, that should be non-blocking.
+     * @param       evnts : The events to watch. The errors and the hang ups are always watched.
+     * @param       cb : The callback called with the events that occurred.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool add_watch(
+            int fd,
+            event_flags evnts,
+            watch_callback_type cb,
+            std::error_code* err_code = nullptr
+    );
+    
+    /**
+     * @brief       Change the events watched on a file descriptor.
+     * @param       fd : The watched file descriptor.
+     * @param       evnts : The events to watch.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool modify_watch(int fd, event_flags evnts, std::error_code* err_code = nullptr) noexcept;
+    
+    /**
+     * @brief       Stop watching a file descriptor. It has to be called before the file
+     *              descriptor is closed. It can be called from a callback, even for its own file
+     *              descriptor, and the events of the file descriptor not dispatched yet are
+     *              dropped.
+     * @param       fd : The watched file descriptor.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool remove_watch(int fd, std::error_code* err_code = nullptr) noexcept;
+    
+    /**
+     * @brief       Handle a signal in the loop. The signal is blocked in the calling thread, and it
+     *              has to be blocked in all the threads of the process, so it should be handled
+     *              before the other threads are created.
+     * @param       sig : The signal.
+     * @param       cb : The callback called each time the signal is received.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool add_signal_handler(int sig, signal_callback_type cb, std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Stop handling a signal in the loop. The signal stays blocked.
+     * @param       sig : The signal.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool remove_signal_handler(int sig, std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Run a task at the end of the current loop iteration, or of the next one if it is
+     *              called from a deferred task. It has to be called from the loop thread.
+     * @param       tsk : The task.
+     */
+    void defer(task_type tsk);
+    
+    /**
+     * @brief       Run a task in the loop thread, with the batch of deferred tasks of the next loop
+     *              iteration. It can be called from any thread.
+     * @param       tsk : The task.
+     */
+    void post(task_type tsk);
+    
+    /**
+     * @brief       Run a loop iteration: wait for events, call their callbacks and run the batch of
+     *              deferred and posted tasks. It does not wait if tasks are deferred. If a callback
+     *              throws an exception, it is propagated and the events and tasks not dispatched
+     *              yet are kept for the next iteration.
+     * @param       tmout : The maximum time to wait in milliseconds, -1 to wait without limit.
+     * @return      The number of callbacks called and tasks run.
+     */
+    std::size_t run_once(int tmout = -1);
+    
+    /**
+     * @brief       Run loop iterations until stop is called.
+     */
+    void run();
+    
+    /**
+     * @brief       Make the running or the next run call return after its current iteration. It
+     *              can be called from any thread.
+     */
+    void stop() noexcept;
+    
+    /**
+     * @brief       Allows knowing whether the calling thread is the one that runs the loop.
+     * @return      If the calling thread runs the loop true is returned, otherwise false is
+     *              returned.
+     */
+    [[nodiscard]] inline bool is_in_loop_thread() const noexcept
+    {
+        return cur_lp_ == this;
+    }
+    
+    /**
+     * @brief       Get the number of watched file descriptors.
+     * @return      The number of watched file descriptors.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return nbr_wtchs_;
+    }
+
+private:
+    /**
+     * @brief       Represents a watched file descriptor.
+     */
+    struct watch_entry
+    {
+        /** The callback. */
+        watch_callback_type cb;
+        
+        /** The generation of the watch, increased when it is removed. */
+        std::uint32_t gen = 0;
+        
+        /** Whether the file descriptor is watched. */
+        bool actv = false;
+    };
+    
+    /** The data of the events of the event notifier. */
+    static constexpr std::uint64_t NOTIFIER_DATA = ~static_cast<std::uint64_t>(0);
+    
+    /** The data of the events of the signal descriptor. */
+    static constexpr std::uint64_t SIGNAL_DATA = NOTIFIER_DATA - 1;
+    
+    /**
+     * @brief       Call the callback of a watched file descriptor.
+     * @param       evnt : The event.
+     * @return      If a callback has been called true is returned, otherwise false is returned.
+     */
+    bool dispatch_watch(const event_record& evnt);
+    
+    /**
+     * @brief       Call the callbacks of the pending signals.
+     * @return      The number of callbacks called.
+     */
+    std::size_t dispatch_signals();
+    
+    /**
+     * @brief       Move the posted tasks to the deferred ones.
+     */
+    void take_posted_tasks();
+    
+    /**
+     * @brief       Run the batch of deferred tasks.
+     * @return      The number of tasks run.
+     */
+    std::size_t run_deferred_tasks();
+    
+    /**
+     * @brief       Update the signals of the signal descriptor, creating it if needed.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool update_signal_descriptor(std::error_code* err_code);
+    
+    /**
+     * @brief       Get the data of the events of a watched file descriptor.
+     * @param       fd : The file descriptor.
+     * @param       gen : The generation of the watch.
+     * @return      The data of the events.
+     */
+    static inline std::uint64_t get_watch_data(int fd, std::uint32_t gen) noexcept
+    {
+        return (static_cast<std::uint64_t>(gen) << 32) | static_cast<std::uint32_t>(fd);
+    }
+    
+    /** The loop run by the current thread. */
+    static inline thread_local event_loop* cur_lp_ = nullptr;
+    
+    /** The watched file descriptors, indexed by file descriptor. */
+    std::deque<watch_entry> wtchs_;
+    
+    /** The events taken by the last wait. */
+    std::vector<event_record> evnts_;
+    
+    /** The deferred tasks, run at the end of the current iteration. */
+    std::vector<task_type> dfrd_;
+    
+    /** The batch of tasks being run. */
+    std::vector<task_type> btch_;
+    
+    /** The tasks posted by other threads. */
+    std::vector<task_type> pstd_;
+    
+    /** The callbacks of the signals, indexed by signal. */
+    std::vector<signal_callback_type> sig_cbs_;
+    
+    /** The signals handled. */
+    std::vector<int> sigs_;
+    
+    /** Mutex that protects the posted tasks. */
+    std::mutex pstd_mtx_;
+    
+    /** The index of the next event to dispatch. */
+    std::size_t nxt_evnt_;
+    
+    /** The number of events taken by the last wait. */
+    std::size_t nbr_evnts_;
+    
+    /** The number of watched file descriptors. */
+    std::size_t nbr_wtchs_;
+    
+    /** The file descriptor of the poller. */
+    int pllr_fd_;
+    
+    /** The file descriptor of the event notifier. */
+    int ntfr_fd_;
+    
+    /** The file descriptor of the signal descriptor, or -1 if it is not created. */
+    int sig_fd_;
+    
+    /** Whether the loop has to stop. */
+    std::atomic<bool> stop_;
+};
+
+
+}
+}
+
+
+#endif
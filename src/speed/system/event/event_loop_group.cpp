@@ -0,0 +1,128 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event_loop_group.cpp
+ * @brief       event_loop_group class definition.
+ * @author      Killian
+ * @date        2018/10/04 - 15:26
+ */
+
+#include <algorithm>
+#include <utility>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "event_loop_group.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+event_loop_group::event_loop_group(std::size_t nbr_lps)
+        : lps_()
+        , thrds_()
+{
+    if (nbr_lps == 0)
+    {
+        nbr_lps = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    
+    lps_.reserve(nbr_lps);
+    for (std::size_t i = 0; i < nbr_lps; ++i)
+    {
+        lps_.push_back(std::make_unique<event_loop>());
+    }
+    
+    thrds_.reserve(nbr_lps);
+    for (std::size_t i = 0; i < nbr_lps; ++i)
+    {
+        thrds_.emplace_back(&event_loop::run, lps_[i].get());
+        pin_thread(thrds_.back(), i);
+    }
+}
+
+
+event_loop_group::~event_loop_group() noexcept
+{
+    for (auto& x : lps_)
+    {
+        x->stop();
+    }
+    
+    for (auto& x : thrds_)
+    {
+        x.join();
+    }
+}
+
+
+std::size_t event_loop_group::select_loop(std::uint64_t ky) const noexcept
+{
+    const std::uint64_t hsh = (ky * 0x9E3779B97F4A7C15) >> 32;
+    
+    return static_cast<std::size_t>((hsh * lps_.size()) >> 32);
+}
+
+
+std::size_t event_loop_group::distribute_watch(
+        int fd,
+        event_flags evnts,
+        event_loop::watch_callback_type cb
+)
+{
+    const std::size_t idx = select_loop(static_cast<std::uint64_t>(fd));
+    event_loop* lp = lps_[idx].get();
+    
+    lp->post([lp, fd, evnts, cb = std::move(cb)]() mutable
+    {
+        event_loop::watch_callback_type err_cb = cb;
+        
+        if (!lp->add_watch(fd, evnts, std::move(cb)))
+        {
+            err_cb(event_flags::ERROR);
+        }
+    });
+    
+    return idx;
+}
+
+
+void event_loop_group::pin_thread(std::thread& thrd, std::size_t idx) noexcept
+{
+#ifdef __linux__
+    const std::size_t nbr_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+    cpu_set_t cpu_st;
+    
+    CPU_ZERO(&cpu_st);
+    CPU_SET(idx % nbr_cpus, &cpu_st);
+    ::pthread_setaffinity_np(thrd.native_handle(), sizeof(cpu_set_t), &cpu_st);
+#else
+    (void)thrd;
+    (void)idx;
+#endif
+}
+
+
+}
+}
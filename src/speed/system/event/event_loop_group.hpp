@@ -0,0 +1,130 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/event/event_loop_group.hpp
+ * @brief       event_loop_group class header.
+ * @author      Killian
+ * @date        2018/10/04 - 15:26
+ */
+
+#ifndef SPEED_SYSTEM_EVENT_EVENT_LOOP_GROUP_HPP
+#define SPEED_SYSTEM_EVENT_EVENT_LOOP_GROUP_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "event_flags.hpp"
+#include "event_loop.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a group of event loops, each run by its own thread pinned to
+ *              a CPU. The file descriptors are spread across the loops by hashing a key, like
+ *              SO_REUSEPORT spreads the connections across the sockets bound to a port, so each
+ *              file descriptor is always handled by the same loop without any locking.
+ */
+class event_loop_group
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_lps : The number of loops. If it is 0 the number of hardware threads is
+     *              used.
+     * @throw       speed::system::system_exception : If a loop can not be created.
+     */
+    explicit event_loop_group(std::size_t nbr_lps = 0);
+    
+    /** @cond */
+    event_loop_group(const event_loop_group&) = delete;
+    
+    event_loop_group& operator =(const event_loop_group&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. It stops the loops and waits for their threads.
+     */
+    ~event_loop_group() noexcept;
+    
+    /**
+     * @brief       Get a loop.
+     * @param       idx : The index of the loop.
+     * @return      The loop.
+     */
+    [[nodiscard]] inline event_loop& get_loop(std::size_t idx) noexcept
+    {
+        return *lps_[idx];
+    }
+    
+    /**
+     * @brief       Get the index of the loop that handles a key. The keys are hashed, so
+     *              consecutive keys like file descriptors are spread evenly.
+     * @param       ky : The key.
+     * @return      The index of the loop that handles the key.
+     */
+    [[nodiscard]] std::size_t select_loop(std::uint64_t ky) const noexcept;
+    
+    /**
+     * @brief       Watch a file descriptor in the loop selected by the file descriptor. The watch
+     *              is added from the loop thread. If it can not be added, the callback is called
+     *              with the error event.
+     * @param       fd : The file descriptor, that should be non-blocking.
+     * @param       evnts : The events to watch.
+     * @param       cb : The callback called with the events that occurred, from the loop thread.
+     * @return      The index of the loop that watches the file descriptor.
+     */
+    std::size_t distribute_watch(int fd, event_flags evnts, event_loop::watch_callback_type cb);
+    
+    /**
+     * @brief       Get the number of loops.
+     * @return      The number of loops.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return lps_.size();
+    }
+
+private:
+    /**
+     * @brief       Pin a thread to a CPU.
+     * @param       thrd : The thread.
+     * @param       idx : The index of the thread, from which the CPU is chosen.
+     */
+    static void pin_thread(std::thread& thrd, std::size_t idx) noexcept;
+    
+    /** The loops. */
+    std::vector<std::unique_ptr<event_loop>> lps_;
+    
+    /** The threads that run the loops. */
+    std::vector<std::thread> thrds_;
+};
+
+
+}
+}
+
+
+#endif
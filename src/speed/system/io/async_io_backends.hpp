@@ -0,0 +1,57 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/io/async_io_backends.hpp
+ * @brief       async_io_backends header.
+ * @author      Killian
+ * @date        2018/10/05 - 10:14
+ */
+
+#ifndef SPEED_SYSTEM_IO_ASYNC_IO_BACKENDS_HPP
+#define SPEED_SYSTEM_IO_ASYNC_IO_BACKENDS_HPP
+
+#include <cstdint>
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Represents the backends of an asynchronous I/O engine.
+ */
+enum class async_io_backends : std::uint8_t
+{
+    /** The I/O ring if the kernel supports it, otherwise the thread pool. */
+    AUTO,
+    
+    /** A kernel I/O ring (io_uring), to which the requests are submitted in batches. */
+    IO_RING,
+    
+    /** A pool of threads that run blocking system calls. */
+    THREAD_POOL
+};
+
+
+}
+}
+
+
+#endif
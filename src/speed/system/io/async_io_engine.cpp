@@ -0,0 +1,1046 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/io/async_io_engine.cpp
+ * @brief       async_io_engine class definition.
+ * @author      Killian
+ * @date        2018/10/05 - 10:14
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#include "../event/event.hpp"
+#include "../system_exception.hpp"
+#include "async_io_engine.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/** @cond */
+namespace __hidden_io {
+
+
+#ifdef __linux__
+/**
+ * @brief       Create an I/O ring.
+ * @param       nbr_entrs : The number of entries of the submission ring.
+ * @param       prms : The parameters of the ring, filled by the kernel.
+ * @return      The file descriptor of the ring, or -1 if function fails.
+ */
+inline int __io_uring_setup(std::uint32_t nbr_entrs, struct ::io_uring_params* prms) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, nbr_entrs, prms));
+}
+
+
+/**
+ * @brief       Submit the entries of the submission ring and wait for completions.
+ * @param       fd : The file descriptor of the ring.
+ * @param       nbr_sbmtd : The number of entries to submit.
+ * @param       min_nbr_cmpltd : The number of completions to wait for.
+ * @param       flgs : The flags.
+ * @return      The number of entries submitted, or -1 if function fails.
+ */
+inline int __io_uring_enter(
+        int fd,
+        std::uint32_t nbr_sbmtd,
+        std::uint32_t min_nbr_cmpltd,
+        std::uint32_t flgs
+) noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, nbr_sbmtd, min_nbr_cmpltd, flgs,
+                                      nullptr, 0));
+}
+
+
+/**
+ * @brief       Register or unregister resources in an I/O ring.
+ * @param       fd : The file descriptor of the ring.
+ * @param       op : The operation.
+ * @param       arg : The argument of the operation.
+ * @param       nbr_args : The number of elements of the argument.
+ * @return      If function fails -1 is returned.
+ */
+inline int __io_uring_register(int fd, unsigned int op, const void* arg, unsigned int nbr_args)
+        noexcept
+{
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, op, arg, nbr_args));
+}
+
+
+/** The operations an I/O ring has to support to be used. */
+constexpr std::uint8_t REQUIRED_OPERATIONS[] = {
+        IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED,
+        IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_FSYNC, IORING_OP_CLOSE
+};
+
+
+static_assert(sizeof(struct ::statx) <= 256, "the status buffer is too small");
+#endif
+
+
+} /* __hidden_io */
+/** @endcond */
+
+
+async_io_engine::async_io_engine(
+        std::uint32_t queue_dpth,
+        async_io_backends bcknd,
+        std::size_t nbr_thrds
+)
+        : reqs_()
+        , free_idxs_()
+        , pndng_()
+        , bfrs_()
+        , fxd_fls_()
+        , rng_()
+        , thrds_()
+        , pl_reqs_()
+        , cmpls_()
+        , rpd_()
+        , mtx_()
+        , wrk_cv_()
+        , cmpl_cv_()
+        , nxt_pndng_(0)
+        , nbr_in_flght_(0)
+        , queue_dpth_(queue_dpth != 0 ? queue_dpth : 1)
+        , ntfr_fd_(-1)
+        , bcknd_(bcknd)
+        , stop_(false)
+{
+    if (bcknd_ != async_io_backends::THREAD_POOL)
+    {
+        if (setup_ring(static_cast<std::uint32_t>(queue_dpth_)))
+        {
+            bcknd_ = async_io_backends::IO_RING;
+            return;
+        }
+        
+        if (bcknd_ == async_io_backends::IO_RING)
+        {
+            throw system_exception();
+        }
+    }
+    
+    bcknd_ = async_io_backends::THREAD_POOL;
+    nbr_thrds = std::max(nbr_thrds, static_cast<std::size_t>(1));
+    
+    thrds_.reserve(nbr_thrds);
+    for (std::size_t i = 0; i < nbr_thrds; ++i)
+    {
+        thrds_.emplace_back(&async_io_engine::work, this);
+    }
+}
+
+
+async_io_engine::~async_io_engine() noexcept
+{
+    std::error_code err_code;
+    
+    pndng_.clear();
+    nxt_pndng_ = 0;
+    for (auto& x : reqs_)
+    {
+        x.cb = nullptr;
+    }
+    
+    while (nbr_in_flght_ > 0 && !err_code)
+    {
+        wait(&err_code);
+    }
+    
+    if (bcknd_ == async_io_backends::IO_RING)
+    {
+        teardown_ring();
+    }
+    else
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            stop_ = true;
+        }
+        
+        wrk_cv_.notify_all();
+        for (auto& x : thrds_)
+        {
+            x.join();
+        }
+    }
+    
+    if (ntfr_fd_ != -1)
+    {
+        close_event_descriptor(ntfr_fd_);
+    }
+}
+
+
+void async_io_engine::read(int fd, void* bfr, std::size_t sz, std::uint64_t off, callback_type cb)
+{
+    request& req = add_request(request_types::READ, fd, std::move(cb));
+    
+    req.bfr = bfr;
+    req.sz = sz;
+    req.off = off;
+}
+
+
+void async_io_engine::write(
+        int fd,
+        const void* bfr,
+        std::size_t sz,
+        std::uint64_t off,
+        callback_type cb
+)
+{
+    request& req = add_request(request_types::WRITE, fd, std::move(cb));
+    
+    req.bfr = const_cast<void*>(bfr);
+    req.sz = sz;
+    req.off = off;
+}
+
+
+void async_io_engine::open(
+        int dir_fd,
+        const char* pth,
+        int flgs,
+        std::uint32_t mde,
+        callback_type cb
+)
+{
+    request& req = add_request(request_types::OPEN, dir_fd, std::move(cb));
+    
+    req.pth = pth;
+    req.flgs = flgs;
+    req.mde = mde;
+}
+
+
+void async_io_engine::stat(
+        int dir_fd,
+        const char* pth,
+        int flgs,
+        file_status* stts,
+        callback_type cb
+)
+{
+    request& req = add_request(request_types::STAT, dir_fd, std::move(cb));
+    
+    req.pth = pth;
+    req.flgs = flgs;
+    req.stts = stts;
+}
+
+
+void async_io_engine::sync(int fd, bool dat_only, callback_type cb)
+{
+    add_request(dat_only ? request_types::DATA_SYNC : request_types::SYNC, fd, std::move(cb));
+}
+
+
+void async_io_engine::close(int fd, callback_type cb)
+{
+    add_request(request_types::CLOSE, fd, std::move(cb));
+}
+
+
+bool async_io_engine::register_buffers(
+        const std::vector<std::pair<void*, std::size_t>>& bfrs,
+        std::error_code* err_code
+)
+{
+    std::vector<registered_buffer> rgstrd_bfrs;
+    
+    if (nbr_in_flght_ > 0)
+    {
+        assign_system_error_code(EBUSY, err_code);
+        return false;
+    }
+    
+    rgstrd_bfrs.reserve(bfrs.size());
+    for (std::size_t i = 0; i < bfrs.size(); ++i)
+    {
+        rgstrd_bfrs.push_back({reinterpret_cast<std::uintptr_t>(bfrs[i].first), bfrs[i].second,
+                               static_cast<std::uint32_t>(i)});
+    }
+    
+    std::sort(rgstrd_bfrs.begin(), rgstrd_bfrs.end(),
+              [](const registered_buffer& lhs, const registered_buffer& rhs)
+    {
+        return lhs.addr < rhs.addr;
+    });
+
+#ifdef __linux__
+    if (bcknd_ == async_io_backends::IO_RING)
+    {
+        std::vector<struct ::iovec> iovs(bfrs.size());
+        
+        for (std::size_t i = 0; i < bfrs.size(); ++i)
+        {
+            iovs[i].iov_base = bfrs[i].first;
+            iovs[i].iov_len = bfrs[i].second;
+        }
+        
+        if (!bfrs_.empty())
+        {
+            __hidden_io::__io_uring_register(rng_.fd, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            bfrs_.clear();
+        }
+        
+        if (!iovs.empty() &&
+            __hidden_io::__io_uring_register(rng_.fd, IORING_REGISTER_BUFFERS, iovs.data(),
+                                             static_cast<unsigned int>(iovs.size())) == -1)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+#endif
+
+    bfrs_ = std::move(rgstrd_bfrs);
+    
+    return true;
+}
+
+
+bool async_io_engine::register_files(const std::vector<int>& fds, std::error_code* err_code)
+{
+    std::vector<int> fxd_fls;
+    
+    if (nbr_in_flght_ > 0)
+    {
+        assign_system_error_code(EBUSY, err_code);
+        return false;
+    }
+    
+    for (std::size_t i = 0; i < fds.size(); ++i)
+    {
+        if (fds[i] < 0)
+        {
+            assign_system_error_code(EBADF, err_code);
+            return false;
+        }
+        
+        if (static_cast<std::size_t>(fds[i]) >= fxd_fls.size())
+        {
+            fxd_fls.resize(static_cast<std::size_t>(fds[i]) + 1, -1);
+        }
+        
+        fxd_fls[fds[i]] = static_cast<int>(i);
+    }
+
+#ifdef __linux__
+    if (bcknd_ == async_io_backends::IO_RING)
+    {
+        if (!fxd_fls_.empty())
+        {
+            __hidden_io::__io_uring_register(rng_.fd, IORING_UNREGISTER_FILES, nullptr, 0);
+            fxd_fls_.clear();
+        }
+        
+        if (!fds.empty() &&
+            __hidden_io::__io_uring_register(rng_.fd, IORING_REGISTER_FILES, fds.data(),
+                                             static_cast<unsigned int>(fds.size())) == -1)
+        {
+            assign_system_error_code(errno, err_code);
+            return false;
+        }
+    }
+#endif
+
+    fxd_fls_ = std::move(fxd_fls);
+    
+    return true;
+}
+
+
+std::size_t async_io_engine::submit(std::error_code* err_code)
+{
+    const std::size_t nbr_sbmtd = bcknd_ == async_io_backends::IO_RING ? submit_to_ring(err_code)
+                                                                        : submit_to_pool();
+    
+    if (nxt_pndng_ == pndng_.size())
+    {
+        pndng_.clear();
+        nxt_pndng_ = 0;
+    }
+    else if (nxt_pndng_ > pndng_.size() / 2)
+    {
+        pndng_.erase(pndng_.begin(), pndng_.begin() + static_cast<std::ptrdiff_t>(nxt_pndng_));
+        nxt_pndng_ = 0;
+    }
+    
+    return nbr_sbmtd;
+}
+
+
+std::size_t async_io_engine::poll(std::error_code* err_code)
+{
+    std::size_t nbr_cmpltd;
+    
+    submit(err_code);
+    nbr_cmpltd = bcknd_ == async_io_backends::IO_RING ? reap_ring() : reap_pool(false);
+    if (nbr_cmpltd > 0)
+    {
+        submit(err_code);
+    }
+    
+    return nbr_cmpltd;
+}
+
+
+std::size_t async_io_engine::wait(std::error_code* err_code)
+{
+    std::size_t nbr_cmpltd;
+    
+    if (size() == 0)
+    {
+        return 0;
+    }
+    
+    submit(err_code);
+    if (bcknd_ == async_io_backends::IO_RING)
+    {
+        nbr_cmpltd = reap_ring();
+        while (nbr_cmpltd == 0 && nbr_in_flght_ > 0)
+        {
+            if (!wait_ring(err_code))
+            {
+                return 0;
+            }
+            
+            nbr_cmpltd = reap_ring();
+        }
+    }
+    else
+    {
+        nbr_cmpltd = nbr_in_flght_ > 0 ? reap_pool(true) : 0;
+    }
+    
+    submit(err_code);
+    
+    return nbr_cmpltd;
+}
+
+
+bool async_io_engine::wait_all(std::error_code* err_code)
+{
+    std::error_code lcl_err_code;
+    
+    while (size() > 0)
+    {
+        if (wait(&lcl_err_code) == 0 && lcl_err_code)
+        {
+            if (err_code != nullptr)
+            {
+                *err_code = lcl_err_code;
+            }
+            
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+
+int async_io_engine::get_file_descriptor(std::error_code* err_code)
+{
+    int fd = ntfr_fd_.load(std::memory_order_acquire);
+    
+    if (fd != -1)
+    {
+        return fd;
+    }
+    
+    if (!create_event_notifier(&fd, err_code))
+    {
+        return -1;
+    }
+
+#ifdef __linux__
+    if (bcknd_ == async_io_backends::IO_RING &&
+        __hidden_io::__io_uring_register(rng_.fd, IORING_REGISTER_EVENTFD, &fd, 1) == -1)
+    {
+        assign_system_error_code(errno, err_code);
+        close_event_descriptor(fd);
+        
+        return -1;
+    }
+#endif
+
+    ntfr_fd_.store(fd, std::memory_order_release);
+    
+    return fd;
+}
+
+
+async_io_engine::request& async_io_engine::add_request(
+        request_types typ,
+        int fd,
+        callback_type&& cb
+)
+{
+    const std::uint32_t idx = free_idxs_.empty() ? static_cast<std::uint32_t>(reqs_.size())
+                                                 : free_idxs_.back();
+    
+    if (idx == reqs_.size())
+    {
+        reqs_.emplace_back();
+        reqs_.back().idx = idx;
+        if (free_idxs_.capacity() < reqs_.size())
+        {
+            free_idxs_.reserve(2 * reqs_.size());
+        }
+    }
+    else
+    {
+        free_idxs_.pop_back();
+    }
+    
+    request& req = reqs_[idx];
+    
+    req.cb = std::move(cb);
+    req.typ = typ;
+    req.fd = fd;
+    req.res = 0;
+    pndng_.push_back(idx);
+    
+    return req;
+}
+
+
+void async_io_engine::complete(std::uint32_t idx)
+{
+    request& req = reqs_[idx];
+    const std::int64_t res = req.res;
+    callback_type cb = std::move(req.cb);
+
+#ifdef __linux__
+    if (req.typ == request_types::STAT && res == 0 && req.stts != nullptr)
+    {
+        const auto* stx = reinterpret_cast<const struct ::statx*>(req.stx_bfr);
+        
+        req.stts->sz = stx->stx_size;
+        req.stts->ino = stx->stx_ino;
+        req.stts->nbr_lnks = stx->stx_nlink;
+        req.stts->mod_tme = time_specification(static_cast<std::uint64_t>(stx->stx_mtime.tv_sec),
+                                               stx->stx_mtime.tv_nsec);
+        req.stts->mde = stx->stx_mode;
+        req.stts->uid = stx->stx_uid;
+        req.stts->gid = stx->stx_gid;
+    }
+#endif
+
+    req.cb = nullptr;
+    req.stts = nullptr;
+    free_idxs_.push_back(idx);
+    --nbr_in_flght_;
+    
+    if (cb)
+    {
+        cb(res);
+    }
+}
+
+
+bool async_io_engine::setup_ring(std::uint32_t nbr_entrs) noexcept
+{
+#ifdef __linux__
+    struct ::io_uring_params prms;
+    alignas(struct ::io_uring_probe) unsigned char prb_bfr[
+            sizeof(struct ::io_uring_probe) + 256 * sizeof(struct ::io_uring_probe_op)] = {};
+    auto* prb = reinterpret_cast<struct ::io_uring_probe*>(prb_bfr);
+    char* sq_ptr;
+    char* cq_ptr;
+    
+    std::memset(&prms, 0, sizeof(prms));
+    rng_.fd = __hidden_io::__io_uring_setup(nbr_entrs, &prms);
+    if (rng_.fd == -1)
+    {
+        return false;
+    }
+    
+    rng_.sq_sz = prms.sq_off.array + prms.sq_entries * sizeof(std::uint32_t);
+    rng_.cq_sz = prms.cq_off.cqes + prms.cq_entries * sizeof(struct ::io_uring_cqe);
+    if ((prms.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        rng_.sq_sz = rng_.cq_sz = std::max(rng_.sq_sz, rng_.cq_sz);
+    }
+    
+    rng_.sq_ptr = ::mmap(nullptr, rng_.sq_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         rng_.fd, IORING_OFF_SQ_RING);
+    if (rng_.sq_ptr == MAP_FAILED)
+    {
+        rng_.sq_ptr = nullptr;
+        teardown_ring();
+        return false;
+    }
+    
+    if ((prms.features & IORING_FEAT_SINGLE_MMAP) != 0)
+    {
+        rng_.cq_ptr = rng_.sq_ptr;
+    }
+    else
+    {
+        rng_.cq_ptr = ::mmap(nullptr, rng_.cq_sz, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, rng_.fd, IORING_OFF_CQ_RING);
+        if (rng_.cq_ptr == MAP_FAILED)
+        {
+            rng_.cq_ptr = nullptr;
+            teardown_ring();
+            return false;
+        }
+    }
+    
+    rng_.sqes_sz = prms.sq_entries * sizeof(struct ::io_uring_sqe);
+    rng_.sqes = ::mmap(nullptr, rng_.sqes_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       rng_.fd, IORING_OFF_SQES);
+    if (rng_.sqes == MAP_FAILED)
+    {
+        rng_.sqes = nullptr;
+        teardown_ring();
+        return false;
+    }
+    
+    sq_ptr = static_cast<char*>(rng_.sq_ptr);
+    cq_ptr = static_cast<char*>(rng_.cq_ptr);
+    rng_.sq_hd = reinterpret_cast<std::atomic<std::uint32_t>*>(sq_ptr + prms.sq_off.head);
+    rng_.sq_tl = reinterpret_cast<std::atomic<std::uint32_t>*>(sq_ptr + prms.sq_off.tail);
+    rng_.sq_arr = reinterpret_cast<std::uint32_t*>(sq_ptr + prms.sq_off.array);
+    rng_.sq_msk = *reinterpret_cast<std::uint32_t*>(sq_ptr + prms.sq_off.ring_mask);
+    rng_.sq_entrs = prms.sq_entries;
+    rng_.cq_hd = reinterpret_cast<std::atomic<std::uint32_t>*>(cq_ptr + prms.cq_off.head);
+    rng_.cq_tl = reinterpret_cast<std::atomic<std::uint32_t>*>(cq_ptr + prms.cq_off.tail);
+    rng_.cqes = cq_ptr + prms.cq_off.cqes;
+    rng_.cq_msk = *reinterpret_cast<std::uint32_t*>(cq_ptr + prms.cq_off.ring_mask);
+    rng_.cq_entrs = prms.cq_entries;
+    
+    if (__hidden_io::__io_uring_register(rng_.fd, IORING_REGISTER_PROBE, prb, 256) == -1)
+    {
+        teardown_ring();
+        return false;
+    }
+    
+    for (const auto& x : __hidden_io::REQUIRED_OPERATIONS)
+    {
+        if (x >= prb->ops_len || (prb->ops[x].flags & IO_URING_OP_SUPPORTED) == 0)
+        {
+            teardown_ring();
+            return false;
+        }
+    }
+    
+    return true;
+#else
+    (void)nbr_entrs;
+    
+    return false;
+#endif
+}
+
+
+void async_io_engine::teardown_ring() noexcept
+{
+#ifdef __linux__
+    if (rng_.sqes != nullptr)
+    {
+        ::munmap(rng_.sqes, rng_.sqes_sz);
+    }
+    
+    if (rng_.cq_ptr != nullptr && rng_.cq_ptr != rng_.sq_ptr)
+    {
+        ::munmap(rng_.cq_ptr, rng_.cq_sz);
+    }
+    
+    if (rng_.sq_ptr != nullptr)
+    {
+        ::munmap(rng_.sq_ptr, rng_.sq_sz);
+    }
+    
+    if (rng_.fd != -1)
+    {
+        ::close(rng_.fd);
+    }
+#endif
+
+    rng_ = io_ring();
+}
+
+
+std::size_t async_io_engine::submit_to_ring(std::error_code* err_code)
+{
+#ifdef __linux__
+    auto* sqes = static_cast<struct ::io_uring_sqe*>(rng_.sqes);
+    const std::size_t max_in_flght = std::min(queue_dpth_,
+                                              static_cast<std::size_t>(rng_.cq_entrs));
+    const std::uint32_t hd = rng_.sq_hd->load(std::memory_order_acquire);
+    std::uint32_t tl = rng_.sq_tl->load(std::memory_order_relaxed);
+    std::uint32_t nbr_unsbmtd;
+    std::size_t nbr_sbmtd = 0;
+    int res;
+    
+    while (nxt_pndng_ < pndng_.size() && tl - hd < rng_.sq_entrs &&
+           nbr_in_flght_ < max_in_flght)
+    {
+        request& req = reqs_[pndng_[nxt_pndng_++]];
+        const std::uint32_t sq_idx = tl & rng_.sq_msk;
+        struct ::io_uring_sqe& sqe = sqes[sq_idx];
+        
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.fd = req.fd;
+        sqe.user_data = req.idx;
+        
+        if (req.typ == request_types::READ || req.typ == request_types::WRITE ||
+            req.typ == request_types::SYNC || req.typ == request_types::DATA_SYNC)
+        {
+            if (req.fd >= 0 && static_cast<std::size_t>(req.fd) < fxd_fls_.size() &&
+                fxd_fls_[req.fd] != -1)
+            {
+                sqe.fd = fxd_fls_[req.fd];
+                sqe.flags |= IOSQE_FIXED_FILE;
+            }
+        }
+        
+        switch (req.typ)
+        {
+            case request_types::READ:
+            case request_types::WRITE:
+            {
+                const auto addr = reinterpret_cast<std::uintptr_t>(req.bfr);
+                auto it = std::upper_bound(
+                        bfrs_.begin(), bfrs_.end(), addr,
+                        [](std::uintptr_t lhs, const registered_buffer& rhs)
+                {
+                    return lhs < rhs.addr;
+                });
+                
+                sqe.addr = addr;
+                sqe.len = static_cast<std::uint32_t>(req.sz);
+                sqe.off = req.off;
+                if (it != bfrs_.begin() && addr + req.sz <= (it - 1)->addr + (it - 1)->sz)
+                {
+                    sqe.opcode = req.typ == request_types::READ ? IORING_OP_READ_FIXED
+                                                                : IORING_OP_WRITE_FIXED;
+                    sqe.buf_index = static_cast<std::uint16_t>((it - 1)->idx);
+                }
+                else
+                {
+                    sqe.opcode = req.typ == request_types::READ ? IORING_OP_READ
+                                                                : IORING_OP_WRITE;
+                }
+                
+                break;
+            }
+            
+            case request_types::OPEN:
+                sqe.opcode = IORING_OP_OPENAT;
+                sqe.addr = reinterpret_cast<std::uintptr_t>(req.pth.c_str());
+                sqe.len = req.mde;
+                sqe.open_flags = static_cast<std::uint32_t>(req.flgs);
+                break;
+            
+            case request_types::STAT:
+                sqe.opcode = IORING_OP_STATX;
+                sqe.addr = reinterpret_cast<std::uintptr_t>(req.pth.c_str());
+                sqe.len = STATX_BASIC_STATS;
+                sqe.off = reinterpret_cast<std::uintptr_t>(req.stx_bfr);
+                sqe.statx_flags = static_cast<std::uint32_t>(req.flgs);
+                break;
+            
+            case request_types::SYNC:
+            case request_types::DATA_SYNC:
+                sqe.opcode = IORING_OP_FSYNC;
+                sqe.fsync_flags = req.typ == request_types::DATA_SYNC ? IORING_FSYNC_DATASYNC : 0;
+                break;
+            
+            case request_types::CLOSE:
+                sqe.opcode = IORING_OP_CLOSE;
+                break;
+        }
+        
+        rng_.sq_arr[sq_idx] = sq_idx;
+        ++tl;
+        ++nbr_sbmtd;
+        ++nbr_in_flght_;
+    }
+    
+    rng_.sq_tl->store(tl, std::memory_order_release);
+    
+    nbr_unsbmtd = tl - rng_.sq_hd->load(std::memory_order_acquire);
+    while (nbr_unsbmtd > 0)
+    {
+        res = __hidden_io::__io_uring_enter(rng_.fd, nbr_unsbmtd, 0, 0);
+        if (res == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            
+            if (errno != EAGAIN && errno != EBUSY)
+            {
+                assign_system_error_code(errno, err_code);
+            }
+            
+            break;
+        }
+        
+        if (res == 0)
+        {
+            break;
+        }
+        
+        nbr_unsbmtd -= static_cast<std::uint32_t>(res);
+    }
+    
+    return nbr_sbmtd;
+#else
+    (void)err_code;
+    
+    return 0;
+#endif
+}
+
+
+std::size_t async_io_engine::reap_ring()
+{
+#ifdef __linux__
+    const auto* cqes = static_cast<const struct ::io_uring_cqe*>(rng_.cqes);
+    std::uint32_t hd = rng_.cq_hd->load(std::memory_order_relaxed);
+    std::size_t nbr_cmpltd = 0;
+    std::uint32_t idx;
+    
+    while (hd != rng_.cq_tl->load(std::memory_order_acquire))
+    {
+        const struct ::io_uring_cqe& cqe = cqes[hd & rng_.cq_msk];
+        
+        idx = static_cast<std::uint32_t>(cqe.user_data);
+        reqs_[idx].res = cqe.res;
+        rng_.cq_hd->store(++hd, std::memory_order_release);
+        
+        complete(idx);
+        ++nbr_cmpltd;
+    }
+    
+    return nbr_cmpltd;
+#else
+    return 0;
+#endif
+}
+
+
+bool async_io_engine::wait_ring(std::error_code* err_code) noexcept
+{
+#ifdef __linux__
+    if (__hidden_io::__io_uring_enter(rng_.fd, 0, 1, IORING_ENTER_GETEVENTS) == -1 &&
+        errno != EINTR)
+    {
+        assign_system_error_code(errno, err_code);
+        return false;
+    }
+    
+    return true;
+#else
+    assign_system_error_code(ENOSYS, err_code);
+    
+    return false;
+#endif
+}
+
+
+std::size_t async_io_engine::submit_to_pool()
+{
+    std::size_t nbr_sbmtd = 0;
+    
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        
+        while (nxt_pndng_ < pndng_.size() && nbr_in_flght_ < queue_dpth_)
+        {
+            pl_reqs_.push_back(&reqs_[pndng_[nxt_pndng_]]);
+            ++nxt_pndng_;
+            ++nbr_sbmtd;
+            ++nbr_in_flght_;
+        }
+    }
+    
+    if (nbr_sbmtd == 1)
+    {
+        wrk_cv_.notify_one();
+    }
+    else if (nbr_sbmtd > 1)
+    {
+        wrk_cv_.notify_all();
+    }
+    
+    return nbr_sbmtd;
+}
+
+
+std::size_t async_io_engine::reap_pool(bool blck)
+{
+    std::size_t nbr_cmpltd;
+    std::size_t i = 0;
+    
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        if (blck)
+        {
+            cmpl_cv_.wait(lck, [this] { return !cmpls_.empty(); });
+        }
+        
+        rpd_.swap(cmpls_);
+    }
+    
+    try
+    {
+        for (; i < rpd_.size(); ++i)
+        {
+            complete(rpd_[i]);
+        }
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lck(mtx_);
+        
+        cmpls_.insert(cmpls_.begin(), rpd_.begin() + static_cast<std::ptrdiff_t>(i) + 1,
+                      rpd_.end());
+        rpd_.clear();
+        
+        throw;
+    }
+    
+    nbr_cmpltd = rpd_.size();
+    rpd_.clear();
+    
+    return nbr_cmpltd;
+}
+
+
+void async_io_engine::work()
+{
+    request* req;
+    bool was_empty;
+    int fd;
+    
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lck(mtx_);
+            
+            wrk_cv_.wait(lck, [this] { return stop_ || !pl_reqs_.empty(); });
+            if (pl_reqs_.empty())
+            {
+                return;
+            }
+            
+            req = pl_reqs_.front();
+            pl_reqs_.pop_front();
+        }
+        
+        run_request(*req);
+        
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            
+            was_empty = cmpls_.empty();
+            cmpls_.push_back(req->idx);
+        }
+        
+        cmpl_cv_.notify_one();
+        fd = ntfr_fd_.load(std::memory_order_acquire);
+        if (was_empty && fd != -1)
+        {
+            notify_event_notifier(fd);
+        }
+    }
+}
+
+
+void async_io_engine::run_request(request& req) noexcept
+{
+    std::int64_t res = -1;
+    
+    do
+    {
+        switch (req.typ)
+        {
+            case request_types::READ:
+                res = ::pread(req.fd, req.bfr, req.sz, static_cast<off_t>(req.off));
+                break;
+            
+            case request_types::WRITE:
+                res = ::pwrite(req.fd, req.bfr, req.sz, static_cast<off_t>(req.off));
+                break;
+            
+            case request_types::OPEN:
+                res = ::openat(req.fd, req.pth.c_str(), req.flgs, req.mde);
+                break;
+            
+            case request_types::STAT:
+#ifdef __linux__
+                res = ::statx(req.fd, req.pth.c_str(), req.flgs, STATX_BASIC_STATS,
+                              reinterpret_cast<struct ::statx*>(req.stx_bfr));
+#else
+                errno = ENOSYS;
+#endif
+                break;
+            
+            case request_types::SYNC:
+                res = ::fsync(req.fd);
+                break;
+            
+            case request_types::DATA_SYNC:
+                res = ::fdatasync(req.fd);
+                break;
+            
+            case request_types::CLOSE:
+                res = ::close(req.fd);
+                if (res == -1 && errno == EINTR)
+                {
+                    res = 0;
+                }
+                
+                break;
+        }
+    } while (res == -1 && errno == EINTR);
+    
+    req.res = res == -1 ? -errno : res;
+}
+
+
+}
+}
@@ -0,0 +1,515 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/io/async_io_engine.hpp
+ * @brief       async_io_engine class header.
+ * @author      Killian
+ * @date        2018/10/05 - 10:14
+ */
+
+#ifndef SPEED_SYSTEM_IO_ASYNC_IO_ENGINE_HPP
+#define SPEED_SYSTEM_IO_ASYNC_IO_ENGINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../types.hpp"
+#include "async_io_backends.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents an asynchronous I/O engine, that reads, writes, opens,
+ *              stats, syncs and closes files without blocking the calling thread. The requests
+ *              are queued and submitted in batches, by submit or by the functions that wait for
+ *              completions. With the I/O ring backend a batch costs a single system call, the
+ *              completions are reaped from shared memory, and the buffers and files registered
+ *              in the engine are used without being mapped and looked up on each request. When
+ *              the kernel has no I/O ring, a pool of threads runs the blocking system calls
+ *              instead, with the same interface. The callbacks are called by the thread that
+ *              polls or waits for completions: they can queue requests, but must not poll or
+ *              wait. An engine has to be used by a single thread.
+ */
+class async_io_engine
+{
+public:
+    /** The type of the callbacks, that receive the result of the requests: the number of bytes
+     *  read or written, the file descriptor opened or 0, and the negated error number if the
+     *  request failed. */
+    using callback_type = std::function<void(std::int64_t)>;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       queue_dpth : The maximum number of requests in flight.
+     * @param       bcknd : The backend to use.
+     * @param       nbr_thrds : The number of threads of the thread pool backend.
+     * @throw       speed::system::system_exception : If the backend can not be created.
+     */
+    explicit async_io_engine(
+            std::uint32_t queue_dpth = 128,
+            async_io_backends bcknd = async_io_backends::AUTO,
+            std::size_t nbr_thrds = 4
+    );
+    
+    /** @cond */
+    async_io_engine(const async_io_engine&) = delete;
+    
+    async_io_engine& operator =(const async_io_engine&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor. It waits for the requests in flight without calling their
+     *              callbacks, and drops the requests not submitted.
+     */
+    ~async_io_engine() noexcept;
+    
+    /**
+     * @brief       Queue a read at an offset of a file.
+     * @param       fd : The file descriptor.
+     * @param       bfr : The buffer in which store the bytes read. It has to stay valid until the
+     *              request completes.
+     * @param       sz : The number of bytes to read.
+     * @param       off : The offset in the file.
+     * @param       cb : The callback.
+     */
+    void read(int fd, void* bfr, std::size_t sz, std::uint64_t off, callback_type cb);
+    
+    /**
+     * @brief       Queue a write at an offset of a file.
+     * @param       fd : The file descriptor.
+     * @param       bfr : The bytes to write. They have to stay valid until the request completes.
+     * @param       sz : The number of bytes to write.
+     * @param       off : The offset in the file.
+     * @param       cb : The callback.
+     */
+    void write(int fd, const void* bfr, std::size_t sz, std::uint64_t off, callback_type cb);
+    
+    /**
+     * @brief       Queue an open of a file, like openat.
+     * @param       dir_fd : The file descriptor of the directory relative to which the path is
+     *              resolved, or AT_FDCWD.
+     * @param       pth : The path of the file.
+     * @param       flgs : The open flags.
+     * @param       mde : The permissions of the file if it is created.
+     * @param       cb : The callback, that receives the file descriptor opened.
+     */
+    void open(int dir_fd, const char* pth, int flgs, std::uint32_t mde, callback_type cb);
+    
+    /**
+     * @brief       Queue a stat of a file, like statx.
+     * @param       dir_fd : The file descriptor of the directory relative to which the path is
+     *              resolved, or AT_FDCWD.
+     * @param       pth : The path of the file.
+     * @param       flgs : The statx flags, like AT_SYMLINK_NOFOLLOW.
+     * @param       stts : The value in which store the status of the file. It has to stay valid
+     *              until the request completes.
+     * @param       cb : The callback.
+     */
+    void stat(int dir_fd, const char* pth, int flgs, file_status* stts, callback_type cb);
+    
+    /**
+     * @brief       Queue a flush of a file to its storage device.
+     * @param       fd : The file descriptor.
+     * @param       dat_only : Whether only the data and the metadata needed to read it are
+     *              flushed, like fdatasync.
+     * @param       cb : The callback.
+     */
+    void sync(int fd, bool dat_only, callback_type cb);
+    
+    /**
+     * @brief       Queue a close of a file.
+     * @param       fd : The file descriptor, that must not be registered.
+     * @param       cb : The callback.
+     */
+    void close(int fd, callback_type cb);
+    
+    /**
+     * @brief       Register buffers, replacing the ones registered before. The reads and writes
+     *              whose buffer lies in a registered one use it without mapping it each time. No
+     *              request has to be in flight.
+     * @param       bfrs : The buffers, as addresses and sizes.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool register_buffers(
+            const std::vector<std::pair<void*, std::size_t>>& bfrs,
+            std::error_code* err_code = nullptr
+    );
+    
+    /**
+     * @brief       Register files, replacing the ones registered before. The requests on a
+     *              registered file use it without looking it up each time. No request has to be
+     *              in flight.
+     * @param       fds : The file descriptors.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool register_files(const std::vector<int>& fds, std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Submit the queued requests, as many as the queue depth allows.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of requests submitted.
+     */
+    std::size_t submit(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Submit the queued requests and call the callbacks of the completed ones,
+     *              without blocking.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of callbacks called.
+     */
+    std::size_t poll(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Submit the queued requests and block until at least one completes, if any is
+     *              pending, then call the callbacks of the completed ones.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of callbacks called.
+     */
+    std::size_t wait(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Wait until all the requests, those queued by the callbacks included, have
+     *              completed.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool wait_all(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Get a file descriptor that becomes readable when requests complete, so that an
+     *              event loop can call poll. It is created on the first call.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The file descriptor, or -1 if it can not be created.
+     */
+    int get_file_descriptor(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Get the backend used.
+     * @return      The backend used, that is not AUTO.
+     */
+    [[nodiscard]] inline async_io_backends get_backend() const noexcept
+    {
+        return bcknd_;
+    }
+    
+    /**
+     * @brief       Get the number of requests not completed yet, queued or in flight.
+     * @return      The number of requests not completed yet.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return pndng_.size() - nxt_pndng_ + nbr_in_flght_;
+    }
+
+private:
+    /**
+     * @brief       Represents the types of the requests.
+     */
+    enum class request_types : std::uint8_t
+    {
+        /** Read. */
+        READ,
+        
+        /** Write. */
+        WRITE,
+        
+        /** Open. */
+        OPEN,
+        
+        /** Stat. */
+        STAT,
+        
+        /** Flush of the data and the metadata. */
+        SYNC,
+        
+        /** Flush of the data only. */
+        DATA_SYNC,
+        
+        /** Close. */
+        CLOSE
+    };
+    
+    /**
+     * @brief       Represents a request.
+     */
+    struct request
+    {
+        /** The buffer in which the kernel stores the status of a file. */
+        alignas(8) unsigned char stx_bfr[256];
+        
+        /** The callback. */
+        callback_type cb;
+        
+        /** The path. */
+        std::string pth;
+        
+        /** The buffer. */
+        void* bfr = nullptr;
+        
+        /** The value in which store the status of a file. */
+        file_status* stts = nullptr;
+        
+        /** The size of the buffer. */
+        std::uint64_t sz = 0;
+        
+        /** The offset in the file. */
+        std::uint64_t off = 0;
+        
+        /** The result. */
+        std::int64_t res = 0;
+        
+        /** The file descriptor. */
+        int fd = -1;
+        
+        /** The flags. */
+        int flgs = 0;
+        
+        /** The permissions of a file created. */
+        std::uint32_t mde = 0;
+        
+        /** The index of the request. */
+        std::uint32_t idx = 0;
+        
+        /** The type. */
+        request_types typ = request_types::READ;
+    };
+    
+    /**
+     * @brief       Represents a registered buffer.
+     */
+    struct registered_buffer
+    {
+        /** The address of the buffer. */
+        std::uintptr_t addr;
+        
+        /** The size of the buffer. */
+        std::size_t sz;
+        
+        /** The index of the buffer in the registration. */
+        std::uint32_t idx;
+    };
+    
+    /**
+     * @brief       Represents the memory shared with the kernel by an I/O ring.
+     */
+    struct io_ring
+    {
+        /** The submission ring. */
+        void* sq_ptr = nullptr;
+        
+        /** The completion ring, that can be the submission ring. */
+        void* cq_ptr = nullptr;
+        
+        /** The submission entries. */
+        void* sqes = nullptr;
+        
+        /** The completion entries. */
+        void* cqes = nullptr;
+        
+        /** The head of the submission ring, moved by the kernel. */
+        std::atomic<std::uint32_t>* sq_hd = nullptr;
+        
+        /** The tail of the submission ring, moved by the engine. */
+        std::atomic<std::uint32_t>* sq_tl = nullptr;
+        
+        /** The head of the completion ring, moved by the engine. */
+        std::atomic<std::uint32_t>* cq_hd = nullptr;
+        
+        /** The tail of the completion ring, moved by the kernel. */
+        std::atomic<std::uint32_t>* cq_tl = nullptr;
+        
+        /** The indexes of the submission entries in the submission ring. */
+        std::uint32_t* sq_arr = nullptr;
+        
+        /** The size of the mapping of the submission ring. */
+        std::size_t sq_sz = 0;
+        
+        /** The size of the mapping of the completion ring. */
+        std::size_t cq_sz = 0;
+        
+        /** The size of the mapping of the submission entries. */
+        std::size_t sqes_sz = 0;
+        
+        /** The mask of the indexes of the submission ring. */
+        std::uint32_t sq_msk = 0;
+        
+        /** The mask of the indexes of the completion ring. */
+        std::uint32_t cq_msk = 0;
+        
+        /** The number of entries of the submission ring. */
+        std::uint32_t sq_entrs = 0;
+        
+        /** The number of entries of the completion ring. */
+        std::uint32_t cq_entrs = 0;
+        
+        /** The file descriptor of the ring. */
+        int fd = -1;
+    };
+    
+    /**
+     * @brief       Queue a request.
+     * @param       typ : The type of the request.
+     * @param       fd : The file descriptor.
+     * @param       cb : The callback.
+     * @return      The request.
+     */
+    request& add_request(request_types typ, int fd, callback_type&& cb);
+    
+    /**
+     * @brief       Release a completed request and call its callback.
+     * @param       idx : The index of the request.
+     */
+    void complete(std::uint32_t idx);
+    
+    /**
+     * @brief       Create the I/O ring and check that it supports all the requests.
+     * @param       nbr_entrs : The number of entries of the submission ring.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool setup_ring(std::uint32_t nbr_entrs) noexcept;
+    
+    /**
+     * @brief       Unmap and close the I/O ring.
+     */
+    void teardown_ring() noexcept;
+    
+    /**
+     * @brief       Submit the queued requests to the I/O ring.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of requests submitted.
+     */
+    std::size_t submit_to_ring(std::error_code* err_code);
+    
+    /**
+     * @brief       Call the callbacks of the requests completed in the I/O ring.
+     * @return      The number of callbacks called.
+     */
+    std::size_t reap_ring();
+    
+    /**
+     * @brief       Block until a request of the I/O ring completes.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool wait_ring(std::error_code* err_code) noexcept;
+    
+    /**
+     * @brief       Submit the queued requests to the thread pool.
+     * @return      The number of requests submitted.
+     */
+    std::size_t submit_to_pool();
+    
+    /**
+     * @brief       Call the callbacks of the requests completed by the thread pool.
+     * @param       blck : Whether to block until a request completes.
+     * @return      The number of callbacks called.
+     */
+    std::size_t reap_pool(bool blck);
+    
+    /**
+     * @brief       Run the requests submitted to the thread pool, until the engine is destroyed.
+     */
+    void work();
+    
+    /**
+     * @brief       Run a request with a blocking system call.
+     * @param       req : The request.
+     */
+    static void run_request(request& req) noexcept;
+    
+    /** The requests, indexed by request index. */
+    std::deque<request> reqs_;
+    
+    /** The indexes of the free requests. */
+    std::vector<std::uint32_t> free_idxs_;
+    
+    /** The indexes of the queued requests. */
+    std::vector<std::uint32_t> pndng_;
+    
+    /** The registered buffers, sorted by address. */
+    std::vector<registered_buffer> bfrs_;
+    
+    /** The indexes of the registered files, indexed by file descriptor, -1 if not registered. */
+    std::vector<int> fxd_fls_;
+    
+    /** The I/O ring. */
+    io_ring rng_;
+    
+    /** The threads of the thread pool. */
+    std::vector<std::thread> thrds_;
+    
+    /** The requests submitted to the thread pool. */
+    std::deque<request*> pl_reqs_;
+    
+    /** The indexes of the requests completed by the thread pool. */
+    std::vector<std::uint32_t> cmpls_;
+    
+    /** The indexes of the requests completed being reaped. */
+    std::vector<std::uint32_t> rpd_;
+    
+    /** Mutex that protects the queues of the thread pool. */
+    std::mutex mtx_;
+    
+    /** Condition variable notified when requests are submitted to the thread pool. */
+    std::condition_variable wrk_cv_;
+    
+    /** Condition variable notified when the thread pool completes a request. */
+    std::condition_variable cmpl_cv_;
+    
+    /** The index of the first queued request not submitted. */
+    std::size_t nxt_pndng_;
+    
+    /** The number of requests in flight. */
+    std::size_t nbr_in_flght_;
+    
+    /** The maximum number of requests in flight. */
+    std::size_t queue_dpth_;
+    
+    /** The file descriptor of the completion notifier, or -1 if it is not created. */
+    std::atomic<int> ntfr_fd_;
+    
+    /** The backend used. */
+    async_io_backends bcknd_;
+    
+    /** Whether the threads of the thread pool have to stop. */
+    bool stop_;
+};
+
+
+}
+}
+
+
+#endif
@@ -0,0 +1,141 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/adaptive_mutex.hpp
+ * @brief       adaptive_mutex class header.
+ * @author      Killian
+ * @date        2018/10/01 - 10:02
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_ADAPTIVE_MUTEX_HPP
+#define SPEED_SYSTEM_SYNC_ADAPTIVE_MUTEX_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a mutex that spins for a while before sleeping on a futex.
+ *              The state word tells whether some thread sleeps, so unlocking an uncontended mutex
+ *              is a single atomic exchange without system call. It fits the critical sections
+ *              that are short compared to a context switch.
+ */
+class adaptive_mutex
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    adaptive_mutex() noexcept
+            : stte_(UNLOCKED)
+    {
+    }
+    
+    /** @cond */
+    adaptive_mutex(const adaptive_mutex&) = delete;
+    
+    adaptive_mutex& operator =(const adaptive_mutex&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Lock the mutex, waiting for it if needed.
+     */
+    void lock() noexcept
+    {
+        std::uint32_t stte = UNLOCKED;
+        
+        if (stte_.compare_exchange_strong(stte, LOCKED, std::memory_order_acquire,
+                                          std::memory_order_relaxed))
+        {
+            return;
+        }
+        
+        for (std::size_t i = 0; i < __hidden_system::__get_spin_count(); ++i)
+        {
+            if (stte == UNLOCKED &&
+                stte_.compare_exchange_weak(stte, LOCKED, std::memory_order_acquire,
+                                            std::memory_order_relaxed))
+            {
+                return;
+            }
+            
+            if (stte == CONTENDED)
+            {
+                break;
+            }
+            
+            __hidden_system::__cpu_relax();
+            stte = stte_.load(std::memory_order_relaxed);
+        }
+        
+        while (stte_.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED)
+        {
+            __hidden_system::__wait_while(&stte_, CONTENDED);
+        }
+    }
+    
+    /**
+     * @brief       Try to lock the mutex without waiting.
+     * @return      If the mutex has been locked true is returned, otherwise false is returned.
+     */
+    bool try_lock() noexcept
+    {
+        std::uint32_t stte = UNLOCKED;
+        
+        return stte_.compare_exchange_strong(stte, LOCKED, std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Unlock the mutex, waking a sleeping thread if any.
+     */
+    void unlock() noexcept
+    {
+        if (stte_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED)
+        {
+            futex_wake(&stte_, 1);
+        }
+    }
+
+private:
+    /** The state of the unlocked mutex. */
+    static constexpr std::uint32_t UNLOCKED = 0;
+    
+    /** The state of the mutex locked with no thread sleeping. */
+    static constexpr std::uint32_t LOCKED = 1;
+    
+    /** The state of the mutex locked with threads that may be sleeping. */
+    static constexpr std::uint32_t CONTENDED = 2;
+    
+    /** The state of the mutex. */
+    std::atomic<std::uint32_t> stte_;
+};
+
+}
+}
+
+
+#endif
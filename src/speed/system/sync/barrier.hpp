@@ -0,0 +1,121 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/barrier.hpp
+ * @brief       barrier class header.
+ * @author      Killian
+ * @date        2018/10/01 - 15:31
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_BARRIER_HPP
+#define SPEED_SYSTEM_SYNC_BARRIER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a reusable barrier: a fixed number of threads wait for each
+ *              other at every phase. The last thread to arrive starts the next phase and wakes the
+ *              others, that sleep on the phase number.
+ */
+class barrier
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_thrds : The number of threads that take part in every phase.
+     */
+    explicit barrier(std::uint32_t nbr_thrds) noexcept
+            : phs_(0)
+            , rmng_(nbr_thrds)
+            , nbr_thrds_(nbr_thrds)
+    {
+    }
+    
+    /** @cond */
+    barrier(const barrier&) = delete;
+    
+    barrier& operator =(const barrier&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Arrive at the barrier and wait for the other threads of the phase.
+     * @return      If the calling thread is the last one of the phase to arrive true is returned,
+     *              otherwise false is returned.
+     */
+    bool arrive_and_wait() noexcept
+    {
+        const std::uint32_t phs = phs_.load(std::memory_order_acquire);
+        
+        if (rmng_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            rmng_.store(nbr_thrds_, std::memory_order_relaxed);
+            phs_.fetch_add(1, std::memory_order_release);
+            futex_wake_all(&phs_);
+            
+            return true;
+        }
+        
+        for (std::size_t i = 0; i < __hidden_system::__get_spin_count() &&
+                                phs_.load(std::memory_order_relaxed) == phs; ++i)
+        {
+            __hidden_system::__cpu_relax();
+        }
+        
+        while (phs_.load(std::memory_order_acquire) == phs)
+        {
+            __hidden_system::__wait_while(&phs_, phs);
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Get the number of threads that take part in every phase.
+     * @return      The number of threads that take part in every phase.
+     */
+    [[nodiscard]] std::uint32_t get_number_of_threads() const noexcept
+    {
+        return nbr_thrds_;
+    }
+
+private:
+    /** The number of the current phase. */
+    std::atomic<std::uint32_t> phs_;
+    
+    /** The number of threads that have not arrived yet in the current phase. */
+    std::atomic<std::uint32_t> rmng_;
+    
+    /** The number of threads that take part in every phase. */
+    std::uint32_t nbr_thrds_;
+};
+
+}
+}
+
+
+#endif
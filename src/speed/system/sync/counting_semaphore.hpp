@@ -0,0 +1,160 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/counting_semaphore.hpp
+ * @brief       counting_semaphore class header.
+ * @author      Killian
+ * @date        2018/10/01 - 14:10
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_COUNTING_SEMAPHORE_HPP
+#define SPEED_SYSTEM_SYNC_COUNTING_SEMAPHORE_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a counting semaphore. The count is the futex word itself, and
+ *              releasing costs no system call when no thread sleeps.
+ */
+class counting_semaphore
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       cnt : The initial count.
+     */
+    explicit counting_semaphore(std::uint32_t cnt = 0) noexcept
+            : cnt_(cnt)
+            , nbr_slprs_(0)
+    {
+    }
+    
+    /** @cond */
+    counting_semaphore(const counting_semaphore&) = delete;
+    
+    counting_semaphore& operator =(const counting_semaphore&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Decrement the count, waiting for it to be greater than 0 if needed.
+     */
+    void acquire() noexcept
+    {
+        if (try_acquire_spinning())
+        {
+            return;
+        }
+        
+        nbr_slprs_.fetch_add(1, std::memory_order_seq_cst);
+        while (!try_acquire())
+        {
+            __hidden_system::__wait_while(&cnt_, 0);
+        }
+        
+        nbr_slprs_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Decrement the count if it is greater than 0, without waiting.
+     * @return      If the count has been decremented true is returned, otherwise false is
+     *              returned.
+     */
+    bool try_acquire() noexcept
+    {
+        std::uint32_t cnt = cnt_.load(std::memory_order_seq_cst);
+        
+        while (cnt != 0)
+        {
+            if (cnt_.compare_exchange_weak(cnt, cnt - 1, std::memory_order_seq_cst))
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Increment the count, waking as many sleeping threads.
+     * @param       nbr : The value to add to the count.
+     */
+    void release(std::uint32_t nbr = 1) noexcept
+    {
+        cnt_.fetch_add(nbr, std::memory_order_seq_cst);
+        if (nbr_slprs_.load(std::memory_order_seq_cst) != 0)
+        {
+            futex_wake(&cnt_, nbr);
+        }
+    }
+    
+    /**
+     * @brief       Get the count. It is only a hint when other threads use the semaphore.
+     * @return      The count.
+     */
+    [[nodiscard]] std::uint32_t get_count() const noexcept
+    {
+        return cnt_.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * @brief       Try to decrement the count for a while before giving up.
+     * @return      If the count has been decremented true is returned, otherwise false is
+     *              returned.
+     */
+    bool try_acquire_spinning() noexcept
+    {
+        if (try_acquire())
+        {
+            return true;
+        }
+        
+        for (std::size_t i = 0; i < __hidden_system::__get_spin_count(); ++i)
+        {
+            __hidden_system::__cpu_relax();
+            if (try_acquire())
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /** The count. */
+    std::atomic<std::uint32_t> cnt_;
+    
+    /** The number of threads that may be sleeping. */
+    std::atomic<std::uint32_t> nbr_slprs_;
+};
+
+}
+}
+
+
+#endif
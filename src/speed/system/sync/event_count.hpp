@@ -0,0 +1,183 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/event_count.hpp
+ * @brief       event_count class header.
+ * @author      Killian
+ * @date        2018/10/01 - 16:08
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_EVENT_COUNT_HPP
+#define SPEED_SYSTEM_SYNC_EVENT_COUNT_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+
+#ifndef __linux__
+#include <condition_variable>
+#include <mutex>
+#endif
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents an event count, that lets threads sleep until a condition
+ *              becomes true without a mutex and without missing a notification. A thread calls
+ *              prepare_wait, checks its condition, and then calls either cancel_wait if it is true
+ *              or wait otherwise. A thread that makes the condition true calls a notify function
+ *              afterwards, which costs no system call when no thread waits. The threads sleep on
+ *              a futex on Linux, and on a condition variable elsewhere.
+ */
+class event_count
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    event_count() noexcept
+            : epch_(0)
+            , nbr_wtrs_(0)
+#ifndef __linux__
+            , mtx_()
+            , cv_()
+#endif
+    {
+    }
+    
+    /** @cond */
+    event_count(const event_count&) = delete;
+    
+    event_count& operator =(const event_count&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Announce that the calling thread is about to wait.
+     * @return      The key to pass to wait.
+     */
+    std::uint32_t prepare_wait() noexcept
+    {
+        nbr_wtrs_.fetch_add(1, std::memory_order_seq_cst);
+        
+        return epch_.load(std::memory_order_seq_cst);
+    }
+    
+    /**
+     * @brief       Cancel a wait announced with prepare_wait.
+     */
+    void cancel_wait() noexcept
+    {
+        nbr_wtrs_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    
+    /**
+     * @brief       Sleep until a notification happens after prepare_wait.
+     * @param       ky : The key returned by prepare_wait.
+     */
+    void wait(std::uint32_t ky) noexcept
+    {
+#ifdef __linux__
+        while (epch_.load(std::memory_order_acquire) == ky)
+        {
+            __hidden_system::__wait_while(&epch_, ky);
+        }
+#else
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        cv_.wait(lck, [&] { return epch_.load(std::memory_order_acquire) != ky; });
+#endif
+        
+        nbr_wtrs_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    
+    /**
+     * @brief       Wake at most one waiting thread.
+     */
+    void notify_one() noexcept
+    {
+        notify(1);
+    }
+    
+    /**
+     * @brief       Wake all the waiting threads.
+     */
+    void notify_all() noexcept
+    {
+        notify(INT_MAX);
+    }
+
+private:
+    /**
+     * @brief       Wake waiting threads. Nothing is done when no thread waits.
+     * @param       nbr_thrds : The maximum number of threads to wake.
+     */
+    void notify(std::uint32_t nbr_thrds) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (nbr_wtrs_.load(std::memory_order_seq_cst) == 0)
+        {
+            return;
+        }
+
+#ifdef __linux__
+        epch_.fetch_add(1, std::memory_order_seq_cst);
+        futex_wake(&epch_, nbr_thrds);
+#else
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            epch_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        
+        if (nbr_thrds == 1)
+        {
+            cv_.notify_one();
+        }
+        else
+        {
+            cv_.notify_all();
+        }
+#endif
+    }
+    
+    /** The number of notifications. */
+    std::atomic<std::uint32_t> epch_;
+    
+    /** The number of threads between prepare_wait and the end of their wait. */
+    std::atomic<std::uint32_t> nbr_wtrs_;
+
+#ifndef __linux__
+    /** Mutex that protects the sleeps, when futexes are not available. */
+    std::mutex mtx_;
+    
+    /** Condition variable on which the threads sleep, when futexes are not available. */
+    std::condition_variable cv_;
+#endif
+};
+
+}
+}
+
+
+#endif
@@ -0,0 +1,121 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/latch.hpp
+ * @brief       latch class header.
+ * @author      Killian
+ * @date        2018/10/01 - 14:52
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_LATCH_HPP
+#define SPEED_SYSTEM_SYNC_LATCH_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a single use barrier: the threads wait until a counter,
+ *              decremented by any thread, reaches 0.
+ */
+class latch
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       cnt : The initial value of the counter.
+     */
+    explicit latch(std::uint32_t cnt) noexcept
+            : cnt_(cnt)
+    {
+    }
+    
+    /** @cond */
+    latch(const latch&) = delete;
+    
+    latch& operator =(const latch&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Decrement the counter without waiting, waking the waiting threads if it
+     *              reaches 0.
+     * @param       nbr : The value to subtract from the counter, not greater than it.
+     */
+    void count_down(std::uint32_t nbr = 1) noexcept
+    {
+        if (cnt_.fetch_sub(nbr, std::memory_order_acq_rel) == nbr)
+        {
+            futex_wake_all(&cnt_);
+        }
+    }
+    
+    /**
+     * @brief       Check whether the counter has reached 0.
+     * @return      If the counter has reached 0 true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] bool try_wait() const noexcept
+    {
+        return cnt_.load(std::memory_order_acquire) == 0;
+    }
+    
+    /**
+     * @brief       Wait for the counter to reach 0.
+     */
+    void wait() noexcept
+    {
+        std::uint32_t cnt;
+        
+        for (std::size_t i = 0; i < __hidden_system::__get_spin_count() && !try_wait(); ++i)
+        {
+            __hidden_system::__cpu_relax();
+        }
+        
+        while ((cnt = cnt_.load(std::memory_order_acquire)) != 0)
+        {
+            __hidden_system::__wait_while(&cnt_, cnt);
+        }
+    }
+    
+    /**
+     * @brief       Decrement the counter and wait for it to reach 0.
+     * @param       nbr : The value to subtract from the counter, not greater than it.
+     */
+    void arrive_and_wait(std::uint32_t nbr = 1) noexcept
+    {
+        count_down(nbr);
+        wait();
+    }
+
+private:
+    /** The counter. */
+    std::atomic<std::uint32_t> cnt_;
+};
+
+}
+}
+
+
+#endif
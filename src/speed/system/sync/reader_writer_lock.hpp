@@ -0,0 +1,303 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/reader_writer_lock.hpp
+ * @brief       reader_writer_lock class header.
+ * @author      Killian
+ * @date        2018/10/01 - 11:58
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_READER_WRITER_LOCK_HPP
+#define SPEED_SYSTEM_SYNC_READER_WRITER_LOCK_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+#include "adaptive_mutex.hpp"
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a reader-writer lock that favors the readers. The readers are
+ *              counted in one slot per core, each one on its own cache line, so readers on
+ *              different cores do not share any written cache line and taking the lock for reading
+ *              scales with the number of cores. A writer has to look at every slot, so writing is
+ *              more expensive, and it lets the readers in as long as some are holding the lock: it
+ *              fits the data that is read much more often than it is written.
+ */
+class reader_writer_lock
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    reader_writer_lock()
+            : slts_()
+            , wrtr_mtx_()
+            , wstte_(FREE)
+            , wevnt_(0)
+            , nbr_slts_(1)
+    {
+        const std::size_t nbr_cpus = std::max(std::thread::hardware_concurrency(), 1U);
+        
+        while (nbr_slts_ < nbr_cpus)
+        {
+            nbr_slts_ *= 2;
+        }
+        
+        slts_ = std::make_unique<slot[]>(nbr_slts_);
+    }
+    
+    /** @cond */
+    reader_writer_lock(const reader_writer_lock&) = delete;
+    
+    reader_writer_lock& operator =(const reader_writer_lock&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Lock for writing, waiting for the other writers and for the readers.
+     */
+    void lock() noexcept
+    {
+        wrtr_mtx_.lock();
+        
+        while (true)
+        {
+            wstte_.store(HELD, std::memory_order_seq_cst);
+            if (!has_readers())
+            {
+                return;
+            }
+            
+            // Some readers are in: the writer steps back so that readers keep coming in, and
+            // waits for all of them to leave.
+            wstte_.store(PENDING, std::memory_order_seq_cst);
+            futex_wake_all(&wstte_);
+            wait_readers();
+        }
+    }
+    
+    /**
+     * @brief       Try to lock for writing without waiting.
+     * @return      If the lock has been taken true is returned, otherwise false is returned.
+     */
+    bool try_lock() noexcept
+    {
+        if (!wrtr_mtx_.try_lock())
+        {
+            return false;
+        }
+        
+        wstte_.store(HELD, std::memory_order_seq_cst);
+        if (!has_readers())
+        {
+            return true;
+        }
+        
+        unlock();
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Unlock for writing.
+     */
+    void unlock() noexcept
+    {
+        if (wstte_.exchange(FREE, std::memory_order_seq_cst) == HELD_WITH_READERS)
+        {
+            futex_wake_all(&wstte_);
+        }
+        
+        wrtr_mtx_.unlock();
+    }
+    
+    /**
+     * @brief       Lock for reading, waiting only if a writer holds the lock.
+     */
+    void lock_shared() noexcept
+    {
+        std::atomic<std::uint32_t>& cnt = get_slot().cnt;
+        std::uint32_t wstte;
+        
+        while (true)
+        {
+            cnt.fetch_add(1, std::memory_order_seq_cst);
+            if (wstte_.load(std::memory_order_seq_cst) < HELD)
+            {
+                return;
+            }
+            
+            leave(cnt);
+            
+            wstte = wstte_.load(std::memory_order_relaxed);
+            while (wstte >= HELD)
+            {
+                if (wstte == HELD_WITH_READERS ||
+                    wstte_.compare_exchange_weak(wstte, HELD_WITH_READERS,
+                                                 std::memory_order_relaxed))
+                {
+                    __hidden_system::__wait_while(&wstte_, HELD_WITH_READERS);
+                }
+                
+                wstte = wstte_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+    
+    /**
+     * @brief       Try to lock for reading without waiting.
+     * @return      If the lock has been taken true is returned, otherwise false is returned.
+     */
+    bool try_lock_shared() noexcept
+    {
+        std::atomic<std::uint32_t>& cnt = get_slot().cnt;
+        
+        cnt.fetch_add(1, std::memory_order_seq_cst);
+        if (wstte_.load(std::memory_order_seq_cst) < HELD)
+        {
+            return true;
+        }
+        
+        leave(cnt);
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Unlock for reading.
+     */
+    void unlock_shared() noexcept
+    {
+        leave(get_slot().cnt);
+    }
+
+private:
+    /** The writer state when no writer wants the lock. */
+    static constexpr std::uint32_t FREE = 0;
+    
+    /** The writer state when a writer waits for the readers to leave. */
+    static constexpr std::uint32_t PENDING = 1;
+    
+    /** The writer state when a writer holds the lock. */
+    static constexpr std::uint32_t HELD = 2;
+    
+    /** The writer state when a writer holds the lock and readers may be sleeping. */
+    static constexpr std::uint32_t HELD_WITH_READERS = 3;
+    
+    /**
+     * @brief       Counter of the readers of a core.
+     */
+    struct alignas(64) slot
+    {
+        /** The number of readers that hold or try to take the lock. */
+        std::atomic<std::uint32_t> cnt{0};
+    };
+    
+    /**
+     * @brief       Get the slot of the calling thread. The threads are spread over the slots in
+     *              the order they first take a lock.
+     * @return      The slot of the calling thread.
+     */
+    slot& get_slot() const noexcept
+    {
+        static std::atomic<std::size_t> nxt_thrd_idx(0);
+        static thread_local const std::size_t thrd_idx =
+                nxt_thrd_idx.fetch_add(1, std::memory_order_relaxed);
+        
+        return slts_[thrd_idx & (nbr_slts_ - 1)];
+    }
+    
+    /**
+     * @brief       Remove a reader from a slot, and wake the writer if it waits for the readers.
+     * @param       cnt : The counter of the slot.
+     */
+    void leave(std::atomic<std::uint32_t>& cnt) noexcept
+    {
+        cnt.fetch_sub(1, std::memory_order_seq_cst);
+        if (wstte_.load(std::memory_order_seq_cst) != FREE)
+        {
+            wevnt_.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake(&wevnt_, 1);
+        }
+    }
+    
+    /**
+     * @brief       Check whether a reader holds or tries to take the lock.
+     * @return      If a reader holds or tries to take the lock true is returned, otherwise false
+     *              is returned.
+     */
+    bool has_readers() const noexcept
+    {
+        for (std::size_t i = 0; i < nbr_slts_; ++i)
+        {
+            if (slts_[i].cnt.load(std::memory_order_seq_cst) != 0)
+            {
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    /**
+     * @brief       Wait for all the readers to leave, the writer state being PENDING.
+     */
+    void wait_readers() noexcept
+    {
+        std::uint32_t ky = wevnt_.load(std::memory_order_seq_cst);
+        
+        while (has_readers())
+        {
+            __hidden_system::__wait_while(&wevnt_, ky);
+            ky = wevnt_.load(std::memory_order_seq_cst);
+        }
+    }
+    
+    /** The reader counters, one per core. */
+    std::unique_ptr<slot[]> slts_;
+    
+    /** Mutex that serializes the writers. */
+    adaptive_mutex wrtr_mtx_;
+    
+    /** The writer state. */
+    alignas(64) std::atomic<std::uint32_t> wstte_;
+    
+    /** The number of times a reader has left while a writer wanted the lock. */
+    std::atomic<std::uint32_t> wevnt_;
+    
+    /** The number of reader counters, a power of two not lower than the number of cores. */
+    std::size_t nbr_slts_;
+};
+
+}
+}
+
+
+#endif
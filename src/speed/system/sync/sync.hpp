@@ -0,0 +1,196 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/sync.hpp
+ * @brief       sync functions header.
+ * @author      Killian
+ * @date        2018/10/01 - 09:20
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_SYNC_HPP
+#define SPEED_SYSTEM_SYNC_SYNC_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#include "../api/glibc/sync.hpp"
+#include "../error_code.hpp"
+#include "../system_macros.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Put the calling thread to sleep if a 32 bits word holds an expected value, until a
+ *              futex_wake on the same word. The check and the sleep are atomic.
+ * @param       addr : The address of the word.
+ * @param       expctd_val : The value the word has to hold for the thread to sleep.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If the thread has slept, or has not because the word did not hold the expected
+ *              value or because a signal interrupted the sleep, true is returned, otherwise false
+ *              is returned.
+ */
+inline bool futex_wait(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t expctd_val,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(futex_wait, false, addr, expctd_val, err_code);
+}
+
+
+/**
+ * @brief       Wake threads that sleep in futex_wait on a 32 bits word.
+ * @param       addr : The address of the word.
+ * @param       nbr_thrds : The maximum number of threads to wake.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool futex_wake(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t nbr_thrds,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(futex_wake, false, addr, nbr_thrds, err_code);
+}
+
+
+/**
+ * @brief       Put the calling thread to sleep if a 32 bits word holds an expected value, until a
+ *              futex_wake_bitset on the same word with a bitset that shares a bit with the one of
+ *              the thread. The check and the sleep are atomic.
+ * @param       addr : The address of the word.
+ * @param       expctd_val : The value the word has to hold for the thread to sleep.
+ * @param       btst : The bitset of the thread, that must not be 0.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If the thread has slept, or has not because the word did not hold the expected
+ *              value or because a signal interrupted the sleep, true is returned, otherwise false
+ *              is returned.
+ */
+inline bool futex_wait_bitset(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t expctd_val,
+        std::uint32_t btst,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(futex_wait_bitset, false, addr, expctd_val, btst, err_code);
+}
+
+
+/**
+ * @brief       Wake threads that sleep in futex_wait_bitset on a 32 bits word with a bitset that
+ *              shares a bit with a given one.
+ * @param       addr : The address of the word.
+ * @param       nbr_thrds : The maximum number of threads to wake.
+ * @param       btst : The bitset, that must not be 0.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool futex_wake_bitset(
+        std::atomic<std::uint32_t>* addr,
+        std::uint32_t nbr_thrds,
+        std::uint32_t btst,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(futex_wake_bitset, false, addr, nbr_thrds, btst, err_code);
+}
+
+
+/**
+ * @brief       Wake all the threads that sleep in futex_wait on a 32 bits word.
+ * @param       addr : The address of the word.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool futex_wake_all(
+        std::atomic<std::uint32_t>* addr,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return futex_wake(addr, INT_MAX, err_code);
+}
+
+
+/** @cond */
+namespace __hidden_system {
+
+
+/** The number of times a thread spins on a lock before going to sleep, on multiprocessors. */
+constexpr std::size_t SPIN_COUNT = 128;
+
+
+/**
+ * @brief       Tell the processor that the calling thread is spinning, to save power and to let
+ *              the other hardware thread of the core run.
+ */
+inline void __cpu_relax() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+
+/**
+ * @brief       Get the number of times a thread spins on a lock before going to sleep. It is 0 on
+ *              a uniprocessor, where the thread that holds the lock cannot run while another one
+ *              spins.
+ * @return      The number of times a thread spins on a lock before going to sleep.
+ */
+inline std::size_t __get_spin_count() noexcept
+{
+    static const std::size_t spn_cnt = std::thread::hardware_concurrency() == 1 ? 0 : SPIN_COUNT;
+    
+    return spn_cnt;
+}
+
+
+/**
+ * @brief       Sleep while a 32 bits word holds a value, or yield when futexes are not available.
+ * @param       addr : The address of the word.
+ * @param       val : The value.
+ */
+inline void __wait_while(std::atomic<std::uint32_t>* addr, std::uint32_t val) noexcept
+{
+    if (!futex_wait(addr, val))
+    {
+        std::this_thread::yield();
+    }
+}
+
+
+} /* __hidden_system */
+/** @endcond */
+
+}
+}
+
+
+#endif
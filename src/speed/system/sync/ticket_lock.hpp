@@ -0,0 +1,158 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed/system/sync/ticket_lock.hpp
+ * @brief       ticket_lock class header.
+ * @author      Killian
+ * @date        2018/10/01 - 10:47
+ */
+
+#ifndef SPEED_SYSTEM_SYNC_TICKET_LOCK_HPP
+#define SPEED_SYSTEM_SYNC_TICKET_LOCK_HPP
+
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <thread>
+
+#include "sync.hpp"
+
+
+namespace speed {
+namespace system {
+
+
+/**
+ * @brief       Class that represents a ticket lock, that grants the lock in the order it is
+ *              requested, so no thread starves. A thread spins for a while, with a back-off
+ *              proportional to its distance to the front of the line, and then sleeps on a futex
+ *              with a bitset derived from its ticket, so unlocking wakes only the next thread in
+ *              line. Handing the lock over in order costs a context switch when the next thread
+ *              sleeps, so it fits the locks held for short times on multiprocessors.
+ */
+class ticket_lock
+{
+public:
+    /**
+     * @brief       Default constructor.
+     */
+    ticket_lock() noexcept
+            : nxt_(0)
+            , srvng_(0)
+            , nbr_slprs_(0)
+    {
+    }
+    
+    /** @cond */
+    ticket_lock(const ticket_lock&) = delete;
+    
+    ticket_lock& operator =(const ticket_lock&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Lock, waiting for the turn of the calling thread.
+     */
+    void lock() noexcept
+    {
+        const std::uint32_t tckt = nxt_.fetch_add(1, std::memory_order_relaxed);
+        std::uint32_t srvng;
+        
+        if ((srvng = srvng_.load(std::memory_order_acquire)) == tckt)
+        {
+            return;
+        }
+        
+        for (std::size_t i = 0; i < __hidden_system::__get_spin_count(); ++i)
+        {
+            for (std::uint32_t j = tckt - srvng; j > 0; --j)
+            {
+                __hidden_system::__cpu_relax();
+            }
+            
+            if ((srvng = srvng_.load(std::memory_order_acquire)) == tckt)
+            {
+                return;
+            }
+        }
+        
+        nbr_slprs_.fetch_add(1, std::memory_order_seq_cst);
+        while ((srvng = srvng_.load(std::memory_order_seq_cst)) != tckt)
+        {
+            if (!futex_wait_bitset(&srvng_, srvng, get_bitset(tckt)))
+            {
+                std::this_thread::yield();
+            }
+        }
+        
+        nbr_slprs_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Try to lock without waiting.
+     * @return      If the lock has been taken true is returned, otherwise false is returned.
+     */
+    bool try_lock() noexcept
+    {
+        std::uint32_t srvng = srvng_.load(std::memory_order_acquire);
+        std::uint32_t nxt = srvng;
+        
+        return nxt_.compare_exchange_strong(nxt, srvng + 1, std::memory_order_acquire,
+                                            std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief       Unlock, giving the lock to the next thread in line.
+     */
+    void unlock() noexcept
+    {
+        const std::uint32_t srvng = srvng_.fetch_add(1, std::memory_order_seq_cst) + 1;
+        
+        if (nbr_slprs_.load(std::memory_order_seq_cst) != 0)
+        {
+            futex_wake_bitset(&srvng_, INT_MAX, get_bitset(srvng));
+        }
+    }
+
+private:
+    /**
+     * @brief       Get the futex bitset of the thread that holds a ticket.
+     * @param       tckt : The ticket.
+     * @return      The futex bitset of the thread that holds the ticket.
+     */
+    static std::uint32_t get_bitset(std::uint32_t tckt) noexcept
+    {
+        return static_cast<std::uint32_t>(1) << (tckt & 31);
+    }
+    
+    /** The next ticket to give. */
+    alignas(64) std::atomic<std::uint32_t> nxt_;
+    
+    /** The ticket that holds the lock. */
+    alignas(64) std::atomic<std::uint32_t> srvng_;
+    
+    /** The number of threads that may be sleeping. */
+    std::atomic<std::uint32_t> nbr_slprs_;
+};
+
+}
+}
+
+
+#endif
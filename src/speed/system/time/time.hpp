@@ -96,6 +96,79 @@ inline bool get_child_cpu_time(
 }
 
 
+/**
+ * @brief       Create a timer on the monotonic clock, that is a file descriptor readable once it
+ *              expires. The timer is created disarmed.
+ * @param       fd : The value in which store the file descriptor of the timer.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool create_timer(int* fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(create_timer, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Arm a timer to expire at an absolute monotonic time, or disarm it.
+ * @param       fd : The file descriptor of the timer.
+ * @param       deadln : The monotonic time at which the timer expires, that has the same origin
+ *              as get_monotonic_time. If it is nullptr the timer is disarmed.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool set_timer(
+        int fd,
+        const time_specification* deadln,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(set_timer, false, fd, deadln, err_code);
+}
+
+
+/**
+ * @brief       Acknowledge the expirations of a timer without blocking.
+ * @param       fd : The file descriptor of the timer.
+ * @param       nbr_expirations : The value in which store the number of expirations since the
+ *              last call, which is 0 if the timer has not expired.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool read_timer(
+        int fd,
+        std::uint64_t* nbr_expirations,
+        std::error_code* err_code = nullptr
+) noexcept
+{
+    return SPEED_SELECT_API(read_timer, false, fd, nbr_expirations, err_code);
+}
+
+
+/**
+ * @brief       Block the calling thread until a timer expires.
+ * @param       fd : The file descriptor of the timer.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool wait_timer(int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(wait_timer, false, fd, err_code);
+}
+
+
+/**
+ * @brief       Destroy a timer.
+ * @param       fd : The file descriptor of the timer.
+ * @param       err_code : If function fails it holds the platform-dependent error code.
+ * @return      If function was successful true is returned, otherwise false is returned.
+ */
+inline bool close_timer(int fd, std::error_code* err_code = nullptr) noexcept
+{
+    return SPEED_SELECT_API(close_timer, false, fd, err_code);
+}
+
+
 }
 }
 
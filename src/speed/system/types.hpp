@@ -30,6 +30,7 @@
 #include <cstdint>
 #include <utility>
 
+#include "event/event_flags.hpp"
 #include "filesystem/types.hpp"
 
 
@@ -162,6 +163,47 @@ struct time_specification
 };
 
 
+/**
+ * @brief       Represents the status of a file.
+ */
+struct file_status
+{
+    /** The size of the file in bytes. */
+    std::uint64_t sz;
+    
+    /** The inode of the file. */
+    std::uint64_t ino;
+    
+    /** The number of hard links to the file. */
+    std::uint64_t nbr_lnks;
+    
+    /** The last modification time of the file, since the Epoch. */
+    time_specification mod_tme;
+    
+    /** The type and the permissions of the file. */
+    std::uint32_t mde;
+    
+    /** The user id of the owner of the file. */
+    std::uint32_t uid;
+    
+    /** The group id of the owner of the file. */
+    std::uint32_t gid;
+};
+
+
+/**
+ * @brief       Represents an event reported on a watched file descriptor.
+ */
+struct event_record
+{
+    /** The data registered with the file descriptor. */
+    std::uint64_t dat;
+    
+    /** The events that occurred. */
+    event_flags evnts;
+};
+
+
 }
 }
 
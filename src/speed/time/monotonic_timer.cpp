@@ -24,6 +24,9 @@
  * @date       2018/01/21 - 01:41
  */
 
+#include <algorithm>
+#include <utility>
+
 #include "monotonic_timer.hpp"
 
 
@@ -31,7 +34,446 @@ namespace speed {
 namespace time {
 
 
-// ...
+monotonic_timer::monotonic_timer(std::uint64_t res)
+        : nods_(NBR_HEADS)
+        , free_idxs_()
+        , ocpd_()
+        , bse_()
+        , res_(res != 0 ? res : 1)
+        , cur_tck_(0)
+        , armd_tck_(NO_TICK)
+        , nbr_tmrs_(0)
+        , fd_(-1)
+{
+    for (std::uint32_t i = 0; i < NBR_HEADS; ++i)
+    {
+        nods_[i].prv = i;
+        nods_[i].nxt = i;
+    }
+    
+    if (!speed::system::get_monotonic_time(&bse_) || !speed::system::create_timer(&fd_))
+    {
+        throw speed::system::system_exception();
+    }
+}
+
+
+monotonic_timer::~monotonic_timer() noexcept
+{
+    speed::system::close_timer(fd_);
+}
+
+
+monotonic_timer::timer_id monotonic_timer::schedule_once(
+        const speed::system::time_specification& dly,
+        callback_type cb
+)
+{
+    return add_timer(to_nanoseconds(dly), 0, std::move(cb));
+}
+
+
+monotonic_timer::timer_id monotonic_timer::schedule_periodic(
+        const speed::system::time_specification& prd,
+        callback_type cb
+)
+{
+    const std::uint64_t prd_ns = to_nanoseconds(prd);
+    
+    return add_timer(prd_ns, std::max<std::uint64_t>((prd_ns + res_ - 1) / res_, 1),
+                     std::move(cb));
+}
+
+
+bool monotonic_timer::cancel(timer_id id) noexcept
+{
+    const auto idx = static_cast<std::uint32_t>(id);
+    
+    if (idx < NBR_HEADS || idx >= nods_.size() ||
+        nods_[idx].gen != static_cast<std::uint32_t>(id >> 32))
+    {
+        return false;
+    }
+    
+    if (nods_[idx].stte == timer_states::PENDING)
+    {
+        unlink(idx);
+        release(idx);
+        --nbr_tmrs_;
+        
+        return true;
+    }
+    
+    if (nods_[idx].stte == timer_states::RUNNING && nods_[idx].prd != 0)
+    {
+        nods_[idx].stte = timer_states::CANCELED;
+        --nbr_tmrs_;
+        
+        return true;
+    }
+    
+    return false;
+}
+
+
+std::size_t monotonic_timer::process_expired_timers(std::error_code* err_code)
+{
+    std::uint64_t nbr_exp;
+    std::uint64_t now;
+    std::uint64_t nxt;
+    std::uint32_t idx;
+    std::uint32_t lvl;
+    std::size_t nbr_clld = 0;
+    callback_type cb;
+    
+    if (!speed::system::read_timer(fd_, &nbr_exp, err_code) ||
+        (now = get_elapsed_nanoseconds(err_code)) == NO_TICK)
+    {
+        return 0;
+    }
+    
+    if (nbr_exp != 0)
+    {
+        armd_tck_ = NO_TICK;
+    }
+    
+    now /= res_;
+    while ((idx = nods_[PENDING_HEAD].nxt) != PENDING_HEAD)
+    {
+        unlink(idx);
+        insert(idx);
+    }
+    
+    while ((nxt = get_next_tick()) <= now)
+    {
+        cur_tck_ = nxt;
+        for (lvl = NBR_LEVELS - 1; lvl > 0; --lvl)
+        {
+            if ((cur_tck_ & ((1ull << (SLOT_BITS * lvl)) - 1)) == 0)
+            {
+                take_slot(lvl, (cur_tck_ >> (SLOT_BITS * lvl)) & (NBR_SLOTS - 1));
+                while ((idx = nods_[PENDING_HEAD].nxt) != PENDING_HEAD)
+                {
+                    unlink(idx);
+                    insert(idx);
+                }
+            }
+        }
+        
+        take_slot(0, cur_tck_ & (NBR_SLOTS - 1));
+        ++cur_tck_;
+        
+        while ((idx = nods_[PENDING_HEAD].nxt) != PENDING_HEAD)
+        {
+            unlink(idx);
+            if (nods_[idx].expry >= cur_tck_)
+            {
+                insert(idx);
+                continue;
+            }
+            
+            nods_[idx].stte = timer_states::RUNNING;
+            if (nods_[idx].prd == 0)
+            {
+                --nbr_tmrs_;
+            }
+            
+            cb = std::move(nods_[idx].cb);
+            ++nbr_clld;
+            
+            try
+            {
+                cb();
+            }
+            catch (...)
+            {
+                finish(idx, std::move(cb));
+                arm(nullptr);
+                throw;
+            }
+            
+            finish(idx, std::move(cb));
+        }
+    }
+    
+    cur_tck_ = std::max(cur_tck_, now);
+    arm(err_code);
+    
+    return nbr_clld;
+}
+
+
+bool monotonic_timer::wait(std::error_code* err_code)
+{
+    if (nbr_tmrs_ == 0 || !speed::system::wait_timer(fd_, err_code))
+    {
+        return false;
+    }
+    
+    process_expired_timers(err_code);
+    
+    return true;
+}
+
+
+monotonic_timer::timer_id monotonic_timer::add_timer(
+        std::uint64_t dly,
+        std::uint64_t prd,
+        callback_type&& cb
+)
+{
+    std::uint64_t now = get_elapsed_nanoseconds(nullptr);
+    std::uint32_t idx;
+    
+    if (now == NO_TICK)
+    {
+        now = cur_tck_ * res_;
+    }
+    
+    if (free_idxs_.empty())
+    {
+        idx = static_cast<std::uint32_t>(nods_.size());
+        nods_.emplace_back();
+        free_idxs_.reserve(nods_.size());
+    }
+    else
+    {
+        idx = free_idxs_.back();
+        free_idxs_.pop_back();
+    }
+    
+    timer_node& nod = nods_[idx];
+    
+    nod.cb = std::move(cb);
+    nod.expry = std::max((now + dly + res_ - 1) / res_, cur_tck_);
+    nod.prd = prd;
+    nod.stte = timer_states::PENDING;
+    insert(idx);
+    ++nbr_tmrs_;
+    
+    if (nod.expry < armd_tck_)
+    {
+        arm(nullptr);
+    }
+    
+    return (static_cast<timer_id>(nod.gen) << 32) | idx;
+}
+
+
+void monotonic_timer::finish(std::uint32_t idx, callback_type&& cb) noexcept
+{
+    timer_node& nod = nods_[idx];
+    
+    if (nod.stte != timer_states::RUNNING || nod.prd == 0)
+    {
+        release(idx);
+        return;
+    }
+    
+    nod.cb = std::move(cb);
+    nod.expry += nod.prd;
+    if (nod.expry < cur_tck_)
+    {
+        nod.expry += (cur_tck_ - nod.expry + nod.prd - 1) / nod.prd * nod.prd;
+    }
+    
+    nod.stte = timer_states::PENDING;
+    insert(idx);
+}
+
+
+void monotonic_timer::release(std::uint32_t idx) noexcept
+{
+    timer_node& nod = nods_[idx];
+    
+    nod.cb = nullptr;
+    nod.stte = timer_states::FREE;
+    ++nod.gen;
+    free_idxs_.push_back(idx);
+}
+
+
+void monotonic_timer::insert(std::uint32_t idx) noexcept
+{
+    std::uint64_t expry = std::max(nods_[idx].expry, cur_tck_);
+    std::uint64_t dlt = expry - cur_tck_;
+    std::uint32_t lvl = 0;
+    
+    if (dlt > MAX_TICKS)
+    {
+        dlt = MAX_TICKS;
+        expry = cur_tck_ + MAX_TICKS;
+    }
+    
+    while (lvl + 1 < NBR_LEVELS && dlt >> (SLOT_BITS * (lvl + 1)) != 0)
+    {
+        ++lvl;
+    }
+    
+    link(lvl * NBR_SLOTS + ((expry >> (SLOT_BITS * lvl)) & (NBR_SLOTS - 1)), idx);
+}
+
+
+void monotonic_timer::link(std::uint32_t hd, std::uint32_t idx) noexcept
+{
+    const std::uint32_t lst = nods_[hd].prv;
+    
+    nods_[idx].prv = lst;
+    nods_[idx].nxt = hd;
+    nods_[lst].nxt = idx;
+    nods_[hd].prv = idx;
+    
+    if (hd < PENDING_HEAD)
+    {
+        ocpd_[hd / NBR_SLOTS][(hd % NBR_SLOTS) / 64] |= 1ull << (hd % 64);
+    }
+}
+
+
+void monotonic_timer::unlink(std::uint32_t idx) noexcept
+{
+    const std::uint32_t prv = nods_[idx].prv;
+    const std::uint32_t nxt = nods_[idx].nxt;
+    
+    nods_[prv].nxt = nxt;
+    nods_[nxt].prv = prv;
+    
+    if (prv == nxt && prv < PENDING_HEAD)
+    {
+        ocpd_[prv / NBR_SLOTS][(prv % NBR_SLOTS) / 64] &= ~(1ull << (prv % 64));
+    }
+}
+
+
+void monotonic_timer::take_slot(std::uint32_t lvl, std::uint32_t slt) noexcept
+{
+    const std::uint32_t hd = lvl * NBR_SLOTS + slt;
+    const std::uint32_t frst = nods_[hd].nxt;
+    const std::uint32_t lst = nods_[hd].prv;
+    const std::uint32_t pndng_lst = nods_[PENDING_HEAD].prv;
+    
+    if (frst == hd)
+    {
+        return;
+    }
+    
+    nods_[pndng_lst].nxt = frst;
+    nods_[frst].prv = pndng_lst;
+    nods_[lst].nxt = PENDING_HEAD;
+    nods_[PENDING_HEAD].prv = lst;
+    nods_[hd].prv = hd;
+    nods_[hd].nxt = hd;
+    ocpd_[lvl][slt / 64] &= ~(1ull << (slt % 64));
+}
+
+
+std::uint64_t monotonic_timer::get_next_tick() const noexcept
+{
+    std::uint64_t nxt = NO_TICK;
+    std::uint32_t cur_slt = cur_tck_ & (NBR_SLOTS - 1);
+    std::uint32_t slt = find_slot(0, cur_slt);
+    std::uint32_t shft;
+    std::uint32_t frst;
+    
+    if (slt != NBR_SLOTS)
+    {
+        nxt = cur_tck_ + ((slt - cur_slt) & (NBR_SLOTS - 1));
+    }
+    
+    for (std::uint32_t lvl = 1; lvl < NBR_LEVELS; ++lvl)
+    {
+        shft = SLOT_BITS * lvl;
+        cur_slt = (cur_tck_ >> shft) & (NBR_SLOTS - 1);
+        frst = (cur_tck_ & ((1ull << shft) - 1)) == 0 ? 0 : 1;
+        slt = find_slot(lvl, (cur_slt + frst) & (NBR_SLOTS - 1));
+        
+        if (slt != NBR_SLOTS)
+        {
+            nxt = std::min(nxt, ((cur_tck_ >> shft) +
+                                 ((slt - cur_slt - frst) & (NBR_SLOTS - 1)) + frst) << shft);
+        }
+    }
+    
+    return nxt;
+}
+
+
+std::uint64_t monotonic_timer::get_elapsed_nanoseconds(std::error_code* err_code) const noexcept
+{
+    speed::system::time_specification now;
+    
+    if (!speed::system::get_monotonic_time(&now, err_code))
+    {
+        return NO_TICK;
+    }
+    
+    return to_nanoseconds(speed::system::get_elapsed_time(bse_, now));
+}
+
+
+bool monotonic_timer::arm(std::error_code* err_code) noexcept
+{
+    const std::uint64_t nxt = get_next_tick();
+    std::uint64_t deadln_ns;
+    
+    if (nxt == armd_tck_)
+    {
+        return true;
+    }
+    
+    if (nxt == NO_TICK)
+    {
+        if (!speed::system::set_timer(fd_, nullptr, err_code))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        deadln_ns = to_nanoseconds(bse_) + nxt * res_;
+        
+        speed::system::time_specification deadln(deadln_ns / 1'000'000'000,
+                                                 deadln_ns % 1'000'000'000);
+        
+        if (!speed::system::set_timer(fd_, &deadln, err_code))
+        {
+            return false;
+        }
+    }
+    
+    armd_tck_ = nxt;
+    
+    return true;
+}
+
+
+std::uint32_t monotonic_timer::find_slot(std::uint32_t lvl, std::uint32_t frm) const noexcept
+{
+    const auto& bts = ocpd_[lvl];
+    std::uint32_t wrd = frm / 64;
+    std::uint64_t msk = bts[wrd] & (~0ull << (frm % 64));
+    
+    for (std::size_t i = 0; i <= bts.size(); ++i)
+    {
+        if (msk != 0)
+        {
+            return wrd * 64 + static_cast<std::uint32_t>(__builtin_ctzll(msk));
+        }
+        
+        wrd = (wrd + 1) % bts.size();
+        msk = bts[wrd];
+    }
+    
+    return NBR_SLOTS;
+}
+
+
+std::uint64_t monotonic_timer::to_nanoseconds(
+        const speed::system::time_specification& tme
+) noexcept
+{
+    return tme.sec * 1'000'000'000 + tme.nsec;
+}
 
 
 }
@@ -27,19 +27,301 @@
 #ifndef SPEED_TIME_MONOTONIC_TIMER_HPP
 #define SPEED_TIME_MONOTONIC_TIMER_HPP
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <system_error>
+#include <vector>
 
-// TODO(killian.poulaud@etu.upmc.fr): Implement the i_timer interface.
-//#include "i_timer.hpp"
+#include "../system.hpp"
 
 
 namespace speed {
 namespace time {
 
 
-// TODO(killian.poulaud@etu.upmc.fr): Implement the monotonic_timer class.
+/**
+ * @brief       Class that represents a deadline scheduler on the monotonic clock, the one of
+ *              monotonic_chrono, that calls callbacks once or periodically. The timers are kept
+ *              in a hierarchical timer wheel of four levels of 256 slots, so adding and cancelling
+ *              a timer are O(1), and a single kernel timer, armed for the nearest deadline, drives
+ *              all of them. Its file descriptor becomes readable once a timer is due, so it can be
+ *              waited for with wait, or watched by an event loop that then calls
+ *              process_expired_timers. A timer scheduler is not thread-safe: it has to be used by
+ *              a single thread, the callbacks included.
+ */
 class monotonic_timer
 {
+public:
+    /** The callback type. */
+    using callback_type = std::function<void()>;
+    
+    /** The type of the identifiers of the timers. */
+    using timer_id = std::uint64_t;
+    
+    /**
+     * @brief       Constructor with parameters.
+     * @param       res : The resolution of the timers in nanoseconds, to which the delays are
+     *              rounded up. It has to be greater than 0.
+     * @throw       speed::system::system_exception : If the kernel timer can not be created.
+     */
+    explicit monotonic_timer(std::uint64_t res = 1'000'000);
+    
+    /** @cond */
+    monotonic_timer(const monotonic_timer&) = delete;
+    
+    monotonic_timer& operator =(const monotonic_timer&) = delete;
+    /** @endcond */
+    
+    /**
+     * @brief       Destructor.
+     */
+    ~monotonic_timer() noexcept;
+    
+    /**
+     * @brief       Add a timer that calls a callback once, after a delay.
+     * @param       dly : The delay.
+     * @param       cb : The callback.
+     * @return      The identifier of the timer.
+     */
+    timer_id schedule_once(const speed::system::time_specification& dly, callback_type cb);
+    
+    /**
+     * @brief       Add a timer that calls a callback periodically, the first time after a period.
+     *              The deadlines are multiples of the period, so the calls do not drift.
+     * @param       prd : The period.
+     * @param       cb : The callback.
+     * @return      The identifier of the timer.
+     */
+    timer_id schedule_periodic(const speed::system::time_specification& prd, callback_type cb);
+    
+    /**
+     * @brief       Cancel a timer. It can be called from a callback, even for its own timer.
+     * @param       id : The identifier of the timer.
+     * @return      If the timer was pending true is returned, otherwise false is returned.
+     */
+    bool cancel(timer_id id) noexcept;
+    
+    /**
+     * @brief       Call the callbacks of the timers that are due, without blocking, and arm the
+     *              kernel timer for the next deadline.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of callbacks called.
+     */
+    std::size_t process_expired_timers(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Block the calling thread until the nearest deadline, and call the callbacks of
+     *              the timers that are due.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If a timer was pending and function was successful true is returned,
+     *              otherwise false is returned.
+     */
+    bool wait(std::error_code* err_code = nullptr);
+    
+    /**
+     * @brief       Get the file descriptor of the kernel timer, that becomes readable once a timer
+     *              is due.
+     * @return      The file descriptor of the kernel timer.
+     */
+    [[nodiscard]] inline int get_file_descriptor() const noexcept
+    {
+        return fd_;
+    }
+    
+    /**
+     * @brief       Get the number of pending timers.
+     * @return      The number of pending timers.
+     */
+    [[nodiscard]] inline std::size_t size() const noexcept
+    {
+        return nbr_tmrs_;
+    }
+    
+    /**
+     * @brief       Check whether there is no pending timer.
+     * @return      If there is no pending timer true is returned, otherwise false is returned.
+     */
+    [[nodiscard]] inline bool empty() const noexcept
+    {
+        return nbr_tmrs_ == 0;
+    }
 
+private:
+    /** The number of bits of the slot index of a level. */
+    static constexpr std::uint32_t SLOT_BITS = 8;
+    
+    /** The number of slots of a level. */
+    static constexpr std::uint32_t NBR_SLOTS = 1u << SLOT_BITS;
+    
+    /** The number of levels. */
+    static constexpr std::uint32_t NBR_LEVELS = 4;
+    
+    /** The index of the head of the list of the timers being processed. */
+    static constexpr std::uint32_t PENDING_HEAD = NBR_SLOTS * NBR_LEVELS;
+    
+    /** The number of list heads, stored before the timers. */
+    static constexpr std::uint32_t NBR_HEADS = PENDING_HEAD + 1;
+    
+    /** The greatest number of ticks to a deadline the wheel can hold. */
+    static constexpr std::uint64_t MAX_TICKS = (1ull << (SLOT_BITS * NBR_LEVELS)) - 1;
+    
+    /** The tick value that means no tick. */
+    static constexpr std::uint64_t NO_TICK = ~0ull;
+    
+    /**
+     * @brief       The states of a timer.
+     */
+    enum class timer_states : std::uint8_t
+    {
+        FREE,
+        PENDING,
+        RUNNING,
+        CANCELED
+    };
+    
+    /**
+     * @brief       Timer, or list head. The lists are linked by indexes, so they stay valid when
+     *              the timers are reallocated.
+     */
+    struct timer_node
+    {
+        /** The callback. */
+        callback_type cb;
+        
+        /** The tick of the deadline. */
+        std::uint64_t expry = 0;
+        
+        /** The period in ticks, or 0 for a timer that fires once. */
+        std::uint64_t prd = 0;
+        
+        /** The index of the previous node of the list. */
+        std::uint32_t prv = 0;
+        
+        /** The index of the next node of the list. */
+        std::uint32_t nxt = 0;
+        
+        /** The generation, incremented every time the node is reused. */
+        std::uint32_t gen = 0;
+        
+        /** The state. */
+        timer_states stte = timer_states::FREE;
+    };
+    
+    /**
+     * @brief       Add a timer.
+     * @param       dly : The delay before the first deadline in nanoseconds.
+     * @param       prd : The period in ticks, or 0 for a timer that fires once.
+     * @param       cb : The callback.
+     * @return      The identifier of the timer.
+     */
+    timer_id add_timer(std::uint64_t dly, std::uint64_t prd, callback_type&& cb);
+    
+    /**
+     * @brief       Reschedule a periodic timer after its callback, or free the timer.
+     * @param       idx : The index of the timer.
+     * @param       cb : The callback of the timer.
+     */
+    void finish(std::uint32_t idx, callback_type&& cb) noexcept;
+    
+    /**
+     * @brief       Free a timer.
+     * @param       idx : The index of the timer.
+     */
+    void release(std::uint32_t idx) noexcept;
+    
+    /**
+     * @brief       Insert a timer in the slot of its deadline.
+     * @param       idx : The index of the timer.
+     */
+    void insert(std::uint32_t idx) noexcept;
+    
+    /**
+     * @brief       Append a node at the end of a list.
+     * @param       hd : The index of the head of the list.
+     * @param       idx : The index of the node.
+     */
+    void link(std::uint32_t hd, std::uint32_t idx) noexcept;
+    
+    /**
+     * @brief       Remove a node from its list.
+     * @param       idx : The index of the node.
+     */
+    void unlink(std::uint32_t idx) noexcept;
+    
+    /**
+     * @brief       Move the timers of a slot to the list of the timers being processed.
+     * @param       lvl : The level of the slot.
+     * @param       slt : The index of the slot.
+     */
+    void take_slot(std::uint32_t lvl, std::uint32_t slt) noexcept;
+    
+    /**
+     * @brief       Get the next tick at which a slot has to be processed.
+     * @return      The next tick at which a slot has to be processed, or NO_TICK if there is no
+     *              pending timer.
+     */
+    [[nodiscard]] std::uint64_t get_next_tick() const noexcept;
+    
+    /**
+     * @brief       Get the number of nanoseconds elapsed since the tick 0.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      The number of nanoseconds elapsed since the tick 0, or NO_TICK if the time can
+     *              not be read.
+     */
+    std::uint64_t get_elapsed_nanoseconds(std::error_code* err_code) const noexcept;
+    
+    /**
+     * @brief       Arm the kernel timer for the next tick at which a slot has to be processed.
+     * @param       err_code : If function fails it holds the platform-dependent error code.
+     * @return      If function was successful true is returned, otherwise false is returned.
+     */
+    bool arm(std::error_code* err_code) noexcept;
+    
+    /**
+     * @brief       Get the index of the first slot of a level that holds timers, at or after a
+     *              given one, in circular order.
+     * @param       lvl : The level.
+     * @param       frm : The index of the slot to start from.
+     * @return      The index of the slot, or NBR_SLOTS if there is none.
+     */
+    [[nodiscard]] std::uint32_t find_slot(std::uint32_t lvl, std::uint32_t frm) const noexcept;
+    
+    /**
+     * @brief       Convert a time specification to a number of nanoseconds.
+     * @param       tme : The time specification.
+     * @return      The number of nanoseconds.
+     */
+    [[nodiscard]] static std::uint64_t to_nanoseconds(
+            const speed::system::time_specification& tme
+    ) noexcept;
+    
+    /** The timers, after the list heads. */
+    std::vector<timer_node> nods_;
+    
+    /** The indexes of the free timers. */
+    std::vector<std::uint32_t> free_idxs_;
+    
+    /** The bitmaps of the slots that hold timers, for every level. */
+    std::array<std::array<std::uint64_t, NBR_SLOTS / 64>, NBR_LEVELS> ocpd_;
+    
+    /** The monotonic time of the tick 0. */
+    speed::system::time_specification bse_;
+    
+    /** The resolution in nanoseconds. */
+    std::uint64_t res_;
+    
+    /** The tick up to which the timers have been processed. */
+    std::uint64_t cur_tck_;
+    
+    /** The tick for which the kernel timer is armed, or NO_TICK if it is disarmed. */
+    std::uint64_t armd_tck_;
+    
+    /** The number of pending timers. */
+    std::size_t nbr_tmrs_;
+    
+    /** The file descriptor of the kernel timer. */
+    int fd_;
 };
 
 
@@ -0,0 +1,143 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/external_sort_bench.cpp
+ * @brief       external_sort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 16:45
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of values of the file to sort, 256 MiB of 64 bits integers. */
+constexpr std::size_t NBR_VALUES = 1 << 25;
+
+
+std::string get_bench_path(const char* nme)
+{
+    return (std::filesystem::temp_directory_path() / nme).string();
+}
+
+
+/**
+ * @brief       Reset the peak resident set size of the process to its current resident set size,
+ *              so that the next calls to get_peak_rss only cover what runs from now on. The peak
+ *              is taken over a single sort, since the heap pages that the allocator keeps after
+ *              a sort would be counted again by the next one.
+ */
+void reset_peak_rss()
+{
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+
+/**
+ * @brief       Get the peak resident set size of the process.
+ * @return      The peak resident set size in MiB, or 0 if it is not available.
+ */
+double get_peak_rss()
+{
+    std::ifstream ifs("/proc/self/status");
+    std::string ln;
+    
+    while (std::getline(ifs, ln))
+    {
+        if (ln.compare(0, 6, "VmHWM:") == 0)
+        {
+            return std::stod(ln.substr(6)) / 1024.0;
+        }
+    }
+    
+    return 0.0;
+}
+
+
+}
+
+
+SPEED_BENCH(external_sort, values)
+{
+    const std::string src_pth = get_bench_path("speed_external_sort_bench_src");
+    const std::string dest_pth = get_bench_path("speed_external_sort_bench_dest");
+    
+    {
+        const std::vector<std::uint64_t> vals = speed_bench::make_random_integers<std::uint64_t>(
+                NBR_VALUES, 0, ~std::uint64_t(0));
+        std::FILE* fle = std::fopen(src_pth.c_str(), "wb");
+        
+        std::fwrite(vals.data(), sizeof(std::uint64_t), vals.size(), fle);
+        std::fclose(fle);
+    }
+    
+    for (std::size_t mem_budget : {16 << 20, 64 << 20})
+    {
+        const std::string sfx = " " + std::to_string(mem_budget >> 20) + " MiB budget";
+        speed::algorithm::external_sort_options opts;
+        
+        opts.mem_budget = mem_budget;
+        
+        reset_peak_rss();
+        const double bse_rss = get_peak_rss();
+        
+        speed::algorithm::external_sort<std::uint64_t>(src_pth.c_str(), dest_pth.c_str(), opts);
+        st.report("external_sort peak RSS" + sfx, get_peak_rss() - bse_rss, "MiB");
+        
+        st.measure("external_sort" + sfx, NBR_VALUES, [&] {
+            speed::algorithm::external_sort<std::uint64_t>(src_pth.c_str(), dest_pth.c_str(),
+                                                           opts);
+        });
+    }
+    
+    reset_peak_rss();
+    const double bse_rss = get_peak_rss();
+    
+    st.measure("read + std::sort + write in memory", NBR_VALUES, [&] {
+        std::vector<std::uint64_t> vals(NBR_VALUES);
+        std::FILE* fle = std::fopen(src_pth.c_str(), "rb");
+        
+        speed_bench::do_not_optimize(std::fread(vals.data(), sizeof(std::uint64_t), vals.size(),
+                                                fle));
+        std::fclose(fle);
+        std::sort(vals.begin(), vals.end());
+        
+        fle = std::fopen(dest_pth.c_str(), "wb");
+        std::fwrite(vals.data(), sizeof(std::uint64_t), vals.size(), fle);
+        std::fclose(fle);
+    });
+    
+    st.report("read + std::sort + write peak RSS", get_peak_rss() - bse_rss, "MiB");
+    
+    std::remove(src_pth.c_str());
+    std::remove(dest_pth.c_str());
+}
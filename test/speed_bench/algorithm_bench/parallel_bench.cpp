@@ -0,0 +1,128 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/parallel_bench.cpp
+ * @brief       parallel reduce, transform and scan benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 16:25
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of elements of the arrays. */
+constexpr std::size_t NBR_ELEMENTS = 16000000;
+
+
+std::vector<double> make_values()
+{
+    const std::vector<std::int32_t> rnds = speed_bench::make_random_integers<std::int32_t>(
+            NBR_ELEMENTS, -1000000, 1000000);
+    
+    return std::vector<double>(rnds.begin(), rnds.end());
+}
+
+
+}
+
+
+SPEED_BENCH(parallel, reduce)
+{
+    const std::vector<double> src = make_values();
+    
+    st.measure("std::accumulate", src.size(), [&] {
+        speed_bench::do_not_optimize(std::accumulate(src.begin(), src.end(), 0.0));
+    });
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 8})
+    {
+        speed::algorithm::work_stealing_executor exec(nbr_thrds);
+        
+        st.measure("parallel_reduce " + std::to_string(nbr_thrds) + " threads", src.size(), [&] {
+            speed_bench::do_not_optimize(speed::algorithm::parallel_reduce(
+                    src, src.size(), 0.0, std::plus<>(), exec));
+        });
+    }
+}
+
+
+SPEED_BENCH(parallel, transform)
+{
+    const std::vector<double> src = make_values();
+    std::vector<double> dest(src.size());
+    
+    st.measure("std::transform sqrt", src.size(), [&] {
+        std::transform(src.begin(), src.end(), dest.begin(),
+                       [](double x) { return std::sqrt(std::abs(x)); });
+        
+        speed_bench::do_not_optimize(dest);
+    });
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 8})
+    {
+        speed::algorithm::work_stealing_executor exec(nbr_thrds);
+        
+        st.measure("parallel_transform sqrt " + std::to_string(nbr_thrds) + " threads",
+                   src.size(), [&] {
+            speed::algorithm::parallel_transform(src, src.size(), dest,
+                                                 [](double x) { return std::sqrt(std::abs(x)); },
+                                                 exec);
+            
+            speed_bench::do_not_optimize(dest);
+        });
+    }
+}
+
+
+SPEED_BENCH(parallel, inclusive_scan)
+{
+    const std::vector<double> src = make_values();
+    std::vector<double> dest(src.size());
+    
+    st.measure("std::inclusive_scan", src.size(), [&] {
+        std::inclusive_scan(src.begin(), src.end(), dest.begin());
+        
+        speed_bench::do_not_optimize(dest);
+    });
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 8})
+    {
+        speed::algorithm::work_stealing_executor exec(nbr_thrds);
+        
+        st.measure("parallel_inclusive_scan " + std::to_string(nbr_thrds) + " threads",
+                   src.size(), [&] {
+            speed::algorithm::parallel_inclusive_scan(src, src.size(), dest, std::plus<>(), exec);
+            
+            speed_bench::do_not_optimize(dest);
+        });
+    }
+}
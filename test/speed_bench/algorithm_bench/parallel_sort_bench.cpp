@@ -0,0 +1,94 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/parallel_sort_bench.cpp
+ * @brief       parallel_sort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 14:45
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of elements to sort. */
+constexpr std::size_t NBR_ELEMENTS = 8000000;
+
+
+template<typename TpSort>
+void measure_sort(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<std::uint64_t>& src,
+        const TpSort& srt
+)
+{
+    std::vector<std::uint64_t> vals;
+    
+    st.measure(lbl, src.size(), [&] {
+        vals = src;
+    }, [&] {
+        srt(vals);
+    });
+}
+
+
+void measure_threads(speed_bench::state& st, const std::vector<std::uint64_t>& src)
+{
+    measure_sort(st, "std::sort", src, [](auto& vals) {
+        std::sort(vals.begin(), vals.end());
+    });
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 8})
+    {
+        speed::algorithm::work_stealing_executor exec(nbr_thrds);
+        
+        measure_sort(st, "parallel_sort " + std::to_string(nbr_thrds) + " threads", src,
+                     [&](auto& vals) {
+            speed::algorithm::parallel_sort(vals, vals.size(), std::less<>(), exec);
+        });
+    }
+}
+
+
+}
+
+
+SPEED_BENCH(parallel_sort, random)
+{
+    measure_threads(st, speed_bench::make_random_integers<std::uint64_t>(
+            NBR_ELEMENTS, 0, ~std::uint64_t(0)));
+}
+
+
+SPEED_BENCH(parallel_sort, few_distinct)
+{
+    measure_threads(st, speed_bench::make_random_integers<std::uint64_t>(NBR_ELEMENTS, 0, 99));
+}
@@ -0,0 +1,143 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/algorithm_bench/quicksort_bench.cpp
+ * @brief       quicksort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 14:20
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of elements of the integer inputs. */
+constexpr std::size_t NBR_INTEGERS = 2000000;
+
+/** Number of elements of the string inputs. */
+constexpr std::size_t NBR_STRINGS = 300000;
+
+
+std::vector<std::int64_t> make_pattern(const std::string& pattrn)
+{
+    std::vector<std::int64_t> vals = speed_bench::make_random_integers<std::int64_t>(
+            NBR_INTEGERS, 0, 1000000000);
+    
+    if (pattrn == "sorted")
+    {
+        std::sort(vals.begin(), vals.end());
+    }
+    else if (pattrn == "reversed")
+    {
+        std::sort(vals.begin(), vals.end(), std::greater<>());
+    }
+    else if (pattrn == "organ pipe")
+    {
+        std::sort(vals.begin(), vals.begin() + vals.size() / 2);
+        std::sort(vals.begin() + vals.size() / 2, vals.end(), std::greater<>());
+    }
+    else if (pattrn == "sorted + 1% noise")
+    {
+        std::sort(vals.begin(), vals.end());
+        
+        for (std::size_t i = 0; i < vals.size(); i += 100)
+        {
+            vals[i] = vals[(i * 7919) % vals.size()];
+        }
+    }
+    else if (pattrn == "16 distinct")
+    {
+        for (auto& x : vals)
+        {
+            x %= 16;
+        }
+    }
+    
+    return vals;
+}
+
+
+template<typename TpValue, typename TpSort>
+void measure_sort(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<TpValue>& src,
+        const TpSort& srt
+)
+{
+    std::vector<TpValue> vals;
+    
+    st.measure(lbl, src.size(), [&] {
+        vals = src;
+    }, [&] {
+        srt(vals);
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(quicksort, integers)
+{
+    for (const char* pattrn : {"random", "sorted", "reversed", "organ pipe", "sorted + 1% noise",
+                               "16 distinct"})
+    {
+        const std::vector<std::int64_t> src = make_pattern(pattrn);
+        
+        measure_sort(st, std::string("quicksort ") + pattrn, src, [](auto& vals) {
+            speed::algorithm::quicksort(vals, vals.size());
+        });
+        
+        measure_sort(st, std::string("std::sort ") + pattrn, src, [](auto& vals) {
+            std::sort(vals.begin(), vals.end());
+        });
+    }
+}
+
+
+SPEED_BENCH(quicksort, strings)
+{
+    const std::vector<std::uint32_t> rnds = speed_bench::make_random_integers<std::uint32_t>(
+            NBR_STRINGS, 0, 0xffffffff);
+    std::vector<std::string> src;
+    
+    for (auto& x : rnds)
+    {
+        src.push_back("key_" + std::to_string(x));
+    }
+    
+    measure_sort(st, "quicksort random strings", src, [](auto& vals) {
+        speed::algorithm::quicksort(vals, vals.size());
+    });
+    
+    measure_sort(st, "std::sort random strings", src, [](auto& vals) {
+        std::sort(vals.begin(), vals.end());
+    });
+}
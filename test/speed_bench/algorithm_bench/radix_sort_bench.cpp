@@ -0,0 +1,168 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/radix_sort_bench.cpp
+ * @brief       radix_sort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 15:05
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of arithmetic elements to sort. */
+constexpr std::size_t NBR_NUMBERS = 4000000;
+
+/** Number of strings to sort. */
+constexpr std::size_t NBR_STRINGS = 500000;
+
+
+/**
+ * @brief       Record sorted by its key, the stable sort use case.
+ */
+struct record
+{
+    /** The sorting key. */
+    std::int64_t ky;
+    
+    /** The payload. */
+    std::uint64_t pld;
+};
+
+
+template<typename TpValue, typename TpSort>
+void measure_sort(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<TpValue>& src,
+        const TpSort& srt
+)
+{
+    std::vector<TpValue> vals;
+    
+    st.measure(lbl, src.size(), [&] {
+        vals = src;
+    }, [&] {
+        srt(vals);
+    });
+}
+
+
+template<typename TpValue>
+void measure_values(
+        speed_bench::state& st,
+        const std::string& nme,
+        const std::vector<TpValue>& src
+)
+{
+    measure_sort(st, "radix_sort " + nme, src, [](auto& vals) {
+        speed::algorithm::radix_sort(vals, vals.size());
+    });
+    
+    measure_sort(st, "std::stable_sort " + nme, src, [](auto& vals) {
+        std::stable_sort(vals.begin(), vals.end());
+    });
+    
+    measure_sort(st, "std::sort " + nme, src, [](auto& vals) {
+        std::sort(vals.begin(), vals.end());
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(radix_sort, integers)
+{
+    measure_values(st, "uint32", speed_bench::make_random_integers<std::uint32_t>(
+            NBR_NUMBERS, 0, 0xffffffff));
+    
+    measure_values(st, "int64", speed_bench::make_random_integers<std::int64_t>(
+            NBR_NUMBERS, -1000000000000, 1000000000000));
+}
+
+
+SPEED_BENCH(radix_sort, floating_points)
+{
+    const std::vector<std::int64_t> rnds = speed_bench::make_random_integers<std::int64_t>(
+            NBR_NUMBERS, -1000000000, 1000000000);
+    std::vector<double> src;
+    
+    for (auto& x : rnds)
+    {
+        src.push_back(static_cast<double>(x) / 1000.0);
+    }
+    
+    measure_values(st, "double", src);
+}
+
+
+SPEED_BENCH(radix_sort, strings)
+{
+    const std::vector<std::uint32_t> rnds = speed_bench::make_random_integers<std::uint32_t>(
+            NBR_STRINGS * 17, 0, 0xffffffff);
+    std::vector<std::string> src(NBR_STRINGS);
+    std::size_t k = 0;
+    
+    for (auto& x : src)
+    {
+        const std::size_t len = 4 + rnds[k++] % 13;
+        
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            x.push_back(static_cast<char>('a' + rnds[k++] % 26));
+        }
+    }
+    
+    measure_values(st, "strings", src);
+}
+
+
+SPEED_BENCH(radix_sort, records)
+{
+    const std::vector<std::int64_t> kys = speed_bench::make_random_integers<std::int64_t>(
+            NBR_NUMBERS, -1000000, 1000000);
+    std::vector<record> src;
+    
+    for (std::size_t i = 0; i < kys.size(); ++i)
+    {
+        src.push_back({kys[i], i});
+    }
+    
+    measure_sort(st, "radix_sort records", src, [](auto& vals) {
+        speed::algorithm::radix_sort(vals, vals.size(), [](const record& x) { return x.ky; });
+    });
+    
+    measure_sort(st, "std::stable_sort records", src, [](auto& vals) {
+        std::stable_sort(vals.begin(), vals.end(), [](const record& lhs, const record& rhs) {
+            return lhs.ky < rhs.ky;
+        });
+    });
+}
@@ -0,0 +1,115 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/search_bench.cpp
+ * @brief       branchless, Eytzinger and k-ary searches benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 15:45
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of searches of a run. */
+constexpr std::size_t NBR_QUERIES = 2000000;
+
+
+template<typename TpSearch>
+void measure_search(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<std::int32_t>& qrys,
+        const TpSearch& srch
+)
+{
+    st.measure(lbl, qrys.size(), [&] {
+        std::size_t sum = 0;
+        
+        for (auto& x : qrys)
+        {
+            sum += srch(x);
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+}
+
+
+/**
+ * @brief       Search random values in a sorted array of distinct 32 bits integers with every
+ *              algorithm.
+ * @param       sz : The array size, that sets the cache level the array fits in.
+ */
+void measure_size(speed_bench::state& st, std::size_t sz)
+{
+    const std::vector<std::int32_t> qrys = speed_bench::make_random_integers<std::int32_t>(
+            NBR_QUERIES, 0, static_cast<std::int32_t>(sz * 4));
+    const std::string sfx = std::to_string(sz * sizeof(std::int32_t) / 1024) + " KiB";
+    std::vector<std::int32_t> vec(sz);
+    std::vector<std::int32_t> eytz(sz);
+    std::vector<std::int32_t> kary(speed::algorithm::get_kary_layout_size(sz));
+    
+    for (std::size_t i = 0; i < sz; ++i)
+    {
+        vec[i] = static_cast<std::int32_t>(i * 4);
+    }
+    
+    speed::algorithm::make_eytzinger_layout(vec, sz, eytz);
+    speed::algorithm::make_kary_layout(vec, sz, kary);
+    
+    measure_search(st, "std::lower_bound " + sfx, qrys, [&](std::int32_t x) {
+        return static_cast<std::size_t>(std::lower_bound(vec.begin(), vec.end(), x) -
+                                        vec.begin());
+    });
+    
+    measure_search(st, "branchless_lower_bound " + sfx, qrys, [&](std::int32_t x) {
+        return speed::algorithm::branchless_lower_bound(vec, sz, x);
+    });
+    
+    measure_search(st, "eytzinger_lower_bound " + sfx, qrys, [&](std::int32_t x) {
+        return speed::algorithm::eytzinger_lower_bound(eytz, sz, x);
+    });
+    
+    measure_search(st, "kary_lower_bound " + sfx, qrys, [&](std::int32_t x) {
+        return speed::algorithm::kary_lower_bound(kary, kary.size(), x);
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(search, lower_bound)
+{
+    for (std::size_t sz : {1 << 10, 1 << 14, 1 << 18, 1 << 22, 1 << 24})
+    {
+        measure_size(st, sz);
+    }
+}
@@ -0,0 +1,158 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/selection_bench.cpp
+ * @brief       nth_element, partial_sort and top_k benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 16:05
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of elements of the arrays and of the streams. */
+constexpr std::size_t NBR_ELEMENTS = 4000000;
+
+/** Number of elements pushed at once in a top_k. */
+constexpr std::size_t BATCH_SIZE = 1024;
+
+
+template<typename TpSelect>
+void measure_select(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<std::int32_t>& src,
+        const TpSelect& slct
+)
+{
+    std::vector<std::int32_t> vals;
+    
+    st.measure(lbl, src.size(), [&] {
+        vals = src;
+    }, [&] {
+        slct(vals);
+    });
+}
+
+
+std::vector<std::int32_t> make_values()
+{
+    return speed_bench::make_random_integers<std::int32_t>(NBR_ELEMENTS, -1000000000, 1000000000);
+}
+
+
+}
+
+
+SPEED_BENCH(selection, nth_element)
+{
+    const std::vector<std::int32_t> src = make_values();
+    
+    measure_select(st, "nth_element median", src, [](auto& vals) {
+        speed::algorithm::nth_element(vals, vals.size(), vals.size() / 2);
+    });
+    
+    measure_select(st, "std::nth_element median", src, [](auto& vals) {
+        std::nth_element(vals.begin(), vals.begin() + vals.size() / 2, vals.end());
+    });
+}
+
+
+SPEED_BENCH(selection, partial_sort)
+{
+    const std::vector<std::int32_t> src = make_values();
+    
+    for (std::size_t k : {100, 10000, 1000000})
+    {
+        const std::string sfx = " k = " + std::to_string(k);
+        
+        measure_select(st, "partial_sort" + sfx, src, [&](auto& vals) {
+            speed::algorithm::partial_sort(vals, vals.size(), k);
+        });
+        
+        measure_select(st, "std::partial_sort" + sfx, src, [&](auto& vals) {
+            std::partial_sort(vals.begin(), vals.begin() + k, vals.end());
+        });
+    }
+}
+
+
+SPEED_BENCH(selection, top_k)
+{
+    const std::vector<std::int32_t> src = make_values();
+    
+    for (std::size_t k : {10, 100, 1000})
+    {
+        const std::string sfx = " k = " + std::to_string(k);
+        
+        st.measure("top_k batch push" + sfx, src.size(), [&] {
+            speed::algorithm::top_k<std::int32_t> tk(k);
+            
+            for (std::size_t i = 0; i < src.size(); i += BATCH_SIZE)
+            {
+                tk.push(src.data() + i, std::min(BATCH_SIZE, src.size() - i));
+            }
+            
+            speed_bench::do_not_optimize(tk);
+        });
+        
+        st.measure("top_k push" + sfx, src.size(), [&] {
+            speed::algorithm::top_k<std::int32_t> tk(k);
+            
+            for (auto& x : src)
+            {
+                tk.push(x);
+            }
+            
+            speed_bench::do_not_optimize(tk);
+        });
+        
+        st.measure("std::priority_queue" + sfx, src.size(), [&] {
+            std::priority_queue<std::int32_t, std::vector<std::int32_t>, std::greater<>> pq;
+            
+            for (auto& x : src)
+            {
+                if (pq.size() < k)
+                {
+                    pq.push(x);
+                }
+                else if (pq.top() < x)
+                {
+                    pq.pop();
+                    pq.push(x);
+                }
+            }
+            
+            speed_bench::do_not_optimize(pq);
+        });
+    }
+}
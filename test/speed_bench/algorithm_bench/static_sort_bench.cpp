@@ -0,0 +1,124 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/static_sort_bench.cpp
+ * @brief       static_sort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 15:25
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Total number of elements sorted by a run, split in small arrays. */
+constexpr std::size_t NBR_ELEMENTS = 4000000;
+
+
+template<std::size_t N>
+void insertion_sort(std::array<std::int32_t, N>& arr)
+{
+    for (std::size_t i = 1; i < N; ++i)
+    {
+        const std::int32_t val = arr[i];
+        std::size_t j = i;
+        
+        for (; j > 0 && val < arr[j - 1]; --j)
+        {
+            arr[j] = arr[j - 1];
+        }
+        
+        arr[j] = val;
+    }
+}
+
+
+template<std::size_t N, typename TpSort>
+void measure_sort(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<std::array<std::int32_t, N>>& src,
+        const TpSort& srt
+)
+{
+    std::vector<std::array<std::int32_t, N>> arrs;
+    
+    st.measure(lbl + " " + std::to_string(N) + " elements", src.size(), [&] {
+        arrs = src;
+    }, [&] {
+        for (auto& x : arrs)
+        {
+            srt(x);
+        }
+        
+        speed_bench::do_not_optimize(arrs);
+    });
+}
+
+
+/**
+ * @brief       Sort many small arrays of random integers, one sort per operation.
+ */
+template<std::size_t N>
+void measure_size(speed_bench::state& st)
+{
+    const std::vector<std::int32_t> rnds = speed_bench::make_random_integers<std::int32_t>(
+            NBR_ELEMENTS, 0, 1000000);
+    std::vector<std::array<std::int32_t, N>> src(NBR_ELEMENTS / N);
+    
+    for (std::size_t i = 0; i < src.size(); ++i)
+    {
+        std::copy_n(rnds.begin() + i * N, N, src[i].begin());
+    }
+    
+    measure_sort(st, "static_sort", src, [](auto& arr) {
+        speed::algorithm::static_sort<N>(arr);
+    });
+    
+    measure_sort(st, "insertion sort", src, [](auto& arr) {
+        insertion_sort(arr);
+    });
+    
+    measure_sort(st, "std::sort", src, [](auto& arr) {
+        std::sort(arr.begin(), arr.end());
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(static_sort, small_arrays)
+{
+    measure_size<4>(st);
+    measure_size<8>(st);
+    measure_size<16>(st);
+    measure_size<32>(st);
+}
@@ -0,0 +1,187 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/algorithm_bench/timsort_bench.cpp
+ * @brief       timsort, argsort and indirect_sort benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 17:05
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "speed/algorithm.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of integers to sort. */
+constexpr std::size_t NBR_INTEGERS = 2000000;
+
+/** Number of records to sort. */
+constexpr std::size_t NBR_RECORDS = 400000;
+
+
+/**
+ * @brief       Large record, expensive to move, sorted by its key.
+ */
+struct record
+{
+    /** The sorting key. */
+    std::int64_t ky;
+    
+    /** The payload. */
+    std::array<std::uint64_t, 31> pld;
+};
+
+
+bool compare_records(const record& lhs, const record& rhs)
+{
+    return lhs.ky < rhs.ky;
+}
+
+
+template<typename TpValue, typename TpSort>
+void measure_sort(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<TpValue>& src,
+        const TpSort& srt
+)
+{
+    std::vector<TpValue> vals;
+    
+    st.measure(lbl, src.size(), [&] {
+        vals = src;
+    }, [&] {
+        srt(vals);
+    });
+}
+
+
+std::vector<std::int64_t> make_pattern(const std::string& pattrn)
+{
+    std::vector<std::int64_t> vals = speed_bench::make_random_integers<std::int64_t>(
+            NBR_INTEGERS, 0, 1000000000);
+    
+    if (pattrn == "sorted + 1% noise")
+    {
+        std::sort(vals.begin(), vals.end());
+        
+        for (std::size_t i = 0; i < vals.size(); i += 100)
+        {
+            vals[i] = vals[(i * 7919) % vals.size()];
+        }
+    }
+    else if (pattrn == "16 sorted blocks")
+    {
+        for (std::size_t i = 0; i < 16; ++i)
+        {
+            std::sort(vals.begin() + vals.size() * i / 16,
+                      vals.begin() + vals.size() * (i + 1) / 16);
+        }
+    }
+    else if (pattrn == "reversed")
+    {
+        std::sort(vals.begin(), vals.end(), std::greater<>());
+    }
+    
+    return vals;
+}
+
+
+}
+
+
+SPEED_BENCH(timsort, integers)
+{
+    for (const char* pattrn : {"random", "sorted + 1% noise", "16 sorted blocks", "reversed"})
+    {
+        const std::vector<std::int64_t> src = make_pattern(pattrn);
+        
+        measure_sort(st, std::string("timsort ") + pattrn, src, [](auto& vals) {
+            speed::algorithm::timsort(vals, vals.size());
+        });
+        
+        measure_sort(st, std::string("std::stable_sort ") + pattrn, src, [](auto& vals) {
+            std::stable_sort(vals.begin(), vals.end());
+        });
+    }
+}
+
+
+SPEED_BENCH(timsort, argsort)
+{
+    const std::vector<std::int64_t> vals = make_pattern("random");
+    
+    st.measure("argsort", vals.size(), [&] {
+        speed_bench::do_not_optimize(speed::algorithm::argsort(vals, vals.size()));
+    });
+    
+    st.measure("argsort_by_key", vals.size(), [&] {
+        speed_bench::do_not_optimize(speed::algorithm::argsort_by_key(
+                vals, vals.size(), [](std::int64_t x) { return x; }));
+    });
+    
+    st.measure("std::stable_sort of the indexes", vals.size(), [&] {
+        std::vector<std::size_t> idxs(vals.size());
+        
+        std::iota(idxs.begin(), idxs.end(), std::size_t(0));
+        std::stable_sort(idxs.begin(), idxs.end(), [&](std::size_t lhs, std::size_t rhs) {
+            return vals[lhs] < vals[rhs];
+        });
+        
+        speed_bench::do_not_optimize(idxs);
+    });
+}
+
+
+SPEED_BENCH(timsort, records)
+{
+    const std::vector<std::int64_t> kys = speed_bench::make_random_integers<std::int64_t>(
+            NBR_RECORDS, 0, 1000000000);
+    std::vector<record> src(NBR_RECORDS);
+    
+    for (std::size_t i = 0; i < src.size(); ++i)
+    {
+        src[i].ky = kys[i];
+        src[i].pld.fill(i);
+    }
+    
+    measure_sort(st, "indirect_sort 256 B records", src, [](auto& vals) {
+        speed::algorithm::indirect_sort(vals, vals.size(), compare_records);
+    });
+    
+    measure_sort(st, "timsort 256 B records", src, [](auto& vals) {
+        speed::algorithm::timsort(vals, vals.size(), compare_records);
+    });
+    
+    measure_sort(st, "std::stable_sort 256 B records", src, [](auto& vals) {
+        std::stable_sort(vals.begin(), vals.end(), compare_records);
+    });
+}
@@ -0,0 +1,269 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/bench.hpp
+ * @brief       speed_bench harness header.
+ * @author      Killian
+ * @date        2018/10/07 - 09:30
+ */
+
+#ifndef SPEED_BENCH_BENCH_HPP
+#define SPEED_BENCH_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace speed_bench {
+
+
+class state;
+
+
+/** Signature of the benchmark functions. */
+using bench_function = void (*)(state&);
+
+
+/**
+ * @brief       Registered benchmark.
+ */
+struct bench_entry
+{
+    /** The benchmark name, "<group>.<name>". */
+    std::string nme;
+    
+    /** The benchmark function. */
+    bench_function fnc;
+};
+
+
+/**
+ * @brief       Get the registered benchmarks, in registration order.
+ * @return      The registered benchmarks.
+ */
+inline std::vector<bench_entry>& get_registry()
+{
+    static std::vector<bench_entry> entrs;
+    return entrs;
+}
+
+
+/**
+ * @brief       Object whose construction registers a benchmark. It is declared by SPEED_BENCH.
+ */
+struct registrar
+{
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nme : The benchmark name.
+     * @param       fnc : The benchmark function.
+     */
+    registrar(std::string nme, bench_function fnc)
+    {
+        get_registry().push_back({std::move(nme), fnc});
+    }
+};
+
+
+/**
+ * @brief       Prevent the compiler from discarding a value that is computed only to be measured.
+ * @param       val : The value.
+ */
+template<typename T>
+inline void do_not_optimize(const T& val) noexcept
+{
+    asm volatile("" : : "r"(&val) : "memory");
+}
+
+
+/**
+ * @brief       Class passed to the benchmark functions to time and report their measures. Every
+ *              measure is run several times, and the fastest and slowest runs are reported, so
+ *              the spread between runs is visible.
+ */
+class state
+{
+public:
+    /**
+     * @brief       Constructor with parameters.
+     * @param       nbr_rns : The number of times every measure is run.
+     */
+    explicit state(std::size_t nbr_rns)
+            : nbr_rns_(std::max(nbr_rns, std::size_t(1)))
+    {
+    }
+    
+    /**
+     * @brief       Time a function and report the time per operation.
+     * @param       lbl : The label of the measure.
+     * @param       nbr_ops : The number of operations a call of the function performs.
+     * @param       fnc : The function to time.
+     */
+    template<typename TpFunction>
+    void measure(const std::string& lbl, std::size_t nbr_ops, TpFunction&& fnc)
+    {
+        measure(lbl, nbr_ops, [] {}, std::forward<TpFunction>(fnc));
+    }
+    
+    /**
+     * @brief       Time a function and report the time per operation. The setup function is
+     *              called before every run and is not timed, so each run can start from the same
+     *              input.
+     * @param       lbl : The label of the measure.
+     * @param       nbr_ops : The number of operations a call of the function performs.
+     * @param       setup : The function that prepares a run.
+     * @param       fnc : The function to time.
+     */
+    template<typename TpSetup, typename TpFunction>
+    void measure(const std::string& lbl, std::size_t nbr_ops, TpSetup&& setup, TpFunction&& fnc)
+    {
+        using clock_type = std::chrono::steady_clock;
+        
+        double min_ns = 0;
+        double max_ns = 0;
+        
+        nbr_ops = std::max(nbr_ops, std::size_t(1));
+        
+        for (std::size_t i = 0; i < nbr_rns_; ++i)
+        {
+            setup();
+            
+            auto strt = clock_type::now();
+            fnc();
+            auto end = clock_type::now();
+            
+            double ns = std::chrono::duration<double, std::nano>(end - strt).count() /
+                        static_cast<double>(nbr_ops);
+            
+            min_ns = i == 0 ? ns : std::min(min_ns, ns);
+            max_ns = i == 0 ? ns : std::max(max_ns, ns);
+        }
+        
+        print_range(lbl, min_ns, max_ns, "ns/op");
+    }
+    
+    /**
+     * @brief       Report a value that is not a time, such as a size or a rate.
+     * @param       lbl : The label of the value.
+     * @param       val : The value.
+     * @param       unt : The unit of the value.
+     */
+    void report(const std::string& lbl, double val, const std::string& unt) const
+    {
+        print_range(lbl, val, val, unt);
+    }
+    
+    /**
+     * @brief       Get the number of times every measure is run.
+     * @return      The number of times every measure is run.
+     */
+    [[nodiscard]] std::size_t get_runs() const noexcept
+    {
+        return nbr_rns_;
+    }
+
+private:
+    /**
+     * @brief       Print a measure line.
+     * @param       lbl : The label of the measure.
+     * @param       min_val : The smallest value.
+     * @param       max_val : The largest value.
+     * @param       unt : The unit of the values.
+     */
+    static void print_range(
+            const std::string& lbl,
+            double min_val,
+            double max_val,
+            const std::string& unt
+    )
+    {
+        std::cout << "  " << std::left << std::setw(44) << lbl << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << min_val;
+        
+        if (max_val != min_val)
+        {
+            std::cout << " - " << std::left << std::setw(12) << max_val << std::right;
+        }
+        else
+        {
+            std::cout << std::string(15, ' ');
+        }
+        
+        std::cout << ' ' << unt << std::endl;
+    }
+    
+    /** The number of times every measure is run. */
+    std::size_t nbr_rns_;
+};
+
+
+/**
+ * @brief       Get a vector of uniformly distributed random integers. The generator is seeded
+ *              with a constant, so every run measures the same input.
+ * @param       sz : The number of integers.
+ * @param       min_val : The smallest integer.
+ * @param       max_val : The largest integer.
+ * @param       sed : The seed.
+ * @return      The random integers.
+ */
+template<typename TpInteger>
+std::vector<TpInteger> make_random_integers(
+        std::size_t sz,
+        TpInteger min_val,
+        TpInteger max_val,
+        std::uint64_t sed = 42
+)
+{
+    std::mt19937_64 gen(sed);
+    std::uniform_int_distribution<TpInteger> dist(min_val, max_val);
+    std::vector<TpInteger> vals(sz);
+    
+    for (auto& x : vals)
+    {
+        x = dist(gen);
+    }
+    
+    return vals;
+}
+
+
+}
+
+
+/**
+ * @brief       Define a benchmark. The body receives the speed_bench::state as st.
+ * @param       group : The group of the benchmark, usually the benchmarked component.
+ * @param       name : The name of the benchmark within the group.
+ */
+#define SPEED_BENCH(group, name)                                                                  \
+    static void speed_bench_##group##_##name(::speed_bench::state& st);                           \
+    static const ::speed_bench::registrar speed_bench_##group##_##name##_rgstr(                   \
+            #group "." #name, &speed_bench_##group##_##name);                                     \
+    static void speed_bench_##group##_##name([[maybe_unused]] ::speed_bench::state& st)
+
+
+#endif
@@ -0,0 +1,193 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/concurrency_bench/future_bench.cpp
+ * @brief       future and promise benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 18:25
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <string>
+
+#include "speed/concurrency.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of operations of the single thread measures. */
+constexpr std::size_t NBR_OPERATIONS = 1000000;
+
+/** Number of operations of the measures that cross threads. */
+constexpr std::size_t NBR_HANDOFFS = 20000;
+
+
+/** Number of allocations done through operator new since the program started. */
+std::atomic<std::uint64_t> nbr_allocs(0);
+
+
+/**
+ * @brief       Time a function and report the number of allocations it does per operation.
+ */
+template<typename TpFunction>
+void measure_allocations(
+        speed_bench::state& st,
+        const std::string& lbl,
+        std::size_t nbr_ops,
+        const TpFunction& fnc
+)
+{
+    std::uint64_t fir_allocs = nbr_allocs.load();
+    
+    st.measure(lbl, nbr_ops, fnc);
+    st.report(lbl + " allocations",
+              static_cast<double>(nbr_allocs.load() - fir_allocs) / (nbr_ops * st.get_runs()),
+              "per op");
+}
+
+
+}
+
+
+/**
+ * @brief       Count the allocations of the whole program. The counter is a relaxed atomic, so
+ *              the other benchmarks only pay an uncontended increment per allocation.
+ */
+void* operator new(std::size_t sz)
+{
+    nbr_allocs.fetch_add(1, std::memory_order_relaxed);
+    
+    if (void* ptr = std::malloc(sz == 0 ? 1 : sz))
+    {
+        return ptr;
+    }
+    
+    throw std::bad_alloc();
+}
+
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+SPEED_BENCH(future, round_trip)
+{
+    measure_allocations(st, "std::promise round trip", NBR_OPERATIONS, [&] {
+        for (std::size_t i = 0; i < NBR_OPERATIONS; ++i)
+        {
+            std::promise<int> prm;
+            std::future<int> fut = prm.get_future();
+            
+            prm.set_value(1);
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+    
+    measure_allocations(st, "promise round trip", NBR_OPERATIONS, [&] {
+        for (std::size_t i = 0; i < NBR_OPERATIONS; ++i)
+        {
+            speed::concurrency::promise<int> prm;
+            speed::concurrency::future<int> fut = prm.get_future();
+            
+            prm.set_value(1);
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+    
+    measure_allocations(st, "make_ready_future", NBR_OPERATIONS, [&] {
+        for (std::size_t i = 0; i < NBR_OPERATIONS; ++i)
+        {
+            speed_bench::do_not_optimize(speed::concurrency::make_ready_future(1).get());
+        }
+    });
+}
+
+
+SPEED_BENCH(future, continuation)
+{
+    measure_allocations(st, "then inline", NBR_OPERATIONS, [&] {
+        for (std::size_t i = 0; i < NBR_OPERATIONS; ++i)
+        {
+            speed::concurrency::promise<int> prm;
+            auto fut = prm.get_future().then([](speed::concurrency::future<int> x) {
+                return x.get() + 1;
+            });
+            
+            prm.set_value(1);
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+    
+    measure_allocations(st, "then on a ready future", NBR_OPERATIONS, [&] {
+        for (std::size_t i = 0; i < NBR_OPERATIONS; ++i)
+        {
+            auto fut = speed::concurrency::make_ready_future(1).then(
+                    [](speed::concurrency::future<int> x) { return x.get() + 1; });
+            
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+}
+
+
+SPEED_BENCH(future, handoff)
+{
+    speed::concurrency::thread_pool pool(1);
+    
+    measure_allocations(st, "std::async continuation", NBR_HANDOFFS, [&] {
+        for (std::size_t i = 0; i < NBR_HANDOFFS; ++i)
+        {
+            std::promise<int> prm;
+            std::future<int> src = prm.get_future();
+            auto fut = std::async(std::launch::async, [&src] { return src.get() + 1; });
+            
+            prm.set_value(1);
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+    
+    measure_allocations(st, "then on a thread_pool", NBR_HANDOFFS, [&] {
+        for (std::size_t i = 0; i < NBR_HANDOFFS; ++i)
+        {
+            speed::concurrency::promise<int> prm;
+            auto fut = prm.get_future().then(pool, [](speed::concurrency::future<int> x) {
+                return x.get() + 1;
+            });
+            
+            prm.set_value(1);
+            speed_bench::do_not_optimize(fut.get());
+        }
+    });
+}
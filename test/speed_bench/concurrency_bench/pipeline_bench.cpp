@@ -0,0 +1,244 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/concurrency_bench/pipeline_bench.cpp
+ * @brief       pipeline benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 18:40
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "speed/concurrency.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of workers of the pool. */
+constexpr std::size_t NBR_WORKERS = 4;
+
+/** Number of items going through the pipelines. */
+constexpr std::uint64_t NBR_ITEMS = 200000;
+
+/** Number of items in flight, and capacity of the queues of the baseline. */
+constexpr std::size_t NBR_TOKENS = 16;
+
+
+using speed::concurrency::flow_control;
+using speed::concurrency::make_stage;
+using speed::concurrency::stage_modes;
+
+
+/**
+ * @brief       Burn a number of iterations that the compiler cannot fold.
+ */
+std::uint64_t spin(std::uint64_t val, std::uint64_t nbr_spns)
+{
+    for (std::uint64_t i = 0; i < nbr_spns; ++i)
+    {
+        val = val * 6364136223846793005ULL + 1442695040888963407ULL;
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+    
+    return val;
+}
+
+
+/**
+ * @brief       Bounded queue behind a mutex and two condition variables, the usual baseline.
+ */
+class bounded_queue
+{
+public:
+    void push(std::uint64_t val)
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        not_full_cv_.wait(lck, [&] { return q_.size() < NBR_TOKENS; });
+        q_.push_back(val);
+        lck.unlock();
+        not_empty_cv_.notify_one();
+    }
+    
+    std::uint64_t pop()
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        not_empty_cv_.wait(lck, [&] { return !q_.empty(); });
+        const std::uint64_t val = q_.front();
+        q_.pop_front();
+        lck.unlock();
+        not_full_cv_.notify_one();
+        
+        return val;
+    }
+
+private:
+    std::deque<std::uint64_t> q_;
+    
+    std::mutex mtx_;
+    
+    std::condition_variable not_empty_cv_;
+    
+    std::condition_variable not_full_cv_;
+};
+
+
+/**
+ * @brief       Run a source, two transforms and a sink with one thread per stage. Every item is
+ *              shifted by one so that zero marks the end of the stream.
+ */
+std::uint64_t run_thread_per_stage(std::uint64_t nbr_spns)
+{
+    bounded_queue qs[3];
+    std::uint64_t sum = 0;
+    std::vector<std::thread> thrds;
+    
+    thrds.emplace_back([&] {
+        for (std::uint64_t i = 1; i <= NBR_ITEMS; ++i)
+        {
+            qs[0].push(spin(i, nbr_spns) | 1);
+        }
+        
+        qs[0].push(0);
+    });
+    
+    for (std::size_t j = 0; j < 2; ++j)
+    {
+        thrds.emplace_back([&, j] {
+            std::uint64_t val;
+            
+            while ((val = qs[j].pop()) != 0)
+            {
+                qs[j + 1].push(spin(val, nbr_spns) | 1);
+            }
+            
+            qs[j + 1].push(0);
+        });
+    }
+    
+    std::uint64_t val;
+    
+    while ((val = qs[2].pop()) != 0)
+    {
+        sum += spin(val, nbr_spns);
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+    
+    return sum;
+}
+
+
+void measure_pipelines(speed_bench::state& st, std::uint64_t nbr_spns)
+{
+    const std::string sfx = " work " + std::to_string(nbr_spns) + " spins";
+    speed::concurrency::thread_pool pool(NBR_WORKERS);
+    std::uint64_t i;
+    std::uint64_t sum;
+    
+    auto make_pipeline = [&](bool tme_stges) {
+        return speed::concurrency::pipeline(
+                pool,
+                make_stage<void, std::uint64_t>(stage_modes::SERIAL_IN_ORDER,
+                                                [&](flow_control& fc) {
+                    if (i == NBR_ITEMS)
+                    {
+                        fc.stop();
+                    }
+                    
+                    return spin(++i, nbr_spns);
+                }) |
+                make_stage<std::uint64_t, std::uint64_t>(stage_modes::PARALLEL,
+                                                         [&](std::uint64_t val) {
+                    return spin(val, nbr_spns);
+                }) |
+                make_stage<std::uint64_t, std::uint64_t>(stage_modes::PARALLEL,
+                                                         [&](std::uint64_t val) {
+                    return spin(val, nbr_spns);
+                }) |
+                make_stage<std::uint64_t, void>(stage_modes::SERIAL_IN_ORDER,
+                                                [&](std::uint64_t val) {
+                    sum += spin(val, nbr_spns);
+                }),
+                NBR_TOKENS,
+                tme_stges);
+    };
+    
+    speed::concurrency::pipeline pl = make_pipeline(false);
+    speed::concurrency::pipeline tmd_pl = make_pipeline(true);
+    
+    st.measure("pipeline" + sfx, NBR_ITEMS, [&] {
+        i = 0;
+        sum = 0;
+    }, [&] {
+        pl.run();
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("pipeline timed stages" + sfx, NBR_ITEMS, [&] {
+        i = 0;
+        sum = 0;
+    }, [&] {
+        tmd_pl.run();
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("thread per stage" + sfx, NBR_ITEMS, [&] {
+        speed_bench::do_not_optimize(run_thread_per_stage(nbr_spns));
+    });
+    
+    const std::vector<speed::concurrency::pipeline_stage_statistics> stats =
+            tmd_pl.get_statistics();
+    
+    for (std::size_t j = 0; j < stats.size(); ++j)
+    {
+        st.report("pipeline stage " + std::to_string(j) + " average queue" + sfx,
+                  stats[j].avg_q_sz, "tokens");
+    }
+}
+
+
+}
+
+
+SPEED_BENCH(pipeline, no_work)
+{
+    measure_pipelines(st, 0);
+}
+
+
+SPEED_BENCH(pipeline, light_work)
+{
+    measure_pipelines(st, 200);
+}
@@ -0,0 +1,200 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/concurrency_bench/thread_pool_bench.cpp
+ * @brief       thread_pool and task_group benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 17:45
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "speed/concurrency.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of workers of the pools. */
+constexpr std::size_t NBR_WORKERS = 4;
+
+/** Number of integers of the parallel quicksort. */
+constexpr std::size_t NBR_INTEGERS = 4000000;
+
+/** Size under which the parallel quicksort sorts sequentially. */
+constexpr std::size_t QUICKSORT_CUTOFF = 2048;
+
+/** Number of tasks submitted from outside the pool. */
+constexpr std::size_t NBR_SUBMITS = 1000000;
+
+
+/**
+ * @brief       Compute a Fibonacci number with a task per call, the classic spawn overhead test.
+ */
+std::uint64_t pool_fibonacci(speed::concurrency::thread_pool& pool, int n)
+{
+    if (n < 2)
+    {
+        return static_cast<std::uint64_t>(n);
+    }
+    
+    speed::concurrency::task_group grp(pool);
+    std::uint64_t x;
+    std::uint64_t y;
+    
+    grp.spawn([&] { x = pool_fibonacci(pool, n - 1); });
+    y = pool_fibonacci(pool, n - 2);
+    grp.wait();
+    
+    return x + y;
+}
+
+
+std::uint64_t async_fibonacci(int n)
+{
+    if (n < 2)
+    {
+        return static_cast<std::uint64_t>(n);
+    }
+    
+    auto x = std::async(std::launch::async, async_fibonacci, n - 1);
+    std::uint64_t y = async_fibonacci(n - 2);
+    
+    return x.get() + y;
+}
+
+
+std::uint64_t get_nbr_calls(int n)
+{
+    return n < 2 ? 1 : 1 + get_nbr_calls(n - 1) + get_nbr_calls(n - 2);
+}
+
+
+void pool_quicksort(speed::concurrency::thread_pool& pool, std::int32_t* fir, std::int32_t* lst)
+{
+    if (lst - fir < static_cast<std::ptrdiff_t>(QUICKSORT_CUTOFF))
+    {
+        std::sort(fir, lst);
+        return;
+    }
+    
+    const std::int32_t pvt = fir[(lst - fir) / 2];
+    std::int32_t* mid = std::partition(fir, lst, [pvt](std::int32_t x) { return x < pvt; });
+    std::int32_t* hi = std::partition(mid, lst, [pvt](std::int32_t x) { return x == pvt; });
+    speed::concurrency::task_group grp(pool);
+    
+    grp.spawn([&] { pool_quicksort(pool, fir, mid); });
+    pool_quicksort(pool, hi, lst);
+    grp.wait();
+}
+
+
+void async_quicksort(std::int32_t* fir, std::int32_t* lst)
+{
+    if (lst - fir < static_cast<std::ptrdiff_t>(QUICKSORT_CUTOFF))
+    {
+        std::sort(fir, lst);
+        return;
+    }
+    
+    const std::int32_t pvt = fir[(lst - fir) / 2];
+    std::int32_t* mid = std::partition(fir, lst, [pvt](std::int32_t x) { return x < pvt; });
+    std::int32_t* hi = std::partition(mid, lst, [pvt](std::int32_t x) { return x == pvt; });
+    
+    auto lo_ftr = std::async(std::launch::async, async_quicksort, fir, mid);
+    async_quicksort(hi, lst);
+    lo_ftr.get();
+}
+
+
+}
+
+
+SPEED_BENCH(thread_pool, fibonacci)
+{
+    speed::concurrency::thread_pool pool(NBR_WORKERS);
+    
+    for (int n : {20, 25, 30})
+    {
+        st.measure("task_group fib(" + std::to_string(n) + ") per call", get_nbr_calls(n), [&] {
+            speed_bench::do_not_optimize(pool_fibonacci(pool, n));
+        });
+    }
+    
+    st.measure("std::async fib(16) per call", get_nbr_calls(16), [&] {
+        speed_bench::do_not_optimize(async_fibonacci(16));
+    });
+}
+
+
+SPEED_BENCH(thread_pool, submit)
+{
+    speed::concurrency::thread_pool pool(NBR_WORKERS);
+    std::atomic<std::size_t> cnt(0);
+    
+    st.measure("submit from outside the pool", NBR_SUBMITS, [&] {
+        cnt.store(0);
+        
+        for (std::size_t i = 0; i < NBR_SUBMITS; ++i)
+        {
+            pool.submit([&] { cnt.fetch_add(1, std::memory_order_relaxed); });
+        }
+        
+        while (cnt.load() != NBR_SUBMITS)
+        {
+            std::this_thread::yield();
+        }
+    });
+}
+
+
+SPEED_BENCH(thread_pool, quicksort)
+{
+    const std::vector<std::int32_t> src = speed_bench::make_random_integers<std::int32_t>(
+            NBR_INTEGERS, 0, 1000000000);
+    speed::concurrency::thread_pool pool(NBR_WORKERS);
+    std::vector<std::int32_t> vals;
+    
+    st.measure("task_group quicksort", src.size(), [&] {
+        vals = src;
+    }, [&] {
+        pool_quicksort(pool, vals.data(), vals.data() + vals.size());
+    });
+    
+    st.measure("std::async quicksort", src.size(), [&] {
+        vals = src;
+    }, [&] {
+        async_quicksort(vals.data(), vals.data() + vals.size());
+    });
+    
+    st.measure("std::sort", src.size(), [&] {
+        vals = src;
+    }, [&] {
+        std::sort(vals.begin(), vals.end());
+    });
+}
@@ -0,0 +1,259 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/containers_bench/btree_map_bench.cpp
+ * @brief       btree_map benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 10:40
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "speed/containers/btree_map.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of keys in the maps. */
+constexpr std::size_t NBR_KEYS = 1000000;
+
+/** Number of bytes currently allocated through counting_allocator. */
+std::size_t nbr_allocd_byts = 0;
+
+
+/**
+ * @brief       Allocator that counts the bytes it currently holds.
+ */
+template<typename T>
+struct counting_allocator
+{
+    using value_type = T;
+    
+    template<typename U>
+    struct rebind
+    {
+        using other = counting_allocator<U>;
+    };
+    
+    counting_allocator() noexcept = default;
+    
+    template<typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept
+    {
+    }
+    
+    T* allocate(std::size_t n)
+    {
+        nbr_allocd_byts += n * sizeof(T);
+        return std::allocator<T>().allocate(n);
+    }
+    
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        nbr_allocd_byts -= n * sizeof(T);
+        std::allocator<T>().deallocate(ptr, n);
+    }
+    
+    template<typename U>
+    bool operator ==(const counting_allocator<U>&) const noexcept
+    {
+        return true;
+    }
+    
+    template<typename U>
+    bool operator !=(const counting_allocator<U>&) const noexcept
+    {
+        return false;
+    }
+};
+
+
+using btree_map_type = speed::containers::btree_map<std::uint64_t, std::uint64_t>;
+
+using std_map_type = std::map<std::uint64_t, std::uint64_t>;
+
+
+std::vector<std::uint64_t> make_keys()
+{
+    std::vector<std::uint64_t> kys = speed_bench::make_random_integers<std::uint64_t>(
+            NBR_KEYS, 0, std::numeric_limits<std::uint64_t>::max());
+    
+    std::sort(kys.begin(), kys.end());
+    kys.erase(std::unique(kys.begin(), kys.end()), kys.end());
+    std::shuffle(kys.begin(), kys.end(), std::mt19937_64(3));
+    
+    return kys;
+}
+
+
+template<typename TpMap>
+void fill(TpMap& mp, const std::vector<std::uint64_t>& kys)
+{
+    for (auto& x : kys)
+    {
+        mp[x] = x;
+    }
+}
+
+
+}
+
+
+SPEED_BENCH(btree_map, insert)
+{
+    const std::vector<std::uint64_t> kys = make_keys();
+    
+    st.measure("btree_map random insert", kys.size(), [&] {
+        btree_map_type mp;
+        
+        fill(mp, kys);
+        speed_bench::do_not_optimize(mp);
+    });
+    
+    st.measure("std::map random insert", kys.size(), [&] {
+        std_map_type mp;
+        
+        fill(mp, kys);
+        speed_bench::do_not_optimize(mp);
+    });
+}
+
+
+SPEED_BENCH(btree_map, find)
+{
+    const std::vector<std::uint64_t> kys = make_keys();
+    btree_map_type btree_mp;
+    std_map_type std_mp;
+    
+    fill(btree_mp, kys);
+    fill(std_mp, kys);
+    
+    st.measure("btree_map random find", kys.size(), [&] {
+        std::uint64_t sum = 0;
+        
+        for (auto& x : kys)
+        {
+            sum += *btree_mp.find(x);
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("std::map random find", kys.size(), [&] {
+        std::uint64_t sum = 0;
+        
+        for (auto& x : kys)
+        {
+            sum += std_mp.find(x)->second;
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("btree_map ordered scan", kys.size(), [&] {
+        std::uint64_t sum = 0;
+        
+        for (auto& x : btree_mp)
+        {
+            sum += x;
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("std::map ordered scan", kys.size(), [&] {
+        std::uint64_t sum = 0;
+        
+        for (auto& x : std_mp)
+        {
+            sum += x.second;
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+}
+
+
+SPEED_BENCH(btree_map, bulk_load)
+{
+    std::vector<std::uint64_t> kys = make_keys();
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> srtd_vals;
+    
+    std::sort(kys.begin(), kys.end());
+    
+    for (auto& x : kys)
+    {
+        srtd_vals.emplace_back(x, x);
+    }
+    
+    st.measure("btree_map bulk_load", srtd_vals.size(), [&] {
+        btree_map_type mp(srtd_vals.begin(), srtd_vals.end());
+        
+        speed_bench::do_not_optimize(mp);
+    });
+    
+    st.measure("btree_map sorted insert", kys.size(), [&] {
+        btree_map_type mp;
+        
+        fill(mp, kys);
+        speed_bench::do_not_optimize(mp);
+    });
+    
+    st.measure("std::map sorted insert", kys.size(), [&] {
+        std_map_type mp;
+        
+        fill(mp, kys);
+        speed_bench::do_not_optimize(mp);
+    });
+}
+
+
+SPEED_BENCH(btree_map, memory)
+{
+    const std::vector<std::uint64_t> kys = make_keys();
+    
+    {
+        speed::containers::btree_map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>, 256,
+                counting_allocator<int>> mp;
+        
+        fill(mp, kys);
+        st.report("btree_map random insert",
+                  static_cast<double>(nbr_allocd_byts) / kys.size(), "bytes/element");
+    }
+    
+    {
+        std::map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>,
+                counting_allocator<std::pair<const std::uint64_t, std::uint64_t>>> mp;
+        
+        fill(mp, kys);
+        st.report("std::map random insert",
+                  static_cast<double>(nbr_allocd_byts) / kys.size(), "bytes/element");
+    }
+}
@@ -0,0 +1,205 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/containers_bench/concurrent_unordered_map_bench.cpp
+ * @brief       concurrent_unordered_map benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 11:25
+ */
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "speed/containers/concurrent_unordered_map.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of distinct keys the operations draw from. Half of them are in the map at start. */
+constexpr std::uint64_t KEY_RANGE = 1 << 21;
+
+/** Total number of operations of a run, split evenly over the threads. */
+constexpr std::size_t NBR_OPS = 2000000;
+
+
+/**
+ * @brief       std::unordered_map behind a reader-writer lock, the usual baseline.
+ */
+class locked_map
+{
+public:
+    bool find(std::uint64_t ky, std::uint64_t* val)
+    {
+        std::shared_lock<std::shared_mutex> lck(mtx_);
+        auto it = mp_.find(ky);
+        
+        if (it == mp_.end())
+        {
+            return false;
+        }
+        
+        *val = it->second;
+        return true;
+    }
+    
+    void insert_or_assign(std::uint64_t ky, std::uint64_t val)
+    {
+        std::unique_lock<std::shared_mutex> lck(mtx_);
+        
+        mp_.insert_or_assign(ky, val);
+    }
+    
+    void erase(std::uint64_t ky)
+    {
+        std::unique_lock<std::shared_mutex> lck(mtx_);
+        
+        mp_.erase(ky);
+    }
+
+private:
+    std::unordered_map<std::uint64_t, std::uint64_t> mp_;
+    
+    std::shared_mutex mtx_;
+};
+
+
+template<typename TpFunction>
+void run_threads(std::size_t nbr_thrds, const TpFunction& fnc)
+{
+    std::vector<std::thread> thrds;
+    
+    for (std::size_t i = 0; i < nbr_thrds; ++i)
+    {
+        thrds.emplace_back(fnc, i);
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+}
+
+
+/**
+ * @brief       Run a mix of finds and writes on a map from several threads.
+ * @param       mp : The map, filled with the even keys.
+ * @param       kys : The key of every operation.
+ * @param       nbr_thrds : The number of threads.
+ * @param       wrt_pct : The percentage of operations that write, half inserts and half erases.
+ */
+template<typename TpMap>
+void run_mix(
+        TpMap& mp,
+        const std::vector<std::uint64_t>& kys,
+        std::size_t nbr_thrds,
+        std::uint64_t wrt_pct
+)
+{
+    run_threads(nbr_thrds, [&](std::size_t thrd_idx) {
+        const std::size_t fir = kys.size() * thrd_idx / nbr_thrds;
+        const std::size_t lst = kys.size() * (thrd_idx + 1) / nbr_thrds;
+        std::uint64_t sum = 0;
+        std::uint64_t val;
+        
+        for (std::size_t i = fir; i < lst; ++i)
+        {
+            const std::uint64_t ky = kys[i];
+            const std::uint64_t op = (ky >> 32) % 100;
+            
+            if (op < wrt_pct / 2)
+            {
+                mp.insert_or_assign(ky % KEY_RANGE, ky);
+            }
+            else if (op < wrt_pct)
+            {
+                mp.erase(ky % KEY_RANGE);
+            }
+            else if (mp.find(ky % KEY_RANGE, &val))
+            {
+                sum += val;
+            }
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+}
+
+
+template<typename TpMap>
+void fill(TpMap& mp)
+{
+    for (std::uint64_t i = 0; i < KEY_RANGE; i += 2)
+    {
+        mp.insert_or_assign(i, i);
+    }
+}
+
+
+void measure_mix(speed_bench::state& st, std::uint64_t wrt_pct)
+{
+    const std::vector<std::uint64_t> kys = speed_bench::make_random_integers<std::uint64_t>(
+            NBR_OPS, 0, ~std::uint64_t(0));
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 8})
+    {
+        const std::string sfx = std::to_string(nbr_thrds) + " threads";
+        speed::containers::concurrent_unordered_map<std::uint64_t, std::uint64_t> cncrnt_mp;
+        locked_map lckd_mp;
+        
+        fill(cncrnt_mp);
+        fill(lckd_mp);
+        
+        st.measure("concurrent_unordered_map " + sfx, NBR_OPS, [&] {
+            run_mix(cncrnt_mp, kys, nbr_thrds, wrt_pct);
+        });
+        
+        st.measure("unordered_map+shared_mutex " + sfx, NBR_OPS, [&] {
+            run_mix(lckd_mp, kys, nbr_thrds, wrt_pct);
+        });
+    }
+}
+
+
+}
+
+
+SPEED_BENCH(concurrent_unordered_map, read_only)
+{
+    measure_mix(st, 0);
+}
+
+
+SPEED_BENCH(concurrent_unordered_map, read_mostly)
+{
+    measure_mix(st, 10);
+}
+
+
+SPEED_BENCH(concurrent_unordered_map, write_heavy)
+{
+    measure_mix(st, 50);
+}
@@ -0,0 +1,221 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/containers_bench/d_ary_heap_bench.cpp
+ * @brief       d_ary_heap benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 10:05
+ */
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "speed/containers/d_ary_heap.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of vertices of the benchmark graph. */
+constexpr std::size_t NBR_VERTICES = 200000;
+
+/** Number of out edges of every vertex. */
+constexpr std::size_t NBR_EDGES_PER_VERTEX = 8;
+
+/** Distance of the vertices that are not reached yet. */
+constexpr std::uint64_t INFINITE_DISTANCE = std::numeric_limits<std::uint64_t>::max();
+
+
+/**
+ * @brief       Random directed graph in compressed sparse row form.
+ */
+struct graph
+{
+    /** Target vertex of every edge, grouped by source vertex. */
+    std::vector<std::uint32_t> trgts;
+    
+    /** Weight of every edge. */
+    std::vector<std::uint32_t> wghts;
+};
+
+
+graph make_graph()
+{
+    const std::size_t nbr_edgs = NBR_VERTICES * NBR_EDGES_PER_VERTEX;
+    
+    return {speed_bench::make_random_integers<std::uint32_t>(
+                    nbr_edgs, 0, NBR_VERTICES - 1, 1),
+            speed_bench::make_random_integers<std::uint32_t>(nbr_edgs, 1, 1000, 2)};
+}
+
+
+template<std::size_t D>
+std::uint64_t dijkstra_decrease_key(const graph& grph)
+{
+    std::vector<std::uint64_t> dists(NBR_VERTICES, INFINITE_DISTANCE);
+    speed::containers::d_ary_heap<std::uint64_t, D> hp(dists.begin(), dists.end());
+    std::uint64_t sum = 0;
+    
+    dists[0] = 0;
+    hp.decrease_key(0, 0);
+    
+    while (!hp.empty() && hp.top() != INFINITE_DISTANCE)
+    {
+        const std::size_t u = hp.top_handle();
+        const std::uint64_t dist = hp.top();
+        
+        hp.pop();
+        sum += dist;
+        
+        for (std::size_t i = u * NBR_EDGES_PER_VERTEX; i < (u + 1) * NBR_EDGES_PER_VERTEX; ++i)
+        {
+            const std::uint32_t v = grph.trgts[i];
+            const std::uint64_t new_dist = dist + grph.wghts[i];
+            
+            if (new_dist < dists[v] && hp.contains(v))
+            {
+                dists[v] = new_dist;
+                hp.decrease_key(v, new_dist);
+            }
+        }
+    }
+    
+    return sum;
+}
+
+
+std::uint64_t dijkstra_lazy_deletion(const graph& grph)
+{
+    using entry_type = std::pair<std::uint64_t, std::uint32_t>;
+    
+    std::vector<std::uint64_t> dists(NBR_VERTICES, INFINITE_DISTANCE);
+    std::vector<bool> dn(NBR_VERTICES, false);
+    std::priority_queue<entry_type, std::vector<entry_type>, std::greater<entry_type>> hp;
+    std::uint64_t sum = 0;
+    
+    dists[0] = 0;
+    hp.push({0, 0});
+    
+    while (!hp.empty())
+    {
+        const auto [dist, u] = hp.top();
+        
+        hp.pop();
+        
+        if (dn[u])
+        {
+            continue;
+        }
+        
+        dn[u] = true;
+        sum += dist;
+        
+        for (std::size_t i = u * NBR_EDGES_PER_VERTEX; i < (u + 1) * NBR_EDGES_PER_VERTEX; ++i)
+        {
+            const std::uint32_t v = grph.trgts[i];
+            const std::uint64_t new_dist = dist + grph.wghts[i];
+            
+            if (new_dist < dists[v])
+            {
+                dists[v] = new_dist;
+                hp.push({new_dist, v});
+            }
+        }
+    }
+    
+    return sum;
+}
+
+
+std::vector<std::uint64_t> make_keys()
+{
+    return speed_bench::make_random_integers<std::uint64_t>(
+            1000000, 0, std::numeric_limits<std::uint64_t>::max());
+}
+
+
+}
+
+
+SPEED_BENCH(d_ary_heap, dijkstra)
+{
+    const graph grph = make_graph();
+    const std::size_t nbr_ops = NBR_VERTICES * NBR_EDGES_PER_VERTEX;
+    
+    st.measure("d_ary_heap<2> decrease_key", nbr_ops, [&] {
+        speed_bench::do_not_optimize(dijkstra_decrease_key<2>(grph));
+    });
+    
+    st.measure("d_ary_heap<4> decrease_key", nbr_ops, [&] {
+        speed_bench::do_not_optimize(dijkstra_decrease_key<4>(grph));
+    });
+    
+    st.measure("d_ary_heap<8> decrease_key", nbr_ops, [&] {
+        speed_bench::do_not_optimize(dijkstra_decrease_key<8>(grph));
+    });
+    
+    st.measure("std::priority_queue lazy deletion", nbr_ops, [&] {
+        speed_bench::do_not_optimize(dijkstra_lazy_deletion(grph));
+    });
+}
+
+
+SPEED_BENCH(d_ary_heap, push_pop)
+{
+    const std::vector<std::uint64_t> kys = make_keys();
+    
+    st.measure("d_ary_heap<4> push + pop", kys.size(), [&] {
+        speed::containers::d_ary_heap<std::uint64_t, 4> hp;
+        
+        hp.reserve(kys.size());
+        
+        for (auto& x : kys)
+        {
+            hp.push(x);
+        }
+        
+        while (!hp.empty())
+        {
+            speed_bench::do_not_optimize(hp.top());
+            hp.pop();
+        }
+    });
+    
+    st.measure("std::priority_queue push + pop", kys.size(), [&] {
+        std::priority_queue<std::uint64_t, std::vector<std::uint64_t>,
+                std::greater<std::uint64_t>> hp;
+        
+        for (auto& x : kys)
+        {
+            hp.push(x);
+        }
+        
+        while (!hp.empty())
+        {
+            speed_bench::do_not_optimize(hp.top());
+            hp.pop();
+        }
+    });
+}
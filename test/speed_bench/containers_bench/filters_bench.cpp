@@ -0,0 +1,183 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/containers_bench/filters_bench.cpp
+ * @brief       blocked_bloom_filter and cuckoo_filter benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 12:10
+ */
+
+#include <cstdint>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "speed/containers/blocked_bloom_filter.hpp"
+#include "speed/containers/cuckoo_filter.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of keys inserted in the filters. */
+constexpr std::size_t NBR_KEYS = 4000000;
+
+/** Target false-positive rate of the filters. */
+constexpr double FALSE_POSITIVE_RATE = 0.01;
+
+
+/**
+ * @brief       Inserted keys and probes. The inserted keys are even and the missing keys odd.
+ */
+struct key_sets
+{
+    /** The inserted keys. */
+    std::vector<std::uint64_t> prsnt;
+    
+    /** Keys that are not inserted. */
+    std::vector<std::uint64_t> mssng;
+};
+
+
+key_sets make_key_sets()
+{
+    key_sets kys = {speed_bench::make_random_integers<std::uint64_t>(
+                            NBR_KEYS, 0, ~std::uint64_t(0), 1),
+                    speed_bench::make_random_integers<std::uint64_t>(
+                            NBR_KEYS, 0, ~std::uint64_t(0), 2)};
+    
+    for (auto& x : kys.prsnt)
+    {
+        x &= ~std::uint64_t(1);
+    }
+    
+    for (auto& x : kys.mssng)
+    {
+        x |= 1;
+    }
+    
+    return kys;
+}
+
+
+template<typename TpFilter>
+void measure_filter(
+        speed_bench::state& st,
+        const std::string& nme,
+        const TpFilter& fltr,
+        const key_sets& kys
+)
+{
+    std::size_t nbr_fls_pstvs = 0;
+    
+    st.measure(nme + " negative probe", kys.mssng.size(), [&] {
+        nbr_fls_pstvs = 0;
+        
+        for (auto& x : kys.mssng)
+        {
+            nbr_fls_pstvs += fltr.contains(x);
+        }
+        
+        speed_bench::do_not_optimize(nbr_fls_pstvs);
+    });
+    
+    st.measure(nme + " positive probe", kys.prsnt.size(), [&] {
+        std::size_t nbr_fnd = 0;
+        
+        for (auto& x : kys.prsnt)
+        {
+            nbr_fnd += fltr.contains(x);
+        }
+        
+        speed_bench::do_not_optimize(nbr_fnd);
+    });
+    
+    st.report(nme + " false-positive rate",
+              100.0 * static_cast<double>(nbr_fls_pstvs) / kys.mssng.size(), "%");
+    st.report(nme + " size", 8.0 * fltr.get_size_in_bytes() / kys.prsnt.size(), "bits/key");
+}
+
+
+}
+
+
+SPEED_BENCH(filters, probe)
+{
+    const key_sets kys = make_key_sets();
+    speed::containers::blocked_bloom_filter<std::uint64_t> blm(NBR_KEYS, FALSE_POSITIVE_RATE);
+    speed::containers::cuckoo_filter<std::uint64_t> cck(NBR_KEYS, FALSE_POSITIVE_RATE);
+    
+    st.measure("blocked_bloom_filter insert", kys.prsnt.size(), [&] {
+        blm.clear();
+        
+        for (auto& x : kys.prsnt)
+        {
+            blm.insert(x);
+        }
+    });
+    
+    st.measure("cuckoo_filter insert", kys.prsnt.size(), [&] {
+        cck.clear();
+        
+        for (auto& x : kys.prsnt)
+        {
+            cck.insert(x);
+        }
+    });
+    
+    measure_filter(st, "blocked_bloom_filter", blm, kys);
+    measure_filter(st, "cuckoo_filter", cck, kys);
+}
+
+
+SPEED_BENCH(filters, short_circuit)
+{
+    const key_sets kys = make_key_sets();
+    speed::containers::blocked_bloom_filter<std::uint64_t> blm(NBR_KEYS, FALSE_POSITIVE_RATE);
+    std::unordered_set<std::uint64_t> st_kys(kys.prsnt.begin(), kys.prsnt.end());
+    
+    for (auto& x : kys.prsnt)
+    {
+        blm.insert(x);
+    }
+    
+    st.measure("unordered_set missing key", kys.mssng.size(), [&] {
+        std::size_t nbr_fnd = 0;
+        
+        for (auto& x : kys.mssng)
+        {
+            nbr_fnd += st_kys.count(x);
+        }
+        
+        speed_bench::do_not_optimize(nbr_fnd);
+    });
+    
+    st.measure("bloom + unordered_set missing key", kys.mssng.size(), [&] {
+        std::size_t nbr_fnd = 0;
+        
+        for (auto& x : kys.mssng)
+        {
+            nbr_fnd += blm.contains(x) && st_kys.count(x) != 0;
+        }
+        
+        speed_bench::do_not_optimize(nbr_fnd);
+    });
+}
@@ -0,0 +1,172 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/containers_bench/static_string_bench.cpp
+ * @brief       static_string benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 13:35
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include "speed/containers/static_string.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of strings. */
+constexpr std::size_t NBR_STRINGS = 1000000;
+
+/** Capacity of the static strings. */
+constexpr std::size_t CAPACITY = 31;
+
+
+using static_string_type = speed::containers::static_string<char, CAPACITY>;
+
+
+/**
+ * @brief       Make random identifiers whose lengths straddle the small string buffer of
+ *              std::string.
+ * @param       min_len : The smallest length.
+ * @param       max_len : The largest length.
+ * @return      The identifiers.
+ */
+std::vector<std::string> make_strings(std::size_t min_len, std::size_t max_len)
+{
+    const std::vector<std::uint32_t> rnds = speed_bench::make_random_integers<std::uint32_t>(
+            NBR_STRINGS * (max_len + 1), 0, 0xffffffff);
+    std::vector<std::string> strs(NBR_STRINGS);
+    std::size_t k = 0;
+    
+    for (auto& x : strs)
+    {
+        const std::size_t len = min_len + rnds[k++] % (max_len - min_len + 1);
+        
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            x.push_back(static_cast<char>('a' + rnds[k++] % 26));
+        }
+    }
+    
+    return strs;
+}
+
+
+void measure_strings(speed_bench::state& st, std::size_t min_len, std::size_t max_len)
+{
+    const std::vector<std::string> srcs = make_strings(min_len, max_len);
+    const std::string sfx = std::to_string(min_len) + "-" + std::to_string(max_len) + " chars";
+    std::vector<std::string> std_strs;
+    std::vector<static_string_type> sttc_strs;
+    
+    st.measure("std::string build " + sfx, srcs.size(), [&] {
+        std_strs.clear();
+        std_strs.shrink_to_fit();
+        
+        for (auto& x : srcs)
+        {
+            std_strs.emplace_back(x.data(), x.size());
+        }
+    });
+    
+    st.measure("static_string build " + sfx, srcs.size(), [&] {
+        sttc_strs.clear();
+        sttc_strs.shrink_to_fit();
+        
+        for (auto& x : srcs)
+        {
+            sttc_strs.emplace_back(x.data(), x.size());
+        }
+    });
+    
+    st.measure("std::string sort " + sfx, srcs.size(), [&] {
+        std_strs.assign(srcs.begin(), srcs.end());
+    }, [&] {
+        std::sort(std_strs.begin(), std_strs.end());
+    });
+    
+    st.measure("static_string sort " + sfx, srcs.size(), [&] {
+        sttc_strs.clear();
+        
+        for (auto& x : srcs)
+        {
+            sttc_strs.emplace_back(x);
+        }
+    }, [&] {
+        std::sort(sttc_strs.begin(), sttc_strs.end());
+    });
+    
+    st.measure("std::string hash " + sfx, srcs.size(), [&] {
+        std::size_t sum = 0;
+        
+        for (auto& x : std_strs)
+        {
+            sum += std::hash<std::string>()(x);
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("static_string hash " + sfx, srcs.size(), [&] {
+        std::size_t sum = 0;
+        
+        for (auto& x : sttc_strs)
+        {
+            sum += std::hash<static_string_type>()(x);
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+    
+    st.measure("std::string unordered_set " + sfx, srcs.size(), [&] {
+        std::unordered_set<std::string> st_strs(std_strs.begin(), std_strs.end());
+        
+        speed_bench::do_not_optimize(st_strs);
+    });
+    
+    st.measure("static_string unordered_set " + sfx, srcs.size(), [&] {
+        std::unordered_set<static_string_type> st_strs(sttc_strs.begin(), sttc_strs.end());
+        
+        speed_bench::do_not_optimize(st_strs);
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(static_string, short_strings)
+{
+    measure_strings(st, 4, 15);
+}
+
+
+SPEED_BENCH(static_string, long_strings)
+{
+    measure_strings(st, 16, 31);
+}
@@ -0,0 +1,138 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/hash_bench/hash_bench.cpp
+ * @brief       hash_bytes and hasher benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 17:25
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "speed/hash.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Size of the buffer the inputs are taken from. It fits in the L2 cache. */
+constexpr std::size_t BUFFER_SIZE = 256 * 1024;
+
+/** Number of bytes hashed by a run. */
+constexpr std::size_t NBR_BYTES = 64 * 1024 * 1024;
+
+/** Number of keys inserted in the buckets. */
+constexpr std::size_t NBR_KEYS = 512;
+
+/** Number of buckets. */
+constexpr std::size_t NBR_BUCKETS = 1024;
+
+
+template<typename TpHash>
+void measure_throughput(
+        speed_bench::state& st,
+        const std::string& lbl,
+        const std::vector<char>& buf,
+        std::size_t sz,
+        const TpHash& hsh
+)
+{
+    const std::size_t nbr_hshs = NBR_BYTES / sz;
+    const std::size_t nbr_ofsts = BUFFER_SIZE - sz + 1;
+    
+    st.measure(lbl + " " + std::to_string(sz) + " B", nbr_hshs, [&] {
+        std::uint64_t sum = 0;
+        std::size_t ofst = 0;
+        
+        for (std::size_t i = 0; i < nbr_hshs; ++i)
+        {
+            sum += hsh(std::string_view(buf.data() + ofst, sz));
+            ofst += sz + 1;
+            
+            if (ofst >= nbr_ofsts)
+            {
+                ofst -= nbr_ofsts;
+            }
+        }
+        
+        speed_bench::do_not_optimize(sum);
+    });
+}
+
+
+/**
+ * @brief       Get the length of the longest bucket chain when keys in arithmetic progression are
+ *              reduced to buckets with a modulo, as static_cache does.
+ * @param       strd : The difference between consecutive keys.
+ * @param       hsh : The hash function.
+ * @return      The length of the longest chain.
+ */
+template<typename TpHash>
+std::size_t get_max_chain(std::uint64_t strd, const TpHash& hsh)
+{
+    std::vector<std::size_t> bckts(NBR_BUCKETS, 0);
+    
+    for (std::uint64_t i = 0; i < NBR_KEYS; ++i)
+    {
+        ++bckts[hsh(i * strd) % NBR_BUCKETS];
+    }
+    
+    return *std::max_element(bckts.begin(), bckts.end());
+}
+
+
+}
+
+
+SPEED_BENCH(hash, hash_bytes)
+{
+    const std::vector<std::uint8_t> rnds = speed_bench::make_random_integers<std::uint8_t>(
+            BUFFER_SIZE, 0, 255);
+    const std::vector<char> buf(rnds.begin(), rnds.end());
+    
+    for (std::size_t sz : {8, 16, 32, 64, 256, 1024, 4096, 65536})
+    {
+        measure_throughput(st, "hash_bytes", buf, sz, [](std::string_view str) {
+            return speed::hash::hash_bytes(str.data(), str.size());
+        });
+        
+        measure_throughput(st, "std::hash<string_view>", buf, sz, std::hash<std::string_view>());
+    }
+}
+
+
+SPEED_BENCH(hash, bucket_distribution)
+{
+    for (std::uint64_t strd : {1, 64, 1024})
+    {
+        const std::string sfx = " max chain stride " + std::to_string(strd);
+        
+        st.report("std::hash" + sfx, get_max_chain(strd, std::hash<std::uint64_t>()), "keys");
+        st.report("hasher" + sfx, get_max_chain(strd, speed::hash::hasher<std::uint64_t>()),
+                  "keys");
+    }
+}
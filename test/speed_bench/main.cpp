@@ -0,0 +1,74 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_bench/main.cpp
+ * @brief       speed_bench entry point. The arguments are substrings of the names of the
+ *              benchmarks to run, and --runs=<n> sets the number of runs of every measure.
+ * @author      Killian
+ * @date        2018/10/07 - 09:30
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "speed_bench/bench.hpp"
+
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> fltrs;
+    std::size_t nbr_rns = 5;
+    
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        
+        if (arg.compare(0, 7, "--runs=") == 0)
+        {
+            nbr_rns = std::strtoul(arg.c_str() + 7, nullptr, 10);
+        }
+        else
+        {
+            fltrs.push_back(std::move(arg));
+        }
+    }
+    
+    speed_bench::state st(nbr_rns);
+    
+    for (auto& entr : speed_bench::get_registry())
+    {
+        bool slctd = fltrs.empty();
+        
+        for (auto& fltr : fltrs)
+        {
+            slctd = slctd || entr.nme.find(fltr) != std::string::npos;
+        }
+        
+        if (slctd)
+        {
+            std::cout << "[ " << entr.nme << " ]" << std::endl;
+            entr.fnc(st);
+        }
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,187 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/system_bench/async_io_engine_bench.cpp
+ * @brief       async_io_engine benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 19:25
+ */
+
+#include <cstdint>
+#include <fcntl.h>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "speed/system/io/async_io_engine.hpp"
+#include "speed/system/system_exception.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Size of the file read. */
+constexpr std::size_t FILE_SIZE = 256 * 1024 * 1024;
+
+/** Size of every read. */
+constexpr std::size_t BLOCK_SIZE = 4096;
+
+/** Number of reads of a run. */
+constexpr std::size_t NBR_READS = 100000;
+
+
+/**
+ * @brief       Keep a number of random reads in flight until all the reads of a run are done.
+ *              Every completed read queues the next one in its buffer slot.
+ */
+class read_driver
+{
+public:
+    read_driver(
+            speed::system::async_io_engine& eng,
+            int fd,
+            std::vector<char>& bfrs,
+            const std::vector<std::uint64_t>& offs
+    )
+            : eng_(eng)
+            , fd_(fd)
+            , bfrs_(bfrs)
+            , offs_(offs)
+            , nxt_(0)
+    {
+    }
+    
+    void run(std::size_t queue_dpth)
+    {
+        nxt_ = 0;
+        
+        for (std::size_t i = 0; i < queue_dpth; ++i)
+        {
+            issue(i);
+        }
+        
+        eng_.wait_all();
+    }
+
+private:
+    void issue(std::size_t slt)
+    {
+        if (nxt_ == offs_.size())
+        {
+            return;
+        }
+        
+        eng_.read(fd_, bfrs_.data() + slt * BLOCK_SIZE, BLOCK_SIZE, offs_[nxt_++],
+                  [this, slt](std::int64_t) { issue(slt); });
+    }
+    
+    speed::system::async_io_engine& eng_;
+    
+    int fd_;
+    
+    std::vector<char>& bfrs_;
+    
+    const std::vector<std::uint64_t>& offs_;
+    
+    std::size_t nxt_;
+};
+
+
+void measure_backend(
+        speed_bench::state& st,
+        const std::string& nme,
+        speed::system::async_io_backends bcknd,
+        bool rgstr,
+        int fd,
+        const std::vector<std::uint64_t>& offs
+)
+{
+    for (std::size_t queue_dpth : {1, 4, 16, 64, 128})
+    {
+        const std::string lbl = nme + " QD " + std::to_string(queue_dpth);
+        std::vector<char> bfrs(queue_dpth * BLOCK_SIZE);
+        
+        try
+        {
+            speed::system::async_io_engine eng(static_cast<std::uint32_t>(queue_dpth), bcknd);
+            read_driver drvr(eng, fd, bfrs, offs);
+            
+            if (rgstr)
+            {
+                eng.register_buffers({{bfrs.data(), bfrs.size()}});
+                eng.register_files({fd});
+            }
+            
+            st.measure(lbl, offs.size(), [&] {
+                drvr.run(queue_dpth);
+            });
+        }
+        catch (const speed::system::system_exception&)
+        {
+            std::cout << "  " << lbl << ": backend not available" << std::endl;
+        }
+    }
+}
+
+
+}
+
+
+SPEED_BENCH(async_io_engine, random_reads)
+{
+    const std::string pth = "/tmp/speed_async_io_engine_bench_" + std::to_string(::getpid());
+    const std::vector<std::uint64_t> blcks = speed_bench::make_random_integers<std::uint64_t>(
+            NBR_READS, 0, FILE_SIZE / BLOCK_SIZE - 1);
+    std::vector<std::uint64_t> offs;
+    std::vector<char> bfr(BLOCK_SIZE * 256, 'x');
+    const int fd = ::open(pth.c_str(), O_CREAT | O_RDWR | O_TRUNC | O_CLOEXEC, 0600);
+    
+    for (std::size_t i = 0; i < FILE_SIZE; i += bfr.size())
+    {
+        speed_bench::do_not_optimize(::pwrite(fd, bfr.data(), bfr.size(), static_cast<off_t>(i)));
+    }
+    
+    for (auto& x : blcks)
+    {
+        offs.push_back(x * BLOCK_SIZE);
+    }
+    
+    st.measure("pread loop", offs.size(), [&] {
+        for (auto& x : offs)
+        {
+            speed_bench::do_not_optimize(::pread(fd, bfr.data(), BLOCK_SIZE,
+                                                 static_cast<off_t>(x)));
+        }
+    });
+    
+    measure_backend(st, "io ring", speed::system::async_io_backends::IO_RING, false, fd, offs);
+    measure_backend(st, "io ring registered", speed::system::async_io_backends::IO_RING, true,
+                    fd, offs);
+    measure_backend(st, "thread pool", speed::system::async_io_backends::THREAD_POOL, false, fd,
+                    offs);
+    
+    ::close(fd);
+    ::unlink(pth.c_str());
+}
@@ -0,0 +1,291 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/system_bench/event_loop_bench.cpp
+ * @brief       event_loop benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 19:05
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "speed/system/event/event_loop.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of round trips between the calling thread and the loop thread. */
+constexpr std::size_t NBR_ROUND_TRIPS = 20000;
+
+/** Number of pipes watched by the loop. */
+constexpr std::size_t NBR_PIPES = 1000;
+
+/** Number of tasks posted by every producer. */
+constexpr std::size_t NBR_TASKS_PER_PRODUCER = 500000;
+
+/** Number of threads that post tasks. */
+constexpr std::size_t NBR_PRODUCERS = 2;
+
+
+/**
+ * @brief       Flag that a thread sets and another one waits for, used to send the replies.
+ */
+class reply_flag
+{
+public:
+    void set()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            st_ = true;
+        }
+        
+        cnd_.notify_one();
+    }
+    
+    void wait()
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        cnd_.wait(lck, [this] { return st_; });
+        st_ = false;
+    }
+
+private:
+    std::mutex mtx_;
+    
+    std::condition_variable cnd_;
+    
+    bool st_ = false;
+};
+
+
+/**
+ * @brief       Task queue served by a thread through a condition variable, the usual baseline.
+ */
+class locked_task_queue
+{
+public:
+    locked_task_queue()
+            : thrd_([this] { run(); })
+    {
+    }
+    
+    ~locked_task_queue()
+    {
+        post(nullptr);
+        thrd_.join();
+    }
+    
+    void post(std::function<void()> tsk)
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            tsks_.push_back(std::move(tsk));
+        }
+        
+        cnd_.notify_one();
+    }
+
+private:
+    void run()
+    {
+        for (;;)
+        {
+            std::unique_lock<std::mutex> lck(mtx_);
+            
+            cnd_.wait(lck, [this] { return !tsks_.empty(); });
+            
+            std::function<void()> tsk = std::move(tsks_.front());
+            tsks_.pop_front();
+            lck.unlock();
+            
+            if (tsk == nullptr)
+            {
+                return;
+            }
+            
+            tsk();
+        }
+    }
+    
+    std::mutex mtx_;
+    
+    std::condition_variable cnd_;
+    
+    std::deque<std::function<void()>> tsks_;
+    
+    std::thread thrd_;
+};
+
+
+/**
+ * @brief       Non-blocking pipe.
+ */
+struct pipe_fds
+{
+    pipe_fds()
+    {
+        int fds[2];
+        
+        if (::pipe2(fds, O_NONBLOCK | O_CLOEXEC) != 0)
+        {
+            fds[0] = fds[1] = -1;
+        }
+        
+        rd = fds[0];
+        wr = fds[1];
+    }
+    
+    ~pipe_fds()
+    {
+        ::close(rd);
+        ::close(wr);
+    }
+    
+    pipe_fds(const pipe_fds&) = delete;
+    
+    pipe_fds& operator =(const pipe_fds&) = delete;
+    
+    int rd;
+    
+    int wr;
+};
+
+
+}
+
+
+SPEED_BENCH(event_loop, round_trip)
+{
+    speed::system::event_loop lp;
+    std::thread thrd([&] { lp.run(); });
+    reply_flag rply;
+    
+    st.measure("event_loop post round trip", NBR_ROUND_TRIPS, [&] {
+        for (std::size_t i = 0; i < NBR_ROUND_TRIPS; ++i)
+        {
+            lp.post([&] { rply.set(); });
+            rply.wait();
+        }
+    });
+    
+    lp.stop();
+    thrd.join();
+    
+    locked_task_queue qu;
+    
+    st.measure("condition_variable queue round trip", NBR_ROUND_TRIPS, [&] {
+        for (std::size_t i = 0; i < NBR_ROUND_TRIPS; ++i)
+        {
+            qu.post([&] { rply.set(); });
+            rply.wait();
+        }
+    });
+}
+
+
+/**
+ * @brief       Make every watched pipe readable, and dispatch the events. Every callback reads
+ *              its pipe until it is empty, as the watches are edge-triggered.
+ */
+SPEED_BENCH(event_loop, pipes)
+{
+    speed::system::event_loop lp(NBR_PIPES);
+    std::vector<pipe_fds> pps(NBR_PIPES);
+    std::size_t nbr_rd = 0;
+    
+    for (auto& x : pps)
+    {
+        lp.add_watch(x.rd, speed::system::event_flags::READABLE,
+                     [&, fd = x.rd](speed::system::event_flags) {
+            char bfr[64];
+            ssize_t res;
+            
+            while ((res = ::read(fd, bfr, sizeof(bfr))) > 0)
+            {
+                nbr_rd += static_cast<std::size_t>(res);
+            }
+        });
+    }
+    
+    st.measure("event dispatch", NBR_PIPES, [&] {
+        const char c = 'x';
+        
+        for (auto& x : pps)
+        {
+            speed_bench::do_not_optimize(::write(x.wr, &c, 1));
+        }
+    }, [&] {
+        nbr_rd = 0;
+        
+        while (nbr_rd < NBR_PIPES)
+        {
+            lp.run_once(1000);
+        }
+    });
+}
+
+
+SPEED_BENCH(event_loop, posted_tasks)
+{
+    speed::system::event_loop lp;
+    std::atomic<std::size_t> nbr_rn(0);
+    
+    st.measure("posted tasks " + std::to_string(NBR_PRODUCERS) + " producers",
+               NBR_PRODUCERS * NBR_TASKS_PER_PRODUCER, [&] {
+        std::vector<std::thread> prdcrs;
+        
+        nbr_rn.store(0);
+        
+        for (std::size_t i = 0; i < NBR_PRODUCERS; ++i)
+        {
+            prdcrs.emplace_back([&] {
+                for (std::size_t j = 0; j < NBR_TASKS_PER_PRODUCER; ++j)
+                {
+                    lp.post([&] { nbr_rn.fetch_add(1, std::memory_order_relaxed); });
+                }
+            });
+        }
+        
+        while (nbr_rn.load() < NBR_PRODUCERS * NBR_TASKS_PER_PRODUCER)
+        {
+            lp.run_once(10);
+        }
+        
+        for (auto& x : prdcrs)
+        {
+            x.join();
+        }
+    });
+}
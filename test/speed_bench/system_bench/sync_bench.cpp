@@ -0,0 +1,276 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/system_bench/sync_bench.cpp
+ * @brief       synchronization primitives benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 18:05
+ */
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "speed/system/sync/adaptive_mutex.hpp"
+#include "speed/system/sync/barrier.hpp"
+#include "speed/system/sync/counting_semaphore.hpp"
+#include "speed/system/sync/reader_writer_lock.hpp"
+#include "speed/system/sync/ticket_lock.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of threads contending for the locks and taking part in the barriers. */
+constexpr std::size_t NBR_THREADS = 4;
+
+/** Total number of lock acquisitions of a run, split evenly over the threads. */
+constexpr std::size_t NBR_LOCKS = 2000000;
+
+/** Number of round trips of the ping-pong. */
+constexpr std::size_t NBR_ROUND_TRIPS = 100000;
+
+/** Number of barrier phases. */
+constexpr std::size_t NBR_PHASES = 20000;
+
+
+/**
+ * @brief       Semaphore made of a mutex and a condition variable, the usual baseline.
+ */
+class locked_semaphore
+{
+public:
+    void acquire()
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        
+        cnd_.wait(lck, [this] { return cnt_ > 0; });
+        --cnt_;
+    }
+    
+    void release()
+    {
+        {
+            std::lock_guard<std::mutex> lck(mtx_);
+            ++cnt_;
+        }
+        
+        cnd_.notify_one();
+    }
+
+private:
+    std::mutex mtx_;
+    
+    std::condition_variable cnd_;
+    
+    std::uint32_t cnt_ = 0;
+};
+
+
+/**
+ * @brief       Barrier made of a mutex and a condition variable, the usual baseline.
+ */
+class locked_barrier
+{
+public:
+    explicit locked_barrier(std::size_t nbr_thrds)
+            : nbr_thrds_(nbr_thrds)
+            , rmng_(nbr_thrds)
+    {
+    }
+    
+    void arrive_and_wait()
+    {
+        std::unique_lock<std::mutex> lck(mtx_);
+        const std::size_t phs = phs_;
+        
+        if (--rmng_ == 0)
+        {
+            rmng_ = nbr_thrds_;
+            ++phs_;
+            cnd_.notify_all();
+        }
+        else
+        {
+            cnd_.wait(lck, [&] { return phs_ != phs; });
+        }
+    }
+
+private:
+    std::mutex mtx_;
+    
+    std::condition_variable cnd_;
+    
+    std::size_t nbr_thrds_;
+    
+    std::size_t rmng_;
+    
+    std::size_t phs_ = 0;
+};
+
+
+template<typename TpFunction>
+void run_threads(std::size_t nbr_thrds, const TpFunction& fnc)
+{
+    std::vector<std::thread> thrds;
+    
+    for (std::size_t i = 0; i < nbr_thrds; ++i)
+    {
+        thrds.emplace_back(fnc, i);
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+}
+
+
+template<typename TpMutex>
+void measure_mutex(speed_bench::state& st, const std::string& nme)
+{
+    TpMutex mtx;
+    std::uint64_t cnt = 0;
+    
+    st.measure(nme + " " + std::to_string(NBR_THREADS) + " threads", NBR_LOCKS, [&] {
+        run_threads(NBR_THREADS, [&](std::size_t) {
+            for (std::size_t i = 0; i < NBR_LOCKS / NBR_THREADS; ++i)
+            {
+                std::lock_guard<TpMutex> lck(mtx);
+                ++cnt;
+            }
+        });
+        
+        speed_bench::do_not_optimize(cnt);
+    });
+}
+
+
+/**
+ * @brief       Run a mix of shared and exclusive locks, one exclusive lock every 100.
+ */
+template<typename TpMutex>
+void measure_shared_mutex(speed_bench::state& st, const std::string& nme)
+{
+    TpMutex mtx;
+    std::uint64_t cnt = 0;
+    
+    st.measure(nme + " 99% reads", NBR_LOCKS, [&] {
+        run_threads(NBR_THREADS, [&](std::size_t) {
+            std::uint64_t sum = 0;
+            
+            for (std::size_t i = 0; i < NBR_LOCKS / NBR_THREADS; ++i)
+            {
+                if (i % 100 == 0)
+                {
+                    std::lock_guard<TpMutex> lck(mtx);
+                    ++cnt;
+                }
+                else
+                {
+                    std::shared_lock<TpMutex> lck(mtx);
+                    sum += cnt;
+                }
+            }
+            
+            speed_bench::do_not_optimize(sum);
+        });
+    });
+}
+
+
+template<typename TpSemaphore>
+void measure_ping_pong(speed_bench::state& st, const std::string& nme)
+{
+    TpSemaphore png;
+    TpSemaphore pong;
+    
+    st.measure(nme + " ping-pong", NBR_ROUND_TRIPS, [&] {
+        std::thread thrd([&] {
+            for (std::size_t i = 0; i < NBR_ROUND_TRIPS; ++i)
+            {
+                png.acquire();
+                pong.release();
+            }
+        });
+        
+        for (std::size_t i = 0; i < NBR_ROUND_TRIPS; ++i)
+        {
+            png.release();
+            pong.acquire();
+        }
+        
+        thrd.join();
+    });
+}
+
+
+template<typename TpBarrier>
+void measure_barrier(speed_bench::state& st, const std::string& nme)
+{
+    TpBarrier barr(NBR_THREADS);
+    
+    st.measure(nme + " " + std::to_string(NBR_THREADS) + " threads", NBR_PHASES, [&] {
+        run_threads(NBR_THREADS, [&](std::size_t) {
+            for (std::size_t i = 0; i < NBR_PHASES; ++i)
+            {
+                barr.arrive_and_wait();
+            }
+        });
+    });
+}
+
+
+}
+
+
+SPEED_BENCH(sync, mutex)
+{
+    measure_mutex<std::mutex>(st, "std::mutex");
+    measure_mutex<speed::system::adaptive_mutex>(st, "adaptive_mutex");
+    measure_mutex<speed::system::ticket_lock>(st, "ticket_lock");
+}
+
+
+SPEED_BENCH(sync, reader_writer_lock)
+{
+    measure_shared_mutex<std::shared_mutex>(st, "std::shared_mutex");
+    measure_shared_mutex<speed::system::reader_writer_lock>(st, "reader_writer_lock");
+}
+
+
+SPEED_BENCH(sync, semaphore)
+{
+    measure_ping_pong<locked_semaphore>(st, "mutex + condition_variable");
+    measure_ping_pong<speed::system::counting_semaphore>(st, "counting_semaphore");
+}
+
+
+SPEED_BENCH(sync, barrier)
+{
+    measure_barrier<locked_barrier>(st, "mutex + condition_variable");
+    measure_barrier<speed::system::barrier>(st, "barrier");
+}
@@ -0,0 +1,221 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+/**
+ * @file        speed_bench/time_bench/monotonic_timer_bench.cpp
+ * @brief       monotonic_timer benchmark.
+ * @author      Killian
+ * @date        2018/10/07 - 18:45
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "speed/time/monotonic_timer.hpp"
+#include "speed_bench/bench.hpp"
+
+
+namespace {
+
+
+/** Number of timers scheduled by the insert and cancel measures. */
+constexpr std::size_t NBR_TIMERS = 100000;
+
+/** Number of timers of the firing measure. */
+constexpr std::size_t NBR_FIRED_TIMERS = 10000;
+
+/** Span of the deadlines of the firing measure, in nanoseconds. */
+constexpr std::uint64_t FIRING_SPAN = 50'000'000;
+
+
+/**
+ * @brief       Deadline queue made of a std::multimap, the usual baseline.
+ */
+class multimap_timer
+{
+public:
+    using iterator = std::multimap<std::uint64_t, std::function<void()>>::iterator;
+    
+    iterator schedule_once(std::uint64_t dly, std::function<void()> cb)
+    {
+        return tmrs_.emplace(get_now() + dly, std::move(cb));
+    }
+    
+    void cancel(iterator it)
+    {
+        tmrs_.erase(it);
+    }
+
+private:
+    static std::uint64_t get_now()
+    {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    
+    std::multimap<std::uint64_t, std::function<void()>> tmrs_;
+};
+
+
+speed::system::time_specification to_time_specification(std::uint64_t ns)
+{
+    return speed::system::time_specification(ns / 1'000'000'000, ns % 1'000'000'000);
+}
+
+
+/**
+ * @brief       Get random delays between 1 ms and 10 s, in nanoseconds.
+ */
+std::vector<std::uint64_t> make_delays()
+{
+    return speed_bench::make_random_integers<std::uint64_t>(NBR_TIMERS, 1'000'000,
+                                                            10'000'000'000);
+}
+
+
+}
+
+
+SPEED_BENCH(monotonic_timer, insert)
+{
+    const std::vector<std::uint64_t> dlys = make_delays();
+    std::unique_ptr<speed::time::monotonic_timer> whl;
+    std::unique_ptr<multimap_timer> mm;
+    
+    st.measure("timer wheel insert", NBR_TIMERS, [&] {
+        whl = std::make_unique<speed::time::monotonic_timer>();
+    }, [&] {
+        for (auto& x : dlys)
+        {
+            whl->schedule_once(to_time_specification(x), [] {});
+        }
+    });
+    
+    st.measure("std::multimap insert", NBR_TIMERS, [&] {
+        mm = std::make_unique<multimap_timer>();
+    }, [&] {
+        for (auto& x : dlys)
+        {
+            mm->schedule_once(x, [] {});
+        }
+    });
+}
+
+
+SPEED_BENCH(monotonic_timer, cancel)
+{
+    const std::vector<std::uint64_t> dlys = make_delays();
+    const std::vector<std::uint64_t> rnds = speed_bench::make_random_integers<std::uint64_t>(
+            NBR_TIMERS, 0, ~std::uint64_t(0), 7);
+    std::unique_ptr<speed::time::monotonic_timer> whl;
+    std::unique_ptr<multimap_timer> mm;
+    std::vector<speed::time::monotonic_timer::timer_id> ids;
+    std::vector<multimap_timer::iterator> its;
+    
+    st.measure("timer wheel cancel", NBR_TIMERS, [&] {
+        whl = std::make_unique<speed::time::monotonic_timer>();
+        ids.clear();
+        
+        for (auto& x : dlys)
+        {
+            ids.push_back(whl->schedule_once(to_time_specification(x), [] {}));
+        }
+        
+        for (std::size_t i = ids.size(); i > 1; --i)
+        {
+            std::swap(ids[i - 1], ids[rnds[i - 1] % i]);
+        }
+    }, [&] {
+        for (auto& x : ids)
+        {
+            whl->cancel(x);
+        }
+    });
+    
+    st.measure("std::multimap cancel", NBR_TIMERS, [&] {
+        mm = std::make_unique<multimap_timer>();
+        its.clear();
+        
+        for (auto& x : dlys)
+        {
+            its.push_back(mm->schedule_once(x, [] {}));
+        }
+        
+        for (std::size_t i = its.size(); i > 1; --i)
+        {
+            std::swap(its[i - 1], its[rnds[i - 1] % i]);
+        }
+    }, [&] {
+        for (auto& x : its)
+        {
+            mm->cancel(x);
+        }
+    });
+}
+
+
+/**
+ * @brief       Fire timers spread over a short span with a 1 us resolution, and report how late
+ *              the callbacks are and how many times the thread wakes up.
+ */
+SPEED_BENCH(monotonic_timer, firing)
+{
+    using clock_type = std::chrono::steady_clock;
+    
+    const std::vector<std::uint64_t> dlys = speed_bench::make_random_integers<std::uint64_t>(
+            NBR_FIRED_TIMERS, 0, FIRING_SPAN);
+    speed::time::monotonic_timer tmr(1'000);
+    std::vector<std::int64_t> ltnss;
+    std::size_t nbr_wkps = 0;
+    const auto strt = clock_type::now();
+    
+    for (auto& x : dlys)
+    {
+        const auto schdl_tme = clock_type::now();
+        
+        tmr.schedule_once(to_time_specification(x), [&, x, schdl_tme] {
+            ltnss.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    clock_type::now() - schdl_tme).count() - static_cast<std::int64_t>(x));
+        });
+    }
+    
+    while (tmr.wait())
+    {
+        ++nbr_wkps;
+    }
+    
+    std::sort(ltnss.begin(), ltnss.end());
+    
+    st.report("timers fired", static_cast<double>(ltnss.size()), "timers");
+    st.report("early callbacks", static_cast<double>(
+            std::count_if(ltnss.begin(), ltnss.end(), [](std::int64_t x) { return x < 0; })),
+              "timers");
+    st.report("median lateness", ltnss[ltnss.size() / 2] / 1000.0, "us");
+    st.report("99th percentile lateness", ltnss[ltnss.size() * 99 / 100] / 1000.0, "us");
+    st.report("wake-ups", static_cast<double>(nbr_wkps), "wake-ups");
+    st.report("elapsed", std::chrono::duration<double, std::milli>(clock_type::now() - strt)
+            .count(), "ms");
+}
@@ -24,6 +24,10 @@
  * @date        2018/08/07 - 15:55
  */
 
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -44,3 +48,59 @@ TEST(algorithm_algorithm, quicksort)
         min = x;
     }
 }
+
+
+TEST(algorithm_algorithm, quicksort_distributions)
+{
+    std::mt19937 gen(17);
+    
+    for (std::size_t sz : {0, 1, 2, 3, 23, 24, 25, 129, 1000, 100000})
+    {
+        std::vector<std::vector<int>> dists(6, std::vector<int>(sz));
+        
+        for (std::size_t i = 0; i < sz; ++i)
+        {
+            dists[0][i] = static_cast<int>(gen());
+            dists[1][i] = static_cast<int>(i);
+            dists[2][i] = static_cast<int>(sz - i);
+            dists[3][i] = static_cast<int>(i < sz / 2 ? i : sz - i);
+            dists[4][i] = static_cast<int>(gen() % 8);
+            dists[5][i] = 42;
+        }
+        
+        for (auto& x : dists)
+        {
+            auto ref = x;
+            
+            std::sort(ref.begin(), ref.end());
+            speed::algorithm::quicksort(x, x.size());
+            EXPECT_TRUE(x == ref);
+        }
+    }
+}
+
+
+TEST(algorithm_algorithm, quicksort_compare)
+{
+    std::mt19937 gen(19);
+    std::vector<std::string> strs(5000);
+    int arr[500];
+    
+    for (auto& x : strs)
+    {
+        x = std::to_string(gen() % 1000);
+    }
+    
+    for (auto& x : arr)
+    {
+        x = static_cast<int>(gen() % 300);
+    }
+    
+    auto strs_ref = strs;
+    std::sort(strs_ref.begin(), strs_ref.end(), std::greater<>());
+    speed::algorithm::quicksort(strs, strs.size(), std::greater<>());
+    EXPECT_TRUE(strs == strs_ref);
+    
+    speed::algorithm::quicksort(arr, 500);
+    EXPECT_TRUE(std::is_sorted(arr, arr + 500));
+}
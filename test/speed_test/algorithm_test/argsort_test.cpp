@@ -0,0 +1,178 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/argsort_test.cpp
+ * @brief       argsort unit test.
+ * @author      Killian
+ * @date        2018/09/28 - 16:20
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+namespace {
+
+
+struct record
+{
+    std::int32_t ky;
+    std::string nme;
+    std::uint64_t pay[16];
+};
+
+
+}
+
+
+TEST(algorithm_argsort, argsort)
+{
+    std::mt19937 gen(11);
+    std::vector<std::int32_t> vec(10000);
+    std::vector<std::size_t> idxs;
+    
+    for (auto& x : vec)
+    {
+        x = static_cast<std::int32_t>(gen() % 100);
+    }
+    
+    idxs = speed::algorithm::argsort(vec, vec.size());
+    ASSERT_TRUE(idxs.size() == vec.size());
+    
+    for (std::size_t i = 1; i < idxs.size(); ++i)
+    {
+        EXPECT_TRUE(vec[idxs[i - 1]] < vec[idxs[i]] ||
+                    (vec[idxs[i - 1]] == vec[idxs[i]] && idxs[i - 1] < idxs[i]));
+    }
+    
+    idxs = speed::algorithm::argsort(vec, vec.size(), std::greater<>());
+    for (std::size_t i = 1; i < idxs.size(); ++i)
+    {
+        EXPECT_TRUE(vec[idxs[i - 1]] > vec[idxs[i]] ||
+                    (vec[idxs[i - 1]] == vec[idxs[i]] && idxs[i - 1] < idxs[i]));
+    }
+    
+    EXPECT_TRUE(speed::algorithm::argsort(vec, 0).empty());
+}
+
+
+TEST(algorithm_argsort, argsort_by_key)
+{
+    std::mt19937 gen(12);
+    std::vector<record> recs(5000);
+    std::vector<std::size_t> idxs;
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        recs[i].ky = static_cast<std::int32_t>(gen() % 200) - 100;
+        recs[i].nme = std::to_string(gen() % 300);
+        recs[i].pay[0] = i;
+    }
+    
+    idxs = speed::algorithm::argsort_by_key(recs, recs.size(), [](const record& rec)
+    {
+        return rec.ky;
+    });
+    
+    for (std::size_t i = 1; i < idxs.size(); ++i)
+    {
+        EXPECT_TRUE(recs[idxs[i - 1]].ky < recs[idxs[i]].ky ||
+                    (recs[idxs[i - 1]].ky == recs[idxs[i]].ky && idxs[i - 1] < idxs[i]));
+    }
+    
+    idxs = speed::algorithm::argsort_by_key(recs, recs.size(), [](const record& rec)
+    {
+        return rec.nme;
+    }, std::greater<>());
+    
+    for (std::size_t i = 1; i < idxs.size(); ++i)
+    {
+        EXPECT_TRUE(recs[idxs[i - 1]].nme > recs[idxs[i]].nme ||
+                    (recs[idxs[i - 1]].nme == recs[idxs[i]].nme && idxs[i - 1] < idxs[i]));
+    }
+}
+
+
+TEST(algorithm_argsort, apply_permutation)
+{
+    std::mt19937 gen(13);
+    std::vector<std::string> strs(1000);
+    std::vector<std::size_t> idxs(1000);
+    
+    for (std::size_t i = 0; i < strs.size(); ++i)
+    {
+        strs[i] = std::to_string(i);
+        idxs[i] = i;
+    }
+    
+    std::shuffle(idxs.begin(), idxs.end(), gen);
+    
+    auto perm = idxs;
+    speed::algorithm::apply_permutation(strs, strs.size(), idxs);
+    
+    for (std::size_t i = 0; i < strs.size(); ++i)
+    {
+        EXPECT_TRUE(strs[i] == std::to_string(perm[i]));
+        EXPECT_TRUE(idxs[i] == i);
+    }
+}
+
+
+TEST(algorithm_argsort, indirect_sort)
+{
+    std::mt19937 gen(14);
+    std::vector<record> recs(3000);
+    std::vector<std::int32_t> vec(3000);
+    
+    auto comp = [](const record& lhs, const record& rhs)
+    {
+        return lhs.ky < rhs.ky;
+    };
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        recs[i].ky = static_cast<std::int32_t>(gen() % 50);
+        recs[i].nme = std::to_string(i);
+        recs[i].pay[15] = i;
+        vec[i] = static_cast<std::int32_t>(gen());
+    }
+    
+    auto ref = recs;
+    std::stable_sort(ref.begin(), ref.end(), comp);
+    
+    speed::algorithm::indirect_sort(recs, recs.size(), comp);
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        EXPECT_TRUE(recs[i].ky == ref[i].ky && recs[i].nme == ref[i].nme &&
+                    recs[i].pay[15] == ref[i].pay[15]);
+    }
+    
+    auto vref = vec;
+    std::sort(vref.begin(), vref.end());
+    
+    speed::algorithm::indirect_sort(vec, vec.size());
+    EXPECT_TRUE(vec == vref);
+}
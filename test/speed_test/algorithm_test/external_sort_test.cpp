@@ -0,0 +1,203 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/external_sort_test.cpp
+ * @brief       external_sort unit test.
+ * @author      Killian
+ * @date        2018/09/27 - 14:02
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+namespace {
+
+
+std::string get_test_path(const char* nme)
+{
+    return (std::filesystem::temp_directory_path() / nme).string();
+}
+
+
+template<typename TpValue>
+void write_file(const std::string& pth, const std::vector<TpValue>& vals)
+{
+    std::FILE* fle = std::fopen(pth.c_str(), "wb");
+    
+    std::fwrite(vals.data(), sizeof(TpValue), vals.size(), fle);
+    std::fclose(fle);
+}
+
+
+template<typename TpValue>
+std::vector<TpValue> read_file(const std::string& pth)
+{
+    std::vector<TpValue> vals;
+    std::FILE* fle = std::fopen(pth.c_str(), "rb");
+    TpValue val;
+    
+    while (std::fread(&val, sizeof(TpValue), 1, fle) == 1)
+    {
+        vals.push_back(val);
+    }
+    
+    std::fclose(fle);
+    
+    return vals;
+}
+
+
+struct record
+{
+    std::uint64_t ky;
+    std::uint32_t pay[5];
+};
+
+
+}
+
+
+TEST(algorithm_external_sort, external_sort)
+{
+    const std::string src_pth = get_test_path("speed_external_sort_src");
+    const std::string dest_pth = get_test_path("speed_external_sort_dest");
+    std::mt19937 gen(1);
+    std::vector<std::int32_t> vals(100000);
+    speed::algorithm::external_sort_options opts;
+    
+    for (auto& x : vals)
+    {
+        x = static_cast<std::int32_t>(gen() % 50000) - 25000;
+    }
+    
+    write_file(src_pth, vals);
+    std::sort(vals.begin(), vals.end());
+    
+    speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), dest_pth.c_str());
+    EXPECT_TRUE(read_file<std::int32_t>(dest_pth) == vals);
+    
+    opts.mem_budget = 4096;
+    opts.nbr_ways = 3;
+    opts.buf_sz = 256;
+    speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), dest_pth.c_str(), opts);
+    EXPECT_TRUE(read_file<std::int32_t>(dest_pth) == vals);
+    
+    opts.nbr_ways = 128;
+    speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), src_pth.c_str(),
+                                                  std::greater<>(), opts);
+    std::reverse(vals.begin(), vals.end());
+    EXPECT_TRUE(read_file<std::int32_t>(src_pth) == vals);
+    
+    write_file(src_pth, std::vector<std::int32_t>());
+    speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), dest_pth.c_str(), opts);
+    EXPECT_TRUE(read_file<std::int32_t>(dest_pth).empty());
+    
+    std::remove(src_pth.c_str());
+    std::remove(dest_pth.c_str());
+}
+
+
+TEST(algorithm_external_sort, external_sort_records)
+{
+    const std::string src_pth = get_test_path("speed_external_sort_src");
+    const std::string dest_pth = get_test_path("speed_external_sort_dest");
+    std::mt19937_64 gen(2);
+    std::vector<record> recs(20000);
+    std::vector<record> res;
+    speed::algorithm::external_sort_options opts;
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        recs[i].ky = gen() % 1000;
+        for (auto& x : recs[i].pay)
+        {
+            x = static_cast<std::uint32_t>(i);
+        }
+    }
+    
+    write_file(src_pth, recs);
+    
+    opts.mem_budget = 10000;
+    opts.nbr_ways = 4;
+    speed::algorithm::external_sort_records(
+            src_pth.c_str(), dest_pth.c_str(), sizeof(record),
+            [](const unsigned char* lhs, const unsigned char* rhs)
+            {
+                std::uint64_t lhs_ky;
+                std::uint64_t rhs_ky;
+                
+                std::memcpy(&lhs_ky, lhs, sizeof(lhs_ky));
+                std::memcpy(&rhs_ky, rhs, sizeof(rhs_ky));
+                
+                return lhs_ky < rhs_ky;
+            }, opts);
+    
+    res = read_file<record>(dest_pth);
+    ASSERT_TRUE(res.size() == recs.size());
+    EXPECT_TRUE(std::is_sorted(res.begin(), res.end(), [](const record& lhs, const record& rhs)
+    {
+        return lhs.ky < rhs.ky;
+    }));
+    
+    std::sort(res.begin(), res.end(), [](const record& lhs, const record& rhs)
+    {
+        return lhs.pay[0] < rhs.pay[0];
+    });
+    EXPECT_TRUE(std::equal(res.begin(), res.end(), recs.begin(),
+                           [](const record& lhs, const record& rhs)
+    {
+        return std::memcmp(&lhs, &rhs, sizeof(record)) == 0;
+    }));
+    
+    std::remove(src_pth.c_str());
+    std::remove(dest_pth.c_str());
+}
+
+
+TEST(algorithm_external_sort, errors)
+{
+    const std::string src_pth = get_test_path("speed_external_sort_src");
+    const std::string dest_pth = get_test_path("speed_external_sort_dest");
+    
+    write_file(src_pth, std::vector<std::uint8_t>(7));
+    
+    EXPECT_THROW(speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), dest_pth.c_str()),
+                 speed::algorithm::invalid_argument_exception);
+    EXPECT_THROW(speed::algorithm::external_sort_records(
+            src_pth.c_str(), dest_pth.c_str(), 0, std::less<>()),
+                 speed::algorithm::invalid_argument_exception);
+    
+    std::remove(src_pth.c_str());
+    
+    EXPECT_THROW(speed::algorithm::external_sort<std::int32_t>(src_pth.c_str(), dest_pth.c_str()),
+                 speed::algorithm::io_exception);
+    
+    std::remove(dest_pth.c_str());
+}
@@ -0,0 +1,113 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/parallel_sort_test.cpp
+ * @brief       parallel_sort unit test.
+ * @author      Killian
+ * @date        2018/09/21 - 14:40
+ */
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_parallel_sort, distributions)
+{
+    std::mt19937 gen(23);
+    const std::size_t sz = 300000;
+    
+    for (std::size_t nbr_thrds : {1, 2, 4, 7})
+    {
+        speed::algorithm::work_stealing_executor exec(nbr_thrds);
+        std::vector<std::vector<std::uint64_t>> dists(5, std::vector<std::uint64_t>(sz));
+        
+        for (std::size_t i = 0; i < sz; ++i)
+        {
+            dists[0][i] = gen();
+            dists[1][i] = i;
+            dists[2][i] = sz - i;
+            dists[3][i] = i < sz / 2 ? i : sz - i;
+            dists[4][i] = gen() % 5;
+        }
+        
+        for (auto& x : dists)
+        {
+            auto ref = x;
+            
+            std::sort(ref.begin(), ref.end());
+            speed::algorithm::parallel_sort(x, x.size(), std::less<>(), exec);
+            EXPECT_TRUE(x == ref);
+        }
+    }
+}
+
+
+TEST(algorithm_parallel_sort, compare)
+{
+    std::mt19937 gen(29);
+    speed::algorithm::work_stealing_executor exec(4);
+    std::vector<std::string> strs(200000);
+    std::vector<int> small_vec = {5, 3, 9, 1};
+    
+    for (auto& x : strs)
+    {
+        x = std::to_string(gen());
+    }
+    
+    auto ref = strs;
+    std::sort(ref.begin(), ref.end(), std::greater<>());
+    speed::algorithm::parallel_sort(strs, strs.size(), std::greater<>(), exec);
+    EXPECT_TRUE(strs == ref);
+    
+    speed::algorithm::parallel_sort(small_vec, small_vec.size());
+    EXPECT_TRUE(small_vec == std::vector<int>({1, 3, 5, 9}));
+}
+
+
+TEST(algorithm_parallel_sort, exception)
+{
+    speed::algorithm::work_stealing_executor exec(4);
+    std::vector<int> vec(200000);
+    
+    for (std::size_t i = 0; i < vec.size(); ++i)
+    {
+        vec[i] = static_cast<int>((i * 7919) % vec.size());
+    }
+    
+    auto comp = [](int lhs, int rhs)
+    {
+        if (lhs == 123456 || rhs == 123456)
+        {
+            throw std::runtime_error("comparison error");
+        }
+        
+        return lhs < rhs;
+    };
+    
+    EXPECT_THROW(speed::algorithm::parallel_sort(vec, vec.size(), comp, exec), std::runtime_error);
+    EXPECT_THROW(speed::algorithm::parallel_sort(vec, vec.size(), comp), std::runtime_error);
+}
@@ -0,0 +1,147 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/parallel_test.cpp
+ * @brief       parallel unit test.
+ * @author      Killian
+ * @date        2018/09/26 - 18:02
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_parallel, for_each_and_transform)
+{
+    speed::algorithm::work_stealing_executor exec(4);
+    
+    for (std::size_t sz : {0, 1, 100, 100000})
+    {
+        std::vector<std::int64_t> vec(sz);
+        std::vector<double> dest(sz);
+        
+        std::iota(vec.begin(), vec.end(), 0);
+        speed::algorithm::parallel_for_each(vec, sz, [](std::int64_t& x) { x *= 3; }, exec);
+        speed::algorithm::parallel_transform(vec, sz, dest, [](std::int64_t x)
+        {
+            return static_cast<double>(x) / 2;
+        }, exec);
+        speed::algorithm::parallel_transform(vec, sz, vec, [](std::int64_t x) { return x + 1; });
+        
+        for (std::size_t i = 0; i < sz; ++i)
+        {
+            EXPECT_TRUE(vec[i] == static_cast<std::int64_t>(3 * i + 1));
+            EXPECT_TRUE(dest[i] == static_cast<double>(3 * i) / 2);
+        }
+    }
+}
+
+
+TEST(algorithm_parallel, reduce)
+{
+    speed::algorithm::work_stealing_executor exec(4);
+    speed::algorithm::sequential_executor seq_exec;
+    
+    for (std::size_t sz : {0, 1, 7, 8, 13, 100000})
+    {
+        std::vector<std::uint64_t> vec(sz);
+        std::uint64_t ref = 5;
+        std::uint64_t sqr_ref = 0;
+        
+        std::iota(vec.begin(), vec.end(), 1);
+        for (auto& x : vec)
+        {
+            ref += x;
+            sqr_ref += x * x;
+        }
+        
+        EXPECT_TRUE(speed::algorithm::parallel_reduce(vec, sz, std::uint64_t(5), std::plus<>(),
+                                                      exec) == ref);
+        EXPECT_TRUE(speed::algorithm::parallel_reduce(vec, sz, std::uint64_t(5), std::plus<>(),
+                                                      seq_exec) == ref);
+        EXPECT_TRUE(speed::algorithm::parallel_reduce(vec, sz, std::uint64_t(5), std::plus<>()) ==
+                    ref);
+        EXPECT_TRUE(speed::algorithm::parallel_transform_reduce(
+                vec, sz, std::uint64_t(0), std::plus<>(), [](std::uint64_t x) { return x * x; },
+                exec) == sqr_ref);
+    }
+    
+    std::vector<std::string> strs(10000, "ab");
+    
+    EXPECT_TRUE(speed::algorithm::parallel_transform_reduce(
+            strs, strs.size(), std::size_t(0), std::plus<>(),
+            [](const std::string& x) { return x.size(); }) == 20000);
+}
+
+
+TEST(algorithm_parallel, scan)
+{
+    speed::algorithm::work_stealing_executor exec(4);
+    
+    for (std::size_t sz : {0, 1, 2, 5000, 100000})
+    {
+        std::vector<std::int64_t> vec(sz);
+        std::vector<std::int64_t> incl(sz);
+        std::vector<std::int64_t> excl(sz);
+        std::vector<std::int64_t> ref_incl(sz);
+        std::vector<std::int64_t> ref_excl(sz);
+        std::int64_t acc = 0;
+        
+        for (std::size_t i = 0; i < sz; ++i)
+        {
+            vec[i] = static_cast<std::int64_t>(i % 13) - 6;
+            ref_excl[i] = acc;
+            acc += vec[i];
+            ref_incl[i] = acc;
+        }
+        
+        speed::algorithm::parallel_inclusive_scan(vec, sz, incl, std::plus<>(), exec);
+        speed::algorithm::parallel_exclusive_scan(vec, sz, excl, std::int64_t(0), std::plus<>(),
+                                                  exec);
+        EXPECT_TRUE(incl == ref_incl);
+        EXPECT_TRUE(excl == ref_excl);
+        
+        speed::algorithm::parallel_exclusive_scan(vec, sz, vec, std::int64_t(0), std::plus<>());
+        EXPECT_TRUE(vec == ref_excl);
+    }
+    
+    std::vector<std::string> strs(20000);
+    std::vector<std::string> res(strs.size());
+    std::vector<std::string> ref(strs.size());
+    
+    for (std::size_t i = 0; i < strs.size(); ++i)
+    {
+        strs[i] = std::to_string(i * 7919 % 20011);
+        ref[i] = i == 0 ? strs[i] : std::max(ref[i - 1], strs[i]);
+    }
+    
+    speed::algorithm::parallel_inclusive_scan(strs, strs.size(), res, [](auto lhs, auto rhs)
+    {
+        return std::max(lhs, rhs);
+    }, exec);
+    EXPECT_TRUE(res == ref);
+}
@@ -0,0 +1,189 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/radix_sort_test.cpp
+ * @brief       radix_sort unit test.
+ * @author      Killian
+ * @date        2018/09/22 - 15:07
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_radix_sort, integers)
+{
+    std::mt19937_64 gen(31);
+    std::vector<std::uint64_t> uvec(50000);
+    std::vector<std::int32_t> ivec(50000);
+    std::vector<std::int16_t> svec(1000);
+    std::uint8_t arr[300];
+    
+    for (auto& x : uvec)
+    {
+        x = gen() >> (gen() % 64);
+    }
+    
+    for (auto& x : ivec)
+    {
+        x = static_cast<std::int32_t>(gen());
+    }
+    
+    for (auto& x : svec)
+    {
+        x = static_cast<std::int16_t>(static_cast<std::int64_t>(gen() % 200) - 100);
+    }
+    
+    for (auto& x : arr)
+    {
+        x = static_cast<std::uint8_t>(gen());
+    }
+    
+    ivec[0] = std::numeric_limits<std::int32_t>::min();
+    ivec[1] = std::numeric_limits<std::int32_t>::max();
+    
+    auto uref = uvec;
+    auto iref = ivec;
+    auto sref = svec;
+    std::sort(uref.begin(), uref.end());
+    std::sort(iref.begin(), iref.end());
+    std::sort(sref.begin(), sref.end());
+    
+    speed::algorithm::radix_sort(uvec, uvec.size());
+    speed::algorithm::radix_sort(ivec, ivec.size());
+    speed::algorithm::radix_sort(svec, svec.size());
+    speed::algorithm::radix_sort(arr, 300);
+    
+    EXPECT_TRUE(uvec == uref);
+    EXPECT_TRUE(ivec == iref);
+    EXPECT_TRUE(svec == sref);
+    EXPECT_TRUE(std::is_sorted(arr, arr + 300));
+}
+
+
+TEST(algorithm_radix_sort, floating_points)
+{
+    std::mt19937 gen(37);
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    std::vector<double> dvec(20000);
+    std::vector<float> fvec(20000);
+    
+    for (std::size_t i = 0; i < dvec.size(); ++i)
+    {
+        dvec[i] = dist(gen);
+        fvec[i] = static_cast<float>(dist(gen) * 1e-9);
+    }
+    
+    dvec[0] = -std::numeric_limits<double>::infinity();
+    dvec[1] = std::numeric_limits<double>::infinity();
+    dvec[2] = std::numeric_limits<double>::denorm_min();
+    fvec[0] = -std::numeric_limits<float>::max();
+    
+    auto dref = dvec;
+    auto fref = fvec;
+    std::sort(dref.begin(), dref.end());
+    std::sort(fref.begin(), fref.end());
+    
+    speed::algorithm::radix_sort(dvec, dvec.size());
+    speed::algorithm::radix_sort(fvec, fvec.size());
+    
+    EXPECT_TRUE(dvec == dref);
+    EXPECT_TRUE(fvec == fref);
+}
+
+
+TEST(algorithm_radix_sort, strings)
+{
+    std::mt19937 gen(41);
+    std::vector<std::string> strs(20000);
+    
+    for (auto& x : strs)
+    {
+        x.resize(gen() % 12);
+        
+        for (auto& y : x)
+        {
+            y = static_cast<char>("abc\xe9"[gen() % 4]);
+        }
+    }
+    
+    strs.push_back(std::string(1000, 'a'));
+    strs.push_back(std::string(1000, 'a'));
+    
+    auto ref = strs;
+    std::sort(ref.begin(), ref.end());
+    speed::algorithm::radix_sort(strs, strs.size());
+    EXPECT_TRUE(strs == ref);
+}
+
+
+TEST(algorithm_radix_sort, stability)
+{
+    struct record
+    {
+        std::int64_t ky;
+        std::string nme;
+        std::size_t idx;
+    };
+    
+    std::mt19937 gen(43);
+    std::vector<record> recs(10000);
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        recs[i] = {static_cast<std::int64_t>(gen() % 50) - 25, std::to_string(gen() % 30), i};
+    }
+    
+    auto ref = recs;
+    std::stable_sort(ref.begin(), ref.end(), [](const record& lhs, const record& rhs)
+    {
+        return lhs.ky < rhs.ky;
+    });
+    speed::algorithm::radix_sort(recs, recs.size(), [](const record& x)
+    {
+        return x.ky;
+    });
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        EXPECT_TRUE(recs[i].idx == ref[i].idx);
+    }
+    
+    std::stable_sort(ref.begin(), ref.end(), [](const record& lhs, const record& rhs)
+    {
+        return lhs.nme < rhs.nme;
+    });
+    speed::algorithm::radix_sort(recs, recs.size(), [](const record& x) -> const std::string&
+    {
+        return x.nme;
+    });
+    
+    for (std::size_t i = 0; i < recs.size(); ++i)
+    {
+        EXPECT_TRUE(recs[i].idx == ref[i].idx);
+    }
+}
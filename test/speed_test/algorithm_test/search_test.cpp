@@ -0,0 +1,196 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/search_test.cpp
+ * @brief       search unit test.
+ * @author      Killian
+ * @date        2018/09/24 - 14:18
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_search, branchless_bounds)
+{
+    std::mt19937 gen(7);
+    std::vector<std::int32_t> vec;
+    std::vector<std::string> strs = {"b", "d", "d", "f", "h"};
+    std::size_t sz;
+    std::int32_t val;
+    
+    for (sz = 0; sz < 300; ++sz)
+    {
+        vec.resize(sz);
+        for (auto& x : vec)
+        {
+            x = static_cast<std::int32_t>(gen() % 100);
+        }
+        std::sort(vec.begin(), vec.end());
+        
+        for (val = -1; val <= 100; ++val)
+        {
+            EXPECT_TRUE(speed::algorithm::branchless_lower_bound(vec, sz, val) ==
+                        static_cast<std::size_t>(
+                                std::lower_bound(vec.begin(), vec.end(), val) - vec.begin()));
+            EXPECT_TRUE(speed::algorithm::branchless_upper_bound(vec, sz, val) ==
+                        static_cast<std::size_t>(
+                                std::upper_bound(vec.begin(), vec.end(), val) - vec.begin()));
+        }
+    }
+    
+    EXPECT_TRUE(speed::algorithm::branchless_lower_bound(strs, strs.size(), "d") == 1);
+    EXPECT_TRUE(speed::algorithm::branchless_upper_bound(strs, strs.size(), "d") == 3);
+    EXPECT_TRUE(speed::algorithm::branchless_lower_bound(strs, strs.size(), "z") == 5);
+    
+    std::reverse(strs.begin(), strs.end());
+    EXPECT_TRUE(speed::algorithm::branchless_lower_bound(strs, strs.size(), std::string("d"),
+                                                         std::greater<>()) == 2);
+    EXPECT_TRUE(speed::algorithm::branchless_upper_bound(strs, strs.size(), std::string("d"),
+                                                         std::greater<>()) == 4);
+}
+
+
+TEST(algorithm_search, eytzinger_bounds)
+{
+    std::mt19937 gen(11);
+    std::vector<std::int64_t> vec;
+    std::vector<std::int64_t> eytz;
+    std::size_t sz;
+    std::size_t idx;
+    std::int64_t val;
+    
+    for (sz = 0; sz < 300; ++sz)
+    {
+        vec.resize(sz);
+        eytz.resize(sz);
+        for (auto& x : vec)
+        {
+            x = static_cast<std::int64_t>(gen() % 100);
+        }
+        std::sort(vec.begin(), vec.end());
+        speed::algorithm::make_eytzinger_layout(vec, sz, eytz);
+        
+        for (val = -1; val <= 100; ++val)
+        {
+            auto lb = std::lower_bound(vec.begin(), vec.end(), val);
+            auto ub = std::upper_bound(vec.begin(), vec.end(), val);
+            
+            idx = speed::algorithm::eytzinger_lower_bound(eytz, sz, val);
+            EXPECT_TRUE(lb == vec.end() ? idx == sz : idx < sz && eytz[idx] == *lb);
+            
+            idx = speed::algorithm::eytzinger_upper_bound(eytz, sz, val);
+            EXPECT_TRUE(ub == vec.end() ? idx == sz : idx < sz && eytz[idx] == *ub);
+        }
+    }
+    
+    std::int32_t arr[7] = {10, 20, 30, 40, 50, 60, 70};
+    std::int32_t eytz_arr[7];
+    
+    speed::algorithm::make_eytzinger_layout(arr, 7, eytz_arr);
+    EXPECT_TRUE(std::vector<std::int32_t>(eytz_arr, eytz_arr + 7) ==
+                std::vector<std::int32_t>({40, 20, 60, 10, 30, 50, 70}));
+    EXPECT_TRUE(speed::algorithm::eytzinger_lower_bound(eytz_arr, 7, 35) == 0);
+    EXPECT_TRUE(speed::algorithm::eytzinger_upper_bound(eytz_arr, 7, 70) == 7);
+}
+
+
+TEST(algorithm_search, kary_lower_bound)
+{
+    std::mt19937 gen(13);
+    std::vector<std::int32_t> ivec;
+    std::vector<float> fvec;
+    std::vector<double> dvec;
+    std::vector<std::uint16_t> uvec;
+    std::vector<std::int32_t> ikary;
+    std::vector<float> fkary;
+    std::vector<double> dkary;
+    std::vector<std::uint16_t> ukary;
+    std::size_t sz;
+    std::size_t kary_sz;
+    std::int32_t val;
+    
+    auto check = [&](const auto& vec, const auto& kary, auto x)
+    {
+        auto lb = std::lower_bound(vec.begin(), vec.end(), x);
+        std::size_t idx = speed::algorithm::kary_lower_bound(kary, kary_sz, x);
+        
+        return lb == vec.end() ? idx == kary_sz : idx < kary_sz && kary[idx] == *lb;
+    };
+    
+    for (sz = 0; sz < 1200; sz += 1 + sz / 16)
+    {
+        kary_sz = speed::algorithm::get_kary_layout_size(sz);
+        ivec.resize(sz);
+        fvec.resize(sz);
+        dvec.resize(sz);
+        uvec.resize(sz);
+        ikary.resize(kary_sz);
+        fkary.resize(kary_sz);
+        dkary.resize(kary_sz);
+        ukary.resize(kary_sz);
+        
+        for (std::size_t i = 0; i < sz; ++i)
+        {
+            ivec[i] = static_cast<std::int32_t>(gen() % 200) - 100;
+            fvec[i] = static_cast<float>(ivec[i]) / 2;
+            dvec[i] = static_cast<double>(ivec[i]) / 4;
+            uvec[i] = static_cast<std::uint16_t>(ivec[i] + 100);
+        }
+        std::sort(ivec.begin(), ivec.end());
+        std::sort(fvec.begin(), fvec.end());
+        std::sort(dvec.begin(), dvec.end());
+        std::sort(uvec.begin(), uvec.end());
+        
+        speed::algorithm::make_kary_layout(ivec, sz, ikary);
+        speed::algorithm::make_kary_layout(fvec, sz, fkary);
+        speed::algorithm::make_kary_layout(dvec, sz, dkary);
+        speed::algorithm::make_kary_layout(uvec, sz, ukary);
+        
+        for (val = -102; val <= 102; ++val)
+        {
+            EXPECT_TRUE(check(ivec, ikary, val));
+            EXPECT_TRUE(check(fvec, fkary, static_cast<float>(val) / 2));
+            EXPECT_TRUE(check(dvec, dkary, static_cast<double>(val) / 4));
+            EXPECT_TRUE(check(uvec, ukary, static_cast<std::uint16_t>(val + 102)));
+        }
+    }
+    
+    std::int32_t arr[20];
+    std::int32_t kary_arr[32];
+    
+    for (std::int32_t i = 0; i < 20; ++i)
+    {
+        arr[i] = 40 - 2 * i;
+    }
+    
+    speed::algorithm::make_kary_layout(arr, 20, kary_arr);
+    EXPECT_TRUE(speed::algorithm::get_kary_layout_size(20) == 32);
+    EXPECT_TRUE(kary_arr[speed::algorithm::kary_lower_bound(kary_arr, 32, 7, std::greater<>())] ==
+                6);
+    EXPECT_TRUE(speed::algorithm::kary_lower_bound(kary_arr, 32, 1, std::greater<>()) == 32);
+}
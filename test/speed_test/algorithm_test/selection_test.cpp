@@ -0,0 +1,128 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/selection_test.cpp
+ * @brief       selection unit test.
+ * @author      Killian
+ * @date        2018/09/25 - 13:27
+ */
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_selection, nth_element)
+{
+    std::mt19937 gen(53);
+    std::vector<int> vec;
+    std::vector<int> ref;
+    
+    for (std::size_t sz : {0, 1, 2, 17, 100, 1000, 30000})
+    {
+        for (std::size_t dstr = 0; dstr < 4; ++dstr)
+        {
+            vec.resize(sz);
+            for (std::size_t i = 0; i < sz; ++i)
+            {
+                switch (dstr)
+                {
+                    case 0:
+                        vec[i] = static_cast<int>(gen());
+                        break;
+                    case 1:
+                        vec[i] = static_cast<int>(gen() % 4);
+                        break;
+                    case 2:
+                        vec[i] = static_cast<int>(i);
+                        break;
+                    default:
+                        vec[i] = static_cast<int>(sz - i);
+                        break;
+                }
+            }
+            
+            ref = vec;
+            std::sort(ref.begin(), ref.end());
+            
+            for (std::size_t nth : {std::size_t(0), sz / 3, sz / 2, sz - 1})
+            {
+                if (nth >= sz)
+                {
+                    continue;
+                }
+                
+                std::shuffle(vec.begin(), vec.end(), gen);
+                speed::algorithm::nth_element(vec, sz, nth);
+                
+                EXPECT_TRUE(vec[nth] == ref[nth]);
+                EXPECT_TRUE(std::all_of(vec.begin(), vec.begin() + static_cast<long>(nth),
+                                        [&](int x) { return x <= vec[nth]; }));
+                EXPECT_TRUE(std::all_of(vec.begin() + static_cast<long>(nth), vec.end(),
+                                        [&](int x) { return x >= vec[nth]; }));
+            }
+        }
+    }
+    
+    std::vector<std::string> strs = {"d", "a", "e", "c", "b"};
+    
+    speed::algorithm::nth_element(strs, strs.size(), 1, std::greater<>());
+    EXPECT_TRUE(strs[1] == "d");
+    
+    speed::algorithm::nth_element(strs, strs.size(), 5);
+    EXPECT_TRUE(strs[1] == "d");
+}
+
+
+TEST(algorithm_selection, partial_sort)
+{
+    std::mt19937 gen(59);
+    std::vector<double> vec(5000);
+    std::vector<double> ref;
+    
+    for (auto& x : vec)
+    {
+        x = static_cast<double>(gen() % 1000) / 8;
+    }
+    
+    ref = vec;
+    std::sort(ref.begin(), ref.end());
+    
+    for (std::size_t nbr_sorted : {0, 1, 10, 100, 4999, 5000, 6000})
+    {
+        std::shuffle(vec.begin(), vec.end(), gen);
+        speed::algorithm::partial_sort(vec, vec.size(), nbr_sorted);
+        
+        for (std::size_t i = 0; i < std::min(nbr_sorted, vec.size()); ++i)
+        {
+            EXPECT_TRUE(vec[i] == ref[i]);
+        }
+    }
+    
+    std::vector<std::string> strs = {"d", "a", "e", "c", "b"};
+    
+    speed::algorithm::partial_sort(strs, strs.size(), 2, std::greater<>());
+    EXPECT_TRUE(strs[0] == "e" && strs[1] == "d");
+}
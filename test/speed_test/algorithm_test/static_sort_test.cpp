@@ -0,0 +1,92 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/static_sort_test.cpp
+ * @brief       static_sort unit test.
+ * @author      Killian
+ * @date        2018/09/23 - 14:52
+ */
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+namespace {
+
+
+template<std::size_t N>
+void check_static_sort(std::mt19937& gen)
+{
+    std::array<int, N> arr;
+    std::array<int, N> ref;
+    
+    for (std::size_t i = 0; i < 200; ++i)
+    {
+        for (auto& x : arr)
+        {
+            x = static_cast<int>(gen() % (i % 2 == 0 ? 1000 : 4));
+        }
+        
+        ref = arr;
+        std::sort(ref.begin(), ref.end());
+        speed::algorithm::static_sort<N>(arr);
+        EXPECT_TRUE(arr == ref);
+    }
+}
+
+
+template<std::size_t... IDXS>
+void check_static_sorts(std::mt19937& gen, std::index_sequence<IDXS...>)
+{
+    (check_static_sort<IDXS>(gen), ...);
+}
+
+
+}
+
+
+TEST(algorithm_static_sort, sizes)
+{
+    std::mt19937 gen(47);
+    
+    check_static_sorts(gen, std::make_index_sequence<33>());
+}
+
+
+TEST(algorithm_static_sort, compare)
+{
+    std::vector<std::string> strs = {"d", "a", "c", "b", "e", "a"};
+    double arr[5] = {3.5, -1.0, 2.0, 8.25, 0.0};
+    
+    speed::algorithm::static_sort<6>(strs, std::greater<>());
+    speed::algorithm::static_sort<4>(arr);
+    
+    EXPECT_TRUE(strs == std::vector<std::string>({"e", "d", "c", "b", "a", "a"}));
+    EXPECT_TRUE(arr[0] == -1.0 && arr[1] == 2.0 && arr[2] == 3.5 && arr[3] == 8.25);
+    EXPECT_TRUE(arr[4] == 0.0);
+}
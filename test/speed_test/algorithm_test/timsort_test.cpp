@@ -0,0 +1,131 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/timsort_test.cpp
+ * @brief       timsort unit test.
+ * @author      Killian
+ * @date        2018/09/28 - 14:51
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_timsort, timsort)
+{
+    std::mt19937 gen(7);
+    std::vector<std::int32_t> vec;
+    std::string strs[100];
+    
+    for (std::size_t sz : {0, 1, 2, 63, 64, 65, 1000, 100000})
+    {
+        for (int pat = 0; pat < 6; ++pat)
+        {
+            vec.resize(sz);
+            for (std::size_t i = 0; i < sz; ++i)
+            {
+                auto x = static_cast<std::int32_t>(i);
+                
+                if (pat == 0)
+                {
+                    x = static_cast<std::int32_t>(gen());
+                }
+                else if (pat == 2)
+                {
+                    x = -x;
+                }
+                else if (pat == 3)
+                {
+                    x = static_cast<std::int32_t>(gen() % 4);
+                }
+                else if (pat == 4)
+                {
+                    x = x % 1000 + (x / 1000) % 3;
+                }
+                else if (pat == 5 && i >= sz / 2)
+                {
+                    x = static_cast<std::int32_t>(gen());
+                }
+                
+                vec[i] = x;
+            }
+            
+            auto ref = vec;
+            std::sort(ref.begin(), ref.end());
+            
+            speed::algorithm::timsort(vec, vec.size());
+            EXPECT_TRUE(vec == ref);
+        }
+    }
+    
+    for (auto& x : strs)
+    {
+        x = std::to_string(gen() % 500);
+    }
+    
+    speed::algorithm::timsort(strs, 100, std::greater<>());
+    EXPECT_TRUE(std::is_sorted(std::begin(strs), std::end(strs), std::greater<>()));
+}
+
+
+TEST(algorithm_timsort, stability)
+{
+    std::mt19937 gen(8);
+    std::vector<std::pair<std::int32_t, std::size_t>> vec;
+    
+    auto comp = [](const auto& lhs, const auto& rhs)
+    {
+        return lhs.first < rhs.first;
+    };
+    
+    for (std::size_t sz : {50, 5000, 200000})
+    {
+        for (std::size_t nbr_kys : {2, 100, 100000})
+        {
+            vec.resize(sz);
+            for (std::size_t i = 0; i < sz; ++i)
+            {
+                vec[i] = {static_cast<std::int32_t>(gen() % nbr_kys), i};
+            }
+            
+            if (nbr_kys == 100)
+            {
+                std::sort(vec.begin(), vec.begin() + sz / 3, comp);
+                std::sort(vec.begin() + sz / 3, vec.end(), [](const auto& lhs, const auto& rhs)
+                {
+                    return lhs.first > rhs.first;
+                });
+            }
+            
+            auto ref = vec;
+            std::stable_sort(ref.begin(), ref.end(), comp);
+            
+            speed::algorithm::timsort(vec, vec.size(), comp);
+            EXPECT_TRUE(vec == ref);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/top_k_test.cpp
+ * @brief       top_k unit test.
+ * @author      Killian
+ * @date        2018/09/25 - 17:05
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+namespace {
+
+
+template<typename TpValue>
+void check_top_k(const std::vector<TpValue>& vals, std::size_t k)
+{
+    speed::algorithm::top_k<TpValue> tk(k);
+    speed::algorithm::top_k<TpValue> tk_one(k);
+    std::vector<TpValue> ref(vals);
+    
+    std::sort(ref.begin(), ref.end(), std::greater<>());
+    ref.resize(std::min(k, ref.size()));
+    
+    for (std::size_t i = 0; i < vals.size(); i += 1000)
+    {
+        tk.push(vals.data() + i, std::min(std::size_t(1000), vals.size() - i));
+    }
+    
+    for (auto& x : vals)
+    {
+        tk_one.push(x);
+    }
+    
+    EXPECT_TRUE(tk.get_values() == ref);
+    EXPECT_TRUE(tk_one.get_values() == ref);
+    EXPECT_TRUE(tk.size() == ref.size());
+}
+
+
+}
+
+
+TEST(algorithm_top_k, push)
+{
+    std::mt19937 gen(61);
+    std::vector<std::int32_t> ivec(100000);
+    std::vector<float> fvec(100000);
+    std::vector<double> dvec(100000);
+    std::vector<std::uint64_t> uvec(100000);
+    
+    for (std::size_t i = 0; i < ivec.size(); ++i)
+    {
+        ivec[i] = static_cast<std::int32_t>(gen());
+        fvec[i] = static_cast<float>(gen() % 100000) / 3;
+        dvec[i] = static_cast<double>(gen() % 5000) / 7;
+        uvec[i] = gen();
+    }
+    
+    for (std::size_t k : {0, 1, 7, 100, 1000})
+    {
+        check_top_k(ivec, k);
+        check_top_k(fvec, k);
+        check_top_k(dvec, k);
+        check_top_k(uvec, k);
+    }
+    
+    std::sort(ivec.begin(), ivec.end());
+    check_top_k(ivec, 100);
+    
+    std::reverse(ivec.begin(), ivec.end());
+    check_top_k(ivec, 100);
+    
+    check_top_k(std::vector<std::int32_t>({3, 1, 2}), 10);
+}
+
+
+TEST(algorithm_top_k, compare)
+{
+    speed::algorithm::top_k<std::string, std::greater<>> tk(2);
+    
+    EXPECT_TRUE(tk.empty());
+    tk.push({"d", "b", "e", "a", "c"});
+    EXPECT_TRUE(tk.get_values() == std::vector<std::string>({"a", "b"}));
+    EXPECT_TRUE(tk.get_threshold() == "b");
+    EXPECT_TRUE(tk.get_k() == 2);
+    
+    tk.clear();
+    EXPECT_TRUE(tk.empty());
+}
+
+
+TEST(algorithm_top_k, merge)
+{
+    std::vector<speed::algorithm::top_k<float>> tks(4, speed::algorithm::top_k<float>(50));
+    std::vector<std::thread> thrds;
+    std::vector<float> ref;
+    
+    for (std::size_t i = 0; i < tks.size(); ++i)
+    {
+        thrds.emplace_back([&, i]()
+        {
+            std::mt19937 gen(static_cast<std::uint32_t>(i));
+            std::vector<float> vals(10000);
+            
+            for (auto& x : vals)
+            {
+                x = static_cast<float>(gen() % 1000000);
+            }
+            
+            tks[i].push(vals);
+        });
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+    
+    for (std::size_t i = 0; i < tks.size(); ++i)
+    {
+        std::mt19937 gen(static_cast<std::uint32_t>(i));
+        
+        for (std::size_t j = 0; j < 10000; ++j)
+        {
+            ref.push_back(static_cast<float>(gen() % 1000000));
+        }
+    }
+    
+    std::sort(ref.begin(), ref.end(), std::greater<>());
+    ref.resize(50);
+    
+    for (std::size_t i = 1; i < tks.size(); ++i)
+    {
+        tks[0].merge(tks[i]);
+    }
+    
+    EXPECT_TRUE(tks[0].get_values() == ref);
+}
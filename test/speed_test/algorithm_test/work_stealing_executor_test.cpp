@@ -0,0 +1,105 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/algorithm_test/work_stealing_executor_test.cpp
+ * @brief       work_stealing_executor unit test.
+ * @author      Killian
+ * @date        2018/09/26 - 14:45
+ */
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/algorithm.hpp"
+
+
+TEST(algorithm_work_stealing_executor, bulk_run)
+{
+    speed::algorithm::work_stealing_executor exec(4);
+    std::vector<std::atomic<int>> cnts(1000);
+    
+    EXPECT_TRUE(exec.get_concurrency() == 4);
+    
+    for (std::size_t nbr_tasks : {0, 1, 3, 4, 1000})
+    {
+        for (auto& x : cnts)
+        {
+            x = 0;
+        }
+        
+        exec.bulk_run(nbr_tasks, [&](std::size_t task_idx)
+        {
+            if (task_idx % 7 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+            
+            ++cnts[task_idx];
+        });
+        
+        for (std::size_t i = 0; i < cnts.size(); ++i)
+        {
+            EXPECT_TRUE(cnts[i] == (i < nbr_tasks ? 1 : 0));
+        }
+    }
+}
+
+
+TEST(algorithm_work_stealing_executor, nested_and_exceptions)
+{
+    speed::algorithm::work_stealing_executor exec(3);
+    std::atomic<int> cnt(0);
+    
+    exec.bulk_run(10, [&](std::size_t)
+    {
+        exec.bulk_run(10, [&](std::size_t) { ++cnt; });
+    });
+    EXPECT_TRUE(cnt == 100);
+    
+    cnt = 0;
+    EXPECT_THROW(exec.bulk_run(50, [&](std::size_t task_idx)
+    {
+        ++cnt;
+        if (task_idx == 17)
+        {
+            throw std::runtime_error("task");
+        }
+    }), std::runtime_error);
+    EXPECT_TRUE(cnt == 50);
+    
+    cnt = 0;
+    exec.bulk_run(20, [&](std::size_t) { ++cnt; });
+    EXPECT_TRUE(cnt == 20);
+}
+
+
+TEST(algorithm_work_stealing_executor, sequential_executor)
+{
+    speed::algorithm::sequential_executor exec;
+    std::vector<std::size_t> ordr;
+    
+    exec.bulk_run(5, [&](std::size_t task_idx) { ordr.push_back(task_idx); });
+    EXPECT_TRUE(ordr == std::vector<std::size_t>({0, 1, 2, 3, 4}));
+    EXPECT_TRUE(exec.get_concurrency() == 1);
+}
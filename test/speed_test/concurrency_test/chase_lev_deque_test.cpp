@@ -0,0 +1,131 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/concurrency_test/chase_lev_deque_test.cpp
+ * @brief       chase_lev_deque unit test.
+ * @author      Killian
+ * @date        2018/09/30 - 16:05
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/concurrency.hpp"
+
+
+TEST(concurrency_chase_lev_deque, push_pop)
+{
+    speed::concurrency::chase_lev_deque<int> dq(4);
+    int val;
+    
+    for (int i = 0; i < 100; ++i)
+    {
+        dq.push(i);
+    }
+    
+    EXPECT_TRUE(dq.size() == 100);
+    EXPECT_TRUE(dq.get_capacity() >= 100);
+    
+    for (int i = 99; i >= 0; --i)
+    {
+        EXPECT_TRUE(dq.pop(val));
+        EXPECT_TRUE(val == i);
+    }
+    
+    EXPECT_FALSE(dq.pop(val));
+    EXPECT_TRUE(dq.empty());
+}
+
+
+TEST(concurrency_chase_lev_deque, steal)
+{
+    speed::concurrency::chase_lev_deque<int> dq;
+    int val;
+    
+    dq.push(1);
+    dq.push(2);
+    dq.push(3);
+    
+    EXPECT_TRUE(dq.steal(val));
+    EXPECT_TRUE(val == 1);
+    EXPECT_TRUE(dq.pop(val));
+    EXPECT_TRUE(val == 3);
+    EXPECT_TRUE(dq.steal(val));
+    EXPECT_TRUE(val == 2);
+    EXPECT_FALSE(dq.steal(val));
+    EXPECT_FALSE(dq.pop(val));
+}
+
+
+TEST(concurrency_chase_lev_deque, concurrent_steal)
+{
+    constexpr int nbr_vals = 200000;
+    constexpr int nbr_thiefs = 3;
+    
+    speed::concurrency::chase_lev_deque<int> dq(16);
+    std::vector<std::atomic<int>> cnts(nbr_vals);
+    std::vector<std::thread> thiefs;
+    std::atomic<bool> dne(false);
+    int val;
+    
+    for (int i = 0; i < nbr_thiefs; ++i)
+    {
+        thiefs.emplace_back([&]
+        {
+            int stln;
+            
+            while (!dne.load())
+            {
+                if (dq.steal(stln))
+                {
+                    cnts[stln].fetch_add(1);
+                }
+            }
+        });
+    }
+    
+    for (int i = 0; i < nbr_vals; ++i)
+    {
+        dq.push(i);
+        if (i % 3 == 0 && dq.pop(val))
+        {
+            cnts[val].fetch_add(1);
+        }
+    }
+    
+    while (dq.pop(val))
+    {
+        cnts[val].fetch_add(1);
+    }
+    
+    dne.store(true);
+    for (auto& x : thiefs)
+    {
+        x.join();
+    }
+    
+    for (auto& x : cnts)
+    {
+        EXPECT_TRUE(x.load() == 1);
+    }
+}
@@ -0,0 +1,282 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/concurrency_test/future_test.cpp
+ * @brief       future unit test.
+ * @author      Killian
+ * @date        2018/10/02 - 17:12
+ */
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/concurrency.hpp"
+
+
+TEST(concurrency_future, promise_set_value)
+{
+    speed::concurrency::promise<int> prms;
+    speed::concurrency::future<int> fut = prms.get_future();
+    
+    EXPECT_TRUE(fut.valid());
+    EXPECT_FALSE(fut.is_ready());
+    EXPECT_THROW(prms.get_future(), speed::concurrency::future_already_retrieved_exception);
+    
+    std::thread thrd([&] { prms.set_value(42); });
+    
+    EXPECT_EQ(fut.get(), 42);
+    EXPECT_FALSE(fut.valid());
+    thrd.join();
+    EXPECT_THROW(prms.set_value(1), speed::concurrency::promise_already_satisfied_exception);
+}
+
+
+TEST(concurrency_future, promise_set_exception)
+{
+    speed::concurrency::promise<void> prms;
+    speed::concurrency::future<void> fut = prms.get_future();
+    
+    prms.set_exception(std::make_exception_ptr(std::runtime_error("error")));
+    EXPECT_TRUE(fut.is_ready());
+    EXPECT_THROW(fut.get(), std::runtime_error);
+}
+
+
+TEST(concurrency_future, broken_promise)
+{
+    speed::concurrency::future<std::string> fut;
+    
+    {
+        speed::concurrency::promise<std::string> prms;
+        
+        fut = prms.get_future();
+    }
+    
+    EXPECT_THROW(fut.get(), speed::concurrency::broken_promise_exception);
+}
+
+
+TEST(concurrency_future, make_ready_future)
+{
+    speed::concurrency::future<std::string> fut = speed::concurrency::make_ready_future(
+            std::string("abc"));
+    speed::concurrency::future<void> vd_fut = speed::concurrency::make_ready_future();
+    speed::concurrency::future<int> excptn_fut =
+            speed::concurrency::make_exceptional_future<int>(
+                    std::make_exception_ptr(std::logic_error("error")));
+    
+    EXPECT_TRUE(fut.is_ready());
+    EXPECT_EQ(fut.get(), "abc");
+    EXPECT_TRUE(vd_fut.is_ready());
+    vd_fut.get();
+    EXPECT_FALSE(vd_fut.valid());
+    EXPECT_THROW(excptn_fut.get(), std::logic_error);
+}
+
+
+TEST(concurrency_future, then)
+{
+    using speed::concurrency::future;
+    
+    speed::concurrency::promise<int> prms;
+    future<std::string> fut = prms.get_future()
+            .then([](future<int> x) { return x.get() * 2; })
+            .then([](future<int> x) { return std::to_string(x.get()); });
+    
+    EXPECT_FALSE(fut.is_ready());
+    prms.set_value(21);
+    EXPECT_TRUE(fut.is_ready());
+    EXPECT_EQ(fut.get(), "42");
+    
+    future<int> rdy_fut = speed::concurrency::make_ready_future(1)
+            .then([](future<int> x) { return x.get() + 1; });
+    
+    EXPECT_TRUE(rdy_fut.is_ready());
+    EXPECT_EQ(rdy_fut.get(), 2);
+    
+    future<void> excptn_fut = speed::concurrency::make_ready_future(1)
+            .then([](future<int>) -> int { throw std::runtime_error("error"); })
+            .then([](future<int> x) { x.get(); });
+    
+    EXPECT_THROW(excptn_fut.get(), std::runtime_error);
+}
+
+
+TEST(concurrency_future, then_executor)
+{
+    using speed::concurrency::future;
+    
+    speed::concurrency::thread_pool pool(4);
+    std::vector<future<int>> futs;
+    std::vector<speed::concurrency::promise<int>> prmss(100);
+    
+    for (auto& x : prmss)
+    {
+        futs.push_back(x.get_future().then(pool, [&pool](future<int> y)
+        {
+            EXPECT_LT(pool.get_worker_index(), 4u);
+            return y.get() + 1;
+        }));
+    }
+    
+    for (std::size_t i = 0; i < prmss.size(); ++i)
+    {
+        prmss[i].set_value(static_cast<int>(i));
+    }
+    
+    for (std::size_t i = 0; i < futs.size(); ++i)
+    {
+        EXPECT_EQ(futs[i].get(), static_cast<int>(i) + 1);
+    }
+}
+
+
+TEST(concurrency_future, when_all)
+{
+    using speed::concurrency::future;
+    
+    std::vector<speed::concurrency::promise<int>> prmss(8);
+    std::vector<future<int>> futs;
+    
+    for (auto& x : prmss)
+    {
+        futs.push_back(x.get_future());
+    }
+    futs.push_back(speed::concurrency::make_ready_future(8));
+    
+    future<std::vector<future<int>>> all_fut = speed::concurrency::when_all(std::move(futs));
+    std::thread thrd([&]
+    {
+        for (std::size_t i = 0; i < prmss.size(); ++i)
+        {
+            prmss[i].set_value(static_cast<int>(i));
+        }
+    });
+    
+    std::vector<future<int>> rdy_futs = all_fut.get();
+    
+    ASSERT_EQ(rdy_futs.size(), 9u);
+    for (std::size_t i = 0; i < rdy_futs.size(); ++i)
+    {
+        EXPECT_EQ(rdy_futs[i].get(), static_cast<int>(i));
+    }
+    thrd.join();
+    
+    speed::concurrency::promise<std::string> str_prms;
+    auto tpl_fut = speed::concurrency::when_all(speed::concurrency::make_ready_future(1),
+                                                str_prms.get_future());
+    
+    EXPECT_FALSE(tpl_fut.is_ready());
+    str_prms.set_value("a");
+    
+    auto tpl = tpl_fut.get();
+    
+    EXPECT_EQ(std::get<0>(tpl).get(), 1);
+    EXPECT_EQ(std::get<1>(tpl).get(), "a");
+    EXPECT_TRUE(speed::concurrency::when_all(std::vector<future<int>>()).get().empty());
+}
+
+
+TEST(concurrency_future, when_any)
+{
+    using speed::concurrency::future;
+    
+    std::vector<speed::concurrency::promise<int>> prmss(4);
+    std::vector<future<int>> futs;
+    
+    for (auto& x : prmss)
+    {
+        futs.push_back(x.get_future());
+    }
+    
+    future<speed::concurrency::when_any_result<int>> any_fut =
+            speed::concurrency::when_any(std::move(futs));
+    
+    EXPECT_FALSE(any_fut.is_ready());
+    prmss[2].set_value(2);
+    
+    auto res = any_fut.get();
+    
+    EXPECT_EQ(res.idx, 2u);
+    EXPECT_EQ(res.futs[2].get(), 2);
+    prmss[0].set_value(0);
+    EXPECT_EQ(res.futs[0].get(), 0);
+    EXPECT_EQ(speed::concurrency::when_any(std::vector<future<int>>()).get().idx,
+              speed::concurrency::when_any_result<int>::npos);
+}
+
+
+TEST(concurrency_future, when_any_leftovers)
+{
+    using speed::concurrency::future;
+    
+    std::vector<speed::concurrency::promise<int>> prmss(4);
+    std::vector<future<int>> futs;
+    bool called = false;
+    
+    for (auto& x : prmss)
+    {
+        futs.push_back(x.get_future());
+    }
+    
+    auto any_fut = speed::concurrency::when_any(std::move(futs));
+    
+    prmss[1].set_value(1);
+    
+    auto res = any_fut.get();
+    
+    ASSERT_EQ(res.idx, 1u);
+    
+    future<int> then_fut = std::move(res.futs[0]).then([&](future<int> fut)
+    {
+        called = true;
+        return fut.get() * 10;
+    });
+    
+    std::vector<future<int>> lft_futs;
+    
+    lft_futs.push_back(std::move(res.futs[2]));
+    lft_futs.push_back(std::move(res.futs[3]));
+    
+    auto all_fut = speed::concurrency::when_all(std::move(lft_futs));
+    
+    EXPECT_FALSE(called);
+    EXPECT_FALSE(then_fut.is_ready());
+    EXPECT_FALSE(all_fut.is_ready());
+    
+    prmss[0].set_value(5);
+    EXPECT_TRUE(called);
+    EXPECT_EQ(then_fut.get(), 50);
+    
+    prmss[2].set_value(2);
+    EXPECT_FALSE(all_fut.is_ready());
+    prmss[3].set_value(3);
+    
+    auto rdy_futs = all_fut.get();
+    
+    EXPECT_EQ(rdy_futs[0].get(), 2);
+    EXPECT_EQ(rdy_futs[1].get(), 3);
+    EXPECT_EQ(res.futs[1].get(), 1);
+}
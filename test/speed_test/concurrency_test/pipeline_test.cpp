@@ -0,0 +1,328 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/concurrency_test/pipeline_test.cpp
+ * @brief       pipeline unit test.
+ * @author      Killian
+ * @date        2018/10/06 - 15:20
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/concurrency.hpp"
+
+
+namespace {
+
+
+using speed::concurrency::flow_control;
+using speed::concurrency::make_stage;
+using speed::concurrency::stage_modes;
+
+
+/**
+ * @brief       Value that counts its living instances.
+ */
+struct counted
+{
+    explicit counted(int v)
+            : val(v)
+    {
+        ++nbr_lvng;
+    }
+    
+    counted(const counted& rhs)
+            : val(rhs.val)
+    {
+        ++nbr_lvng;
+    }
+    
+    ~counted()
+    {
+        --nbr_lvng;
+    }
+    
+    int val;
+    
+    static inline std::atomic<int> nbr_lvng = 0;
+};
+
+
+void spin(int n)
+{
+    for (int i = 0; i < n; ++i)
+    {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    }
+}
+
+
+}
+
+
+TEST(concurrency_pipeline, serial_in_order)
+{
+    speed::concurrency::thread_pool pool(4);
+    std::vector<std::string> outs;
+    int i = 0;
+    
+    speed::concurrency::pipeline pl(
+            pool,
+            make_stage<void, int>(stage_modes::SERIAL_IN_ORDER, [&](flow_control& fc)
+            {
+                if (i == 2000)
+                {
+                    fc.stop();
+                }
+                
+                return i++;
+            }) |
+            make_stage<int, std::string>(stage_modes::PARALLEL, [](int v)
+            {
+                spin((v * 7919) % 3000);
+                return std::to_string(v);
+            }) |
+            make_stage<std::string, void>(stage_modes::SERIAL_IN_ORDER, [&](std::string s)
+            {
+                outs.push_back(std::move(s));
+            }),
+            8,
+            true);
+    
+    for (int k = 0; k < 2; ++k)
+    {
+        i = 0;
+        outs.clear();
+        pl.run();
+        
+        ASSERT_TRUE(outs.size() == 2000);
+        for (int j = 0; j < 2000; ++j)
+        {
+            EXPECT_TRUE(outs[j] == std::to_string(j));
+        }
+        
+        auto stats = pl.get_statistics();
+        
+        ASSERT_TRUE(stats.size() == 3);
+        for (auto& x : stats)
+        {
+            EXPECT_TRUE(x.nbr_itms == 2000);
+            EXPECT_TRUE(x.thrpt > 0);
+            EXPECT_TRUE(x.max_q_sz <= pl.get_max_tokens());
+            EXPECT_TRUE(x.avg_q_sz >= 0 && x.avg_q_sz <= 8);
+        }
+        
+        EXPECT_TRUE(stats[1].mde == stage_modes::PARALLEL);
+        EXPECT_TRUE(stats[1].max_q_sz == 0);
+        EXPECT_TRUE(stats[1].bsy_tme.count() > 0);
+    }
+}
+
+
+TEST(concurrency_pipeline, serial_out_of_order)
+{
+    speed::concurrency::thread_pool pool(4);
+    std::atomic<int> in_stge(0);
+    std::atomic<bool> ovrlp(false);
+    std::vector<int> outs;
+    int i = 0;
+    
+    auto serial = [&](int v)
+    {
+        if (in_stge.fetch_add(1) != 0)
+        {
+            ovrlp = true;
+        }
+        
+        spin(200);
+        in_stge.fetch_sub(1);
+        
+        return v;
+    };
+    
+    speed::concurrency::pipeline pl(
+            pool,
+            make_stage<void, int>(stage_modes::SERIAL_OUT_OF_ORDER, [&](flow_control& fc)
+            {
+                if (i == 1000)
+                {
+                    fc.stop();
+                }
+                
+                return i++;
+            }) |
+            make_stage<int, int>(stage_modes::PARALLEL, [](int v)
+            {
+                spin((v * 31) % 2000);
+                return v * 2;
+            }) |
+            make_stage<int, int>(stage_modes::SERIAL_OUT_OF_ORDER, serial) |
+            make_stage<int, void>(stage_modes::SERIAL_OUT_OF_ORDER, [&](int v)
+            {
+                outs.push_back(v);
+            }));
+    
+    pl.run();
+    
+    EXPECT_FALSE(ovrlp.load());
+    ASSERT_TRUE(outs.size() == 1000);
+    std::sort(outs.begin(), outs.end());
+    for (int j = 0; j < 1000; ++j)
+    {
+        EXPECT_TRUE(outs[j] == j * 2);
+    }
+}
+
+
+TEST(concurrency_pipeline, token_limit)
+{
+    speed::concurrency::thread_pool pool(4);
+    std::atomic<int> in_flght(0);
+    std::atomic<int> max_in_flght(0);
+    int i = 0;
+    int nbr = 0;
+    
+    speed::concurrency::pipeline pl(
+            pool,
+            make_stage<void, std::unique_ptr<int>>(stage_modes::SERIAL_IN_ORDER,
+                                                   [&](flow_control& fc)
+            {
+                int cur = in_flght.fetch_add(1) + 1;
+                
+                if (i == 5000)
+                {
+                    in_flght.fetch_sub(1);
+                    fc.stop();
+                }
+                
+                max_in_flght = std::max(max_in_flght.load(), cur);
+                
+                return std::make_unique<int>(i++);
+            }) |
+            make_stage<std::unique_ptr<int>, int>(stage_modes::PARALLEL,
+                                                  [](std::unique_ptr<int> v)
+            {
+                spin(500);
+                return *v;
+            }) |
+            make_stage<int, void>(stage_modes::SERIAL_IN_ORDER, [&](int v)
+            {
+                EXPECT_TRUE(v == nbr);
+                ++nbr;
+                spin(1000);
+                in_flght.fetch_sub(1);
+            }),
+            3);
+    
+    pl.run();
+    
+    EXPECT_TRUE(nbr == 5000);
+    EXPECT_TRUE(pl.get_max_tokens() == 3);
+    EXPECT_TRUE(max_in_flght.load() <= 3);
+    EXPECT_TRUE(in_flght.load() == 0);
+}
+
+
+TEST(concurrency_pipeline, parallel_input)
+{
+    speed::concurrency::thread_pool pool(4);
+    std::atomic<int> i(0);
+    std::int64_t sm = 0;
+    int nbr = 0;
+    
+    speed::concurrency::pipeline pl(
+            pool,
+            make_stage<void, int>(stage_modes::PARALLEL, [&](flow_control& fc)
+            {
+                int v = i.fetch_add(1);
+                
+                if (v >= 3000)
+                {
+                    fc.stop();
+                }
+                
+                return v;
+            }) |
+            make_stage<int, void>(stage_modes::SERIAL_IN_ORDER, [&](int v)
+            {
+                sm += v;
+                ++nbr;
+            }));
+    
+    pl.run();
+    
+    EXPECT_TRUE(nbr == 3000);
+    EXPECT_TRUE(sm == 2999LL * 3000 / 2);
+}
+
+
+TEST(concurrency_pipeline, exception)
+{
+    speed::concurrency::thread_pool pool(4);
+    int i = 0;
+    int lst = -1;
+    bool thrw = true;
+    
+    speed::concurrency::pipeline pl(
+            pool,
+            make_stage<void, counted>(stage_modes::SERIAL_IN_ORDER, [&](flow_control& fc)
+            {
+                if (i == 1000)
+                {
+                    fc.stop();
+                }
+                
+                return counted(i++);
+            }) |
+            make_stage<counted, counted>(stage_modes::PARALLEL, [&](counted v)
+            {
+                if (thrw && v.val == 300)
+                {
+                    throw std::runtime_error("stage");
+                }
+                
+                return v;
+            }) |
+            make_stage<counted, void>(stage_modes::SERIAL_IN_ORDER, [&](counted v)
+            {
+                EXPECT_TRUE(v.val > lst);
+                lst = v.val;
+            }));
+    
+    EXPECT_THROW(pl.run(), std::runtime_error);
+    EXPECT_TRUE(i < 1000);
+    EXPECT_TRUE(counted::nbr_lvng.load() == 0);
+    
+    i = 0;
+    lst = -1;
+    thrw = false;
+    pl.run();
+    
+    EXPECT_TRUE(lst == 999);
+    EXPECT_TRUE(counted::nbr_lvng.load() == 0);
+}
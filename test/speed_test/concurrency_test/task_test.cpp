@@ -0,0 +1,115 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/concurrency_test/task_test.cpp
+ * @brief       task unit test.
+ * @author      Killian
+ * @date        2018/10/02 - 18:40
+ */
+
+#include "gtest/gtest.h"
+#include "speed/concurrency.hpp"
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <stdexcept>
+#include <thread>
+
+
+namespace {
+
+
+speed::concurrency::task<int> add(int x, int y)
+{
+    co_return x + y;
+}
+
+
+speed::concurrency::task<int> sum(int n)
+{
+    int res = 0;
+    
+    for (int i = 0; i < n; ++i)
+    {
+        res += co_await add(i, 1);
+    }
+    
+    co_return res;
+}
+
+
+speed::concurrency::task<void> fail()
+{
+    throw std::runtime_error("error");
+    co_return;
+}
+
+
+speed::concurrency::task<int> await_future(speed::concurrency::future<int> fut)
+{
+    co_return co_await std::move(fut) * 2;
+}
+
+
+speed::concurrency::task<std::size_t> switch_executor(speed::concurrency::thread_pool& pool)
+{
+    co_await speed::concurrency::resume_on(pool);
+    
+    co_return pool.get_worker_index();
+}
+
+
+}
+
+
+TEST(concurrency_task, start)
+{
+    speed::concurrency::inline_executor exec;
+    speed::concurrency::thread_pool pool(2);
+    
+    EXPECT_EQ(sum(10).start(exec).get(), 55);
+    EXPECT_EQ(sum(100).start(pool).get(), 5050);
+    EXPECT_THROW(fail().start(pool).get(), std::runtime_error);
+}
+
+
+TEST(concurrency_task, await_future)
+{
+    speed::concurrency::thread_pool pool(2);
+    speed::concurrency::promise<int> prms;
+    speed::concurrency::future<int> fut = await_future(prms.get_future()).start(pool);
+    
+    std::thread thrd([&] { prms.set_value(21); });
+    
+    EXPECT_EQ(fut.get(), 42);
+    thrd.join();
+    EXPECT_EQ(await_future(speed::concurrency::make_ready_future(2)).start(pool).get(), 4);
+}
+
+
+TEST(concurrency_task, resume_on)
+{
+    speed::concurrency::inline_executor exec;
+    speed::concurrency::thread_pool pool(2);
+    
+    EXPECT_LT(switch_executor(pool).start(exec).get(), 2u);
+}
+
+#endif
@@ -0,0 +1,176 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/concurrency_test/thread_pool_test.cpp
+ * @brief       thread_pool unit test.
+ * @author      Killian
+ * @date        2018/09/30 - 16:31
+ */
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+#include "speed/concurrency.hpp"
+
+
+namespace {
+
+
+std::uint64_t fibonacci(speed::concurrency::thread_pool& pool, int n)
+{
+    if (n < 2)
+    {
+        return static_cast<std::uint64_t>(n);
+    }
+    
+    if (n < 12)
+    {
+        return fibonacci(pool, n - 1) + fibonacci(pool, n - 2);
+    }
+    
+    speed::concurrency::task_group grp(pool);
+    std::uint64_t x;
+    std::uint64_t y;
+    
+    grp.spawn([&] { x = fibonacci(pool, n - 1); });
+    y = fibonacci(pool, n - 2);
+    grp.wait();
+    
+    return x + y;
+}
+
+
+}
+
+
+TEST(concurrency_thread_pool, submit)
+{
+    std::atomic<int> cnt(0);
+    
+    {
+        speed::concurrency::thread_pool pool(4);
+        
+        for (int i = 0; i < 1000; ++i)
+        {
+            pool.submit([&] { cnt.fetch_add(1); });
+        }
+    }
+    
+    EXPECT_TRUE(cnt.load() == 1000);
+}
+
+
+TEST(concurrency_thread_pool, task_group)
+{
+    speed::concurrency::thread_pool pool(3);
+    speed::concurrency::task_group grp(pool);
+    std::atomic<int> cnt(0);
+    
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int i = 0; i < 500; ++i)
+        {
+            grp.spawn([&] { cnt.fetch_add(1); });
+        }
+        
+        grp.wait();
+        EXPECT_TRUE(cnt.load() == 500 * (r + 1));
+    }
+}
+
+
+TEST(concurrency_thread_pool, large_task)
+{
+    speed::concurrency::thread_pool pool(2);
+    speed::concurrency::task_group grp(pool);
+    std::array<std::uint64_t, 32> vals = {};
+    std::uint64_t sm = 0;
+    
+    for (std::size_t i = 0; i < vals.size(); ++i)
+    {
+        vals[i] = i;
+    }
+    
+    grp.spawn([vals, &sm]
+    {
+        for (auto& x : vals)
+        {
+            sm += x;
+        }
+    });
+    grp.wait();
+    
+    EXPECT_TRUE(sm == 31 * 32 / 2);
+}
+
+
+TEST(concurrency_thread_pool, fork_join)
+{
+    speed::concurrency::thread_pool pool(4);
+    
+    EXPECT_TRUE(fibonacci(pool, 25) == 75025);
+}
+
+
+TEST(concurrency_thread_pool, exception)
+{
+    speed::concurrency::thread_pool pool(2);
+    speed::concurrency::task_group grp(pool);
+    std::atomic<int> cnt(0);
+    
+    for (int i = 0; i < 100; ++i)
+    {
+        grp.spawn([&, i]
+        {
+            cnt.fetch_add(1);
+            if (i == 42)
+            {
+                throw std::runtime_error("task");
+            }
+        });
+    }
+    
+    EXPECT_THROW(grp.wait(), std::runtime_error);
+    EXPECT_TRUE(cnt.load() == 100);
+    EXPECT_NO_THROW(grp.wait());
+}
+
+
+TEST(concurrency_thread_pool, pinned)
+{
+    speed::concurrency::thread_pool pool(2, true);
+    speed::concurrency::task_group grp(pool);
+    std::atomic<std::size_t> idxs(0);
+    
+    EXPECT_TRUE(pool.get_concurrency() == 2);
+    EXPECT_TRUE(pool.get_worker_index() == 2);
+    
+    for (int i = 0; i < 10; ++i)
+    {
+        grp.spawn([&] { idxs.fetch_add(pool.get_worker_index()); });
+    }
+    
+    grp.wait();
+    
+    EXPECT_TRUE(idxs.load() <= 20);
+}
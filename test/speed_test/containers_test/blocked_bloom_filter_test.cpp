@@ -0,0 +1,115 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/blocked_bloom_filter_test.cpp
+ * @brief       blocked_bloom_filter unit test.
+ * @author      Killian
+ * @date        2018/09/16 - 14:05
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_blocked_bloom_filter, insert)
+{
+    speed::containers::blocked_bloom_filter<std::string> bf(100);
+    
+    bf.insert("alpha");
+    bf.insert("beta");
+    
+    EXPECT_TRUE(bf.contains("alpha"));
+    EXPECT_TRUE(bf.contains("beta"));
+    EXPECT_TRUE(bf.size() == 2);
+    
+    bf.clear();
+    
+    EXPECT_FALSE(bf.contains("alpha"));
+    EXPECT_TRUE(bf.size() == 0);
+}
+
+
+TEST(containers_blocked_bloom_filter, false_positive_rate)
+{
+    const int nbr_kys = 100000;
+    
+    for (double trgt : {0.1, 0.01, 0.001})
+    {
+        speed::containers::blocked_bloom_filter<int> bf(nbr_kys, trgt);
+        int nbr_fps = 0;
+        
+        for (int i = 0; i < nbr_kys; ++i)
+        {
+            bf.insert(i);
+        }
+        
+        for (int i = 0; i < nbr_kys; ++i)
+        {
+            ASSERT_TRUE(bf.contains(i));
+        }
+        
+        for (int i = nbr_kys; i < nbr_kys * 11; ++i)
+        {
+            if (bf.contains(i))
+            {
+                ++nbr_fps;
+            }
+        }
+        
+        EXPECT_TRUE(nbr_fps / (nbr_kys * 10.0) < trgt * 1.5);
+        EXPECT_TRUE(bf.get_expected_false_positive_rate() <= trgt * 1.01);
+    }
+}
+
+
+TEST(containers_blocked_bloom_filter, serialize)
+{
+    speed::containers::blocked_bloom_filter<int> bf(1000, 0.01);
+    std::vector<std::uint8_t> buf;
+    
+    for (int i = 0; i < 1000; i += 3)
+    {
+        bf.insert(i);
+    }
+    
+    buf = bf.serialize();
+    auto bf2 = speed::containers::blocked_bloom_filter<int>::deserialize(buf);
+    
+    EXPECT_TRUE(bf2.size() == bf.size());
+    EXPECT_TRUE(bf2.get_size_in_bytes() == bf.get_size_in_bytes());
+    
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(bf.contains(i) == bf2.contains(i));
+    }
+    
+    buf.pop_back();
+    EXPECT_THROW(speed::containers::blocked_bloom_filter<int>::deserialize(buf),
+                 speed::containers::deserialization_exception);
+    
+    buf = bf.serialize();
+    buf[0] ^= 0xff;
+    EXPECT_THROW(speed::containers::blocked_bloom_filter<int>::deserialize(buf),
+                 speed::containers::deserialization_exception);
+}
@@ -0,0 +1,311 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/btree_map_test.cpp
+ * @brief       btree_map unit test.
+ * @author      Killian
+ * @date        2018/09/08 - 20:15
+ */
+
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_btree_map, insert)
+{
+    speed::containers::btree_map<int, std::string> mp;
+    
+    mp.insert(3, "three");
+    mp.insert(1, "one");
+    mp.insert(2, "two");
+    
+    EXPECT_THROW(mp.insert(1, "..."), speed::containers::insertion_exception);
+    EXPECT_FALSE(mp.try_insert(1, "..."));
+    EXPECT_TRUE(mp.size() == 3);
+    EXPECT_TRUE(*mp.find(1) == "one");
+    EXPECT_TRUE(*mp.find(2) == "two");
+    EXPECT_TRUE(mp.find(4) == mp.end());
+    
+    mp.insert_or_assign(1, "uno");
+    mp[5] = "five";
+    
+    EXPECT_TRUE(mp.at(1) == "uno");
+    EXPECT_TRUE(mp.at(5) == "five");
+    EXPECT_THROW(mp.at(6), speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_btree_map, iteration)
+{
+    speed::containers::btree_map<int, int, std::less<int>, 32> mp;
+    int i = 0;
+    
+    for (int j = 999; j >= 0; --j)
+    {
+        mp.insert(j, j * 2);
+    }
+    
+    EXPECT_TRUE(mp.get_depth() > 2);
+    
+    for (auto it = mp.begin(); it != mp.end(); ++it)
+    {
+        EXPECT_TRUE(it.key() == i);
+        EXPECT_TRUE(*it == i * 2);
+        ++i;
+    }
+    
+    EXPECT_TRUE(i == 1000);
+    
+    auto it = mp.end();
+    --it;
+    
+    EXPECT_TRUE(it.key() == 999);
+}
+
+
+TEST(containers_btree_map, bounds)
+{
+    speed::containers::btree_map<int, int, std::less<int>, 32> mp;
+    std::vector<int> kys;
+    
+    for (int i = 0; i < 500; ++i)
+    {
+        mp.insert(i * 10, i);
+    }
+    
+    EXPECT_TRUE(mp.lower_bound(15).key() == 20);
+    EXPECT_TRUE(mp.lower_bound(20).key() == 20);
+    EXPECT_TRUE(mp.upper_bound(20).key() == 30);
+    EXPECT_TRUE(mp.lower_bound(4991).end());
+    
+    EXPECT_TRUE(mp.for_each_in_range(95, 205, [&](const int& ky, int&)
+    {
+        kys.push_back(ky);
+    }) == 11);
+    
+    EXPECT_TRUE(kys.front() == 100);
+    EXPECT_TRUE(kys.back() == 200);
+}
+
+
+TEST(containers_btree_map, erase)
+{
+    speed::containers::btree_map<int, int, std::less<int>, 32> mp;
+    std::map<int, int> ref;
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dis(0, 2000);
+    int ky;
+    
+    for (int i = 0; i < 20000; ++i)
+    {
+        ky = dis(gen);
+        
+        if (gen() % 3 == 0)
+        {
+            EXPECT_TRUE(mp.erase(ky) == (ref.erase(ky) == 1));
+        }
+        else
+        {
+            mp.insert_or_assign(ky, i);
+            ref[ky] = i;
+        }
+    }
+    
+    ASSERT_TRUE(mp.size() == ref.size());
+    
+    auto it = mp.begin();
+    
+    for (auto& x : ref)
+    {
+        ASSERT_FALSE(it.end());
+        EXPECT_TRUE(it.key() == x.first);
+        EXPECT_TRUE(*it == x.second);
+        ++it;
+    }
+    
+    for (auto& x : ref)
+    {
+        EXPECT_TRUE(mp.erase(x.first));
+    }
+    
+    EXPECT_TRUE(mp.empty());
+    EXPECT_TRUE(mp.begin() == mp.end());
+}
+
+
+TEST(containers_btree_map, bulk_load)
+{
+    std::vector<std::pair<int, int>> vals;
+    
+    for (int i = 0; i < 10000; ++i)
+    {
+        vals.emplace_back(i * 2, i);
+    }
+    
+    speed::containers::btree_map<int, int, std::less<int>, 64> mp(vals.begin(), vals.end());
+    
+    EXPECT_TRUE(mp.size() == vals.size());
+    EXPECT_TRUE(*mp.find(5000) == 2500);
+    EXPECT_TRUE(mp.find(5001) == mp.end());
+    
+    mp.insert(5001, -1);
+    EXPECT_TRUE(mp.erase(0));
+    EXPECT_TRUE(mp.begin().key() == 2);
+    
+    std::swap(vals[0], vals[1]);
+    EXPECT_THROW(mp.bulk_load(vals.begin(), vals.end()),
+                 speed::containers::insertion_exception);
+}
+
+
+TEST(containers_btree_map, copy)
+{
+    speed::containers::btree_map<int, std::string, std::less<int>, 64> mp;
+    
+    for (int i = 0; i < 5000; ++i)
+    {
+        mp.insert(i, std::to_string(i));
+    }
+    
+    auto cpy = mp;
+    
+    EXPECT_TRUE(cpy.size() == mp.size());
+    mp.insert(5000, "5000");
+    EXPECT_TRUE(mp.erase(0));
+    EXPECT_TRUE(cpy.find(5000) == cpy.end());
+    EXPECT_TRUE(*cpy.find(0) == "0");
+    
+    int i = 0;
+    for (auto it = cpy.begin(); it != cpy.end(); ++it, ++i)
+    {
+        EXPECT_TRUE(it.key() == i);
+        EXPECT_TRUE(*it == std::to_string(i));
+    }
+    EXPECT_TRUE(i == 5000);
+    
+    cpy = mp;
+    EXPECT_TRUE(cpy.size() == mp.size());
+    EXPECT_TRUE(cpy.begin().key() == 1);
+    
+    decltype(mp) mvd;
+    mvd = std::move(cpy);
+    EXPECT_TRUE(mvd.size() == mp.size());
+    EXPECT_TRUE(cpy.empty());
+    EXPECT_TRUE(*mvd.find(5000) == "5000");
+    
+    cpy = decltype(mp)();
+    EXPECT_TRUE(cpy.begin() == cpy.end());
+}
+
+
+namespace {
+
+
+struct throwing_key
+{
+    throwing_key() = default;
+    
+    throwing_key(int v)
+            : val(v)
+    {
+    }
+    
+    throwing_key(const throwing_key& rhs)
+            : val(rhs.val)
+    {
+        count_copy();
+    }
+    
+    throwing_key(throwing_key&& rhs) noexcept = default;
+    
+    throwing_key& operator =(const throwing_key& rhs)
+    {
+        count_copy();
+        val = rhs.val;
+        return *this;
+    }
+    
+    throwing_key& operator =(throwing_key&& rhs) noexcept = default;
+    
+    bool operator <(const throwing_key& rhs) const noexcept
+    {
+        return val < rhs.val;
+    }
+    
+    static void count_copy()
+    {
+        if (nbr_cpys_lft == 0)
+        {
+            throw std::runtime_error("copy");
+        }
+        
+        if (nbr_cpys_lft > 0)
+        {
+            --nbr_cpys_lft;
+        }
+    }
+    
+    int val = 0;
+    
+    static inline int nbr_cpys_lft = -1;
+};
+
+
+}
+
+
+TEST(containers_btree_map, copy_throw)
+{
+    speed::containers::btree_map<throwing_key, int, std::less<throwing_key>, 64> mp;
+    bool cpyd = false;
+    
+    for (int i = 0; i < 300; ++i)
+    {
+        mp.insert(throwing_key(i), i);
+    }
+    
+    for (int nbr_cpys = 0; !cpyd; ++nbr_cpys)
+    {
+        throwing_key::nbr_cpys_lft = nbr_cpys;
+        
+        try
+        {
+            auto cpy = mp;
+            
+            throwing_key::nbr_cpys_lft = -1;
+            cpyd = true;
+            EXPECT_TRUE(cpy.size() == mp.size());
+            EXPECT_TRUE(*cpy.find(throwing_key(299)) == 299);
+        }
+        catch (const std::runtime_error&)
+        {
+            EXPECT_TRUE(nbr_cpys < 1000);
+        }
+    }
+    
+    throwing_key::nbr_cpys_lft = -1;
+    EXPECT_TRUE(mp.size() == 300);
+}
@@ -0,0 +1,95 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/btree_set_test.cpp
+ * @brief       btree_set unit test.
+ * @author      Killian
+ * @date        2018/09/08 - 20:47
+ */
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_btree_set, insert)
+{
+    speed::containers::btree_set<std::string> st;
+    
+    st.insert("b");
+    st.insert("a");
+    
+    EXPECT_THROW(st.insert("a"), speed::containers::insertion_exception);
+    EXPECT_TRUE(st.try_insert("c"));
+    EXPECT_FALSE(st.try_insert("c"));
+    EXPECT_TRUE(st.contains("a"));
+    EXPECT_FALSE(st.contains("d"));
+    EXPECT_TRUE(*st.begin() == "a");
+}
+
+
+TEST(containers_btree_set, erase)
+{
+    speed::containers::btree_set<std::uint64_t, std::less<std::uint64_t>, 32> st;
+    std::set<std::uint64_t> ref;
+    std::mt19937_64 gen(7);
+    std::uint64_t ky;
+    
+    for (int i = 0; i < 20000; ++i)
+    {
+        ky = gen() % 3000;
+        
+        if (gen() % 2 == 0)
+        {
+            EXPECT_TRUE(st.erase(ky) == (ref.erase(ky) == 1));
+        }
+        else
+        {
+            EXPECT_TRUE(st.try_insert(ky) == ref.insert(ky).second);
+        }
+    }
+    
+    ASSERT_TRUE(st.size() == ref.size());
+    EXPECT_TRUE(std::equal(ref.begin(), ref.end(), st.begin()));
+}
+
+
+TEST(containers_btree_set, bulk_load)
+{
+    std::vector<int> vals;
+    
+    for (int i = 0; i < 1000; ++i)
+    {
+        vals.push_back(i);
+    }
+    
+    speed::containers::btree_set<int> st(vals.begin(), vals.end());
+    auto it = st.lower_bound(500);
+    
+    EXPECT_TRUE(st.size() == 1000);
+    EXPECT_TRUE(*it == 500);
+    EXPECT_TRUE(*++it == 501);
+    EXPECT_TRUE(*st.upper_bound(998) == 999);
+}
@@ -0,0 +1,165 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/concurrent_skip_list_map_test.cpp
+ * @brief       concurrent_skip_list_map unit test.
+ * @author      Killian
+ * @date        2018/09/17 - 19:02
+ */
+
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_concurrent_skip_list_map, insert)
+{
+    speed::containers::concurrent_skip_list_map<int, std::string> mp;
+    std::string val;
+    
+    mp.insert(2, "two");
+    mp.insert(1, "one");
+    
+    EXPECT_THROW(mp.insert(1, "..."), speed::containers::insertion_exception);
+    EXPECT_FALSE(mp.try_insert(2, "..."));
+    EXPECT_TRUE(mp.find(1, &val));
+    EXPECT_TRUE(val == "one");
+    EXPECT_FALSE(mp.contains(3));
+    EXPECT_TRUE(mp.size() == 2);
+}
+
+
+TEST(containers_concurrent_skip_list_map, random)
+{
+    speed::containers::concurrent_skip_list_map<int, int> mp;
+    std::map<int, int> ref;
+    std::mt19937 gen(42);
+    std::vector<int> kys;
+    
+    for (int i = 0; i < 20000; ++i)
+    {
+        int ky = static_cast<int>(gen() % 5000);
+        
+        if (gen() % 3 == 0)
+        {
+            EXPECT_TRUE(mp.erase(ky) == (ref.erase(ky) == 1));
+        }
+        else
+        {
+            EXPECT_TRUE(mp.try_insert(ky, ky * 2) == ref.emplace(ky, ky * 2).second);
+        }
+    }
+    
+    EXPECT_TRUE(mp.size() == ref.size());
+    
+    mp.cvisit_all([&](const int& ky, const int& val)
+    {
+        EXPECT_TRUE(val == ky * 2);
+        kys.push_back(ky);
+    });
+    
+    ASSERT_TRUE(kys.size() == ref.size());
+    
+    auto it = ref.begin();
+    for (auto& x : kys)
+    {
+        EXPECT_TRUE(x == (it++)->first);
+    }
+}
+
+
+TEST(containers_concurrent_skip_list_map, cvisit_range)
+{
+    speed::containers::concurrent_skip_list_map<int, int, std::greater<int>> mp;
+    std::vector<int> kys;
+    
+    for (int i = 0; i < 100; ++i)
+    {
+        mp.insert(i, i);
+    }
+    
+    mp.cvisit_range(50, 40, [&](const int& ky, const int&)
+    {
+        kys.push_back(ky);
+    });
+    
+    EXPECT_TRUE(kys == std::vector<int>({50, 49, 48, 47, 46, 45, 44, 43, 42, 41}));
+}
+
+
+TEST(containers_concurrent_skip_list_map, concurrent_access)
+{
+    speed::containers::concurrent_skip_list_map<int, int> mp;
+    const int nbr_thrds = 8;
+    const int nbr_kys = 4000;
+    std::vector<std::thread> thrds;
+    
+    for (int t = 0; t < nbr_thrds; ++t)
+    {
+        thrds.emplace_back([&, t]()
+        {
+            for (int i = 0; i < nbr_kys; ++i)
+            {
+                int ky = i * nbr_thrds + t;
+                int prev = ky - 501;
+                
+                mp.insert(ky, ky);
+                
+                if (i % 2 == 0)
+                {
+                    EXPECT_TRUE(mp.erase(ky));
+                }
+                
+                if (i % 64 == 0)
+                {
+                    mp.cvisit_range(ky - 500, ky + 500, [&](const int& k, const int& v)
+                    {
+                        EXPECT_TRUE(k == v);
+                        EXPECT_TRUE(k > prev);
+                        prev = k;
+                    });
+                }
+                
+                mp.try_insert(-i - 1, -i - 1);
+                mp.erase(-i - 1);
+            }
+        });
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+    
+    for (int i = 0; i < nbr_kys * nbr_thrds; ++i)
+    {
+        EXPECT_TRUE(mp.contains(i) == ((i / nbr_thrds) % 2 == 1));
+    }
+    
+    EXPECT_FALSE(mp.contains(-1));
+    EXPECT_TRUE(mp.size() == nbr_kys * nbr_thrds / 2);
+    
+    speed::containers::epoch_based_reclamation::collect();
+}
@@ -0,0 +1,167 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/concurrent_unordered_map_test.cpp
+ * @brief       concurrent_unordered_map unit test.
+ * @author      Killian
+ * @date        2018/09/15 - 21:10
+ */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_concurrent_unordered_map, insert)
+{
+    speed::containers::concurrent_unordered_map<int, std::string> mp;
+    std::string val;
+    
+    mp.insert(1, "one");
+    mp.insert(2, "two");
+    
+    EXPECT_THROW(mp.insert(1, "..."), speed::containers::insertion_exception);
+    EXPECT_FALSE(mp.try_insert(2, "..."));
+    EXPECT_TRUE(mp.find(1, &val));
+    EXPECT_TRUE(val == "one");
+    EXPECT_FALSE(mp.find(3));
+    EXPECT_TRUE(mp.size() == 2);
+    
+    EXPECT_FALSE(mp.insert_or_assign(1, "uno"));
+    EXPECT_TRUE(mp.cvisit(1, [&](const std::string& x) { val = x; }));
+    EXPECT_TRUE(val == "uno");
+}
+
+
+TEST(containers_concurrent_unordered_map, insert_or_assign_move)
+{
+    speed::containers::concurrent_unordered_map<int, std::string> mp;
+    std::string val(64, 'a');
+    const char* dat = val.data();
+    const char* cur_dat = nullptr;
+    
+    EXPECT_TRUE(mp.insert_or_assign(1, std::move(val)));
+    EXPECT_TRUE(mp.cvisit(1, [&](const std::string& x) { cur_dat = x.data(); }));
+    EXPECT_TRUE(cur_dat == dat);
+    
+    val.assign(64, 'b');
+    EXPECT_FALSE(mp.insert_or_assign(1, val));
+    EXPECT_TRUE(mp.cvisit(1, [&](const std::string& x) { cur_dat = x.data(); }));
+    EXPECT_TRUE(cur_dat != val.data());
+    EXPECT_TRUE(val == std::string(64, 'b'));
+}
+
+
+TEST(containers_concurrent_unordered_map, visit)
+{
+    speed::containers::concurrent_unordered_map<std::string, int> mp;
+    int val = 0;
+    
+    EXPECT_FALSE(mp.visit("a", [](int& x) { ++x; }));
+    EXPECT_TRUE(mp.insert_or_visit("a", 1, [](int& x) { ++x; }));
+    EXPECT_FALSE(mp.insert_or_visit("a", 1, [](int& x) { ++x; }));
+    EXPECT_TRUE(mp.visit("a", [](int& x) { x *= 10; }));
+    EXPECT_TRUE(mp.find("a", &val));
+    EXPECT_TRUE(val == 20);
+}
+
+
+TEST(containers_concurrent_unordered_map, erase)
+{
+    speed::containers::concurrent_unordered_map<int, int, std::hash<int>, std::equal_to<int>, 4> mp;
+    int sum = 0;
+    
+    for (int i = 0; i < 10000; ++i)
+    {
+        mp.insert(i, i);
+    }
+    
+    for (int i = 0; i < 10000; i += 2)
+    {
+        EXPECT_TRUE(mp.erase(i));
+    }
+    
+    EXPECT_FALSE(mp.erase(0));
+    EXPECT_TRUE(mp.size() == 5000);
+    
+    mp.cvisit_all([&](const int& ky, const int& val)
+    {
+        EXPECT_TRUE(ky == val);
+        EXPECT_TRUE(ky % 2 == 1);
+        ++sum;
+    });
+    
+    EXPECT_TRUE(sum == 5000);
+    
+    mp.clear();
+    
+    EXPECT_TRUE(mp.empty());
+    EXPECT_FALSE(mp.find(1));
+}
+
+
+TEST(containers_concurrent_unordered_map, concurrent_access)
+{
+    speed::containers::concurrent_unordered_map<int, long> mp;
+    const int nbr_thrds = 8;
+    const int nbr_kys = 2000;
+    std::vector<std::thread> thrds;
+    
+    for (int t = 0; t < nbr_thrds; ++t)
+    {
+        thrds.emplace_back([&, t]()
+        {
+            long val;
+            
+            for (int i = 0; i < nbr_kys; ++i)
+            {
+                mp.insert_or_visit(i, 1L, [](long& x) { ++x; });
+                
+                if (mp.find((i * 7 + t) % nbr_kys, &val))
+                {
+                    EXPECT_TRUE(val >= 1 && val <= nbr_thrds);
+                }
+                
+                mp.try_insert(nbr_kys + t * nbr_kys + i, 0L);
+                mp.erase(nbr_kys + t * nbr_kys + i);
+            }
+        });
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+    
+    EXPECT_TRUE(mp.size() == nbr_kys);
+    
+    for (int i = 0; i < nbr_kys; ++i)
+    {
+        long val = 0;
+        
+        EXPECT_TRUE(mp.find(i, &val));
+        EXPECT_TRUE(val == nbr_thrds);
+    }
+    
+    speed::containers::epoch_based_reclamation::collect();
+}
@@ -0,0 +1,158 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/cuckoo_filter_test.cpp
+ * @brief       cuckoo_filter unit test.
+ * @author      Killian
+ * @date        2018/09/16 - 18:31
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_cuckoo_filter, insert)
+{
+    speed::containers::cuckoo_filter<std::string> cf(100);
+    
+    cf.insert("alpha");
+    cf.insert("beta");
+    
+    EXPECT_TRUE(cf.contains("alpha"));
+    EXPECT_TRUE(cf.contains("beta"));
+    EXPECT_TRUE(cf.size() == 2);
+}
+
+
+TEST(containers_cuckoo_filter, erase)
+{
+    speed::containers::cuckoo_filter<int> cf(10000, 0.001);
+    
+    for (int i = 0; i < 10000; ++i)
+    {
+        cf.insert(i);
+    }
+    
+    for (int i = 0; i < 10000; i += 2)
+    {
+        EXPECT_TRUE(cf.erase(i));
+    }
+    
+    for (int i = 1; i < 10000; i += 2)
+    {
+        EXPECT_TRUE(cf.contains(i));
+    }
+    
+    EXPECT_TRUE(cf.size() == 5000);
+    
+    cf.clear();
+    
+    EXPECT_TRUE(cf.empty());
+    EXPECT_FALSE(cf.contains(1));
+}
+
+
+TEST(containers_cuckoo_filter, full)
+{
+    speed::containers::cuckoo_filter<int> cf(64);
+    int i = 0;
+    
+    while (cf.try_insert(i))
+    {
+        ++i;
+    }
+    
+    EXPECT_TRUE(i >= 64);
+    EXPECT_THROW(cf.insert(i), speed::containers::exhausted_resources_exception);
+    
+    for (int j = 0; j < i; ++j)
+    {
+        EXPECT_TRUE(cf.contains(j));
+    }
+    
+    EXPECT_TRUE(cf.erase(0));
+    EXPECT_TRUE(cf.try_insert(i));
+}
+
+
+TEST(containers_cuckoo_filter, false_positive_rate)
+{
+    const int nbr_kys = 100000;
+    
+    for (double trgt : {0.05, 0.01, 0.0001})
+    {
+        speed::containers::cuckoo_filter<int> cf(nbr_kys, trgt);
+        int nbr_fps = 0;
+        
+        for (int i = 0; i < nbr_kys; ++i)
+        {
+            cf.insert(i);
+        }
+        
+        for (int i = 0; i < nbr_kys; ++i)
+        {
+            ASSERT_TRUE(cf.contains(i));
+        }
+        
+        for (int i = nbr_kys; i < nbr_kys * 11; ++i)
+        {
+            if (cf.contains(i))
+            {
+                ++nbr_fps;
+            }
+        }
+        
+        EXPECT_TRUE(nbr_fps / (nbr_kys * 10.0) < trgt * 1.5);
+    }
+}
+
+
+TEST(containers_cuckoo_filter, serialize)
+{
+    speed::containers::cuckoo_filter<int> cf(1000, 0.0001);
+    std::vector<std::uint8_t> buf;
+    
+    for (int i = 0; i < 1000; i += 3)
+    {
+        cf.insert(i);
+    }
+    
+    buf = cf.serialize();
+    auto cf2 = speed::containers::cuckoo_filter<int>::deserialize(buf);
+    
+    EXPECT_TRUE(cf2.size() == cf.size());
+    EXPECT_TRUE(cf2.get_fingerprint_bits() == cf.get_fingerprint_bits());
+    
+    for (int i = 0; i < 2000; ++i)
+    {
+        EXPECT_TRUE(cf.contains(i) == cf2.contains(i));
+    }
+    
+    EXPECT_TRUE(cf2.erase(3));
+    EXPECT_FALSE(cf2.contains(3));
+    
+    buf.resize(10);
+    EXPECT_THROW(speed::containers::cuckoo_filter<int>::deserialize(buf),
+                 speed::containers::deserialization_exception);
+}
@@ -0,0 +1,172 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/d_ary_heap_test.cpp
+ * @brief       d_ary_heap unit test.
+ * @author      Killian
+ * @date        2018/09/02 - 19:40
+ */
+
+#include <functional>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_d_ary_heap, push_pop)
+{
+    speed::containers::d_ary_heap<int> hp;
+    std::vector<int> vals = {42, 7, 19, 3, 25, 7, 100, -4, 0, 61};
+    int prev;
+    
+    for (auto& x : vals)
+    {
+        hp.push(x);
+    }
+    
+    ASSERT_TRUE(hp.size() == vals.size());
+    
+    prev = hp.top();
+    hp.pop();
+    
+    while (!hp.empty())
+    {
+        EXPECT_TRUE(prev <= hp.top());
+        prev = hp.top();
+        hp.pop();
+    }
+    
+    EXPECT_THROW(hp.top(), speed::containers::empty_container_exception);
+    EXPECT_THROW(hp.pop(), speed::containers::empty_container_exception);
+}
+
+
+TEST(containers_d_ary_heap, max_heap)
+{
+    speed::containers::d_ary_heap<int, 3, std::greater<int>> hp;
+    
+    hp.push(5);
+    hp.push(50);
+    hp.push(15);
+    
+    EXPECT_TRUE(hp.top() == 50);
+}
+
+
+TEST(containers_d_ary_heap, assign)
+{
+    std::vector<int> vals = {9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    speed::containers::d_ary_heap<int> hp(vals.begin(), vals.end());
+    
+    EXPECT_TRUE(hp.top() == 0);
+    EXPECT_TRUE(hp.top_handle() == 9);
+    EXPECT_TRUE(hp.get(3) == 6);
+    
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(hp.top() == i);
+        hp.pop();
+    }
+}
+
+
+TEST(containers_d_ary_heap, update)
+{
+    speed::containers::d_ary_heap<int> hp;
+    auto a = hp.push(10);
+    auto b = hp.push(20);
+    auto c = hp.push(30);
+    
+    hp.update(c, 5);
+    EXPECT_TRUE(hp.top_handle() == c);
+    
+    hp.update(c, 25);
+    EXPECT_TRUE(hp.top_handle() == a);
+    
+    hp.decrease_key(b, 1);
+    EXPECT_TRUE(hp.top_handle() == b);
+    EXPECT_TRUE(hp.get(b) == 1);
+}
+
+
+TEST(containers_d_ary_heap, erase)
+{
+    speed::containers::d_ary_heap<int> hp;
+    auto a = hp.push(10);
+    auto b = hp.push(20);
+    auto c = hp.push(30);
+    
+    hp.erase(a);
+    
+    EXPECT_FALSE(hp.contains(a));
+    EXPECT_TRUE(hp.contains(b));
+    EXPECT_TRUE(hp.top() == 20);
+    EXPECT_THROW(hp.erase(a), speed::containers::out_of_range_exception);
+    
+    hp.erase(c);
+    hp.erase(b);
+    
+    EXPECT_TRUE(hp.empty());
+    EXPECT_TRUE(hp.push(1) == b);
+}
+
+
+TEST(containers_d_ary_heap, dijkstra)
+{
+    const std::size_t nbr_nods = 6;
+    const int inf = 1 << 30;
+    std::vector<std::vector<std::pair<std::size_t, int>>> adj(nbr_nods);
+    std::vector<int> dist(nbr_nods, inf);
+    std::vector<std::size_t> hndls(nbr_nods);
+    
+    adj[0] = {{1, 7}, {2, 9}, {5, 14}};
+    adj[1] = {{0, 7}, {2, 10}, {3, 15}};
+    adj[2] = {{0, 9}, {1, 10}, {3, 11}, {5, 2}};
+    adj[3] = {{1, 15}, {2, 11}, {4, 6}};
+    adj[4] = {{3, 6}, {5, 9}};
+    adj[5] = {{0, 14}, {2, 2}, {4, 9}};
+    
+    dist[0] = 0;
+    
+    speed::containers::d_ary_heap<std::pair<int, std::size_t>> hp;
+    
+    for (std::size_t i = 0; i < nbr_nods; ++i)
+    {
+        hndls[i] = hp.push(std::make_pair(dist[i], i));
+    }
+    
+    while (!hp.empty())
+    {
+        std::size_t u = hp.top().second;
+        hp.pop();
+        
+        for (auto& x : adj[u])
+        {
+            if (dist[u] + x.second < dist[x.first])
+            {
+                dist[x.first] = dist[u] + x.second;
+                hp.decrease_key(hndls[x.first], std::make_pair(dist[x.first], x.first));
+            }
+        }
+    }
+    
+    EXPECT_TRUE(dist == std::vector<int>({0, 7, 9, 20, 20, 11}));
+}
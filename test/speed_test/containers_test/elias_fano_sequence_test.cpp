@@ -0,0 +1,177 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/elias_fano_sequence_test.cpp
+ * @brief       elias_fano_sequence unit test.
+ * @author      Killian
+ * @date        2018/09/20 - 16:48
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_elias_fano_sequence, get)
+{
+    speed::containers::elias_fano_sequence<std::uint64_t> seq = {3, 3, 8, 20, 21, 1000, 1u << 20};
+    
+    EXPECT_TRUE(seq.size() == 7);
+    EXPECT_TRUE(seq.get(0) == 3);
+    EXPECT_TRUE(seq.get(1) == 3);
+    EXPECT_TRUE(seq.get(4) == 21);
+    EXPECT_TRUE(seq.at(6) == 1u << 20);
+    EXPECT_TRUE(seq.back() == 1u << 20);
+    EXPECT_THROW(static_cast<void>(seq.at(7)), speed::containers::out_of_range_exception);
+    EXPECT_THROW(speed::containers::elias_fano_sequence<std::uint32_t>({1, 5, 4}),
+                 speed::containers::insertion_exception);
+}
+
+
+TEST(containers_elias_fano_sequence, next_geq)
+{
+    std::mt19937_64 gen(3);
+    std::vector<std::uint64_t> ref(20000);
+    std::uint64_t val;
+    std::size_t idx;
+    
+    for (auto& x : ref)
+    {
+        x = gen() % 5000000;
+    }
+    
+    std::sort(ref.begin(), ref.end());
+    speed::containers::elias_fano_sequence<std::uint64_t> seq(ref.begin(), ref.end());
+    
+    for (std::size_t i = 0; i < ref.size(); ++i)
+    {
+        EXPECT_TRUE(seq.get(i) == ref[i]);
+    }
+    
+    for (std::size_t i = 0; i < 20000; ++i)
+    {
+        val = gen() % 5100000;
+        idx = seq.next_geq(val, val);
+        
+        EXPECT_TRUE(idx == static_cast<std::size_t>(
+                std::lower_bound(ref.begin(), ref.end(), val) - ref.begin()));
+        
+        if (idx < ref.size())
+        {
+            EXPECT_TRUE(val == ref[idx]);
+        }
+    }
+    
+    EXPECT_TRUE(seq.next_geq(0) == 0);
+    EXPECT_TRUE(seq.next_geq(ref.back()) <= ref.size() - 1);
+    EXPECT_TRUE(seq.next_geq(ref.back() + 1) == ref.size());
+    EXPECT_TRUE(seq.get_size_in_bytes() < ref.size() * 4);
+}
+
+
+TEST(containers_elias_fano_sequence, decode)
+{
+    std::mt19937 gen(5);
+    std::vector<std::uint32_t> ref(3000);
+    std::vector<std::uint32_t> out(3000);
+    std::uint32_t cur = 0;
+    
+    for (auto& x : ref)
+    {
+        cur += gen() % 700;
+        x = cur;
+    }
+    
+    speed::containers::elias_fano_sequence<std::uint32_t> seq(ref.begin(), ref.end());
+    
+    seq.decode(0, ref.size(), out.data());
+    EXPECT_TRUE(out == ref);
+    
+    for (std::size_t first : {1, 7, 127, 128, 129, 1000, 2999})
+    {
+        std::fill(out.begin(), out.end(), 0);
+        seq.decode(first, ref.size() - first, out.data());
+        EXPECT_TRUE(std::equal(ref.begin() + first, ref.end(), out.begin()));
+    }
+    
+    EXPECT_THROW(seq.decode(2999, 2, out.data()), speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_elias_fano_sequence, serialize)
+{
+    std::vector<std::uint64_t> ref;
+    
+    for (std::uint64_t i = 0; i < 1000; ++i)
+    {
+        ref.push_back(i * i * i);
+    }
+    
+    speed::containers::elias_fano_sequence<std::uint64_t> seq(ref.begin(), ref.end());
+    auto buf = seq.serialize();
+    auto seq2 = speed::containers::elias_fano_sequence<std::uint64_t>::deserialize(buf);
+    std::vector<std::uint64_t> wrds(buf.size() / 8);
+    
+    std::copy(buf.begin(), buf.end(), reinterpret_cast<std::uint8_t*>(wrds.data()));
+    speed::containers::elias_fano_view<std::uint64_t> vw(wrds.data(), buf.size());
+    
+    EXPECT_TRUE(seq2.size() == ref.size());
+    EXPECT_TRUE(vw.size() == ref.size());
+    
+    for (std::size_t i = 0; i < ref.size(); ++i)
+    {
+        EXPECT_TRUE(seq2.get(i) == ref[i]);
+        EXPECT_TRUE(vw.get(i) == ref[i]);
+    }
+    
+    EXPECT_TRUE(vw.next_geq(1000) == 10);
+    EXPECT_TRUE(vw.get_size_in_bytes() == seq.get_size_in_bytes());
+    
+    wrds[0] ^= 1;
+    EXPECT_THROW(speed::containers::elias_fano_view<std::uint64_t>(wrds.data(), buf.size()),
+                 speed::containers::deserialization_exception);
+    EXPECT_THROW(speed::containers::elias_fano_view<std::uint32_t>(seq.data(), buf.size()),
+                 speed::containers::deserialization_exception);
+    buf.pop_back();
+    EXPECT_THROW(speed::containers::elias_fano_sequence<std::uint64_t>::deserialize(buf),
+                 speed::containers::deserialization_exception);
+}
+
+
+TEST(containers_elias_fano_sequence, empty)
+{
+    speed::containers::elias_fano_sequence<std::uint32_t> seq;
+    auto seq2 = seq;
+    std::uint32_t out;
+    
+    EXPECT_TRUE(seq.empty());
+    EXPECT_TRUE(seq2.empty());
+    EXPECT_TRUE(seq.next_geq(0) == 0);
+    EXPECT_NO_THROW(seq.decode(0, 0, &out));
+    EXPECT_THROW(static_cast<void>(seq.at(0)), speed::containers::out_of_range_exception);
+    
+    seq2 = speed::containers::elias_fano_sequence<std::uint32_t>({4, 9});
+    EXPECT_TRUE(seq2.next_geq(5) == 1);
+    EXPECT_TRUE(seq.get_view().empty());
+}
@@ -0,0 +1,208 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/packed_array_test.cpp
+ * @brief       packed_array unit test.
+ * @author      Killian
+ * @date        2018/09/19 - 15:22
+ */
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_packed_array, get_set)
+{
+    speed::containers::packed_array<20> arr(1000);
+    std::vector<std::uint64_t> ref(1000);
+    std::mt19937_64 gen(7);
+    
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        ref[i] = gen() & 0xfffff;
+        arr.set(i, ref[i]);
+    }
+    
+    for (std::size_t i = 0; i < 1000; i += 3)
+    {
+        ref[i] = gen() & 0xfffff;
+        arr.set(i, ref[i]);
+    }
+    
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+        EXPECT_TRUE(arr.get(i) == ref[i]);
+    }
+    
+    EXPECT_TRUE(arr.get_max_value() == 0xfffff);
+    EXPECT_TRUE(arr.get_size_in_bytes() < 1000 * 4);
+    EXPECT_THROW(static_cast<void>(arr.at(1000)), speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_packed_array, all_widths)
+{
+    std::mt19937_64 gen(11);
+    
+    for (std::size_t bits = 1; bits <= 64; ++bits)
+    {
+        speed::containers::packed_array<> arr(0, bits);
+        std::vector<std::uint64_t> ref;
+        
+        for (std::size_t i = 0; i < 300; ++i)
+        {
+            ref.push_back(gen() & arr.get_max_value());
+            arr.push_back(ref.back());
+        }
+        
+        for (std::size_t i = 0; i < ref.size(); ++i)
+        {
+            ASSERT_TRUE(arr.get(i) == ref[i]);
+        }
+    }
+}
+
+
+TEST(containers_packed_array, resize)
+{
+    speed::containers::packed_array<7> arr(100);
+    
+    for (std::size_t i = 0; i < 100; ++i)
+    {
+        arr.set(i, 127);
+    }
+    
+    arr.resize(10);
+    arr.resize(50);
+    
+    EXPECT_TRUE(arr.get(9) == 127);
+    
+    for (std::size_t i = 10; i < 50; ++i)
+    {
+        EXPECT_TRUE(arr.get(i) == 0);
+    }
+    
+    arr.clear();
+    
+    EXPECT_TRUE(arr.empty());
+    EXPECT_THROW(speed::containers::packed_array<7>(10, 8),
+                 speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_packed_array, runtime_width)
+{
+    std::vector<std::uint32_t> vals = {3, 900, 17, 1023, 0, 512};
+    speed::containers::packed_array<> arr(vals.begin(), vals.end());
+    
+    EXPECT_TRUE(arr.get_bits() == 10);
+    EXPECT_TRUE(arr.size() == vals.size());
+    
+    for (std::size_t i = 0; i < vals.size(); ++i)
+    {
+        EXPECT_TRUE(arr.get(i) == vals[i]);
+    }
+    
+    EXPECT_THROW(speed::containers::packed_array<8>(vals.begin(), vals.end()),
+                 speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_packed_array, decode)
+{
+    std::mt19937_64 gen(3);
+    
+    for (std::size_t bits : {1, 5, 13, 20, 25, 31, 33, 64})
+    {
+        speed::containers::packed_array<> arr(1000, bits);
+        std::vector<std::uint32_t> out32(1000);
+        std::vector<std::uint64_t> out64(1000);
+        
+        for (std::size_t i = 0; i < arr.size(); ++i)
+        {
+            arr.set(i, gen());
+        }
+        
+        for (std::size_t first : {0, 1, 7, 99})
+        {
+            arr.decode(first, arr.size() - first, out64.data());
+            
+            for (std::size_t i = first; i < arr.size(); ++i)
+            {
+                ASSERT_TRUE(out64[i - first] == arr.get(i));
+            }
+            
+            if (bits <= 32)
+            {
+                arr.decode(first, arr.size() - first, out32.data());
+                
+                for (std::size_t i = first; i < arr.size(); ++i)
+                {
+                    ASSERT_TRUE(out32[i - first] == arr.get(i));
+                }
+            }
+        }
+    }
+    
+    speed::containers::packed_array<4> arr(10);
+    std::uint32_t out[10];
+    
+    EXPECT_THROW(arr.decode(5, 6, out), speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_packed_array, decode_end)
+{
+    for (std::size_t bits : {1, 8, 16, 25, 32, 64})
+    {
+        speed::containers::packed_array<> arr(64, bits);
+        std::vector<std::uint32_t> out32(64);
+        std::vector<std::uint64_t> out64(64);
+        
+        for (std::size_t i = 0; i < arr.size(); ++i)
+        {
+            arr.set(i, i * 0x9e3779b97f4a7c15ULL);
+        }
+        
+        for (std::size_t first : {0, 8, 56, 63, 64})
+        {
+            arr.decode(first, arr.size() - first, out64.data());
+            
+            for (std::size_t i = first; i < arr.size(); ++i)
+            {
+                ASSERT_TRUE(out64[i - first] == arr.get(i));
+            }
+            
+            if (bits <= 32)
+            {
+                arr.decode(first, arr.size() - first, out32.data());
+                
+                for (std::size_t i = first; i < arr.size(); ++i)
+                {
+                    ASSERT_TRUE(out32[i - first] == arr.get(i));
+                }
+            }
+        }
+    }
+}
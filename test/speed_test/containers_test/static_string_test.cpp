@@ -0,0 +1,120 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/containers_test/static_string_test.cpp
+ * @brief       static_string unit test.
+ * @author      Killian
+ * @date        2018/09/18 - 12:40
+ */
+
+#include <cstring>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+
+#include "gtest/gtest.h"
+#include "speed/containers.hpp"
+
+
+TEST(containers_static_string, constexpr)
+{
+    constexpr speed::containers::static_string<char, 8> str("key");
+    
+    static_assert(str.size() == 3);
+    static_assert(str == "key");
+    static_assert(str < "kez");
+    static_assert(str.substr(1) == "ey");
+    static_assert(std::is_trivially_copyable<speed::containers::static_string<char, 8>>::value);
+    
+    EXPECT_TRUE(str.capacity() == 8);
+}
+
+
+TEST(containers_static_string, modifiers)
+{
+    speed::containers::static_string<char, 6> str;
+    
+    EXPECT_TRUE(str.empty());
+    
+    str += "abc";
+    str += 'd';
+    str.append("ef", 2);
+    
+    EXPECT_TRUE(str == "abcdef");
+    EXPECT_TRUE(std::strlen(str.c_str()) == 6);
+    EXPECT_THROW(str.push_back('g'), speed::containers::out_of_range_exception);
+    EXPECT_THROW(static_cast<void>(str.at(6)), speed::containers::out_of_range_exception);
+    
+    str.pop_back();
+    str.resize(2);
+    
+    EXPECT_TRUE(str == "ab");
+    EXPECT_TRUE(str.c_str()[2] == '\0');
+    
+    str.resize(4, 'x');
+    
+    EXPECT_TRUE(str == "abxx");
+    EXPECT_TRUE(str.find('x') == 2);
+    EXPECT_TRUE(str.find("zz") == str.npos);
+    
+    str.clear();
+    
+    EXPECT_THROW(str.pop_back(), speed::containers::empty_container_exception);
+    EXPECT_THROW((speed::containers::static_string<char, 2>("abc")),
+                 speed::containers::out_of_range_exception);
+}
+
+
+TEST(containers_static_string, copy)
+{
+    speed::containers::static_string<wchar_t, 16> str1(L"hello");
+    speed::containers::static_string<wchar_t, 16> str2;
+    
+    std::memcpy(&str2, &str1, sizeof(str1));
+    
+    EXPECT_TRUE(str2 == L"hello");
+    EXPECT_TRUE(str2.str() == std::wstring(L"hello"));
+}
+
+
+TEST(containers_static_string, hash)
+{
+    speed::containers::static_string<char, 32> str(std::string("speed"));
+    std::unordered_set<speed::containers::static_string<char, 32>> st;
+    std::ostringstream oss;
+    std::size_t hsh;
+    
+    hsh = std::hash<speed::containers::static_string<char, 32>>()(str);
+    
+    EXPECT_TRUE(hsh == std::hash<std::string>()("speed"));
+    
+    st.insert(str);
+    st.insert("speed");
+    st.insert("lib");
+    
+    EXPECT_TRUE(st.size() == 2);
+    
+    oss << str;
+    
+    EXPECT_TRUE(oss.str() == "speed");
+}
@@ -0,0 +1,147 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/hash_test/hash_test.cpp
+ * @brief       hash unit test.
+ * @author      Killian
+ * @date        2018/09/29 - 18:12
+ */
+
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/hash.hpp"
+
+
+namespace {
+
+
+std::vector<unsigned char> make_bytes(std::size_t sz)
+{
+    std::vector<unsigned char> byts(sz);
+    
+    for (std::size_t i = 0; i < sz; ++i)
+    {
+        byts[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+    
+    return byts;
+}
+
+
+}
+
+
+TEST(hash_hash, mix64)
+{
+    std::set<std::uint64_t> hshs;
+    
+    for (std::uint64_t i = 0; i < 10000; ++i)
+    {
+        hshs.insert(speed::hash::mix64(i));
+    }
+    
+    EXPECT_TRUE(hshs.size() == 10000);
+    EXPECT_TRUE(speed::hash::mix64(1) != 1);
+    static_assert(speed::hash::mix64(0) == 0);
+}
+
+
+TEST(hash_hash, hash_bytes)
+{
+    const std::vector<unsigned char> byts = make_bytes(3000);
+    const std::pair<std::size_t, std::uint64_t> expctd[] = {
+        {0, 0x0409638ee2bde459ULL},
+        {3, 0x8e4fbcba74db6389ULL},
+        {8, 0x6ad2fe40e65970edULL},
+        {16, 0x47340008ff15ca56ULL},
+        {17, 0x8700d4e8fbdc902bULL},
+        {48, 0xb61c237f7239a6efULL},
+        {49, 0x601195ce2f825428ULL},
+        {100, 0xa013c973ca2ff6c6ULL},
+        {256, 0x324212f8c03583baULL},
+        {1024, 0x765f7942b87ed23eULL},
+        {1025, 0x3cbdc5c8eaf4d2deULL},
+        {3000, 0xd94e6eac0b3e503eULL},
+    };
+    
+    for (auto& x : expctd)
+    {
+        EXPECT_TRUE(speed::hash::hash_bytes(byts.data(), x.first) == x.second);
+    }
+}
+
+
+TEST(hash_hash, hash_bytes_lengths)
+{
+    const std::vector<unsigned char> byts = make_bytes(2000);
+    std::set<std::uint64_t> hshs;
+    
+    for (std::size_t i = 0; i <= 2000; ++i)
+    {
+        hshs.insert(speed::hash::hash_bytes(byts.data(), i));
+    }
+    
+    EXPECT_TRUE(hshs.size() == 2001);
+}
+
+
+TEST(hash_hash, hash_bytes_single_bit)
+{
+    std::vector<unsigned char> byts = make_bytes(1500);
+    const std::uint64_t ref_hsh = speed::hash::hash_bytes(byts.data(), byts.size());
+    
+    for (std::size_t i = 0; i < byts.size(); i += 7)
+    {
+        byts[i] ^= 0x10;
+        EXPECT_TRUE(speed::hash::hash_bytes(byts.data(), byts.size()) != ref_hsh);
+        byts[i] ^= 0x10;
+    }
+    
+    EXPECT_TRUE(speed::hash::hash_bytes(byts.data(), byts.size()) == ref_hsh);
+}
+
+
+TEST(hash_hash, hash_bytes_seed)
+{
+    const std::vector<unsigned char> byts = make_bytes(2000);
+    
+    for (std::size_t sz : {0, 5, 40, 200, 2000})
+    {
+        EXPECT_TRUE(speed::hash::hash_bytes(byts.data(), sz, 1) !=
+                    speed::hash::hash_bytes(byts.data(), sz, 2));
+        EXPECT_TRUE(speed::hash::hash_bytes(byts.data(), sz, 3) ==
+                    speed::hash::hash_bytes(byts.data(), sz, 3));
+    }
+}
+
+
+TEST(hash_hash, hash_combine)
+{
+    const std::uint64_t hsh1 = speed::hash::mix64(1);
+    const std::uint64_t hsh2 = speed::hash::mix64(2);
+    
+    EXPECT_TRUE(speed::hash::hash_combine(speed::hash::hash_combine(0, hsh1), hsh2) !=
+                speed::hash::hash_combine(speed::hash::hash_combine(0, hsh2), hsh1));
+    EXPECT_TRUE(speed::hash::hash_combine(0, hsh1) != speed::hash::hash_combine(1, hsh1));
+}
@@ -0,0 +1,134 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/hash_test/hasher_test.cpp
+ * @brief       hasher unit test.
+ * @author      Killian
+ * @date        2018/09/29 - 18:40
+ */
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "speed/hash.hpp"
+
+
+namespace {
+
+
+struct point
+{
+    int x;
+    
+    int y;
+    
+    bool operator ==(const point& rhs) const noexcept
+    {
+        return x == rhs.x && y == rhs.y;
+    }
+};
+
+
+}
+
+
+namespace std {
+
+
+template<>
+struct hash<point>
+{
+    std::size_t operator()(const point& pt) const noexcept
+    {
+        return static_cast<std::size_t>(pt.x) * 31 + static_cast<std::size_t>(pt.y);
+    }
+};
+
+
+}
+
+
+TEST(hash_hasher, integral)
+{
+    speed::hash::hasher<std::uint32_t> hshr;
+    std::set<std::size_t> hshs;
+    std::set<std::size_t> bkts;
+    
+    for (std::uint32_t i = 0; i < 4096; ++i)
+    {
+        hshs.insert(hshr(i));
+        bkts.insert(hshr(i << 12) & 1023);
+    }
+    
+    EXPECT_TRUE(hshs.size() == 4096);
+    EXPECT_TRUE(bkts.size() > 900);
+}
+
+
+TEST(hash_hasher, floating_point)
+{
+    speed::hash::hasher<double> hshr;
+    
+    EXPECT_TRUE(hshr(0.0) == hshr(-0.0));
+    EXPECT_TRUE(hshr(1.0) != hshr(-1.0));
+    EXPECT_TRUE(hshr(1.5) == hshr(1.5));
+}
+
+
+TEST(hash_hasher, string)
+{
+    speed::hash::hasher<std::string> str_hshr;
+    speed::hash::hasher<std::string_view> sv_hshr;
+    speed::hash::hasher<const char*> ptr_hshr;
+    const std::string str = "the quick brown fox";
+    
+    EXPECT_TRUE(str_hshr(str) == sv_hshr(str));
+    EXPECT_TRUE(str_hshr(str) ==
+                speed::hash::hash_bytes(str.data(), str.size()));
+    EXPECT_TRUE(str_hshr("alpha") != str_hshr("beta"));
+    EXPECT_TRUE(ptr_hshr(str.c_str()) == ptr_hshr(str.c_str()));
+}
+
+
+TEST(hash_hasher, tuple_like)
+{
+    speed::hash::hasher<std::pair<int, int>> pr_hshr;
+    speed::hash::hasher<std::tuple<int, std::string, double>> tpl_hshr;
+    
+    EXPECT_TRUE(pr_hshr({1, 2}) != pr_hshr({2, 1}));
+    EXPECT_TRUE(pr_hshr({1, 2}) == pr_hshr({1, 2}));
+    EXPECT_TRUE(tpl_hshr({1, "a", 2.0}) != tpl_hshr({1, "b", 2.0}));
+    EXPECT_TRUE(tpl_hshr({1, "a", 2.0}) == tpl_hshr({1, "a", 2.0}));
+}
+
+
+TEST(hash_hasher, std_hash_fallback)
+{
+    speed::hash::hasher<point> hshr;
+    
+    EXPECT_TRUE(hshr({1, 2}) == hshr({1, 2}));
+    EXPECT_TRUE(hshr({1, 2}) != std::hash<point>()({1, 2}));
+    EXPECT_TRUE(hshr({1, 2}) != hshr({2, 1}));
+}
@@ -0,0 +1,309 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/system_test/event_test.cpp
+ * @brief       event unit test.
+ * @author      Killian
+ * @date        2018/10/04 - 17:48
+ */
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/system.hpp"
+
+
+namespace {
+
+
+struct pipe_fds
+{
+    pipe_fds()
+    {
+        int fds[2];
+        
+        EXPECT_EQ(::pipe2(fds, O_NONBLOCK | O_CLOEXEC), 0);
+        rd = fds[0];
+        wr = fds[1];
+    }
+    
+    ~pipe_fds()
+    {
+        ::close(rd);
+        ::close(wr);
+    }
+    
+    void write_byte() const
+    {
+        char c = 'x';
+        
+        EXPECT_EQ(::write(wr, &c, 1), 1);
+    }
+    
+    std::size_t drain() const
+    {
+        char bfr[64];
+        std::size_t nbr_rd = 0;
+        ssize_t res;
+        
+        while ((res = ::read(rd, bfr, sizeof(bfr))) > 0)
+        {
+            nbr_rd += static_cast<std::size_t>(res);
+        }
+        
+        return nbr_rd;
+    }
+    
+    int rd;
+    
+    int wr;
+};
+
+
+}
+
+
+TEST(system_event, watch)
+{
+    speed::system::event_loop lp;
+    pipe_fds pp;
+    std::error_code err_code;
+    int nbr_clls = 0;
+    
+    EXPECT_TRUE(lp.add_watch(pp.rd, speed::system::event_flags::READABLE,
+                             [&](speed::system::event_flags evnts)
+    {
+        EXPECT_TRUE((evnts & speed::system::event_flags::READABLE) !=
+                    speed::system::event_flags::NIL);
+        EXPECT_TRUE(lp.is_in_loop_thread());
+        EXPECT_EQ(pp.drain(), 2u);
+        ++nbr_clls;
+    }));
+    
+    EXPECT_FALSE(lp.add_watch(pp.rd, speed::system::event_flags::READABLE, nullptr, &err_code));
+    EXPECT_EQ(err_code.value(), EEXIST);
+    EXPECT_FALSE(lp.add_watch(-1, speed::system::event_flags::READABLE, nullptr));
+    EXPECT_EQ(lp.size(), 1u);
+    EXPECT_FALSE(lp.is_in_loop_thread());
+    
+    EXPECT_EQ(lp.run_once(0), 0u);
+    pp.write_byte();
+    pp.write_byte();
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(nbr_clls, 1);
+    
+    EXPECT_TRUE(lp.remove_watch(pp.rd));
+    EXPECT_FALSE(lp.remove_watch(pp.rd));
+    EXPECT_EQ(lp.size(), 0u);
+    pp.write_byte();
+    EXPECT_EQ(lp.run_once(0), 0u);
+    EXPECT_EQ(nbr_clls, 1);
+}
+
+
+TEST(system_event, edge_triggered)
+{
+    speed::system::event_loop lp;
+    pipe_fds pp;
+    int nbr_clls = 0;
+    
+    lp.add_watch(pp.rd, speed::system::event_flags::READABLE,
+                 [&](speed::system::event_flags) { ++nbr_clls; });
+    
+    pp.write_byte();
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(lp.run_once(0), 0u);
+    pp.write_byte();
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(nbr_clls, 2);
+    EXPECT_EQ(pp.drain(), 2u);
+}
+
+
+TEST(system_event, remove_from_callback)
+{
+    speed::system::event_loop lp;
+    pipe_fds pp1;
+    pipe_fds pp2;
+    int nbr_clls = 0;
+    
+    auto cb = [&](speed::system::event_flags)
+    {
+        ++nbr_clls;
+        EXPECT_TRUE(lp.remove_watch(pp1.rd));
+        EXPECT_TRUE(lp.remove_watch(pp2.rd));
+    };
+    
+    lp.add_watch(pp1.rd, speed::system::event_flags::READABLE, cb);
+    lp.add_watch(pp2.rd, speed::system::event_flags::READABLE, cb);
+    pp1.write_byte();
+    pp2.write_byte();
+    
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(nbr_clls, 1);
+    EXPECT_EQ(lp.size(), 0u);
+    
+    EXPECT_TRUE(lp.add_watch(pp1.rd, speed::system::event_flags::READABLE,
+                             [&](speed::system::event_flags)
+    {
+        ++nbr_clls;
+        EXPECT_TRUE(lp.remove_watch(pp1.rd));
+        EXPECT_TRUE(lp.add_watch(pp1.rd, speed::system::event_flags::READABLE, cb));
+    }));
+    
+    pp1.write_byte();
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(nbr_clls, 2);
+    EXPECT_EQ(lp.size(), 1u);
+}
+
+
+TEST(system_event, defer)
+{
+    speed::system::event_loop lp;
+    pipe_fds pp;
+    std::vector<int> ordr;
+    
+    lp.add_watch(pp.rd, speed::system::event_flags::READABLE, [&](speed::system::event_flags)
+    {
+        pp.drain();
+        ordr.push_back(1);
+        lp.defer([&]
+        {
+            ordr.push_back(2);
+            lp.defer([&] { ordr.push_back(3); });
+        });
+    });
+    
+    pp.write_byte();
+    EXPECT_EQ(lp.run_once(1000), 2u);
+    EXPECT_EQ(ordr, std::vector<int>({1, 2}));
+    EXPECT_EQ(lp.run_once(), 1u);
+    EXPECT_EQ(ordr, std::vector<int>({1, 2, 3}));
+}
+
+
+TEST(system_event, post)
+{
+    speed::system::event_loop lp;
+    std::vector<std::thread> thrds;
+    std::size_t cnt = 0;
+    
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        thrds.emplace_back([&]
+        {
+            for (std::size_t j = 0; j < 10'000; ++j)
+            {
+                lp.post([&]
+                {
+                    if (++cnt == 40'000)
+                    {
+                        lp.stop();
+                    }
+                });
+            }
+        });
+    }
+    
+    lp.run();
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+    
+    EXPECT_EQ(cnt, 40'000u);
+}
+
+
+TEST(system_event, signal)
+{
+    speed::system::event_loop lp;
+    int sig_rcvd = 0;
+    
+    ASSERT_TRUE(lp.add_signal_handler(SIGUSR1, [&](int sig) { sig_rcvd = sig; }));
+    ::raise(SIGUSR1);
+    
+    EXPECT_EQ(lp.run_once(1000), 1u);
+    EXPECT_EQ(sig_rcvd, SIGUSR1);
+    EXPECT_TRUE(lp.remove_signal_handler(SIGUSR1));
+    EXPECT_FALSE(lp.remove_signal_handler(SIGUSR1));
+}
+
+
+TEST(system_event, event_loop_group)
+{
+    speed::system::event_loop_group grp(4);
+    std::vector<std::size_t> nbr_kys(grp.size(), 0);
+    std::vector<pipe_fds> pps(16);
+    std::atomic<std::size_t> nbr_clls(0);
+    std::atomic<std::size_t> nbr_errs(0);
+    std::atomic<std::size_t> nbr_in_thrd(0);
+    
+    for (std::uint64_t i = 0; i < 1'000; ++i)
+    {
+        ++nbr_kys[grp.select_loop(i)];
+    }
+    
+    for (auto& x : nbr_kys)
+    {
+        EXPECT_GT(x, 200u);
+    }
+    
+    for (auto& x : pps)
+    {
+        std::size_t idx = grp.distribute_watch(x.rd, speed::system::event_flags::READABLE,
+                                               [&, idx = grp.select_loop(x.rd), &pp = x]
+                                               (speed::system::event_flags)
+        {
+            nbr_in_thrd += grp.get_loop(idx).is_in_loop_thread();
+            pp.drain();
+            ++nbr_clls;
+        });
+        
+        EXPECT_EQ(idx, grp.select_loop(x.rd));
+    }
+    
+    grp.distribute_watch(-1, speed::system::event_flags::READABLE,
+                         [&](speed::system::event_flags evnts)
+    {
+        nbr_errs += evnts == speed::system::event_flags::ERROR;
+    });
+    
+    for (std::size_t i = 0; i < 1'000 && (nbr_clls < pps.size() || nbr_errs == 0); ++i)
+    {
+        for (auto& x : pps)
+        {
+            x.write_byte();
+        }
+        
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    
+    EXPECT_GE(nbr_clls.load(), pps.size());
+    EXPECT_EQ(nbr_in_thrd.load(), nbr_clls.load());
+    EXPECT_EQ(nbr_errs.load(), 1u);
+}
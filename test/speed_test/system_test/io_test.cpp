@@ -0,0 +1,254 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/system_test/io_test.cpp
+ * @brief       io unit test.
+ * @author      Killian
+ * @date        2018/10/05 - 16:31
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/system.hpp"
+
+
+namespace {
+
+
+const speed::system::async_io_backends BACKENDS[] = {
+        speed::system::async_io_backends::AUTO,
+        speed::system::async_io_backends::THREAD_POOL
+};
+
+
+std::string get_test_path()
+{
+    return "/tmp/speed_io_test_" + std::to_string(::getpid());
+}
+
+
+int open_file(speed::system::async_io_engine& eng, const std::string& pth)
+{
+    std::int64_t fd = -1;
+    
+    eng.open(AT_FDCWD, pth.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600,
+             [&](std::int64_t res) { fd = res; });
+    EXPECT_TRUE(eng.wait_all());
+    EXPECT_GE(fd, 0);
+    
+    return static_cast<int>(fd);
+}
+
+
+}
+
+
+TEST(system_io, read_write)
+{
+    for (auto bcknd : BACKENDS)
+    {
+        speed::system::async_io_engine eng(16, bcknd);
+        const std::string pth = get_test_path();
+        const int fd = open_file(eng, pth);
+        std::vector<std::uint8_t> wr_bfr(64 * 1024);
+        std::vector<std::uint8_t> rd_bfr(wr_bfr.size());
+        speed::system::file_status stts = {};
+        std::size_t nbr_wrttn = 0;
+        std::size_t nbr_rd = 0;
+        std::int64_t sync_res = -1;
+        
+        for (std::size_t i = 0; i < wr_bfr.size(); ++i)
+        {
+            wr_bfr[i] = static_cast<std::uint8_t>(i * 7 + i / 4096);
+        }
+        
+        for (std::size_t i = 0; i < 16; ++i)
+        {
+            eng.write(fd, wr_bfr.data() + i * 4096, 4096, i * 4096,
+                      [&](std::int64_t res) { nbr_wrttn += static_cast<std::size_t>(res); });
+        }
+        
+        EXPECT_EQ(eng.size(), 16u);
+        EXPECT_TRUE(eng.wait_all());
+        EXPECT_EQ(nbr_wrttn, wr_bfr.size());
+        
+        eng.sync(fd, true, [&](std::int64_t res) { sync_res = res; });
+        eng.stat(AT_FDCWD, pth.c_str(), 0, &stts, [](std::int64_t res) { EXPECT_EQ(res, 0); });
+        for (std::size_t i = 16; i-- > 0;)
+        {
+            eng.read(fd, rd_bfr.data() + i * 4096, 4096, i * 4096,
+                     [&](std::int64_t res) { nbr_rd += static_cast<std::size_t>(res); });
+        }
+        
+        EXPECT_TRUE(eng.wait_all());
+        EXPECT_EQ(sync_res, 0);
+        EXPECT_EQ(stts.sz, wr_bfr.size());
+        EXPECT_TRUE(S_ISREG(stts.mde));
+        EXPECT_EQ(nbr_rd, rd_bfr.size());
+        EXPECT_EQ(rd_bfr, wr_bfr);
+        
+        eng.close(fd, [](std::int64_t res) { EXPECT_EQ(res, 0); });
+        EXPECT_TRUE(eng.wait_all());
+        ::unlink(pth.c_str());
+    }
+}
+
+
+TEST(system_io, registered_resources)
+{
+    for (auto bcknd : BACKENDS)
+    {
+        speed::system::async_io_engine eng(8, bcknd);
+        const std::string pth = get_test_path();
+        const int fd = open_file(eng, pth);
+        std::vector<char> bfr(8 * 4096);
+        std::size_t nbr_ok = 0;
+        
+        ASSERT_TRUE(eng.register_buffers({{bfr.data(), bfr.size()}}));
+        ASSERT_TRUE(eng.register_files({fd}));
+        
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            std::fill(bfr.begin() + i * 4096, bfr.begin() + (i + 1) * 4096, 'a' + i);
+            eng.write(fd, bfr.data() + i * 4096, 4096, i * 4096,
+                      [&](std::int64_t res) { nbr_ok += res == 4096; });
+        }
+        
+        EXPECT_TRUE(eng.wait_all());
+        std::fill(bfr.begin(), bfr.end(), 0);
+        
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            eng.read(fd, bfr.data() + (7 - i) * 4096, 4096, i * 4096,
+                     [&, i](std::int64_t res)
+            {
+                nbr_ok += res == 4096 && bfr[(7 - i) * 4096 + 100] == static_cast<char>('a' + i);
+            });
+        }
+        
+        EXPECT_TRUE(eng.wait_all());
+        EXPECT_EQ(nbr_ok, 16u);
+        EXPECT_TRUE(eng.register_files({}));
+        
+        ::close(fd);
+        ::unlink(pth.c_str());
+    }
+}
+
+
+TEST(system_io, errors)
+{
+    for (auto bcknd : BACKENDS)
+    {
+        speed::system::async_io_engine eng(4, bcknd);
+        speed::system::file_status stts;
+        char bfr[16];
+        std::vector<std::int64_t> ress;
+        
+        eng.read(-1, bfr, sizeof(bfr), 0, [&](std::int64_t res) { ress.push_back(res); });
+        eng.open(AT_FDCWD, "/speed_io_test_missing/file", O_RDONLY, 0,
+                 [&](std::int64_t res) { ress.push_back(res); });
+        eng.stat(AT_FDCWD, "/speed_io_test_missing/file", 0, &stts,
+                 [&](std::int64_t res) { ress.push_back(res); });
+        
+        EXPECT_TRUE(eng.wait_all());
+        ASSERT_EQ(ress.size(), 3u);
+        std::sort(ress.begin(), ress.end());
+        EXPECT_EQ(ress[0], -EBADF);
+        EXPECT_EQ(ress[1], -ENOENT);
+        EXPECT_EQ(ress[2], -ENOENT);
+    }
+}
+
+
+TEST(system_io, queue_depth)
+{
+    for (auto bcknd : BACKENDS)
+    {
+        speed::system::async_io_engine eng(8, bcknd);
+        const std::string pth = get_test_path();
+        const int fd = open_file(eng, pth);
+        std::vector<std::uint32_t> vals(1'000);
+        std::size_t nbr_cmpltd = 0;
+        
+        for (std::uint32_t i = 0; i < vals.size(); ++i)
+        {
+            vals[i] = i;
+            eng.write(fd, &vals[i], sizeof(std::uint32_t), i * sizeof(std::uint32_t),
+                      [&, i](std::int64_t)
+            {
+                eng.read(fd, &vals[i], sizeof(std::uint32_t), i * sizeof(std::uint32_t),
+                         [&](std::int64_t res) { nbr_cmpltd += res == sizeof(std::uint32_t); });
+            });
+        }
+        
+        EXPECT_EQ(eng.size(), vals.size());
+        EXPECT_LE(eng.submit(), 8u);
+        EXPECT_TRUE(eng.wait_all());
+        EXPECT_EQ(eng.size(), 0u);
+        EXPECT_EQ(nbr_cmpltd, vals.size());
+        
+        for (std::uint32_t i = 0; i < vals.size(); ++i)
+        {
+            EXPECT_EQ(vals[i], i);
+        }
+        
+        ::close(fd);
+        ::unlink(pth.c_str());
+    }
+}
+
+
+TEST(system_io, event_loop)
+{
+    for (auto bcknd : BACKENDS)
+    {
+        speed::system::async_io_engine eng(4, bcknd);
+        speed::system::event_loop lp;
+        speed::system::file_status stts;
+        bool dne = false;
+        
+        ASSERT_TRUE(lp.add_watch(eng.get_file_descriptor(), speed::system::event_flags::READABLE,
+                                 [&](speed::system::event_flags) { eng.poll(); }));
+        
+        eng.stat(AT_FDCWD, "/tmp", 0, &stts, [&](std::int64_t res)
+        {
+            EXPECT_EQ(res, 0);
+            EXPECT_TRUE(S_ISDIR(stts.mde));
+            dne = true;
+        });
+        
+        eng.submit();
+        for (std::size_t i = 0; i < 100 && !dne; ++i)
+        {
+            lp.run_once(100);
+        }
+        
+        EXPECT_TRUE(dne);
+        lp.remove_watch(eng.get_file_descriptor());
+    }
+}
@@ -0,0 +1,275 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/system_test/sync_test.cpp
+ * @brief       sync unit test.
+ * @author      Killian
+ * @date        2018/10/01 - 17:02
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/system.hpp"
+
+
+namespace {
+
+
+template<typename TpFunction>
+void run_threads(std::size_t nbr_thrds, const TpFunction& fnc)
+{
+    std::vector<std::thread> thrds;
+    
+    for (std::size_t i = 0; i < nbr_thrds; ++i)
+    {
+        thrds.emplace_back(fnc, i);
+    }
+    
+    for (auto& x : thrds)
+    {
+        x.join();
+    }
+}
+
+
+template<typename TpMutex>
+void check_mutual_exclusion()
+{
+    TpMutex mtx;
+    std::uint64_t cnt = 0;
+    
+    run_threads(4, [&](std::size_t)
+    {
+        for (int i = 0; i < 20000; ++i)
+        {
+            std::lock_guard<TpMutex> lck(mtx);
+            ++cnt;
+        }
+    });
+    
+    EXPECT_TRUE(cnt == 80000);
+    EXPECT_TRUE(mtx.try_lock());
+    mtx.unlock();
+}
+
+
+}
+
+
+TEST(system_sync, futex)
+{
+    std::atomic<std::uint32_t> wrd(1);
+    std::atomic<bool> wkn(false);
+    
+    EXPECT_TRUE(speed::system::futex_wait(&wrd, 0));
+    
+    std::thread thrd([&]
+    {
+        while (wrd.load() == 1)
+        {
+            speed::system::futex_wait(&wrd, 1);
+        }
+        
+        wkn.store(true);
+    });
+    
+    wrd.store(2);
+    speed::system::futex_wake_all(&wrd);
+    thrd.join();
+    
+    EXPECT_TRUE(wkn.load());
+}
+
+
+TEST(system_sync, adaptive_mutex)
+{
+    check_mutual_exclusion<speed::system::adaptive_mutex>();
+}
+
+
+TEST(system_sync, ticket_lock)
+{
+    check_mutual_exclusion<speed::system::ticket_lock>();
+}
+
+
+TEST(system_sync, reader_writer_lock)
+{
+    speed::system::reader_writer_lock rw_lck;
+    std::uint64_t x = 0;
+    std::uint64_t y = 0;
+    std::atomic<bool> cnsstnt(true);
+    
+    run_threads(4, [&](std::size_t thrd_idx)
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            if (thrd_idx == 0 || i % 50 == 0)
+            {
+                std::lock_guard<speed::system::reader_writer_lock> lck(rw_lck);
+                ++x;
+                ++y;
+            }
+            else
+            {
+                std::shared_lock<speed::system::reader_writer_lock> lck(rw_lck);
+                if (x != y)
+                {
+                    cnsstnt.store(false);
+                }
+            }
+        }
+    });
+    
+    EXPECT_TRUE(cnsstnt.load());
+    EXPECT_TRUE(x == 5000 + 3 * 100);
+    EXPECT_TRUE(rw_lck.try_lock_shared());
+    EXPECT_FALSE(rw_lck.try_lock());
+    rw_lck.unlock_shared();
+    EXPECT_TRUE(rw_lck.try_lock());
+    EXPECT_FALSE(rw_lck.try_lock_shared());
+    rw_lck.unlock();
+}
+
+
+TEST(system_sync, counting_semaphore)
+{
+    speed::system::counting_semaphore sem(0);
+    std::atomic<int> cnsmd(0);
+    
+    run_threads(4, [&](std::size_t thrd_idx)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (thrd_idx < 2)
+            {
+                sem.release();
+            }
+            else
+            {
+                sem.acquire();
+                cnsmd.fetch_add(1);
+            }
+        }
+    });
+    
+    EXPECT_TRUE(cnsmd.load() == 2000);
+    EXPECT_TRUE(sem.get_count() == 0);
+    EXPECT_FALSE(sem.try_acquire());
+    sem.release(2);
+    EXPECT_TRUE(sem.try_acquire());
+    EXPECT_TRUE(sem.get_count() == 1);
+}
+
+
+TEST(system_sync, latch)
+{
+    speed::system::latch ltch(4);
+    std::atomic<int> arrvd(0);
+    std::atomic<bool> ok(true);
+    
+    run_threads(4, [&](std::size_t)
+    {
+        arrvd.fetch_add(1);
+        ltch.arrive_and_wait();
+        if (arrvd.load() != 4)
+        {
+            ok.store(false);
+        }
+    });
+    
+    EXPECT_TRUE(ok.load());
+    EXPECT_TRUE(ltch.try_wait());
+}
+
+
+TEST(system_sync, barrier)
+{
+    constexpr int nbr_phss = 200;
+    
+    speed::system::barrier barr(4);
+    std::vector<std::atomic<int>> cnts(nbr_phss);
+    std::atomic<int> nbr_lsts(0);
+    std::atomic<bool> ok(true);
+    
+    run_threads(4, [&](std::size_t)
+    {
+        for (int i = 0; i < nbr_phss; ++i)
+        {
+            cnts[i].fetch_add(1);
+            if (barr.arrive_and_wait())
+            {
+                nbr_lsts.fetch_add(1);
+            }
+            
+            if (cnts[i].load() != 4)
+            {
+                ok.store(false);
+            }
+        }
+    });
+    
+    EXPECT_TRUE(ok.load());
+    EXPECT_TRUE(nbr_lsts.load() == nbr_phss);
+}
+
+
+TEST(system_sync, event_count)
+{
+    speed::system::event_count evnt_cnt;
+    std::atomic<int> val(0);
+    int sm = 0;
+    
+    std::thread cnsmr([&]
+    {
+        int cur = 0;
+        std::uint32_t ky;
+        
+        while (cur < 1000)
+        {
+            ky = evnt_cnt.prepare_wait();
+            if (val.load() != cur)
+            {
+                evnt_cnt.cancel_wait();
+                cur = val.load();
+                ++sm;
+                continue;
+            }
+            
+            evnt_cnt.wait(ky);
+        }
+    });
+    
+    for (int i = 1; i <= 1000; ++i)
+    {
+        val.store(i);
+        evnt_cnt.notify_one();
+    }
+    
+    cnsmr.join();
+    
+    EXPECT_TRUE(sm > 0);
+}
@@ -0,0 +1,177 @@
+/* speed - Generic C++ library.
+ * Copyright (C) 2015-2018 Killian Poulaud.
+ *
+ * This file is part of speed.
+ *
+ * speed is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * speed is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with speed. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/**
+ * @file        speed_test/time_test/monotonic_timer_test.cpp
+ * @brief       monotonic_timer unit test.
+ * @author      Killian
+ * @date        2018/10/03 - 11:26
+ */
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "speed/time.hpp"
+
+
+namespace {
+
+
+std::uint64_t get_monotonic_nanoseconds()
+{
+    speed::system::time_specification tme;
+    
+    speed::system::get_monotonic_time(&tme);
+    
+    return tme.sec * 1'000'000'000 + tme.nsec;
+}
+
+
+}
+
+
+TEST(time_monotonic_timer, schedule_once)
+{
+    speed::time::monotonic_timer tmr;
+    std::vector<int> ordr;
+    
+    tmr.schedule_once(speed::system::time_specification(0, 20'000'000), [&] { ordr.push_back(2); });
+    tmr.schedule_once(speed::system::time_specification(0, 5'000'000), [&] { ordr.push_back(1); });
+    tmr.schedule_once(speed::system::time_specification(0, 0), [&] { ordr.push_back(0); });
+    
+    EXPECT_GE(tmr.get_file_descriptor(), 0);
+    EXPECT_EQ(tmr.size(), 3u);
+    while (tmr.wait())
+    {
+    }
+    
+    EXPECT_TRUE(tmr.empty());
+    EXPECT_EQ(ordr, std::vector<int>({0, 1, 2}));
+    EXPECT_EQ(tmr.process_expired_timers(), 0u);
+}
+
+
+TEST(time_monotonic_timer, cancel)
+{
+    speed::time::monotonic_timer tmr;
+    int nbr_clls = 0;
+    
+    auto id1 = tmr.schedule_once(speed::system::time_specification(0, 1'000'000),
+                                 [&] { ++nbr_clls; });
+    auto id2 = tmr.schedule_once(speed::system::time_specification(0, 2'000'000),
+                                 [&] { nbr_clls += 10; });
+    auto id3 = tmr.schedule_once(speed::system::time_specification(7200, 0), [&] { ++nbr_clls; });
+    
+    EXPECT_TRUE(tmr.cancel(id2));
+    EXPECT_FALSE(tmr.cancel(id2));
+    EXPECT_TRUE(tmr.cancel(id3));
+    EXPECT_FALSE(tmr.cancel(0));
+    EXPECT_EQ(tmr.size(), 1u);
+    
+    while (tmr.wait())
+    {
+    }
+    
+    EXPECT_EQ(nbr_clls, 1);
+    EXPECT_FALSE(tmr.cancel(id1));
+}
+
+
+TEST(time_monotonic_timer, schedule_periodic)
+{
+    speed::time::monotonic_timer tmr;
+    speed::time::monotonic_timer::timer_id id;
+    std::uint64_t strt = get_monotonic_nanoseconds();
+    int nbr_clls = 0;
+    
+    id = tmr.schedule_periodic(speed::system::time_specification(0, 2'000'000), [&]
+    {
+        if (++nbr_clls == 5)
+        {
+            EXPECT_TRUE(tmr.cancel(id));
+        }
+    });
+    
+    while (tmr.wait())
+    {
+    }
+    
+    EXPECT_EQ(nbr_clls, 5);
+    EXPECT_GE(get_monotonic_nanoseconds() - strt, 10'000'000u);
+    EXPECT_TRUE(tmr.empty());
+}
+
+
+TEST(time_monotonic_timer, schedule_from_callback)
+{
+    speed::time::monotonic_timer tmr;
+    int nbr_clls = 0;
+    
+    std::function<void()> cb = [&]
+    {
+        if (++nbr_clls < 10)
+        {
+            tmr.schedule_once(speed::system::time_specification(0, 100'000), cb);
+        }
+    };
+    
+    tmr.schedule_once(speed::system::time_specification(0, 0), cb);
+    while (tmr.wait())
+    {
+    }
+    
+    EXPECT_EQ(nbr_clls, 10);
+}
+
+
+TEST(time_monotonic_timer, many_timers)
+{
+    speed::time::monotonic_timer tmr(1'000);
+    std::mt19937_64 gen(7);
+    std::uniform_int_distribution<std::uint64_t> dist(0, 100'000'000);
+    std::vector<speed::time::monotonic_timer::timer_id> ids;
+    std::uint64_t strt = get_monotonic_nanoseconds();
+    std::size_t nbr_clls = 0;
+    std::size_t nbr_erly = 0;
+    
+    for (std::size_t i = 0; i < 10'000; ++i)
+    {
+        const std::uint64_t dly = dist(gen);
+        
+        ids.push_back(tmr.schedule_once(speed::system::time_specification(0, dly), [&, dly]
+        {
+            nbr_erly += get_monotonic_nanoseconds() - strt < dly;
+            ++nbr_clls;
+        }));
+    }
+    
+    for (std::size_t i = 0; i < ids.size(); i += 2)
+    {
+        EXPECT_TRUE(tmr.cancel(ids[i]));
+    }
+    
+    while (tmr.wait())
+    {
+    }
+    
+    EXPECT_EQ(nbr_clls, 5'000u);
+    EXPECT_EQ(nbr_erly, 0u);
+}